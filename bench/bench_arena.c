@@ -0,0 +1,224 @@
+/**
+ * EDN.C - Arena footprint benchmark
+ *
+ * Parses each bench/data file and reports how many arena bytes the
+ * resulting tree occupies (used) and reserves (block capacity), next to
+ * the parse time. A generated document of tens of megabytes is then parsed
+ * with fixed-size arena blocks, with blocks estimated from the input
+ * length, and with huge pages, counting blocks and minor page faults. Run
+ * from the repository root.
+ *
+ * EDN_BENCH_DATA replaces the bench/data files; see bench_data.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "../src/edn_internal.h"
+#include "bench_data.h"
+#include "bench_report.h"
+#include "bench_time.h"
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+#define ROUNDS 5 /* Each timing keeps its fastest round */
+
+static const char* const files[] = {
+    "basic_1000.edn",
+    "basic_10000.edn",
+    "basic_100000.edn",
+    "keywords_1000.edn",
+    "keywords_10000.edn",
+    "ints_1400.edn",
+    "nested_100000.edn",
+    "strings_1000.edn",
+    "strings_uni_250.edn",
+};
+
+#define LARGE_RECORDS 400000 /* Generated document of about 30 MB */
+
+static char* read_file(const char* path, size_t* out_size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(f);
+        return NULL;
+    }
+    char* buffer = malloc((size_t) size + 1);
+    if (buffer && fread(buffer, 1, (size_t) size, f) != (size_t) size) {
+        free(buffer);
+        buffer = NULL;
+    }
+    fclose(f);
+    if (buffer) {
+        buffer[size] = '\0';
+        *out_size = (size_t) size;
+    }
+    return buffer;
+}
+
+static size_t arena_used(const edn_arena_t* arena) {
+    size_t used = 0;
+    for (const arena_block_t* b = arena->first; b != NULL; b = b->next) {
+        used += b->used;
+    }
+    for (const arena_block_t* b = arena->large; b != NULL; b = b->next) {
+        used += b->used;
+    }
+    return used;
+}
+
+static size_t arena_blocks(const edn_arena_t* arena) {
+    size_t blocks = 0;
+    for (const arena_block_t* b = arena->first; b != NULL; b = b->next) {
+        blocks++;
+    }
+    for (const arena_block_t* b = arena->large; b != NULL; b = b->next) {
+        blocks++;
+    }
+    return blocks;
+}
+
+static long minor_faults(void) {
+#if !defined(_WIN32)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_minflt;
+    }
+#endif
+    return -1;
+}
+
+static char* build_large_document(size_t* out_size) {
+    size_t cap = (size_t) LARGE_RECORDS * 96 + 16;
+    char* out = malloc(cap);
+    if (!out) {
+        return NULL;
+    }
+    size_t pos = (size_t) snprintf(out, cap, "[");
+    for (int i = 0; i < LARGE_RECORDS; i++) {
+        pos += (size_t) snprintf(out + pos, cap - pos,
+                                 "{:id %d :name \"user-%d\" :score %d.5 :tags [:a :b] :active "
+                                 "true}\n",
+                                 i, i, i % 100);
+    }
+    pos += (size_t) snprintf(out + pos, cap - pos, "]");
+    *out_size = pos;
+    return out;
+}
+
+/* One parse of the large document under `options`, reporting its blocks and faults */
+static void run_large(const char* label, const char* data, size_t size,
+                      const edn_parse_options_t* options) {
+    double best = 0;
+    long faults = 0;
+    size_t blocks = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        long before = minor_faults();
+        double start = get_time();
+        edn_result_t r = edn_read_with_options(data, size, options);
+        double us = (get_time() - start) * 1e6;
+        long after = minor_faults();
+        if (r.error != EDN_OK) {
+            printf("  %-22s FAILED (%s)\n", label, r.error_message ? r.error_message : "?");
+            return;
+        }
+        blocks = arena_blocks(r.value->arena);
+        edn_free(r.value);
+        if (round == 0 || us < best) {
+            best = us;
+            faults = after - before;
+        }
+    }
+    printf("  %-22s %10zu %12ld %12.1f\n", label, blocks, faults, best / 1000.0);
+    bench_report(label, "blocks", (double) blocks, "count");
+    bench_report(label, "minor_faults", (double) faults, "count");
+    bench_report(label, "parse_ms", best / 1000.0, "ms");
+}
+
+static double time_parse(const char* data, size_t size, int iterations) {
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            edn_result_t r = edn_read(data, size);
+            edn_free(r.value);
+        }
+        double us = (get_time() - start) * 1e6 / iterations;
+        best = (round == 0 || us < best) ? us : best;
+    }
+    return best;
+}
+
+int main(void) {
+    printf("Arena Footprint Benchmarks\n");
+    printf("==========================\n");
+    printf("Parse time is best of %d rounds (parse + free)\n\n", ROUNDS);
+    printf("  %-22s %10s %12s %12s %8s %12s\n", "file", "input", "arena used", "reserved",
+           "used/in", "us/op");
+
+    bench_data_t inputs = bench_data_files(files, sizeof(files) / sizeof(files[0]));
+    char path[512];
+    const char* label;
+    while (bench_data_next(&inputs, path, sizeof(path), &label)) {
+        size_t size = 0;
+        char* data = read_file(path, &size);
+        if (!data) {
+            printf("  %-22s FAILED (could not read file)\n", label);
+            continue;
+        }
+
+        edn_result_t r = edn_read(data, size);
+        if (r.error != EDN_OK || r.value->arena == NULL) {
+            printf("  %-22s FAILED (%s)\n", label, r.error_message ? r.error_message : "?");
+            edn_free(r.value);
+            free(data);
+            continue;
+        }
+        size_t used = arena_used(r.value->arena);
+        size_t reserved = r.value->arena->total_allocated;
+        edn_free(r.value);
+
+        int iterations = size > 1000000 ? 5 : size > 50000 ? 200 : 2000;
+        double us = time_parse(data, size, iterations);
+        printf("  %-22s %10zu %12zu %12zu %8.2f %12.1f\n", label, size, used, reserved,
+               (double) used / (double) size, us);
+        bench_report(label, "arena_used", (double) used, "bytes");
+        bench_report(label, "arena_reserved", (double) reserved, "bytes");
+        bench_report(label, "parse_us", us, "us");
+        free(data);
+    }
+
+    size_t size = 0;
+    char* data = build_large_document(&size);
+    if (data) {
+        printf("\nGenerated document (%zu bytes), one parse + free\n\n", size);
+        printf("  %-22s %10s %12s %12s\n", "arena", "blocks", "minor faults", "ms/op");
+
+        edn_parse_options_t opts = {0};
+        opts.struct_size = sizeof(opts);
+        opts.arena_initial_block = ARENA_INITIAL_SIZE; /* Sizing before input estimates */
+        opts.arena_max_block = ARENA_LARGE_SIZE;
+        run_large("fixed 16KB..256KB", data, size, &opts);
+
+        opts.arena_initial_block = 0;
+        opts.arena_max_block = 0;
+        run_large("estimated", data, size, &opts);
+
+        opts.arena_huge_pages = true;
+        run_large("estimated + huge pages", data, size, &opts);
+        free(data);
+    }
+
+    printf("\nBenchmark complete.\n");
+    return 0;
+}
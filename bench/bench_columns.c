@@ -0,0 +1,220 @@
+/**
+ * EDN.C - Columnar conversion benchmark
+ *
+ * Converts generated batches of event maps to columns two ways: the manual
+ * loop of edn_map_get_keyword calls per row and field, filling the same
+ * int64/double/bool arrays and string offsets + data, and edn_to_columns.
+ * The manual loop keeps keyword names as pointers rather than building a
+ * dictionary, so it does less work than edn_to_columns. Parsing is not
+ * timed.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "bench_report.h"
+#include "bench_time.h"
+
+#define ROUNDS 5 /* Each timing keeps its fastest round */
+
+static const size_t batch_rows[] = {100, 1000, 10000, 100000};
+
+static char* build_batch(size_t rows, size_t* out_size) {
+    size_t cap = rows * 160 + 16;
+    char* out = malloc(cap);
+    if (!out) {
+        return NULL;
+    }
+    static const char* const kinds[] = {"click", "view", "buy", "scroll", "exit"};
+    size_t pos = (size_t) snprintf(out, cap, "[");
+    for (size_t i = 0; i < rows; i++) {
+        pos += (size_t) snprintf(out + pos, cap - pos,
+                                 "{:id %zu :user \"user-%zu\" :kind :%s :score %zu.5 "
+                                 ":ok %s :region :r%zu%s}\n",
+                                 i, i % 997, kinds[i % 5], i % 100, i % 3 ? "true" : "false",
+                                 i % 7, i % 10 == 0 ? " :note \"flagged\"" : "");
+    }
+    pos += (size_t) snprintf(out + pos, cap - pos, "]");
+    *out_size = pos;
+    return out;
+}
+
+/* What the manual loop produces */
+typedef struct {
+    int64_t* id;
+    double* score;
+    uint8_t* ok;
+    int32_t* user_offsets;
+    char* user_data;
+    size_t user_capacity;
+    const char** kind; /* Keyword names, not deduplicated */
+    size_t* kind_length;
+    const char** region;
+    size_t* region_length;
+    int32_t* note_offsets;
+    char* note_data;
+    size_t note_capacity;
+} manual_t;
+
+static char* append(char* data, size_t* capacity, size_t used, const char* text, size_t length) {
+    if (used + length > *capacity) {
+        *capacity = (*capacity + length) * 2;
+        data = realloc(data, *capacity);
+    }
+    memcpy(data + used, text, length);
+    return data;
+}
+
+static int64_t convert_manual(const edn_value_t* batch, manual_t* m) {
+    size_t rows = edn_vector_count(batch);
+    size_t user_used = 0;
+    size_t note_used = 0;
+    int64_t check = 0;
+    memset(m->ok, 0, (rows + 7) / 8);
+    for (size_t r = 0; r < rows; r++) {
+        const edn_value_t* row = edn_vector_get(batch, r);
+        const char* text;
+        size_t length;
+
+        m->id[r] = 0;
+        edn_int64_get(edn_map_get_keyword(row, "id"), &m->id[r]);
+        m->score[r] = 0;
+        edn_number_as_double(edn_map_get_keyword(row, "score"), &m->score[r]);
+        bool flag = false;
+        if (edn_bool_get(edn_map_get_keyword(row, "ok"), &flag) && flag) {
+            m->ok[r >> 3] |= (uint8_t) (1u << (r & 7));
+        }
+
+        m->user_offsets[r] = (int32_t) user_used;
+        text = edn_string_get(edn_map_get_keyword(row, "user"), &length);
+        if (text != NULL) {
+            m->user_data = append(m->user_data, &m->user_capacity, user_used, text, length);
+            user_used += length;
+        }
+        m->note_offsets[r] = (int32_t) note_used;
+        text = edn_string_get(edn_map_get_keyword(row, "note"), &length);
+        if (text != NULL) {
+            m->note_data = append(m->note_data, &m->note_capacity, note_used, text, length);
+            note_used += length;
+        }
+
+        m->kind[r] = NULL;
+        edn_keyword_get(edn_map_get_keyword(row, "kind"), NULL, NULL, &m->kind[r],
+                        &m->kind_length[r]);
+        m->region[r] = NULL;
+        edn_keyword_get(edn_map_get_keyword(row, "region"), NULL, NULL, &m->region[r],
+                        &m->region_length[r]);
+        check += m->id[r];
+    }
+    m->user_offsets[rows] = (int32_t) user_used;
+    m->note_offsets[rows] = (int32_t) note_used;
+    return check;
+}
+
+static int64_t convert_columns(const edn_value_t* batch) {
+    edn_columns_t* columns = NULL;
+    edn_result_t r = edn_to_columns(batch, NULL, &columns);
+    if (r.error != EDN_OK) {
+        return -1;
+    }
+    const edn_column_t* id = edn_columns_find(columns, "id");
+    int64_t check = 0;
+    for (size_t i = 0; i < edn_columns_row_count(columns); i++) {
+        check += id->int64_values[i];
+    }
+    edn_columns_free(columns);
+    return check;
+}
+
+typedef struct {
+    double manual_us;
+    double columns_us;
+} timings_t;
+
+static double keep_best(double best, double us, int round) {
+    return (round == 0 || us < best) ? us : best;
+}
+
+static bool run_batch(size_t rows, timings_t* t) {
+    size_t size = 0;
+    char* text = build_batch(rows, &size);
+    if (text == NULL) {
+        return false;
+    }
+    edn_result_t r = edn_read(text, size);
+    if (r.error != EDN_OK) {
+        free(text);
+        return false;
+    }
+
+    manual_t m = {0};
+    m.id = malloc(rows * sizeof(*m.id));
+    m.score = malloc(rows * sizeof(*m.score));
+    m.ok = malloc((rows + 7) / 8);
+    m.user_offsets = malloc((rows + 1) * sizeof(int32_t));
+    m.note_offsets = malloc((rows + 1) * sizeof(int32_t));
+    m.kind = malloc(rows * sizeof(*m.kind));
+    m.kind_length = malloc(rows * sizeof(size_t));
+    m.region = malloc(rows * sizeof(*m.region));
+    m.region_length = malloc(rows * sizeof(size_t));
+
+    bool ok = convert_manual(r.value, &m) == convert_columns(r.value);
+    int iterations = rows >= 100000 ? 5 : rows >= 10000 ? 50 : 500;
+    volatile int64_t sink = 0;
+    for (int round = 0; ok && round < ROUNDS; round++) {
+        double start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            sink += convert_manual(r.value, &m);
+        }
+        t->manual_us = keep_best(t->manual_us, (get_time() - start) * 1e6 / iterations, round);
+
+        start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            sink += convert_columns(r.value);
+        }
+        t->columns_us = keep_best(t->columns_us, (get_time() - start) * 1e6 / iterations, round);
+    }
+    (void) sink;
+
+    free(m.id);
+    free(m.score);
+    free(m.ok);
+    free(m.user_offsets);
+    free(m.user_data);
+    free(m.note_offsets);
+    free(m.note_data);
+    free(m.kind);
+    free(m.kind_length);
+    free(m.region);
+    free(m.region_length);
+    edn_free(r.value);
+    free(text);
+    return ok;
+}
+
+int main(void) {
+    printf("Columnar Conversion Benchmarks\n");
+    printf("==============================\n");
+    printf("Times in us, best of %d rounds\n\n", ROUNDS);
+    printf("  %-10s %12s %14s %9s\n", "rows", "manual loop", "edn_to_columns", "speedup");
+
+    for (size_t i = 0; i < sizeof(batch_rows) / sizeof(batch_rows[0]); i++) {
+        timings_t t = {0};
+        if (!run_batch(batch_rows[i], &t)) {
+            printf("  %-10zu FAILED\n", batch_rows[i]);
+            continue;
+        }
+        printf("  %-10zu %12.1f %14.1f %8.2fx\n", batch_rows[i], t.manual_us, t.columns_us,
+               t.manual_us / t.columns_us);
+        char label[32];
+        snprintf(label, sizeof(label), "%zu rows", batch_rows[i]);
+        bench_report(label, "manual_us", t.manual_us, "us");
+        bench_report(label, "columns_us", t.columns_us, "us");
+    }
+
+    printf("\nBenchmark complete.\n");
+    return 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * Input file selection for file-driven benchmarks
+ *
+ * A benchmark lists its built-in bench/data files and walks them with
+ * bench_data_next. When EDN_BENCH_DATA is set to a whitespace-separated
+ * list of paths, those files replace the built-in set, so the same
+ * benchmark runs over generated inputs: `make bench-matrix` points it at
+ * the corpus written by bench/corpus/gen_corpus.
+ */
+
+#ifndef BENCH_DATA_H
+#define BENCH_DATA_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char* const* defaults; /* Names under bench/data/ */
+    size_t count;
+    size_t next;
+    const char* env; /* Rest of EDN_BENCH_DATA, or NULL to use the defaults */
+} bench_data_t;
+
+static inline bench_data_t bench_data_files(const char* const* defaults, size_t count) {
+    bench_data_t data;
+    data.defaults = defaults;
+    data.count = count;
+    data.next = 0;
+    data.env = getenv("EDN_BENCH_DATA");
+    if (data.env != NULL && strspn(data.env, " \t\n") == strlen(data.env)) {
+        data.env = NULL;
+    }
+    return data;
+}
+
+/* True if EDN_BENCH_DATA replaced the built-in files */
+static inline bool bench_data_overridden(const bench_data_t* data) {
+    return data->env != NULL;
+}
+
+/**
+ * Next input: its path and a label for the result table (the file name
+ * without directories). False when there are no more files.
+ */
+static inline bool bench_data_next(bench_data_t* data, char* path, size_t path_size,
+                                   const char** label) {
+    if (data->env == NULL) {
+        if (data->next >= data->count) {
+            return false;
+        }
+        *label = data->defaults[data->next++];
+        snprintf(path, path_size, "bench/data/%s", *label);
+        return true;
+    }
+
+    const char* start = data->env + strspn(data->env, " \t\n");
+    size_t length = strcspn(start, " \t\n");
+    if (length == 0) {
+        return false;
+    }
+    data->env = start + length;
+    if (length >= path_size) {
+        length = path_size - 1;
+    }
+    memcpy(path, start, length);
+    path[length] = '\0';
+    const char* slash = strrchr(path, '/');
+    *label = slash != NULL ? slash + 1 : path;
+    return true;
+}
+
+#endif /* BENCH_DATA_H */
@@ -0,0 +1,122 @@
+/**
+ * EDN.C - Schema-directed decoding benchmark
+ *
+ * Compares filling a C struct with edn_decode against the hand-written
+ * edn_read + edn_map_get_keyword path it replaces.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "bench_report.h"
+#include "bench_time.h"
+
+#define ITERATIONS 200000
+
+typedef struct {
+    int64_t id;
+    int32_t age;
+    bool active;
+    char name[32];
+    char email[48];
+    double balance;
+    double scores[8];
+    size_t score_count;
+} account_t;
+
+static const edn_field_desc_t account_fields[] = {
+    EDN_FIELD(account_t, id, "id", EDN_FIELD_INT64, true),
+    EDN_FIELD(account_t, age, "age", EDN_FIELD_INT32, false),
+    EDN_FIELD(account_t, active, "active", EDN_FIELD_BOOL, false),
+    EDN_FIELD(account_t, name, "name", EDN_FIELD_STRING, false),
+    EDN_FIELD(account_t, email, "email", EDN_FIELD_STRING, false),
+    EDN_FIELD(account_t, balance, "balance", EDN_FIELD_DOUBLE, false),
+    EDN_ARRAY_FIELD(account_t, scores, score_count, "scores", EDN_FIELD_DOUBLE, NULL, false),
+};
+static const edn_struct_desc_t account_desc = {account_fields, 7, sizeof(account_t)};
+
+static const char* INPUT = "{:id 1024 :age 37 :active true :name \"Ada Lovelace\""
+                           " :email \"ada@example.com\" :balance 1234.5"
+                           " :scores [9.5 8.25 7 10 6.75] :created \"2024-01-01\""
+                           " :tags [:admin :ops] :notes {:last-login 1700000000}}";
+
+static void copy_string(char* dst, size_t size, const edn_value_t* v) {
+    size_t length;
+    const char* s = edn_string_get(v, &length);
+    if (s != NULL && length < size) {
+        memcpy(dst, s, length);
+        dst[length] = '\0';
+    }
+}
+
+/* The two-pass baseline: build the tree, then pick fields out of it */
+static int decode_by_hand(const char* input, account_t* out) {
+    edn_result_t r = edn_read(input, 0);
+    if (r.error != EDN_OK) {
+        return -1;
+    }
+    memset(out, 0, sizeof(*out));
+
+    edn_int64_get(edn_map_get_keyword(r.value, "id"), &out->id);
+    int64_t age = 0;
+    edn_int64_get(edn_map_get_keyword(r.value, "age"), &age);
+    out->age = (int32_t) age;
+    edn_bool_get(edn_map_get_keyword(r.value, "active"), &out->active);
+    copy_string(out->name, sizeof(out->name), edn_map_get_keyword(r.value, "name"));
+    copy_string(out->email, sizeof(out->email), edn_map_get_keyword(r.value, "email"));
+    edn_number_as_double(edn_map_get_keyword(r.value, "balance"), &out->balance);
+
+    edn_value_t* scores = edn_map_get_keyword(r.value, "scores");
+    size_t count = edn_vector_count(scores);
+    for (size_t i = 0; i < count && i < 8; i++) {
+        edn_number_as_double(edn_vector_get(scores, i), &out->scores[i]);
+    }
+    out->score_count = count;
+
+    edn_free(r.value);
+    return 0;
+}
+
+int main(void) {
+    printf("Schema Decode Benchmarks\n");
+    printf("========================\n");
+    printf("Iterations: %d\n\n", ITERATIONS);
+
+    edn_decoder_t* decoder = edn_decoder_create(&account_desc);
+    if (decoder == NULL) {
+        printf("ERROR: failed to compile descriptor\n");
+        return 1;
+    }
+
+    account_t a;
+    account_t b;
+    if (decode_by_hand(INPUT, &a) != 0 || edn_decode(decoder, INPUT, 0, &b).error != EDN_OK ||
+        a.id != b.id || a.score_count != b.score_count || strcmp(a.email, b.email) != 0) {
+        printf("ERROR: decoders disagree\n");
+        edn_decoder_destroy(decoder);
+        return 1;
+    }
+
+    double start = get_time();
+    for (int i = 0; i < ITERATIONS; i++) {
+        decode_by_hand(INPUT, &a);
+    }
+    double by_hand_ns = (get_time() - start) * 1e9 / ITERATIONS;
+
+    start = get_time();
+    for (int i = 0; i < ITERATIONS; i++) {
+        edn_decode(decoder, INPUT, 0, &b);
+    }
+    double decode_ns = (get_time() - start) * 1e9 / ITERATIONS;
+
+    printf("edn_read + edn_map_get_keyword: %8.1f ns/op\n", by_hand_ns);
+    printf("edn_decode:                     %8.1f ns/op\n", decode_ns);
+    printf("Speedup:                        %8.2fx\n", by_hand_ns / decode_ns);
+    bench_report("message", "by_hand_ns", by_hand_ns, "ns");
+    bench_report("message", "decode_ns", decode_ns, "ns");
+
+    edn_decoder_destroy(decoder);
+    printf("\nBenchmark complete.\n");
+    return 0;
+}
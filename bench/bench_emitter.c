@@ -0,0 +1,104 @@
+/**
+ * EDN.C - Streaming emitter keyword benchmark
+ *
+ * Encodes a vector of records whose keys come from a small fixed set, once
+ * with edn_emit_keyword_ns (validated and rendered per call) and once with
+ * pre-made edn_emitter_token_t handles.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "bench_time.h"
+
+#define ITERATIONS 2000
+#define RECORDS 200
+#define ROUNDS 5 /* Each timing keeps its fastest round */
+
+static const char* const key_ns[] = {"order", "order", "order", "customer", "customer", "line"};
+static const char* const key_name[] = {"id", "status", "created-at", "id", "email", "total"};
+#define KEY_COUNT (sizeof(key_name) / sizeof(key_name[0]))
+
+static edn_emitter_token_t* tokens[KEY_COUNT];
+
+typedef struct {
+    size_t bytes;
+} count_sink_t;
+
+static int count_cb(const char* data, size_t n, void* ctx) {
+    (void) data;
+    ((count_sink_t*) ctx)->bytes += n;
+    return 0;
+}
+
+static size_t encode(bool use_tokens) {
+    count_sink_t sink = {0};
+    edn_emitter_t* em = edn_emitter_create(count_cb, &sink, NULL);
+    edn_emit_begin_vector(em);
+    for (int r = 0; r < RECORDS; r++) {
+        edn_emit_begin_map(em);
+        for (size_t k = 0; k < KEY_COUNT; k++) {
+            if (use_tokens) {
+                edn_emit_token(em, tokens[k]);
+            } else {
+                edn_emit_keyword_ns(em, key_ns[k], key_name[k]);
+            }
+            edn_emit_int(em, r * 31 + (int64_t) k);
+        }
+        edn_emit_end_map(em);
+    }
+    edn_emit_end_vector(em);
+    edn_emitter_finish(em);
+    edn_emitter_destroy(em);
+    return sink.bytes;
+}
+
+static double time_encode(bool use_tokens) {
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double start = get_time();
+        for (int i = 0; i < ITERATIONS; i++) {
+            encode(use_tokens);
+        }
+        double ns = (get_time() - start) * 1e9 / ITERATIONS;
+        best = (round == 0 || ns < best) ? ns : best;
+    }
+    return best;
+}
+
+int main(void) {
+    printf("Streaming Emitter Keyword Benchmarks\n");
+    printf("====================================\n");
+    printf("Iterations: %d (best of %d rounds)\n\n", ITERATIONS, ROUNDS);
+
+    for (size_t k = 0; k < KEY_COUNT; k++) {
+        tokens[k] = edn_emitter_make_keyword(key_ns[k], key_name[k]);
+        if (!tokens[k]) {
+            printf("ERROR: invalid benchmark keyword\n");
+            return 1;
+        }
+    }
+
+    size_t length = encode(false);
+    if (encode(true) != length) {
+        printf("ERROR: token output differs from keyword output\n");
+        return 1;
+    }
+    printf("Document: %zu bytes, %d records x %zu keys\n\n", length, RECORDS, (size_t) KEY_COUNT);
+
+    double kw_ns = time_encode(false);
+    double tok_ns = time_encode(true);
+
+    printf("  edn_emit_keyword_ns:          %9.1f ns/op  %7.1f MB/s\n", kw_ns,
+           length * 1e3 / kw_ns);
+    printf("  edn_emit_token:               %9.1f ns/op  %7.1f MB/s (%.2fx)\n", tok_ns,
+           length * 1e3 / tok_ns, kw_ns / tok_ns);
+
+    for (size_t k = 0; k < KEY_COUNT; k++) {
+        edn_emitter_token_free(tokens[k]);
+    }
+
+    printf("\nBenchmark complete.\n");
+    return 0;
+}
@@ -4,8 +4,20 @@
  * Simple timing utilities for benchmarking EDN parsing performance.
  * 
  * Note: On Unix/macOS/Linux, requires _POSIX_C_SOURCE=200809L for clock_gettime()
- * This is set via -D flag in Makefile for benchmark builds.
+ * and, on Linux, _DEFAULT_SOURCE for syscall(). Both are set via -D flags in
+ * the Makefile and CMakeLists.txt for benchmark builds.
  * On Windows, uses QueryPerformanceCounter.
+ *
+ * On Linux, setting EDN_BENCH_PERF=1 in the environment also counts cycles,
+ * instructions, branch misses and L1d/LLC misses with perf_event_open around
+ * the timed loop of bench_run, and bench_print_result adds IPC, cycles/byte
+ * and misses per iteration. Counters only cover user space. When the kernel
+ * refuses them (perf_event_paranoid, containers, VMs without a PMU) a note
+ * is printed once and only the timings are reported.
+ *
+ * bench_run also reports each result through bench_report.h (median, p99,
+ * throughput, counters, allocations), keyed by its `name` argument, so names
+ * passed to bench_run should be unique within a benchmark.
  */
 
 #ifndef BENCH_FRAMEWORK_H
@@ -17,6 +29,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "bench_report.h"
+
 #if defined(_WIN32) || defined(_WIN64)
 /* Windows timing */
 #include <windows.h>
@@ -40,17 +54,192 @@ static inline uint64_t bench_get_time_ns(void) {
 }
 #endif
 
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define BENCH_HAVE_PERF 1
+#else
+#define BENCH_HAVE_PERF 0
+#endif
+
+/* Hardware counters read around the timed loop, in this order */
+enum {
+    BENCH_PERF_CYCLES,
+    BENCH_PERF_INSTRUCTIONS,
+    BENCH_PERF_BRANCH_MISSES,
+    BENCH_PERF_L1D_MISSES,
+    BENCH_PERF_LLC_MISSES,
+    BENCH_PERF_COUNT
+};
+
+/* Counter totals over the timed loop; valid[i] is false where counter i is unsupported */
+typedef struct {
+    int enabled; /* Counters were opened for this run */
+    uint64_t values[BENCH_PERF_COUNT];
+    int valid[BENCH_PERF_COUNT];
+} bench_perf_t;
+
 /* Benchmark result */
 typedef struct {
     uint64_t iterations;
     uint64_t total_time_ns;
     double mean_time_us;
+    double median_time_us;         /* Median of the sampled iterations */
+    double p99_time_us;            /* 99th percentile of the sampled iterations */
     double stddev_time_us;         /* Standard deviation in microseconds */
     double confidence_interval_us; /* 95% confidence interval (±) in microseconds */
     double throughput_gbps;
     size_t data_size;
+    bench_perf_t perf; /* Hardware counters, when EDN_BENCH_PERF=1 */
+    long allocations;  /* Per bench_fn call, from the allocation counter; -1 if none is set */
 } bench_result_t;
 
+/**
+ * Optional allocation counter: given one closure returned by bench_fn (say
+ * a parsed document), return how many allocations produced it. Set with
+ * bench_set_allocation_counter; bench_run calls it once, outside timing.
+ */
+typedef size_t (*bench_allocation_fn)(void* closure);
+
+static bench_allocation_fn bench_allocation_counter = NULL;
+
+static inline void bench_set_allocation_counter(bench_allocation_fn count) {
+    bench_allocation_counter = count;
+}
+
+static inline int bench_compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return x < y ? -1 : x > y;
+}
+
+/* Send a finished result to bench_report (no-op unless EDN_BENCH_JSON is set) */
+static inline void bench_report_result(const char* name, const bench_result_t* result) {
+    bench_report(name, "median_us", result->median_time_us, "us");
+    bench_report(name, "p99_us", result->p99_time_us, "us");
+    bench_report(name, "mean_us", result->mean_time_us, "us");
+    if (result->data_size > 0) {
+        bench_report(name, "throughput", result->throughput_gbps, "GB/s");
+    }
+    if (result->allocations >= 0) {
+        bench_report(name, "allocations", (double) result->allocations, "count");
+    }
+    const bench_perf_t* perf = &result->perf;
+    if (perf->enabled && result->iterations > 0) {
+        if (perf->valid[BENCH_PERF_CYCLES] && perf->valid[BENCH_PERF_INSTRUCTIONS] &&
+            perf->values[BENCH_PERF_CYCLES] > 0) {
+            bench_report(name, "ipc",
+                         (double) perf->values[BENCH_PERF_INSTRUCTIONS] /
+                             (double) perf->values[BENCH_PERF_CYCLES],
+                         "IPC");
+        }
+        if (perf->valid[BENCH_PERF_CYCLES] && result->data_size > 0) {
+            bench_report(name, "cycles_per_byte",
+                         (double) perf->values[BENCH_PERF_CYCLES] / (double) result->iterations /
+                             (double) result->data_size,
+                         "cycles/byte");
+        }
+    }
+}
+
+#if BENCH_HAVE_PERF
+typedef struct {
+    int fds[BENCH_PERF_COUNT];
+} bench_perf_session_t;
+
+static inline int bench_perf_open(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    /* Counters are not grouped, so the kernel may multiplex them; scale by run time */
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/* Open the counters if EDN_BENCH_PERF is set; false if none could be opened */
+static inline int bench_perf_start(bench_perf_session_t* session) {
+    static int warned = 0;
+    const char* env = getenv("EDN_BENCH_PERF");
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        session->fds[i] = -1;
+    }
+    if (env == NULL || env[0] == '\0' || strcmp(env, "0") == 0) {
+        return 0;
+    }
+
+    const uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    session->fds[BENCH_PERF_CYCLES] =
+        bench_perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    session->fds[BENCH_PERF_INSTRUCTIONS] =
+        bench_perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    session->fds[BENCH_PERF_BRANCH_MISSES] =
+        bench_perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    session->fds[BENCH_PERF_L1D_MISSES] = bench_perf_open(PERF_TYPE_HW_CACHE, l1d_read_miss);
+    session->fds[BENCH_PERF_LLC_MISSES] =
+        bench_perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+    int opened = 0;
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        if (session->fds[i] >= 0) {
+            ioctl(session->fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(session->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+            opened = 1;
+        }
+    }
+    if (!opened && !warned) {
+        fprintf(stderr,
+                "NOTE: EDN_BENCH_PERF is set but perf_event_open failed; reporting timings "
+                "only (check /proc/sys/kernel/perf_event_paranoid)\n");
+        warned = 1;
+    }
+    return opened;
+}
+
+/* Stop and close the counters, filling `perf` */
+static inline void bench_perf_stop(bench_perf_session_t* session, bench_perf_t* perf) {
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        if (session->fds[i] >= 0) {
+            ioctl(session->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        uint64_t data[3]; /* value, time enabled, time running */
+        if (session->fds[i] < 0) {
+            continue;
+        }
+        if (read(session->fds[i], data, sizeof(data)) == (ssize_t) sizeof(data) && data[2] > 0) {
+            double scale = (double) data[1] / (double) data[2];
+            perf->values[i] = (uint64_t) ((double) data[0] * scale);
+            perf->valid[i] = 1;
+            perf->enabled = 1;
+        }
+        close(session->fds[i]);
+    }
+}
+#else
+typedef struct {
+    int unused;
+} bench_perf_session_t;
+
+static inline int bench_perf_start(bench_perf_session_t* session) {
+    (void) session;
+    return 0;
+}
+
+static inline void bench_perf_stop(bench_perf_session_t* session, bench_perf_t* perf) {
+    (void) session;
+    (void) perf;
+}
+#endif
+
 /**
  * Run benchmark for a minimum duration or minimum iterations
  * 
@@ -69,12 +258,16 @@ static inline bench_result_t bench_run(const char* name, const char* data, size_
                                        void (*bench_after_fn)(void*), int include_after_in_timing) {
     bench_result_t result = {0};
     result.data_size = size;
+    result.allocations = -1;
 
     uint64_t target_duration_ns = min_duration_ms * 1000000ULL;
 
     /* Warmup */
     for (int i = 0; i < 3; i++) {
         void* closure = bench_fn(data, size);
+        if (i == 0 && bench_allocation_counter != NULL && closure != NULL) {
+            result.allocations = (long) bench_allocation_counter(closure);
+        }
         if (bench_after_fn) {
             bench_after_fn(closure);
         }
@@ -89,6 +282,8 @@ static inline bench_result_t bench_run(const char* name, const char* data, size_
     }
 
     /* Main benchmark loop - collect samples */
+    bench_perf_session_t perf_session;
+    int perf_running = bench_perf_start(&perf_session);
     uint64_t iterations = 0;
     size_t sample_count = 0;
     uint64_t start_time = bench_get_time_ns();
@@ -101,6 +296,10 @@ static inline bench_result_t bench_run(const char* name, const char* data, size_
         void* closure = bench_fn(data, size);
         if (closure == NULL) {
             printf("ERROR: Benchmark function failed for %s\n", name);
+            if (perf_running) {
+                bench_perf_stop(&perf_session, &result.perf);
+                result.perf.enabled = 0;
+            }
             free(sample_times);
             return result;
         }
@@ -134,6 +333,9 @@ static inline bench_result_t bench_run(const char* name, const char* data, size_
             bench_after_fn(closure);
         }
     }
+    if (perf_running) {
+        bench_perf_stop(&perf_session, &result.perf);
+    }
 
     result.iterations = iterations;
     result.total_time_ns = elapsed;
@@ -166,6 +368,18 @@ static inline bench_result_t bench_run(const char* name, const char* data, size_
         result.confidence_interval_us = 0.0;
     }
 
+    /* Median and 99th percentile (nearest rank) of the samples */
+    if (sample_count > 0) {
+        qsort(sample_times, sample_count, sizeof(uint64_t), bench_compare_u64);
+        size_t p99_rank = (sample_count * 99 + 99) / 100;
+        result.median_time_us = (sample_count % 2 == 1)
+                                    ? (double) sample_times[sample_count / 2] / 1000.0
+                                    : ((double) sample_times[sample_count / 2 - 1] +
+                                       (double) sample_times[sample_count / 2]) /
+                                          2000.0;
+        result.p99_time_us = (double) sample_times[p99_rank - 1] / 1000.0;
+    }
+
     free(sample_times);
 
     /* Calculate throughput in GB/s */
@@ -174,6 +388,7 @@ static inline bench_result_t bench_run(const char* name, const char* data, size_
     double time_seconds = (double) elapsed / 1000000000.0;
     result.throughput_gbps = (total_bytes / time_seconds) / (1024.0 * 1024.0 * 1024.0);
 
+    bench_report_result(name, &result);
     return result;
 }
 
@@ -224,6 +439,36 @@ static inline void bench_print_result(const char* name, bench_result_t result) {
 
     printf("%5.3f GB/s  ", result.throughput_gbps);
     printf("(%zu bytes)\n", result.data_size);
+
+    const bench_perf_t* perf = &result.perf;
+    if (!perf->enabled || result.iterations == 0) {
+        return;
+    }
+    /* The loop includes the timing calls and, when untimed, bench_after_fn */
+    double per_iteration[BENCH_PERF_COUNT];
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        per_iteration[i] = (double) perf->values[i] / (double) result.iterations;
+    }
+    printf("%-25s ", "");
+    if (perf->valid[BENCH_PERF_CYCLES] && perf->valid[BENCH_PERF_INSTRUCTIONS] &&
+        perf->values[BENCH_PERF_CYCLES] > 0) {
+        printf("%.2f IPC  ", (double) perf->values[BENCH_PERF_INSTRUCTIONS] /
+                                 (double) perf->values[BENCH_PERF_CYCLES]);
+    }
+    if (perf->valid[BENCH_PERF_CYCLES] && result.data_size > 0) {
+        printf("%.2f cycles/byte  ", per_iteration[BENCH_PERF_CYCLES] / (double) result.data_size);
+    }
+    static const char* const labels[BENCH_PERF_COUNT] = {"cycles", "instructions", "branch-misses",
+                                                         "L1d-misses", "LLC-misses"};
+    printf("per iteration:");
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        if (perf->valid[i]) {
+            printf(" %.0f %s", per_iteration[i], labels[i]);
+        } else {
+            printf(" - %s", labels[i]);
+        }
+    }
+    printf("\n");
 }
 
 /**
@@ -2,6 +2,8 @@
  * Integration benchmarks using real EDN data files
  * 
  * Benchmarks the complete parsing pipeline with realistic workloads.
+ * When EDN_BENCH_DATA is set, its files are benchmarked in both modes
+ * instead of the built-in set (see bench_data.h).
  */
 
 #include <stdio.h>
@@ -9,6 +11,7 @@
 #include <string.h>
 
 #include "../include/edn.h"
+#include "bench_data.h"
 #include "bench_framework.h"
 
 /* Benchmark function that parses EDN and returns the value as closure */
@@ -27,6 +30,13 @@ static void bench_free_value(void* closure) {
     }
 }
 
+/* Allocation counter: arena blocks behind a parsed document */
+static size_t bench_arena_blocks(void* closure) {
+    edn_memory_stats_t stats;
+    edn_value_memory_usage((const edn_value_t*) closure, &stats);
+    return stats.blocks;
+}
+
 /* Read entire file into memory */
 static char* read_file(const char* path, size_t* out_size) {
     FILE* f = fopen(path, "rb");
@@ -66,11 +76,8 @@ static char* read_file(const char* path, size_t* out_size) {
     return buffer;
 }
 
-/* Benchmark a single file with both parse-only and roundtrip modes */
-static void bench_file(const char* filename, const char* description, int mode) {
-    char path[256];
-    snprintf(path, sizeof(path), "bench/data/%s", filename);
-
+/* Benchmark the file at `path` in parse-only (0) or roundtrip (1) mode */
+static void bench_path(const char* path, const char* description, int mode) {
     size_t size;
     char* data = read_file(path, &size);
 
@@ -80,24 +87,59 @@ static void bench_file(const char* filename, const char* description, int mode)
     }
 
     bench_result_t result;
+    char name[300]; /* Unique per mode for bench_report */
+    snprintf(name, sizeof(name), "%s%s", description, mode == 0 ? "" : " [roundtrip]");
+    /* Generated inputs reach gigabytes; 500ms bounds those, not 1000 iterations */
+    uint64_t min_iterations = size > 1000000 ? 5 : 1000;
 
     if (mode == 0) {
         /* Parse-only mode: measures pure parsing performance, cleanup is deferred (outside timing) */
-        result =
-            bench_run(description, data, size, 500, 1000, bench_parse_only, bench_free_value, 0);
+        result = bench_run(name, data, size, 500, min_iterations, bench_parse_only,
+                           bench_free_value, 0);
     } else {
         /* Roundtrip mode: includes both parse and free in the timing */
-        result =
-            bench_run(description, data, size, 500, 1000, bench_parse_only, bench_free_value, 1);
+        result = bench_run(name, data, size, 500, min_iterations, bench_parse_only,
+                           bench_free_value, 1);
     }
 
     bench_print_result(description, result);
     free(data);
 }
 
+/* Benchmark a bench/data file */
+static void bench_file(const char* filename, const char* description, int mode) {
+    char path[256];
+    snprintf(path, sizeof(path), "bench/data/%s", filename);
+    bench_path(path, description, mode);
+}
+
+/* Benchmark every EDN_BENCH_DATA file in both modes */
+static void bench_data_inputs(void) {
+    for (int mode = 0; mode < 2; mode++) {
+        printf("%s\n", mode == 0 ? "=== PARSE-ONLY MODE (EDN_BENCH_DATA) ==="
+                                 : "\n\n=== ROUNDTRIP MODE (EDN_BENCH_DATA) ===");
+        bench_print_header();
+        printf("\n");
+
+        bench_data_t inputs = bench_data_files(NULL, 0);
+        char path[512];
+        const char* label;
+        while (bench_data_next(&inputs, path, sizeof(path), &label)) {
+            bench_path(path, label, mode);
+        }
+    }
+}
+
 int main(void) {
     printf("EDN.C Integration Benchmarks\n");
     printf("============================\n\n");
+    bench_set_allocation_counter(bench_arena_blocks);
+
+    bench_data_t inputs = bench_data_files(NULL, 0);
+    if (bench_data_overridden(&inputs)) {
+        bench_data_inputs();
+        return 0;
+    }
 
     printf("=== PARSE-ONLY MODE (Pure Parsing Performance) ===\n");
     printf("Measures only parsing time, excludes memory cleanup\n\n");
@@ -0,0 +1,147 @@
+/**
+ * EDN.C - Wide map lookup and iteration benchmark
+ *
+ * Parses a vector of wide keyword-keyed maps (large enough to fall out of
+ * cache), then times keyword lookups with edn_map_get_keyword, generic
+ * lookups with edn_map_lookup, and a full key/value walk.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "bench_time.h"
+
+#define ROUNDS 5 /* Each timing keeps its fastest round */
+
+typedef struct {
+    int maps;
+    int width;
+} shape_t;
+
+static const shape_t shapes[] = {{4000, 16}, {1000, 64}, {250, 256}};
+
+static char* build_document(int maps, int width, size_t* out_len) {
+    size_t cap = (size_t) maps * (size_t) width * 48 + 16;
+    char* out = malloc(cap);
+    size_t pos = (size_t) snprintf(out, cap, "[");
+    for (int m = 0; m < maps; m++) {
+        pos += (size_t) snprintf(out + pos, cap - pos, "{");
+        for (int k = 0; k < width; k++) {
+            pos += (size_t) snprintf(out + pos, cap - pos, ":record/field-%d %d ", k, m + k);
+        }
+        pos += (size_t) snprintf(out + pos, cap - pos, "}\n");
+    }
+    pos += (size_t) snprintf(out + pos, cap - pos, "]");
+    *out_len = pos;
+    return out;
+}
+
+static double best_of(double (*fn)(const edn_value_t*, int, int64_t*), const edn_value_t* doc,
+                      int width, int64_t* sink) {
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double ns = fn(doc, width, sink);
+        best = (round == 0 || ns < best) ? ns : best;
+    }
+    return best;
+}
+
+/* ns per lookup: every map is probed for an early, a middle and a late key */
+static double time_get_keyword(const edn_value_t* doc, int width, int64_t* sink) {
+    char names[3][32];
+    int probes[3] = {1, width / 2, width - 1};
+    for (int p = 0; p < 3; p++) {
+        snprintf(names[p], sizeof(names[p]), "field-%d", probes[p]);
+    }
+    size_t count = edn_vector_count(doc);
+    double start = get_time();
+    for (size_t i = 0; i < count; i++) {
+        const edn_value_t* map = edn_vector_get(doc, i);
+        for (int p = 0; p < 3; p++) {
+            int64_t v = 0;
+            edn_int64_get(edn_map_get_namespaced_keyword(map, "record", names[p]), &v);
+            *sink += v;
+        }
+    }
+    return (get_time() - start) * 1e9 / (double) (count * 3);
+}
+
+static double time_lookup(const edn_value_t* doc, int width, int64_t* sink) {
+    char text[3][48];
+    edn_result_t keys[3];
+    int probes[3] = {1, width / 2, width - 1};
+    for (int p = 0; p < 3; p++) {
+        snprintf(text[p], sizeof(text[p]), ":record/field-%d", probes[p]);
+        keys[p] = edn_read(text[p], 0);
+    }
+    size_t count = edn_vector_count(doc);
+    double start = get_time();
+    for (size_t i = 0; i < count; i++) {
+        const edn_value_t* map = edn_vector_get(doc, i);
+        for (int p = 0; p < 3; p++) {
+            int64_t v = 0;
+            edn_int64_get(edn_map_lookup(map, keys[p].value), &v);
+            *sink += v;
+        }
+    }
+    double ns = (get_time() - start) * 1e9 / (double) (count * 3);
+    for (int p = 0; p < 3; p++) {
+        edn_free(keys[p].value);
+    }
+    return ns;
+}
+
+/* ns per entry visited */
+static double time_iterate(const edn_value_t* doc, int width, int64_t* sink) {
+    (void) width;
+    size_t count = edn_vector_count(doc);
+    size_t entries = 0;
+    double start = get_time();
+    for (size_t i = 0; i < count; i++) {
+        const edn_value_t* map = edn_vector_get(doc, i);
+        size_t n = edn_map_count(map);
+        for (size_t j = 0; j < n; j++) {
+            int64_t v = 0;
+            *sink += edn_type(edn_map_get_key(map, j));
+            edn_int64_get(edn_map_get_value(map, j), &v);
+            *sink += v;
+        }
+        entries += n;
+    }
+    return (get_time() - start) * 1e9 / (double) entries;
+}
+
+int main(void) {
+    printf("Wide Map Lookup Benchmarks\n");
+    printf("==========================\n");
+    printf("Best of %d rounds\n\n", ROUNDS);
+    printf("  %-12s %14s %14s %14s\n", "maps x keys", "get_keyword", "map_lookup", "iterate");
+    printf("  %-12s %14s %14s %14s\n", "", "ns/lookup", "ns/lookup", "ns/entry");
+
+    int64_t sink = 0;
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        size_t length;
+        char* input = build_document(shapes[s].maps, shapes[s].width, &length);
+        edn_result_t r = edn_read(input, length);
+        if (r.error != EDN_OK) {
+            printf("ERROR: benchmark document does not parse\n");
+            return 1;
+        }
+
+        double get_ns = best_of(time_get_keyword, r.value, shapes[s].width, &sink);
+        double lookup_ns = best_of(time_lookup, r.value, shapes[s].width, &sink);
+        double iter_ns = best_of(time_iterate, r.value, shapes[s].width, &sink);
+
+        char label[32];
+        snprintf(label, sizeof(label), "%d x %d", shapes[s].maps, shapes[s].width);
+        printf("  %-12s %14.1f %14.1f %14.2f\n", label, get_ns, lookup_ns, iter_ns);
+
+        edn_free(r.value);
+        free(input);
+    }
+
+    printf("\n(checksum %lld)\nBenchmark complete.\n", (long long) sink);
+    return 0;
+}
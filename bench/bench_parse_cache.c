@@ -0,0 +1,145 @@
+/**
+ * EDN.C - Parse-result cache benchmark
+ *
+ * For each bench/data file, times a plain edn_read + edn_free against an
+ * edn_parse_cache_read hit + edn_free of the same bytes, read from a fresh
+ * buffer each time like a payload off the network would be. A cold pass
+ * through the cache (hash, parse, freeze, insert) is timed too. Run from the
+ * repository root.
+ *
+ * EDN_BENCH_DATA replaces the bench/data files; see bench_data.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "bench_data.h"
+#include "bench_report.h"
+#include "bench_time.h"
+
+#define ROUNDS 5 /* Each timing keeps its fastest round */
+
+static const char* const files[] = {
+    "basic_10.edn",     "basic_100.edn",      "basic_1000.edn", "basic_10000.edn",
+    "basic_100000.edn", "keywords_10000.edn", "ints_1400.edn",  "strings_1000.edn",
+};
+
+static char* read_file(const char* path, size_t* out_size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(f);
+        return NULL;
+    }
+    char* buffer = malloc((size_t) size + 1);
+    if (buffer && fread(buffer, 1, (size_t) size, f) != (size_t) size) {
+        free(buffer);
+        buffer = NULL;
+    }
+    fclose(f);
+    if (buffer) {
+        buffer[size] = '\0';
+        *out_size = (size_t) size;
+    }
+    return buffer;
+}
+
+typedef struct {
+    double read_us;
+    double cold_us;
+    double hit_us;
+} timings_t;
+
+static double keep_best(double best, double us, int round) {
+    return (round == 0 || us < best) ? us : best;
+}
+
+static bool run_file(const char* data, size_t size, timings_t* t) {
+    int iterations = size > 1000000 ? 5 : size > 50000 ? 100 : size > 1000 ? 2000 : 20000;
+    char* payload = malloc(size + 1);
+    edn_parse_cache_t* cache = edn_parse_cache_create((size_t) 256 * 1024 * 1024, 0);
+    if (payload == NULL || cache == NULL) {
+        free(payload);
+        edn_parse_cache_destroy(cache);
+        return false;
+    }
+    memcpy(payload, data, size + 1);
+
+    edn_result_t r = edn_parse_cache_read(cache, payload, size, NULL);
+    if (r.error != EDN_OK) {
+        free(payload);
+        edn_parse_cache_destroy(cache);
+        return false;
+    }
+    edn_free(r.value);
+
+    for (int round = 0; round < ROUNDS; round++) {
+        double start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            edn_result_t p = edn_read(payload, size);
+            edn_free(p.value);
+        }
+        t->read_us = keep_best(t->read_us, (get_time() - start) * 1e6 / iterations, round);
+
+        start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            edn_parse_cache_clear(cache);
+            edn_result_t p = edn_parse_cache_read(cache, payload, size, NULL);
+            edn_free(p.value);
+        }
+        t->cold_us = keep_best(t->cold_us, (get_time() - start) * 1e6 / iterations, round);
+
+        start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            edn_result_t p = edn_parse_cache_read(cache, payload, size, NULL);
+            edn_free(p.value);
+        }
+        t->hit_us = keep_best(t->hit_us, (get_time() - start) * 1e6 / iterations, round);
+    }
+
+    free(payload);
+    edn_parse_cache_destroy(cache);
+    return true;
+}
+
+int main(void) {
+    printf("Parse Cache Benchmarks\n");
+    printf("======================\n");
+    printf("Times in us, best of %d rounds\n\n", ROUNDS);
+    printf("  %-22s %10s %10s %10s %10s %9s\n", "file", "bytes", "edn_read", "cold", "hit",
+           "speedup");
+
+    bench_data_t inputs = bench_data_files(files, sizeof(files) / sizeof(files[0]));
+    char path[512];
+    const char* label;
+    while (bench_data_next(&inputs, path, sizeof(path), &label)) {
+        size_t size = 0;
+        char* data = read_file(path, &size);
+        if (!data) {
+            printf("  %-22s FAILED (could not read file)\n", label);
+            continue;
+        }
+
+        timings_t t = {0};
+        if (!run_file(data, size, &t)) {
+            printf("  %-22s FAILED\n", label);
+        } else {
+            printf("  %-22s %10zu %10.2f %10.2f %10.2f %8.1fx\n", label, size, t.read_us,
+                   t.cold_us, t.hit_us, t.read_us / t.hit_us);
+            bench_report(label, "read_us", t.read_us, "us");
+            bench_report(label, "cold_us", t.cold_us, "us");
+            bench_report(label, "hit_us", t.hit_us, "us");
+        }
+        free(data);
+    }
+
+    printf("\nBenchmark complete.\n");
+    return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * EDN.C - Incremental reparse benchmark
+ *
+ * For each bench/data file, flips one letter or digit near the middle of the
+ * text back and forth and times edn_reparse of each edit against a full
+ * edn_read of the edited text. Both texts stay alive for the whole run, as edn_reparse
+ * requires. The periodic full parses edn_reparse makes to reclaim memory
+ * are included in its time. Run from the repository root.
+ *
+ * EDN_BENCH_DATA replaces the bench/data files; see bench_data.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "bench_data.h"
+#include "bench_report.h"
+#include "bench_time.h"
+
+#define ROUNDS 5 /* Each timing keeps its fastest round */
+
+static const char* const files[] = {
+    "basic_1000.edn",  "basic_10000.edn", "basic_100000.edn", "keywords_10000.edn",
+    "ints_1400.edn",   "strings_1000.edn", "nested_100000.edn",
+};
+
+static char* read_file(const char* path, size_t* out_size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(f);
+        return NULL;
+    }
+    char* buffer = malloc((size_t) size + 1);
+    if (buffer && fread(buffer, 1, (size_t) size, f) != (size_t) size) {
+        free(buffer);
+        buffer = NULL;
+    }
+    fclose(f);
+    if (buffer) {
+        buffer[size] = '\0';
+        *out_size = (size_t) size;
+    }
+    return buffer;
+}
+
+static double keep_best(double best, double us, int round) {
+    return (round == 0 || us < best) ? us : best;
+}
+
+/* Offset of the first digit or lowercase letter at or after `from` */
+static bool find_edit(const char* data, size_t size, size_t from, size_t* offset) {
+    for (size_t i = from; i < size; i++) {
+        if ((data[i] >= '0' && data[i] <= '9') || (data[i] >= 'a' && data[i] <= 'z')) {
+            *offset = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool run_file(const char* data, size_t size, double* read_us, double* reparse_us) {
+    int iterations = size > 1000000 ? 20 : size > 50000 ? 200 : size > 1000 ? 2000 : 20000;
+    char* texts[2] = {malloc(size + 1), malloc(size + 1)};
+    if (texts[0] == NULL || texts[1] == NULL) {
+        free(texts[0]);
+        free(texts[1]);
+        return false;
+    }
+    memcpy(texts[0], data, size + 1);
+    memcpy(texts[1], data, size + 1);
+
+    /* An edit that breaks the text (a duplicate map key, say) moves to the next byte */
+    size_t offset = size / 2;
+    bool found = false;
+    while (!found && find_edit(data, size, offset, &offset)) {
+        char c = data[offset];
+        texts[1][offset] =
+            (c >= '0' && c <= '9') ? (c == '1' ? '2' : '1') : (c == 'a' ? 'b' : 'a');
+        edn_result_t check = edn_read(texts[1], size);
+        edn_free(check.value);
+        found = check.error == EDN_OK;
+        if (!found) {
+            texts[1][offset++] = c;
+        }
+    }
+
+    edn_result_t r = edn_read(texts[0], size);
+    if (!found || r.error != EDN_OK) {
+        edn_free(r.value);
+        free(texts[0]);
+        free(texts[1]);
+        return false;
+    }
+    edn_value_t* root = r.value;
+    bool ok = true;
+    int current = 0;
+
+    for (int round = 0; round < ROUNDS && ok; round++) {
+        double start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            edn_result_t p = edn_read(texts[(i + 1) & 1], size);
+            edn_free(p.value);
+        }
+        *read_us = keep_best(*read_us, (get_time() - start) * 1e6 / iterations, round);
+
+        start = get_time();
+        for (int i = 0; i < iterations && ok; i++) {
+            int next = current ^ 1;
+            r = edn_reparse(root, texts[current], texts[next], size, offset, 1, 1, NULL);
+            ok = r.error == EDN_OK;
+            if (ok) {
+                root = r.value;
+                current = next;
+            }
+        }
+        *reparse_us = keep_best(*reparse_us, (get_time() - start) * 1e6 / iterations, round);
+    }
+
+    edn_free(root);
+    free(texts[0]);
+    free(texts[1]);
+    return ok;
+}
+
+int main(void) {
+    printf("Incremental Reparse Benchmarks\n");
+    printf("==============================\n");
+    printf("One-byte edit, times in us, best of %d rounds\n\n", ROUNDS);
+    printf("  %-22s %10s %10s %10s %9s\n", "file", "bytes", "edn_read", "reparse", "speedup");
+
+    bench_data_t inputs = bench_data_files(files, sizeof(files) / sizeof(files[0]));
+    char path[512];
+    const char* label;
+    while (bench_data_next(&inputs, path, sizeof(path), &label)) {
+        size_t size = 0;
+        char* data = read_file(path, &size);
+        if (!data) {
+            printf("  %-22s FAILED (could not read file)\n", label);
+            continue;
+        }
+
+        double read_us = 0;
+        double reparse_us = 0;
+        if (!run_file(data, size, &read_us, &reparse_us)) {
+            printf("  %-22s FAILED\n", label);
+        } else {
+            printf("  %-22s %10zu %10.2f %10.2f %8.1fx\n", label, size, read_us, reparse_us,
+                   read_us / reparse_us);
+            bench_report(label, "read_us", read_us, "us");
+            bench_report(label, "reparse_us", reparse_us, "us");
+        }
+        free(data);
+    }
+
+    printf("\nBenchmark complete.\n");
+    return 0;
+}
@@ -0,0 +1,58 @@
+/**
+ * Machine-readable benchmark results
+ *
+ * When EDN_BENCH_JSON names a file, every bench_report call appends one
+ * JSON object to it on its own line:
+ *
+ *   {"case": "basic_1000.edn", "metric": "read_us", "value": 4.31, "unit": "us"}
+ *
+ * Without EDN_BENCH_JSON the calls do nothing, so benchmarks report next
+ * to their printf output unconditionally. bench/runner/bench_runner sets
+ * the variable, runs each benchmark several times and compares the
+ * collected values against a baseline. Units "x", "GB/s" and "IPC" are
+ * higher-is-better; every other unit is lower-is-better.
+ */
+
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static inline void bench_report_string(FILE* f, const char* text) {
+    fputc('"', f);
+    for (const unsigned char* p = (const unsigned char*) text; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            fprintf(f, "\\%c", *p);
+        } else if (*p < 0x20) {
+            fprintf(f, "\\u%04x", *p);
+        } else {
+            fputc(*p, f);
+        }
+    }
+    fputc('"', f);
+}
+
+/* Append one result to $EDN_BENCH_JSON, if set */
+static inline void bench_report(const char* case_name, const char* metric, double value,
+                                const char* unit) {
+    const char* path = getenv("EDN_BENCH_JSON");
+    if (path == NULL || path[0] == '\0' || !isfinite(value)) {
+        return;
+    }
+    FILE* f = fopen(path, "a");
+    if (f == NULL) {
+        return;
+    }
+    fputs("{\"case\": ", f);
+    bench_report_string(f, case_name);
+    fputs(", \"metric\": ", f);
+    bench_report_string(f, metric);
+    fprintf(f, ", \"value\": %.17g, \"unit\": ", value);
+    bench_report_string(f, unit);
+    fputs("}\n", f);
+    fclose(f);
+}
+
+#endif /* BENCH_REPORT_H */
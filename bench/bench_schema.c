@@ -0,0 +1,139 @@
+/**
+ * EDN.C - Streaming schema validation benchmark
+ *
+ * Compares edn_schema_validate and edn_schema_read against parsing with
+ * edn_read and checking the tree afterwards, for a valid message and for
+ * one whose first field breaks the schema.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "bench_report.h"
+#include "bench_time.h"
+
+#define ITERATIONS 100000
+
+static const char* SCHEMA = "[:map"
+                            " [:id [:int {:min 1}]]"
+                            " [:kind [:enum :order :cancel]]"
+                            " [:items [:vector {:max 64} [:map [:sku :string] [:qty :int]]]]]";
+
+static char valid[8192];
+static char invalid[8192];
+
+/* The check edn_schema_validate replaces, run over the finished tree */
+static int check_by_hand(const char* input) {
+    edn_result_t r = edn_read(input, 0);
+    if (r.error != EDN_OK) {
+        return -1;
+    }
+
+    int rc = 0;
+    int64_t id = 0;
+    const char* name;
+    size_t name_length;
+    edn_value_t* items = edn_map_get_keyword(r.value, "items");
+    if (!edn_int64_get(edn_map_get_keyword(r.value, "id"), &id) || id < 1 ||
+        !edn_keyword_get(edn_map_get_keyword(r.value, "kind"), NULL, NULL, &name, &name_length) ||
+        edn_type(items) != EDN_TYPE_VECTOR || edn_vector_count(items) > 64) {
+        rc = -1;
+    }
+    for (size_t i = 0; rc == 0 && i < edn_vector_count(items); i++) {
+        edn_value_t* item = edn_vector_get(items, i);
+        if (!edn_is_string(edn_map_get_keyword(item, "sku")) ||
+            !edn_is_integer(edn_map_get_keyword(item, "qty"))) {
+            rc = -1;
+        }
+    }
+    edn_free(r.value);
+    return rc;
+}
+
+static void build_message(char* out, size_t size, int64_t id) {
+    size_t pos = (size_t) snprintf(out, size, "{:id %lld :kind :order :items [", (long long) id);
+    for (int i = 0; i < 60; i++) {
+        pos += (size_t) snprintf(out + pos, size - pos, "{:sku \"SKU-%04d\" :qty %d} ", i, i + 1);
+    }
+    snprintf(out + pos, size - pos, "]}");
+}
+
+static double time_validate(const edn_schema_t* schema, const char* input) {
+    double start = get_time();
+    for (int i = 0; i < ITERATIONS; i++) {
+        edn_schema_validate(schema, input, 0, NULL, 0);
+    }
+    return (get_time() - start) * 1e9 / ITERATIONS;
+}
+
+/* One pass that both checks and builds the tree */
+static double time_schema_read(const edn_schema_t* schema, const char* input) {
+    double start = get_time();
+    for (int i = 0; i < ITERATIONS; i++) {
+        edn_result_t r = edn_schema_read(schema, input, 0, NULL, NULL, 0);
+        edn_free(r.value);
+    }
+    return (get_time() - start) * 1e9 / ITERATIONS;
+}
+
+static double time_by_hand(const char* input) {
+    double start = get_time();
+    for (int i = 0; i < ITERATIONS; i++) {
+        check_by_hand(input);
+    }
+    return (get_time() - start) * 1e9 / ITERATIONS;
+}
+
+int main(void) {
+    printf("Schema Validation Benchmarks\n");
+    printf("============================\n");
+    printf("Iterations: %d\n\n", ITERATIONS);
+
+    const char* message = NULL;
+    edn_schema_t* schema = edn_schema_compile(SCHEMA, 0, &message);
+    if (schema == NULL) {
+        printf("ERROR: %s\n", message);
+        return 1;
+    }
+
+    build_message(valid, sizeof(valid), 42);
+    build_message(invalid, sizeof(invalid), 0);
+    if (edn_schema_validate(schema, valid, 0, NULL, 0).error != EDN_OK ||
+        check_by_hand(valid) != 0 ||
+        edn_schema_validate(schema, invalid, 0, NULL, 0).error != EDN_ERROR_SCHEMA_MISMATCH ||
+        edn_schema_read(schema, invalid, 0, NULL, NULL, 0).error != EDN_ERROR_SCHEMA_MISMATCH ||
+        check_by_hand(invalid) == 0) {
+        printf("ERROR: validators disagree\n");
+        edn_schema_destroy(schema);
+        return 1;
+    }
+
+    printf("Message size: %zu bytes\n\n", strlen(valid));
+
+    double hand_ok = time_by_hand(valid);
+    double schema_ok = time_validate(schema, valid);
+    double read_ok = time_schema_read(schema, valid);
+    printf("Valid message:\n");
+    printf("  edn_read + checks:   %9.1f ns/op\n", hand_ok);
+    printf("  edn_schema_validate: %9.1f ns/op (%.2fx)\n", schema_ok, hand_ok / schema_ok);
+    printf("  edn_schema_read:     %9.1f ns/op (%.2fx)\n\n", read_ok, hand_ok / read_ok);
+    bench_report("valid", "by_hand_ns", hand_ok, "ns");
+    bench_report("valid", "schema_validate_ns", schema_ok, "ns");
+    bench_report("valid", "schema_read_ns", read_ok, "ns");
+
+    double hand_bad = time_by_hand(invalid);
+    double schema_bad = time_validate(schema, invalid);
+    double read_bad = time_schema_read(schema, invalid);
+    printf("Invalid :id (first field):\n");
+    printf("  edn_read + checks:   %9.1f ns/op\n", hand_bad);
+    printf("  edn_schema_validate: %9.1f ns/op (%.2fx)\n", schema_bad, hand_bad / schema_bad);
+    printf("  edn_schema_read:     %9.1f ns/op (%.2fx)\n", read_bad, hand_bad / read_bad);
+    bench_report("invalid", "by_hand_ns", hand_bad, "ns");
+    bench_report("invalid", "schema_validate_ns", schema_bad, "ns");
+    bench_report("invalid", "schema_read_ns", read_bad, "ns");
+
+    edn_schema_destroy(schema);
+    printf("\nBenchmark complete.\n");
+    return 0;
+}
@@ -0,0 +1,271 @@
+/**
+ * EDN.C - Tape document benchmark
+ *
+ * For each bench/data file, times building an edn_value_t tree against
+ * building a tape, then a full depth-first walk over each: every node is
+ * visited and integers, doubles, string and keyword lengths are summed. A
+ * generated document larger than the caches is measured last. Run from the
+ * repository root.
+ *
+ * EDN_BENCH_DATA replaces the bench/data files; see bench_data.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "bench_data.h"
+#include "bench_report.h"
+#include "bench_time.h"
+
+#define ROUNDS 5 /* Each timing keeps its fastest round */
+
+static const char* const files[] = {
+    "basic_10000.edn",   "basic_100000.edn", "keywords_10000.edn", "ints_1400.edn",
+    "nested_100000.edn", "strings_1000.edn",
+};
+
+#define LARGE_RECORDS 200000 /* Generated document well past the cache sizes */
+
+static char* read_file(const char* path, size_t* out_size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(f);
+        return NULL;
+    }
+    char* buffer = malloc((size_t) size + 1);
+    if (buffer && fread(buffer, 1, (size_t) size, f) != (size_t) size) {
+        free(buffer);
+        buffer = NULL;
+    }
+    fclose(f);
+    if (buffer) {
+        buffer[size] = '\0';
+        *out_size = (size_t) size;
+    }
+    return buffer;
+}
+
+static char* build_large_document(size_t* out_size) {
+    size_t cap = (size_t) LARGE_RECORDS * 96 + 16;
+    char* out = malloc(cap);
+    if (!out) {
+        return NULL;
+    }
+    size_t pos = (size_t) snprintf(out, cap, "[");
+    for (int i = 0; i < LARGE_RECORDS; i++) {
+        pos += (size_t) snprintf(out + pos, cap - pos,
+                                 "{:id %d :name \"user-%d\" :score %d.5 :tags [:a :b] :active "
+                                 "true}\n",
+                                 i, i, i % 100);
+    }
+    pos += (size_t) snprintf(out + pos, cap - pos, "]");
+    *out_size = pos;
+    return out;
+}
+
+static int64_t walk_tree(const edn_value_t* v, size_t* nodes) {
+    int64_t sum = 0;
+    int64_t i;
+    double d;
+    size_t length;
+    const char* name;
+    (*nodes)++;
+    switch (edn_type(v)) {
+        case EDN_TYPE_INT:
+            edn_int64_get(v, &i);
+            return i;
+        case EDN_TYPE_FLOAT:
+            edn_double_get(v, &d);
+            return (int64_t) d;
+        case EDN_TYPE_STRING:
+            edn_string_get(v, &length);
+            return (int64_t) length;
+        case EDN_TYPE_KEYWORD:
+            edn_keyword_get(v, NULL, NULL, &name, &length);
+            return (int64_t) length;
+        case EDN_TYPE_VECTOR:
+            for (size_t k = 0, n = edn_vector_count(v); k < n; k++) {
+                sum += walk_tree(edn_vector_get(v, k), nodes);
+            }
+            return sum;
+        case EDN_TYPE_LIST:
+            for (size_t k = 0, n = edn_list_count(v); k < n; k++) {
+                sum += walk_tree(edn_list_get(v, k), nodes);
+            }
+            return sum;
+        case EDN_TYPE_SET:
+            for (size_t k = 0, n = edn_set_count(v); k < n; k++) {
+                sum += walk_tree(edn_set_get(v, k), nodes);
+            }
+            return sum;
+        case EDN_TYPE_MAP:
+            for (size_t k = 0, n = edn_map_count(v); k < n; k++) {
+                sum += walk_tree(edn_map_get_key(v, k), nodes);
+                sum += walk_tree(edn_map_get_value(v, k), nodes);
+            }
+            return sum;
+        case EDN_TYPE_TAGGED: {
+            const char* tag;
+            edn_value_t* inner = NULL;
+            edn_tagged_get(v, &tag, NULL, &inner);
+            return walk_tree(inner, nodes);
+        }
+        default:
+            return 0;
+    }
+}
+
+static int64_t walk_tape(const edn_tape_t* tape, size_t* nodes) {
+    int64_t sum = 0;
+    edn_tape_cursor_t c = edn_tape_root(tape);
+    edn_tape_item_t item;
+    while (edn_tape_iter_next(&c, &item)) {
+        if (item.end) {
+            continue;
+        }
+        (*nodes)++;
+        switch (item.type) {
+            case EDN_TYPE_INT:
+                sum += item.integer;
+                break;
+            case EDN_TYPE_FLOAT:
+                sum += (int64_t) item.floating;
+                break;
+            case EDN_TYPE_STRING:
+            case EDN_TYPE_KEYWORD:
+                sum += (int64_t) item.length;
+                break;
+            default:
+                break;
+        }
+    }
+    return sum;
+}
+
+typedef struct {
+    double tree_parse_us;
+    double tape_parse_us;
+    double tree_walk_us;
+    double tape_walk_us;
+} timings_t;
+
+static double keep_best(double best, double us, int round) {
+    return (round == 0 || us < best) ? us : best;
+}
+
+static bool run_file(const char* data, size_t size, timings_t* t, size_t* nodes_out) {
+    int iterations = size > 1000000 ? 2 : size > 50000 ? 50 : 500;
+    edn_result_t r = edn_read(data, size);
+    edn_tape_t* tape = NULL;
+    edn_result_t tr = edn_tape_read(data, size, &tape);
+    if (r.error != EDN_OK || tr.error != EDN_OK) {
+        edn_free(r.value);
+        edn_tape_free(tape);
+        return false;
+    }
+
+    size_t tree_nodes = 0, tape_nodes = 0;
+    int64_t tree_sum = walk_tree(r.value, &tree_nodes);
+    int64_t tape_sum = walk_tape(tape, &tape_nodes);
+    if (tree_sum != tape_sum || tree_nodes != tape_nodes) {
+        printf("ERROR: tree and tape walks disagree\n");
+        edn_free(r.value);
+        edn_tape_free(tape);
+        return false;
+    }
+    *nodes_out = tree_nodes;
+
+    volatile int64_t sink = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            edn_result_t p = edn_read(data, size);
+            edn_free(p.value);
+        }
+        t->tree_parse_us =
+            keep_best(t->tree_parse_us, (get_time() - start) * 1e6 / iterations, round);
+
+        start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            edn_tape_t* p = NULL;
+            edn_tape_read(data, size, &p);
+            edn_tape_free(p);
+        }
+        t->tape_parse_us =
+            keep_best(t->tape_parse_us, (get_time() - start) * 1e6 / iterations, round);
+
+        size_t nodes = 0;
+        start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            sink += walk_tree(r.value, &nodes);
+        }
+        t->tree_walk_us =
+            keep_best(t->tree_walk_us, (get_time() - start) * 1e6 / iterations, round);
+
+        start = get_time();
+        for (int i = 0; i < iterations; i++) {
+            sink += walk_tape(tape, &nodes);
+        }
+        t->tape_walk_us =
+            keep_best(t->tape_walk_us, (get_time() - start) * 1e6 / iterations, round);
+    }
+    (void) sink;
+
+    edn_free(r.value);
+    edn_tape_free(tape);
+    return true;
+}
+
+int main(void) {
+    printf("Tape Document Benchmarks\n");
+    printf("========================\n");
+    printf("Times in us, best of %d rounds\n\n", ROUNDS);
+    printf("  %-22s %9s %10s %10s %10s %10s %8s\n", "file", "nodes", "read", "tape_read",
+           "tree walk", "tape walk", "speedup");
+
+    bench_data_t inputs = bench_data_files(files, sizeof(files) / sizeof(files[0]));
+    bool large = false;
+    while (!large) {
+        char path[512];
+        const char* label;
+        size_t size = 0;
+        char* data;
+        if (bench_data_next(&inputs, path, sizeof(path), &label)) {
+            data = read_file(path, &size);
+        } else {
+            large = true;
+            label = "generated (large)";
+            data = build_large_document(&size);
+        }
+        if (!data) {
+            printf("  %-22s FAILED (could not read file)\n", label);
+            continue;
+        }
+
+        timings_t t = {0};
+        size_t nodes = 0;
+        if (!run_file(data, size, &t, &nodes)) {
+            printf("  %-22s FAILED\n", label);
+        } else {
+            printf("  %-22s %9zu %10.1f %10.1f %10.1f %10.1f %7.2fx\n", label, nodes,
+                   t.tree_parse_us, t.tape_parse_us, t.tree_walk_us, t.tape_walk_us,
+                   t.tree_walk_us / t.tape_walk_us);
+            bench_report(label, "read_us", t.tree_parse_us, "us");
+            bench_report(label, "tape_read_us", t.tape_parse_us, "us");
+            bench_report(label, "tree_walk_us", t.tree_walk_us, "us");
+            bench_report(label, "tape_walk_us", t.tape_walk_us, "us");
+        }
+        free(data);
+    }
+
+    printf("\nBenchmark complete.\n");
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * EDN.C - Validation-only parse benchmark
+ *
+ * Compares edn_validate, with and without duplicate checks, against the
+ * common "validate by parsing" idiom: edn_read followed by edn_free.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "bench_report.h"
+#include "bench_time.h"
+
+#define ITERATIONS 20000
+#define ROUNDS 5 /* Each timing keeps its fastest round */
+
+static char document[65536];
+
+/* A batch of records mixing the value kinds seen in typical payloads */
+static size_t build_document(char* out, size_t size) {
+    size_t pos =
+        (size_t) snprintf(out, size, "{:batch/id 7781 :batch/source \"ingest-03\" :records [");
+    for (int i = 0; i < 100 && pos < size; i++) {
+        pos += (size_t) snprintf(out + pos, size - pos,
+                                 "{:id %d :user/name \"user-%04d\" :active %s :score %d.%02d"
+                                 " :tags #{:alpha :beta} :loc [%d -%d] :note nil}\n",
+                                 100000 + i, i, (i & 1) ? "true" : "false", i, i % 100, i * 3,
+                                 i * 7);
+    }
+    pos += (size_t) snprintf(out + pos, size - pos, "]}");
+    return pos;
+}
+
+static double time_read(const char* input, size_t length) {
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double start = get_time();
+        for (int i = 0; i < ITERATIONS; i++) {
+            edn_result_t r = edn_read(input, length);
+            edn_free(r.value);
+        }
+        double ns = (get_time() - start) * 1e9 / ITERATIONS;
+        best = (round == 0 || ns < best) ? ns : best;
+    }
+    return best;
+}
+
+static double time_validate(const char* input, size_t length,
+                            const edn_validate_options_t* options) {
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double start = get_time();
+        for (int i = 0; i < ITERATIONS; i++) {
+            edn_validate(input, length, options, NULL);
+        }
+        double ns = (get_time() - start) * 1e9 / ITERATIONS;
+        best = (round == 0 || ns < best) ? ns : best;
+    }
+    return best;
+}
+
+int main(void) {
+    printf("Validation-only Parse Benchmarks\n");
+    printf("================================\n");
+    printf("Iterations: %d (best of %d rounds)\n\n", ITERATIONS, ROUNDS);
+
+    size_t length = build_document(document, sizeof(document));
+
+    uint64_t scratch[512];
+    edn_validate_options_t plain = {0};
+    plain.struct_size = sizeof(plain);
+    edn_validate_options_t dedup = plain;
+    dedup.check_duplicates = true;
+    dedup.scratch = scratch;
+    dedup.scratch_size = sizeof(scratch);
+
+    edn_validate_stats_t stats;
+    edn_result_t check = edn_read(document, length);
+    if (check.error != EDN_OK || edn_validate(document, length, &dedup, &stats).error != EDN_OK) {
+        printf("ERROR: benchmark document does not parse\n");
+        return 1;
+    }
+    edn_free(check.value);
+
+    printf("Document: %zu bytes, %zu forms, %zu collections, depth %zu\n\n", length, stats.forms,
+           stats.collections, stats.max_depth);
+
+    double read_ns = time_read(document, length);
+    double plain_ns = time_validate(document, length, &plain);
+    double dedup_ns = time_validate(document, length, &dedup);
+
+    printf("  edn_read + edn_free:          %9.1f ns/op  %7.1f MB/s\n", read_ns,
+           length * 1e3 / read_ns);
+    printf("  edn_validate:                 %9.1f ns/op  %7.1f MB/s (%.2fx)\n", plain_ns,
+           length * 1e3 / plain_ns, read_ns / plain_ns);
+    printf("  edn_validate (duplicates):    %9.1f ns/op  %7.1f MB/s (%.2fx)\n", dedup_ns,
+           length * 1e3 / dedup_ns, read_ns / dedup_ns);
+    bench_report("document", "read_ns", read_ns, "ns");
+    bench_report("document", "validate_ns", plain_ns, "ns");
+    bench_report("document", "validate_duplicates_ns", dedup_ns, "ns");
+
+    printf("\nBenchmark complete.\n");
+    return 0;
+}
@@ -0,0 +1,518 @@
+/**
+ * EDN.C - Synthetic benchmark corpus generator
+ *
+ * Writes one EDN vector of generated items of a chosen shape, stopping at
+ * the first item that takes the output past the requested size. Output is
+ * deterministic for a (shape, seed) pair: items come from a seeded
+ * splitmix64 stream, so a smaller file holds the first items of a larger
+ * one. Items are streamed through a fixed buffer, so a 10GB file needs no
+ * more memory than a 1KB one.
+ *
+ * The clojure shape uses metadata, ratios, namespaced maps and \uXXXX
+ * string escapes and only parses with EDN_ENABLE_CLOJURE_EXTENSION; every
+ * other shape is plain EDN.
+ *
+ * Usage: gen_corpus --shape NAME --size SIZE [--seed N] [-o FILE]
+ *        gen_corpus --list
+ *
+ * SIZE is a byte count with an optional K, M or G suffix (powers of 1024).
+ * `make bench-corpus` writes the shape/size matrix to bench/data/gen/.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OUT_BUFFER_SIZE (1 << 16)
+#define NESTED_MAX_DEPTH 128 /* Well inside the reader's default limit of 1024 */
+
+/* ======================================================================== */
+/* Output                                                                   */
+/* ======================================================================== */
+
+typedef struct {
+    FILE* file;
+    char buffer[OUT_BUFFER_SIZE];
+    size_t used;
+    uint64_t written; /* Bytes produced so far, flushed or not */
+    bool failed;
+} out_t;
+
+static void out_flush(out_t* out) {
+    if (out->used > 0 && fwrite(out->buffer, 1, out->used, out->file) != out->used) {
+        out->failed = true;
+    }
+    out->used = 0;
+}
+
+static void out_bytes(out_t* out, const char* bytes, size_t length) {
+    if (out->used + length > OUT_BUFFER_SIZE) {
+        out_flush(out);
+    }
+    memcpy(out->buffer + out->used, bytes, length);
+    out->used += length;
+    out->written += length;
+}
+
+static void out_str(out_t* out, const char* text) {
+    out_bytes(out, text, strlen(text));
+}
+
+static void out_char(out_t* out, char c) {
+    out_bytes(out, &c, 1);
+}
+
+static void out_fmt(out_t* out, const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length > 0) {
+        out_bytes(out, text, (size_t) length < sizeof(text) ? (size_t) length : sizeof(text) - 1);
+    }
+}
+
+/* ======================================================================== */
+/* Random numbers                                                           */
+/* ======================================================================== */
+
+typedef struct {
+    uint64_t state;
+} rng_t;
+
+static uint64_t rng_next(rng_t* rng) {
+    uint64_t z = (rng->state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* Uniform in [0, n) */
+static uint64_t rng_below(rng_t* rng, uint64_t n) {
+    return rng_next(rng) % n;
+}
+
+/* Uniform in [lo, hi] */
+static int64_t rng_range(rng_t* rng, int64_t lo, int64_t hi) {
+    return lo + (int64_t) rng_below(rng, (uint64_t) (hi - lo) + 1);
+}
+
+static double rng_double(rng_t* rng) {
+    return (double) (rng_next(rng) >> 11) / 9007199254740992.0;
+}
+
+#define PICK(rng, array) ((array)[rng_below((rng), sizeof(array) / sizeof((array)[0]))])
+
+static const char* const words[] = {
+    "alpha", "beta",   "gamma",  "delta", "order", "user",    "event", "session",
+    "click", "view",   "buy",    "cart",  "item",  "price",   "total", "status",
+    "ok",    "failed", "region", "zone",  "node",  "cluster", "query", "result",
+};
+
+static void out_words(out_t* out, rng_t* rng, int count) {
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            out_char(out, ' ');
+        }
+        out_str(out, PICK(rng, words));
+    }
+}
+
+/* ======================================================================== */
+/* Shapes                                                                   */
+/* ======================================================================== */
+
+/* Homogeneous event records, the usual shape of a log or API batch */
+static void gen_records(out_t* out, rng_t* rng, uint64_t index) {
+    static const char* const kinds[] = {"click", "view", "buy", "scroll", "exit"};
+    static const char* const regions[] = {"eu-west", "eu-north", "us-east", "us-west", "ap-south"};
+    static const char* const flags[] = {"new", "returning", "mobile", "desktop", "trial"};
+    out_fmt(out, "{:id %" PRIu64 " :user \"user-%" PRIu64 "\" :email \"u%" PRIu64 "@example.com\"",
+            index, rng_below(rng, 100000), rng_below(rng, 100000));
+    out_fmt(out, " :kind :%s :score %.2f :ok %s", PICK(rng, kinds), rng_double(rng) * 100.0,
+            rng_below(rng, 4) != 0 ? "true" : "false");
+    out_fmt(out, " :tags #{:%s :%s} :created %" PRIu64 " :region :%s}", PICK(rng, words),
+            PICK(rng, flags), (uint64_t) 1700000000000ULL + rng_below(rng, 100000000000ULL),
+            PICK(rng, regions));
+}
+
+/* Maps of 128 to 255 entries; each field keeps one value type across maps */
+static void gen_wide_maps(out_t* out, rng_t* rng, uint64_t index) {
+    (void) index;
+    uint64_t fields = 128 + rng_below(rng, 128);
+    out_char(out, '{');
+    for (uint64_t f = 0; f < fields; f++) {
+        if (f > 0) {
+            out_char(out, ' ');
+        }
+        out_fmt(out, ":field-%" PRIu64 " ", f);
+        switch (f % 6) {
+            case 0:
+                out_fmt(out, "%" PRId64, rng_range(rng, -1000000, 1000000));
+                break;
+            case 1:
+                out_fmt(out, "%.4f", rng_double(rng) * 1000.0);
+                break;
+            case 2:
+                out_fmt(out, "\"%s-%" PRIu64 "\"", PICK(rng, words), rng_below(rng, 1000));
+                break;
+            case 3:
+                out_fmt(out, ":%s", PICK(rng, words));
+                break;
+            case 4:
+                out_str(out, rng_below(rng, 2) ? "true" : "false");
+                break;
+            default:
+                out_str(out, rng_below(rng, 3) == 0 ? "nil" : "[1 2 3]");
+                break;
+        }
+    }
+    out_char(out, '}');
+}
+
+/* Chains of 16 to 127 nested maps, vectors, lists and sets */
+static void gen_nested(out_t* out, rng_t* rng, uint64_t index) {
+    (void) index;
+    char closers[NESTED_MAX_DEPTH];
+    int depth = (int) rng_range(rng, 16, NESTED_MAX_DEPTH - 1);
+    for (int level = 0; level < depth; level++) {
+        switch (rng_below(rng, 4)) {
+            case 0:
+                out_fmt(out, "{:level %d :child ", level);
+                closers[level] = '}';
+                break;
+            case 1:
+                out_fmt(out, "[%d ", level);
+                closers[level] = ']';
+                break;
+            case 2:
+                out_str(out, "(node ");
+                closers[level] = ')';
+                break;
+            default:
+                /* A set holding the rest of the chain as its only element */
+                out_str(out, "#{");
+                closers[level] = '}';
+                break;
+        }
+    }
+    out_fmt(out, ":leaf-%" PRIu64, rng_below(rng, 100));
+    for (int level = depth - 1; level >= 0; level--) {
+        out_char(out, closers[level]);
+    }
+}
+
+/* Strings with an escape sequence after every word */
+static void gen_escapes(out_t* out, rng_t* rng, uint64_t index) {
+    /* \uXXXX is Clojure-only in strings; the clojure shape has those */
+    static const char* const escapes[] = {"\\n", "\\t", "\\\"", "\\\\", "\\r"};
+    (void) index;
+    out_char(out, '[');
+    for (int s = 0; s < 4; s++) {
+        if (s > 0) {
+            out_char(out, ' ');
+        }
+        out_char(out, '"');
+        int pieces = (int) rng_range(rng, 4, 16);
+        for (int p = 0; p < pieces; p++) {
+            out_str(out, PICK(rng, words));
+            out_str(out, PICK(rng, escapes));
+        }
+        out_char(out, '"');
+    }
+    out_char(out, ']');
+}
+
+/* Strings mixing ASCII words with 2-, 3- and 4-byte UTF-8 sequences */
+static void gen_unicode(out_t* out, rng_t* rng, uint64_t index) {
+    static const char* const texts[] = {
+        "\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82",         /* Cyrillic */
+        "\xce\xba\xce\xb1\xce\xbb\xce\xb7\xce\xbc\xce\xad\xcf\x81\xce\xb1", /* Greek */
+        "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e",                     /* CJK */
+        "\xed\x95\x9c\xea\xb5\xad\xec\x96\xb4",                     /* Hangul */
+        "caf\xc3\xa9",                                               /* Latin-1 range */
+        "\xf0\x9f\x98\x80\xf0\x9f\x9a\x80",                         /* Emoji */
+    };
+    (void) index;
+    out_char(out, '[');
+    for (int s = 0; s < 4; s++) {
+        if (s > 0) {
+            out_char(out, ' ');
+        }
+        out_char(out, '"');
+        int pieces = (int) rng_range(rng, 3, 12);
+        for (int p = 0; p < pieces; p++) {
+            if (p > 0) {
+                out_char(out, ' ');
+            }
+            out_str(out, rng_below(rng, 3) == 0 ? PICK(rng, words) : PICK(rng, texts));
+        }
+        out_char(out, '"');
+    }
+    out_char(out, ']');
+}
+
+/* Decimal digits for big integers and decimals */
+static void out_digits(out_t* out, rng_t* rng, int count) {
+    out_char(out, (char) ('1' + rng_below(rng, 9)));
+    for (int i = 1; i < count; i++) {
+        out_char(out, (char) ('0' + rng_below(rng, 10)));
+    }
+}
+
+/* Vectors of 16 numbers: int64, doubles, big integers and big decimals */
+static void gen_numbers(out_t* out, rng_t* rng, uint64_t index) {
+    (void) index;
+    out_char(out, '[');
+    for (int n = 0; n < 16; n++) {
+        if (n > 0) {
+            out_char(out, ' ');
+        }
+        switch (rng_below(rng, 6)) {
+            case 0:
+                out_fmt(out, "%" PRId64, (int64_t) rng_next(rng));
+                break;
+            case 1:
+                out_fmt(out, "%" PRId64, rng_range(rng, -1000, 1000));
+                break;
+            case 2:
+                out_fmt(out, "%.17g", (rng_double(rng) - 0.5) * 1e6);
+                break;
+            case 3:
+                out_fmt(out, "%.6e", rng_double(rng) * 1e-12);
+                break;
+            case 4:
+                /* Past int64, with and without the N suffix */
+                out_digits(out, rng, (int) rng_range(rng, 20, 40));
+                if (rng_below(rng, 2)) {
+                    out_char(out, 'N');
+                }
+                break;
+            default:
+                out_digits(out, rng, (int) rng_range(rng, 1, 12));
+                out_char(out, '.');
+                out_digits(out, rng, (int) rng_range(rng, 1, 20));
+                out_char(out, 'M');
+                break;
+        }
+    }
+    out_char(out, ']');
+}
+
+static void out_uuid(out_t* out, rng_t* rng) {
+    uint64_t hi = rng_next(rng);
+    uint64_t lo = rng_next(rng);
+    out_fmt(out, "#uuid \"%08" PRIx64 "-%04" PRIx64 "-4%03" PRIx64 "-%04" PRIx64 "-%012" PRIx64 "\"",
+            hi >> 32, (hi >> 16) & 0xffff, hi & 0xfff, 0x8000 | (lo >> 48 & 0x3fff),
+            lo & 0xffffffffffffULL);
+}
+
+static void out_inst(out_t* out, rng_t* rng) {
+    out_fmt(out, "#inst \"20%02d-%02d-%02dT%02d:%02d:%02d.%03dZ\"", (int) rng_range(rng, 10, 30),
+            (int) rng_range(rng, 1, 12), (int) rng_range(rng, 1, 28), (int) rng_range(rng, 0, 23),
+            (int) rng_range(rng, 0, 59), (int) rng_range(rng, 0, 59), (int) rng_range(rng, 0, 999));
+}
+
+/* Records keyed by #uuid with #inst timestamps */
+static void gen_tagged(out_t* out, rng_t* rng, uint64_t index) {
+    out_str(out, "{:id ");
+    out_uuid(out, rng);
+    out_fmt(out, " :seq %" PRIu64 " :created ", index);
+    out_inst(out, rng);
+    out_str(out, " :updated ");
+    out_inst(out, rng);
+    out_str(out, " :parent ");
+    out_uuid(out, rng);
+    out_str(out, "}");
+}
+
+/* Metadata, ratios, namespaced maps and \uXXXX escapes (Clojure extension) */
+static void gen_clojure(out_t* out, rng_t* rng, uint64_t index) {
+    out_fmt(out, "^{:line %" PRIu64 " :file \"src/%s.clj\"} ", index + 1, PICK(rng, words));
+    if (rng_below(rng, 2)) {
+        out_str(out, "^:private ");
+    }
+    out_fmt(out, "#:entity{:id %" PRIu64 " :name \"%s\" :share %" PRIu64 "/%" PRIu64, index,
+            PICK(rng, words), (uint64_t) rng_range(rng, 1, 99), (uint64_t) rng_range(rng, 100, 999));
+    out_str(out, " :doc \"caf\\u00e9 \\u2603 \\u03b1\"");
+    out_fmt(out, " :weights [%" PRIu64 "/3 %" PRIu64 "/7 -%" PRIu64 "/11] :tag ^String %s}",
+            (uint64_t) rng_range(rng, 1, 2), (uint64_t) rng_range(rng, 1, 6),
+            (uint64_t) rng_range(rng, 1, 10), PICK(rng, words));
+}
+
+/* Records where most of the text is #_ discards and comments */
+static void gen_discard(out_t* out, rng_t* rng, uint64_t index) {
+    out_str(out, "#_ {:old-id ");
+    out_fmt(out, "%" PRIu64 " :debug [", index);
+    out_words(out, rng, (int) rng_range(rng, 2, 8));
+    out_str(out, "]}\n");
+    out_fmt(out, "; record %" PRIu64 ": ", index);
+    out_words(out, rng, (int) rng_range(rng, 3, 10));
+    out_fmt(out, "\n{:id %" PRIu64 " #_ :legacy-field #_ \"", index);
+    out_words(out, rng, 4);
+    out_fmt(out, "\" :value %" PRId64 " #_#_ :a :b :status :%s}", rng_range(rng, -500, 500),
+            PICK(rng, words));
+}
+
+typedef struct {
+    const char* name;
+    const char* description;
+    void (*item)(out_t* out, rng_t* rng, uint64_t index);
+} shape_t;
+
+static const shape_t shapes[] = {
+    {"records", "homogeneous event maps (ints, strings, keywords, doubles, sets)", gen_records},
+    {"wide-maps", "maps of 128-255 keyword keys with mixed value types", gen_wide_maps},
+    {"nested", "chains of 16-127 nested maps, vectors, lists and sets", gen_nested},
+    {"escapes", "strings dense with escape sequences", gen_escapes},
+    {"unicode", "strings of 2-, 3- and 4-byte UTF-8 text", gen_unicode},
+    {"numbers", "int64, doubles, big integers (N) and big decimals (M)", gen_numbers},
+    {"tagged", "maps of #uuid and #inst tagged literals", gen_tagged},
+    {"discard", "records buried in #_ discards and comments", gen_discard},
+    {"clojure", "metadata, ratios, namespaced maps, \\u escapes (Clojure extension)", gen_clojure},
+};
+
+/* ======================================================================== */
+/* Command line                                                             */
+/* ======================================================================== */
+
+static const shape_t* find_shape(const char* name) {
+    for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+        if (strcmp(shapes[i].name, name) == 0) {
+            return &shapes[i];
+        }
+    }
+    return NULL;
+}
+
+/* "64K" -> 65536; false on a malformed or zero size */
+static bool parse_size(const char* text, uint64_t* out) {
+    char* end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (errno != 0 || end == text || value == 0) {
+        return false;
+    }
+    int shift = 0;
+    switch (*end) {
+        case '\0':
+            break;
+        case 'k':
+        case 'K':
+            shift = 10;
+            end++;
+            break;
+        case 'm':
+        case 'M':
+            shift = 20;
+            end++;
+            break;
+        case 'g':
+        case 'G':
+            shift = 30;
+            end++;
+            break;
+        default:
+            return false;
+    }
+    if (*end != '\0' || value > (UINT64_MAX >> shift)) {
+        return false;
+    }
+    *out = (uint64_t) value << shift;
+    return true;
+}
+
+static void usage(FILE* stream) {
+    fprintf(stream, "Usage: gen_corpus --shape NAME --size SIZE [--seed N] [-o FILE]\n"
+                    "       gen_corpus --list\n"
+                    "SIZE takes a K, M or G suffix. Output goes to stdout without -o.\n");
+}
+
+int main(int argc, char** argv) {
+    const shape_t* shape = NULL;
+    uint64_t size = 0;
+    uint64_t seed = 1;
+    const char* path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--list") == 0) {
+            for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+                printf("%-10s %s\n", shapes[s].name, shapes[s].description);
+            }
+            return 0;
+        } else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (value == NULL) {
+            usage(stderr);
+            return 1;
+        } else if (strcmp(arg, "--shape") == 0) {
+            shape = find_shape(value);
+            if (shape == NULL) {
+                fprintf(stderr, "Unknown shape '%s' (see --list)\n", value);
+                return 1;
+            }
+        } else if (strcmp(arg, "--size") == 0) {
+            if (!parse_size(value, &size)) {
+                fprintf(stderr, "Invalid size '%s'\n", value);
+                return 1;
+            }
+        } else if (strcmp(arg, "--seed") == 0) {
+            char* end;
+            seed = strtoull(value, &end, 10);
+            if (end == value || *end != '\0') {
+                fprintf(stderr, "Invalid seed '%s'\n", value);
+                return 1;
+            }
+        } else if (strcmp(arg, "-o") == 0) {
+            path = value;
+        } else {
+            usage(stderr);
+            return 1;
+        }
+        i++;
+    }
+    if (shape == NULL || size == 0) {
+        usage(stderr);
+        return 1;
+    }
+
+    static out_t out;
+    out.file = path != NULL ? fopen(path, "wb") : stdout;
+    if (out.file == NULL) {
+        fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+
+    rng_t rng = {seed};
+    out_char(&out, '[');
+    for (uint64_t index = 0; index == 0 || out.written + 2 < size; index++) {
+        if (index > 0) {
+            out_char(&out, '\n');
+        }
+        shape->item(&out, &rng, index);
+        if (out.failed) {
+            break;
+        }
+    }
+    out_str(&out, "]\n");
+    out_flush(&out);
+
+    bool ok = !out.failed && fflush(out.file) == 0;
+    if (path != NULL && fclose(out.file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "Write failed%s%s\n", path ? " for " : "", path ? path : "");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1177 @@
+/**
+ * EDN.C - Benchmark regression runner
+ *
+ *   bench_runner run [--runs N] [--output FILE] [--verbose] BENCH...
+ *   bench_runner compare BASELINE CURRENT [--threshold PCT] [--alpha P] [--all]
+ *
+ * `run` executes each benchmark binary N times (default 5) from the current
+ * directory, with EDN_BENCH_JSON pointing at a scratch file and
+ * EDN_BENCH_PERF=1. Every value a benchmark reports through bench_report.h
+ * becomes one sample per run of its (case, metric) series. Each run also
+ * adds process-level samples under the case "(process)": wall time and
+ * peak RSS, plus cycles and instructions where perf_event_open is allowed.
+ * The results are written as one JSON document with, per series, the
+ * samples, their median and their 99th percentile (nearest rank).
+ *
+ * `compare` matches the series of two such documents and runs a two-sided
+ * Mann-Whitney U test on each pair of samples (exact distribution when
+ * there are no ties and both sides have at most 20 samples, the normal
+ * approximation with tie correction otherwise). A series regresses when
+ * the test is significant at --alpha (default 0.05) and its median moved
+ * the wrong way by more than --threshold percent (default 5). The exit
+ * status is 1 if any series regressed or any benchmark failed.
+ *
+ * Process wall time, cycles and instructions are recorded but never gate:
+ * benchmarks built on bench_run stop after a fixed duration, so those
+ * numbers describe the run, not the code. Peak RSS does gate.
+ *
+ * POSIX only. `make bench-json`, `make bench-baseline` and
+ * `make bench-check` drive it over every benchmark in bench/.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+
+int main(void) {
+    fprintf(stderr, "bench_runner needs a POSIX system\n");
+    return 2;
+}
+
+#else
+
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#define RUNNER_HAVE_PERF 1
+#else
+#define RUNNER_HAVE_PERF 0
+#endif
+
+#define PROCESS_CASE "(process)"
+#define JSON_MAX_DEPTH 64
+#define EXACT_MAX_SAMPLES 20 /* Exact U distribution up to this many samples per side */
+
+/* ======================================================================== */
+/* JSON reader                                                              */
+/* ======================================================================== */
+
+typedef enum { JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT } json_type_t;
+
+typedef struct json {
+    json_type_t type;
+    bool boolean;
+    double number;
+    char* string;       /* JSON_STRING */
+    struct json* items; /* JSON_ARRAY elements, JSON_OBJECT values */
+    char** keys;        /* JSON_OBJECT keys, parallel to items */
+    size_t count;
+} json_t;
+
+typedef struct {
+    const char* p;
+    const char* end;
+    int depth;
+} json_parser_t;
+
+static void json_free(json_t* value) {
+    for (size_t i = 0; i < value->count; i++) {
+        json_free(&value->items[i]);
+        if (value->keys != NULL) {
+            free(value->keys[i]);
+        }
+    }
+    free(value->items);
+    free(value->keys);
+    free(value->string);
+    memset(value, 0, sizeof(*value));
+}
+
+static void json_skip_space(json_parser_t* jp) {
+    while (jp->p < jp->end &&
+           (*jp->p == ' ' || *jp->p == '\t' || *jp->p == '\n' || *jp->p == '\r')) {
+        jp->p++;
+    }
+}
+
+static void utf8_append(char* out, size_t* used, uint32_t cp) {
+    if (cp < 0x80) {
+        out[(*used)++] = (char) cp;
+    } else if (cp < 0x800) {
+        out[(*used)++] = (char) (0xC0 | (cp >> 6));
+        out[(*used)++] = (char) (0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out[(*used)++] = (char) (0xE0 | (cp >> 12));
+        out[(*used)++] = (char) (0x80 | ((cp >> 6) & 0x3F));
+        out[(*used)++] = (char) (0x80 | (cp & 0x3F));
+    } else {
+        out[(*used)++] = (char) (0xF0 | (cp >> 18));
+        out[(*used)++] = (char) (0x80 | ((cp >> 12) & 0x3F));
+        out[(*used)++] = (char) (0x80 | ((cp >> 6) & 0x3F));
+        out[(*used)++] = (char) (0x80 | (cp & 0x3F));
+    }
+}
+
+static bool json_hex4(json_parser_t* jp, uint32_t* out) {
+    if (jp->end - jp->p < 4) {
+        return false;
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = *jp->p++;
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= (uint32_t) (c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            value |= (uint32_t) (c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            value |= (uint32_t) (c - 'A' + 10);
+        } else {
+            return false;
+        }
+    }
+    *out = value;
+    return true;
+}
+
+/* Parse a string at jp->p (on the opening quote); the result is malloc'd */
+static char* json_parse_string(json_parser_t* jp) {
+    jp->p++;
+    const char* start = jp->p;
+    while (jp->p < jp->end && *jp->p != '"') {
+        jp->p += (*jp->p == '\\' && jp->p + 1 < jp->end) ? 2 : 1;
+    }
+    if (jp->p >= jp->end) {
+        return NULL;
+    }
+    const char* stop = jp->p;
+    char* out = malloc((size_t) (stop - start) + 1); /* Escapes never grow */
+    if (out == NULL) {
+        return NULL;
+    }
+    size_t used = 0;
+    jp->p = start;
+    while (jp->p < stop) {
+        char c = *jp->p++;
+        if (c != '\\') {
+            out[used++] = c;
+            continue;
+        }
+        c = *jp->p++;
+        uint32_t cp;
+        switch (c) {
+            case 'n':
+                out[used++] = '\n';
+                break;
+            case 't':
+                out[used++] = '\t';
+                break;
+            case 'r':
+                out[used++] = '\r';
+                break;
+            case 'b':
+                out[used++] = '\b';
+                break;
+            case 'f':
+                out[used++] = '\f';
+                break;
+            case 'u':
+                if (!json_hex4(jp, &cp)) {
+                    free(out);
+                    return NULL;
+                }
+                if (cp >= 0xD800 && cp < 0xDC00 && stop - jp->p >= 6 && jp->p[0] == '\\' &&
+                    jp->p[1] == 'u') {
+                    uint32_t low;
+                    jp->p += 2;
+                    if (!json_hex4(jp, &low) || low < 0xDC00 || low > 0xDFFF) {
+                        free(out);
+                        return NULL;
+                    }
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                utf8_append(out, &used, cp);
+                break;
+            default: /* \" \\ \/ */
+                out[used++] = c;
+                break;
+        }
+    }
+    out[used] = '\0';
+    jp->p = stop + 1;
+    return out;
+}
+
+static bool json_parse_value(json_parser_t* jp, json_t* out);
+
+static bool json_push(json_t* container, json_t* item, char* key) {
+    if ((container->count & (container->count - 1)) == 0) {
+        size_t capacity = container->count == 0 ? 4 : container->count * 2;
+        json_t* items = realloc(container->items, capacity * sizeof(*items));
+        if (items == NULL) {
+            return false;
+        }
+        container->items = items;
+        if (container->type == JSON_OBJECT) {
+            char** keys = realloc(container->keys, capacity * sizeof(*keys));
+            if (keys == NULL) {
+                return false;
+            }
+            container->keys = keys;
+        }
+    }
+    if (container->type == JSON_OBJECT) {
+        container->keys[container->count] = key;
+    }
+    container->items[container->count++] = *item;
+    return true;
+}
+
+static bool json_parse_container(json_parser_t* jp, json_t* out, char close) {
+    jp->p++;
+    if (++jp->depth > JSON_MAX_DEPTH) {
+        return false;
+    }
+    json_skip_space(jp);
+    if (jp->p < jp->end && *jp->p == close) {
+        jp->p++;
+        jp->depth--;
+        return true;
+    }
+    for (;;) {
+        char* key = NULL;
+        json_skip_space(jp);
+        if (out->type == JSON_OBJECT) {
+            if (jp->p >= jp->end || *jp->p != '"' || (key = json_parse_string(jp)) == NULL) {
+                return false;
+            }
+            json_skip_space(jp);
+            if (jp->p >= jp->end || *jp->p++ != ':') {
+                free(key);
+                return false;
+            }
+        }
+        json_t item = {0};
+        if (!json_parse_value(jp, &item) || !json_push(out, &item, key)) {
+            json_free(&item);
+            free(key);
+            return false;
+        }
+        json_skip_space(jp);
+        if (jp->p < jp->end && *jp->p == ',') {
+            jp->p++;
+            continue;
+        }
+        if (jp->p < jp->end && *jp->p == close) {
+            jp->p++;
+            jp->depth--;
+            return true;
+        }
+        return false;
+    }
+}
+
+static bool json_parse_value(json_parser_t* jp, json_t* out) {
+    memset(out, 0, sizeof(*out));
+    json_skip_space(jp);
+    if (jp->p >= jp->end) {
+        return false;
+    }
+    switch (*jp->p) {
+        case '{':
+            out->type = JSON_OBJECT;
+            return json_parse_container(jp, out, '}');
+        case '[':
+            out->type = JSON_ARRAY;
+            return json_parse_container(jp, out, ']');
+        case '"':
+            out->type = JSON_STRING;
+            out->string = json_parse_string(jp);
+            return out->string != NULL;
+        default:
+            break;
+    }
+    static const struct {
+        const char* text;
+        json_type_t type;
+        bool value;
+    } words[] = {{"true", JSON_BOOL, true}, {"false", JSON_BOOL, false}, {"null", JSON_NULL, 0}};
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+        size_t length = strlen(words[i].text);
+        if ((size_t) (jp->end - jp->p) >= length && memcmp(jp->p, words[i].text, length) == 0) {
+            out->type = words[i].type;
+            out->boolean = words[i].value;
+            jp->p += length;
+            return true;
+        }
+    }
+    char* stop;
+    out->type = JSON_NUMBER;
+    out->number = strtod(jp->p, &stop);
+    if (stop == jp->p || stop > jp->end) {
+        return false;
+    }
+    jp->p = stop;
+    return true;
+}
+
+/* Parse a whole NUL-terminated document */
+static bool json_parse(const char* text, size_t length, json_t* out) {
+    json_parser_t jp = {text, text + length, 0};
+    if (!json_parse_value(&jp, out)) {
+        json_free(out);
+        return false;
+    }
+    json_skip_space(&jp);
+    if (jp.p != jp.end) {
+        json_free(out);
+        return false;
+    }
+    return true;
+}
+
+static const json_t* json_get(const json_t* object, const char* key) {
+    if (object == NULL || object->type != JSON_OBJECT) {
+        return NULL;
+    }
+    for (size_t i = 0; i < object->count; i++) {
+        if (strcmp(object->keys[i], key) == 0) {
+            return &object->items[i];
+        }
+    }
+    return NULL;
+}
+
+static const char* json_get_string(const json_t* object, const char* key) {
+    const json_t* value = json_get(object, key);
+    return value != NULL && value->type == JSON_STRING ? value->string : NULL;
+}
+
+/* ======================================================================== */
+/* JSON writer                                                              */
+/* ======================================================================== */
+
+static void json_write_string(FILE* f, const char* text) {
+    fputc('"', f);
+    for (const unsigned char* p = (const unsigned char*) text; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            fprintf(f, "\\%c", *p);
+        } else if (*p < 0x20) {
+            fprintf(f, "\\u%04x", *p);
+        } else {
+            fputc(*p, f);
+        }
+    }
+    fputc('"', f);
+}
+
+/* ======================================================================== */
+/* Results                                                                  */
+/* ======================================================================== */
+
+/* One (case, metric) of a benchmark, one sample per run */
+typedef struct {
+    char* case_name;
+    char* metric;
+    char* unit;
+    bool gate; /* Counts towards pass/fail in compare */
+    double* samples;
+    size_t count;
+    size_t capacity;
+} series_t;
+
+typedef struct {
+    char* name;
+    bool failed;
+    series_t* series;
+    size_t count;
+    size_t capacity;
+} benchmark_t;
+
+typedef struct {
+    char* host;
+    int runs;
+    benchmark_t* benchmarks;
+    size_t count;
+    size_t capacity;
+} results_t;
+
+static void* grow(void* items, size_t* capacity, size_t count, size_t size) {
+    if (count < *capacity) {
+        return items;
+    }
+    size_t next = *capacity == 0 ? 8 : *capacity * 2;
+    void* grown = realloc(items, next * size);
+    if (grown == NULL) {
+        fprintf(stderr, "bench_runner: out of memory\n");
+        exit(2);
+    }
+    *capacity = next;
+    return grown;
+}
+
+static char* copy_string(const char* text) {
+    char* copy = strdup(text);
+    if (copy == NULL) {
+        fprintf(stderr, "bench_runner: out of memory\n");
+        exit(2);
+    }
+    return copy;
+}
+
+static benchmark_t* add_benchmark(results_t* results, const char* name) {
+    results->benchmarks =
+        grow(results->benchmarks, &results->capacity, results->count, sizeof(benchmark_t));
+    benchmark_t* bench = &results->benchmarks[results->count++];
+    memset(bench, 0, sizeof(*bench));
+    bench->name = copy_string(name);
+    return bench;
+}
+
+static series_t* find_series(const benchmark_t* bench, const char* case_name, const char* metric) {
+    for (size_t i = 0; i < bench->count; i++) {
+        if (strcmp(bench->series[i].case_name, case_name) == 0 &&
+            strcmp(bench->series[i].metric, metric) == 0) {
+            return &bench->series[i];
+        }
+    }
+    return NULL;
+}
+
+static series_t* get_series(benchmark_t* bench, const char* case_name, const char* metric,
+                            const char* unit, bool gate) {
+    series_t* series = find_series(bench, case_name, metric);
+    if (series != NULL) {
+        return series;
+    }
+    bench->series = grow(bench->series, &bench->capacity, bench->count, sizeof(series_t));
+    series = &bench->series[bench->count++];
+    memset(series, 0, sizeof(*series));
+    series->case_name = copy_string(case_name);
+    series->metric = copy_string(metric);
+    series->unit = copy_string(unit);
+    series->gate = gate;
+    return series;
+}
+
+static void add_sample(series_t* series, double value) {
+    series->samples = grow(series->samples, &series->capacity, series->count, sizeof(double));
+    series->samples[series->count++] = value;
+}
+
+static void results_free(results_t* results) {
+    for (size_t b = 0; b < results->count; b++) {
+        benchmark_t* bench = &results->benchmarks[b];
+        for (size_t s = 0; s < bench->count; s++) {
+            free(bench->series[s].case_name);
+            free(bench->series[s].metric);
+            free(bench->series[s].unit);
+            free(bench->series[s].samples);
+        }
+        free(bench->series);
+        free(bench->name);
+    }
+    free(results->benchmarks);
+    free(results->host);
+}
+
+/* ======================================================================== */
+/* Statistics                                                               */
+/* ======================================================================== */
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return x < y ? -1 : x > y;
+}
+
+/* Sorted copy of the samples; the caller frees it */
+static double* sorted_copy(const double* samples, size_t count) {
+    double* sorted = malloc((count ? count : 1) * sizeof(double));
+    if (sorted == NULL) {
+        fprintf(stderr, "bench_runner: out of memory\n");
+        exit(2);
+    }
+    memcpy(sorted, samples, count * sizeof(double));
+    qsort(sorted, count, sizeof(double), compare_double);
+    return sorted;
+}
+
+static double median(const double* samples, size_t count) {
+    if (count == 0) {
+        return NAN;
+    }
+    double* sorted = sorted_copy(samples, count);
+    double m = count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+    free(sorted);
+    return m;
+}
+
+/* Nearest-rank percentile */
+static double percentile(const double* samples, size_t count, unsigned pct) {
+    if (count == 0) {
+        return NAN;
+    }
+    double* sorted = sorted_copy(samples, count);
+    size_t rank = (count * pct + 99) / 100;
+    double value = sorted[rank > 0 ? rank - 1 : 0];
+    free(sorted);
+    return value;
+}
+
+/* P(U <= u) under the null hypothesis, for n and m samples without ties */
+static double exact_u_cdf(size_t n, size_t m, double u) {
+    size_t max_u = n * m;
+    size_t stride = max_u + 1;
+    /* ways[i][j][k]: orderings of i and j samples with U = k */
+    double* ways = calloc((n + 1) * (m + 1) * stride, sizeof(double));
+    if (ways == NULL) {
+        fprintf(stderr, "bench_runner: out of memory\n");
+        exit(2);
+    }
+#define WAYS(i, j, k) ways[((i) * (m + 1) + (j)) * stride + (k)]
+    for (size_t i = 0; i <= n; i++) {
+        for (size_t j = 0; j <= m; j++) {
+            if (i == 0 || j == 0) {
+                WAYS(i, j, 0) = 1;
+                continue;
+            }
+            for (size_t k = 0; k <= i * j; k++) {
+                double w = WAYS(i, j - 1, k); /* Largest value from the second sample */
+                if (k >= j) {
+                    w += WAYS(i - 1, j, k - j); /* Largest value from the first: beats all j */
+                }
+                WAYS(i, j, k) = w;
+            }
+        }
+    }
+    double total = 0;
+    double below = 0;
+    for (size_t k = 0; k <= max_u; k++) {
+        total += WAYS(n, m, k);
+        if ((double) k <= u + 1e-9) {
+            below += WAYS(n, m, k);
+        }
+    }
+#undef WAYS
+    free(ways);
+    return below / total;
+}
+
+typedef struct {
+    double value;
+    int group;
+} ranked_t;
+
+static int compare_ranked(const void* a, const void* b) {
+    return compare_double(&((const ranked_t*) a)->value, &((const ranked_t*) b)->value);
+}
+
+/* Two-sided p-value of the Mann-Whitney U test */
+static double mann_whitney_p(const double* a, size_t n, const double* b, size_t m) {
+    if (n == 0 || m == 0) {
+        return 1.0;
+    }
+    size_t total = n + m;
+    ranked_t* all = malloc(total * sizeof(*all));
+    if (all == NULL) {
+        fprintf(stderr, "bench_runner: out of memory\n");
+        exit(2);
+    }
+    for (size_t i = 0; i < n; i++) {
+        all[i] = (ranked_t){a[i], 0};
+    }
+    for (size_t j = 0; j < m; j++) {
+        all[n + j] = (ranked_t){b[j], 1};
+    }
+    qsort(all, total, sizeof(*all), compare_ranked);
+
+    /* Midranks for ties */
+    double rank_sum = 0;
+    double tie_term = 0;
+    bool ties = false;
+    for (size_t i = 0; i < total;) {
+        size_t j = i;
+        while (j + 1 < total && all[j + 1].value == all[i].value) {
+            j++;
+        }
+        double t = (double) (j - i + 1);
+        double rank = (double) (i + j) / 2.0 + 1.0;
+        for (size_t k = i; k <= j; k++) {
+            if (all[k].group == 0) {
+                rank_sum += rank;
+            }
+        }
+        if (t > 1) {
+            ties = true;
+            tie_term += t * t * t - t;
+        }
+        i = j + 1;
+    }
+    free(all);
+
+    double nm = (double) n * (double) m;
+    double u1 = rank_sum - (double) n * ((double) n + 1) / 2.0;
+    double u = u1 < nm - u1 ? u1 : nm - u1;
+
+    if (!ties && n <= EXACT_MAX_SAMPLES && m <= EXACT_MAX_SAMPLES) {
+        double p = 2.0 * exact_u_cdf(n, m, u);
+        return p > 1.0 ? 1.0 : p;
+    }
+    double N = (double) total;
+    double variance = nm / 12.0 * ((N + 1.0) - tie_term / (N * (N - 1.0)));
+    if (variance <= 0) {
+        return 1.0; /* Every sample equal */
+    }
+    double z = (fabs(u1 - nm / 2.0) - 0.5) / sqrt(variance);
+    if (z < 0) {
+        z = 0;
+    }
+    return erfc(z / sqrt(2.0));
+}
+
+/* Units where a larger value is better; see bench_report.h */
+static bool higher_is_better(const char* unit) {
+    return strcmp(unit, "x") == 0 || strcmp(unit, "GB/s") == 0 || strcmp(unit, "IPC") == 0;
+}
+
+/* ======================================================================== */
+/* run                                                                      */
+/* ======================================================================== */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/* Cycle and instruction counters that follow the benchmark process */
+typedef struct {
+    int cycles;
+    int instructions;
+} process_perf_t;
+
+#if RUNNER_HAVE_PERF
+static int open_inherited_counter(uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1; /* Children count into this fd once they exit */
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void perf_open(process_perf_t* perf) {
+    perf->cycles = open_inherited_counter(PERF_COUNT_HW_CPU_CYCLES);
+    perf->instructions = open_inherited_counter(PERF_COUNT_HW_INSTRUCTIONS);
+}
+
+static void perf_control(const process_perf_t* perf, unsigned long request) {
+    if (perf->cycles >= 0) {
+        ioctl(perf->cycles, request, 0);
+    }
+    if (perf->instructions >= 0) {
+        ioctl(perf->instructions, request, 0);
+    }
+}
+
+static void perf_start(const process_perf_t* perf) {
+    perf_control(perf, PERF_EVENT_IOC_RESET);
+    perf_control(perf, PERF_EVENT_IOC_ENABLE);
+}
+
+static void perf_stop(const process_perf_t* perf) {
+    perf_control(perf, PERF_EVENT_IOC_DISABLE);
+}
+
+static bool perf_read(int fd, double* value) {
+    uint64_t count;
+    if (fd < 0 || read(fd, &count, sizeof(count)) != (ssize_t) sizeof(count)) {
+        return false;
+    }
+    *value = (double) count;
+    return true;
+}
+
+static void perf_close(process_perf_t* perf) {
+    if (perf->cycles >= 0) {
+        close(perf->cycles);
+    }
+    if (perf->instructions >= 0) {
+        close(perf->instructions);
+    }
+}
+#else
+static void perf_open(process_perf_t* perf) {
+    perf->cycles = -1;
+    perf->instructions = -1;
+}
+
+static void perf_start(const process_perf_t* perf) {
+    (void) perf;
+}
+
+static void perf_stop(const process_perf_t* perf) {
+    (void) perf;
+}
+
+static bool perf_read(int fd, double* value) {
+    (void) fd;
+    (void) value;
+    return false;
+}
+
+static void perf_close(process_perf_t* perf) {
+    (void) perf;
+}
+#endif
+
+/* Add one line of bench_report output to `bench`; false if malformed */
+static bool add_report_line(benchmark_t* bench, const char* line, size_t length) {
+    json_t object;
+    if (!json_parse(line, length, &object)) {
+        return false;
+    }
+    const char* case_name = json_get_string(&object, "case");
+    const char* metric = json_get_string(&object, "metric");
+    const char* unit = json_get_string(&object, "unit");
+    const json_t* value = json_get(&object, "value");
+    bool ok = case_name != NULL && metric != NULL && unit != NULL && value != NULL &&
+              value->type == JSON_NUMBER;
+    if (ok) {
+        add_sample(get_series(bench, case_name, metric, unit, true), value->number);
+    }
+    json_free(&object);
+    return ok;
+}
+
+static void read_reports(benchmark_t* bench, const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        return;
+    }
+    char* line = NULL;
+    size_t capacity = 0;
+    ssize_t length;
+    while ((length = getline(&line, &capacity, f)) > 0) {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+            line[--length] = '\0';
+        }
+        if (length > 0 && !add_report_line(bench, line, (size_t) length)) {
+            fprintf(stderr, "  %s: ignoring malformed report line: %s\n", bench->name, line);
+        }
+    }
+    free(line);
+    fclose(f);
+}
+
+/* Run `path` once; false if it could not start or did not exit with status 0 */
+static bool run_once(benchmark_t* bench, const char* path, const char* report_path,
+                     const char* log_path, const process_perf_t* perf) {
+    double start = now_seconds();
+    perf_start(perf);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perf_stop(perf);
+        fprintf(stderr, "  %s: fork failed: %s\n", bench->name, strerror(errno));
+        return false;
+    }
+    if (pid == 0) {
+        setenv("EDN_BENCH_JSON", report_path, 1);
+        setenv("EDN_BENCH_PERF", "1", 0);
+        if (log_path != NULL) {
+            int fd = open(log_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd >= 0) {
+                dup2(fd, STDOUT_FILENO);
+                dup2(fd, STDERR_FILENO);
+                close(fd);
+            }
+        }
+        execl(path, path, (char*) NULL);
+        fprintf(stderr, "cannot execute %s: %s\n", path, strerror(errno));
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    while (wait4(pid, &status, 0, &usage) < 0) {
+        if (errno != EINTR) {
+            perf_stop(perf);
+            return false;
+        }
+    }
+    perf_stop(perf);
+    double wall = now_seconds() - start;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return false;
+    }
+
+#if defined(__APPLE__)
+    double rss_kb = (double) usage.ru_maxrss / 1024.0; /* Bytes on macOS */
+#else
+    double rss_kb = (double) usage.ru_maxrss; /* Kilobytes on Linux and the BSDs */
+#endif
+    add_sample(get_series(bench, PROCESS_CASE, "wall_ms", "ms", false), wall * 1000.0);
+    add_sample(get_series(bench, PROCESS_CASE, "peak_rss_kb", "KB", true), rss_kb);
+    double count;
+    if (perf_read(perf->cycles, &count)) {
+        add_sample(get_series(bench, PROCESS_CASE, "cycles", "cycles", false), count);
+    }
+    if (perf_read(perf->instructions, &count)) {
+        add_sample(get_series(bench, PROCESS_CASE, "instructions", "instructions", false),
+                   count);
+    }
+    read_reports(bench, report_path);
+    return true;
+}
+
+static void write_results(FILE* f, const results_t* results) {
+    fprintf(f, "{\n  \"format\": \"edn-bench-results\",\n  \"version\": 1,\n  \"host\": ");
+    json_write_string(f, results->host);
+    fprintf(f, ",\n  \"runs\": %d,\n  \"benchmarks\": [", results->runs);
+    for (size_t b = 0; b < results->count; b++) {
+        const benchmark_t* bench = &results->benchmarks[b];
+        fprintf(f, "%s\n    {\"name\": ", b ? "," : "");
+        json_write_string(f, bench->name);
+        fprintf(f, ", \"status\": \"%s\", \"series\": [", bench->failed ? "failed" : "ok");
+        for (size_t s = 0; s < bench->count; s++) {
+            const series_t* series = &bench->series[s];
+            fprintf(f, "%s\n      {\"case\": ", s ? "," : "");
+            json_write_string(f, series->case_name);
+            fprintf(f, ", \"metric\": ");
+            json_write_string(f, series->metric);
+            fprintf(f, ", \"unit\": ");
+            json_write_string(f, series->unit);
+            fprintf(f, ", \"gate\": %s, \"median\": %.17g, \"p99\": %.17g, \"samples\": [",
+                    series->gate ? "true" : "false", median(series->samples, series->count),
+                    percentile(series->samples, series->count, 99));
+            for (size_t i = 0; i < series->count; i++) {
+                fprintf(f, "%s%.17g", i ? ", " : "", series->samples[i]);
+            }
+            fprintf(f, "]}");
+        }
+        fprintf(f, "%s]}", bench->count ? "\n    " : "");
+    }
+    fprintf(f, "\n  ]\n}\n");
+}
+
+static char* host_description(void) {
+    struct utsname name;
+    char text[512];
+    if (uname(&name) != 0) {
+        return copy_string("unknown");
+    }
+    snprintf(text, sizeof(text), "%s %s %s %s", name.nodename, name.sysname, name.release,
+             name.machine);
+    return copy_string(text);
+}
+
+static const char* base_name(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash != NULL ? slash + 1 : path;
+}
+
+static int command_run(int argc, char** argv) {
+    int runs = 5;
+    const char* output = NULL;
+    bool verbose = false;
+    int first = argc;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 2;
+        } else {
+            first = i;
+            break;
+        }
+    }
+    if (runs < 1 || first == argc) {
+        fprintf(stderr, "Usage: bench_runner run [--runs N] [--output FILE] [--verbose] "
+                        "BENCH...\n");
+        return 2;
+    }
+    if (runs < 4) {
+        fprintf(stderr, "note: with fewer than 4 runs no difference can be significant at 0.05\n");
+    }
+
+    char report_path[] = "/tmp/edn_bench_report_XXXXXX";
+    int report_fd = mkstemp(report_path);
+    char log_path[] = "/tmp/edn_bench_log_XXXXXX";
+    int log_fd = mkstemp(log_path);
+    if (report_fd < 0 || log_fd < 0) {
+        fprintf(stderr, "bench_runner: cannot create scratch files: %s\n", strerror(errno));
+        return 2;
+    }
+    close(report_fd);
+    close(log_fd);
+
+    results_t results = {0};
+    results.host = host_description();
+    results.runs = runs;
+    process_perf_t perf;
+    perf_open(&perf);
+    bool any_failed = false;
+
+    for (int i = first; i < argc; i++) {
+        benchmark_t* bench = add_benchmark(&results, base_name(argv[i]));
+        for (int run = 0; run < runs && !bench->failed; run++) {
+            fprintf(stderr, "  %-24s run %d/%d\n", bench->name, run + 1, runs);
+            FILE* truncate = fopen(report_path, "w");
+            if (truncate != NULL) {
+                fclose(truncate);
+            }
+            if (!run_once(bench, argv[i], report_path, verbose ? NULL : log_path, &perf)) {
+                bench->failed = true;
+                any_failed = true;
+                fprintf(stderr, "  %s FAILED", bench->name);
+                if (!verbose) {
+                    /* Keep the output of the failed run */
+                    char kept[64];
+                    snprintf(kept, sizeof(kept), "%s.%s", log_path, bench->name);
+                    if (rename(log_path, kept) == 0) {
+                        fprintf(stderr, " (output in %s)", kept);
+                        FILE* recreate = fopen(log_path, "w");
+                        if (recreate != NULL) {
+                            fclose(recreate);
+                        }
+                    }
+                }
+                fprintf(stderr, "\n");
+            }
+        }
+    }
+    perf_close(&perf);
+    unlink(report_path);
+    unlink(log_path);
+
+    FILE* out = output != NULL ? fopen(output, "w") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "bench_runner: cannot write %s: %s\n", output, strerror(errno));
+        results_free(&results);
+        return 2;
+    }
+    write_results(out, &results);
+    if (output != NULL && fclose(out) != 0) {
+        fprintf(stderr, "bench_runner: cannot write %s\n", output);
+        results_free(&results);
+        return 2;
+    }
+    if (output != NULL) {
+        fprintf(stderr, "Wrote %s\n", output);
+    }
+    results_free(&results);
+    return any_failed ? 1 : 0;
+}
+
+/* ======================================================================== */
+/* compare                                                                  */
+/* ======================================================================== */
+
+/* Load a `run` document back into results_t */
+static bool load_results(const char* path, results_t* results) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "bench_runner: cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* text = size >= 0 ? malloc((size_t) size + 1) : NULL;
+    bool ok = text != NULL && fread(text, 1, (size_t) size, f) == (size_t) size;
+    fclose(f);
+    json_t doc;
+    if (!ok || !json_parse(text, (size_t) size, &doc)) {
+        fprintf(stderr, "bench_runner: %s is not valid JSON\n", path);
+        free(text);
+        return false;
+    }
+    free(text);
+
+    const char* format = json_get_string(&doc, "format");
+    const json_t* benchmarks = json_get(&doc, "benchmarks");
+    if (format == NULL || strcmp(format, "edn-bench-results") != 0 || benchmarks == NULL ||
+        benchmarks->type != JSON_ARRAY) {
+        fprintf(stderr, "bench_runner: %s is not a bench_runner results file\n", path);
+        json_free(&doc);
+        return false;
+    }
+    const char* host = json_get_string(&doc, "host");
+    results->host = copy_string(host != NULL ? host : "unknown");
+    for (size_t b = 0; b < benchmarks->count; b++) {
+        const json_t* entry = &benchmarks->items[b];
+        const char* name = json_get_string(entry, "name");
+        const char* status = json_get_string(entry, "status");
+        const json_t* series = json_get(entry, "series");
+        if (name == NULL || series == NULL || series->type != JSON_ARRAY) {
+            continue;
+        }
+        benchmark_t* bench = add_benchmark(results, name);
+        bench->failed = status == NULL || strcmp(status, "ok") != 0;
+        for (size_t s = 0; s < series->count; s++) {
+            const json_t* item = &series->items[s];
+            const char* case_name = json_get_string(item, "case");
+            const char* metric = json_get_string(item, "metric");
+            const char* unit = json_get_string(item, "unit");
+            const json_t* gate = json_get(item, "gate");
+            const json_t* samples = json_get(item, "samples");
+            if (case_name == NULL || metric == NULL || unit == NULL || samples == NULL ||
+                samples->type != JSON_ARRAY) {
+                continue;
+            }
+            series_t* target = get_series(bench, case_name, metric, unit,
+                                          gate == NULL || gate->type != JSON_BOOL || gate->boolean);
+            for (size_t i = 0; i < samples->count; i++) {
+                if (samples->items[i].type == JSON_NUMBER) {
+                    add_sample(target, samples->items[i].number);
+                }
+            }
+        }
+    }
+    json_free(&doc);
+    return true;
+}
+
+static const benchmark_t* find_benchmark(const results_t* results, const char* name) {
+    for (size_t i = 0; i < results->count; i++) {
+        if (strcmp(results->benchmarks[i].name, name) == 0) {
+            return &results->benchmarks[i];
+        }
+    }
+    return NULL;
+}
+
+static int command_compare(int argc, char** argv) {
+    double threshold = 5.0;
+    double alpha = 0.05;
+    bool all = false;
+    const char* paths[2] = {NULL, NULL};
+    int positional = 0;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--alpha") == 0 && i + 1 < argc) {
+            alpha = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--all") == 0) {
+            all = true;
+        } else if (argv[i][0] != '-' && positional < 2) {
+            paths[positional++] = argv[i];
+        } else {
+            positional = -1;
+            break;
+        }
+    }
+    if (positional != 2) {
+        fprintf(stderr, "Usage: bench_runner compare BASELINE CURRENT [--threshold PCT] "
+                        "[--alpha P] [--all]\n");
+        return 2;
+    }
+
+    results_t base = {0};
+    results_t current = {0};
+    if (!load_results(paths[0], &base) || !load_results(paths[1], &current)) {
+        results_free(&base);
+        results_free(&current);
+        return 2;
+    }
+    if (strcmp(base.host, current.host) != 0) {
+        printf("warning: baseline from \"%s\", current from \"%s\"\n\n", base.host, current.host);
+    }
+
+    size_t compared = 0, regressions = 0, improvements = 0, failures = 0;
+    printf("%-22s %-30s %-20s %12s %12s %8s %7s  %s\n", "benchmark", "case", "metric", "baseline",
+           "current", "change", "p", "verdict");
+    for (size_t b = 0; b < current.count; b++) {
+        const benchmark_t* now = &current.benchmarks[b];
+        const benchmark_t* then = find_benchmark(&base, now->name);
+        if (now->failed) {
+            printf("%-22s %-30s %-20s %12s %12s %8s %7s  FAILED\n", now->name, "", "", "", "", "",
+                   "");
+            failures++;
+            continue;
+        }
+        if (then == NULL) {
+            printf("%-22s (not in baseline)\n", now->name);
+            continue;
+        }
+        for (size_t s = 0; s < now->count; s++) {
+            const series_t* cur = &now->series[s];
+            const series_t* old = find_series(then, cur->case_name, cur->metric);
+            if (old == NULL || old->count == 0 || cur->count == 0) {
+                continue;
+            }
+            double m_old = median(old->samples, old->count);
+            double m_new = median(cur->samples, cur->count);
+            double change = m_old != 0 ? (m_new - m_old) / fabs(m_old) * 100.0 : 0.0;
+            double worse = higher_is_better(cur->unit) ? -change : change;
+            double p = mann_whitney_p(old->samples, old->count, cur->samples, cur->count);
+            bool significant = p < alpha && fabs(change) > threshold;
+            const char* verdict = "ok";
+            if (significant && worse > 0) {
+                verdict = cur->gate ? "REGRESSION" : "slower (not gated)";
+                regressions += cur->gate;
+            } else if (significant) {
+                verdict = "improved";
+                improvements++;
+            }
+            compared++;
+            if (all || significant) {
+                printf("%-22s %-30s %-20s %12.4g %12.4g %+7.1f%% %7.4f  %s\n", now->name,
+                       cur->case_name, cur->metric, m_old, m_new, change, p, verdict);
+            }
+        }
+    }
+    for (size_t b = 0; b < base.count; b++) {
+        if (find_benchmark(&current, base.benchmarks[b].name) == NULL) {
+            printf("%-22s (missing from current results)\n", base.benchmarks[b].name);
+        }
+    }
+
+    printf("\n%zu series compared: %zu regressions, %zu improvements, %zu failed benchmarks "
+           "(threshold %.1f%%, alpha %.3g)\n",
+           compared, regressions, improvements, failures, threshold, alpha);
+    results_free(&base);
+    results_free(&current);
+    return regressions > 0 || failures > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && strcmp(argv[1], "run") == 0) {
+        return command_run(argc - 2, argv + 2);
+    }
+    if (argc >= 2 && strcmp(argv[1], "compare") == 0) {
+        return command_compare(argc - 2, argv + 2);
+    }
+    fprintf(stderr, "Usage: bench_runner run [--runs N] [--output FILE] [--verbose] BENCH...\n"
+                    "       bench_runner compare BASELINE CURRENT [--threshold PCT] [--alpha P] "
+                    "[--all]\n");
+    return 2;
+}
+
+#endif /* _WIN32 */
@@ -558,14 +558,11 @@ int wasm_edn_validate(const char* input) {
         return 0;
     }
 
-    edn_result_t result = edn_read(input, 0);
-
-    if (result.error == EDN_OK) {
-        edn_free(result.value);
-        return 1;
-    }
+    edn_validate_options_t options = {0};
+    options.struct_size = sizeof(options);
+    options.check_duplicates = true;
 
-    return 0;
+    return edn_validate(input, 0, &options, NULL).error == EDN_OK;
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -574,15 +571,14 @@ const char* wasm_edn_get_error(const char* input) {
         return "Input is NULL";
     }
 
-    edn_result_t result = edn_read(input, 0);
+    edn_validate_options_t options = {0};
+    options.struct_size = sizeof(options);
+    options.check_duplicates = true;
 
-    if (result.error != EDN_OK) {
-        // Note: This string lifetime is static, safe to return
-        return result.error_message;
-    }
+    edn_result_t result = edn_validate(input, 0, &options, NULL);
 
-    edn_free(result.value);
-    return NULL;
+    // Note: This string lifetime is static, safe to return
+    return result.error != EDN_OK ? result.error_message : NULL;
 }
 
 /*
@@ -0,0 +1,35 @@
+# EDN.C - edn_codegen build integration
+#
+# edn_generate_codec(<target> SCHEMA <schema.edn> NAME <basename> [OUTPUT_DIR <dir>])
+#
+# Runs edn_codegen on SCHEMA at build time, producing <basename>.h and
+# <basename>.c in OUTPUT_DIR (default: the current binary directory). The
+# source is added to <target>, which also gets the output directory and the
+# edn headers on its include path and is linked against edn. The codec is
+# regenerated whenever the schema or the generator changes.
+
+set(EDN_CODEGEN_INCLUDE_DIR "${CMAKE_CURRENT_LIST_DIR}/../include")
+
+function(edn_generate_codec target)
+    cmake_parse_arguments(ARG "" "SCHEMA;NAME;OUTPUT_DIR" "" ${ARGN})
+    if(NOT ARG_SCHEMA OR NOT ARG_NAME)
+        message(FATAL_ERROR "edn_generate_codec: SCHEMA and NAME are required")
+    endif()
+    if(NOT ARG_OUTPUT_DIR)
+        set(ARG_OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}")
+    endif()
+    get_filename_component(schema "${ARG_SCHEMA}" ABSOLUTE)
+
+    set(base "${ARG_OUTPUT_DIR}/${ARG_NAME}")
+    add_custom_command(
+        OUTPUT "${base}.c" "${base}.h"
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${ARG_OUTPUT_DIR}"
+        COMMAND edn_codegen "${schema}" "${base}"
+        DEPENDS edn_codegen "${schema}"
+        COMMENT "Generating EDN codec ${ARG_NAME} from ${ARG_SCHEMA}"
+        VERBATIM)
+
+    target_sources(${target} PRIVATE "${base}.c" "${base}.h")
+    target_include_directories(${target} PRIVATE "${ARG_OUTPUT_DIR}" "${EDN_CODEGEN_INCLUDE_DIR}")
+    target_link_libraries(${target} edn)
+endfunction()
@@ -0,0 +1,57 @@
+/**
+ * EDN.C - edn_codegen demo
+ *
+ * Decodes an order with the generated decoder, edits it, and writes it
+ * back with the generated encoder. msg_types.h/.c are generated from
+ * schema.edn at build time (`make codegen-example`, or edn_generate_codec
+ * in CMake).
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "msg_types.h"
+
+static int write_stdout(const char* data, size_t length, void* ctx) {
+    return fwrite(data, 1, length, (FILE*) ctx) == length ? 0 : -1;
+}
+
+int main(void) {
+    const char* input = "{:order/id 7 :symbol \"ACME \\\"B\\\"\" :side :buy :qty 100"
+                        " :price 12.5 :live? true :at {:x 1 :y 2}"
+                        " :fills [12.4 12.5] :route [{:x 0 :y 0} {:x 3 :y 4}]"
+                        " :notes [\"first\\nline\"] :ignored {:any [thing]}}";
+
+    msg_order_t order;
+    edn_result_t r = msg_order_decode(input, 0, &order);
+    if (r.error != EDN_OK) {
+        fprintf(stderr, "decode failed: %s at %zu:%zu\n", r.error_message, r.error_start.line,
+                r.error_start.column);
+        return 1;
+    }
+    printf("order %lld %s %s qty=%d fills=%zu route=%zu\n", (long long) order.id, order.symbol,
+           order.side, order.qty, order.fills_count, order.route_count);
+
+    order.qty *= 2;
+    strcpy(order.side, "sell");
+
+    edn_emitter_t* emitter = edn_emitter_create(write_stdout, stdout, NULL);
+    if (emitter == NULL) {
+        return 1;
+    }
+    int rc = msg_order_encode(emitter, &order);
+    if (rc == 0) {
+        rc = edn_emitter_finish(emitter);
+    }
+    edn_emitter_destroy(emitter);
+    printf("\n");
+    if (rc != 0) {
+        fprintf(stderr, "encode failed: %d\n", rc);
+        return 1;
+    }
+
+    /* A missing required key is reported like any decode error */
+    r = msg_order_decode("{:order/id 1}", 0, &order);
+    printf("missing symbol: %s\n", r.error_message);
+    return 0;
+}
@@ -35,9 +35,6 @@ typedef struct {
 #define COLOR_SYMBOL "\033[33m"  /* Yellow */
 #define COLOR_TAG "\033[35;1m"   /* Bright Magenta */
 
-/* Forward declaration */
-static void print_value(const edn_value_t* value, int indent, const print_options_t* opts);
-
 /* Print indentation - Clojure style uses 1 space for collection elements */
 static void print_indent(int level) {
     for (int i = 0; i < level; i++) {
@@ -289,157 +286,8 @@ static void print_symbol(const edn_value_t* value, const print_options_t* opts)
     }
 }
 
-/* Print list */
-static void print_list(const edn_value_t* value, int indent, const print_options_t* opts) {
-    size_t count = edn_list_count(value);
-
-    printf("(");
-    if (count > 0) {
-        for (size_t i = 0; i < count; i++) {
-            if (i > 0)
-                printf(" ");
-            print_value(edn_list_get(value, i), indent, opts);
-        }
-    }
-    printf(")");
-}
-
-/* Print vector */
-static void print_vector(const edn_value_t* value, int indent, const print_options_t* opts) {
-    size_t count = edn_vector_count(value);
-
-    printf("[");
-    if (count > 0) {
-        /* Clojure style: first element on same line, rest aligned below
-         * Small vectors (≤3 elements) stay inline
-         * Example: [1        or    [1 2 3]
-         *           2
-         *           3]
-         */
-        bool multiline = count > 3;
-
-        if (multiline) {
-            /* First element on same line as [ */
-            print_value(edn_vector_get(value, 0), indent + 1, opts);
-
-            /* Rest of elements aligned with first */
-            for (size_t i = 1; i < count; i++) {
-                printf("\n");
-                print_indent(indent + 1); /* Align with first element */
-                print_value(edn_vector_get(value, i), indent + 1, opts);
-            }
-        } else {
-            /* Inline for small vectors */
-            for (size_t i = 0; i < count; i++) {
-                if (i > 0)
-                    printf(" ");
-                print_value(edn_vector_get(value, i), indent, opts);
-            }
-        }
-    }
-    printf("]");
-}
-
-/* Print set */
-static void print_set(const edn_value_t* value, int indent, const print_options_t* opts) {
-    size_t count = edn_set_count(value);
-
-    printf("#{");
-    if (count > 0) {
-        /* Clojure style: first element on same line, rest aligned below
-         * Example: #{:a       or    #{:a :b :c}
-         *            :b
-         *            :c}
-         */
-        bool multiline = count > 3;
-
-        if (multiline) {
-            /* First element on same line as #{ */
-            print_value(edn_set_get(value, 0), indent + 2, opts);
-
-            /* Rest of elements aligned with first */
-            for (size_t i = 1; i < count; i++) {
-                printf("\n");
-                print_indent(indent + 2); /* Align with first element (2 chars: #{) */
-                print_value(edn_set_get(value, i), indent + 2, opts);
-            }
-        } else {
-            /* Inline for small sets */
-            for (size_t i = 0; i < count; i++) {
-                if (i > 0)
-                    printf(" ");
-                print_value(edn_set_get(value, i), indent, opts);
-            }
-        }
-    }
-    printf("}");
-}
-
-/* Print map */
-static void print_map(const edn_value_t* value, int indent, const print_options_t* opts) {
-    size_t count = edn_map_count(value);
-
-    printf("{");
-    if (count > 0) {
-        /* Clojure style: first key-value pair on same line, rest aligned below
-         * Example: {:foo 1        or    {:foo 1 :bar 2}
-         *           :bar 2
-         *           :baz 3}
-         */
-        bool multiline = count > 2;
-
-        if (multiline) {
-            /* First key-value pair on same line as { */
-            print_value(edn_map_get_key(value, 0), indent + 1, opts);
-            printf(" ");
-            print_value(edn_map_get_value(value, 0), indent + 1, opts);
-
-            /* Rest of key-value pairs aligned with first key */
-            for (size_t i = 1; i < count; i++) {
-                printf("\n");
-                print_indent(indent + 1); /* Align with first key */
-                print_value(edn_map_get_key(value, i), indent + 1, opts);
-                printf(" ");
-                print_value(edn_map_get_value(value, i), indent + 1, opts);
-            }
-        } else {
-            /* Inline for small maps */
-            for (size_t i = 0; i < count; i++) {
-                if (i > 0)
-                    printf(" ");
-                print_value(edn_map_get_key(value, i), indent, opts);
-                printf(" ");
-                print_value(edn_map_get_value(value, i), indent, opts);
-            }
-        }
-    }
-    printf("}");
-}
-
-/* Print tagged literal */
-static void print_tagged(const edn_value_t* value, int indent, const print_options_t* opts) {
-    const char* tag;
-    size_t tag_len;
-    edn_value_t* wrapped;
-
-    if (edn_tagged_get(value, &tag, &tag_len, &wrapped)) {
-        if (opts->use_colors)
-            printf("%s", COLOR_TAG);
-        printf("#%.*s ", (int) tag_len, tag);
-        if (opts->use_colors)
-            printf("%s", COLOR_RESET);
-
-        print_value(wrapped, indent, opts);
-    }
-}
-
-/* Print any EDN value */
-static void print_value(const edn_value_t* value, int indent, const print_options_t* opts) {
-    if (value == NULL) {
-        print_nil(opts);
-        return;
-    }
-
+/* Print a value that has no children */
+static void print_scalar(const edn_value_t* value, const print_options_t* opts) {
     switch (edn_type(value)) {
         case EDN_TYPE_NIL:
             print_nil(opts);
@@ -471,27 +319,153 @@ static void print_value(const edn_value_t* value, int indent, const print_option
         case EDN_TYPE_SYMBOL:
             print_symbol(value, opts);
             break;
+        default:
+            printf("<unknown type>");
+            break;
+    }
+}
+
+/* Layout of an open collection or tagged literal */
+typedef struct {
+    int indent; /* Indentation of its children */
+    bool multiline;
+} layout_t;
+
+/* Print the opening of `value` and return its children's layout */
+static layout_t print_open(const edn_value_t* value, int indent, const print_options_t* opts) {
+    /* Clojure style: first element on the same line, rest aligned below.
+     * Small vectors and sets (<= 3 elements) and maps (<= 2 entries) stay inline.
+     * Example: [1        or    [1 2 3]
+     *           2
+     *           3]
+     */
+    layout_t layout = {indent, false};
+    const char* tag;
+    size_t tag_len;
+    edn_value_t* wrapped;
+
+    switch (edn_type(value)) {
         case EDN_TYPE_LIST:
-            print_list(value, indent, opts);
+            printf("(");
             break;
         case EDN_TYPE_VECTOR:
-            print_vector(value, indent, opts);
-            break;
-        case EDN_TYPE_MAP:
-            print_map(value, indent, opts);
+            printf("[");
+            layout.multiline = edn_vector_count(value) > 3;
+            layout.indent = layout.multiline ? indent + 1 : indent;
             break;
         case EDN_TYPE_SET:
-            print_set(value, indent, opts);
+            printf("#{");
+            layout.multiline = edn_set_count(value) > 3;
+            layout.indent = layout.multiline ? indent + 2 : indent; /* 2 chars: #{ */
+            break;
+        case EDN_TYPE_MAP:
+            printf("{");
+            layout.multiline = edn_map_count(value) > 2;
+            layout.indent = layout.multiline ? indent + 1 : indent;
             break;
         case EDN_TYPE_TAGGED:
-            print_tagged(value, indent, opts);
+            if (edn_tagged_get(value, &tag, &tag_len, &wrapped)) {
+                if (opts->use_colors)
+                    printf("%s", COLOR_TAG);
+                printf("#%.*s ", (int) tag_len, tag);
+                if (opts->use_colors)
+                    printf("%s", COLOR_RESET);
+            }
+            break;
+        default:
+            break;
+    }
+    return layout;
+}
+
+/* Print the closing of `value` */
+static void print_close(const edn_value_t* value) {
+    switch (edn_type(value)) {
+        case EDN_TYPE_LIST:
+            printf(")");
+            break;
+        case EDN_TYPE_VECTOR:
+            printf("]");
+            break;
+        case EDN_TYPE_SET:
+        case EDN_TYPE_MAP:
+            printf("}");
             break;
         default:
-            printf("<unknown type>");
             break;
     }
 }
 
+/* Print any EDN value. The tree is walked with edn_walk rather than by
+ * recursion, so deeply nested input cannot overflow the stack. */
+static bool print_value(const edn_value_t* value, const print_options_t* opts) {
+    if (value == NULL) {
+        print_nil(opts);
+        return true;
+    }
+
+    edn_walk_t* walk = edn_walk_create(value, EDN_WALK_PRE | EDN_WALK_POST);
+    size_t capacity = 64;
+    layout_t* layouts = malloc(capacity * sizeof(*layouts)); /* One per open node, by depth */
+    if (walk == NULL || layouts == NULL) {
+        edn_walk_destroy(walk);
+        free(layouts);
+        return false;
+    }
+
+    edn_walk_item_t item;
+    while (edn_walk_next(walk, &item)) {
+        if (item.post) {
+            print_close(item.value);
+            continue;
+        }
+
+        int indent = 0;
+        if (item.depth > 0) {
+            const layout_t* parent = &layouts[item.depth - 1];
+            indent = parent->indent;
+            if (item.key != NULL) {
+                printf(" "); /* Between key and value */
+            } else if (item.index > 0) {
+                if (parent->multiline) {
+                    printf("\n");
+                    print_indent(indent);
+                } else {
+                    printf(" ");
+                }
+            }
+        }
+
+        switch (edn_type(item.value)) {
+            case EDN_TYPE_LIST:
+            case EDN_TYPE_VECTOR:
+            case EDN_TYPE_SET:
+            case EDN_TYPE_MAP:
+            case EDN_TYPE_TAGGED:
+                if (item.depth == capacity) {
+                    layout_t* grown = realloc(layouts, capacity * 2 * sizeof(*layouts));
+                    if (grown == NULL) {
+                        edn_walk_destroy(walk);
+                        free(layouts);
+                        return false;
+                    }
+                    layouts = grown;
+                    capacity *= 2;
+                }
+                layouts[item.depth] = print_open(item.value, indent, opts);
+                break;
+            default:
+                print_scalar(item.value, opts);
+                break;
+        }
+    }
+
+    bool ok = edn_walk_error(walk) == EDN_OK;
+    edn_walk_destroy(walk);
+    free(layouts);
+    return ok;
+}
+
 /* Read entire input into buffer */
 static char* read_input(FILE* fp, size_t* out_size) {
     size_t capacity = INITIAL_BUFFER_SIZE;
@@ -659,12 +633,15 @@ int main(int argc, char** argv) {
     }
 
     /* Pretty-print result */
-    print_value(result.value, 0, &opts);
+    bool printed = print_value(result.value, &opts);
     printf("\n");
+    if (!printed) {
+        fprintf(stderr, "Error: Out of memory\n");
+    }
 
     /* Cleanup */
     edn_free(result.value);
     free(input_data);
 
-    return 0;
+    return printed ? 0 : 1;
 }
@@ -0,0 +1,1256 @@
+/**
+ * EDN.C - Schema-to-C code generator
+ *
+ * Reads an EDN schema and writes a header/source pair with one C struct,
+ * one specialized decoder and one encoder per schema entry. Decoders run on
+ * edn_parse_events; key dispatch is unrolled into switches on keyword
+ * length and first byte, and every field store is a typed assignment in a
+ * per-event switch. Encoders write through edn_emitter_t.
+ *
+ * Usage:
+ *   edn_codegen schema.edn out/messages   # writes out/messages.h, out/messages.c
+ *
+ * Schema:
+ *   {:prefix "msg"                         ; optional C name prefix
+ *    :structs [{:name point
+ *               :fields [[:x :double :required]
+ *                        [:y :double :required]]}
+ *              {:name order
+ *               :fields [[:order/id :int64 :required]
+ *                        [:symbol [:string 16]]   ; char[16]
+ *                        [:side [:keyword 8]]     ; char[8], "ns/name"
+ *                        [:at point]              ; earlier struct
+ *                        [:fills [:array :double 8]]]}]}
+ *
+ * Field types: :bool :int32 :int64 :double [:string N] [:keyword N],
+ * a struct name, or [:array ELEMENT N] with any non-array ELEMENT. An
+ * array member `m` gets a `size_t m_count` companion. Member names are the
+ * key names with non-alphanumerics replaced by '_'.
+ */
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+
+#define MAX_STRUCTS 64
+#define MAX_FIELDS 64 /* Width of the generated seen/required masks */
+#define MAX_NAME 64
+
+typedef enum { T_BOOL, T_INT32, T_INT64, T_DOUBLE, T_STRING, T_KEYWORD, T_STRUCT, T_ARRAY } ftype_t;
+
+typedef struct {
+    ftype_t type;
+    size_t size; /* String/keyword buffer size */
+    int ref;     /* Struct index */
+} type_ref_t;
+
+typedef struct {
+    char ns[MAX_NAME]; /* Empty when the key has no namespace */
+    char name[MAX_NAME];
+    char member[MAX_NAME];
+    type_ref_t type;
+    type_ref_t element; /* T_ARRAY only */
+    size_t capacity;    /* T_ARRAY only */
+    bool required;
+} field_t;
+
+typedef struct {
+    char name[MAX_NAME];
+    char ctype[2 * MAX_NAME + 4]; /* prefix_name_t */
+    char fn[2 * MAX_NAME];    /* prefix_name */
+    field_t fields[MAX_FIELDS];
+    size_t field_count;
+    size_t depth;       /* Frames needed to decode it */
+    size_t first_field; /* Global index of fields[0] */
+} struct_t;
+
+typedef struct {
+    struct_t structs[MAX_STRUCTS];
+    size_t struct_count;
+    size_t total_fields;
+    char prefix[MAX_NAME];
+    const char* schema_path;
+    FILE* out;
+} gen_t;
+
+static void die(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "edn_codegen: ");
+    vfprintf(stderr, fmt, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    exit(1);
+}
+
+static void out(gen_t* g, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(g->out, fmt, args);
+    va_end(args);
+}
+
+static char* read_file(const char* path, size_t* size) {
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) {
+        die("cannot open %s", path);
+    }
+    fseek(fp, 0, SEEK_END);
+    long length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (length < 0) {
+        die("cannot read %s", path);
+    }
+    char* buffer = malloc((size_t) length + 1);
+    if (buffer == NULL || fread(buffer, 1, (size_t) length, fp) != (size_t) length) {
+        die("cannot read %s", path);
+    }
+    buffer[length] = '\0';
+    fclose(fp);
+    *size = (size_t) length;
+    return buffer;
+}
+
+static void copy_name(char* dst, const char* src, size_t length, const char* what) {
+    if (length >= MAX_NAME) {
+        die("%s name too long: %.*s", what, (int) length, src);
+    }
+    memcpy(dst, src, length);
+    dst[length] = '\0';
+}
+
+/* Key or struct name -> C identifier fragment */
+static void c_identifier(char* dst, const char* src) {
+    size_t i = 0;
+    for (; src[i] != '\0'; i++) {
+        dst[i] = isalnum((unsigned char) src[i]) ? src[i] : '_';
+    }
+    dst[i] = '\0';
+    if (isdigit((unsigned char) dst[0])) {
+        die("name must not start with a digit: %s", src);
+    }
+}
+
+static bool keyword_is(const edn_value_t* value, const char* expected) {
+    const char* ns;
+    const char* name;
+    size_t ns_length, name_length;
+    return edn_keyword_get(value, &ns, &ns_length, &name, &name_length) && ns == NULL &&
+           name_length == strlen(expected) && memcmp(name, expected, name_length) == 0;
+}
+
+static size_t positive_size(const edn_value_t* value, const char* what) {
+    int64_t n;
+    if (!edn_int64_get(value, &n) || n <= 0 || n > 1024 * 1024) {
+        die("%s must be a positive integer", what);
+    }
+    return (size_t) n;
+}
+
+static int find_struct(const gen_t* g, const char* name, size_t length) {
+    for (size_t i = 0; i < g->struct_count; i++) {
+        if (strlen(g->structs[i].name) == length && memcmp(g->structs[i].name, name, length) == 0) {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+static type_ref_t parse_type(const gen_t* g, const edn_value_t* value, bool allow_array,
+                             const edn_value_t** array_spec) {
+    type_ref_t t = {T_BOOL, 0, -1};
+    const char* ns;
+    const char* name;
+    size_t ns_length, name_length;
+
+    if (keyword_is(value, "bool")) {
+        t.type = T_BOOL;
+    } else if (keyword_is(value, "int32")) {
+        t.type = T_INT32;
+    } else if (keyword_is(value, "int64")) {
+        t.type = T_INT64;
+    } else if (keyword_is(value, "double")) {
+        t.type = T_DOUBLE;
+    } else if (edn_symbol_get(value, &ns, &ns_length, &name, &name_length) && ns == NULL) {
+        t.type = T_STRUCT;
+        t.ref = find_struct(g, name, name_length);
+        if (t.ref < 0) {
+            die("unknown struct %.*s (structs must be defined before use)", (int) name_length,
+                name);
+        }
+    } else if (edn_type(value) == EDN_TYPE_VECTOR && edn_vector_count(value) >= 2) {
+        const edn_value_t* head = edn_vector_get(value, 0);
+        if (keyword_is(head, "string") || keyword_is(head, "keyword")) {
+            t.type = keyword_is(head, "string") ? T_STRING : T_KEYWORD;
+            t.size = positive_size(edn_vector_get(value, 1), "buffer size");
+        } else if (keyword_is(head, "array") && allow_array && edn_vector_count(value) == 3) {
+            t.type = T_ARRAY;
+            *array_spec = value;
+        } else {
+            die("invalid type vector");
+        }
+    } else {
+        die("invalid field type");
+    }
+    return t;
+}
+
+static void parse_field(gen_t* g, struct_t* s, const edn_value_t* spec) {
+    if (edn_type(spec) != EDN_TYPE_VECTOR || edn_vector_count(spec) < 2) {
+        die("field in %s must be [key type & options]", s->name);
+    }
+    if (s->field_count == MAX_FIELDS) {
+        die("struct %s has more than %d fields", s->name, MAX_FIELDS);
+    }
+
+    field_t* f = &s->fields[s->field_count];
+    const char* ns;
+    const char* name;
+    size_t ns_length, name_length;
+    if (!edn_keyword_get(edn_vector_get(spec, 0), &ns, &ns_length, &name, &name_length)) {
+        die("field key in %s must be a keyword", s->name);
+    }
+    copy_name(f->ns, ns ? ns : "", ns ? ns_length : 0, "namespace");
+    copy_name(f->name, name, name_length, "field");
+    c_identifier(f->member, f->name);
+
+    const edn_value_t* array_spec = NULL;
+    f->type = parse_type(g, edn_vector_get(spec, 1), true, &array_spec);
+    if (array_spec != NULL) {
+        f->element = parse_type(g, edn_vector_get(array_spec, 1), false, NULL);
+        f->capacity = positive_size(edn_vector_get(array_spec, 2), "array capacity");
+    }
+
+    for (size_t i = 2; i < edn_vector_count(spec); i++) {
+        if (!keyword_is(edn_vector_get(spec, i), "required")) {
+            die("unknown option on %s/%s", s->name, f->name);
+        }
+        f->required = true;
+    }
+
+    for (size_t i = 0; i < s->field_count; i++) {
+        if (strcmp(s->fields[i].member, f->member) == 0) {
+            die("fields %s and %s of %s map to the same member", s->fields[i].name, f->name,
+                s->name);
+        }
+    }
+    s->field_count++;
+}
+
+static void parse_schema(gen_t* g, const edn_value_t* schema) {
+    if (edn_type(schema) != EDN_TYPE_MAP) {
+        die("schema must be a map");
+    }
+
+    const edn_value_t* prefix = edn_map_get_keyword(schema, "prefix");
+    if (prefix != NULL) {
+        size_t length;
+        const char* p = edn_string_get(prefix, &length);
+        if (p == NULL) {
+            die(":prefix must be a string");
+        }
+        copy_name(g->prefix, p, length, "prefix");
+    }
+
+    const edn_value_t* structs = edn_map_get_keyword(schema, "structs");
+    if (edn_type(structs) != EDN_TYPE_VECTOR || edn_vector_count(structs) == 0) {
+        die(":structs must be a non-empty vector");
+    }
+    if (edn_vector_count(structs) > MAX_STRUCTS) {
+        die("more than %d structs", MAX_STRUCTS);
+    }
+
+    for (size_t i = 0; i < edn_vector_count(structs); i++) {
+        const edn_value_t* spec = edn_vector_get(structs, i);
+        const char* ns;
+        const char* name;
+        size_t ns_length, name_length;
+        if (!edn_symbol_get(edn_map_get_keyword(spec, "name"), &ns, &ns_length, &name,
+                            &name_length) ||
+            ns != NULL) {
+            die("struct :name must be a plain symbol");
+        }
+        if (find_struct(g, name, name_length) >= 0) {
+            die("duplicate struct %.*s", (int) name_length, name);
+        }
+
+        struct_t* s = &g->structs[g->struct_count];
+        copy_name(s->name, name, name_length, "struct");
+        char id[MAX_NAME];
+        c_identifier(id, s->name);
+        snprintf(s->fn, sizeof(s->fn), "%s%s%s", g->prefix, g->prefix[0] ? "_" : "", id);
+        snprintf(s->ctype, sizeof(s->ctype), "%s%s%s_t", g->prefix, g->prefix[0] ? "_" : "", id);
+
+        const edn_value_t* fields = edn_map_get_keyword(spec, "fields");
+        if (edn_type(fields) != EDN_TYPE_VECTOR || edn_vector_count(fields) == 0) {
+            die("struct %s needs a non-empty :fields vector", s->name);
+        }
+        for (size_t j = 0; j < edn_vector_count(fields); j++) {
+            parse_field(g, s, edn_vector_get(fields, j));
+        }
+
+        /* Structs only reference earlier ones, so depths are already known */
+        s->depth = 1;
+        for (size_t j = 0; j < s->field_count; j++) {
+            const field_t* f = &s->fields[j];
+            const type_ref_t* t = f->type.type == T_ARRAY ? &f->element : &f->type;
+            size_t depth = 1 + (f->type.type == T_ARRAY ? 1 : 0) +
+                           (t->type == T_STRUCT ? g->structs[t->ref].depth : 0);
+            if (depth > s->depth) {
+                s->depth = depth;
+            }
+        }
+
+        s->first_field = g->total_fields;
+        g->total_fields += s->field_count;
+        g->struct_count++;
+    }
+}
+
+/* Whether any field or array element has type `want` (T_ARRAY: any array) */
+static bool schema_uses(const gen_t* g, ftype_t want) {
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        for (size_t j = 0; j < s->field_count; j++) {
+            const field_t* f = &s->fields[j];
+            if (f->type.type == want || (f->type.type == T_ARRAY && f->element.type == want)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* ========================================================================
+ * Header
+ * ======================================================================== */
+
+static void member_decl(gen_t* g, const type_ref_t* t, const char* member, const char* suffix) {
+    switch (t->type) {
+        case T_BOOL:
+            out(g, "    bool %s%s;\n", member, suffix);
+            break;
+        case T_INT32:
+            out(g, "    int32_t %s%s;\n", member, suffix);
+            break;
+        case T_INT64:
+            out(g, "    int64_t %s%s;\n", member, suffix);
+            break;
+        case T_DOUBLE:
+            out(g, "    double %s%s;\n", member, suffix);
+            break;
+        case T_STRING:
+        case T_KEYWORD:
+            out(g, "    char %s%s[%zu];\n", member, suffix, t->size);
+            break;
+        case T_STRUCT:
+            out(g, "    %s %s%s;\n", g->structs[t->ref].ctype, member, suffix);
+            break;
+        case T_ARRAY:
+            break;
+    }
+}
+
+static void write_header(gen_t* g, const char* guard) {
+    out(g, "/* Generated by edn_codegen from %s. Do not edit. */\n\n", g->schema_path);
+    out(g, "#ifndef %s\n#define %s\n\n", guard, guard);
+    out(g, "#include <stdbool.h>\n#include <stddef.h>\n#include <stdint.h>\n\n");
+    out(g, "#include \"edn.h\"\n\n");
+    out(g, "#ifdef __cplusplus\nextern \"C\" {\n#endif\n");
+
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        out(g, "\ntypedef struct {\n");
+        for (size_t j = 0; j < s->field_count; j++) {
+            const field_t* f = &s->fields[j];
+            if (f->type.type == T_ARRAY) {
+                char suffix[32];
+                snprintf(suffix, sizeof(suffix), "[%zu]", f->capacity);
+                member_decl(g, &f->element, f->member, suffix);
+                out(g, "    size_t %s_count;\n", f->member);
+            } else {
+                member_decl(g, &f->type, f->member, "");
+            }
+        }
+        out(g, "} %s;\n\n", s->ctype);
+        out(g, "/* Decode one EDN map into *out (zeroed first); errors as edn_decode */\n");
+        out(g, "edn_result_t %s_decode(const char* input, size_t length, %s* out);\n\n", s->fn,
+            s->ctype);
+        out(g, "/* Emit *value as an EDN map; 0 on success, -EDN_ERROR_* on failure */\n");
+        out(g, "int %s_encode(edn_emitter_t* emitter, const %s* value);\n", s->fn, s->ctype);
+    }
+
+    out(g, "\n#ifdef __cplusplus\n}\n#endif\n\n#endif /* %s */\n", guard);
+}
+
+/* ========================================================================
+ * Decoder
+ * ======================================================================== */
+
+static void field_enum(const gen_t* g, const struct_t* s, const field_t* f, char* buf,
+                       size_t size, bool element) {
+    (void) g;
+    snprintf(buf, size, "%s_%s__%s", element ? "E" : "F", s->fn, f->member);
+}
+
+/* Cases storing into member `m` of a field of type `want`, for both the
+ * field itself and array elements. `assign` is a printf format taking the
+ * lvalue. Returns whether any case was written. */
+static bool store_cases(gen_t* g, ftype_t want, const char* assign) {
+    bool any = false;
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        for (size_t j = 0; j < s->field_count; j++) {
+            const field_t* f = &s->fields[j];
+            bool element = f->type.type == T_ARRAY;
+            const type_ref_t* t = element ? &f->element : &f->type;
+            if (t->type != want) {
+                continue;
+            }
+            char id[3 * MAX_NAME];
+            char lvalue[4 * MAX_NAME];
+            field_enum(g, s, f, id, sizeof(id), element);
+            snprintf(lvalue, sizeof(lvalue), "((%s*) base)->%s%s", s->ctype, f->member,
+                     element ? "[index]" : "");
+            out(g, "        case %s:\n            ", id);
+            out(g, assign, lvalue, lvalue);
+            out(g, "\n            break;\n");
+            any = true;
+        }
+    }
+    return any;
+}
+
+static int compare_fields_by_name(const void* a, const void* b) {
+    const field_t* fa = *(const field_t* const*) a;
+    const field_t* fb = *(const field_t* const*) b;
+    size_t la = strlen(fa->name), lb = strlen(fb->name);
+    if (la != lb) {
+        return la < lb ? -1 : 1;
+    }
+    return (unsigned char) fa->name[0] - (unsigned char) fb->name[0];
+}
+
+static void write_matcher(gen_t* g, const struct_t* s) {
+    int indent = (int) strlen("static int match_(") + (int) strlen(s->fn);
+    out(g, "\nstatic int match_%s(const char* ns, size_t ns_length, const char* name,\n", s->fn);
+    out(g, "%*ssize_t name_length) {\n", indent, "");
+    out(g, "    (void) ns;\n    (void) ns_length;\n    (void) name;\n");
+    out(g, "    switch (name_length) {\n");
+
+    const field_t* sorted[MAX_FIELDS];
+    for (size_t i = 0; i < s->field_count; i++) {
+        sorted[i] = &s->fields[i];
+    }
+    qsort(sorted, s->field_count, sizeof(sorted[0]), compare_fields_by_name);
+
+    size_t i = 0;
+    while (i < s->field_count) {
+        size_t length = strlen(sorted[i]->name);
+        out(g, "        case %zu:\n            switch (name[0]) {\n", length);
+        while (i < s->field_count && strlen(sorted[i]->name) == length) {
+            char first = sorted[i]->name[0];
+            out(g, "                case '%s%c':\n", first == '\'' || first == '\\' ? "\\" : "",
+                first);
+            for (; i < s->field_count && strlen(sorted[i]->name) == length &&
+                   sorted[i]->name[0] == first;
+                 i++) {
+                const field_t* f = sorted[i];
+                char id[3 * MAX_NAME];
+                field_enum(g, s, f, id, sizeof(id), false);
+                out(g, "                    if (");
+                if (f->ns[0] != '\0') {
+                    out(g, "ns != NULL && ns_length == %zu && memcmp(ns, \"%s\", %zu) == 0",
+                        strlen(f->ns), f->ns, strlen(f->ns));
+                } else {
+                    out(g, "ns == NULL");
+                }
+                if (length > 1) {
+                    out(g, " &&\n                        memcmp(name + 1, \"%s\", %zu) == 0",
+                        f->name + 1, length - 1);
+                }
+                out(g, ") {\n                        return %s;\n                    }\n", id);
+            }
+            out(g, "                    break;\n");
+        }
+        out(g, "            }\n            break;\n");
+    }
+    out(g, "    }\n    return -1;\n}\n");
+}
+
+static const char* DECODER_PRELUDE =
+    "typedef struct {\n"
+    "    int kind;     /* K_* for a struct, F_* for an array */\n"
+    "    bool is_array;\n"
+    "    void* base;   /* The struct; for arrays, the struct owning the array */\n"
+    "    int pending;  /* Struct: F_* awaiting its value, SLOT_KEY or SLOT_SKIP */\n"
+    "    uint64_t seen;\n"
+    "    size_t count; /* Array: elements stored so far */\n"
+    "} frame_t;\n"
+    "\n"
+    "typedef struct {\n"
+    "    frame_t frames[MAX_FRAMES];\n"
+    "    size_t depth;\n"
+    "    size_t skip;         /* Open collections inside a skipped form */\n"
+    "    bool skip_is_meta;   /* The skipped form is a metadata payload */\n"
+    "    size_t pending_meta; /* Metadata payloads before the next form */\n"
+    "    int root;\n"
+    "    void* out;\n"
+    "    bool done;\n"
+    "    edn_error_t error;\n"
+    "    const char* error_message;\n"
+    "} state_t;\n"
+    "\n"
+    "static int fail(state_t* st, edn_error_t error, const char* message) {\n"
+    "    st->error = error;\n"
+    "    st->error_message = message;\n"
+    "    return 1;\n"
+    "}\n"
+    "\n"
+    "static int mismatch(state_t* st) {\n"
+    "    if (st->depth == 0) {\n"
+    "        return fail(st, EDN_ERROR_SCHEMA_MISMATCH, \"Expected a map\");\n"
+    "    }\n"
+    "    return fail(st, EDN_ERROR_SCHEMA_MISMATCH, \"Value does not match field type\");\n"
+    "}\n"
+    "\n"
+    "/* Where the next form goes: *slot is an F_/E_ id or a SLOT_ marker */\n"
+    "static int next_slot(state_t* st, int* slot, void** base, size_t* index) {\n"
+    "    if (st->pending_meta > 0) {\n"
+    "        st->pending_meta--;\n"
+    "        *slot = SLOT_META;\n"
+    "        return 0;\n"
+    "    }\n"
+    "    if (st->depth == 0) {\n"
+    "        *slot = SLOT_ROOT;\n"
+    "        *base = st->out;\n"
+    "        return 0;\n"
+    "    }\n"
+    "    frame_t* frame = &st->frames[st->depth - 1];\n"
+    "    *base = frame->base;\n"
+    "    if (frame->is_array) {\n"
+    "        if (frame->count == array_capacity(frame->kind)) {\n"
+    "            return fail(st, EDN_ERROR_SCHEMA_MISMATCH, \"Array capacity exceeded\");\n"
+    "        }\n"
+    "        *slot = frame->kind + FIELD_COUNT;\n"
+    "        *index = frame->count;\n"
+    "        return 0;\n"
+    "    }\n"
+    "    *slot = frame->pending;\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "static void slot_done(state_t* st) {\n"
+    "    if (st->depth == 0) {\n"
+    "        st->done = true;\n"
+    "        return;\n"
+    "    }\n"
+    "    frame_t* frame = &st->frames[st->depth - 1];\n"
+    "    if (frame->is_array) {\n"
+    "        frame->count++;\n"
+    "    } else {\n"
+    "        frame->pending = frame->pending == SLOT_KEY ? SLOT_SKIP : SLOT_KEY;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "/* Shared prologue of scalar events; falls through when the slot is typed */\n"
+    "#define SCALAR_SLOT(st, slot, base, index)                 \\\n"
+    "    if ((st)->skip > 0) {                                  \\\n"
+    "        return 0;                                          \\\n"
+    "    }                                                      \\\n"
+    "    if (next_slot((st), &(slot), &(base), &(index)) != 0) { \\\n"
+    "        return 1;                                          \\\n"
+    "    }                                                      \\\n"
+    "    if ((slot) == SLOT_META) {                             \\\n"
+    "        return 0;                                          \\\n"
+    "    }                                                      \\\n"
+    "    if ((slot) == SLOT_KEY || (slot) == SLOT_SKIP) {       \\\n"
+    "        slot_done(st);                                     \\\n"
+    "        return 0;                                          \\\n"
+    "    }\n"
+    "\n"
+    "#define SCALAR_LOCALS \\\n"
+    "    state_t* st = ctx; \\\n"
+    "    int slot;          \\\n"
+    "    void* base = NULL; \\\n"
+    "    size_t index = 0\n"
+    "\n"
+    "static int push_struct(state_t* st, int kind, void* base) {\n"
+    "    if (st->depth == MAX_FRAMES) {\n"
+    "        return fail(st, EDN_ERROR_MAX_DEPTH_EXCEEDED, \"Schema nesting exceeded\");\n"
+    "    }\n"
+    "    frame_t* frame = &st->frames[st->depth++];\n"
+    "    frame->kind = kind;\n"
+    "    frame->is_array = false;\n"
+    "    frame->base = base;\n"
+    "    frame->pending = SLOT_KEY;\n"
+    "    frame->seen = 0;\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "/* Skip the collection that just opened; it fills its slot when it closes */\n"
+    "static int skip_collection(state_t* st, int slot) {\n"
+    "    st->skip = 1;\n"
+    "    st->skip_is_meta = slot == SLOT_META;\n"
+    "    return 0;\n"
+    "}\n";
+
+/* Only for schemas with array fields */
+static const char* DECODER_PUSH_ARRAY =
+    "\n"
+    "static int push_array(state_t* st, int field, void* base) {\n"
+    "    if (st->depth == MAX_FRAMES) {\n"
+    "        return fail(st, EDN_ERROR_MAX_DEPTH_EXCEEDED, \"Schema nesting exceeded\");\n"
+    "    }\n"
+    "    frame_t* frame = &st->frames[st->depth++];\n"
+    "    frame->kind = field;\n"
+    "    frame->is_array = true;\n"
+    "    frame->base = base;\n"
+    "    frame->count = 0;\n"
+    "    return 0;\n"
+    "}\n";
+
+static const char* DECODER_HELPERS =
+    "\n"
+    "static int on_nil(void* ctx) {\n"
+    "    SCALAR_LOCALS;\n"
+    "    SCALAR_SLOT(st, slot, base, index);\n"
+    "    (void) base;\n"
+    "    (void) index;\n"
+    "    if (slot == SLOT_ROOT) {\n"
+    "        return mismatch(st);\n"
+    "    }\n"
+    "    slot_done(st); /* Member stays zeroed */\n"
+    "    return 0;\n"
+    "}\n"
+    "\n"
+    "static bool copy_keyword(char* dst, size_t size, const char* ns, size_t ns_length,\n"
+    "                         const char* name, size_t name_length) {\n"
+    "    size_t length = (ns != NULL ? ns_length + 1 : 0) + name_length;\n"
+    "    if (length >= size) {\n"
+    "        return false;\n"
+    "    }\n"
+    "    if (ns != NULL) {\n"
+    "        memcpy(dst, ns, ns_length);\n"
+    "        dst += ns_length;\n"
+    "        *dst++ = '/';\n"
+    "    }\n"
+    "    memcpy(dst, name, name_length);\n"
+    "    dst[name_length] = '\\0';\n"
+    "    return true;\n"
+    "}\n"
+    "\n"
+    "/* Symbols, characters and arbitrary-precision numbers fit no field */\n"
+    "static int unsupported(void* ctx) {\n"
+    "    SCALAR_LOCALS;\n"
+    "    SCALAR_SLOT(st, slot, base, index);\n"
+    "    (void) base;\n"
+    "    (void) index;\n"
+    "    return mismatch(st);\n"
+    "}\n"
+    "\n"
+    "static int on_symbol(void* ctx, const char* ns, size_t ns_length, const char* name,\n"
+    "                     size_t name_length) {\n"
+    "    (void) ns;\n"
+    "    (void) ns_length;\n"
+    "    (void) name;\n"
+    "    (void) name_length;\n"
+    "    return unsupported(ctx);\n"
+    "}\n"
+    "\n"
+    "static int on_character(void* ctx, uint32_t codepoint) {\n"
+    "    (void) codepoint;\n"
+    "    return unsupported(ctx);\n"
+    "}\n"
+    "\n"
+    "static int on_bigint(void* ctx, const char* digits, size_t length, bool negative,\n"
+    "                     uint8_t radix) {\n"
+    "    (void) digits;\n"
+    "    (void) length;\n"
+    "    (void) negative;\n"
+    "    (void) radix;\n"
+    "    return unsupported(ctx);\n"
+    "}\n"
+    "\n"
+    "static int on_bigdec(void* ctx, const char* digits, size_t length, bool negative) {\n"
+    "    (void) digits;\n"
+    "    (void) length;\n"
+    "    (void) negative;\n"
+    "    return unsupported(ctx);\n"
+    "}\n"
+    "\n"
+    "static int on_ratio(void* ctx, int64_t numerator, int64_t denominator) {\n"
+    "    (void) numerator;\n"
+    "    (void) denominator;\n"
+    "    return unsupported(ctx);\n"
+    "}\n"
+    "\n"
+    "static int on_bigratio(void* ctx, const char* numerator, size_t numer_length,\n"
+    "                       bool negative, const char* denominator, size_t denom_length) {\n"
+    "    (void) numerator;\n"
+    "    (void) numer_length;\n"
+    "    (void) negative;\n"
+    "    (void) denominator;\n"
+    "    (void) denom_length;\n"
+    "    return unsupported(ctx);\n"
+    "}\n"
+    "\n"
+    "static int on_begin_set(void* ctx) {\n"
+    "    SCALAR_LOCALS;\n"
+    "    if (st->skip > 0) {\n"
+    "        st->skip++;\n"
+    "        return 0;\n"
+    "    }\n"
+    "    if (next_slot(st, &slot, &base, &index) != 0) {\n"
+    "        return 1;\n"
+    "    }\n"
+    "    if (slot == SLOT_META || slot == SLOT_KEY || slot == SLOT_SKIP) {\n"
+    "        return skip_collection(st, slot);\n"
+    "    }\n"
+    "    return mismatch(st);\n"
+    "}\n"
+    "\n"
+    "static int on_meta(void* ctx) {\n"
+    "    state_t* st = ctx;\n"
+    "    if (st->skip == 0) {\n"
+    "        st->pending_meta++;\n"
+    "    }\n"
+    "    return 0;\n"
+    "}\n";
+
+static void write_scalar_handler(gen_t* g, const char* signature, const char* prologue,
+                                 const char* const* stores, const ftype_t* types,
+                                 size_t count) {
+    out(g, "\nstatic int %s {\n    SCALAR_LOCALS;\n    SCALAR_SLOT(st, slot, base, index);\n",
+        signature);
+    if (prologue != NULL) {
+        out(g, "%s", prologue);
+    }
+    out(g, "    switch (slot) {\n");
+    bool any = false;
+    for (size_t i = 0; i < count; i++) {
+        any |= store_cases(g, types[i], stores[i]);
+    }
+    out(g, "        default:\n            return mismatch(st);\n    }\n");
+    if (!any) {
+        out(g, "    (void) value;\n    (void) base;\n    (void) index;\n");
+    }
+    out(g, "    slot_done(st);\n    return 0;\n}\n");
+}
+
+static void write_decoder(gen_t* g, const char* header_name) {
+    out(g, "/* Generated by edn_codegen from %s. Do not edit. */\n\n", g->schema_path);
+    out(g, "#include \"%s\"\n\n#include <stdlib.h>\n#include <string.h>\n\n", header_name);
+
+    size_t max_depth = 0;
+    for (size_t i = 0; i < g->struct_count; i++) {
+        if (g->structs[i].depth > max_depth) {
+            max_depth = g->structs[i].depth;
+        }
+    }
+    out(g, "#define MAX_FRAMES %zu\n#define FIELD_COUNT %zu\n\n", max_depth, g->total_fields);
+
+    out(g, "/* Struct kinds */\nenum {\n");
+    for (size_t i = 0; i < g->struct_count; i++) {
+        out(g, "    K_%s,\n", g->structs[i].fn);
+    }
+    out(g, "};\n\n");
+
+    out(g, "/* Slots: F_ fields, E_ array elements (F_ + FIELD_COUNT), and markers */\n");
+    out(g, "enum {\n    SLOT_KEY = -1,\n    SLOT_SKIP = -2,\n    SLOT_META = -3,\n");
+    out(g, "    SLOT_ROOT = -4,\n");
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        for (size_t j = 0; j < s->field_count; j++) {
+            char id[3 * MAX_NAME];
+            field_enum(g, s, &s->fields[j], id, sizeof(id), false);
+            out(g, "    %s = %zu,\n", id, s->first_field + j);
+            if (s->fields[j].type.type == T_ARRAY) {
+                field_enum(g, s, &s->fields[j], id, sizeof(id), true);
+                out(g, "    %s = %zu,\n", id, g->total_fields + s->first_field + j);
+            }
+        }
+    }
+    out(g, "};\n\n");
+
+    out(g, "static const uint64_t REQUIRED[] = {\n");
+    for (size_t i = 0; i < g->struct_count; i++) {
+        uint64_t mask = 0;
+        for (size_t j = 0; j < g->structs[i].field_count; j++) {
+            if (g->structs[i].fields[j].required) {
+                mask |= (uint64_t) 1 << j;
+            }
+        }
+        out(g, "    0x%llxULL, /* %s */\n", (unsigned long long) mask, g->structs[i].name);
+    }
+    out(g, "};\n\n");
+
+    out(g, "static size_t array_capacity(int field) {\n    switch (field) {\n");
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        for (size_t j = 0; j < s->field_count; j++) {
+            if (s->fields[j].type.type == T_ARRAY) {
+                char id[3 * MAX_NAME];
+                field_enum(g, s, &s->fields[j], id, sizeof(id), false);
+                out(g, "        case %s:\n            return %zu;\n", id, s->fields[j].capacity);
+            }
+        }
+    }
+    out(g, "        default:\n            return 0;\n    }\n}\n\n");
+
+    out(g, "%s", DECODER_PRELUDE);
+    if (schema_uses(g, T_ARRAY)) {
+        out(g, "%s", DECODER_PUSH_ARRAY);
+    }
+    for (size_t i = 0; i < g->struct_count; i++) {
+        write_matcher(g, &g->structs[i]);
+    }
+    out(g, "%s", DECODER_HELPERS);
+
+    /* Typed scalar handlers: one case per member that accepts the event */
+    static const char* bool_store[] = {"%s = value;"};
+    static const ftype_t bool_types[] = {T_BOOL};
+    write_scalar_handler(g, "on_bool(void* ctx, bool value)", NULL, bool_store, bool_types, 1);
+
+    static const char* int_store[] = {
+        "%s = value;",
+        "if (value < INT32_MIN || value > INT32_MAX) {\n"
+        "                return fail(st, EDN_ERROR_SCHEMA_MISMATCH, \"Integer out of range\");\n"
+        "            }\n"
+        "            %s = (int32_t) value;",
+        "%s = (double) value;"};
+    static const ftype_t int_types[] = {T_INT64, T_INT32, T_DOUBLE};
+    write_scalar_handler(g, "on_int(void* ctx, int64_t value)", NULL, int_store, int_types, 3);
+
+    static const char* double_store[] = {"%s = value;"};
+    static const ftype_t double_types[] = {T_DOUBLE};
+    write_scalar_handler(g, "on_double(void* ctx, double value)", NULL, double_store,
+                         double_types, 1);
+
+    /* Strings and keywords copy into buffers of per-member size */
+    out(g, "\nstatic int on_string(void* ctx, const char* s, size_t length) {\n");
+    out(g, "    SCALAR_LOCALS;\n    SCALAR_SLOT(st, slot, base, index);\n");
+    out(g, "    char* dst;\n    size_t size;\n    switch (slot) {\n");
+    bool any_string = false;
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        for (size_t j = 0; j < s->field_count; j++) {
+            const field_t* f = &s->fields[j];
+            bool element = f->type.type == T_ARRAY;
+            const type_ref_t* t = element ? &f->element : &f->type;
+            if (t->type != T_STRING) {
+                continue;
+            }
+            char id[3 * MAX_NAME];
+            field_enum(g, s, f, id, sizeof(id), element);
+            out(g, "        case %s:\n", id);
+            out(g, "            dst = ((%s*) base)->%s%s;\n", s->ctype, f->member,
+                element ? "[index]" : "");
+            out(g, "            size = %zu;\n            break;\n", t->size);
+            any_string = true;
+        }
+    }
+    out(g, "        default:\n            return mismatch(st);\n    }\n");
+    if (!any_string) {
+        out(g, "    (void) base;\n    (void) index;\n");
+    }
+    out(g, "    if (length >= size) {\n");
+    out(g, "        return fail(st, EDN_ERROR_SCHEMA_MISMATCH,\n"
+           "                    \"String too long for field\");\n");
+    out(g, "    }\n    memcpy(dst, s, length);\n    dst[length] = '\\0';\n");
+    out(g, "    slot_done(st);\n    return 0;\n}\n");
+
+    /* Keywords: map keys dispatch to the per-struct matcher */
+    out(g, "\nstatic int on_keyword(void* ctx, const char* ns, size_t ns_length,\n"
+           "                      const char* name, size_t name_length) {\n");
+    out(g, "    SCALAR_LOCALS;\n");
+    out(g, "    if (st->skip > 0) {\n        return 0;\n    }\n");
+    out(g, "    if (next_slot(st, &slot, &base, &index) != 0) {\n        return 1;\n    }\n");
+    out(g, "    if (slot == SLOT_KEY) {\n");
+    out(g, "        frame_t* frame = &st->frames[st->depth - 1];\n");
+    out(g, "        int field = -1;\n        int first = 0;\n");
+    out(g, "        switch (frame->kind) {\n");
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        out(g, "            case K_%s:\n", s->fn);
+        out(g, "                field = match_%s(ns, ns_length, name, name_length);\n", s->fn);
+        out(g, "                first = %zu;\n                break;\n", s->first_field);
+    }
+    out(g, "        }\n");
+    out(g, "        if (field < 0) {\n            frame->pending = SLOT_SKIP;\n");
+    out(g, "            return 0;\n        }\n");
+    out(g, "        uint64_t bit = (uint64_t) 1 << (field - first);\n");
+    out(g, "        if (frame->seen & bit) {\n");
+    out(g, "            return fail(st, EDN_ERROR_DUPLICATE_KEY, \"Duplicate key in map\");\n");
+    out(g, "        }\n        frame->seen |= bit;\n        frame->pending = field;\n");
+    out(g, "        return 0;\n    }\n");
+    out(g, "    if (slot == SLOT_META) {\n        return 0;\n    }\n");
+    out(g, "    if (slot == SLOT_SKIP) {\n        slot_done(st);\n        return 0;\n    }\n");
+    out(g, "    char* dst;\n    size_t size;\n    switch (slot) {\n");
+    bool any_keyword = false;
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        for (size_t j = 0; j < s->field_count; j++) {
+            const field_t* f = &s->fields[j];
+            bool element = f->type.type == T_ARRAY;
+            const type_ref_t* t = element ? &f->element : &f->type;
+            if (t->type != T_KEYWORD) {
+                continue;
+            }
+            char id[3 * MAX_NAME];
+            field_enum(g, s, f, id, sizeof(id), element);
+            out(g, "        case %s:\n", id);
+            out(g, "            dst = ((%s*) base)->%s%s;\n", s->ctype, f->member,
+                element ? "[index]" : "");
+            out(g, "            size = %zu;\n            break;\n", t->size);
+            any_keyword = true;
+        }
+    }
+    out(g, "        default:\n            return mismatch(st);\n    }\n");
+    if (!any_keyword) {
+        out(g, "    (void) base;\n    (void) index;\n");
+    }
+    out(g, "    if (!copy_keyword(dst, size, ns, ns_length, name, name_length)) {\n");
+    out(g, "        return fail(st, EDN_ERROR_SCHEMA_MISMATCH, \"Keyword too long for field\");\n");
+    out(g, "    }\n    slot_done(st);\n    return 0;\n}\n");
+
+    /* Collections */
+    out(g, "\nstatic int on_begin_map(void* ctx) {\n    SCALAR_LOCALS;\n");
+    out(g, "    if (st->skip > 0) {\n        st->skip++;\n        return 0;\n    }\n");
+    out(g, "    if (next_slot(st, &slot, &base, &index) != 0) {\n        return 1;\n    }\n");
+    out(g, "    switch (slot) {\n");
+    out(g, "        case SLOT_META:\n        case SLOT_KEY:\n        case SLOT_SKIP:\n");
+    out(g, "            return skip_collection(st, slot);\n");
+    out(g, "        case SLOT_ROOT:\n            return push_struct(st, st->root, base);\n");
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        for (size_t j = 0; j < s->field_count; j++) {
+            const field_t* f = &s->fields[j];
+            bool element = f->type.type == T_ARRAY;
+            const type_ref_t* t = element ? &f->element : &f->type;
+            if (t->type != T_STRUCT) {
+                continue;
+            }
+            char id[3 * MAX_NAME];
+            field_enum(g, s, f, id, sizeof(id), element);
+            out(g, "        case %s:\n", id);
+            out(g, "            return push_struct(st, K_%s, &((%s*) base)->%s%s);\n",
+                g->structs[t->ref].fn, s->ctype, f->member, element ? "[index]" : "");
+        }
+    }
+    out(g, "        default:\n            return mismatch(st);\n    }\n}\n");
+
+    out(g, "\nstatic int on_begin_sequence(void* ctx) {\n    SCALAR_LOCALS;\n");
+    out(g, "    (void) index;\n");
+    out(g, "    if (st->skip > 0) {\n        st->skip++;\n        return 0;\n    }\n");
+    out(g, "    if (next_slot(st, &slot, &base, &index) != 0) {\n        return 1;\n    }\n");
+    out(g, "    switch (slot) {\n");
+    out(g, "        case SLOT_META:\n        case SLOT_KEY:\n        case SLOT_SKIP:\n");
+    out(g, "            return skip_collection(st, slot);\n");
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        for (size_t j = 0; j < s->field_count; j++) {
+            if (s->fields[j].type.type == T_ARRAY) {
+                char id[3 * MAX_NAME];
+                field_enum(g, s, &s->fields[j], id, sizeof(id), false);
+                out(g, "        case %s:\n            return push_array(st, %s, base);\n", id,
+                    id);
+            }
+        }
+    }
+    out(g, "        default:\n            return mismatch(st);\n    }\n}\n");
+
+    out(g, "\nstatic int on_end(void* ctx) {\n    state_t* st = ctx;\n");
+    out(g, "    if (st->skip > 0) {\n");
+    out(g, "        if (--st->skip == 0 && !st->skip_is_meta) {\n            slot_done(st);\n");
+    out(g, "        }\n        return 0;\n    }\n");
+    out(g, "    frame_t* frame = &st->frames[st->depth - 1];\n");
+    out(g, "    if (!frame->is_array) {\n");
+    out(g, "        if ((REQUIRED[frame->kind] & ~frame->seen) != 0) {\n");
+    out(g, "            return fail(st, EDN_ERROR_SCHEMA_MISMATCH, \"Missing required field\");\n");
+    out(g, "        }\n    } else {\n        switch (frame->kind) {\n");
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        for (size_t j = 0; j < s->field_count; j++) {
+            if (s->fields[j].type.type == T_ARRAY) {
+                char id[3 * MAX_NAME];
+                field_enum(g, s, &s->fields[j], id, sizeof(id), false);
+                out(g, "            case %s:\n", id);
+                out(g, "                ((%s*) frame->base)->%s_count = frame->count;\n",
+                    s->ctype, s->fields[j].member);
+                out(g, "                break;\n");
+            }
+        }
+    }
+    out(g, "        }\n    }\n    st->depth--;\n    slot_done(st);\n    return 0;\n}\n");
+
+    out(g, "\nstatic const edn_event_handlers_t HANDLERS = {\n");
+    out(g, "    .on_nil = on_nil,\n    .on_bool = on_bool,\n    .on_int = on_int,\n");
+    out(g, "    .on_double = on_double,\n    .on_string = on_string,\n");
+    out(g, "    .on_keyword = on_keyword,\n    .on_symbol = on_symbol,\n");
+    out(g, "    .on_character = on_character,\n    .on_bigint = on_bigint,\n");
+    out(g, "    .on_bigdec = on_bigdec,\n    .on_ratio = on_ratio,\n");
+    out(g, "    .on_bigratio = on_bigratio,\n    .on_begin_list = on_begin_sequence,\n");
+    out(g, "    .on_end_list = on_end,\n    .on_begin_vector = on_begin_sequence,\n");
+    out(g, "    .on_end_vector = on_end,\n    .on_begin_set = on_begin_set,\n");
+    out(g, "    .on_end_set = on_end,\n    .on_begin_map = on_begin_map,\n");
+    out(g, "    .on_end_map = on_end,\n    .on_meta = on_meta,\n");
+    out(g, "    .decode_strings = true,\n};\n");
+
+    out(g, "\nstatic edn_result_t decode(int root, void* out, size_t size, const char* input,\n"
+           "                           size_t length) {\n");
+    out(g, "    edn_result_t result = {0};\n    if (out == NULL) {\n");
+    out(g, "        result.error = EDN_ERROR_INVALID_ARGUMENT;\n");
+    out(g, "        result.error_message = \"Output is NULL\";\n        return result;\n    }\n");
+    out(g, "    state_t st;\n    st.depth = 0;\n    st.skip = 0;\n    st.skip_is_meta = false;\n");
+    out(g, "    st.pending_meta = 0;\n    st.root = root;\n    st.out = out;\n");
+    out(g, "    st.done = false;\n    st.error = EDN_OK;\n    st.error_message = NULL;\n");
+    out(g, "    memset(out, 0, size);\n\n");
+    out(g, "    result = edn_parse_events(input, length, &HANDLERS, &st);\n");
+    out(g, "    if (result.error == EDN_ERROR_ABORTED && st.error != EDN_OK) {\n");
+    out(g, "        result.error = st.error;\n        result.error_message = st.error_message;\n");
+    out(g, "    } else if (result.error == EDN_OK && !st.done) {\n");
+    out(g, "        result.error = EDN_ERROR_SCHEMA_MISMATCH;\n");
+    out(g, "        result.error_message = \"Expected a map\";\n    }\n");
+    out(g, "    return result;\n}\n");
+
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        out(g, "\nedn_result_t %s_decode(const char* input, size_t length, %s* out) {\n", s->fn,
+            s->ctype);
+        out(g, "    return decode(K_%s, out, sizeof(%s), input, length);\n}\n", s->fn, s->ctype);
+    }
+}
+
+/* ========================================================================
+ * Encoder
+ * ======================================================================== */
+
+static const char* ENCODER_PRELUDE =
+    "\n"
+    "#define EMIT(call)          \\\n"
+    "    do {                    \\\n"
+    "        int rc_ = (call);   \\\n"
+    "        if (rc_ != 0) {     \\\n"
+    "            return rc_;     \\\n"
+    "        }                   \\\n"
+    "    } while (0)\n";
+
+/* Only for schemas with string fields */
+static const char* ENCODER_TEXT =
+    "\n"
+    "/* edn_emit_string takes the escaped body; re-escape decoded text */\n"
+    "static int emit_text(edn_emitter_t* emitter, const char* s) {\n"
+    "    size_t length = strlen(s);\n"
+    "    size_t escaped = length;\n"
+    "    for (size_t i = 0; i < length; i++) {\n"
+    "        char c = s[i];\n"
+    "        escaped += c == '\"' || c == '\\\\' || c == '\\n' || c == '\\t' || c == '\\r';\n"
+    "    }\n"
+    "    if (escaped == length) {\n"
+    "        return edn_emit_string(emitter, s, length);\n"
+    "    }\n"
+    "\n"
+    "    char stack[256];\n"
+    "    char* buffer = escaped <= sizeof(stack) ? stack : malloc(escaped);\n"
+    "    if (buffer == NULL) {\n"
+    "        return -EDN_ERROR_OUT_OF_MEMORY;\n"
+    "    }\n"
+    "    char* p = buffer;\n"
+    "    for (size_t i = 0; i < length; i++) {\n"
+    "        char c = s[i];\n"
+    "        switch (c) {\n"
+    "            case '\"':\n"
+    "            case '\\\\':\n"
+    "                *p++ = '\\\\';\n"
+    "                *p++ = c;\n"
+    "                break;\n"
+    "            case '\\n':\n"
+    "                *p++ = '\\\\';\n"
+    "                *p++ = 'n';\n"
+    "                break;\n"
+    "            case '\\t':\n"
+    "                *p++ = '\\\\';\n"
+    "                *p++ = 't';\n"
+    "                break;\n"
+    "            case '\\r':\n"
+    "                *p++ = '\\\\';\n"
+    "                *p++ = 'r';\n"
+    "                break;\n"
+    "            default:\n"
+    "                *p++ = c;\n"
+    "                break;\n"
+    "        }\n"
+    "    }\n"
+    "    int rc = edn_emit_string(emitter, buffer, escaped);\n"
+    "    if (buffer != stack) {\n"
+    "        free(buffer);\n"
+    "    }\n"
+    "    return rc;\n"
+    "}\n";
+
+/* Only for schemas with keyword fields */
+static const char* ENCODER_KEYWORD_TEXT =
+    "\n"
+    "/* Keyword members hold \"ns/name\" or \"name\"; empty means nil */\n"
+    "static int emit_keyword_text(edn_emitter_t* emitter, const char* s) {\n"
+    "    if (s[0] == '\\0') {\n"
+    "        return edn_emit_nil(emitter);\n"
+    "    }\n"
+    "    const char* slash = strchr(s, '/');\n"
+    "    if (slash == NULL || slash == s || slash[1] == '\\0') {\n"
+    "        return edn_emit_keyword(emitter, s);\n"
+    "    }\n"
+    "    char ns[256];\n"
+    "    size_t ns_length = (size_t) (slash - s);\n"
+    "    if (ns_length >= sizeof(ns)) {\n"
+    "        return -EDN_ERROR_INVALID_ARGUMENT;\n"
+    "    }\n"
+    "    memcpy(ns, s, ns_length);\n"
+    "    ns[ns_length] = '\\0';\n"
+    "    return edn_emit_keyword_ns(emitter, ns, slash + 1);\n"
+    "}\n";
+
+static void emit_value(gen_t* g, const type_ref_t* t, const char* expr, const char* indent) {
+    switch (t->type) {
+        case T_BOOL:
+            out(g, "%sEMIT(edn_emit_bool(emitter, %s));\n", indent, expr);
+            break;
+        case T_INT32:
+        case T_INT64:
+            out(g, "%sEMIT(edn_emit_int(emitter, %s));\n", indent, expr);
+            break;
+        case T_DOUBLE:
+            out(g, "%sEMIT(edn_emit_double(emitter, %s));\n", indent, expr);
+            break;
+        case T_STRING:
+            out(g, "%sEMIT(emit_text(emitter, %s));\n", indent, expr);
+            break;
+        case T_KEYWORD:
+            out(g, "%sEMIT(emit_keyword_text(emitter, %s));\n", indent, expr);
+            break;
+        case T_STRUCT:
+            out(g, "%sEMIT(%s_encode(emitter, &%s));\n", indent, g->structs[t->ref].fn, expr);
+            break;
+        case T_ARRAY:
+            break;
+    }
+}
+
+static void write_encoder(gen_t* g) {
+    out(g, "%s", ENCODER_PRELUDE);
+    if (schema_uses(g, T_STRING)) {
+        out(g, "%s", ENCODER_TEXT);
+    }
+    if (schema_uses(g, T_KEYWORD)) {
+        out(g, "%s", ENCODER_KEYWORD_TEXT);
+    }
+
+    for (size_t i = 0; i < g->struct_count; i++) {
+        const struct_t* s = &g->structs[i];
+        out(g, "\nint %s_encode(edn_emitter_t* emitter, const %s* value) {\n", s->fn, s->ctype);
+        out(g, "    (void) value;\n    EMIT(edn_emit_begin_map(emitter));\n");
+        for (size_t j = 0; j < s->field_count; j++) {
+            const field_t* f = &s->fields[j];
+            if (f->ns[0] != '\0') {
+                out(g, "    EMIT(edn_emit_keyword_ns(emitter, \"%s\", \"%s\"));\n", f->ns,
+                    f->name);
+            } else {
+                out(g, "    EMIT(edn_emit_keyword(emitter, \"%s\"));\n", f->name);
+            }
+
+            char expr[3 * MAX_NAME];
+            if (f->type.type == T_ARRAY) {
+                out(g, "    EMIT(edn_emit_begin_vector(emitter));\n");
+                out(g, "    for (size_t i = 0; i < value->%s_count && i < %zu; i++) {\n",
+                    f->member, f->capacity);
+                snprintf(expr, sizeof(expr), "value->%s[i]", f->member);
+                emit_value(g, &f->element, expr, "        ");
+                out(g, "    }\n    EMIT(edn_emit_end_vector(emitter));\n");
+            } else {
+                snprintf(expr, sizeof(expr), "value->%s", f->member);
+                emit_value(g, &f->type, expr, "    ");
+            }
+        }
+        out(g, "    return edn_emit_end_map(emitter);\n}\n");
+    }
+}
+
+static void open_output(gen_t* g, const char* path) {
+    g->out = fopen(path, "w");
+    if (g->out == NULL) {
+        die("cannot write %s", path);
+    }
+}
+
+static void close_output(gen_t* g, const char* path) {
+    if (fclose(g->out) != 0) {
+        die("cannot write %s", path);
+    }
+    g->out = NULL;
+}
+
+static void print_usage(const char* program_name) {
+    fprintf(stderr, "Usage: %s SCHEMA.edn OUTPUT_BASE\n", program_name);
+    fprintf(stderr, "Writes OUTPUT_BASE.h and OUTPUT_BASE.c\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    size_t size;
+    char* text = read_file(argv[1], &size);
+    edn_result_t r = edn_read(text, size);
+    if (r.error != EDN_OK) {
+        die("%s:%zu:%zu: %s", argv[1], r.error_start.line, r.error_start.column,
+            r.error_message);
+    }
+
+    static gen_t g;
+    g.schema_path = argv[1];
+    parse_schema(&g, r.value);
+
+    const char* base = argv[2];
+    size_t base_length = strlen(base);
+    char* header_path = malloc(base_length + 3);
+    char* source_path = malloc(base_length + 3);
+    if (header_path == NULL || source_path == NULL) {
+        die("out of memory");
+    }
+    snprintf(header_path, base_length + 3, "%s.h", base);
+    snprintf(source_path, base_length + 3, "%s.c", base);
+
+    /* The source includes the header by file name; the guard uses it too */
+    const char* header_name = strrchr(header_path, '/');
+    header_name = header_name ? header_name + 1 : header_path;
+    char guard[2 * MAX_NAME + 8];
+    snprintf(guard, sizeof(guard), "EDN_GEN_");
+    size_t n = strlen(guard);
+    for (const char* p = header_name; *p != '\0' && n + 1 < sizeof(guard); p++) {
+        guard[n++] = isalnum((unsigned char) *p) ? (char) toupper((unsigned char) *p) : '_';
+    }
+    guard[n] = '\0';
+
+    open_output(&g, header_path);
+    write_header(&g, guard);
+    close_output(&g, header_path);
+
+    open_output(&g, source_path);
+    write_decoder(&g, header_name);
+    write_encoder(&g);
+    close_output(&g, source_path);
+
+    edn_free(r.value);
+    free(text);
+    free(header_path);
+    free(source_path);
+    return 0;
+}
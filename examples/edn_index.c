@@ -0,0 +1,164 @@
+/**
+ * EDN.C - Sidecar index tool
+ *
+ * Builds and queries the .ednidx offset index of a large multi-form EDN
+ * file (see edn_index_build), so single records can be read without
+ * parsing everything before them.
+ *
+ * Usage:
+ *   edn_index build [--elements] [--key NAME] [--index PATH] FILE
+ *   edn_index count [--index PATH] FILE
+ *   edn_index get [--index PATH] FILE N...     # forms by position (from 0)
+ *   edn_index find [--index PATH] FILE KEY...  # forms by key, KEY as EDN
+ *
+ * Examples:
+ *   edn_index build --key id events.edn        # writes events.edn.ednidx
+ *   edn_index get events.edn 0 1000000
+ *   edn_index find events.edn 42 '"order-7"'
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage:\n"
+            "  %s build [--elements] [--key NAME] [--index PATH] FILE\n"
+            "  %s count [--index PATH] FILE\n"
+            "  %s get [--index PATH] FILE N...\n"
+            "  %s find [--index PATH] FILE KEY...\n"
+            "\n"
+            "  --elements    index the elements of the file's top-level vector\n"
+            "  --key NAME    key map forms by the value of :NAME (e.g. id, user/id)\n"
+            "  --index PATH  index file (default: FILE.ednidx)\n",
+            program, program, program, program);
+}
+
+static const char* error_name(edn_error_t error) {
+    switch (error) {
+        case EDN_ERROR_IO_FAILURE:
+            return "cannot read or write file";
+        case EDN_ERROR_INVALID_STATE:
+            return "index is malformed or out of date (rebuild it)";
+        case EDN_ERROR_OUT_OF_MEMORY:
+            return "out of memory";
+        default:
+            return "error";
+    }
+}
+
+/* Parse and print form `n`; false on error */
+static bool print_form(const edn_index_t* index, const char* path, size_t n) {
+    edn_result_t r = edn_index_get(index, n, NULL);
+    if (r.error != EDN_OK) {
+        fprintf(stderr, "%s:%zu:%zu: %s\n", path, r.error_start.line, r.error_start.column,
+                r.error_message ? r.error_message : error_name(r.error));
+        return false;
+    }
+    bool ok = edn_write_file(r.value, stdout, NULL) == 0;
+    putchar('\n');
+    edn_free(r.value);
+    return ok;
+}
+
+static int build(const char* path, const edn_index_options_t* options) {
+    edn_result_t r = edn_index_build(path, options);
+    if (r.error != EDN_OK) {
+        if (r.error == EDN_ERROR_IO_FAILURE || r.error == EDN_ERROR_INVALID_ARGUMENT) {
+            fprintf(stderr, "%s: %s\n", path, r.error_message);
+        } else {
+            fprintf(stderr, "%s:%zu:%zu: %s\n", path, r.error_start.line,
+                    r.error_start.column, r.error_message);
+        }
+        return 1;
+    }
+    edn_index_t* index = edn_index_open(path, options->index_path, NULL);
+    printf("%zu forms indexed\n", edn_index_count(index));
+    edn_index_close(index);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const char* command = argv[1];
+    edn_index_options_t options = {0};
+    options.struct_size = sizeof(options);
+    int arg = 2;
+    while (arg < argc && strncmp(argv[arg], "--", 2) == 0) {
+        if (strcmp(argv[arg], "--elements") == 0) {
+            options.vector_elements = true;
+            arg++;
+        } else if (strcmp(argv[arg], "--key") == 0 && arg + 1 < argc) {
+            options.key = argv[arg + 1];
+            arg += 2;
+        } else if (strcmp(argv[arg], "--index") == 0 && arg + 1 < argc) {
+            options.index_path = argv[arg + 1];
+            arg += 2;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (arg >= argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    const char* path = argv[arg++];
+
+    if (strcmp(command, "build") == 0) {
+        return arg == argc ? build(path, &options) : (print_usage(argv[0]), 1);
+    }
+
+    edn_error_t error;
+    edn_index_t* index = edn_index_open(path, options.index_path, &error);
+    if (index == NULL) {
+        fprintf(stderr, "%s: %s\n", path, error_name(error));
+        return 1;
+    }
+
+    int status = 0;
+    if (strcmp(command, "count") == 0) {
+        printf("%zu\n", edn_index_count(index));
+    } else if (strcmp(command, "get") == 0) {
+        for (; arg < argc; arg++) {
+            char* end;
+            unsigned long long n = strtoull(argv[arg], &end, 10);
+            if (*end != '\0' || n >= edn_index_count(index)) {
+                fprintf(stderr, "%s: no form %s (%zu forms)\n", path, argv[arg],
+                        edn_index_count(index));
+                status = 1;
+            } else if (!print_form(index, path, (size_t) n)) {
+                status = 1;
+            }
+        }
+    } else if (strcmp(command, "find") == 0) {
+        for (; arg < argc; arg++) {
+            edn_result_t key = edn_read(argv[arg], 0);
+            size_t n;
+            if (key.error != EDN_OK) {
+                fprintf(stderr, "invalid key %s: %s\n", argv[arg], key.error_message);
+                status = 1;
+            } else if (!edn_index_find(index, key.value, &n)) {
+                fprintf(stderr, "%s: no form with key %s\n", path, argv[arg]);
+                status = 1;
+            } else if (!print_form(index, path, n)) {
+                status = 1;
+            }
+            edn_free(key.value);
+        }
+    } else {
+        print_usage(argv[0]);
+        status = 1;
+    }
+
+    edn_index_close(index);
+    return status;
+}
@@ -78,7 +78,11 @@ typedef enum {
     EDN_ERROR_UNSUPPORTED_TYPE,
     EDN_ERROR_INVALID_ARGUMENT,
     EDN_ERROR_IO_FAILURE,
-    EDN_ERROR_INVALID_STATE
+    EDN_ERROR_INVALID_STATE,
+    EDN_ERROR_ABORTED,
+    EDN_ERROR_SCHEMA_MISMATCH,
+    EDN_ERROR_CANCELLED,
+    EDN_ERROR_DEADLINE_EXCEEDED
 } edn_error_t;
 
 typedef struct {
@@ -110,10 +114,62 @@ EDN_API edn_result_t edn_read(const char* input, size_t length);
 /**
  * Free an EDN value and all associated memory.
  *
+ * For documents returned by edn_parse_cache_read this drops one reference
+ * instead; the memory goes once the cache and every reader let go.
+ *
  * @param value Value to free (may be NULL)
  */
 EDN_API void edn_free(edn_value_t* value);
 
+/**
+ * Memory held by a parsed document, summed over its arena blocks.
+ * allocated = used + wasted + available.
+ */
+typedef struct {
+    size_t allocated;    /* Block capacity reserved, large-object blocks included */
+    size_t used;         /* Bytes handed out to values, strings and arrays */
+    size_t wasted;       /* Unused tails of blocks the arena has moved past */
+    size_t available;    /* Room left in the block currently being filled */
+    size_t blocks;       /* Number of blocks, large-object blocks included */
+    size_t large_blocks; /* Dedicated blocks for single large allocations */
+} edn_memory_stats_t;
+
+/* One arena block, as reported by edn_value_memory_blocks */
+typedef struct {
+    size_t allocated; /* Block capacity */
+    size_t used;      /* Bytes handed out from it */
+    size_t wasted;    /* Capacity the arena will no longer use */
+    bool large;       /* Dedicated block for a single large allocation */
+    bool current;     /* The block still being filled */
+} edn_memory_block_t;
+
+/**
+ * Report the memory held by the document that `value` belongs to.
+ *
+ * Every value of a document shares its arena, so any value reports the
+ * whole document. NULL or values without an arena report zeros.
+ *
+ * @param value Any value of the document
+ * @param stats Receives the totals
+ * @return true if the value has an arena, false otherwise
+ */
+EDN_API bool edn_value_memory_usage(const edn_value_t* value, edn_memory_stats_t* stats);
+
+/**
+ * Per-block breakdown of edn_value_memory_usage.
+ *
+ * Fills up to `capacity` entries in allocation order, large-object blocks
+ * last, and returns the total number of blocks (which may exceed
+ * `capacity`; call with capacity 0 to size the array).
+ *
+ * @param value    Any value of the document
+ * @param blocks   Array to fill (may be NULL when capacity is 0)
+ * @param capacity Number of entries in blocks
+ * @return Number of blocks in the document's arena
+ */
+EDN_API size_t edn_value_memory_blocks(const edn_value_t* value, edn_memory_block_t* blocks,
+                                       size_t capacity);
+
 /**
  * Get the type of an EDN value.
  *
@@ -126,7 +182,8 @@ EDN_API edn_type_t edn_type(const edn_value_t* value);
  * Get the source position range of an EDN value.
  *
  * Returns the byte offsets in the original input where this value
- * started and ended.
+ * started and ended. For trees updated by edn_reparse, the offsets are in
+ * the latest input.
  *
  * @param value EDN value
  * @param start Optional output for start byte offset (may be NULL)
@@ -549,13 +606,32 @@ EDN_API edn_value_t* edn_map_get_string_key(const edn_value_t* map, const char*
  * @param tag Output for tag string pointer
  * @param tag_length Optional output for tag length (may be NULL)
  * @param tagged_value Output for the tagged value
- * @return true if value is EDN_TYPE_TAGGED, false otherwise
+ * @return true if value is EDN_TYPE_TAGGED, false otherwise (or if a lazy reader failed)
  *
  * The tag string is the raw symbol name (e.g., "inst", "uuid", "myapp/custom").
+ *
+ * For tags bound with edn_reader_register_lazy(), tagged_value is the reader's
+ * result; the reader runs on first access (see edn_tagged_resolve()).
  */
 EDN_API bool edn_tagged_get(const edn_value_t* value, const char** tag, size_t* tag_length,
                             edn_value_t** tagged_value);
 
+/**
+ * Resolve a lazily-read tagged literal.
+ *
+ * Runs the deferred reader on first call and caches the result (or the
+ * failure) in the value's arena; later calls return the cached outcome.
+ * Values that are not lazy tagged literals are returned unchanged.
+ *
+ * Like lazy string decoding, resolution mutates the value: do not resolve
+ * the same value concurrently from several threads.
+ *
+ * @param value EDN value
+ * @param error_message Optional output for the reader's error message (may be NULL)
+ * @return Reader result, `value` itself if nothing is deferred, or NULL on reader failure
+ */
+EDN_API edn_value_t* edn_tagged_resolve(const edn_value_t* value, const char** error_message);
+
 /**
  * External Value API
  *
@@ -701,7 +777,7 @@ EDN_API void edn_reader_registry_destroy(edn_reader_registry_t* registry);
 /**
  * Register a reader function for a tag.
  *
- * If a reader is already registered for this tag, it will be replaced.
+ * If a reader (or raw reader) is already registered for this tag, it will be replaced.
  *
  * @param registry Reader registry
  * @param tag Tag name (e.g., "inst", "uuid", "myapp/custom")
@@ -728,6 +804,163 @@ EDN_API void edn_reader_unregister(edn_reader_registry_t* registry, const char*
  */
 EDN_API edn_reader_fn edn_reader_lookup(const edn_reader_registry_t* registry, const char* tag);
 
+/**
+ * Raw reader function type.
+ *
+ * Instead of a parsed value, a raw reader receives the source slice of the
+ * form following the tag (leading whitespace, comments and #_ discards
+ * excluded; e.g. `"AAE="` with its quotes, or `[1 2]` with its brackets).
+ * The parser only determines the slice's extent structurally (balanced
+ * delimiters, strings, characters); validating its contents is up to the
+ * reader. No intermediate value is allocated for the form.
+ *
+ * The slice points into the input buffer and is valid as long as the input
+ * is. Allocate the result from `arena`.
+ *
+ * @param source Start of the form in the input
+ * @param length Length of the form in bytes
+ * @param arena Arena allocator for creating new values
+ * @param error_message Output parameter for error message (set on failure)
+ * @return Final value, or NULL on error
+ */
+typedef edn_value_t* (*edn_raw_reader_fn)(const char* source, size_t length, edn_arena_t* arena,
+                                          const char** error_message);
+
+/**
+ * Register a raw reader function for a tag.
+ *
+ * Replaces any reader (raw or not) previously registered for this tag.
+ * edn_reader_lookup() returns NULL for tags bound to a raw reader.
+ * Inside #_ discards, raw readers are not invoked (like regular readers).
+ *
+ * @param registry Reader registry
+ * @param tag Tag name (e.g., "bytes", "myapp/geo")
+ * @param reader Raw reader function
+ * @return true on success, false on allocation failure
+ */
+EDN_API bool edn_reader_register_raw(edn_reader_registry_t* registry, const char* tag,
+                                     edn_raw_reader_fn reader);
+
+/**
+ * Register a lazy reader function for a tag.
+ *
+ * The parser keeps the literal as EDN_TYPE_TAGGED (tag plus parsed inner
+ * value) and defers the reader until the value is accessed through
+ * edn_tagged_resolve() or edn_tagged_get(). Parse latency then excludes the
+ * cost of readers whose values are never read, at the price of reporting
+ * reader errors at access time instead of from edn_read_with_options().
+ *
+ * Equality, hashing and the writer operate on the unresolved literal.
+ * Replaces any reader previously registered for this tag.
+ *
+ * @param registry Reader registry
+ * @param tag Tag name
+ * @param reader Reader function
+ * @return true on success, false on allocation failure
+ */
+EDN_API bool edn_reader_register_lazy(edn_reader_registry_t* registry, const char* tag,
+                                      edn_reader_fn reader);
+
+/**
+ * Built-in readers for the standard #inst and #uuid tags.
+ *
+ * Both produce EDN_TYPE_EXTERNAL values with the reserved type ids below.
+ * Equality, hashing and the writer understand these ids natively; no call to
+ * edn_external_register_type() is needed. User type ids should avoid the
+ * 0xED1A0000-0xED1AFFFF range.
+ */
+#define EDN_EXTERNAL_TYPE_INST 0xED1A0001u
+#define EDN_EXTERNAL_TYPE_UUID 0xED1A0002u
+
+/** Size in bytes of a decoded #uuid. */
+#define EDN_UUID_SIZE 16
+
+/**
+ * Data behind an EDN_EXTERNAL_TYPE_INST value.
+ */
+typedef struct {
+    int64_t epoch_ns;       /* Nanoseconds since 1970-01-01T00:00:00Z */
+    int32_t offset_minutes; /* UTC offset as written in the source (0 for Z) */
+} edn_inst_data_t;
+
+/**
+ * Reader for #inst "RFC3339".
+ *
+ * Accepts YYYY[-MM[-DD[Thh[:mm[:ss[.f{1,9}]]]]]] followed by an optional
+ * Z or (+|-)hh:mm offset. Dates are validated (including leap years) and
+ * must fit in int64 nanoseconds (1677-09-21 .. 2262-04-11).
+ */
+EDN_API edn_value_t* edn_inst_reader(edn_value_t* value, edn_arena_t* arena,
+                                     const char** error_message);
+
+/**
+ * Reader for #uuid "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" (hex, either case).
+ */
+EDN_API edn_value_t* edn_uuid_reader(edn_value_t* value, edn_arena_t* arena,
+                                     const char** error_message);
+
+/**
+ * Register edn_inst_reader and edn_uuid_reader for "inst" and "uuid".
+ *
+ * @param registry Reader registry
+ * @return true on success, false on allocation failure
+ */
+EDN_API bool edn_reader_register_builtins(edn_reader_registry_t* registry);
+
+/**
+ * Get the instant stored in a #inst value.
+ *
+ * @param value Value produced by edn_inst_reader
+ * @param epoch_ns Output for nanoseconds since the Unix epoch, UTC (may be NULL)
+ * @param offset_minutes Output for the original UTC offset (may be NULL)
+ * @return true if value is an #inst external, false otherwise
+ */
+EDN_API bool edn_inst_get(const edn_value_t* value, int64_t* epoch_ns, int32_t* offset_minutes);
+
+/**
+ * Get the 16 bytes of a #uuid value, in string order.
+ *
+ * @param value Value produced by edn_uuid_reader
+ * @param bytes Output buffer of EDN_UUID_SIZE bytes
+ * @return true if value is a #uuid external, false otherwise
+ */
+EDN_API bool edn_uuid_get(const edn_value_t* value, uint8_t bytes[16]);
+
+/**
+ * Cooperative cancellation and time budget, shared by edn_read_with_options
+ * and edn_write_* (one budget can cover both halves of a request).
+ *
+ * The parser and writer look at the budget between the elements of
+ * collections, once every `slice_bytes` bytes of input read or output
+ * written. At each check they stop with EDN_ERROR_CANCELLED when `*cancel`
+ * is non-zero, with EDN_ERROR_DEADLINE_EXCEEDED once edn_monotonic_ns()
+ * reaches `deadline_ns`, and otherwise call `yield`. A single scalar (one
+ * long string, say) is never interrupted.
+ *
+ * `yield` is the hook for time slicing on an event loop: it runs on the
+ * parsing thread, so it can service other work, switch to another fiber or
+ * coroutine, or report progress. Returning non-zero cancels the operation
+ * with EDN_ERROR_CANCELLED.
+ */
+typedef int (*edn_yield_fn)(size_t progress, void* ctx);
+
+typedef struct {
+    const volatile int* cancel; /* Stop once non-zero; may be set from any thread or a
+                                   signal handler (NULL = not cancellable) */
+    uint64_t deadline_ns;       /* edn_monotonic_ns() value to stop at (0 = none) */
+    size_t slice_bytes;         /* Bytes between checks (0 = 64 KB) */
+    edn_yield_fn yield;         /* Called at every check with the input offset or the
+                                   bytes written so far (may be NULL) */
+    void* yield_ctx;
+} edn_budget_t;
+
+/**
+ * Monotonic clock used for budget deadlines, in nanoseconds from an
+ * unspecified starting point. A deadline 50 ms from now is
+ * `edn_monotonic_ns() + 50000000`.
+ */
+EDN_API uint64_t edn_monotonic_ns(void);
+
 /**
  * Default fallback behavior for unregistered tags.
  */
@@ -792,6 +1025,53 @@ typedef struct {
      * with EDN_ERROR_MAX_DEPTH_EXCEEDED if this limit is exceeded.
      */
     size_t max_depth;
+
+    /**
+     * Reject ill-formed UTF-8 (overlong forms, surrogates, truncated
+     * sequences) in strings and identifiers. Strings fail with
+     * EDN_ERROR_INVALID_STRING and identifiers with EDN_ERROR_INVALID_SYNTAX,
+     * positioned at the first bad byte. ASCII-only strings cost nothing
+     * extra: the quote scan notices non-ASCII bytes and only those strings
+     * are validated. Off by default, in which case any bytes are accepted.
+     */
+    bool strict_utf8;
+
+    /**
+     * Arena block sizing. Parsed values are bump-allocated from arena
+     * blocks. By default the first block and the cap on how large later
+     * blocks grow are estimated from the input length, so big documents
+     * need a few dozen blocks rather than thousands. Non-zero values
+     * override the estimate. Allocations larger than a quarter of the
+     * next block get a dedicated block of their own.
+     */
+    size_t arena_initial_block;
+    size_t arena_max_block;
+
+    /**
+     * Back arena blocks of 2 MB and more with huge pages where the platform
+     * supports it: MAP_HUGETLB when huge pages are reserved, otherwise an
+     * anonymous mapping advised with MADV_HUGEPAGE. Blocks fall back to
+     * malloc when mapping fails or is unavailable. Off by default.
+     */
+    bool arena_huge_pages;
+
+    /**
+     * Upper bound on the arena bytes reserved for the parsed tree, as
+     * reported by edn_memory_stats_t.allocated; 0 means no limit. Blocks
+     * are shrunk to fit, and once a value cannot be allocated within the
+     * budget the parse fails with EDN_ERROR_OUT_OF_MEMORY ("Memory limit
+     * exceeded") positioned at the form being built. The limit only
+     * applies while parsing. The parser's temporary child stack is not
+     * counted; it holds one pointer per pending element.
+     */
+    size_t max_memory;
+
+    /**
+     * Optional cancellation flag, deadline and yield hook (see edn_budget_t).
+     * The parse fails with EDN_ERROR_CANCELLED or EDN_ERROR_DEADLINE_EXCEEDED
+     * positioned at the element where it stopped. NULL means unbounded.
+     */
+    const edn_budget_t* budget;
 } edn_parse_options_t;
 
 /**
@@ -805,6 +1085,123 @@ typedef struct {
 EDN_API edn_result_t edn_read_with_options(const char* input, size_t length,
                                            const edn_parse_options_t* options);
 
+/**
+ * Parse-result cache
+ *
+ * An opt-in LRU for services that receive the same payloads again and
+ * again. edn_parse_cache_read hashes the input bytes together with the
+ * parse options that affect the result (reader registry, default reader
+ * mode, max_depth, strict_utf8, max_memory) and returns the cached tree on
+ * a hit, so a repeated payload costs a hash, a lookup and one comparison of
+ * the input bytes instead of a parse. The registry is keyed by its
+ * contents, not only its address: after a reader is registered or
+ * unregistered, documents parsed before the change miss and are parsed
+ * again. Do not change a registry while a read that uses it is running.
+ *
+ * Cached trees are shared, reference-counted and frozen:
+ *   - Each successful edn_parse_cache_read must be matched by edn_free,
+ *     which drops that reference. The tree lives until the last reference
+ *     is dropped, even after eviction or edn_parse_cache_destroy.
+ *   - Before a tree is published, every lazy step (string decoding,
+ *     underscore cleaning, value hashes, lazy readers) is run, so readers
+ *     only read it and may share it across threads. Do not pass a cached
+ *     tree to anything that mutates it, and do not rely on readers running
+ *     once per read: they run on the first parse only.
+ *   - The tree points into the cache's own copy of the input, so the
+ *     caller's buffer may be reused right away.
+ *
+ * Errors and eof_value results are not cached. The cache is split into
+ * shards, each with its own lock and an equal share of max_memory; a
+ * document bigger than a shard's share is returned uncached. Memory is
+ * counted as the tree's arena, whose first block is sized from the input,
+ * plus the input copy. Budgets (edn_parse_options_t.budget) only apply to
+ * misses.
+ */
+typedef struct edn_parse_cache edn_parse_cache_t;
+
+typedef struct {
+    uint64_t hits;       /* Reads served from the cache */
+    uint64_t misses;     /* Reads that parsed */
+    uint64_t evictions;  /* Entries dropped to stay under max_memory */
+    uint64_t uncached;   /* Parsed documents too large to cache */
+    size_t entries;      /* Documents currently cached */
+    size_t memory;       /* Bytes charged for them */
+    size_t max_memory;   /* Cap, summed over shards */
+} edn_parse_cache_stats_t;
+
+/**
+ * Create a parse cache.
+ *
+ * @param max_memory Cap on the bytes held by cached documents
+ * @param shards     Number of independently locked shards (0 = 16)
+ * @return New cache, or NULL on allocation failure
+ */
+EDN_API edn_parse_cache_t* edn_parse_cache_create(size_t max_memory, size_t shards);
+
+/**
+ * Destroy a cache. Trees still referenced by callers stay valid until
+ * their edn_free. Must not run concurrently with other calls on the cache.
+ */
+EDN_API void edn_parse_cache_destroy(edn_parse_cache_t* cache);
+
+/**
+ * Parse through the cache. Same contract as edn_read_with_options, except
+ * that the returned tree may be shared (see above). Safe to call from
+ * several threads at once. A NULL cache parses without caching.
+ */
+EDN_API edn_result_t edn_parse_cache_read(edn_parse_cache_t* cache, const char* input,
+                                          size_t length, const edn_parse_options_t* options);
+
+/* Drop every cached document (outstanding references stay valid) */
+EDN_API void edn_parse_cache_clear(edn_parse_cache_t* cache);
+
+/* Counters summed over all shards; zeros for a NULL cache */
+EDN_API void edn_parse_cache_stats(edn_parse_cache_t* cache, edn_parse_cache_stats_t* stats);
+
+/**
+ * Update a parsed tree after a text edit.
+ *
+ * `new_input` is `old_input` with `removed_len` bytes at `edit_offset`
+ * replaced by `inserted_len` bytes. Instead of parsing all of `new_input`,
+ * edn_reparse finds the innermost collection whose delimiters enclose the
+ * edit, reparses only the children that overlap or touch the edited bytes
+ * and splices them in; every other value is reused as is. If the edit
+ * changes the structure around it (an opened string or comment, an
+ * unbalanced delimiter, a duplicate key), enclosing collections are tried
+ * in turn, and finally a full parse of `new_input`.
+ *
+ * Ownership:
+ *   - On success the old tree is consumed: result.value is usually
+ *     `old_root` itself, updated in place, and is the only tree to free.
+ *     After a full parse, `old_root` has been freed.
+ *   - On error `old_root` is left untouched and still describes
+ *     `old_input`; the error is the one a full parse of `new_input` reports.
+ *   - Reused values still point into the text they were parsed from, so
+ *     every input passed to edn_read_with_options or edn_reparse for this
+ *     tree must outlive it (immutable snapshots, as most editors keep).
+ *
+ * edn_source_position reports offsets in `new_input` for every value; old
+ * values are mapped through the edits lazily. Pass the options the tree
+ * was parsed with. Reader registries and non-passthrough default readers
+ * always take the full parse, as do trees from edn_parse_cache_read. After
+ * many edits, or once replaced values have doubled the tree's arena, the
+ * next edit also parses fully to reclaim memory.
+ *
+ * @param old_root     Tree parsed from old_input (consumed on success)
+ * @param old_input    Text old_root was parsed from, or last reparsed to
+ * @param new_input    Text after the edit
+ * @param new_length   Length of new_input (or 0 to use strlen)
+ * @param edit_offset  Byte offset of the edit (same in both texts)
+ * @param removed_len  Bytes of old_input replaced
+ * @param inserted_len Bytes of new_input that replaced them
+ * @param options      Parse options (or NULL for defaults)
+ * @return Parse result for new_input
+ */
+EDN_API edn_result_t edn_reparse(edn_value_t* old_root, const char* old_input,
+                                 const char* new_input, size_t new_length, size_t edit_offset,
+                                 size_t removed_len, size_t inserted_len,
+                                 const edn_parse_options_t* options);
+
 /**
  * Metadata API (optional, requires EDN_ENABLE_CLOJURE_EXTENSION)
  */
@@ -829,6 +1226,142 @@ EDN_API edn_value_t* edn_value_meta(const edn_value_t* value);
 EDN_API bool edn_value_has_meta(const edn_value_t* value);
 #endif
 
+/**
+ * Parse instrumentation (optional, requires EDN_ENABLE_INSTRUMENTATION)
+ *
+ * Without the flag none of this is compiled and the parser carries no
+ * counters. With it, counting only happens for parses that ask for stats.
+ */
+
+#ifdef EDN_ENABLE_INSTRUMENTATION
+/* Duplicate-check strategies, chosen by element count (see uniqueness.c) */
+typedef enum {
+    EDN_DUPLICATE_TIER_LINEAR, /* Pairwise comparison for small collections */
+    EDN_DUPLICATE_TIER_SORTED, /* Sort, then compare neighbours */
+    EDN_DUPLICATE_TIER_HASH,   /* Open-addressing hash table */
+    EDN_DUPLICATE_TIER_COUNT
+} edn_duplicate_tier_t;
+
+/**
+ * Where a parse spent its effort. Node counts, max_depth and
+ * strings_with_escapes describe the returned tree and are zero when the
+ * parse fails; the other counters are filled in up to the point where the
+ * parse stopped.
+ */
+typedef struct edn_parse_stats {
+    size_t bytes_scanned;                /* Input bytes consumed */
+    size_t nodes[EDN_TYPE_EXTERNAL + 1]; /* Values in the tree, indexed by edn_type_t */
+    size_t max_depth;                    /* Deepest collection nesting (1 for a flat vector) */
+    size_t strings_with_escapes;         /* Strings that need decoding on access */
+    size_t strtod_fallbacks;             /* Floats the fast path handed to strtod */
+    size_t duplicate_checks[EDN_DUPLICATE_TIER_COUNT];   /* Map and set checks per tier */
+    uint64_t duplicate_check_ns[EDN_DUPLICATE_TIER_COUNT]; /* Time spent in them */
+    size_t reader_calls;                 /* Eager and raw reader invocations */
+    size_t arena_blocks;                 /* Arena blocks held by the result */
+    uint64_t parse_ns;                   /* Wall time of the whole call */
+} edn_parse_stats_t;
+
+/**
+ * edn_read_with_options, also filling `stats` (which may be NULL).
+ */
+EDN_API edn_result_t edn_read_with_stats(const char* input, size_t length,
+                                         const edn_parse_options_t* options,
+                                         edn_parse_stats_t* stats);
+
+typedef enum { EDN_TRACE_PARSE_BEGIN, EDN_TRACE_PARSE_END } edn_trace_event_t;
+
+/**
+ * Trace hook, called at the start and end of every edn_read* call.
+ * `result` and `stats` are NULL at EDN_TRACE_PARSE_BEGIN; `stats` is only
+ * non-NULL at the end of edn_read_with_stats calls.
+ */
+typedef void (*edn_trace_fn)(edn_trace_event_t event, const char* input, size_t length,
+                             const edn_result_t* result, const edn_parse_stats_t* stats,
+                             void* ctx);
+
+/**
+ * Install (or with NULL, remove) the process-wide trace hook. Not
+ * synchronized: set it before other threads start parsing.
+ *
+ * Where <sys/sdt.h> is available, the same points are also USDT probes
+ * edn:parse_begin(input, length) and edn:parse_end(input, length, error,
+ * bytes_scanned), usable from bpftrace, perf or SystemTap without a hook.
+ */
+EDN_API void edn_set_trace_hook(edn_trace_fn hook, void* ctx);
+#endif
+
+/* ========================================================================
+ * Tree walker
+ * ========================================================================
+ *
+ * Visits every node of a tree in document order without recursion. The
+ * walker keeps its own stack of open collections (grown on the heap, so
+ * any depth is safe), reads child arrays directly instead of going through
+ * the indexed getters, and prefetches the nodes a few positions ahead of
+ * the one it returns.
+ *
+ *   edn_walk_t* walk = edn_walk_create(root, EDN_WALK_PRE);
+ *   edn_walk_item_t item;
+ *   while (edn_walk_next(walk, &item)) { ... }
+ *   edn_walk_destroy(walk);
+ *
+ * Children are the elements of lists, vectors and sets, the keys and
+ * values of map entries (each key directly before its value), and the form
+ * of a tagged literal as parsed (lazy readers are not run). Metadata
+ * (Clojure extension) is not visited. The tree must not change during the
+ * walk.
+ */
+
+/* Which visits edn_walk_next reports (combine with |) */
+#define EDN_WALK_PRE 1u  /* Collections and tagged literals before their children */
+#define EDN_WALK_POST 2u /* Collections and tagged literals after their children */
+
+typedef struct edn_walk edn_walk_t;
+
+/* One visit */
+typedef struct {
+    const edn_value_t* value;  /* Node visited */
+    const edn_value_t* parent; /* Enclosing collection or tagged literal (NULL for the root) */
+    const edn_value_t* key;    /* Entry key when `value` is a map value, otherwise NULL */
+    size_t depth;              /* 0 for the root, parent's depth + 1 below it */
+    size_t index;              /* Position in `parent`: element, or entry for map keys/values */
+    bool is_key;               /* `value` is a map key */
+    bool post;                 /* Post-order visit (children done); leaves are never post */
+} edn_walk_item_t;
+
+/**
+ * Start a walk at `root`.
+ *
+ * @param root  Tree to walk (NULL walks nothing)
+ * @param order EDN_WALK_PRE, EDN_WALK_POST or both (0 means EDN_WALK_PRE).
+ *              Leaves are reported once either way.
+ * @return Walker, or NULL on allocation failure
+ */
+EDN_API edn_walk_t* edn_walk_create(const edn_value_t* root, unsigned order);
+
+/* Restart the walker on another tree, keeping its order and stack memory */
+EDN_API void edn_walk_reset(edn_walk_t* walk, const edn_value_t* root);
+
+EDN_API void edn_walk_destroy(edn_walk_t* walk);
+
+/**
+ * Report the next visit.
+ *
+ * @return false when the walk is complete, or when the stack could not
+ *         grow (edn_walk_error then reports EDN_ERROR_OUT_OF_MEMORY)
+ */
+EDN_API bool edn_walk_next(edn_walk_t* walk, edn_walk_item_t* item);
+
+/**
+ * Do not descend into the collection or tagged literal just reported by a
+ * pre-order visit. Its post-order visit, if requested, follows next. No
+ * effect after any other visit.
+ */
+EDN_API void edn_walk_skip(edn_walk_t* walk);
+
+/* EDN_OK, or EDN_ERROR_OUT_OF_MEMORY if the walk stopped early */
+EDN_API edn_error_t edn_walk_error(const edn_walk_t* walk);
+
 /* ========================================================================
  * EDN writer (serializer)
  * ======================================================================== */
@@ -862,6 +1395,13 @@ typedef struct edn_writer_registry edn_writer_registry_t;
  *                                   supplementary codepoints pass through as UTF-8)
  *   writer_registry  - NOT IMPLEMENTED (EDN_TYPE_EXTERNAL -> EDN_ERROR_UNSUPPORTED_TYPE)
  *   newline_at_end   - implemented
+ *   budget           - implemented (-EDN_ERROR_CANCELLED or
+ *                      -EDN_ERROR_DEADLINE_EXCEEDED; partial output has been
+ *                      delivered). The streaming emitter checks it before each
+ *                      collection element and is poisoned once it stops.
+ *
+ * `budget` was appended after writer_registry. Callers built against the
+ * older struct may pass its smaller struct_size.
  */
 typedef struct {
     size_t struct_size;
@@ -874,6 +1414,7 @@ typedef struct {
                                                \uXXXX (BMP only) */
     bool newline_at_end;                    /* emit trailing '\n' after value */
     edn_writer_registry_t* writer_registry; /* reserved */
+    const edn_budget_t* budget;             /* cancellation and deadline (NULL = none) */
 } edn_write_options_t;
 
 /**
@@ -973,7 +1514,8 @@ typedef struct edn_emitter edn_emitter_t;
  * @param ctx      Opaque pointer passed back to cb.
  * @param options  Writer options (may be NULL for defaults). Copied; the
  *                 caller's struct lifetime is not the emitter's concern after
- *                 this call returns.
+ *                 this call returns. options->budget is kept by pointer and
+ *                 must outlive the emitter.
  *
  * @return New emitter, or NULL on:
  *         - cb == NULL,
@@ -1027,6 +1569,31 @@ EDN_API int edn_emit_keyword_ns(edn_emitter_t* emitter, const char* ns, const ch
 EDN_API int edn_emit_symbol(edn_emitter_t* emitter, const char* name);
 EDN_API int edn_emit_symbol_ns(edn_emitter_t* emitter, const char* ns, const char* name);
 
+/**
+ * Pre-rendered identifier token for hot emission paths. Validation and
+ * rendering happen once at make time; edn_emit_token then writes the
+ * stored bytes with a single callback. Tokens are immutable and
+ * independent of any emitter, so one token may be shared by many
+ * emitters (and threads).
+ */
+typedef struct edn_emitter_token edn_emitter_token_t;
+
+/**
+ * Make a keyword token (`:name` or `:ns/name`; `ns` may be NULL). Returns
+ * NULL when the name or namespace would be rejected by edn_emit_keyword_ns,
+ * or on allocation failure. Free with edn_emitter_token_free.
+ */
+EDN_API edn_emitter_token_t* edn_emitter_make_keyword(const char* ns, const char* name);
+
+/** Free a token. NULL-safe. */
+EDN_API void edn_emitter_token_free(edn_emitter_token_t* token);
+
+/**
+ * Emit a token. Output and state-machine behavior are identical to the
+ * edn_emit_keyword_ns call the token was made from.
+ */
+EDN_API int edn_emit_token(edn_emitter_t* emitter, const edn_emitter_token_t* token);
+
 /**
  * Emit a character literal. Codepoints > 0x10FFFF and surrogates
  * (0xD800..0xDFFF) return -EDN_ERROR_INVALID_ARGUMENT.
@@ -1098,6 +1665,758 @@ EDN_API int edn_emit_meta(edn_emitter_t* emitter);
  */
 EDN_API int edn_emit_value(edn_emitter_t* emitter, const edn_value_t* value);
 
+/* ========================================================================
+ * EDN event parser
+ * ========================================================================
+ *
+ * SAX-style counterpart of edn_read: the input is tokenized with the same
+ * scanners and validated with the same rules, but instead of building a
+ * value tree each form is reported to a set of callbacks as it is read.
+ * Memory use is O(depth): scalars are scanned into a single scratch block
+ * that is reused for every scalar, and no value outlives its callback. The
+ * block is on the stack; the heap is only used for a scalar too large for it.
+ *
+ * Event order mirrors the streaming emitter:
+ *   - A collection produces on_begin_<kind>, its elements, on_end_<kind>.
+ *     Map elements alternate key, value.
+ *   - `#tag form` produces on_tag followed by the events of `form`. Reader
+ *     functions are never invoked.
+ *   - `^meta form` (Clojure extension) produces on_meta, the events of the
+ *     metadata payload as written (not normalized to a map, not merged with
+ *     stacked metadata), then the events of the form it attaches to.
+ *   - `#:ns{...}` (Clojure extension) is reported as a plain map whose
+ *     keyword/symbol keys already carry the namespace.
+ *   - Discarded forms (`#_`) are validated but produce no events.
+ *
+ * Differences from edn_read: duplicate map keys and set elements are NOT
+ * checked (that would require keeping the elements), and there is no
+ * eof_value fallback.
+ *
+ * Every callback is optional; a NULL callback drops the event. Pointer
+ * arguments are only valid for the duration of the callback. A callback
+ * returning nonzero stops parsing with EDN_ERROR_ABORTED.
+ */
+
+typedef struct {
+    int (*on_nil)(void* ctx);
+    int (*on_bool)(void* ctx, bool value);
+    int (*on_int)(void* ctx, int64_t value);
+    int (*on_double)(void* ctx, double value);
+
+    /* String body, not null-terminated. By default these are the raw bytes
+     * between the quotes with escape sequences intact (what edn_emit_string
+     * expects); with decode_strings set they are the decoded bytes. */
+    int (*on_string)(void* ctx, const char* s, size_t length);
+
+    /* ns is NULL (and ns_length 0) when the identifier has no namespace */
+    int (*on_keyword)(void* ctx, const char* ns, size_t ns_length, const char* name,
+                      size_t name_length);
+    int (*on_symbol)(void* ctx, const char* ns, size_t ns_length, const char* name,
+                     size_t name_length);
+
+    int (*on_character)(void* ctx, uint32_t codepoint);
+
+    /* Digit strings as returned by edn_bigint_get / edn_bigdec_get */
+    int (*on_bigint)(void* ctx, const char* digits, size_t length, bool negative, uint8_t radix);
+    int (*on_bigdec)(void* ctx, const char* digits, size_t length, bool negative);
+
+    /* Clojure extension only; never called otherwise */
+    int (*on_ratio)(void* ctx, int64_t numerator, int64_t denominator);
+    int (*on_bigratio)(void* ctx, const char* numerator, size_t numer_length, bool negative,
+                       const char* denominator, size_t denom_length);
+
+    int (*on_begin_list)(void* ctx);
+    int (*on_end_list)(void* ctx);
+    int (*on_begin_vector)(void* ctx);
+    int (*on_end_vector)(void* ctx);
+    int (*on_begin_set)(void* ctx);
+    int (*on_end_set)(void* ctx);
+    int (*on_begin_map)(void* ctx);
+    int (*on_end_map)(void* ctx);
+
+    /* Tag name without the leading '#'; the next form is the tagged value */
+    int (*on_tag)(void* ctx, const char* tag, size_t length);
+
+    /* Clojure extension only: the next form is a metadata payload */
+    int (*on_meta)(void* ctx);
+
+    /* Resolve string escapes before on_string (uses the scratch block) */
+    bool decode_strings;
+} edn_event_handlers_t;
+
+/**
+ * Parse one EDN form and report it through `handlers`.
+ *
+ * @param input     UTF-8 encoded EDN text
+ * @param length    Length of input in bytes (or 0 to use strlen)
+ * @param handlers  Callback table (required)
+ * @param ctx       Opaque pointer passed to every callback
+ *
+ * @return Result with value always NULL. On failure error, error_message and
+ *         the error positions are filled in exactly as edn_read would;
+ *         events already delivered are not retracted.
+ */
+EDN_API edn_result_t edn_parse_events(const char* input, size_t length,
+                                      const edn_event_handlers_t* handlers, void* ctx);
+
+/**
+ * Handler table that forwards every event to the edn_emitter_t passed as
+ * ctx, so `edn_parse_events(input, len, edn_emitter_event_handlers(), em)`
+ * re-serializes input without building a tree. An emitter failure aborts
+ * parsing (EDN_ERROR_ABORTED). Metadata requires an emitter created with
+ * emit_metadata; string metadata payloads (`^"Type" x`) are rejected by the
+ * emitter like any other non-keyword/symbol/map/vector payload.
+ */
+EDN_API const edn_event_handlers_t* edn_emitter_event_handlers(void);
+
+/* ========================================================================
+ * Schema-directed decoding
+ * ========================================================================
+ *
+ * Decodes an EDN map straight into a caller-defined C struct. A descriptor
+ * lists, for each keyword key, the offset and type of the struct member it
+ * fills. The decoder is driven by the event parser: matched values are
+ * stored as they are scanned, unknown keys and their values are validated
+ * and skipped, and no edn_value_t tree is ever built.
+ *
+ * Field storage:
+ *   EDN_FIELD_BOOL     bool
+ *   EDN_FIELD_INT32    int32_t (out-of-range integers are rejected)
+ *   EDN_FIELD_INT64    int64_t
+ *   EDN_FIELD_DOUBLE   double (integers are converted)
+ *   EDN_FIELD_STRING   char[N]: decoded, null-terminated; must fit in N
+ *   EDN_FIELD_KEYWORD  char[N]: "ns/name" or "name" without the ':'
+ *   EDN_FIELD_STRUCT   nested struct, described by `nested`
+ *   EDN_FIELD_ARRAY    fixed-capacity element array filled from a vector
+ *                      or list; the element count goes to the size_t
+ *                      member at `count_offset`. Elements may be any type
+ *                      except EDN_FIELD_ARRAY.
+ *
+ * Matching rules:
+ *   - Keys are compared against `key` as "ns/name" or "name".
+ *   - Non-keyword keys and keys not in the descriptor are skipped. Skipped
+ *     keys are hashed and a repeat fails as in edn_read (a 64-bit hash
+ *     collision would too, as with check_duplicates); maps inside skipped
+ *     values are not checked.
+ *   - `nil` leaves the member zeroed. Tags are transparent (`#inst "..."`
+ *     fills a string member with the string).
+ *   - Any other type disagreement, a string or array overflowing its
+ *     member, a repeated key, or a missing required field fails with
+ *     EDN_ERROR_SCHEMA_MISMATCH (or EDN_ERROR_DUPLICATE_KEY) at the
+ *     offending form.
+ */
+
+typedef enum {
+    EDN_FIELD_BOOL,
+    EDN_FIELD_INT32,
+    EDN_FIELD_INT64,
+    EDN_FIELD_DOUBLE,
+    EDN_FIELD_STRING,
+    EDN_FIELD_KEYWORD,
+    EDN_FIELD_STRUCT,
+    EDN_FIELD_ARRAY
+} edn_field_type_t;
+
+typedef struct edn_struct_desc edn_struct_desc_t;
+
+typedef struct {
+    const char* key;       /* Keyword without ':', e.g. "id" or "user/id" */
+    edn_field_type_t type; /* Member type */
+    size_t offset;         /* offsetof(struct, member) */
+    size_t size;           /* sizeof(member): buffer size for strings, whole array for arrays */
+    bool required;         /* Fail if the key is absent */
+
+    /* EDN_FIELD_STRUCT, or EDN_FIELD_ARRAY of EDN_FIELD_STRUCT elements */
+    const edn_struct_desc_t* nested;
+
+    /* EDN_FIELD_ARRAY only */
+    edn_field_type_t element_type;
+    size_t element_size; /* sizeof(member[0]) */
+    size_t count_offset; /* offsetof the size_t element count */
+} edn_field_desc_t;
+
+struct edn_struct_desc {
+    const edn_field_desc_t* fields; /* At most 64 fields */
+    size_t field_count;
+    size_t size; /* sizeof(struct) */
+};
+
+/* Descriptor helpers: EDN_FIELD(Point, x, "x", EDN_FIELD_DOUBLE, true) */
+#define EDN_FIELD(type_, member_, key_, field_type_, required_)                                  \
+    {(key_), (field_type_), offsetof(type_, member_), sizeof(((type_*) 0)->member_),              \
+     (required_), NULL, EDN_FIELD_BOOL, 0, 0}
+
+#define EDN_STRUCT_FIELD(type_, member_, key_, desc_, required_)                                 \
+    {(key_), EDN_FIELD_STRUCT, offsetof(type_, member_), sizeof(((type_*) 0)->member_),           \
+     (required_), (desc_), EDN_FIELD_BOOL, 0, 0}
+
+/* `desc_` is the element descriptor for EDN_FIELD_STRUCT elements, else NULL */
+#define EDN_ARRAY_FIELD(type_, member_, count_member_, key_, element_type_, desc_, required_)    \
+    {(key_),                                                                                     \
+     EDN_FIELD_ARRAY,                                                                            \
+     offsetof(type_, member_),                                                                   \
+     sizeof(((type_*) 0)->member_),                                                              \
+     (required_),                                                                                \
+     (desc_),                                                                                    \
+     (element_type_),                                                                            \
+     sizeof(((type_*) 0)->member_[0]),                                                           \
+     offsetof(type_, count_member_)}
+
+/* Opaque compiled decoder */
+typedef struct edn_decoder edn_decoder_t;
+
+/**
+ * Compile a descriptor (and every descriptor nested in it) into a decoder.
+ * Each struct's keys get a collision-free hash table, so a key is matched
+ * with one hash and one compare. The descriptors must outlive the decoder.
+ *
+ * @return Decoder, or NULL if out of memory or the descriptor is invalid
+ *         (more than 64 fields, duplicate or empty keys, missing nested
+ *         descriptor, arrays of arrays, a descriptor cycle, or nesting
+ *         deeper than 32 levels counting arrays).
+ */
+EDN_API edn_decoder_t* edn_decoder_create(const edn_struct_desc_t* desc);
+
+EDN_API void edn_decoder_destroy(edn_decoder_t* decoder);
+
+/**
+ * Decode one EDN map into `out`, which must point to a struct of the
+ * descriptor's size. `out` is zeroed first; on failure it may be partially
+ * filled. A decoder is immutable and may be shared between threads.
+ *
+ * @return Result with value always NULL; errors carry positions like
+ *         edn_read. Syntax errors take precedence as in edn_parse_events.
+ */
+EDN_API edn_result_t edn_decode(const edn_decoder_t* decoder, const char* input, size_t length,
+                                void* out);
+
+/* ========================================================================
+ * Streaming schema validation
+ * ========================================================================
+ *
+ * Checks a document against a spec-like shape while it is being scanned.
+ * Schemas are written in EDN:
+ *
+ *   [:map {:closed true}
+ *    [:user/id [:int {:min 1}]]
+ *    [:name [:string {:max 64}]]
+ *    [:email {:optional true} :string]
+ *    [:roles [:set [:enum :admin :ops :dev]]]
+ *    [:scores [:vector {:max 16} [:maybe :double]]]]
+ *
+ * Types:
+ *   :any :nil :boolean :string :keyword :symbol :char
+ *   :int (fixed or arbitrary precision)  :double  :number (any numeric)
+ *   :map :vector :list :set :sequential (list or vector)   any contents
+ *   [:map props? [key props? spec]...]    keyword keys; entry props
+ *                                         {:optional true}; map props
+ *                                         {:closed true} rejects other keys
+ *   [:map-of props? key-spec value-spec]
+ *   [:vector props? spec], [:list ...], [:set ...], [:sequential ...]
+ *   [:tuple spec...]                      vector with one spec per position
+ *   [:enum value...]                      keywords, strings or integers
+ *   [:maybe spec]                         spec or nil
+ *
+ * {:min n :max n} bounds a number's value, a string's decoded length in
+ * bytes, or a collection's element (or entry) count. Tags are transparent
+ * and metadata is ignored. Map schemas have at most 64 entries and
+ * collection schemas nest at most 64 deep.
+ *
+ * Each map key, map value and collection element is checked as soon as
+ * it has been read, and the scan stops at the first violation; an
+ * element past a :max is rejected before it is scanned. The check runs
+ * either on its own (edn_schema_validate) or while edn_schema_read builds
+ * the tree.
+ */
+
+/* Opaque compiled schema */
+typedef struct edn_schema edn_schema_t;
+
+/**
+ * Compile a schema written in EDN. The schema is immutable and may be
+ * shared between threads.
+ *
+ * @param source        EDN text of the schema
+ * @param length        Length in bytes (or 0 to use strlen)
+ * @param error_message Set to a static description on failure (may be NULL)
+ * @return Schema, or NULL if the text is not valid EDN, the schema is
+ *         malformed, or memory runs out
+ */
+EDN_API edn_schema_t* edn_schema_compile(const char* source, size_t length,
+                                         const char** error_message);
+
+EDN_API void edn_schema_destroy(edn_schema_t* schema);
+
+/**
+ * Check one EDN form against a schema without building a tree.
+ *
+ * On a violation the result carries EDN_ERROR_SCHEMA_MISMATCH (or
+ * EDN_ERROR_DUPLICATE_KEY for a repeated schema key) with positions
+ * covering the offending form, and `path` receives its location as an
+ * EDN vector of keys and indices, e.g. "[:users 3 :age]". For a missing
+ * required key the path ends with that key. Syntax errors are reported as
+ * by edn_parse_events and leave `path` empty.
+ *
+ * @param path      Buffer for the violation path (may be NULL); truncated
+ *                  to fit and always null-terminated when path_size > 0
+ * @param path_size Size of `path` in bytes
+ * @return Result with value always NULL
+ */
+EDN_API edn_result_t edn_schema_validate(const edn_schema_t* schema, const char* input,
+                                         size_t length, char* path, size_t path_size);
+
+/**
+ * Parse one EDN form into a tree, checking it against a schema while the
+ * tree is built. Accepts the same options as edn_read_with_options and
+ * returns the same tree, but the parse stops at the first violation with
+ * the error, positions and `path` edn_schema_validate reports, so a
+ * message that is both checked and used is parsed once.
+ *
+ * Tagged literals are checked on the form their reader receives; a raw
+ * reader's result is checked instead, as its form is never parsed.
+ *
+ * @return Result as edn_read_with_options; free the value with edn_free
+ */
+EDN_API edn_result_t edn_schema_read(const edn_schema_t* schema, const char* input,
+                                     size_t length, const edn_parse_options_t* options,
+                                     char* path, size_t path_size);
+
+/* ========================================================================
+ * Validation-only parsing
+ * ========================================================================
+ *
+ * Checks that input is one well-formed EDN form, applying the same syntax
+ * rules and error reporting as edn_read, without building edn_value_t
+ * nodes. Identifiers, strings and plain decimal numbers are checked in place;
+ * rarer scalars go through the tree scanners one at a time.
+ */
+
+/**
+ * Validation options.
+ *
+ * Same ABI convention as edn_parse_options_t: zero-initialize and set
+ * struct_size to sizeof(edn_validate_options_t).
+ */
+typedef struct {
+    size_t struct_size;
+
+    /**
+     * Reject duplicate map keys and set elements, as edn_read always does.
+     * Duplicates are found by comparing 64-bit hashes that follow
+     * edn_value_equal semantics, so a hash collision between distinct
+     * values would be reported as a duplicate.
+     */
+    bool check_duplicates;
+
+    /* Maximum nesting depth; 0 means the edn_read default (1024) */
+    size_t max_depth;
+
+    /**
+     * Optional caller-owned buffer for the duplicate-check hash stack,
+     * reused across calls. Validation only allocates when it is exhausted
+     * (or absent and a small internal buffer is not enough).
+     */
+    void* scratch;
+    size_t scratch_size;
+
+    /* Reject ill-formed UTF-8, as edn_parse_options_t.strict_utf8 */
+    bool strict_utf8;
+} edn_validate_options_t;
+
+/* Form counts, filled in up to the point where validation stopped */
+typedef struct {
+    size_t forms;       /* Values edn_read would produce, excluding #_ forms */
+    size_t collections; /* Lists, vectors, maps and sets among them */
+    size_t max_depth;   /* Deepest collection nesting (1 for a flat vector) */
+} edn_validate_stats_t;
+
+/**
+ * Validate one EDN form without building a tree.
+ *
+ * Error codes, messages and positions match edn_read, except that
+ * duplicates are only reported when options->check_duplicates is set.
+ *
+ * @param input   UTF-8 encoded EDN text
+ * @param length  Length in bytes (or 0 to use strlen)
+ * @param options Options (or NULL for defaults: no duplicate check)
+ * @param stats   Receives form counts (may be NULL)
+ * @return Result with value always NULL
+ */
+EDN_API edn_result_t edn_validate(const char* input, size_t length,
+                                  const edn_validate_options_t* options,
+                                  edn_validate_stats_t* stats);
+
+/* ========================================================================
+ * Tape documents
+ * ========================================================================
+ *
+ * A flat alternative to the edn_value_t tree for traversal-heavy reads.
+ * edn_tape_read records the document as one contiguous array of 64-bit
+ * words in document order, with string-like payloads in a side buffer:
+ *
+ *   - Every entry is two words: a type in the top byte with a 56-bit
+ *     offset into the side buffer, then a value word holding the integer,
+ *     double bits, codepoint or text length. The fixed width means finding
+ *     the next entry never depends on the current one.
+ *   - A collection's begin entry holds the position just past its end
+ *     entry, which in turn holds the element count, so skipping a subtree
+ *     or counting it never walks the children.
+ *   - `#tag form` is a tag entry followed by the form; `^meta form`
+ *     (Clojure extension) is a meta entry, the payload, then the form.
+ *
+ * The tape is filled from the event parser, so syntax errors and positions
+ * match edn_read. Duplicate map keys and set elements are rejected as
+ * edn_read does, except that strings are compared by their decoded text:
+ * a set holding "\t" and a string with a literal tab is an error here.
+ * Strings are stored decoded and nothing points into the input, which may
+ * be freed once edn_tape_read returns.
+ *
+ * A cursor is a (tape, position) pair passed by value and valid while the
+ * tape lives. Accessors look through metadata, so a cursor on
+ * `^:private [1]` reports a vector; the metadata is only surfaced by
+ * edn_tape_to_value.
+ *
+ *   edn_tape_cursor_t users = edn_tape_root(tape);
+ *   for (edn_tape_cursor_t c = edn_tape_child(users); !edn_tape_at_end(c);
+ *        c = edn_tape_next(c)) { ... }
+ */
+
+/* Opaque tape document */
+typedef struct edn_tape edn_tape_t;
+
+typedef struct {
+    const edn_tape_t* tape;
+    size_t index;
+} edn_tape_cursor_t;
+
+/**
+ * Parse one EDN form into a tape.
+ *
+ * @param input  UTF-8 encoded EDN text
+ * @param length Length in bytes (or 0 to use strlen)
+ * @param out    Receives the tape on success (NULL on failure); free it
+ *               with edn_tape_free
+ * @return Result with value always NULL; errors as edn_parse_events, plus
+ *         EDN_ERROR_DUPLICATE_KEY and EDN_ERROR_DUPLICATE_ELEMENT
+ */
+EDN_API edn_result_t edn_tape_read(const char* input, size_t length, edn_tape_t** out);
+
+EDN_API void edn_tape_free(edn_tape_t* tape);
+
+/* Number of 64-bit words in the tape (two per entry) */
+EDN_API size_t edn_tape_length(const edn_tape_t* tape);
+
+/* Cursor on the top-level form */
+EDN_API edn_tape_cursor_t edn_tape_root(const edn_tape_t* tape);
+
+/**
+ * True when the cursor is past the last element of a collection (or past
+ * the root form). Such a cursor has no type and must not be advanced.
+ */
+EDN_API bool edn_tape_at_end(edn_tape_cursor_t cursor);
+
+/* Type of the form under the cursor (EDN_TYPE_NIL when at the end) */
+EDN_API edn_type_t edn_tape_type(edn_tape_cursor_t cursor);
+
+/* Next sibling, skipping the whole subtree of the current form */
+EDN_API edn_tape_cursor_t edn_tape_next(edn_tape_cursor_t cursor);
+
+/**
+ * First element of a collection (at end when it is empty; map elements
+ * alternate key, value), or the form of a tagged literal. Any other
+ * cursor is returned at the end.
+ */
+EDN_API edn_tape_cursor_t edn_tape_child(edn_tape_cursor_t cursor);
+
+/**
+ * Element count of a list, vector or set, or entry count of a map, in
+ * O(1). Returns 0 for anything else.
+ */
+EDN_API size_t edn_tape_count(edn_tape_cursor_t cursor);
+
+/* Scalar accessors: same contracts as the edn_value_t getters. Returned
+ * pointers are null-terminated and live as long as the tape. */
+EDN_API bool edn_tape_bool_get(edn_tape_cursor_t cursor, bool* out);
+EDN_API bool edn_tape_int64_get(edn_tape_cursor_t cursor, int64_t* out);
+EDN_API bool edn_tape_double_get(edn_tape_cursor_t cursor, double* out);
+EDN_API bool edn_tape_character_get(edn_tape_cursor_t cursor, uint32_t* out);
+EDN_API const char* edn_tape_string_get(edn_tape_cursor_t cursor, size_t* length);
+EDN_API bool edn_tape_keyword_get(edn_tape_cursor_t cursor, const char** ns, size_t* ns_length,
+                                  const char** name, size_t* name_length);
+EDN_API bool edn_tape_symbol_get(edn_tape_cursor_t cursor, const char** ns, size_t* ns_length,
+                                 const char** name, size_t* name_length);
+EDN_API const char* edn_tape_bigint_get(edn_tape_cursor_t cursor, size_t* length, bool* negative,
+                                        uint8_t* radix);
+EDN_API const char* edn_tape_bigdec_get(edn_tape_cursor_t cursor, size_t* length,
+                                        bool* negative);
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+EDN_API bool edn_tape_ratio_get(edn_tape_cursor_t cursor, int64_t* numerator,
+                                int64_t* denominator);
+EDN_API bool edn_tape_bigratio_get(edn_tape_cursor_t cursor, const char** numerator,
+                                   size_t* numer_length, bool* numer_negative,
+                                   const char** denominator, size_t* denom_length);
+#endif
+
+/* Tag name (without '#') of a tagged literal; the form is edn_tape_child */
+EDN_API const char* edn_tape_tag_get(edn_tape_cursor_t cursor, size_t* length);
+
+/* One step of a document-order walk (see edn_tape_iter_next) */
+typedef struct {
+    edn_type_t type;          /* Form type; for end items, the collection closed */
+    bool end;                 /* Closes a list, vector, set or map */
+    edn_tape_cursor_t cursor; /* The form, for the accessors above and edn_tape_to_value */
+    int64_t integer;          /* EDN_TYPE_INT value, EDN_TYPE_BOOL 0/1, character codepoint */
+    double floating;          /* EDN_TYPE_FLOAT value */
+    const char* text;         /* String text, tag name, or keyword/symbol name */
+    size_t length;            /* Length of text */
+    const char* ns;           /* Keyword/symbol namespace (NULL if none) */
+    size_t ns_length;
+} edn_tape_item_t;
+
+/**
+ * Report the next item in document order and advance the cursor: a
+ * scalar, the start of a collection (the cursor then moves to its first
+ * element), the end of a collection, or a tag (its form follows).
+ * Metadata payloads are skipped. Only the fields listed for the item's
+ * type are meaningful; the others hold unspecified values. The walk continues past the cursor's own subtree to the
+ * end of the tape, so callers that start inside a document track depth
+ * with the begin and end items.
+ *
+ * This is the fastest way to visit every form: one call per item, no
+ * re-resolution of the cursor.
+ *
+ * @return false once the tape is exhausted
+ */
+EDN_API bool edn_tape_iter_next(edn_tape_cursor_t* cursor, edn_tape_item_t* item);
+
+/**
+ * Build an edn_value_t tree for the form under the cursor, in a new arena
+ * that the caller releases with edn_free. Tagged literals stay
+ * EDN_TYPE_TAGGED (no readers run) and metadata is merged as edn_read
+ * does.
+ *
+ * @return Value, or NULL when the cursor is at the end or memory runs out
+ */
+EDN_API edn_value_t* edn_tape_to_value(edn_tape_cursor_t cursor);
+
+/* ========================================================================
+ * Sidecar offset index
+ * ========================================================================
+ *
+ * Random access into large files holding many EDN forms (logs, archives,
+ * one huge top-level vector). edn_index_build scans the file once and
+ * writes a sidecar index (by default `path` + ".ednidx") with the byte
+ * offset and length of every top-level form, or of every element of a
+ * single top-level vector. edn_index_open maps both files, and
+ * edn_index_get parses just the requested form.
+ *
+ * With `key` set, every form that is a map with that keyword also records
+ * a hash of the value under it, and the index carries a hash table, so
+ * edn_index_find locates a record by key (e.g. its :id) without scanning.
+ *
+ * Indexing is structural, like raw tagged readers (brackets, strings,
+ * comments and discards are honored, atoms are not checked), unless a key
+ * is requested, in which case each form is parsed. Syntax errors inside a
+ * form may therefore surface only from edn_index_get.
+ *
+ * The index records the data file's size and is refused with
+ * EDN_ERROR_INVALID_STATE once the size changes. It stores integers in
+ * native byte order, so it is not portable across endianness. Offsets
+ * read from it are bounds-checked against the data file.
+ */
+
+/**
+ * Index build options.
+ *
+ * Same ABI convention as edn_parse_options_t: zero-initialize and set
+ * struct_size to sizeof(edn_index_options_t).
+ */
+typedef struct {
+    size_t struct_size;
+
+    /* Index file to write; NULL means `path` + ".ednidx" */
+    const char* index_path;
+
+    /* Index the elements of the file's single top-level vector instead of
+     * its top-level forms */
+    bool vector_elements;
+
+    /* Keyword name (without ':', "ns/name" for namespaced keywords) whose
+     * value keys each map form; NULL builds an index by position only */
+    const char* key;
+} edn_index_options_t;
+
+typedef struct edn_index edn_index_t;
+
+/**
+ * Scan an EDN file and write its sidecar index.
+ *
+ * @param path    EDN file to index
+ * @param options Build options (or NULL: top-level forms, no key)
+ * @return Result with value always NULL. Syntax errors carry positions in
+ *         the data file; unreadable or unwritable files report
+ *         EDN_ERROR_IO_FAILURE.
+ */
+EDN_API edn_result_t edn_index_build(const char* path, const edn_index_options_t* options);
+
+/**
+ * Open an EDN file with its index.
+ *
+ * @param path       EDN file the index was built from
+ * @param index_path Index file, or NULL for `path` + ".ednidx"
+ * @param error      Receives the failure reason (may be NULL):
+ *                   EDN_ERROR_IO_FAILURE, EDN_ERROR_INVALID_STATE for a
+ *                   malformed or stale index, EDN_ERROR_OUT_OF_MEMORY
+ * @return Index handle, or NULL on failure
+ */
+EDN_API edn_index_t* edn_index_open(const char* path, const char* index_path, edn_error_t* error);
+
+/* Unmap both files. Values returned by edn_index_get point into the data
+ * file mapping, so free them first. */
+EDN_API void edn_index_close(edn_index_t* index);
+
+/* Number of indexed forms (0 for NULL) */
+EDN_API size_t edn_index_count(const edn_index_t* index);
+
+/**
+ * Source text of form `n`, without parsing it.
+ *
+ * @return false if `n` is out of range
+ */
+EDN_API bool edn_index_form(const edn_index_t* index, size_t n, const char** text,
+                            size_t* length);
+
+/**
+ * Parse form `n`. Same contract as edn_read_with_options on the form's
+ * text; error positions are in the data file. The tree must be freed
+ * before edn_index_close.
+ *
+ * @return Parse result, or EDN_ERROR_INVALID_ARGUMENT if `n` is out of range
+ */
+EDN_API edn_result_t edn_index_get(const edn_index_t* index, size_t n,
+                                   const edn_parse_options_t* options);
+
+/**
+ * Find the first form whose key value equals `key` (edn_value_equal
+ * semantics, keys as read with default options).
+ *
+ * @param n Receives the form's position for edn_index_get
+ * @return false if no form has that key, or the index was built without one
+ */
+EDN_API bool edn_index_find(const edn_index_t* index, const edn_value_t* key, size_t* n);
+
+/* ========================================================================
+ * Columnar conversion
+ * ========================================================================
+ *
+ * edn_to_columns turns a vector (or list) of maps, such as a batch of
+ * events, into one typed column per keyword key, in a single pass over
+ * the rows: a column's type is inferred from the values under its key as
+ * they are stored. The buffers follow the Apache Arrow columnar layout, so
+ * they can be handed to Arrow-based tools without conversion:
+ *
+ *   EDN_COLUMN_NULL     no buffers: the key only ever holds nil
+ *   EDN_COLUMN_BOOL     `bits`: one bit per row
+ *   EDN_COLUMN_INT64    `int64_values`: one int64_t per row
+ *   EDN_COLUMN_DOUBLE   `double_values`: one double per row (integers
+ *                       are converted)
+ *   EDN_COLUMN_STRING   `offsets` (row count + 1 int32_t) into `data`,
+ *                       holding the decoded UTF-8 text of every row
+ *   EDN_COLUMN_KEYWORD  dictionary encoded: `indices` (one int32_t per
+ *                       row) into a dictionary of distinct keywords, in
+ *                       first-seen order, stored as `offsets` into `data`
+ *                       ("ns/name" or "name", without ':')
+ *
+ * A row without the key, or with nil under it, is null: its bit in
+ * `validity` is 0 and its slots are zeroed. Bitmaps are LSB first, bit
+ * `row % 8` of byte `row / 8`; `validity` is NULL when the column has no
+ * nulls. Columns appear in the order their keys are first seen.
+ *
+ * Rows must be maps. Non-keyword keys are ignored. Tagged values are
+ * replaced by their form as parsed (`#inst "..."` fills a string column).
+ * Any other value type (collections, symbols, characters, big numbers) or
+ * a key mixing incompatible types (say strings and integers) fails with
+ * EDN_ERROR_SCHEMA_MISMATCH, unless the key is left out by
+ * edn_columns_options_t.keys.
+ */
+
+typedef enum {
+    EDN_COLUMN_NULL,
+    EDN_COLUMN_BOOL,
+    EDN_COLUMN_INT64,
+    EDN_COLUMN_DOUBLE,
+    EDN_COLUMN_STRING,
+    EDN_COLUMN_KEYWORD
+} edn_column_type_t;
+
+/* One column; buffers live as long as the edn_columns_t */
+typedef struct {
+    const char* name;        /* Key as "ns/name" or "name", null-terminated */
+    edn_column_type_t type;
+    size_t null_count;       /* Rows without a value */
+    const uint8_t* validity; /* 1 bit per row, set when the row has a value; NULL if no nulls */
+
+    const uint8_t* bits;          /* EDN_COLUMN_BOOL */
+    const int64_t* int64_values;  /* EDN_COLUMN_INT64 */
+    const double* double_values;  /* EDN_COLUMN_DOUBLE */
+    const int32_t* indices;       /* EDN_COLUMN_KEYWORD: dictionary entry per row */
+    size_t dictionary_size;       /* EDN_COLUMN_KEYWORD: distinct keywords */
+    const int32_t* offsets;       /* STRING: row count + 1; KEYWORD: dictionary_size + 1 */
+    const char* data;             /* STRING, KEYWORD: UTF-8 bytes the offsets point into */
+} edn_column_t;
+
+typedef struct edn_columns edn_columns_t;
+
+/**
+ * Conversion options.
+ *
+ * Same ABI convention as edn_parse_options_t: zero-initialize and set
+ * struct_size to sizeof(edn_columns_options_t).
+ */
+typedef struct {
+    size_t struct_size;
+
+    /* Convert only these keys ("name" or "ns/name"), in this order. A key
+     * no row has becomes an EDN_COLUMN_NULL column. NULL converts every
+     * keyword key. */
+    const char* const* keys;
+    size_t key_count;
+} edn_columns_options_t;
+
+/**
+ * Convert a vector or list of maps to columns.
+ *
+ * @param rows    Vector or list of maps
+ * @param options Conversion options (or NULL: every keyword key)
+ * @param out     Receives the columns on success (NULL on failure); free
+ *                them with edn_columns_free
+ * @return Result with value always NULL. EDN_ERROR_SCHEMA_MISMATCH and
+ *         EDN_ERROR_INVALID_ARGUMENT (a row that is not a map) carry the
+ *         offending value's source offsets (see edn_source_position) in
+ *         error_start.offset and error_end.offset; line and column are 0.
+ *         Strings longer in total than INT32_MAX bytes fail with
+ *         EDN_ERROR_OUT_OF_MEMORY.
+ */
+EDN_API edn_result_t edn_to_columns(const edn_value_t* rows, const edn_columns_options_t* options,
+                                    edn_columns_t** out);
+
+EDN_API void edn_columns_free(edn_columns_t* columns);
+
+/* Number of rows (0 for NULL) */
+EDN_API size_t edn_columns_row_count(const edn_columns_t* columns);
+
+/* Number of columns (0 for NULL) */
+EDN_API size_t edn_columns_count(const edn_columns_t* columns);
+
+/* Column `n`, or NULL if out of range */
+EDN_API const edn_column_t* edn_columns_get(const edn_columns_t* columns, size_t n);
+
+/* Column for key `name` ("name" or "ns/name"), or NULL */
+EDN_API const edn_column_t* edn_columns_find(const edn_columns_t* columns, const char* name);
+
+/* True if `row` of `column` has a value */
+EDN_API bool edn_column_is_valid(const edn_column_t* column, size_t row);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,32 +1,202 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* MAP_ANONYMOUS, MAP_HUGETLB and MADV_HUGEPAGE under -std=c11 */
+#endif
+
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "edn_internal.h"
 
-edn_arena_t* edn_arena_create(void) {
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#include <sys/mman.h>
+#define EDN_ARENA_MMAP 1
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+/* Huge-page backed block of at least `bytes` (header included), or NULL */
+static arena_block_t* arena_block_map(size_t bytes) {
+#ifdef EDN_ARENA_MMAP
+    if (bytes > SIZE_MAX - ARENA_HUGE_PAGE_SIZE) {
+        return NULL;
+    }
+    size_t mapped = (bytes + ARENA_HUGE_PAGE_SIZE - 1) & ~(size_t) (ARENA_HUGE_PAGE_SIZE - 1);
+    void* memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    /* Only succeeds when the administrator has reserved huge pages */
+    memory = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                  -1, 0);
+#endif
+    if (memory == MAP_FAILED) {
+        memory = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            return NULL;
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(memory, mapped, MADV_HUGEPAGE); /* Advisory: ignore failure */
+#endif
+    }
+    arena_block_t* block = memory;
+    block->mapped = mapped;
+    block->capacity = mapped - sizeof(arena_block_t);
+    return block;
+#else
+    (void) bytes;
+    return NULL;
+#endif
+}
+
+static arena_block_t* arena_block_new(size_t capacity, bool huge_pages) {
+    if (capacity > SIZE_MAX - sizeof(arena_block_t)) {
+        return NULL;
+    }
+    size_t bytes = sizeof(arena_block_t) + capacity;
+    arena_block_t* block = NULL;
+    if (huge_pages && bytes >= ARENA_HUGE_PAGE_SIZE) {
+        block = arena_block_map(bytes);
+    }
+    if (block == NULL) {
+        block = malloc(bytes);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->mapped = 0;
+        block->capacity = capacity;
+    }
+    block->next = NULL;
+    block->used = 0;
+    return block;
+}
+
+static void arena_block_free(arena_block_t* block) {
+#ifdef EDN_ARENA_MMAP
+    if (block->mapped != 0) {
+        munmap(block, block->mapped);
+        return;
+    }
+#endif
+    free(block);
+}
+
+static void arena_block_free_list(arena_block_t* block) {
+    while (block) {
+        arena_block_t* next = block->next;
+        arena_block_free(block);
+        block = next;
+    }
+}
+
+void edn_arena_config_for_input(edn_arena_config_t* config, size_t input_length) {
+    size_t estimate = input_length > SIZE_MAX / ARENA_INPUT_RATIO ? SIZE_MAX
+                                                                  : input_length * ARENA_INPUT_RATIO;
+
+    config->initial_size = estimate;
+    if (config->initial_size < ARENA_INITIAL_SIZE) {
+        config->initial_size = ARENA_INITIAL_SIZE;
+    } else if (config->initial_size > ARENA_MAX_INITIAL_SIZE) {
+        config->initial_size = ARENA_MAX_INITIAL_SIZE;
+    }
+
+    /* Aim for a few dozen blocks at most, whatever the document size */
+    config->max_block_size = estimate / 16;
+    if (config->max_block_size < ARENA_LARGE_SIZE) {
+        config->max_block_size = ARENA_LARGE_SIZE;
+    } else if (config->max_block_size > ARENA_MAX_BLOCK_SIZE) {
+        config->max_block_size = ARENA_MAX_BLOCK_SIZE;
+    }
+    config->huge_pages = false;
+    config->limit = 0;
+}
+
+edn_arena_t* edn_arena_create_with(const edn_arena_config_t* config) {
+    size_t initial = ARENA_INITIAL_SIZE;
+    size_t max_block = ARENA_LARGE_SIZE;
+    bool huge_pages = false;
+    size_t limit = 0;
+    if (config != NULL) {
+        initial = config->initial_size > 0 ? (config->initial_size + 7) & ~(size_t) 7 : initial;
+        max_block = config->max_block_size > 0 ? config->max_block_size : max_block;
+        huge_pages = config->huge_pages;
+        limit = config->limit;
+    }
+    if (limit > 0 && initial > limit) {
+        initial = limit;
+    }
+
     edn_arena_t* arena = malloc(sizeof(edn_arena_t));
     if (!arena) {
         return NULL;
     }
 
-    /* Start with small block for small documents */
-    arena_block_t* block = malloc(sizeof(arena_block_t) + ARENA_INITIAL_SIZE);
+    arena_block_t* block = arena_block_new(initial, huge_pages);
     if (!block) {
         free(arena);
         return NULL;
     }
 
+    /* Grow to medium on the next block, or keep the first block's size if that is bigger */
+    size_t next = initial > ARENA_MEDIUM_SIZE ? initial : ARENA_MEDIUM_SIZE;
+    if (next > max_block) {
+        next = max_block;
+    }
+
+    arena->current = block;
+    arena->first = block;
+    arena->large = NULL;
+    arena->next_block_size = next;
+    arena->growth_start = next;
+    arena->max_block_size = max_block;
+    if (limit > 0 && block->capacity > limit) {
+        block->capacity = limit; /* Huge-page rounding: leave the excess untouched */
+    }
+    arena->total_allocated = block->capacity;
+    arena->limit = limit;
+    arena->limit_hit = false;
+    arena->huge_pages = huge_pages;
+    arena->cache_entry = NULL;
+    arena->source_edits = NULL;
+    arena->source_epoch = 0;
+    arena->source_edit_capacity = 0;
+    arena->source_baseline = 0;
+
+    return arena;
+}
+
+edn_arena_t* edn_arena_create(void) {
+    return edn_arena_create_with(NULL);
+}
+
+void edn_arena_init_with_buffer(edn_arena_t* arena, void* buffer, size_t size) {
+    arena_block_t* block = buffer;
     block->next = NULL;
     block->used = 0;
-    block->capacity = ARENA_INITIAL_SIZE;
+    block->capacity = size - sizeof(arena_block_t);
+    block->mapped = 0;
 
     arena->current = block;
     arena->first = block;
-    arena->next_block_size = ARENA_MEDIUM_SIZE; /* Grow to medium on next allocation */
-    arena->total_allocated = ARENA_INITIAL_SIZE;
+    arena->large = NULL;
+    arena->next_block_size = ARENA_MEDIUM_SIZE;
+    arena->growth_start = ARENA_MEDIUM_SIZE;
+    arena->max_block_size = ARENA_LARGE_SIZE;
+    arena->total_allocated = block->capacity;
+    arena->limit = 0;
+    arena->limit_hit = false;
+    arena->huge_pages = false;
+    arena->cache_entry = NULL;
+    arena->source_edits = NULL;
+    arena->source_epoch = 0;
+    arena->source_edit_capacity = 0;
+    arena->source_baseline = 0;
+}
 
-    return arena;
+void edn_arena_release(edn_arena_t* arena) {
+    /* The first block and the arena itself belong to the caller */
+    arena_block_free_list(arena->first->next);
+    arena_block_free_list(arena->large);
+    free(arena->source_edits);
 }
 
 void edn_arena_destroy(edn_arena_t* arena) {
@@ -34,47 +204,65 @@ void edn_arena_destroy(edn_arena_t* arena) {
         return;
     }
 
-    arena_block_t* block = arena->first;
-    while (block) {
-        arena_block_t* next = block->next;
-        free(block);
-        block = next;
-    }
-
+    arena_block_free_list(arena->first);
+    arena_block_free_list(arena->large);
+    free(arena->source_edits);
     free(arena);
 }
 
 static void* edn_arena_alloc_slow(edn_arena_t* arena, size_t size) {
-    arena_block_t* block = arena->current;
+    size_t remaining = SIZE_MAX;
+    if (arena->limit > 0) {
+        remaining = arena->limit > arena->total_allocated ? arena->limit - arena->total_allocated
+                                                          : 0;
+        if (size > remaining) {
+            arena->limit_hit = true;
+            return NULL;
+        }
+    }
 
-    /* Use adaptive block size - either the next planned size or the requested size (whichever is larger) */
-    size_t block_size = (size > arena->next_block_size) ? size : arena->next_block_size;
+    /* Large allocations get a dedicated block on a side list, so the current
+     * block keeps serving small allocations instead of being retired with
+     * its tail unused. */
+    if (size > arena->next_block_size / 4) {
+        arena_block_t* large = arena_block_new(size, arena->huge_pages);
+        if (!large) {
+            return NULL;
+        }
+        if (large->capacity > remaining) {
+            large->capacity = remaining;
+        }
+        large->used = size;
+        large->next = arena->large;
+        arena->large = large;
+        arena->total_allocated += large->capacity;
+        return large->data;
+    }
 
-    arena_block_t* new_block = malloc(sizeof(arena_block_t) + block_size);
+    size_t block_size = arena->next_block_size < remaining ? arena->next_block_size : remaining;
+    arena_block_t* new_block = arena_block_new(block_size, arena->huge_pages);
     if (!new_block) {
         return NULL;
     }
+    if (new_block->capacity > remaining) {
+        new_block->capacity = remaining;
+    }
 
-    new_block->next = NULL;
-    new_block->used = 0;
-    new_block->capacity = block_size;
-
-    block->next = new_block;
+    arena->current->next = new_block;
     arena->current = new_block;
-    block = new_block;
 
-    /* Adaptive growth: double size up to LARGE limit */
-    if (arena->next_block_size < ARENA_LARGE_SIZE) {
+    /* Adaptive growth: double size up to the cap */
+    if (arena->next_block_size < arena->max_block_size) {
         arena->next_block_size *= 2;
-        if (arena->next_block_size > ARENA_LARGE_SIZE) {
-            arena->next_block_size = ARENA_LARGE_SIZE;
+        if (arena->next_block_size > arena->max_block_size) {
+            arena->next_block_size = arena->max_block_size;
         }
     }
 
-    arena->total_allocated += block_size;
+    arena->total_allocated += new_block->capacity;
 
-    void* ptr = block->data + block->used;
-    block->used += size;
+    void* ptr = new_block->data;
+    new_block->used = size;
 
     return ptr;
 }
@@ -106,3 +294,82 @@ void* edn_arena_alloc(edn_arena_t* arena, size_t size) {
 
     return edn_arena_alloc_slow(arena, size);
 }
+
+void edn_arena_reset(edn_arena_t* arena) {
+    if (!arena) {
+        return;
+    }
+
+    /* Keep the first block, release the rest */
+    arena_block_free_list(arena->first->next);
+    arena_block_free_list(arena->large);
+
+    arena->first->next = NULL;
+    arena->first->used = 0;
+    arena->current = arena->first;
+    arena->large = NULL;
+    arena->next_block_size = arena->growth_start;
+    arena->total_allocated = arena->first->capacity;
+    arena->limit_hit = false;
+    arena->source_epoch = 0; /* Offsets of new values start from scratch */
+    arena->source_baseline = 0;
+}
+
+/* ========================================================================
+ * Memory accounting
+ * ======================================================================== */
+
+static void describe_block(const edn_arena_t* arena, const arena_block_t* block, bool large,
+                           edn_memory_block_t* out) {
+    out->allocated = block->capacity;
+    out->used = block->used;
+    out->large = large;
+    out->current = !large && block == arena->current;
+    out->wasted = out->current ? 0 : block->capacity - block->used;
+}
+
+bool edn_value_memory_usage(const edn_value_t* value, edn_memory_stats_t* stats) {
+    if (stats == NULL) {
+        return false;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (value == NULL || value->arena == NULL) {
+        return false;
+    }
+
+    const edn_arena_t* arena = value->arena;
+    for (int large = 0; large < 2; large++) {
+        const arena_block_t* block = large ? arena->large : arena->first;
+        for (; block != NULL; block = block->next) {
+            edn_memory_block_t b;
+            describe_block(arena, block, large, &b);
+            stats->allocated += b.allocated;
+            stats->used += b.used;
+            stats->wasted += b.wasted;
+            stats->available += b.current ? b.allocated - b.used : 0;
+            stats->blocks++;
+            stats->large_blocks += large;
+        }
+    }
+    return true;
+}
+
+size_t edn_value_memory_blocks(const edn_value_t* value, edn_memory_block_t* blocks,
+                               size_t capacity) {
+    if (value == NULL || value->arena == NULL) {
+        return 0;
+    }
+
+    const edn_arena_t* arena = value->arena;
+    size_t count = 0;
+    for (int large = 0; large < 2; large++) {
+        const arena_block_t* block = large ? arena->large : arena->first;
+        for (; block != NULL; block = block->next) {
+            if (blocks != NULL && count < capacity) {
+                describe_block(arena, block, large, &blocks[count]);
+            }
+            count++;
+        }
+    }
+    return count;
+}
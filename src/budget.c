@@ -0,0 +1,80 @@
+/**
+ * EDN.C - Cancellation and deadlines
+ *
+ * Monotonic clock and the budget checks shared by the parser and the
+ * writer. Callers keep their own checkpoint (an input pointer or an output
+ * byte count) so the common case between checks is a single compare.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L /* clock_gettime under -std=c11 */
+#endif
+
+#include "edn_internal.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+uint64_t edn_monotonic_ns(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t) ((double) counter.QuadPart * 1e9 / (double) freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+/* The flag may be written by another thread: read it atomically where the
+ * compiler lets us, so the load is neither torn nor hoisted. */
+static int load_cancel_flag(const volatile int* flag) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(flag, __ATOMIC_RELAXED);
+#else
+    return *flag;
+#endif
+}
+
+size_t edn_budget_slice(const edn_budget_t* budget) {
+    return budget->slice_bytes > 0 ? budget->slice_bytes : EDN_DEFAULT_BUDGET_SLICE;
+}
+
+edn_error_t edn_budget_poll(const edn_budget_t* budget, size_t progress) {
+    if (budget->cancel != NULL && load_cancel_flag(budget->cancel) != 0) {
+        return EDN_ERROR_CANCELLED;
+    }
+    if (budget->deadline_ns != 0 && edn_monotonic_ns() >= budget->deadline_ns) {
+        return EDN_ERROR_DEADLINE_EXCEEDED;
+    }
+    if (budget->yield != NULL && budget->yield(progress, budget->yield_ctx) != 0) {
+        return EDN_ERROR_CANCELLED;
+    }
+    return EDN_OK;
+}
+
+bool edn_budget_check(edn_parser_t* parser) {
+    if (parser->budget == NULL) {
+        parser->budget_checkpoint = parser->end;
+        return true;
+    }
+
+    edn_error_t error = edn_budget_poll(parser->budget, (size_t) (parser->current - parser->input));
+    if (error != EDN_OK) {
+        edn_parser_set_error(parser, error,
+                             error == EDN_ERROR_CANCELLED ? "Parse cancelled"
+                                                          : "Parse deadline exceeded",
+                             parser->current, parser->current);
+        return false;
+    }
+
+    size_t slice = edn_budget_slice(parser->budget);
+    size_t remaining = (size_t) (parser->end - parser->current);
+    parser->budget_checkpoint = slice < remaining ? parser->current + slice : parser->end;
+    return true;
+}
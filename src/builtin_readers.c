@@ -0,0 +1,522 @@
+/**
+ * EDN.C - Built-in #inst and #uuid readers
+ *
+ * Native readers for the two tags defined by the EDN specification:
+ *   - #inst "RFC3339"  → int64 epoch nanoseconds (UTC) plus the original offset
+ *   - #uuid "8-4-4-4-12" → 16 raw bytes
+ *
+ * Both produce EDN_TYPE_EXTERNAL values with reserved type ids
+ * (EDN_EXTERNAL_TYPE_INST / EDN_EXTERNAL_TYPE_UUID), so equality, hashing and
+ * the writer handle them without any global registration.
+ *
+ * Performance optimizations:
+ * - Reads the zero-copy string payload directly (no null-terminated copy)
+ * - SWAR digit kernels: validates the fixed-width "YYYY-MM-DDTHH:MM:SS" head
+ *   with two 64-bit word checks and converts 2/4/8-digit groups in-register
+ * - SWAR hex kernel: validates and decodes 8 hex characters (4 UUID bytes)
+ *   per 64-bit word, no per-character branching
+ *
+ * Like the SWAR integer path in number.c, word loads assume a little-endian
+ * host (x86_64, ARM64, WebAssembly).
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "edn_internal.h"
+
+#define NS_PER_SECOND 1000000000LL
+#define SECONDS_PER_DAY 86400LL
+
+/* Broadcast a byte to every lane of a 64-bit word. */
+#define SWAR_BCAST(b) (0x0101010101010101ULL * (uint64_t) (b))
+
+static inline uint64_t load_u64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+/**
+ * Per-lane flag (0x80) for bytes strictly between lo and hi.
+ * Classic "hasbetween" bit trick; valid for 0 <= lo, hi <= 128.
+ * Bytes >= 0x80 never match.
+ */
+static inline uint64_t swar_between(uint64_t x, unsigned lo, unsigned hi) {
+    const uint64_t low7 = SWAR_BCAST(0x7F);
+    uint64_t t = x & low7;
+    return ((SWAR_BCAST(127 + hi) - t) & ~x & (t + SWAR_BCAST(127 - lo))) & SWAR_BCAST(0x80);
+}
+
+/**
+ * Check that every lane selected by `digit_lanes` (0xFF per lane) holds an
+ * ASCII digit, and every other lane matches the same lane of `literal`.
+ */
+static inline bool swar_match_pattern(uint64_t word, uint64_t digit_lanes, uint64_t literal) {
+    uint64_t digits = swar_between(word, '0' - 1, '9' + 1);
+    if ((digits & digit_lanes) != (SWAR_BCAST(0x80) & digit_lanes)) {
+        return false;
+    }
+    return (word & ~digit_lanes) == (literal & ~digit_lanes);
+}
+
+/* Two ASCII digits at p (already validated) → 0..99. */
+static inline int parse_two_digits(const char* p) {
+    return (p[0] - '0') * 10 + (p[1] - '0');
+}
+
+/* Four ASCII digits at p (already validated) → 0..9999, combined in-register. */
+static inline int parse_four_digits(const char* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    v = (v & 0x0F0F0F0F) * 2561 >> 8;
+    v = (v & 0x00FF00FF) * 6553601 >> 16;
+    return (int) (v & 0xFFFF);
+}
+
+static inline bool is_ascii_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool all_digits(const char* p, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (!is_ascii_digit(p[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline bool is_leap_year(int64_t y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static int days_in_month(int64_t year, int month) {
+    static const uint8_t DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month == 2 && is_leap_year(year)) {
+        return 29;
+    }
+    return DAYS[month - 1];
+}
+
+/**
+ * Days since 1970-01-01 for a proleptic Gregorian date.
+ * Howard Hinnant's days_from_civil (branch-light, exact for all int64 years
+ * the caller can produce from four digits).
+ */
+static int64_t days_from_civil(int64_t y, int m, int d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/* Inverse of days_from_civil. */
+static void civil_from_days(int64_t z, int64_t* y, int* m, int* d) {
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    *d = (int) (doy - (153 * mp + 2) / 5 + 1);
+    *m = (int) (mp < 10 ? mp + 3 : mp - 9);
+    *y = yoe + era * 400 + (*m <= 2);
+}
+
+/**
+ * Parse an RFC3339 timestamp as accepted by Clojure's #inst reader:
+ *
+ *   YYYY[-MM[-DD[Thh[:mm[:ss[.fffffffff]]]]]][Z|(+|-)hh:mm]
+ *
+ * Missing fields default to their minimum (month/day = 1, time = 0).
+ * Returns NULL on success, or a static error message.
+ */
+const char* edn_inst_parse(const char* s, size_t len, int64_t* out_epoch_ns,
+                           int32_t* out_offset_minutes) {
+    int64_t year;
+    int month = 1, day = 1, hour = 0, minute = 0, second = 0;
+    int64_t nanos = 0;
+    int32_t offset = 0;
+    size_t pos;
+
+    /* Fast path: full "YYYY-MM-DDTHH:MM:SS" head validated as two words
+     * ("YYYY-MM-" and "DDTHH:MM") plus ":SS". */
+    if (len >= 19 &&
+        swar_match_pattern(load_u64(s), 0x00FFFF00FFFFFFFFULL, load_u64("0000-00-")) &&
+        swar_match_pattern(load_u64(s + 8), 0xFFFF00FFFF00FFFFULL, load_u64("00T00:00")) &&
+        s[16] == ':' && is_ascii_digit(s[17]) && is_ascii_digit(s[18])) {
+        year = parse_four_digits(s);
+        month = parse_two_digits(s + 5);
+        day = parse_two_digits(s + 8);
+        hour = parse_two_digits(s + 11);
+        minute = parse_two_digits(s + 14);
+        second = parse_two_digits(s + 17);
+        pos = 19;
+    } else {
+        /* Truncated forms: each component is optional once the year is present. */
+        if (len < 4 || !all_digits(s, 4)) {
+            return "#inst requires an RFC3339 timestamp (YYYY-MM-DDThh:mm:ss)";
+        }
+        year = parse_four_digits(s);
+        pos = 4;
+        if (pos < len && s[pos] == '-') {
+            if (pos + 3 > len || !all_digits(s + pos + 1, 2)) {
+                return "#inst has invalid month";
+            }
+            month = parse_two_digits(s + pos + 1);
+            pos += 3;
+            if (pos < len && s[pos] == '-') {
+                if (pos + 3 > len || !all_digits(s + pos + 1, 2)) {
+                    return "#inst has invalid day";
+                }
+                day = parse_two_digits(s + pos + 1);
+                pos += 3;
+                if (pos < len && s[pos] == 'T') {
+                    if (pos + 3 > len || !all_digits(s + pos + 1, 2)) {
+                        return "#inst has invalid hour";
+                    }
+                    hour = parse_two_digits(s + pos + 1);
+                    pos += 3;
+                    if (pos < len && s[pos] == ':') {
+                        if (pos + 3 > len || !all_digits(s + pos + 1, 2)) {
+                            return "#inst has invalid minute";
+                        }
+                        minute = parse_two_digits(s + pos + 1);
+                        pos += 3;
+                        if (pos < len && s[pos] == ':') {
+                            if (pos + 3 > len || !all_digits(s + pos + 1, 2)) {
+                                return "#inst has invalid second";
+                            }
+                            second = parse_two_digits(s + pos + 1);
+                            pos += 3;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* Fractional seconds: 1-9 digits, scaled to nanoseconds. */
+    if (pos < len && s[pos] == '.') {
+        pos++;
+        size_t frac_start = pos;
+        while (pos < len && is_ascii_digit(s[pos])) {
+            pos++;
+        }
+        size_t frac_len = pos - frac_start;
+        if (frac_len == 0 || frac_len > 9) {
+            return "#inst fractional seconds must have 1 to 9 digits";
+        }
+        char frac[9];
+        memset(frac, '0', sizeof(frac));
+        memcpy(frac, s + frac_start, frac_len);
+        /* Eight digits in one SWAR step, the ninth as a scalar tail. */
+        uint64_t v = load_u64(frac);
+        v = (v & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+        v = (v & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+        v = (v & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32;
+        nanos = (int64_t) (uint32_t) v * 10 + (frac[8] - '0');
+    }
+
+    /* Offset: Z, or +hh:mm / -hh:mm. Absent offset means UTC. */
+    if (pos < len) {
+        if (s[pos] == 'Z' || s[pos] == 'z') {
+            pos++;
+        } else if (s[pos] == '+' || s[pos] == '-') {
+            if (pos + 6 > len || !all_digits(s + pos + 1, 2) || s[pos + 3] != ':' ||
+                !all_digits(s + pos + 4, 2)) {
+                return "#inst has invalid UTC offset (expected +hh:mm or -hh:mm)";
+            }
+            int oh = parse_two_digits(s + pos + 1);
+            int om = parse_two_digits(s + pos + 4);
+            if (oh > 23 || om > 59) {
+                return "#inst UTC offset out of range";
+            }
+            offset = (int32_t) (oh * 60 + om);
+            if (s[pos] == '-') {
+                offset = -offset;
+            }
+            pos += 6;
+        }
+    }
+
+    if (pos != len) {
+        return "#inst has trailing characters after timestamp";
+    }
+
+    if (month < 1 || month > 12) {
+        return "#inst month out of range";
+    }
+    if (day < 1 || day > days_in_month(year, month)) {
+        return "#inst day out of range";
+    }
+    if (hour > 23 || minute > 59 || second > 59) {
+        return "#inst time of day out of range";
+    }
+
+    int64_t seconds = days_from_civil(year, month, day) * SECONDS_PER_DAY + hour * 3600LL +
+                      minute * 60LL + second - (int64_t) offset * 60LL;
+
+    /* int64 nanoseconds span 1677-09-21 .. 2262-04-11. */
+    if (seconds > (INT64_MAX - nanos) / NS_PER_SECOND || seconds < INT64_MIN / NS_PER_SECOND) {
+        return "#inst out of range for int64 epoch nanoseconds";
+    }
+
+    *out_epoch_ns = seconds * NS_PER_SECOND + nanos;
+    *out_offset_minutes = offset;
+    return NULL;
+}
+
+/**
+ * Format an instant as RFC3339 in its original offset.
+ * Fraction is omitted when zero, 3 digits when millisecond-aligned, else 9.
+ * Returns the number of bytes written (at most EDN_INST_FORMAT_MAX).
+ */
+size_t edn_inst_format(int64_t epoch_ns, int32_t offset_minutes, char* buf) {
+    /* Floor division so pre-epoch instants format correctly. */
+    int64_t local_ns_secs = epoch_ns / NS_PER_SECOND;
+    int64_t nanos = epoch_ns % NS_PER_SECOND;
+    if (nanos < 0) {
+        nanos += NS_PER_SECOND;
+        local_ns_secs--;
+    }
+    int64_t secs = local_ns_secs + (int64_t) offset_minutes * 60;
+    int64_t days = secs / SECONDS_PER_DAY;
+    int64_t sod = secs % SECONDS_PER_DAY;
+    if (sod < 0) {
+        sod += SECONDS_PER_DAY;
+        days--;
+    }
+
+    int64_t year;
+    int month, day;
+    civil_from_days(days, &year, &month, &day);
+
+    char* p = buf;
+    int64_t y = year < 0 ? 0 : (year > 9999 ? 9999 : year);
+    *p++ = (char) ('0' + y / 1000);
+    *p++ = (char) ('0' + y / 100 % 10);
+    *p++ = (char) ('0' + y / 10 % 10);
+    *p++ = (char) ('0' + y % 10);
+    *p++ = '-';
+    *p++ = (char) ('0' + month / 10);
+    *p++ = (char) ('0' + month % 10);
+    *p++ = '-';
+    *p++ = (char) ('0' + day / 10);
+    *p++ = (char) ('0' + day % 10);
+    *p++ = 'T';
+    int hh = (int) (sod / 3600), mm = (int) (sod / 60 % 60), ss = (int) (sod % 60);
+    *p++ = (char) ('0' + hh / 10);
+    *p++ = (char) ('0' + hh % 10);
+    *p++ = ':';
+    *p++ = (char) ('0' + mm / 10);
+    *p++ = (char) ('0' + mm % 10);
+    *p++ = ':';
+    *p++ = (char) ('0' + ss / 10);
+    *p++ = (char) ('0' + ss % 10);
+
+    if (nanos != 0) {
+        int digits = (nanos % 1000000 == 0) ? 3 : 9;
+        int64_t frac = digits == 3 ? nanos / 1000000 : nanos;
+        *p++ = '.';
+        for (int i = digits - 1; i >= 0; i--) {
+            p[i] = (char) ('0' + frac % 10);
+            frac /= 10;
+        }
+        p += digits;
+    }
+
+    if (offset_minutes == 0) {
+        *p++ = 'Z';
+    } else {
+        int32_t off = offset_minutes;
+        *p++ = off < 0 ? '-' : '+';
+        if (off < 0) {
+            off = -off;
+        }
+        *p++ = (char) ('0' + off / 60 / 10);
+        *p++ = (char) ('0' + off / 60 % 10);
+        *p++ = ':';
+        *p++ = (char) ('0' + off % 60 / 10);
+        *p++ = (char) ('0' + off % 60 % 10);
+    }
+
+    return (size_t) (p - buf);
+}
+
+/**
+ * SWAR hex kernel: validate 8 ASCII hex characters and decode them into
+ * 4 bytes written in string order. Returns false on any non-hex byte.
+ */
+static inline bool decode_hex8(const char* p, uint8_t* out) {
+    uint64_t x = load_u64(p);
+    uint64_t lower = x | SWAR_BCAST(0x20); /* 'A'-'F' → 'a'-'f'; digits unchanged */
+    uint64_t valid = swar_between(x, '0' - 1, '9' + 1) | swar_between(lower, 'a' - 1, 'f' + 1);
+    if (valid != SWAR_BCAST(0x80)) {
+        return false;
+    }
+
+    /* Nibble per lane: low four bits, plus 9 for letters (bit 6 set). */
+    uint64_t nib = (x & SWAR_BCAST(0x0F)) + ((x >> 6) & SWAR_BCAST(0x01)) * 9;
+
+    /* Pair lanes: even lane is the high nibble, odd lane the low nibble. */
+    uint64_t bytes = ((nib & 0x000F000F000F000FULL) << 4) | ((nib >> 8) & 0x000F000F000F000FULL);
+    bytes = (bytes | (bytes >> 8)) & 0x0000FFFF0000FFFFULL;
+    bytes = (bytes | (bytes >> 16)) & 0x00000000FFFFFFFFULL;
+
+    uint32_t packed = (uint32_t) bytes;
+    memcpy(out, &packed, 4);
+    return true;
+}
+
+/* Decode 4 hex characters (one UUID group) into 2 bytes. */
+static inline bool decode_hex4(const char* p, uint8_t* out) {
+    char buf[8];
+    memcpy(buf, p, 4);
+    memcpy(buf + 4, "0000", 4);
+    uint8_t tmp[4];
+    if (!decode_hex8(buf, tmp)) {
+        return false;
+    }
+    out[0] = tmp[0];
+    out[1] = tmp[1];
+    return true;
+}
+
+/**
+ * Parse the canonical 36-character UUID form (8-4-4-4-12, either case).
+ * Returns NULL on success, or a static error message.
+ */
+const char* edn_uuid_parse(const char* s, size_t len, uint8_t out[16]) {
+    if (len != 36 || s[8] != '-' || s[13] != '-' || s[18] != '-' || s[23] != '-') {
+        return "#uuid requires a 36-character 8-4-4-4-12 hex string";
+    }
+    if (!decode_hex8(s, out) || !decode_hex4(s + 9, out + 4) || !decode_hex4(s + 14, out + 6) ||
+        !decode_hex4(s + 19, out + 8) || !decode_hex4(s + 24, out + 10) ||
+        !decode_hex8(s + 28, out + 12)) {
+        return "#uuid contains a non-hex character";
+    }
+    return NULL;
+}
+
+size_t edn_uuid_format(const uint8_t bytes[16], char* buf) {
+    static const char HEX[] = "0123456789abcdef";
+    char* p = buf;
+    for (int i = 0; i < 16; i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            *p++ = '-';
+        }
+        *p++ = HEX[bytes[i] >> 4];
+        *p++ = HEX[bytes[i] & 0x0F];
+    }
+    return (size_t) (p - buf);
+}
+
+/**
+ * Fetch the payload of a string value without forcing a null-terminated
+ * copy: raw input bytes when there are no escapes, decoded otherwise.
+ */
+static const char* string_payload(edn_value_t* value, size_t* length) {
+    if (!edn_string_has_escapes(value)) {
+        *length = edn_string_get_length(value);
+        return value->as.string.data;
+    }
+    return edn_string_get(value, length);
+}
+
+edn_value_t* edn_inst_reader(edn_value_t* value, edn_arena_t* arena, const char** error_message) {
+    if (value == NULL || value->type != EDN_TYPE_STRING) {
+        *error_message = "#inst requires a string";
+        return NULL;
+    }
+
+    size_t len;
+    const char* s = string_payload(value, &len);
+    if (s == NULL) {
+        *error_message = "#inst has an invalid string escape";
+        return NULL;
+    }
+
+    edn_inst_data_t* inst = edn_arena_alloc(arena, sizeof(edn_inst_data_t));
+    if (inst == NULL) {
+        *error_message = "Out of memory allocating #inst";
+        return NULL;
+    }
+
+    const char* err = edn_inst_parse(s, len, &inst->epoch_ns, &inst->offset_minutes);
+    if (err != NULL) {
+        *error_message = err;
+        return NULL;
+    }
+
+    edn_value_t* result = edn_external_create(arena, inst, EDN_EXTERNAL_TYPE_INST);
+    if (result == NULL) {
+        *error_message = "Out of memory allocating #inst";
+    }
+    return result;
+}
+
+edn_value_t* edn_uuid_reader(edn_value_t* value, edn_arena_t* arena, const char** error_message) {
+    if (value == NULL || value->type != EDN_TYPE_STRING) {
+        *error_message = "#uuid requires a string";
+        return NULL;
+    }
+
+    size_t len;
+    const char* s = string_payload(value, &len);
+    if (s == NULL) {
+        *error_message = "#uuid has an invalid string escape";
+        return NULL;
+    }
+
+    uint8_t* bytes = edn_arena_alloc(arena, EDN_UUID_SIZE);
+    if (bytes == NULL) {
+        *error_message = "Out of memory allocating #uuid";
+        return NULL;
+    }
+
+    const char* err = edn_uuid_parse(s, len, bytes);
+    if (err != NULL) {
+        *error_message = err;
+        return NULL;
+    }
+
+    edn_value_t* result = edn_external_create(arena, bytes, EDN_EXTERNAL_TYPE_UUID);
+    if (result == NULL) {
+        *error_message = "Out of memory allocating #uuid";
+    }
+    return result;
+}
+
+bool edn_reader_register_builtins(edn_reader_registry_t* registry) {
+    if (registry == NULL) {
+        return false;
+    }
+    return edn_reader_register(registry, "inst", edn_inst_reader) &&
+           edn_reader_register(registry, "uuid", edn_uuid_reader);
+}
+
+bool edn_inst_get(const edn_value_t* value, int64_t* epoch_ns, int32_t* offset_minutes) {
+    if (!value || value->type != EDN_TYPE_EXTERNAL ||
+        value->as.external.type_id != EDN_EXTERNAL_TYPE_INST) {
+        return false;
+    }
+    const edn_inst_data_t* inst = value->as.external.data;
+    if (epoch_ns)
+        *epoch_ns = inst->epoch_ns;
+    if (offset_minutes)
+        *offset_minutes = inst->offset_minutes;
+    return true;
+}
+
+bool edn_uuid_get(const edn_value_t* value, uint8_t bytes[16]) {
+    if (!value || !bytes || value->type != EDN_TYPE_EXTERNAL ||
+        value->as.external.type_id != EDN_EXTERNAL_TYPE_UUID) {
+        return false;
+    }
+    memcpy(bytes, value->as.external.data, EDN_UUID_SIZE);
+    return true;
+}
@@ -0,0 +1,596 @@
+/**
+ * EDN.C - Parse-result cache
+ *
+ * An LRU of parsed documents keyed by the input bytes and the parse options
+ * that change the result. The cache is split into shards chosen by the
+ * input hash, each with its own lock, hash table, LRU list and share of the
+ * memory cap.
+ *
+ * Every entry owns a copy of its input (parsed values point into it) and
+ * the arena of its tree. References are counted: the cache holds one while
+ * the entry is linked, and each edn_parse_cache_read hit hands out another
+ * that edn_free drops (arena->cache_entry routes it here). Evicted entries
+ * stay alive until their last reader lets go.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "edn_internal.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef SRWLOCK cache_lock_t;
+#define CACHE_LOCK_INIT(l) InitializeSRWLock(l)
+#define CACHE_LOCK_DESTROY(l) ((void) (l))
+#define CACHE_LOCK(l) AcquireSRWLockExclusive(l)
+#define CACHE_UNLOCK(l) ReleaseSRWLockExclusive(l)
+#define CACHE_REF_INC(p) InterlockedIncrement(p)
+#define CACHE_REF_DEC(p) InterlockedDecrement(p)
+#elif defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+typedef pthread_mutex_t cache_lock_t;
+#define CACHE_LOCK_INIT(l) pthread_mutex_init((l), NULL)
+#define CACHE_LOCK_DESTROY(l) pthread_mutex_destroy(l)
+#define CACHE_LOCK(l) pthread_mutex_lock(l)
+#define CACHE_UNLOCK(l) pthread_mutex_unlock(l)
+#define CACHE_REF_INC(p) __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+#define CACHE_REF_DEC(p) __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+#else
+/* No threads: the cache is unsynchronized (callers must serialize externally) */
+typedef int cache_lock_t;
+#define CACHE_LOCK_INIT(l) ((void) (l))
+#define CACHE_LOCK_DESTROY(l) ((void) (l))
+#define CACHE_LOCK(l) ((void) (l))
+#define CACHE_UNLOCK(l) ((void) (l))
+#define CACHE_REF_INC(p) (++*(p))
+#define CACHE_REF_DEC(p) (--*(p))
+#endif
+
+#define CACHE_DEFAULT_SHARDS 16
+#define CACHE_MAX_SHARDS 1024
+#define CACHE_INITIAL_BUCKETS 64
+#define CACHE_MIN_BLOCK 512     /* Smallest first arena block for a cached document */
+#define CACHE_GROWTH_BLOCK 4096 /* Growth blocks for documents that outgrow a small first one */
+#define CACHE_MAX_ESTIMATE (ARENA_MAX_INITIAL_SIZE / ARENA_INPUT_RATIO)
+
+/* Parse options that change what a document parses to. Arena sizing and
+ * budgets do not, so documents parsed with different ones share entries.
+ * The registry's generation stands for its contents: entries parsed before
+ * a reader was (un)registered stop matching and age out of the LRU. */
+typedef struct {
+    edn_reader_registry_t* reader_registry;
+    uint64_t registry_generation;
+    edn_default_reader_mode_t default_reader_mode;
+    size_t max_depth;
+    size_t max_memory;
+    bool strict_utf8;
+} cache_key_options_t;
+
+struct edn_parse_cache_entry {
+    struct edn_parse_cache_entry* bucket_next;
+    struct edn_parse_cache_entry* lru_prev; /* Toward most recently used */
+    struct edn_parse_cache_entry* lru_next;
+    uint64_t hash;
+    char* input; /* Owned copy the tree points into */
+    size_t length;
+    cache_key_options_t options;
+    edn_value_t* root;
+    size_t memory; /* Charged against the shard's cap */
+#if defined(_WIN32)
+    volatile LONG refs;
+#else
+    long refs;
+#endif
+};
+
+typedef struct edn_parse_cache_entry cache_entry_t;
+
+typedef struct {
+    cache_lock_t lock;
+    cache_entry_t** buckets;
+    size_t bucket_count; /* Power of two */
+    size_t entries;
+    cache_entry_t* lru_head; /* Most recently used */
+    cache_entry_t* lru_tail;
+    size_t memory;
+    size_t max_memory;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t uncached;
+} cache_shard_t;
+
+struct edn_parse_cache {
+    cache_shard_t* shards;
+    size_t shard_count;
+};
+
+/* ========================================================================
+ * Input hash
+ * ======================================================================== */
+
+/* XXH64-style: four independent multiply-rotate lanes over 32-byte stripes,
+ * so long inputs hash at several bytes per cycle. */
+#define HASH_P1 0x9E3779B185EBCA87ULL
+#define HASH_P2 0xC2B2AE3D27D4EB4FULL
+#define HASH_P3 0x165667B19E3779F9ULL
+#define HASH_P4 0x85EBCA77C2B2AE63ULL
+#define HASH_P5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t hash_rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t hash_read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t hash_round(uint64_t acc, uint64_t input) {
+    acc += input * HASH_P2;
+    acc = hash_rotl(acc, 31);
+    return acc * HASH_P1;
+}
+
+static inline uint64_t hash_merge(uint64_t acc, uint64_t lane) {
+    acc ^= hash_round(0, lane);
+    return acc * HASH_P1 + HASH_P4;
+}
+
+static uint64_t hash_input(const char* input, size_t length, uint64_t seed) {
+    const unsigned char* p = (const unsigned char*) input;
+    const unsigned char* end = p + length;
+    uint64_t h;
+
+    if (length >= 32) {
+        uint64_t v1 = seed + HASH_P1 + HASH_P2;
+        uint64_t v2 = seed + HASH_P2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - HASH_P1;
+        do {
+            v1 = hash_round(v1, hash_read64(p));
+            v2 = hash_round(v2, hash_read64(p + 8));
+            v3 = hash_round(v3, hash_read64(p + 16));
+            v4 = hash_round(v4, hash_read64(p + 24));
+            p += 32;
+        } while (p + 32 <= end);
+        h = hash_rotl(v1, 1) + hash_rotl(v2, 7) + hash_rotl(v3, 12) + hash_rotl(v4, 18);
+        h = hash_merge(h, v1);
+        h = hash_merge(h, v2);
+        h = hash_merge(h, v3);
+        h = hash_merge(h, v4);
+    } else {
+        h = seed + HASH_P5;
+    }
+
+    h += (uint64_t) length;
+    for (; p + 8 <= end; p += 8) {
+        h ^= hash_round(0, hash_read64(p));
+        h = hash_rotl(h, 27) * HASH_P1 + HASH_P4;
+    }
+    for (; p < end; p++) {
+        h ^= (uint64_t) *p * HASH_P5;
+        h = hash_rotl(h, 11) * HASH_P1;
+    }
+
+    h ^= h >> 33;
+    h *= HASH_P2;
+    h ^= h >> 29;
+    h *= HASH_P3;
+    h ^= h >> 32;
+    return h;
+}
+
+static void key_options_from(cache_key_options_t* key, const edn_parse_options_t* options) {
+    memset(key, 0, sizeof(*key));
+    key->default_reader_mode = EDN_DEFAULT_READER_PASSTHROUGH;
+    if (options == NULL) {
+        return;
+    }
+    size_t sz = options->struct_size == 0 ? sizeof(edn_parse_options_t) : options->struct_size;
+    if (sz >= offsetof(edn_parse_options_t, reader_registry) + sizeof(options->reader_registry)) {
+        key->reader_registry = options->reader_registry;
+        key->registry_generation = edn_reader_registry_generation(options->reader_registry);
+    }
+    if (sz >= offsetof(edn_parse_options_t, default_reader_mode) +
+                  sizeof(options->default_reader_mode)) {
+        key->default_reader_mode = options->default_reader_mode;
+    }
+    if (sz >= offsetof(edn_parse_options_t, max_depth) + sizeof(options->max_depth)) {
+        key->max_depth = options->max_depth;
+    }
+    if (sz >= offsetof(edn_parse_options_t, strict_utf8) + sizeof(options->strict_utf8)) {
+        key->strict_utf8 = options->strict_utf8;
+    }
+    if (sz >= offsetof(edn_parse_options_t, max_memory) + sizeof(options->max_memory)) {
+        key->max_memory = options->max_memory;
+    }
+}
+
+static edn_value_t* options_eof_value(const edn_parse_options_t* options) {
+    if (options == NULL) {
+        return NULL;
+    }
+    size_t sz = options->struct_size == 0 ? sizeof(edn_parse_options_t) : options->struct_size;
+    if (sz < offsetof(edn_parse_options_t, eof_value) + sizeof(options->eof_value)) {
+        return NULL;
+    }
+    return options->eof_value;
+}
+
+static uint64_t key_options_seed(const cache_key_options_t* key) {
+    uint64_t seed = (uint64_t) (uintptr_t) key->reader_registry;
+    seed = seed * HASH_P1 + key->registry_generation;
+    seed = seed * HASH_P1 + (uint64_t) key->default_reader_mode;
+    seed = seed * HASH_P1 + (uint64_t) key->max_depth;
+    seed = seed * HASH_P1 + (uint64_t) key->max_memory;
+    return seed * HASH_P1 + (key->strict_utf8 ? 1u : 0u);
+}
+
+static bool key_options_equal(const cache_key_options_t* a, const cache_key_options_t* b) {
+    return a->reader_registry == b->reader_registry &&
+           a->registry_generation == b->registry_generation &&
+           a->default_reader_mode == b->default_reader_mode && a->max_depth == b->max_depth &&
+           a->max_memory == b->max_memory && a->strict_utf8 == b->strict_utf8;
+}
+
+/* ========================================================================
+ * Freezing
+ * ======================================================================== */
+
+/* Run every lazy step a reader could trigger (string decoding, underscore
+ * cleaning, hashes, deferred readers) so that shared trees are only ever
+ * read, never written, by their users. Every node's hash is stored, children
+ * first, since hashing or comparing any subtree would otherwise cache it. */
+static void freeze_value(const edn_value_t* value) {
+    if (value == NULL) {
+        return;
+    }
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    freeze_value(value->metadata);
+#endif
+    switch (value->type) {
+        case EDN_TYPE_STRING:
+            edn_string_get(value, NULL);
+            break;
+        case EDN_TYPE_BIGINT:
+            edn_bigint_get(value, NULL, NULL, NULL);
+            break;
+        case EDN_TYPE_BIGDEC:
+            edn_bigdec_get(value, NULL, NULL);
+            break;
+        case EDN_TYPE_LIST:
+            for (size_t i = 0; i < value->as.list.count; i++) {
+                freeze_value(value->as.list.elements[i]);
+            }
+            break;
+        case EDN_TYPE_VECTOR:
+            for (size_t i = 0; i < value->as.vector.count; i++) {
+                freeze_value(value->as.vector.elements[i]);
+            }
+            break;
+        case EDN_TYPE_SET:
+            for (size_t i = 0; i < value->as.set.count; i++) {
+                freeze_value(value->as.set.elements[i]);
+            }
+            break;
+        case EDN_TYPE_MAP:
+            for (size_t i = 0; i < value->as.map.count; i++) {
+                freeze_value(value->as.map.entries[i].key);
+                freeze_value(value->as.map.entries[i].value);
+            }
+            break;
+        case EDN_TYPE_TAGGED: {
+            freeze_value(value->as.tagged.value);
+            const edn_value_t* resolved = edn_tagged_resolve(value, NULL);
+            if (resolved != value) {
+                freeze_value(resolved);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    edn_value_hash(value);
+}
+
+/* ========================================================================
+ * Entries
+ * ======================================================================== */
+
+static void entry_free(cache_entry_t* entry) {
+    entry->root->arena->cache_entry = NULL;
+    edn_arena_destroy(entry->root->arena);
+    free(entry->input);
+    free(entry);
+}
+
+void edn_parse_cache_release(struct edn_parse_cache_entry* entry) {
+    if (CACHE_REF_DEC(&entry->refs) == 0) {
+        entry_free(entry);
+    }
+}
+
+static void lru_unlink(cache_shard_t* shard, cache_entry_t* entry) {
+    if (entry->lru_prev != NULL) {
+        entry->lru_prev->lru_next = entry->lru_next;
+    } else {
+        shard->lru_head = entry->lru_next;
+    }
+    if (entry->lru_next != NULL) {
+        entry->lru_next->lru_prev = entry->lru_prev;
+    } else {
+        shard->lru_tail = entry->lru_prev;
+    }
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+static void lru_push_front(cache_shard_t* shard, cache_entry_t* entry) {
+    entry->lru_prev = NULL;
+    entry->lru_next = shard->lru_head;
+    if (shard->lru_head != NULL) {
+        shard->lru_head->lru_prev = entry;
+    } else {
+        shard->lru_tail = entry;
+    }
+    shard->lru_head = entry;
+}
+
+/* Unlink from the table and the LRU and drop the cache's reference */
+static void shard_remove(cache_shard_t* shard, cache_entry_t* entry) {
+    cache_entry_t** link = &shard->buckets[entry->hash & (shard->bucket_count - 1)];
+    while (*link != entry) {
+        link = &(*link)->bucket_next;
+    }
+    *link = entry->bucket_next;
+    lru_unlink(shard, entry);
+    shard->entries--;
+    shard->memory -= entry->memory;
+    edn_parse_cache_release(entry);
+}
+
+static cache_entry_t* shard_find(cache_shard_t* shard, uint64_t hash, const char* input,
+                                 size_t length, const cache_key_options_t* options) {
+    cache_entry_t* entry = shard->buckets[hash & (shard->bucket_count - 1)];
+    for (; entry != NULL; entry = entry->bucket_next) {
+        if (entry->hash == hash && entry->length == length &&
+            key_options_equal(&entry->options, options) &&
+            memcmp(entry->input, input, length) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void shard_grow(cache_shard_t* shard) {
+    size_t count = shard->bucket_count * 2;
+    cache_entry_t** buckets = calloc(count, sizeof(*buckets));
+    if (buckets == NULL) {
+        return; /* Longer chains, still correct */
+    }
+    for (size_t i = 0; i < shard->bucket_count; i++) {
+        cache_entry_t* entry = shard->buckets[i];
+        while (entry != NULL) {
+            cache_entry_t* next = entry->bucket_next;
+            cache_entry_t** head = &buckets[entry->hash & (count - 1)];
+            entry->bucket_next = *head;
+            *head = entry;
+            entry = next;
+        }
+    }
+    free(shard->buckets);
+    shard->buckets = buckets;
+    shard->bucket_count = count;
+}
+
+static void shard_insert(cache_shard_t* shard, cache_entry_t* entry) {
+    while (shard->memory + entry->memory > shard->max_memory && shard->lru_tail != NULL) {
+        shard_remove(shard, shard->lru_tail);
+        shard->evictions++;
+    }
+    if (shard->entries >= shard->bucket_count) {
+        shard_grow(shard);
+    }
+    cache_entry_t** head = &shard->buckets[entry->hash & (shard->bucket_count - 1)];
+    entry->bucket_next = *head;
+    *head = entry;
+    lru_push_front(shard, entry);
+    shard->entries++;
+    shard->memory += entry->memory;
+    CACHE_REF_INC(&entry->refs);
+}
+
+/* ========================================================================
+ * Public API
+ * ======================================================================== */
+
+edn_parse_cache_t* edn_parse_cache_create(size_t max_memory, size_t shards) {
+    if (shards == 0) {
+        shards = CACHE_DEFAULT_SHARDS;
+    } else if (shards > CACHE_MAX_SHARDS) {
+        shards = CACHE_MAX_SHARDS;
+    }
+
+    edn_parse_cache_t* cache = malloc(sizeof(*cache));
+    if (cache == NULL) {
+        return NULL;
+    }
+    cache->shards = calloc(shards, sizeof(cache_shard_t));
+    if (cache->shards == NULL) {
+        free(cache);
+        return NULL;
+    }
+    cache->shard_count = shards;
+
+    for (size_t i = 0; i < shards; i++) {
+        cache_shard_t* shard = &cache->shards[i];
+        shard->buckets = calloc(CACHE_INITIAL_BUCKETS, sizeof(cache_entry_t*));
+        if (shard->buckets == NULL) {
+            for (size_t j = 0; j < i; j++) {
+                CACHE_LOCK_DESTROY(&cache->shards[j].lock);
+                free(cache->shards[j].buckets);
+            }
+            free(cache->shards);
+            free(cache);
+            return NULL;
+        }
+        shard->bucket_count = CACHE_INITIAL_BUCKETS;
+        shard->max_memory = max_memory / shards;
+        CACHE_LOCK_INIT(&shard->lock);
+    }
+    return cache;
+}
+
+void edn_parse_cache_clear(edn_parse_cache_t* cache) {
+    if (cache == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        cache_shard_t* shard = &cache->shards[i];
+        CACHE_LOCK(&shard->lock);
+        while (shard->lru_tail != NULL) {
+            shard_remove(shard, shard->lru_tail);
+        }
+        CACHE_UNLOCK(&shard->lock);
+    }
+}
+
+void edn_parse_cache_destroy(edn_parse_cache_t* cache) {
+    if (cache == NULL) {
+        return;
+    }
+    edn_parse_cache_clear(cache);
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        CACHE_LOCK_DESTROY(&cache->shards[i].lock);
+        free(cache->shards[i].buckets);
+    }
+    free(cache->shards);
+    free(cache);
+}
+
+edn_result_t edn_parse_cache_read(edn_parse_cache_t* cache, const char* input, size_t length,
+                                  const edn_parse_options_t* options) {
+    if (cache == NULL || input == NULL) {
+        return edn_read_with_options(input, length, options);
+    }
+    if (length == 0) {
+        length = strlen(input);
+    }
+
+    cache_key_options_t key;
+    key_options_from(&key, options);
+    uint64_t hash = hash_input(input, length, key_options_seed(&key));
+    cache_shard_t* shard = &cache->shards[(hash >> 32) % cache->shard_count];
+
+    edn_result_t result = {0};
+    CACHE_LOCK(&shard->lock);
+    cache_entry_t* hit = shard_find(shard, hash, input, length, &key);
+    if (hit != NULL) {
+        lru_unlink(shard, hit);
+        lru_push_front(shard, hit);
+        CACHE_REF_INC(&hit->refs);
+        shard->hits++;
+        CACHE_UNLOCK(&shard->lock);
+        result.value = hit->root;
+        return result;
+    }
+    shard->misses++;
+    CACHE_UNLOCK(&shard->lock);
+
+    /* Miss: parse a private copy, since the tree points into its input */
+    cache_entry_t* entry = malloc(sizeof(*entry));
+    char* copy = malloc(length + 1);
+    if (entry == NULL || copy == NULL) {
+        free(entry);
+        free(copy);
+        result.error = EDN_ERROR_OUT_OF_MEMORY;
+        result.error_message = "Out of memory";
+        return result;
+    }
+    memcpy(copy, input, length);
+    copy[length] = '\0';
+
+    /* Size the arena from the input even for small payloads: a cached
+     * document would otherwise pin a default-sized first block for life. */
+    edn_parse_options_t local = {0};
+    if (options != NULL) {
+        size_t sz = options->struct_size == 0 ? sizeof(local) : options->struct_size;
+        memcpy(&local, options, sz < sizeof(local) ? sz : sizeof(local));
+    }
+    local.struct_size = sizeof(local);
+    if (local.arena_initial_block == 0) {
+        size_t estimate =
+            length < CACHE_MAX_ESTIMATE ? length * ARENA_INPUT_RATIO : ARENA_MAX_INITIAL_SIZE;
+        local.arena_initial_block = estimate > CACHE_MIN_BLOCK ? estimate : CACHE_MIN_BLOCK;
+    }
+    if (local.arena_max_block == 0 && local.arena_initial_block < CACHE_GROWTH_BLOCK) {
+        local.arena_max_block = CACHE_GROWTH_BLOCK;
+    }
+
+    /* Error positions are offsets and line numbers, the same for the copy */
+    result = edn_read_with_options(copy, length, &local);
+    if (result.error != EDN_OK || result.value == NULL || result.value->arena == NULL ||
+        result.value == options_eof_value(options)) {
+        /* Errors and eof_value own nothing that points into the copy */
+        free(entry);
+        free(copy);
+        return result;
+    }
+
+    freeze_value(result.value);
+
+    memset(entry, 0, sizeof(*entry));
+    entry->hash = hash;
+    entry->input = copy;
+    entry->length = length;
+    entry->options = key;
+    entry->root = result.value;
+    entry->memory = sizeof(*entry) + length + 1 + result.value->arena->total_allocated;
+    entry->refs = 1; /* The caller's */
+    result.value->arena->cache_entry = entry;
+
+    CACHE_LOCK(&shard->lock);
+    cache_entry_t* raced = shard_find(shard, hash, input, length, &key);
+    if (raced != NULL) {
+        /* Another thread cached the same document meanwhile: share theirs */
+        lru_unlink(shard, raced);
+        lru_push_front(shard, raced);
+        CACHE_REF_INC(&raced->refs);
+        CACHE_UNLOCK(&shard->lock);
+        edn_parse_cache_release(entry);
+        result.value = raced->root;
+        return result;
+    }
+    if (entry->memory <= shard->max_memory) {
+        shard_insert(shard, entry);
+    } else {
+        shard->uncached++; /* Still shared with edn_free, just never found again */
+    }
+    CACHE_UNLOCK(&shard->lock);
+    return result;
+}
+
+void edn_parse_cache_stats(edn_parse_cache_t* cache, edn_parse_cache_stats_t* stats) {
+    if (stats == NULL) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (cache == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < cache->shard_count; i++) {
+        cache_shard_t* shard = &cache->shards[i];
+        CACHE_LOCK(&shard->lock);
+        stats->hits += shard->hits;
+        stats->misses += shard->misses;
+        stats->evictions += shard->evictions;
+        stats->uncached += shard->uncached;
+        stats->entries += shard->entries;
+        stats->memory += shard->memory;
+        stats->max_memory += shard->max_memory;
+        CACHE_UNLOCK(&shard->lock);
+    }
+}
@@ -3,6 +3,7 @@
  */
 
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "edn_internal.h"
@@ -12,75 +13,72 @@ static inline bool capacity_too_large(size_t count) {
     return count > (SIZE_MAX / sizeof(edn_value_t*));
 }
 
-typedef struct {
-    edn_value_t** elements;
-    size_t count;
-    size_t capacity;
-    edn_arena_t* arena;
-    edn_value_t* inline_storage[8];
-} edn_collection_builder_t;
-
-static void edn_collection_builder_init(edn_collection_builder_t* builder, edn_arena_t* arena,
-                                        size_t initial_capacity) {
-    builder->count = 0;
-    builder->arena = arena;
-
-    if (initial_capacity <= 8) {
-        builder->elements = builder->inline_storage;
-        builder->capacity = 8;
-    } else {
-        builder->elements = edn_arena_alloc(arena, initial_capacity * sizeof(edn_value_t*));
-        if (builder->elements != NULL) {
-            builder->capacity = initial_capacity;
-        } else {
-            builder->elements = builder->inline_storage;
-            builder->capacity = 8;
-        }
-    }
+/* edn_has_duplicates, timed per strategy when the parse collects stats */
+static bool parser_has_duplicates(edn_parser_t* parser, edn_value_t** elements, size_t count) {
+#ifdef EDN_ENABLE_INSTRUMENTATION
+    if (parser->stats != NULL) {
+        edn_duplicate_tier_t tier = edn_duplicates_tier(count);
+        uint64_t start = edn_monotonic_ns();
+        bool found = edn_has_duplicates(elements, count);
+        parser->stats->duplicate_checks[tier]++;
+        parser->stats->duplicate_check_ns[tier] += edn_monotonic_ns() - start;
+        return found;
+    }
+#else
+    (void) parser;
+#endif
+    return edn_has_duplicates(elements, count);
 }
 
-static bool edn_collection_builder_add(edn_collection_builder_t* builder, edn_value_t* value) {
-    if (builder->count >= builder->capacity) {
-        size_t new_capacity = builder->capacity + (builder->capacity >> 1);
-        if (new_capacity <= builder->capacity) {
-            new_capacity = builder->capacity + 8;
-        }
-        if (capacity_too_large(new_capacity)) {
+/*
+ * Children of every open collection live on one heap stack owned by the
+ * parser. A collection records the stack height at its opening delimiter,
+ * its children are pushed above that mark, and on close the exact-size
+ * slice is copied into the arena once and popped. Growing the stack never
+ * strands arrays in the arena, and its capacity is reused by every later
+ * collection in the same parse.
+ */
+static bool edn_child_push(edn_parser_t* parser, edn_value_t* value) {
+    if (parser->child_count == parser->child_capacity) {
+        size_t new_capacity = parser->child_capacity ? parser->child_capacity * 2 : 64;
+        if (new_capacity <= parser->child_capacity || capacity_too_large(new_capacity)) {
             return false;
         }
 
-        edn_value_t** new_elements =
-            edn_arena_alloc(builder->arena, new_capacity * sizeof(edn_value_t*));
-        if (new_elements == NULL) {
+        edn_value_t** grown = realloc(parser->child_stack, new_capacity * sizeof(edn_value_t*));
+        if (grown == NULL) {
             return false;
         }
 
-        if (builder->count > 0) {
-            memcpy(new_elements, builder->elements, builder->count * sizeof(edn_value_t*));
-        }
-
-        builder->elements = new_elements;
-        builder->capacity = new_capacity;
+        parser->child_stack = grown;
+        parser->child_capacity = new_capacity;
     }
 
-    builder->elements[builder->count++] = value;
+    parser->child_stack[parser->child_count++] = value;
     return true;
 }
 
-static edn_value_t** edn_collection_builder_finish(edn_collection_builder_t* builder,
-                                                   size_t* out_count) {
-    *out_count = builder->count;
+/* Pop the children above `base` into an exact-size arena array (NULL when
+ * empty). Returns false if the arena is out of memory. */
+static bool edn_child_pop(edn_parser_t* parser, size_t base, edn_value_t*** out_elements,
+                          size_t* out_count) {
+    size_t count = parser->child_count - base;
+    parser->child_count = base;
+    *out_count = count;
+    *out_elements = NULL;
 
-    if (builder->elements == builder->inline_storage && builder->count > 0) {
-        edn_value_t** permanent =
-            edn_arena_alloc(builder->arena, builder->count * sizeof(edn_value_t*));
-        if (permanent != NULL) {
-            memcpy(permanent, builder->inline_storage, builder->count * sizeof(edn_value_t*));
-            return permanent;
-        }
+    if (count == 0) {
+        return true;
+    }
+
+    edn_value_t** elements = edn_arena_alloc(parser->arena, count * sizeof(edn_value_t*));
+    if (elements == NULL) {
+        return false;
     }
 
-    return builder->elements;
+    memcpy(elements, parser->child_stack + base, count * sizeof(edn_value_t*));
+    *out_elements = elements;
+    return true;
 }
 
 edn_value_t* edn_read_list(edn_parser_t* parser) {
@@ -90,17 +88,24 @@ edn_value_t* edn_read_list(edn_parser_t* parser) {
     if (!edn_enter_depth(parser)) {
         return NULL;
     }
+    if (!edn_schema_begin(parser, EDN_TYPE_LIST, value_start)) {
+        edn_leave_depth(parser);
+        return NULL;
+    }
 
-    edn_collection_builder_t builder;
-    edn_collection_builder_init(&builder, parser->arena, 8);
+    size_t base = parser->child_count;
 
     while (true) {
+        if (!edn_budget_ok(parser)) {
+            break;
+        }
         edn_value_t* element = edn_read_value(parser);
-        if (element == NULL) {
+        if (element == NULL || !edn_schema_element(parser, element)) {
             break;
         }
 
-        if (!edn_collection_builder_add(&builder, element)) {
+        if (!edn_child_push(parser, element)) {
+            parser->child_count = base;
             edn_leave_depth(parser);
             edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
                                  "Out of memory while building list", value_start, parser->current);
@@ -113,11 +118,13 @@ edn_value_t* edn_read_list(edn_parser_t* parser) {
             edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
                                  "Unterminated list (missing ')')", value_start, parser->current);
         }
+        parser->child_count = base;
         edn_leave_depth(parser);
         return NULL;
     }
 
     if (parser->current >= parser->end) {
+        parser->child_count = base;
         edn_leave_depth(parser);
         edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
                              "Unterminated list (missing ')')", value_start, parser->current);
@@ -125,6 +132,7 @@ edn_value_t* edn_read_list(edn_parser_t* parser) {
     }
 
     if (*parser->current != ')') {
+        parser->child_count = base;
         edn_leave_depth(parser);
         edn_parser_set_error(parser, EDN_ERROR_UNMATCHED_DELIMITER,
                              "Mismatched closing delimiter in list", value_start,
@@ -134,9 +142,18 @@ edn_value_t* edn_read_list(edn_parser_t* parser) {
 
     parser->current++;
     edn_leave_depth(parser);
+    if (!edn_schema_end(parser, value_start)) {
+        parser->child_count = base;
+        return NULL;
+    }
 
     size_t count;
-    edn_value_t** elements = edn_collection_builder_finish(&builder, &count);
+    edn_value_t** elements;
+    if (!edn_child_pop(parser, base, &elements, &count)) {
+        edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY, "Out of memory allocating list",
+                             value_start, parser->current);
+        return NULL;
+    }
 
     edn_value_t* value = edn_arena_alloc_value(parser->arena);
     if (value == NULL) {
@@ -162,17 +179,24 @@ edn_value_t* edn_read_vector(edn_parser_t* parser) {
     if (!edn_enter_depth(parser)) {
         return NULL;
     }
+    if (!edn_schema_begin(parser, EDN_TYPE_VECTOR, value_start)) {
+        edn_leave_depth(parser);
+        return NULL;
+    }
 
-    edn_collection_builder_t builder;
-    edn_collection_builder_init(&builder, parser->arena, 8);
+    size_t base = parser->child_count;
 
     while (true) {
+        if (!edn_budget_ok(parser)) {
+            break;
+        }
         edn_value_t* element = edn_read_value(parser);
-        if (element == NULL) {
+        if (element == NULL || !edn_schema_element(parser, element)) {
             break;
         }
 
-        if (!edn_collection_builder_add(&builder, element)) {
+        if (!edn_child_push(parser, element)) {
+            parser->child_count = base;
             edn_leave_depth(parser);
             edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
                                  "Out of memory while building vector", value_start,
@@ -186,11 +210,13 @@ edn_value_t* edn_read_vector(edn_parser_t* parser) {
             edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
                                  "Unterminated vector (missing ']')", value_start, parser->current);
         }
+        parser->child_count = base;
         edn_leave_depth(parser);
         return NULL;
     }
 
     if (parser->current >= parser->end) {
+        parser->child_count = base;
         edn_leave_depth(parser);
         edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
                              "Unterminated vector (missing ']')", value_start, parser->current);
@@ -198,6 +224,7 @@ edn_value_t* edn_read_vector(edn_parser_t* parser) {
     }
 
     if (*parser->current != ']') {
+        parser->child_count = base;
         edn_leave_depth(parser);
         edn_parser_set_error(parser, EDN_ERROR_UNMATCHED_DELIMITER,
                              "Mismatched closing delimiter in vector", value_start,
@@ -207,9 +234,18 @@ edn_value_t* edn_read_vector(edn_parser_t* parser) {
 
     parser->current++;
     edn_leave_depth(parser);
+    if (!edn_schema_end(parser, value_start)) {
+        parser->child_count = base;
+        return NULL;
+    }
 
     size_t count;
-    edn_value_t** elements = edn_collection_builder_finish(&builder, &count);
+    edn_value_t** elements;
+    if (!edn_child_pop(parser, base, &elements, &count)) {
+        edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY, "Out of memory allocating vector",
+                             value_start, parser->current);
+        return NULL;
+    }
 
     edn_value_t* value = edn_arena_alloc_value(parser->arena);
     if (value == NULL) {
@@ -235,17 +271,24 @@ edn_value_t* edn_read_set(edn_parser_t* parser) {
     if (!edn_enter_depth(parser)) {
         return NULL;
     }
+    if (!edn_schema_begin(parser, EDN_TYPE_SET, value_start)) {
+        edn_leave_depth(parser);
+        return NULL;
+    }
 
-    edn_collection_builder_t builder;
-    edn_collection_builder_init(&builder, parser->arena, 8);
+    size_t base = parser->child_count;
 
     while (true) {
+        if (!edn_budget_ok(parser)) {
+            break;
+        }
         edn_value_t* element = edn_read_value(parser);
-        if (element == NULL) {
+        if (element == NULL || !edn_schema_element(parser, element)) {
             break;
         }
 
-        if (!edn_collection_builder_add(&builder, element)) {
+        if (!edn_child_push(parser, element)) {
+            parser->child_count = base;
             edn_leave_depth(parser);
             edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
                                  "Out of memory while building set", value_start, parser->current);
@@ -258,11 +301,13 @@ edn_value_t* edn_read_set(edn_parser_t* parser) {
             edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
                                  "Unterminated set (missing '}')", value_start, parser->current);
         }
+        parser->child_count = base;
         edn_leave_depth(parser);
         return NULL;
     }
 
     if (parser->current >= parser->end) {
+        parser->child_count = base;
         edn_leave_depth(parser);
         edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
                              "Unterminated set (missing '}')", value_start, parser->current);
@@ -270,6 +315,7 @@ edn_value_t* edn_read_set(edn_parser_t* parser) {
     }
 
     if (*parser->current != '}') {
+        parser->child_count = base;
         edn_leave_depth(parser);
         edn_parser_set_error(parser, EDN_ERROR_UNMATCHED_DELIMITER,
                              "Mismatched closing delimiter in set", value_start,
@@ -279,12 +325,21 @@ edn_value_t* edn_read_set(edn_parser_t* parser) {
 
     parser->current++;
     edn_leave_depth(parser);
+    if (!edn_schema_end(parser, value_start)) {
+        parser->child_count = base;
+        return NULL;
+    }
 
     size_t count;
-    edn_value_t** elements = edn_collection_builder_finish(&builder, &count);
+    edn_value_t** elements;
+    if (!edn_child_pop(parser, base, &elements, &count)) {
+        edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY, "Out of memory allocating set",
+                             value_start, parser->current);
+        return NULL;
+    }
 
     /* Check for duplicate elements (EDN spec requirement) */
-    if (count > 1 && edn_has_duplicates(elements, count)) {
+    if (count > 1 && parser_has_duplicates(parser, elements, count)) {
         edn_parser_set_error(parser, EDN_ERROR_DUPLICATE_ELEMENT, "Set contains duplicate elements",
                              value_start, parser->current);
         return NULL;
@@ -307,94 +362,34 @@ edn_value_t* edn_read_set(edn_parser_t* parser) {
     return value;
 }
 
-typedef struct {
-    edn_value_t** keys;
-    edn_value_t** values;
-    size_t count;
-    size_t capacity;
-    edn_arena_t* arena;
-    edn_value_t* inline_keys[8];
-    edn_value_t* inline_values[8];
-} edn_map_builder_t;
-
-static void edn_map_builder_init(edn_map_builder_t* builder, edn_arena_t* arena,
-                                 size_t initial_capacity) {
-    builder->count = 0;
-    builder->arena = arena;
-
-    if (initial_capacity <= 8) {
-        builder->keys = builder->inline_keys;
-        builder->values = builder->inline_values;
-        builder->capacity = 8;
-    } else {
-        builder->keys = edn_arena_alloc(arena, initial_capacity * sizeof(edn_value_t*));
-        builder->values = edn_arena_alloc(arena, initial_capacity * sizeof(edn_value_t*));
-        if (builder->keys != NULL && builder->values != NULL) {
-            builder->capacity = initial_capacity;
-        } else {
-            builder->keys = builder->inline_keys;
-            builder->values = builder->inline_values;
-            builder->capacity = 8;
-        }
-    }
-}
-
-static bool edn_map_builder_add(edn_map_builder_t* builder, edn_value_t* key, edn_value_t* value) {
-    if (builder->count >= builder->capacity) {
-        size_t new_capacity = builder->capacity + (builder->capacity >> 1);
-        if (new_capacity <= builder->capacity) {
-            new_capacity = builder->capacity + 8;
-        }
-        if (capacity_too_large(new_capacity)) {
-            return false;
-        }
-
-        edn_value_t** new_keys =
-            edn_arena_alloc(builder->arena, new_capacity * sizeof(edn_value_t*));
-        edn_value_t** new_values =
-            edn_arena_alloc(builder->arena, new_capacity * sizeof(edn_value_t*));
-        if (new_keys == NULL || new_values == NULL) {
-            return false;
-        }
-
-        if (builder->count > 0) {
-            memcpy(new_keys, builder->keys, builder->count * sizeof(edn_value_t*));
-            memcpy(new_values, builder->values, builder->count * sizeof(edn_value_t*));
-        }
+/* Pop the key/value pairs above `base` into an exact-size entry array
+ * (NULL when empty). The keys are also gathered, in order, into the freed
+ * stack slots at `base` for the duplicate check; *out_keys points there and
+ * is valid until the next push. */
+static bool edn_child_pop_map(edn_parser_t* parser, size_t base, edn_map_entry_t** out_entries,
+                              edn_value_t*** out_keys, size_t* out_count) {
+    size_t count = (parser->child_count - base) / 2;
+    edn_value_t** pairs = parser->child_stack + base;
+    parser->child_count = base;
+    *out_count = count;
+    *out_entries = NULL;
+    *out_keys = pairs;
 
-        builder->keys = new_keys;
-        builder->values = new_values;
-        builder->capacity = new_capacity;
+    if (count == 0) {
+        return true;
     }
 
-    builder->keys[builder->count] = key;
-    builder->values[builder->count] = value;
-    builder->count++;
-
-    return true;
-}
-
-static void edn_map_builder_finish(edn_map_builder_t* builder, edn_value_t*** out_keys,
-                                   edn_value_t*** out_values, size_t* out_count) {
-    *out_count = builder->count;
-
-    /* If using inline storage and we have entries, allocate permanent storage */
-    if (builder->keys == builder->inline_keys && builder->count > 0) {
-        edn_value_t** permanent_keys =
-            edn_arena_alloc(builder->arena, builder->count * sizeof(edn_value_t*));
-        edn_value_t** permanent_values =
-            edn_arena_alloc(builder->arena, builder->count * sizeof(edn_value_t*));
-        if (permanent_keys != NULL && permanent_values != NULL) {
-            memcpy(permanent_keys, builder->inline_keys, builder->count * sizeof(edn_value_t*));
-            memcpy(permanent_values, builder->inline_values, builder->count * sizeof(edn_value_t*));
-            *out_keys = permanent_keys;
-            *out_values = permanent_values;
-            return;
-        }
+    edn_map_entry_t* entries = edn_arena_alloc(parser->arena, count * sizeof(edn_map_entry_t));
+    if (entries == NULL) {
+        return false;
     }
 
-    *out_keys = builder->keys;
-    *out_values = builder->values;
+    for (size_t i = 0; i < count; i++) {
+        edn_map_entry_init(&entries[i], pairs[2 * i], pairs[2 * i + 1]);
+        pairs[i] = entries[i].key; /* slot i <= 2i was already consumed */
+    }
+    *out_entries = entries;
+    return true;
 }
 
 static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* value_start,
@@ -403,11 +398,19 @@ static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* valu
     if (!edn_enter_depth(parser)) {
         return NULL;
     }
+    if (!edn_schema_begin(parser, EDN_TYPE_MAP, value_start)) {
+        edn_leave_depth(parser);
+        return NULL;
+    }
 
-    edn_map_builder_t builder;
-    edn_map_builder_init(&builder, parser->arena, 8);
+    size_t base = parser->child_count;
 
     while (true) {
+        if (!edn_budget_ok(parser)) {
+            parser->child_count = base;
+            edn_leave_depth(parser);
+            return NULL;
+        }
         edn_value_t* key = edn_read_value(parser);
         if (key == NULL) {
             if (parser->error != EDN_OK) {
@@ -418,34 +421,20 @@ static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* valu
                                              : "Unterminated map (missing '}')",
                                          value_start, parser->current);
                 }
+                parser->child_count = base;
                 edn_leave_depth(parser);
                 return NULL;
             }
             break;
         }
 
-        edn_value_t* value = edn_read_value(parser);
-        if (value == NULL) {
-            edn_leave_depth(parser);
-            if (parser->error == EDN_OK) {
-                edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
-                                     "Map has odd number of elements (key without value)",
-                                     value_start, parser->current);
-            } else if (parser->error == EDN_ERROR_UNEXPECTED_EOF) {
-                edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
-                                     ns_name != NULL ? "Unterminated namespaced map (missing '}')"
-                                                     : "Unterminated map (missing '}')",
-                                     value_start, parser->current);
-            }
-            return NULL;
-        }
-
         edn_value_t* final_key = key;
 
         if (ns_name != NULL && key->type == EDN_TYPE_KEYWORD) {
             if (key->as.keyword.namespace == NULL) {
                 final_key = edn_arena_alloc_value(parser->arena);
                 if (final_key == NULL) {
+                    parser->child_count = base;
                     edn_leave_depth(parser);
                     edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
                                          "Out of memory allocating namespaced keyword", value_start,
@@ -462,6 +451,7 @@ static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* valu
             } else if (key->as.keyword.ns_length == 1 && key->as.keyword.namespace[0] == '_') {
                 final_key = edn_arena_alloc_value(parser->arena);
                 if (final_key == NULL) {
+                    parser->child_count = base;
                     edn_leave_depth(parser);
                     edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
                                          "Out of memory allocating keyword", value_start,
@@ -482,6 +472,7 @@ static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* valu
             if (key->as.symbol.namespace == NULL) {
                 final_key = edn_arena_alloc_value(parser->arena);
                 if (final_key == NULL) {
+                    parser->child_count = base;
                     edn_leave_depth(parser);
                     edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
                                          "Out of memory allocating namespaced symbol", value_start,
@@ -498,6 +489,7 @@ static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* valu
             } else if (key->as.symbol.ns_length == 1 && key->as.symbol.namespace[0] == '_') {
                 final_key = edn_arena_alloc_value(parser->arena);
                 if (final_key == NULL) {
+                    parser->child_count = base;
                     edn_leave_depth(parser);
                     edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
                                          "Out of memory allocating symbol", value_start,
@@ -514,7 +506,42 @@ static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* valu
             }
         }
 
-        if (!edn_map_builder_add(&builder, final_key, value)) {
+        /* A rewritten key keeps the source range of the key that was read */
+        final_key->source_start = key->source_start;
+        final_key->source_end = key->source_end;
+
+        /* The key is checked before its value is read: it picks the value's schema */
+        if (!edn_schema_element(parser, final_key)) {
+            parser->child_count = base;
+            edn_leave_depth(parser);
+            return NULL;
+        }
+
+        edn_value_t* value = edn_read_value(parser);
+        if (value == NULL) {
+            parser->child_count = base;
+            edn_leave_depth(parser);
+            if (parser->error == EDN_OK) {
+                edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                                     "Map has odd number of elements (key without value)",
+                                     value_start, parser->current);
+            } else if (parser->error == EDN_ERROR_UNEXPECTED_EOF) {
+                edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
+                                     ns_name != NULL ? "Unterminated namespaced map (missing '}')"
+                                                     : "Unterminated map (missing '}')",
+                                     value_start, parser->current);
+            }
+            return NULL;
+        }
+
+        if (!edn_schema_element(parser, value)) {
+            parser->child_count = base;
+            edn_leave_depth(parser);
+            return NULL;
+        }
+
+        if (!edn_child_push(parser, final_key) || !edn_child_push(parser, value)) {
+            parser->child_count = base;
             edn_leave_depth(parser);
             edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
                                  "Out of memory while building map", value_start, parser->current);
@@ -523,6 +550,7 @@ static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* valu
     }
 
     if (parser->current >= parser->end) {
+        parser->child_count = base;
         edn_leave_depth(parser);
         edn_parser_set_error(parser, EDN_ERROR_UNEXPECTED_EOF,
                              ns_name != NULL ? "Unterminated namespaced map (missing '}')"
@@ -532,6 +560,7 @@ static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* valu
     }
 
     if (*parser->current != '}') {
+        parser->child_count = base;
         edn_leave_depth(parser);
         edn_parser_set_error(parser, EDN_ERROR_UNMATCHED_DELIMITER,
                              ns_name != NULL ? "Mismatched closing delimiter in namespaced map"
@@ -542,15 +571,23 @@ static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* valu
 
     parser->current++;
     edn_leave_depth(parser);
+    if (!edn_schema_end(parser, value_start)) {
+        parser->child_count = base;
+        return NULL;
+    }
 
+    edn_map_entry_t* entries;
     edn_value_t** keys;
-    edn_value_t** values;
     size_t count;
-    edn_map_builder_finish(&builder, &keys, &values, &count);
+    if (!edn_child_pop_map(parser, base, &entries, &keys, &count)) {
+        edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY, "Out of memory allocating map",
+                             value_start, parser->current);
+        return NULL;
+    }
 
     /* Check for duplicate keys (EDN spec requirement) */
     if (count > 1) {
-        if (edn_has_duplicates(keys, count)) {
+        if (parser_has_duplicates(parser, keys, count)) {
             edn_parser_set_error(parser, EDN_ERROR_DUPLICATE_KEY,
                                  ns_name != NULL ? "Namespaced map contains duplicate keys"
                                                  : "Map contains duplicate keys",
@@ -567,8 +604,7 @@ static edn_value_t* edn_read_map_internal(edn_parser_t* parser, const char* valu
     }
 
     result->type = EDN_TYPE_MAP;
-    result->as.map.keys = keys;
-    result->as.map.values = values;
+    result->as.map.entries = entries;
     result->as.map.count = count;
     result->arena = parser->arena;
     result->source_start = value_start - parser->input;
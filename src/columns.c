@@ -0,0 +1,662 @@
+/**
+ * EDN.C - Columnar conversion
+ *
+ * edn_to_columns makes a single pass over the rows. The row count is
+ * known up front, so a column's buffers are allocated at their final size
+ * (zeroed, which is what null slots hold) by the first non-nil value that
+ * settles its type, and every later value is stored in place. The one
+ * type change allowed, integers meeting floats, converts the int64_t
+ * buffer to double in place. Only string data and keyword dictionaries
+ * grow as they go.
+ *
+ * Rows from one producer usually list their keys in the same order, so a
+ * key is first compared with the column the same entry position had in
+ * the previous row; only a miss goes to the hash table.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "edn_internal.h"
+
+#define COLUMN_SKIP UINT32_MAX /* Entry not converted */
+#define COLUMN_TABLE_INITIAL 64
+#define STRING_DATA_INITIAL 256
+#define DICTIONARY_INITIAL 16
+
+typedef struct {
+    char* name; /* "ns/name" or "name" */
+    const char* ns;
+    size_t ns_length;
+    const char* local;
+    size_t local_length;
+    uint32_t hash; /* edn_keyword_hash32 of the key */
+    edn_column_type_t type; /* EDN_COLUMN_NULL until a value settles it */
+    size_t present;         /* Rows with a value */
+
+    uint8_t* validity;
+    uint8_t* bits;
+    int64_t* int64_values;
+    double* double_values;
+    int32_t* indices;
+    int32_t* offsets;
+    char* data;
+
+    size_t used;          /* STRING, KEYWORD: data bytes written */
+    size_t data_capacity; /* STRING, KEYWORD */
+    size_t offset_row;    /* STRING: offsets are set for rows before this one */
+
+    /* KEYWORD dictionary */
+    size_t dictionary_size;
+    size_t dictionary_capacity;
+    uint32_t* dictionary_hashes;
+    uint32_t* dictionary_table; /* Entry + 1 (0 = empty) */
+    size_t dictionary_slots;
+
+    edn_column_t pub;
+} column_t;
+
+struct edn_columns {
+    column_t* columns;
+    size_t count;
+    size_t rows;
+};
+
+typedef struct {
+    edn_columns_t* out;
+    size_t capacity;
+    uint32_t* table; /* Column + 1 by key hash (0 = empty) */
+    size_t slots;
+    bool fixed; /* Columns come from options->keys */
+    edn_result_t* result;
+} builder_t;
+
+static void set_error(edn_result_t* result, edn_error_t error, const char* message,
+                      const edn_value_t* at) {
+    result->error = error;
+    result->error_message = message;
+    memset(&result->error_start, 0, sizeof(result->error_start));
+    memset(&result->error_end, 0, sizeof(result->error_end));
+    if (at != NULL) {
+        result->error_start.offset = at->source_start;
+        result->error_end.offset = at->source_end;
+    }
+}
+
+/* Zeroed allocation that never returns NULL for a zero size */
+static void* zalloc(size_t count, size_t size) {
+    return calloc(count ? count : 1, size);
+}
+
+static bool column_matches(const column_t* column, uint32_t hash, const char* ns,
+                           size_t ns_length, const char* local, size_t local_length) {
+    return column->hash == hash && column->ns_length == ns_length &&
+           column->local_length == local_length &&
+           (ns_length == 0 || memcmp(column->ns, ns, ns_length) == 0) &&
+           memcmp(column->local, local, local_length) == 0;
+}
+
+static void table_insert(uint32_t* table, size_t slots, uint32_t hash, uint32_t value) {
+    size_t i = hash & (slots - 1);
+    while (table[i] != 0) {
+        i = (i + 1) & (slots - 1);
+    }
+    table[i] = value + 1;
+}
+
+static uint32_t find_column(const builder_t* b, uint32_t hash, const char* ns, size_t ns_length,
+                            const char* local, size_t local_length) {
+    for (size_t i = hash & (b->slots - 1); b->table[i] != 0; i = (i + 1) & (b->slots - 1)) {
+        uint32_t c = b->table[i] - 1;
+        if (column_matches(&b->out->columns[c], hash, ns, ns_length, local, local_length)) {
+            return c;
+        }
+    }
+    return COLUMN_SKIP;
+}
+
+/* Append a column; COLUMN_SKIP with b->result set when out of memory */
+static uint32_t add_column(builder_t* b, uint32_t hash, const char* ns, size_t ns_length,
+                           const char* local, size_t local_length) {
+    edn_columns_t* out = b->out;
+    if (out->count == b->capacity) {
+        size_t capacity = b->capacity ? b->capacity * 2 : 16;
+        column_t* columns = realloc(out->columns, capacity * sizeof(*columns));
+        if (columns == NULL) {
+            goto oom;
+        }
+        out->columns = columns;
+        b->capacity = capacity;
+    }
+    if ((out->count + 1) * 2 > b->slots) {
+        size_t slots = b->slots * 2;
+        uint32_t* table = calloc(slots, sizeof(*table));
+        if (table == NULL) {
+            goto oom;
+        }
+        for (size_t c = 0; c < out->count; c++) {
+            table_insert(table, slots, out->columns[c].hash, (uint32_t) c);
+        }
+        free(b->table);
+        b->table = table;
+        b->slots = slots;
+    }
+
+    size_t length = ns_length ? ns_length + 1 + local_length : local_length;
+    char* name = malloc(length + 1);
+    if (name == NULL) {
+        goto oom;
+    }
+    if (ns_length) {
+        memcpy(name, ns, ns_length);
+        name[ns_length] = '/';
+    }
+    memcpy(name + length - local_length, local, local_length);
+    name[length] = '\0';
+
+    column_t* column = &out->columns[out->count];
+    memset(column, 0, sizeof(*column));
+    column->name = name;
+    column->ns = ns_length ? name : NULL;
+    column->ns_length = ns_length;
+    column->local = name + length - local_length;
+    column->local_length = local_length;
+    column->hash = hash;
+    table_insert(b->table, b->slots, hash, (uint32_t) out->count);
+    return (uint32_t) out->count++;
+
+oom:
+    set_error(b->result, EDN_ERROR_OUT_OF_MEMORY, "Out of memory", NULL);
+    return COLUMN_SKIP;
+}
+
+/* Split "ns/name" the way the reader splits keywords: at the first '/' */
+static void split_name(const char* name, const char** ns, size_t* ns_length, const char** local,
+                       size_t* local_length) {
+    size_t length = strlen(name);
+    const char* slash = length > 1 ? memchr(name, '/', length - 1) : NULL;
+    if (slash != NULL && slash != name) {
+        *ns = name;
+        *ns_length = (size_t) (slash - name);
+        *local = slash + 1;
+        *local_length = length - *ns_length - 1;
+    } else {
+        *ns = NULL;
+        *ns_length = 0;
+        *local = name;
+        *local_length = length;
+    }
+}
+
+/* Tags are transparent: the value is the form as parsed */
+static const edn_value_t* unwrap(const edn_value_t* value) {
+    while (value->type == EDN_TYPE_TAGGED && value->as.tagged.value != NULL) {
+        value = value->as.tagged.value;
+    }
+    return value;
+}
+
+/* Column type a value needs: EDN_COLUMN_NULL for nil, -1 if none fits */
+static int value_column_type(const edn_value_t* value) {
+    switch (value->type) {
+        case EDN_TYPE_NIL:
+            return EDN_COLUMN_NULL;
+        case EDN_TYPE_BOOL:
+            return EDN_COLUMN_BOOL;
+        case EDN_TYPE_INT:
+            return EDN_COLUMN_INT64;
+        case EDN_TYPE_FLOAT:
+            return EDN_COLUMN_DOUBLE;
+        case EDN_TYPE_STRING:
+            return EDN_COLUMN_STRING;
+        case EDN_TYPE_KEYWORD:
+            return EDN_COLUMN_KEYWORD;
+        default:
+            return -1;
+    }
+}
+
+/* Settle the column type on its first value and allocate its buffers;
+ * false when out of memory */
+static bool allocate_column(column_t* column, edn_column_type_t type, size_t rows) {
+    bool ok;
+    column->type = type;
+    switch (type) {
+        case EDN_COLUMN_BOOL:
+            column->bits = zalloc((rows + 7) / 8, 1);
+            ok = column->bits != NULL;
+            break;
+        case EDN_COLUMN_INT64:
+            column->int64_values = zalloc(rows, sizeof(int64_t));
+            ok = column->int64_values != NULL;
+            break;
+        case EDN_COLUMN_DOUBLE:
+            column->double_values = zalloc(rows, sizeof(double));
+            ok = column->double_values != NULL;
+            break;
+        case EDN_COLUMN_STRING:
+            column->data_capacity = STRING_DATA_INITIAL;
+            column->offsets = malloc((rows + 1) * sizeof(int32_t));
+            column->data = malloc(column->data_capacity);
+            ok = column->offsets != NULL && column->data != NULL;
+            break;
+        default: /* EDN_COLUMN_KEYWORD */
+            column->indices = zalloc(rows, sizeof(int32_t));
+            column->dictionary_capacity = DICTIONARY_INITIAL;
+            column->dictionary_slots = DICTIONARY_INITIAL * 2;
+            column->data_capacity = DICTIONARY_INITIAL * 16;
+            column->offsets = malloc((DICTIONARY_INITIAL + 1) * sizeof(int32_t));
+            column->dictionary_hashes = malloc(DICTIONARY_INITIAL * sizeof(uint32_t));
+            column->dictionary_table = calloc(column->dictionary_slots, sizeof(uint32_t));
+            column->data = malloc(column->data_capacity);
+            ok = column->indices != NULL && column->offsets != NULL &&
+                 column->dictionary_hashes != NULL && column->dictionary_table != NULL &&
+                 column->data != NULL;
+            if (ok) {
+                column->offsets[0] = 0;
+            }
+            break;
+    }
+    /* Dropped at the end if every row turns out to have a value */
+    column->validity = zalloc((rows + 7) / 8, 1);
+    return ok && column->validity != NULL;
+}
+
+/* Make room for `length` more data bytes; false when out of memory or
+ * past what int32_t offsets can address */
+static bool reserve_data(column_t* column, size_t length) {
+    if (column->used + length > INT32_MAX) {
+        return false;
+    }
+    if (column->used + length > column->data_capacity) {
+        size_t capacity = column->data_capacity * 2;
+        while (capacity < column->used + length) {
+            capacity *= 2;
+        }
+        char* data = realloc(column->data, capacity);
+        if (data == NULL) {
+            return false;
+        }
+        column->data = data;
+        column->data_capacity = capacity;
+    }
+    return true;
+}
+
+static bool keyword_text_equals(const char* text, size_t length, const edn_value_t* keyword) {
+    size_t ns_length = keyword->as.keyword.ns_length;
+    size_t name_length = keyword->as.keyword.name_length;
+    if (ns_length == 0) {
+        return length == name_length && memcmp(text, keyword->as.keyword.name, length) == 0;
+    }
+    return length == ns_length + 1 + name_length &&
+           memcmp(text, keyword->as.keyword.namespace, ns_length) == 0 &&
+           text[ns_length] == '/' &&
+           memcmp(text + ns_length + 1, keyword->as.keyword.name, name_length) == 0;
+}
+
+/* Dictionary entry of `keyword`, added if new; -1 when out of memory */
+static int32_t dictionary_index(column_t* column, const edn_value_t* keyword) {
+    const char* ns = keyword->as.keyword.namespace;
+    size_t ns_length = keyword->as.keyword.ns_length;
+    const char* name = keyword->as.keyword.name;
+    size_t name_length = keyword->as.keyword.name_length;
+    uint32_t hash = edn_keyword_hash32(ns, ns_length, name, name_length);
+
+    size_t mask = column->dictionary_slots - 1;
+    size_t i = hash & mask;
+    for (; column->dictionary_table[i] != 0; i = (i + 1) & mask) {
+        uint32_t e = column->dictionary_table[i] - 1;
+        if (column->dictionary_hashes[e] == hash &&
+            keyword_text_equals(column->data + column->offsets[e],
+                                (size_t) (column->offsets[e + 1] - column->offsets[e]),
+                                keyword)) {
+            return (int32_t) e;
+        }
+    }
+
+    size_t length = ns_length ? ns_length + 1 + name_length : name_length;
+    if (column->dictionary_size >= INT32_MAX || !reserve_data(column, length)) {
+        return -1;
+    }
+    if (column->dictionary_size == column->dictionary_capacity) {
+        size_t capacity = column->dictionary_capacity * 2;
+        int32_t* offsets = realloc(column->offsets, (capacity + 1) * sizeof(int32_t));
+        if (offsets != NULL) {
+            column->offsets = offsets;
+        }
+        uint32_t* hashes = realloc(column->dictionary_hashes, capacity * sizeof(uint32_t));
+        if (hashes != NULL) {
+            column->dictionary_hashes = hashes;
+        }
+        uint32_t* table = calloc(capacity * 2, sizeof(uint32_t));
+        if (offsets == NULL || hashes == NULL || table == NULL) {
+            free(table);
+            return -1;
+        }
+        for (size_t e = 0; e < column->dictionary_size; e++) {
+            table_insert(table, capacity * 2, column->dictionary_hashes[e], (uint32_t) e);
+        }
+        free(column->dictionary_table);
+        column->dictionary_table = table;
+        column->dictionary_slots = capacity * 2;
+        column->dictionary_capacity = capacity;
+        mask = column->dictionary_slots - 1;
+        i = hash & mask;
+        while (column->dictionary_table[i] != 0) {
+            i = (i + 1) & mask;
+        }
+    }
+
+    char* text = column->data + column->used;
+    if (ns_length) {
+        memcpy(text, ns, ns_length);
+        text[ns_length] = '/';
+    }
+    memcpy(text + length - name_length, name, name_length);
+    column->used += length;
+
+    size_t e = column->dictionary_size++;
+    column->offsets[e + 1] = (int32_t) column->used;
+    column->dictionary_hashes[e] = hash;
+    column->dictionary_table[i] = (uint32_t) e + 1;
+    return (int32_t) e;
+}
+
+/* Store `value` in row `r` of its column; false with b->result set on failure */
+static bool store_value(builder_t* b, column_t* column, const edn_value_t* value, size_t r) {
+    int type = value_column_type(value);
+    if (type < 0) {
+        set_error(b->result, EDN_ERROR_SCHEMA_MISMATCH, "Value type cannot be stored in a column",
+                  value);
+        return false;
+    }
+    if (type == EDN_COLUMN_NULL) {
+        return true;
+    }
+
+    if (column->type == EDN_COLUMN_NULL) {
+        if (!allocate_column(column, (edn_column_type_t) type, b->out->rows)) {
+            set_error(b->result, EDN_ERROR_OUT_OF_MEMORY, "Out of memory", value);
+            return false;
+        }
+    } else if (column->type == EDN_COLUMN_INT64 && type == EDN_COLUMN_DOUBLE) {
+        /* Same size: rewrite the rows so far as doubles, in place */
+        double* doubles = (double*) (void*) column->int64_values;
+        for (size_t i = 0; i < r; i++) {
+            int64_t n = column->int64_values[i];
+            doubles[i] = (double) n;
+        }
+        column->double_values = doubles;
+        column->int64_values = NULL;
+        column->type = EDN_COLUMN_DOUBLE;
+    } else if (column->type != (edn_column_type_t) type &&
+               !(column->type == EDN_COLUMN_DOUBLE && type == EDN_COLUMN_INT64)) {
+        set_error(b->result, EDN_ERROR_SCHEMA_MISMATCH, "Key holds values of incompatible types",
+                  value);
+        return false;
+    }
+
+    uint8_t bit = (uint8_t) (1u << (r & 7));
+    column->validity[r >> 3] |= bit;
+    column->present++;
+    switch (column->type) {
+        case EDN_COLUMN_BOOL:
+            if (value->as.boolean) {
+                column->bits[r >> 3] |= bit;
+            }
+            break;
+        case EDN_COLUMN_INT64:
+            column->int64_values[r] = value->as.integer;
+            break;
+        case EDN_COLUMN_DOUBLE:
+            column->double_values[r] =
+                value->type == EDN_TYPE_INT ? (double) value->as.integer : value->as.floating;
+            break;
+        case EDN_COLUMN_STRING: {
+            size_t length;
+            const char* text = edn_string_get(value, &length);
+            if (text == NULL) {
+                set_error(b->result, EDN_ERROR_INVALID_STRING, "Invalid string", value);
+                return false;
+            }
+            if (!reserve_data(column, length)) {
+                set_error(b->result, EDN_ERROR_OUT_OF_MEMORY,
+                          "Out of memory (or column data past INT32_MAX bytes)", value);
+                return false;
+            }
+            while (column->offset_row <= r) {
+                column->offsets[column->offset_row++] = (int32_t) column->used;
+            }
+            memcpy(column->data + column->used, text, length);
+            column->used += length;
+            break;
+        }
+        default: { /* EDN_COLUMN_KEYWORD */
+            int32_t index = dictionary_index(column, value);
+            if (index < 0) {
+                set_error(b->result, EDN_ERROR_OUT_OF_MEMORY,
+                          "Out of memory (or column data past INT32_MAX bytes)", value);
+                return false;
+            }
+            column->indices[r] = index;
+            break;
+        }
+    }
+    return true;
+}
+
+static bool convert_rows(builder_t* b, edn_value_t* const* rows, uint32_t* hints,
+                         size_t hint_count) {
+    for (size_t j = 0; j < hint_count; j++) {
+        hints[j] = COLUMN_SKIP;
+    }
+    for (size_t r = 0; r < b->out->rows; r++) {
+        const edn_map_entry_t* entries = rows[r]->as.map.entries;
+        size_t count = rows[r]->as.map.count;
+        for (size_t j = 0; j < count; j++) {
+            const edn_value_t* key = entries[j].key;
+            if (key->type != EDN_TYPE_KEYWORD) {
+                continue;
+            }
+            const char* ns = key->as.keyword.namespace;
+            size_t ns_length = key->as.keyword.ns_length;
+            const char* local = key->as.keyword.name;
+            size_t local_length = key->as.keyword.name_length;
+            uint32_t hash = entries[j].key_hash
+                                ? entries[j].key_hash
+                                : edn_keyword_hash32(ns, ns_length, local, local_length);
+
+            uint32_t c = hints[j];
+            if (c == COLUMN_SKIP || !column_matches(&b->out->columns[c], hash, ns, ns_length,
+                                                    local, local_length)) {
+                c = find_column(b, hash, ns, ns_length, local, local_length);
+                if (c == COLUMN_SKIP && !b->fixed) {
+                    c = add_column(b, hash, ns, ns_length, local, local_length);
+                    if (c == COLUMN_SKIP) {
+                        return false;
+                    }
+                }
+                hints[j] = c;
+                if (c == COLUMN_SKIP) {
+                    continue;
+                }
+            }
+            if (!store_value(b, &b->out->columns[c], unwrap(entries[j].value), r)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void publish_column(column_t* column, size_t rows) {
+    if (column->type == EDN_COLUMN_STRING) {
+        while (column->offset_row <= rows) {
+            column->offsets[column->offset_row++] = (int32_t) column->used;
+        }
+    }
+    if (column->present == rows) {
+        free(column->validity);
+        column->validity = NULL;
+    }
+    edn_column_t* pub = &column->pub;
+    pub->name = column->name;
+    pub->type = column->type;
+    pub->null_count = rows - column->present;
+    pub->validity = column->validity;
+    pub->bits = column->bits;
+    pub->int64_values = column->int64_values;
+    pub->double_values = column->double_values;
+    pub->indices = column->indices;
+    pub->dictionary_size = column->dictionary_size;
+    pub->offsets = column->offsets;
+    pub->data = column->data;
+}
+
+static void free_column(column_t* column) {
+    free(column->name);
+    free(column->validity);
+    free(column->bits);
+    free(column->int64_values);
+    free(column->double_values);
+    free(column->indices);
+    free(column->offsets);
+    free(column->data);
+    free(column->dictionary_hashes);
+    free(column->dictionary_table);
+}
+
+void edn_columns_free(edn_columns_t* columns) {
+    if (columns == NULL) {
+        return;
+    }
+    for (size_t c = 0; c < columns->count; c++) {
+        free_column(&columns->columns[c]);
+    }
+    free(columns->columns);
+    free(columns);
+}
+
+edn_result_t edn_to_columns(const edn_value_t* rows, const edn_columns_options_t* options,
+                            edn_columns_t** out) {
+    edn_result_t result = {0};
+    result.error = EDN_OK;
+    if (out != NULL) {
+        *out = NULL;
+    }
+    if (out == NULL || rows == NULL ||
+        (rows->type != EDN_TYPE_VECTOR && rows->type != EDN_TYPE_LIST)) {
+        set_error(&result, EDN_ERROR_INVALID_ARGUMENT, "Rows must be a vector or list", rows);
+        return result;
+    }
+
+    const char* const* keys = NULL;
+    size_t key_count = 0;
+    if (options != NULL) {
+        size_t sz =
+            options->struct_size == 0 ? sizeof(edn_columns_options_t) : options->struct_size;
+        if (sz >= offsetof(edn_columns_options_t, key_count) + sizeof(options->key_count)) {
+            keys = options->keys;
+            key_count = options->key_count;
+        }
+    }
+
+    edn_value_t* const* elements =
+        rows->type == EDN_TYPE_VECTOR ? rows->as.vector.elements : rows->as.list.elements;
+    size_t row_count = rows->type == EDN_TYPE_VECTOR ? rows->as.vector.count : rows->as.list.count;
+
+    size_t widest = 0;
+    for (size_t r = 0; r < row_count; r++) {
+        if (elements[r]->type != EDN_TYPE_MAP) {
+            set_error(&result, EDN_ERROR_INVALID_ARGUMENT, "Row is not a map", elements[r]);
+            return result;
+        }
+        if (elements[r]->as.map.count > widest) {
+            widest = elements[r]->as.map.count;
+        }
+    }
+
+    builder_t b = {0};
+    b.result = &result;
+    b.slots = COLUMN_TABLE_INITIAL;
+    b.table = calloc(b.slots, sizeof(*b.table));
+    b.out = calloc(1, sizeof(*b.out));
+    uint32_t* hints = malloc((widest ? widest : 1) * sizeof(*hints));
+    bool ok = b.table != NULL && b.out != NULL && hints != NULL;
+    if (!ok) {
+        set_error(&result, EDN_ERROR_OUT_OF_MEMORY, "Out of memory", NULL);
+    }
+    if (b.out != NULL) {
+        b.out->rows = row_count;
+    }
+
+    if (ok && keys != NULL) {
+        b.fixed = true;
+        for (size_t i = 0; ok && i < key_count; i++) {
+            const char *ns, *local;
+            size_t ns_length, local_length;
+            if (keys[i] == NULL) {
+                set_error(&result, EDN_ERROR_INVALID_ARGUMENT, "Key name is NULL", NULL);
+                ok = false;
+                break;
+            }
+            split_name(keys[i], &ns, &ns_length, &local, &local_length);
+            uint32_t hash = edn_keyword_hash32(ns, ns_length, local, local_length);
+            if (find_column(&b, hash, ns, ns_length, local, local_length) != COLUMN_SKIP) {
+                set_error(&result, EDN_ERROR_INVALID_ARGUMENT, "Key is listed twice", NULL);
+                ok = false;
+            } else if (add_column(&b, hash, ns, ns_length, local, local_length) == COLUMN_SKIP) {
+                ok = false;
+            }
+        }
+    }
+
+    ok = ok && convert_rows(&b, elements, hints, widest);
+
+    free(hints);
+    free(b.table);
+    if (!ok) {
+        edn_columns_free(b.out);
+        return result;
+    }
+    for (size_t c = 0; c < b.out->count; c++) {
+        publish_column(&b.out->columns[c], row_count);
+    }
+    *out = b.out;
+    return result;
+}
+
+size_t edn_columns_row_count(const edn_columns_t* columns) {
+    return columns ? columns->rows : 0;
+}
+
+size_t edn_columns_count(const edn_columns_t* columns) {
+    return columns ? columns->count : 0;
+}
+
+const edn_column_t* edn_columns_get(const edn_columns_t* columns, size_t n) {
+    if (columns == NULL || n >= columns->count) {
+        return NULL;
+    }
+    return &columns->columns[n].pub;
+}
+
+const edn_column_t* edn_columns_find(const edn_columns_t* columns, const char* name) {
+    if (columns == NULL || name == NULL) {
+        return NULL;
+    }
+    for (size_t c = 0; c < columns->count; c++) {
+        if (strcmp(columns->columns[c].name, name) == 0) {
+            return &columns->columns[c].pub;
+        }
+    }
+    return NULL;
+}
+
+bool edn_column_is_valid(const edn_column_t* column, size_t row) {
+    if (column == NULL || column->type == EDN_COLUMN_NULL) {
+        return false;
+    }
+    return column->validity == NULL || (column->validity[row >> 3] >> (row & 7)) & 1;
+}
@@ -0,0 +1,1045 @@
+/**
+ * EDN.C - Schema-directed decoding
+ *
+ * Compiles edn_struct_desc_t descriptors into per-struct perfect hash
+ * tables and decodes maps into C structs from edn_parse_events callbacks.
+ * A small stack of frames (one per open struct or array) tracks where the
+ * next value goes; forms that no field asks for are counted and skipped.
+ * Skipped keys are still hashed, so a repeated one is rejected as edn_read
+ * would reject it.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "edn_internal.h"
+
+#define DECODE_MAX_DEPTH 32   /* Frames: nested structs plus arrays */
+#define DECODE_MAX_FIELDS 64  /* Width of the seen/required bitmasks */
+#define DECODE_MAX_SEEDS 256  /* Seeds tried per table size */
+#define DECODE_MAX_TABLE 8192 /* Largest table tried before giving up */
+#define DECODE_INLINE_KEYS 32 /* Skipped-key hashes held before using the heap */
+#define DECODE_INLINE_LEVELS 8 /* Nesting of a hashed collection key before using the heap */
+#define DECODE_LINEAR_DUPS 16 /* Pairwise duplicate check up to this many hashes */
+
+/* Skipped-key hashing follows validate.c: per-kind seeds, lists and
+ * vectors alike, sets and maps combined order-independently */
+#define HASH_PRIME 0x9E3779B97F4A7C15ULL
+#define HASH_NIL 0x6E696CULL
+#define HASH_BOOL 0x626F6F6CULL
+#define HASH_INT 0x696E74ULL
+#define HASH_FLOAT 0x666C74ULL
+#define HASH_STRING 0x737472ULL
+#define HASH_KEYWORD 0x6B6579ULL
+#define HASH_SYMBOL 0x73796DULL
+#define HASH_CHARACTER 0x636872ULL
+#define HASH_BIGINT 0x626967ULL
+#define HASH_BIGDEC 0x646563ULL
+#define HASH_RATIO 0x726174ULL
+#define HASH_SEQUENCE 0x736571ULL
+#define HASH_SET 0x736574ULL
+#define HASH_MAP 0x6D6170ULL
+#define HASH_TAGGED 0x746167ULL
+
+typedef struct decoder_struct {
+    const edn_struct_desc_t* desc;
+    const struct decoder_struct** nested; /* Per field: compiled nested descriptor or NULL */
+    size_t* key_lengths;                  /* Per field */
+    uint8_t* slots;                       /* Hash slot -> field index + 1 (0 = empty) */
+    uint64_t seed;
+    size_t mask;
+    uint64_t required; /* Bit i set when fields[i] is required */
+    size_t depth;      /* Frames needed to decode this struct */
+    bool compiling;    /* Cycle detection during compilation */
+} decoder_struct_t;
+
+struct edn_decoder {
+    decoder_struct_t** structs; /* Every compiled descriptor, root first */
+    size_t count;
+    size_t capacity;
+};
+
+/* FNV-1a over "ns/name" (or "name"), seeded; the final fold mixes high
+ * bits into the low bits used for the table index. */
+static uint64_t key_hash(uint64_t seed, const char* ns, size_t ns_length, const char* name,
+                         size_t name_length) {
+    uint64_t h = 0xcbf29ce484222325ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+    if (ns != NULL) {
+        for (size_t i = 0; i < ns_length; i++) {
+            h = (h ^ (uint8_t) ns[i]) * 0x100000001b3ULL;
+        }
+        h = (h ^ (uint8_t) '/') * 0x100000001b3ULL;
+    }
+    for (size_t i = 0; i < name_length; i++) {
+        h = (h ^ (uint8_t) name[i]) * 0x100000001b3ULL;
+    }
+    return h ^ (h >> 29);
+}
+
+/* `hash` is key_hash() of the key under the schema's seed */
+static const edn_field_desc_t* lookup_field(const decoder_struct_t* schema, uint64_t hash,
+                                            const char* ns, size_t ns_length, const char* name,
+                                            size_t name_length, size_t* index) {
+    uint8_t entry = schema->slots[hash & schema->mask];
+    if (entry == 0) {
+        return NULL;
+    }
+
+    size_t i = entry - 1;
+    const edn_field_desc_t* field = &schema->desc->fields[i];
+    const char* key = field->key;
+    size_t key_length = schema->key_lengths[i];
+    if (ns != NULL) {
+        if (key_length != ns_length + 1 + name_length || memcmp(key, ns, ns_length) != 0 ||
+            key[ns_length] != '/') {
+            return NULL;
+        }
+        key += ns_length + 1;
+    } else if (key_length != name_length) {
+        return NULL;
+    }
+    if (memcmp(key, name, name_length) != 0) {
+        return NULL;
+    }
+
+    *index = i;
+    return field;
+}
+
+/* Find a seed and power-of-two table size with no collisions */
+static bool build_perfect_hash(decoder_struct_t* schema) {
+    size_t n = schema->desc->field_count;
+    size_t size = 1;
+    while (size < n * 2) {
+        size <<= 1;
+    }
+
+    for (; size <= DECODE_MAX_TABLE; size <<= 1) {
+        uint8_t* slots = malloc(size);
+        if (slots == NULL) {
+            return false;
+        }
+
+        for (uint64_t seed = 0; seed < DECODE_MAX_SEEDS; seed++) {
+            memset(slots, 0, size);
+            bool collision = false;
+            for (size_t i = 0; i < n && !collision; i++) {
+                size_t slot = key_hash(seed, NULL, 0, schema->desc->fields[i].key,
+                                       schema->key_lengths[i]) &
+                              (size - 1);
+                if (slots[slot] != 0) {
+                    collision = true;
+                } else {
+                    slots[slot] = (uint8_t) (i + 1);
+                }
+            }
+            if (!collision) {
+                schema->slots = slots;
+                schema->seed = seed;
+                schema->mask = size - 1;
+                return true;
+            }
+        }
+        free(slots);
+    }
+    return false;
+}
+
+static void free_struct(decoder_struct_t* schema) {
+    free(schema->nested);
+    free(schema->key_lengths);
+    free(schema->slots);
+    free(schema);
+}
+
+static bool valid_field_type(edn_field_type_t type) {
+    return type >= EDN_FIELD_BOOL && type <= EDN_FIELD_ARRAY;
+}
+
+static decoder_struct_t* compile_struct(edn_decoder_t* decoder, const edn_struct_desc_t* desc);
+
+/* Validate one field and compile its nested descriptor; *depth gets the frames it needs */
+static bool compile_field(edn_decoder_t* decoder, decoder_struct_t* schema, size_t i,
+                          size_t* depth) {
+    const edn_field_desc_t* field = &schema->desc->fields[i];
+    if (field->key == NULL || field->key[0] == '\0' || !valid_field_type(field->type)) {
+        return false;
+    }
+    schema->key_lengths[i] = strlen(field->key);
+    for (size_t j = 0; j < i; j++) {
+        if (schema->key_lengths[j] == schema->key_lengths[i] &&
+            memcmp(schema->desc->fields[j].key, field->key, schema->key_lengths[i]) == 0) {
+            return false;
+        }
+    }
+    if (field->required) {
+        schema->required |= (uint64_t) 1 << i;
+    }
+
+    edn_field_type_t type = field->type;
+    *depth = 0;
+    if (type == EDN_FIELD_ARRAY) {
+        if (!valid_field_type(field->element_type) || field->element_type == EDN_FIELD_ARRAY ||
+            field->element_size == 0) {
+            return false;
+        }
+        type = field->element_type;
+        *depth = 1;
+    }
+    if (type == EDN_FIELD_STRUCT) {
+        if (field->nested == NULL) {
+            return false;
+        }
+        decoder_struct_t* nested = compile_struct(decoder, field->nested);
+        if (nested == NULL) {
+            return false;
+        }
+        schema->nested[i] = nested;
+        *depth += nested->depth;
+    }
+    return true;
+}
+
+static bool add_struct(edn_decoder_t* decoder, decoder_struct_t* schema) {
+    if (decoder->count == decoder->capacity) {
+        size_t capacity = decoder->capacity ? decoder->capacity * 2 : 4;
+        decoder_struct_t** structs = realloc(decoder->structs, capacity * sizeof(*structs));
+        if (structs == NULL) {
+            return false;
+        }
+        decoder->structs = structs;
+        decoder->capacity = capacity;
+    }
+    decoder->structs[decoder->count++] = schema;
+    return true;
+}
+
+static decoder_struct_t* compile_struct(edn_decoder_t* decoder, const edn_struct_desc_t* desc) {
+    for (size_t i = 0; i < decoder->count; i++) {
+        if (decoder->structs[i]->desc == desc) {
+            /* Still compiling means the descriptor contains itself */
+            return decoder->structs[i]->compiling ? NULL : decoder->structs[i];
+        }
+    }
+
+    if (desc->field_count > DECODE_MAX_FIELDS || (desc->field_count > 0 && !desc->fields)) {
+        return NULL;
+    }
+
+    decoder_struct_t* schema = calloc(1, sizeof(decoder_struct_t));
+    if (schema == NULL) {
+        return NULL;
+    }
+    schema->desc = desc;
+    schema->compiling = true;
+    size_t n = desc->field_count ? desc->field_count : 1;
+    schema->nested = calloc(n, sizeof(*schema->nested));
+    schema->key_lengths = calloc(n, sizeof(size_t));
+    if (schema->nested == NULL || schema->key_lengths == NULL || !add_struct(decoder, schema)) {
+        free_struct(schema);
+        return NULL;
+    }
+
+    /* From here on the decoder owns the schema */
+    size_t depth = 0;
+    for (size_t i = 0; i < desc->field_count; i++) {
+        size_t field_depth;
+        if (!compile_field(decoder, schema, i, &field_depth)) {
+            return NULL;
+        }
+        if (field_depth > depth) {
+            depth = field_depth;
+        }
+    }
+    schema->depth = depth + 1;
+    if (schema->depth > DECODE_MAX_DEPTH || !build_perfect_hash(schema)) {
+        return NULL;
+    }
+
+    schema->compiling = false;
+    return schema;
+}
+
+edn_decoder_t* edn_decoder_create(const edn_struct_desc_t* desc) {
+    if (desc == NULL) {
+        return NULL;
+    }
+
+    edn_decoder_t* decoder = calloc(1, sizeof(edn_decoder_t));
+    if (decoder == NULL) {
+        return NULL;
+    }
+    if (compile_struct(decoder, desc) == NULL) {
+        edn_decoder_destroy(decoder);
+        return NULL;
+    }
+    return decoder;
+}
+
+void edn_decoder_destroy(edn_decoder_t* decoder) {
+    if (decoder == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < decoder->count; i++) {
+        free_struct(decoder->structs[i]);
+    }
+    free(decoder->structs);
+    free(decoder);
+}
+
+/* ========================================================================
+ * Decoding
+ * ======================================================================== */
+
+typedef enum { FRAME_STRUCT, FRAME_ARRAY } frame_kind_t;
+
+typedef struct {
+    frame_kind_t kind;
+    const decoder_struct_t* schema; /* Struct, or array element struct (NULL for scalars) */
+    const edn_field_desc_t* field;  /* Struct: field awaiting its value; array: the array */
+    char* base;                     /* Struct start, or first array element */
+    size_t* count_target;           /* Array only */
+    size_t count;                   /* Array elements stored so far */
+    uint64_t seen;                  /* Struct fields matched so far */
+    size_t key_base;                /* Struct: first of its skipped-key hashes */
+    bool skip_value;                /* Struct: next value belongs to an unknown key */
+} decode_frame_t;
+
+/* An open collection inside a skipped key that is being hashed */
+typedef struct {
+    uint64_t seed;     /* HASH_SEQUENCE, HASH_SET or HASH_MAP */
+    uint64_t combined; /* Element hashes folded so far */
+    uint64_t key;      /* Map: hash of the key awaiting its value */
+    uint64_t tag;      /* Tags read before the collection (0 = none) */
+    size_t count;
+    bool muted; /* Metadata payload: not part of the key's hash */
+} key_level_t;
+
+/* Where the next complete form goes */
+typedef enum {
+    SLOT_FIELD,   /* A struct member or array element */
+    SLOT_KEY,     /* A map key */
+    SLOT_DISCARD, /* Value of an unknown key */
+    SLOT_META     /* Metadata payload; does not occupy the following slot */
+} slot_kind_t;
+
+typedef struct {
+    slot_kind_t kind;
+    edn_field_type_t type;
+    char* target;
+    size_t size;                    /* Target size (string and keyword buffers) */
+    const decoder_struct_t* nested; /* Struct target, or array element struct */
+    const edn_field_desc_t* field;  /* Array target */
+} decode_slot_t;
+
+typedef struct {
+    const decoder_struct_t* root;
+    void* out;
+    decode_frame_t frames[DECODE_MAX_DEPTH];
+    size_t depth;
+    size_t skip;         /* Open collections inside a skipped form */
+    bool skip_is_meta;   /* The skipped form is a metadata payload */
+    size_t pending_meta; /* Metadata payloads before the next form */
+    bool done;           /* Root map decoded */
+    edn_error_t error;
+    const char* error_message;
+
+    uint64_t* keys; /* Skipped-key hashes of the open struct frames */
+    size_t key_count;
+    size_t key_capacity;
+    key_level_t* levels; /* Open collections of the key being hashed (one per skip) */
+    size_t level_count;
+    size_t level_capacity;
+    uint64_t key_tag; /* Tags read before the next hashed form (0 = none) */
+    size_t key_meta;  /* Metadata payloads pending inside the key being hashed */
+    uint64_t inline_keys[DECODE_INLINE_KEYS];
+    key_level_t inline_levels[DECODE_INLINE_LEVELS];
+} decode_state_t;
+
+static int decode_fail(decode_state_t* st, edn_error_t error, const char* message) {
+    st->error = error;
+    st->error_message = message;
+    return 1;
+}
+
+static inline uint64_t hash_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static uint64_t hash_bytes(uint64_t h, const char* data, size_t length) {
+    h = (h ^ length) * HASH_PRIME;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        h = (h ^ word) * HASH_PRIME;
+        h ^= h >> 29;
+        data += 8;
+        length -= 8;
+    }
+    if (length > 0) {
+        uint64_t word = 0;
+        memcpy(&word, data, length);
+        h = (h ^ word) * HASH_PRIME;
+    }
+    return hash_mix(h);
+}
+
+static inline uint64_t hash_int(uint64_t seed, uint64_t value) {
+    return hash_mix(seed ^ (value * HASH_PRIME));
+}
+
+/* Equal doubles hash alike: NaNs and both zeros are folded as in edn_value_equal */
+static uint64_t hash_float(double value) {
+    uint64_t bits;
+    if (isnan(value)) {
+        bits = 0x7FF8000000000000ULL;
+    } else if (value == 0.0) {
+        bits = 0;
+    } else {
+        memcpy(&bits, &value, sizeof(bits));
+    }
+    return hash_int(HASH_FLOAT, bits);
+}
+
+static uint64_t hash_identifier(uint64_t seed, const char* ns, size_t ns_length,
+                                const char* name, size_t name_length) {
+    if (ns != NULL) {
+        seed = hash_bytes(seed, ns, ns_length);
+    }
+    return hash_bytes(seed, name, name_length);
+}
+
+static int compare_hashes(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+/* Sorts the range in place; the caller pops it afterwards */
+static bool has_duplicate_hash(uint64_t* hashes, size_t count) {
+    if (count <= DECODE_LINEAR_DUPS) {
+        for (size_t i = 1; i < count; i++) {
+            for (size_t j = 0; j < i; j++) {
+                if (hashes[i] == hashes[j]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    qsort(hashes, count, sizeof(uint64_t), compare_hashes);
+    for (size_t i = 1; i < count; i++) {
+        if (hashes[i] == hashes[i - 1]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Double a stack that starts in the decode state's inline storage */
+static void* grow_stack(void* items, const void* inline_items, size_t* capacity, size_t count,
+                        size_t size) {
+    size_t grown_capacity = *capacity * 2;
+    void* grown;
+    if (items != inline_items) {
+        grown = realloc(items, grown_capacity * size);
+    } else {
+        grown = malloc(grown_capacity * size);
+        if (grown != NULL) {
+            memcpy(grown, items, count * size);
+        }
+    }
+    if (grown != NULL) {
+        *capacity = grown_capacity;
+    }
+    return grown;
+}
+
+static int next_slot(decode_state_t* st, decode_slot_t* slot) {
+    if (st->pending_meta > 0) {
+        st->pending_meta--;
+        slot->kind = SLOT_META;
+        return 0;
+    }
+
+    if (st->depth == 0) {
+        slot->kind = SLOT_FIELD;
+        slot->type = EDN_FIELD_STRUCT;
+        slot->target = st->out;
+        slot->size = st->root->desc->size;
+        slot->nested = st->root;
+        slot->field = NULL;
+        return 0;
+    }
+
+    decode_frame_t* frame = &st->frames[st->depth - 1];
+    if (frame->kind == FRAME_ARRAY) {
+        const edn_field_desc_t* field = frame->field;
+        if (frame->count == field->size / field->element_size) {
+            return decode_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Array capacity exceeded");
+        }
+        slot->kind = SLOT_FIELD;
+        slot->type = field->element_type;
+        slot->target = frame->base + frame->count * field->element_size;
+        slot->size = field->element_size;
+        slot->nested = frame->schema;
+        slot->field = NULL;
+        return 0;
+    }
+
+    if (frame->skip_value) {
+        slot->kind = SLOT_DISCARD;
+    } else if (frame->field == NULL) {
+        slot->kind = SLOT_KEY;
+    } else {
+        const edn_field_desc_t* field = frame->field;
+        slot->kind = SLOT_FIELD;
+        slot->type = field->type;
+        slot->target = frame->base + field->offset;
+        slot->size = field->size;
+        slot->nested = frame->schema->nested[field - frame->schema->desc->fields];
+        slot->field = field;
+    }
+    return 0;
+}
+
+/* A form completed its slot */
+static void slot_done(decode_state_t* st) {
+    if (st->depth == 0) {
+        st->done = true;
+        return;
+    }
+
+    decode_frame_t* frame = &st->frames[st->depth - 1];
+    if (frame->kind == FRAME_ARRAY) {
+        frame->count++;
+    } else if (frame->field == NULL && !frame->skip_value) {
+        frame->skip_value = true; /* Key that matches no field */
+    } else {
+        frame->field = NULL;
+        frame->skip_value = false;
+    }
+}
+
+/* ------------------------------------------------------------------------
+ * Skipped keys
+ *
+ * A key that matches no field is hashed instead of stored: scalars
+ * directly, collections through one level per open collection (the skip
+ * counter and the level count move together). The finished hash goes on
+ * the enclosing struct frame's range of the key stack, which is checked
+ * for repeats when the map closes.
+ * ------------------------------------------------------------------------ */
+
+/* The next form starts a key of the innermost struct */
+static bool at_key(const decode_state_t* st) {
+    if (st->pending_meta > 0 || st->depth == 0) {
+        return false;
+    }
+    const decode_frame_t* frame = &st->frames[st->depth - 1];
+    return frame->kind == FRAME_STRUCT && frame->field == NULL && !frame->skip_value;
+}
+
+/* A hashed form is complete: fold it into its collection, or record the key */
+static int key_hashed(decode_state_t* st, uint64_t hash) {
+    if (st->level_count > 0) {
+        key_level_t* level = &st->levels[st->level_count - 1];
+        if (level->seed == HASH_SEQUENCE) {
+            level->combined = hash_mix(level->combined ^ hash) * HASH_PRIME;
+        } else if (level->seed == HASH_SET) {
+            level->combined += hash_mix(hash);
+        } else if ((level->count & 1) == 0) {
+            level->key = hash;
+        } else {
+            level->combined += hash_mix(level->key ^ (hash * HASH_PRIME));
+        }
+        level->count++;
+        return 0;
+    }
+
+    if (st->key_count == st->key_capacity) {
+        uint64_t* grown = grow_stack(st->keys, st->inline_keys, &st->key_capacity,
+                                     st->key_count, sizeof(uint64_t));
+        if (grown == NULL) {
+            return decode_fail(st, EDN_ERROR_OUT_OF_MEMORY, "Out of memory checking duplicates");
+        }
+        st->keys = grown;
+    }
+    st->keys[st->key_count++] = hash;
+    slot_done(st); /* The key's value is skipped */
+    return 0;
+}
+
+static int key_scalar(decode_state_t* st, uint64_t hash) {
+    if (st->key_meta > 0) {
+        st->key_meta--;
+        return 0;
+    }
+    if (st->key_tag != 0) {
+        hash = hash_mix(st->key_tag ^ (hash * HASH_PRIME));
+        st->key_tag = 0;
+    }
+    return key_hashed(st, hash);
+}
+
+static int key_begin(decode_state_t* st, uint64_t seed) {
+    if (st->level_count == st->level_capacity) {
+        key_level_t* grown = grow_stack(st->levels, st->inline_levels, &st->level_capacity,
+                                        st->level_count, sizeof(key_level_t));
+        if (grown == NULL) {
+            return decode_fail(st, EDN_ERROR_OUT_OF_MEMORY, "Out of memory checking duplicates");
+        }
+        st->levels = grown;
+    }
+
+    key_level_t* level = &st->levels[st->level_count++];
+    level->seed = seed;
+    level->combined = 0;
+    level->key = 0;
+    level->count = 0;
+    level->muted = st->key_meta > 0;
+    if (level->muted) {
+        st->key_meta--;
+    }
+    /* A payload keeps the tags read before it for the form that follows */
+    level->tag = st->key_tag;
+    st->key_tag = 0;
+    return 0;
+}
+
+static int key_end(decode_state_t* st) {
+    key_level_t* level = &st->levels[--st->level_count];
+    if (level->muted) {
+        st->key_tag = level->tag;
+        return 0;
+    }
+    uint64_t hash = hash_mix(level->seed ^ (level->combined + level->count));
+    if (level->tag != 0) {
+        hash = hash_mix(level->tag ^ (hash * HASH_PRIME));
+    }
+    return key_hashed(st, hash);
+}
+
+/* Common entry for scalar events: 1 = abort, 0 = ignored, 2 = store into
+ * slot, 3 = part of a skipped key */
+static int scalar_slot(decode_state_t* st, decode_slot_t* slot) {
+    if (st->skip > 0) {
+        return st->level_count > 0 ? 3 : 0;
+    }
+    if (next_slot(st, slot) != 0) {
+        return 1;
+    }
+    if (slot->kind == SLOT_META) {
+        return 0;
+    }
+    if (slot->kind == SLOT_KEY) {
+        return 3;
+    }
+    if (slot->kind == SLOT_DISCARD) {
+        slot_done(st);
+        return 0;
+    }
+    return 2;
+}
+
+/* `hash` is only evaluated for a form that is, or is inside, a skipped key */
+#define SCALAR_SLOT(st, slot, hash)                                                            \
+    do {                                                                                       \
+        int r_ = scalar_slot((st), &(slot));                                                   \
+        if (r_ == 3) {                                                                         \
+            return key_scalar((st), (hash));                                                   \
+        }                                                                                      \
+        if (r_ != 2) {                                                                         \
+            return r_;                                                                         \
+        }                                                                                      \
+    } while (0)
+
+static int type_mismatch(decode_state_t* st) {
+    if (st->depth == 0) {
+        return decode_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Expected a map");
+    }
+    return decode_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Value does not match field type");
+}
+
+static int decode_nil(void* ctx) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot, hash_mix(HASH_NIL));
+    if (st->depth == 0) {
+        return type_mismatch(st);
+    }
+    slot_done(st); /* Member stays zeroed */
+    return 0;
+}
+
+static int decode_bool(void* ctx, bool value) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot, hash_mix(HASH_BOOL + value));
+    if (slot.type != EDN_FIELD_BOOL) {
+        return type_mismatch(st);
+    }
+    *(bool*) slot.target = value;
+    slot_done(st);
+    return 0;
+}
+
+static int decode_int(void* ctx, int64_t value) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot, hash_int(HASH_INT, (uint64_t) value));
+    switch (slot.type) {
+        case EDN_FIELD_INT64:
+            memcpy(slot.target, &value, sizeof(value));
+            break;
+        case EDN_FIELD_INT32: {
+            if (value < INT32_MIN || value > INT32_MAX) {
+                return decode_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Integer out of range");
+            }
+            int32_t narrow = (int32_t) value;
+            memcpy(slot.target, &narrow, sizeof(narrow));
+            break;
+        }
+        case EDN_FIELD_DOUBLE: {
+            double d = (double) value;
+            memcpy(slot.target, &d, sizeof(d));
+            break;
+        }
+        default:
+            return type_mismatch(st);
+    }
+    slot_done(st);
+    return 0;
+}
+
+static int decode_double(void* ctx, double value) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot, hash_float(value));
+    if (slot.type != EDN_FIELD_DOUBLE) {
+        return type_mismatch(st);
+    }
+    memcpy(slot.target, &value, sizeof(value));
+    slot_done(st);
+    return 0;
+}
+
+static int decode_string(void* ctx, const char* s, size_t length) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot, hash_bytes(HASH_STRING, s, length));
+    if (slot.type != EDN_FIELD_STRING) {
+        return type_mismatch(st);
+    }
+    if (length >= slot.size) {
+        return decode_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "String too long for field");
+    }
+    memcpy(slot.target, s, length);
+    slot.target[length] = '\0';
+    slot_done(st);
+    return 0;
+}
+
+static int decode_keyword(void* ctx, const char* ns, size_t ns_length, const char* name,
+                          size_t name_length) {
+    decode_state_t* st = ctx;
+    if (st->skip > 0) {
+        if (st->level_count > 0) {
+            return key_scalar(st, hash_identifier(HASH_KEYWORD, ns, ns_length, name, name_length));
+        }
+        return 0;
+    }
+
+    decode_slot_t slot;
+    if (next_slot(st, &slot) != 0) {
+        return 1;
+    }
+
+    if (slot.kind == SLOT_KEY) {
+        decode_frame_t* frame = &st->frames[st->depth - 1];
+        uint64_t hash = key_hash(frame->schema->seed, ns, ns_length, name, name_length);
+        size_t index;
+        const edn_field_desc_t* field =
+            lookup_field(frame->schema, hash, ns, ns_length, name, name_length, &index);
+        if (field == NULL) {
+            /* The lookup hash serves: the frame's other keys share its seed */
+            return key_scalar(st, hash_int(HASH_KEYWORD, hash));
+        }
+        uint64_t bit = (uint64_t) 1 << index;
+        if (frame->seen & bit) {
+            return decode_fail(st, EDN_ERROR_DUPLICATE_KEY, "Duplicate key in map");
+        }
+        frame->seen |= bit;
+        frame->field = field;
+        st->key_tag = 0; /* Tags on a field's key are transparent */
+        return 0;
+    }
+    if (slot.kind == SLOT_META) {
+        return 0;
+    }
+    if (slot.kind == SLOT_DISCARD) {
+        slot_done(st);
+        return 0;
+    }
+
+    if (slot.type != EDN_FIELD_KEYWORD) {
+        return type_mismatch(st);
+    }
+    size_t length = (ns != NULL ? ns_length + 1 : 0) + name_length;
+    if (length >= slot.size) {
+        return decode_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Keyword too long for field");
+    }
+    char* p = slot.target;
+    if (ns != NULL) {
+        memcpy(p, ns, ns_length);
+        p += ns_length;
+        *p++ = '/';
+    }
+    memcpy(p, name, name_length);
+    p[name_length] = '\0';
+    slot_done(st);
+    return 0;
+}
+
+/* Symbols, characters and arbitrary-precision numbers fit no field type */
+static int decode_symbol(void* ctx, const char* ns, size_t ns_length, const char* name,
+                         size_t name_length) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot, hash_identifier(HASH_SYMBOL, ns, ns_length, name, name_length));
+    return type_mismatch(st);
+}
+
+static int decode_character(void* ctx, uint32_t codepoint) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot, hash_int(HASH_CHARACTER, codepoint));
+    return type_mismatch(st);
+}
+
+static int decode_bigint(void* ctx, const char* digits, size_t length, bool negative,
+                         uint8_t radix) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot,
+                hash_bytes(HASH_BIGINT + ((uint64_t) radix << 1) + negative, digits, length));
+    if (slot.type == EDN_FIELD_INT32 || slot.type == EDN_FIELD_INT64) {
+        return decode_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Integer out of range");
+    }
+    return type_mismatch(st);
+}
+
+static int decode_bigdec(void* ctx, const char* digits, size_t length, bool negative) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot, hash_bytes(HASH_BIGDEC + negative, digits, length));
+    return type_mismatch(st);
+}
+
+static int decode_ratio(void* ctx, int64_t numerator, int64_t denominator) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot,
+                hash_int(hash_int(HASH_RATIO, (uint64_t) numerator), (uint64_t) denominator));
+    return type_mismatch(st);
+}
+
+static int decode_bigratio(void* ctx, const char* numerator, size_t numer_length,
+                           bool negative, const char* denominator, size_t denom_length) {
+    decode_state_t* st = ctx;
+    decode_slot_t slot;
+    SCALAR_SLOT(st, slot,
+                hash_bytes(hash_bytes(HASH_RATIO + negative, numerator, numer_length),
+                           denominator, denom_length));
+    return type_mismatch(st);
+}
+
+static int decode_begin(decode_state_t* st, bool is_map, bool is_sequential) {
+    uint64_t seed = is_map ? HASH_MAP : is_sequential ? HASH_SEQUENCE : HASH_SET;
+    if (st->skip > 0) {
+        st->skip++;
+        return st->level_count > 0 ? key_begin(st, seed) : 0;
+    }
+
+    decode_slot_t slot;
+    if (next_slot(st, &slot) != 0) {
+        return 1;
+    }
+    if (slot.kind != SLOT_FIELD) {
+        st->skip = 1;
+        st->skip_is_meta = slot.kind == SLOT_META;
+        return slot.kind == SLOT_KEY ? key_begin(st, seed) : 0;
+    }
+
+    decode_frame_t* frame = &st->frames[st->depth];
+    if (is_map && slot.type == EDN_FIELD_STRUCT) {
+        frame->kind = FRAME_STRUCT;
+        frame->field = NULL;
+        frame->skip_value = false;
+        frame->seen = 0;
+        frame->key_base = st->key_count;
+    } else if (is_sequential && slot.type == EDN_FIELD_ARRAY) {
+        decode_frame_t* owner = &st->frames[st->depth - 1];
+        frame->kind = FRAME_ARRAY;
+        frame->field = slot.field;
+        frame->count = 0;
+        frame->count_target = (size_t*) (owner->base + slot.field->count_offset);
+    } else {
+        return type_mismatch(st);
+    }
+
+    /* The compiled depth bounds the stack: only schema-directed forms push */
+    frame->schema = slot.nested;
+    frame->base = slot.target;
+    st->depth++;
+    return 0;
+}
+
+static int decode_end(decode_state_t* st) {
+    if (st->skip > 0) {
+        st->skip--;
+        if (st->level_count > 0) {
+            return key_end(st);
+        }
+        if (st->skip == 0 && !st->skip_is_meta) {
+            slot_done(st);
+        }
+        return 0;
+    }
+
+    decode_frame_t* frame = &st->frames[st->depth - 1];
+    if (frame->kind == FRAME_STRUCT) {
+        if ((frame->schema->required & ~frame->seen) != 0) {
+            return decode_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Missing required field");
+        }
+        size_t skipped = st->key_count - frame->key_base;
+        if (skipped > 1 && has_duplicate_hash(st->keys + frame->key_base, skipped)) {
+            return decode_fail(st, EDN_ERROR_DUPLICATE_KEY, "Duplicate key in map");
+        }
+        st->key_count = frame->key_base;
+    } else {
+        *frame->count_target = frame->count;
+    }
+    st->depth--;
+    slot_done(st);
+    return 0;
+}
+
+static int decode_begin_list(void* ctx) {
+    return decode_begin(ctx, false, true);
+}
+
+static int decode_begin_vector(void* ctx) {
+    return decode_begin(ctx, false, true);
+}
+
+static int decode_begin_set(void* ctx) {
+    return decode_begin(ctx, false, false);
+}
+
+static int decode_begin_map(void* ctx) {
+    return decode_begin(ctx, true, false);
+}
+
+static int decode_end_collection(void* ctx) {
+    return decode_end(ctx);
+}
+
+static int decode_tag(void* ctx, const char* tag, size_t length) {
+    decode_state_t* st = ctx;
+    if (st->skip > 0 ? st->level_count > 0 : at_key(st)) {
+        st->key_tag = hash_bytes(st->key_tag ^ HASH_TAGGED, tag, length);
+    }
+    return 0;
+}
+
+static int decode_meta(void* ctx) {
+    decode_state_t* st = ctx;
+    if (st->skip == 0) {
+        st->pending_meta++;
+    } else if (st->level_count > 0) {
+        st->key_meta++;
+    }
+    return 0;
+}
+
+static const edn_event_handlers_t decode_handlers = {
+    .on_nil = decode_nil,
+    .on_bool = decode_bool,
+    .on_int = decode_int,
+    .on_double = decode_double,
+    .on_string = decode_string,
+    .on_keyword = decode_keyword,
+    .on_symbol = decode_symbol,
+    .on_character = decode_character,
+    .on_bigint = decode_bigint,
+    .on_bigdec = decode_bigdec,
+    .on_ratio = decode_ratio,
+    .on_bigratio = decode_bigratio,
+    .on_begin_list = decode_begin_list,
+    .on_end_list = decode_end_collection,
+    .on_begin_vector = decode_begin_vector,
+    .on_end_vector = decode_end_collection,
+    .on_begin_set = decode_begin_set,
+    .on_end_set = decode_end_collection,
+    .on_begin_map = decode_begin_map,
+    .on_end_map = decode_end_collection,
+    .on_tag = decode_tag, /* Transparent to fields; part of a skipped key */
+    .on_meta = decode_meta,
+    .decode_strings = true,
+};
+
+edn_result_t edn_decode(const edn_decoder_t* decoder, const char* input, size_t length,
+                        void* out) {
+    edn_result_t result = {0};
+
+    if (decoder == NULL || out == NULL) {
+        result.error = EDN_ERROR_INVALID_ARGUMENT;
+        result.error_message = "Decoder or output is NULL";
+        return result;
+    }
+
+    decode_state_t st;
+    st.root = decoder->structs[0];
+    st.out = out;
+    st.depth = 0;
+    st.skip = 0;
+    st.skip_is_meta = false;
+    st.pending_meta = 0;
+    st.done = false;
+    st.error = EDN_OK;
+    st.error_message = NULL;
+    st.keys = st.inline_keys;
+    st.key_count = 0;
+    st.key_capacity = DECODE_INLINE_KEYS;
+    st.levels = st.inline_levels;
+    st.level_count = 0;
+    st.level_capacity = DECODE_INLINE_LEVELS;
+    st.key_tag = 0;
+    st.key_meta = 0;
+    memset(out, 0, st.root->desc->size);
+
+    result = edn_parse_events(input, length, &decode_handlers, &st);
+    if (st.keys != st.inline_keys) {
+        free(st.keys);
+    }
+    if (st.levels != st.inline_levels) {
+        free(st.levels);
+    }
+    if (result.error == EDN_ERROR_ABORTED && st.error != EDN_OK) {
+        /* Positions already cover the form the decoder rejected */
+        result.error = st.error;
+        result.error_message = st.error_message;
+    } else if (result.error == EDN_OK && !st.done) {
+        result.error = EDN_ERROR_SCHEMA_MISMATCH;
+        result.error_message = "Expected a map";
+    }
+    return result;
+}
@@ -8,14 +8,17 @@ edn_value_t* edn_read_discarded_value(edn_parser_t* parser) {
     const char* start = parser->current;
     parser->current += 2;
 
-    /* Enable discard mode to prevent reader invocation */
+    /* Enable discard mode to prevent reader invocation; a schema does not see the form */
     bool old_discard_mode = parser->discard_mode;
+    struct edn_schema_check* schema = parser->schema;
     parser->discard_mode = true;
+    parser->schema = NULL;
 
     edn_value_t* discarded = edn_read_value(parser);
 
     /* Restore discard mode */
     parser->discard_mode = old_discard_mode;
+    parser->schema = schema;
 
     if (discarded == NULL) {
         /* edn_read_value returns NULL with error==EDN_OK in one other case:
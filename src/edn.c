@@ -29,12 +29,49 @@ static pthread_mutex_t g_external_registry_lock = PTHREAD_MUTEX_INITIALIZER;
 #define EDN_EXT_UNLOCK_READ() ((void) 0)
 #endif
 
+void edn_result_set_error_positions(edn_result_t* result, const edn_parser_t* parser) {
+    edn_arena_t* temp_arena = edn_arena_create();
+    if (temp_arena == NULL) {
+        return;
+    }
+
+    size_t length = parser->end - parser->input;
+    newline_positions_t* positions =
+        newline_find_all_ex(parser->input, length, NEWLINE_MODE_LF, temp_arena);
+    if (positions) {
+        const char* start_ptr = parser->error_start ? parser->error_start : parser->current;
+        size_t start_offset = start_ptr - parser->input;
+        document_position_t start_pos;
+        if (newline_get_position(positions, start_offset, &start_pos)) {
+            result->error_start.offset = start_offset;
+            result->error_start.line = start_pos.line;
+            result->error_start.column = start_pos.column;
+        }
+
+        const char* end_ptr = parser->error_end ? parser->error_end : parser->current;
+        size_t end_offset = end_ptr - parser->input;
+        document_position_t end_pos;
+        if (newline_get_position(positions, end_offset, &end_pos)) {
+            result->error_end.offset = end_offset;
+            result->error_end.line = end_pos.line;
+            result->error_end.column = end_pos.column;
+        }
+    }
+    edn_arena_destroy(temp_arena);
+}
+
 edn_result_t edn_read(const char* input, size_t length) {
     return edn_read_with_options(input, length, NULL);
 }
 
-edn_result_t edn_read_with_options(const char* input, size_t length,
-                                   const edn_parse_options_t* options) {
+/* Parse body shared by edn_read_with_options, edn_read_with_stats and
+ * edn_read_checked. `stats` (instrumented builds only) receives the
+ * hot-path counters, `schema` (or NULL) is checked as the tree is built
+ * and `stopped` is set to where the parse stopped. */
+static edn_result_t read_document(const char* input, size_t length,
+                                  const edn_parse_options_t* options,
+                                  struct edn_parse_stats* stats, struct edn_schema_check* schema,
+                                  const char** stopped) {
     edn_result_t result = {0};
 
     if (!input) {
@@ -48,20 +85,16 @@ edn_result_t edn_read_with_options(const char* input, size_t length,
     }
 
     edn_parser_t parser;
-    parser.input = input;
-    parser.current = input;
-    parser.end = input + length;
-    parser.depth = 0;
-    parser.max_depth = EDN_DEFAULT_MAX_DEPTH;
-    parser.arena = edn_arena_create();
-    parser.error = EDN_OK;
-    parser.error_message = NULL;
-    parser.error_start = NULL;
-    parser.error_end = NULL;
-
-    /* Defaults */
-    parser.reader_registry = NULL;
-    parser.default_reader_mode = EDN_DEFAULT_READER_PASSTHROUGH;
+    edn_parser_init(&parser, input, length);
+    parser.schema = schema;
+#ifdef EDN_ENABLE_INSTRUMENTATION
+    parser.stats = stats;
+#else
+    (void) stats;
+#endif
+
+    edn_arena_config_t arena_config;
+    edn_arena_config_for_input(&arena_config, length);
 
     /* Honor caller-provided fields. struct_size lets us add fields later
      * without breaking older callers: we only read fields the caller's struct
@@ -81,42 +114,52 @@ edn_result_t edn_read_with_options(const char* input, size_t length,
             options->max_depth > 0) {
             parser.max_depth = options->max_depth;
         }
+        if (sz >= offsetof(edn_parse_options_t, strict_utf8) + sizeof(options->strict_utf8)) {
+            parser.strict_utf8 = options->strict_utf8;
+        }
+        if (sz >= offsetof(edn_parse_options_t, arena_max_block) +
+                      sizeof(options->arena_max_block)) {
+            if (options->arena_initial_block > 0) {
+                arena_config.initial_size = options->arena_initial_block;
+            }
+            if (options->arena_max_block > 0) {
+                arena_config.max_block_size = options->arena_max_block;
+            }
+        }
+        if (sz >= offsetof(edn_parse_options_t, arena_huge_pages) +
+                      sizeof(options->arena_huge_pages)) {
+            arena_config.huge_pages = options->arena_huge_pages;
+        }
+        if (sz >= offsetof(edn_parse_options_t, max_memory) + sizeof(options->max_memory)) {
+            arena_config.limit = options->max_memory;
+        }
+        if (sz >= offsetof(edn_parse_options_t, budget) + sizeof(options->budget)) {
+            parser.budget = options->budget;
+        }
     }
 
-    parser.discard_mode = false;
+    /* With a budget the first collection element checks it straight away */
+    parser.budget_checkpoint = parser.budget != NULL ? parser.input : parser.end;
+
+    parser.arena = edn_arena_create_with(&arena_config);
 
     result.value = edn_read_value(&parser);
+    if (result.value != NULL && !edn_schema_form(&parser, result.value)) {
+        result.value = NULL;
+    }
+    free(parser.child_stack);
     result.error = parser.error;
     result.error_message = parser.error_message;
+    if (parser.arena != NULL) {
+        if (result.error == EDN_ERROR_OUT_OF_MEMORY && parser.arena->limit_hit) {
+            result.error_message = "Memory limit exceeded";
+        }
+        parser.arena->limit = 0; /* Lazy readers and decoding may still allocate */
+    }
 
-    /* This needs refactoring? */
     /* Calculate error positions if there was an error */
     if (result.error != EDN_OK) {
-        edn_arena_t* temp_arena = edn_arena_create();
-        if (temp_arena) {
-            newline_positions_t* positions =
-                newline_find_all_ex(input, length, NEWLINE_MODE_LF, temp_arena);
-            if (positions) {
-                const char* start_ptr = parser.error_start ? parser.error_start : parser.current;
-                size_t start_offset = start_ptr - parser.input;
-                document_position_t start_pos;
-                if (newline_get_position(positions, start_offset, &start_pos)) {
-                    result.error_start.offset = start_offset;
-                    result.error_start.line = start_pos.line;
-                    result.error_start.column = start_pos.column;
-                }
-
-                const char* end_ptr = parser.error_end ? parser.error_end : parser.current;
-                size_t end_offset = end_ptr - parser.input;
-                document_position_t end_pos;
-                if (newline_get_position(positions, end_offset, &end_pos)) {
-                    result.error_end.offset = end_offset;
-                    result.error_end.line = end_pos.line;
-                    result.error_end.column = end_pos.column;
-                }
-            }
-            edn_arena_destroy(temp_arena);
-        }
+        edn_result_set_error_positions(&result, &parser);
     }
 
     /* Handle EOF error with eof_value option */
@@ -141,13 +184,65 @@ edn_result_t edn_read_with_options(const char* input, size_t length,
         }
     }
 
+    *stopped = parser.current;
+    return result;
+}
+
+edn_result_t edn_read_with_options(const char* input, size_t length,
+                                   const edn_parse_options_t* options) {
+#ifdef EDN_ENABLE_INSTRUMENTATION
+    return edn_read_with_stats(input, length, options, NULL);
+#else
+    const char* stopped = input;
+    return read_document(input, length, options, NULL, NULL, &stopped);
+#endif
+}
+
+edn_result_t edn_read_checked(const char* input, size_t length, const edn_parse_options_t* options,
+                              struct edn_schema_check* schema) {
+    const char* stopped = input;
+    return read_document(input, length, options, NULL, schema, &stopped);
+}
+
+#ifdef EDN_ENABLE_INSTRUMENTATION
+edn_result_t edn_read_with_stats(const char* input, size_t length,
+                                 const edn_parse_options_t* options, edn_parse_stats_t* stats) {
+    if (input != NULL && length == 0) {
+        length = strlen(input);
+    }
+    edn_trace_parse_begin(input, length);
+
+    uint64_t start = 0;
+    if (stats != NULL) {
+        memset(stats, 0, sizeof(*stats));
+        start = edn_monotonic_ns();
+    }
+
+    const char* stopped = input;
+    edn_result_t result = read_document(input, length, options, stats, NULL, &stopped);
+
+    size_t bytes_scanned = input != NULL ? (size_t) (stopped - input) : 0;
+    if (stats != NULL) {
+        stats->bytes_scanned = bytes_scanned;
+        if (result.error == EDN_OK) {
+            edn_stats_count_tree(result.value, stats);
+        }
+        stats->parse_ns = edn_monotonic_ns() - start;
+    }
+
+    edn_trace_parse_end(input, length, &result, stats, bytes_scanned);
     return result;
 }
+#endif
 
 void edn_free(edn_value_t* value) {
     if (!value || !value->arena) {
         return;
     }
+    if (value->arena->cache_entry != NULL) {
+        edn_parse_cache_release(value->arena->cache_entry);
+        return;
+    }
     edn_arena_destroy(value->arena);
 }
 
@@ -159,10 +254,12 @@ bool edn_source_position(const edn_value_t* value, size_t* start, size_t* end) {
     if (!value) {
         return false;
     }
+    size_t s, e;
+    edn_source_map(value, &s, &e);
     if (start)
-        *start = value->source_start;
+        *start = s;
     if (end)
-        *end = value->source_end;
+        *end = e;
     return true;
 }
 
@@ -1106,7 +1203,7 @@ edn_value_t* edn_map_get_key(const edn_value_t* value, size_t index) {
     if (index >= value->as.map.count) {
         return NULL;
     }
-    return value->as.map.keys[index];
+    return value->as.map.entries[index].key;
 }
 
 edn_value_t* edn_map_get_value(const edn_value_t* value, size_t index) {
@@ -1116,35 +1213,75 @@ edn_value_t* edn_map_get_value(const edn_value_t* value, size_t index) {
     if (index >= value->as.map.count) {
         return NULL;
     }
-    return value->as.map.values[index];
+    return value->as.map.entries[index].value;
 }
 
-edn_value_t* edn_map_lookup(const edn_value_t* value, const edn_value_t* key) {
-    if (!value || value->type != EDN_TYPE_MAP || !key) {
-        return NULL;
-    }
+static bool keyword_matches(const edn_value_t* key, const char* ns, size_t ns_length,
+                            const char* name, size_t name_length) {
+    return key->type == EDN_TYPE_KEYWORD && key->as.keyword.ns_length == ns_length &&
+           key->as.keyword.name_length == name_length &&
+           memcmp(key->as.keyword.name, name, name_length) == 0 &&
+           (ns_length == 0 || memcmp(key->as.keyword.namespace, ns, ns_length) == 0);
+}
 
-    for (size_t i = 0; i < value->as.map.count; i++) {
-        if (edn_value_equal(value->as.map.keys[i], key)) {
-            return value->as.map.values[i];
+/* Keyword lookup over the entry summaries: entries with a different hash
+ * are skipped without loading their key node. Entries without a summary
+ * (non-keyword keys, oversized keywords) are compared through the node. */
+static const edn_map_entry_t* map_find_keyword(const edn_value_t* map, const char* ns,
+                                               size_t ns_length, const char* name,
+                                               size_t name_length) {
+    const edn_map_entry_t* entries = map->as.map.entries;
+    size_t count = map->as.map.count;
+    uint32_t hash = edn_keyword_hash32(ns, ns_length, name, name_length);
+    bool summarized = ns_length <= UINT16_MAX && name_length <= UINT16_MAX;
+
+    for (size_t i = 0; i < count; i++) {
+        const edn_map_entry_t* e = &entries[i];
+        if (e->key_hash == hash) {
+            if (summarized && e->key_ns_length == ns_length &&
+                e->key_name_length == name_length &&
+                keyword_matches(e->key, ns, ns_length, name, name_length)) {
+                return e;
+            }
+        } else if (e->key_hash == 0 && !summarized &&
+                   keyword_matches(e->key, ns, ns_length, name, name_length)) {
+            return e;
         }
     }
+    return NULL;
+}
 
+static const edn_map_entry_t* map_find(const edn_value_t* map, const edn_value_t* key) {
+    if (key->type == EDN_TYPE_KEYWORD) {
+        return map_find_keyword(map, key->as.keyword.namespace, key->as.keyword.ns_length,
+                                key->as.keyword.name, key->as.keyword.name_length);
+    }
+
+    const edn_map_entry_t* entries = map->as.map.entries;
+    for (size_t i = 0; i < map->as.map.count; i++) {
+        /* A summarized entry holds a keyword, which cannot equal `key` */
+        if (entries[i].key_hash == 0 && edn_value_equal(entries[i].key, key)) {
+            return &entries[i];
+        }
+    }
     return NULL;
 }
 
-bool edn_map_contains_key(const edn_value_t* value, const edn_value_t* key) {
+edn_value_t* edn_map_lookup(const edn_value_t* value, const edn_value_t* key) {
     if (!value || value->type != EDN_TYPE_MAP || !key) {
-        return false;
+        return NULL;
     }
 
-    for (size_t i = 0; i < value->as.map.count; i++) {
-        if (edn_value_equal(value->as.map.keys[i], key)) {
-            return true;
-        }
+    const edn_map_entry_t* entry = map_find(value, key);
+    return entry ? entry->value : NULL;
+}
+
+bool edn_map_contains_key(const edn_value_t* value, const edn_value_t* key) {
+    if (!value || value->type != EDN_TYPE_MAP || !key) {
+        return false;
     }
 
-    return false;
+    return map_find(value, key) != NULL;
 }
 
 /* Map Convenience Functions */
@@ -1154,19 +1291,8 @@ edn_value_t* edn_map_get_keyword(const edn_value_t* map, const char* keyword) {
         return NULL;
     }
 
-    edn_value_t temp_key;
-    temp_key.type = EDN_TYPE_KEYWORD;
-    temp_key.as.keyword.namespace = NULL;
-    temp_key.as.keyword.ns_length = 0;
-    temp_key.as.keyword.name = keyword;
-    temp_key.as.keyword.name_length = strlen(keyword);
-    temp_key.arena = NULL;
-    temp_key.cached_hash = 0;
-#ifdef EDN_ENABLE_CLOJURE_EXTENSION
-    temp_key.metadata = NULL;
-#endif
-
-    return edn_map_lookup(map, &temp_key);
+    const edn_map_entry_t* entry = map_find_keyword(map, NULL, 0, keyword, strlen(keyword));
+    return entry ? entry->value : NULL;
 }
 
 edn_value_t* edn_map_get_namespaced_keyword(const edn_value_t* map, const char* namespace,
@@ -1175,19 +1301,9 @@ edn_value_t* edn_map_get_namespaced_keyword(const edn_value_t* map, const char*
         return NULL;
     }
 
-    edn_value_t temp_key;
-    temp_key.type = EDN_TYPE_KEYWORD;
-    temp_key.as.keyword.namespace = namespace;
-    temp_key.as.keyword.ns_length = strlen(namespace);
-    temp_key.as.keyword.name = name;
-    temp_key.as.keyword.name_length = strlen(name);
-    temp_key.arena = NULL;
-    temp_key.cached_hash = 0;
-#ifdef EDN_ENABLE_CLOJURE_EXTENSION
-    temp_key.metadata = NULL;
-#endif
-
-    return edn_map_lookup(map, &temp_key);
+    const edn_map_entry_t* entry =
+        map_find_keyword(map, namespace, strlen(namespace), name, strlen(name));
+    return entry ? entry->value : NULL;
 }
 
 edn_value_t* edn_map_get_string_key(const edn_value_t* map, const char* key) {
@@ -1200,7 +1316,7 @@ edn_value_t* edn_map_get_string_key(const edn_value_t* map, const char* key) {
     size_t key_len = strlen(key);
 
     for (size_t i = 0; i < map->as.map.count; i++) {
-        edn_value_t* candidate = map->as.map.keys[i];
+        edn_value_t* candidate = map->as.map.entries[i].key;
         if (!candidate || candidate->type != EDN_TYPE_STRING) {
             continue;
         }
@@ -1210,7 +1326,7 @@ edn_value_t* edn_map_get_string_key(const edn_value_t* map, const char* key) {
             continue;
         }
         if (cand_len == key_len && memcmp(cand_str, key, key_len) == 0) {
-            return map->as.map.values[i];
+            return map->as.map.entries[i].value;
         }
     }
     return NULL;
@@ -1224,10 +1340,18 @@ bool edn_tagged_get(const edn_value_t* value, const char** tag, size_t* tag_leng
         return false;
     }
 
+    edn_value_t* inner = value->as.tagged.value;
+    if (value->as.tagged.lazy != NULL) {
+        inner = edn_tagged_resolve(value, NULL);
+        if (inner == NULL) {
+            return false;
+        }
+    }
+
     *tag = value->as.tagged.tag;
     if (tag_length)
         *tag_length = value->as.tagged.tag_length;
-    *tagged_value = value->as.tagged.value;
+    *tagged_value = inner;
 
     return true;
 }
@@ -10,6 +10,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "edn.h"
 
@@ -17,6 +18,10 @@
 #define ARENA_INITIAL_SIZE (16 * 1024) /* Start with 16KB for small documents */
 #define ARENA_MEDIUM_SIZE (64 * 1024)  /* 64KB blocks */
 #define ARENA_LARGE_SIZE (256 * 1024)  /* 256KB for large documents */
+#define ARENA_MAX_INITIAL_SIZE (4 * 1024 * 1024) /* Largest estimated first block */
+#define ARENA_MAX_BLOCK_SIZE (64 * 1024 * 1024)  /* Largest estimated growth cap */
+#define ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)   /* Smallest block mapped with huge pages */
+#define ARENA_INPUT_RATIO 4 /* Estimated arena bytes per input byte (typical trees: 1.5-7) */
 
 /* Built-in default max nesting depth used when caller passes 0/NULL options. */
 #define EDN_DEFAULT_MAX_DEPTH 1024u
@@ -29,6 +34,7 @@ typedef struct arena_block {
     struct arena_block* next;
     size_t used;
     size_t capacity;
+    size_t mapped; /* Bytes obtained with mmap, or 0 when the block came from malloc */
 #if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable : 4200)
@@ -43,12 +49,33 @@ typedef struct arena_block {
 struct edn_arena {
     arena_block_t* current;
     arena_block_t* first;
+    arena_block_t* large;  /* Dedicated blocks for large allocations, outside the bump chain */
     size_t next_block_size;
+    size_t growth_start;   /* next_block_size right after creation or reset */
+    size_t max_block_size; /* Growth cap for bump blocks */
     size_t total_allocated;
+    size_t limit;    /* Cap on total_allocated while parsing, or 0 */
+    bool limit_hit;  /* An allocation failed because of the cap */
+    bool huge_pages;
+    /* Parse-cache entry sharing this document (see cache.c), or NULL */
+    struct edn_parse_cache_entry* cache_entry;
+    /* Text edits applied by edn_reparse (see reparse.c); source_epoch counts them */
+    struct edn_source_edit* source_edits;
+    uint32_t source_epoch;
+    uint32_t source_edit_capacity;
+    size_t source_baseline; /* total_allocated before the first edit */
 };
 
 typedef struct edn_arena edn_arena_t;
 
+/* Arena sizing; zero fields take the fixed defaults used by edn_arena_create */
+typedef struct {
+    size_t initial_size;   /* First block (default ARENA_INITIAL_SIZE) */
+    size_t max_block_size; /* Growth cap (default ARENA_LARGE_SIZE) */
+    bool huge_pages;       /* Map blocks of ARENA_HUGE_PAGE_SIZE and more with huge pages */
+    size_t limit;          /* Cap on total block capacity, or 0 for none */
+} edn_arena_config_t;
+
 /**
  * Line terminator detection mode.
  *
@@ -199,15 +226,30 @@ newline_positions_t* newline_positions_create(size_t initial_capacity, edn_arena
 bool newline_get_position(const newline_positions_t* positions, size_t byte_offset,
                           document_position_t* out_position);
 
-/* Map entry structure for key-value pairs */
+/* Map entry: key and value stored side by side, plus an inline summary of
+ * keyword keys so lookups can pass over non-matching entries without
+ * touching the key node. key_hash is edn_keyword_hash32() of a keyword key
+ * whose namespace and name both fit the 16-bit lengths, and 0 for any
+ * other key (which lookups then compare through the node). */
 typedef struct {
     edn_value_t* key;
     edn_value_t* value;
+    uint32_t key_hash;
+    uint16_t key_ns_length;
+    uint16_t key_name_length;
 } edn_map_entry_t;
 
+/* Deferred reader invocation for lazily-read tagged literals (arena-allocated) */
+typedef struct {
+    edn_reader_fn reader;
+    edn_value_t* resolved;     /* Cached reader result (NULL until resolved) */
+    const char* error_message; /* Cached reader failure (NULL if none) */
+} edn_lazy_tagged_t;
+
 /* Internal value structure */
 struct edn_value {
     edn_type_t type;
+    uint32_t source_epoch; /* Edits (arena->source_edits) made before this value was parsed */
     uint64_t cached_hash; /* Cached hash value (0 = not computed yet) */
     size_t source_start;  /* Byte offset where this value started in input */
     size_t source_end;    /* Byte offset where this value ended in input */
@@ -276,8 +318,7 @@ struct edn_value {
             size_t count;
         } vector;
         struct {
-            edn_value_t** keys;
-            edn_value_t** values;
+            edn_map_entry_t* entries;
             size_t count;
         } map;
         struct {
@@ -288,6 +329,7 @@ struct edn_value {
             const char* tag;
             size_t tag_length;
             edn_value_t* value;
+            edn_lazy_tagged_t* lazy; /* Deferred reader state (NULL unless lazy reader) */
         } tagged;
         struct {
             void* data;
@@ -297,6 +339,57 @@ struct edn_value {
     edn_arena_t* arena; /* Arena that owns this value */
 };
 
+/* Length and up to 16 boundary bytes of a keyword part, in O(1) */
+static inline uint64_t edn_keyword_part_fingerprint(const char* s, size_t n) {
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    if (n >= 8) {
+        memcpy(&head, s, 8);
+        memcpy(&tail, s + n - 8, 8);
+    } else if (n >= 4) {
+        uint32_t h32, t32;
+        memcpy(&h32, s, 4);
+        memcpy(&t32, s + n - 4, 4);
+        head = h32;
+        tail = t32;
+    } else if (n > 0) {
+        head = (unsigned char) s[0] | ((uint64_t) (unsigned char) s[n / 2] << 8) |
+               ((uint64_t) (unsigned char) s[n - 1] << 16);
+    }
+    return head ^ (tail * 0x9E3779B97F4A7C15ull) ^ ((uint64_t) n << 56);
+}
+
+/* Keyword summary hash for map entries. Reads a bounded number of bytes so
+ * building a map stays cheap; a collision only costs a full comparison.
+ * Never 0, which marks entries without a summary. */
+static inline uint32_t edn_keyword_hash32(const char* ns, size_t ns_length, const char* name,
+                                          size_t name_length) {
+    uint64_t h = edn_keyword_part_fingerprint(name, name_length) ^
+                 (edn_keyword_part_fingerprint(ns, ns_length) * 0xC2B2AE3D27D4EB4Full);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    uint32_t h32 = (uint32_t) h;
+    return h32 != 0 ? h32 : 1;
+}
+
+static inline void edn_map_entry_init(edn_map_entry_t* entry, edn_value_t* key,
+                                      edn_value_t* value) {
+    entry->key = key;
+    entry->value = value;
+    entry->key_hash = 0;
+    entry->key_ns_length = 0;
+    entry->key_name_length = 0;
+    if (key->type == EDN_TYPE_KEYWORD && key->as.keyword.ns_length <= UINT16_MAX &&
+        key->as.keyword.name_length <= UINT16_MAX) {
+        entry->key_hash =
+            edn_keyword_hash32(key->as.keyword.namespace, key->as.keyword.ns_length,
+                               key->as.keyword.name, key->as.keyword.name_length);
+        entry->key_ns_length = (uint16_t) key->as.keyword.ns_length;
+        entry->key_name_length = (uint16_t) key->as.keyword.name_length;
+    }
+}
+
 /* String packing flags and helper functions */
 #define EDN_STRING_FLAG_HAS_ESCAPES (1ULL << 63)
 #define EDN_STRING_FLAG_IS_DECODED (1ULL << 62)
@@ -340,8 +433,69 @@ typedef struct {
     edn_default_reader_mode_t default_reader_mode;
     /* Discard mode - when true, readers are not invoked */
     bool discard_mode;
+    /* Reject ill-formed UTF-8 in strings and identifiers */
+    bool strict_utf8;
+    /* Children of all open collections, innermost on top (heap, see collection.c) */
+    edn_value_t** child_stack;
+    size_t child_count;
+    size_t child_capacity;
+    /* Cancellation and deadline (NULL = unbounded), checked again once
+     * current reaches budget_checkpoint (see edn_budget_ok) */
+    const edn_budget_t* budget;
+    const char* budget_checkpoint;
+    /* Schema checked while the tree is built (edn_schema_read), or NULL.
+     * Cleared while reading forms the schema does not see: discarded
+     * forms and metadata payloads. */
+    struct edn_schema_check* schema;
+#ifdef EDN_ENABLE_INSTRUMENTATION
+    edn_parse_stats_t* stats; /* Counters to update, or NULL */
+#endif
 } edn_parser_t;
 
+/* Reset every field of *parser to parse [input, input + length) with default
+ * options: no readers, no budget, default depth limit, empty child stack.
+ * The arena is left NULL for the caller to set; the caller frees
+ * child_stack when done. */
+static inline void edn_parser_init(edn_parser_t* parser, const char* input, size_t length) {
+    parser->input = input;
+    parser->current = input;
+    parser->end = input + length;
+    parser->depth = 0;
+    parser->max_depth = EDN_DEFAULT_MAX_DEPTH;
+    parser->arena = NULL;
+    parser->error = EDN_OK;
+    parser->error_message = NULL;
+    parser->error_start = NULL;
+    parser->error_end = NULL;
+    parser->reader_registry = NULL;
+    parser->default_reader_mode = EDN_DEFAULT_READER_PASSTHROUGH;
+    parser->discard_mode = false;
+    parser->strict_utf8 = false;
+    parser->child_stack = NULL;
+    parser->child_count = 0;
+    parser->child_capacity = 0;
+    parser->budget = NULL;
+    parser->budget_checkpoint = parser->end;
+    parser->schema = NULL;
+#ifdef EDN_ENABLE_INSTRUMENTATION
+    parser->stats = NULL;
+#endif
+}
+
+struct edn_parse_stats; /* Opaque unless EDN_ENABLE_INSTRUMENTATION */
+
+/* Hot-path counters: compiled out without EDN_ENABLE_INSTRUMENTATION */
+#ifdef EDN_ENABLE_INSTRUMENTATION
+#define EDN_STATS_INC(parser, field)   \
+    do {                               \
+        if ((parser)->stats != NULL) { \
+            (parser)->stats->field++;  \
+        }                              \
+    } while (0)
+#else
+#define EDN_STATS_INC(parser, field) ((void) (parser))
+#endif
+
 /**
  * Set parser error state in one call.
  *
@@ -381,6 +535,54 @@ static inline bool edn_enter_depth(edn_parser_t* parser) {
     return true;
 }
 
+/* Bytes between budget checks when edn_budget_t.slice_bytes is 0 */
+#define EDN_DEFAULT_BUDGET_SLICE (64u * 1024u)
+
+/* EDN_OK, or the error a budget asks to stop with at `progress` bytes */
+edn_error_t edn_budget_poll(const edn_budget_t* budget, size_t progress);
+size_t edn_budget_slice(const edn_budget_t* budget);
+bool edn_budget_check(edn_parser_t* parser);
+
+/* Called by collection parsers before each element. Without a budget the
+ * checkpoint is the end of input, so this is one compare per element. */
+static inline bool edn_budget_ok(edn_parser_t* parser) {
+    if (parser->current < parser->budget_checkpoint) {
+        return true;
+    }
+    return edn_budget_check(parser);
+}
+
+/* Schema hooks (schema.c). Each returns false with the parser error set
+ * at the offending form. Collection parsers call edn_schema_begin after
+ * the opening delimiter, edn_schema_element for each element (and map
+ * key) as soon as it is read, and edn_schema_end after the closing one.
+ * Forms that are not collections are checked from their built value;
+ * edn_schema_form does that for a tagged literal's form, before any
+ * reader replaces it. */
+bool edn_schema_check_begin(edn_parser_t* parser, edn_type_t type, const char* start);
+bool edn_schema_check_end(edn_parser_t* parser, const char* start);
+bool edn_schema_check_form(edn_parser_t* parser, const edn_value_t* value, bool element);
+
+/* Parse like edn_read_with_options, checking `schema` as the tree is built */
+edn_result_t edn_read_checked(const char* input, size_t length, const edn_parse_options_t* options,
+                              struct edn_schema_check* schema);
+
+static inline bool edn_schema_begin(edn_parser_t* parser, edn_type_t type, const char* start) {
+    return parser->schema == NULL || edn_schema_check_begin(parser, type, start);
+}
+
+static inline bool edn_schema_end(edn_parser_t* parser, const char* start) {
+    return parser->schema == NULL || edn_schema_check_end(parser, start);
+}
+
+static inline bool edn_schema_element(edn_parser_t* parser, const edn_value_t* value) {
+    return parser->schema == NULL || edn_schema_check_form(parser, value, true);
+}
+
+static inline bool edn_schema_form(edn_parser_t* parser, const edn_value_t* value) {
+    return parser->schema == NULL || edn_schema_check_form(parser, value, false);
+}
+
 static inline void edn_leave_depth(edn_parser_t* parser) {
     if (parser->depth > 0) {
         parser->depth--;
@@ -388,12 +590,24 @@ static inline void edn_leave_depth(edn_parser_t* parser) {
 }
 
 edn_arena_t* edn_arena_create(void);
+edn_arena_t* edn_arena_create_with(const edn_arena_config_t* config);
+/* Size the first block and growth cap from the length of the input to be parsed */
+void edn_arena_config_for_input(edn_arena_config_t* config, size_t input_length);
 void edn_arena_destroy(edn_arena_t* arena);
+/* Set up `arena` in caller storage with `buffer` (at least 8-byte aligned and larger
+ * than an arena_block_t) as its first block; later blocks come from the heap.
+ * Undo with edn_arena_release, never edn_arena_destroy. */
+void edn_arena_init_with_buffer(edn_arena_t* arena, void* buffer, size_t size);
+/* Free the heap blocks of an arena set up by edn_arena_init_with_buffer */
+void edn_arena_release(edn_arena_t* arena);
 void* edn_arena_alloc(edn_arena_t* arena, size_t size);
+/* Drop every allocation, keeping the first block for reuse */
+void edn_arena_reset(edn_arena_t* arena);
 
 static inline edn_value_t* edn_arena_alloc_value(edn_arena_t* arena) {
     edn_value_t* value = (edn_value_t*) edn_arena_alloc(arena, sizeof(edn_value_t));
     if (value) {
+        value->source_epoch = 0;
         value->cached_hash = 0;
         value->source_start = 0;
         value->source_end = 0;
@@ -490,14 +704,49 @@ static inline bool is_delimiter(unsigned char c) {
 bool edn_skip_whitespace(edn_parser_t* parser);
 edn_value_t* edn_read_value(edn_parser_t* parser);
 
+/* Translate parser->error_start/error_end into line/column positions on `result` */
+void edn_result_set_error_positions(edn_result_t* result, const edn_parser_t* parser);
+
 const char* edn_simd_skip_whitespace(const char* ptr, const char* end);
 const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_backslash);
+/* As edn_simd_find_quote; *out_non_ascii is set if a byte >= 0x80 was seen. It
+ * may also cover a few bytes past the quote, so callers validate the exact range. */
+const char* edn_simd_find_quote_utf8(const char* ptr, const char* end, bool* out_has_backslash,
+                                     bool* out_non_ascii);
+/* Start of the first ill-formed UTF-8 sequence in [ptr, end), or end if none */
+const char* edn_simd_validate_utf8(const char* ptr, const char* end);
+
+/* Strict-mode check of [start, end); on failure sets the error at the bad sequence */
+static inline bool edn_check_utf8(edn_parser_t* parser, const char* start, const char* end,
+                                  edn_error_t code, const char* message) {
+    if (end - start < 16) {
+        /* Short ranges, typically identifiers: settle the ASCII case inline */
+        unsigned char high = 0;
+        for (const char* p = start; p < end; p++) {
+            high |= (unsigned char) *p;
+        }
+        if ((high & 0x80) == 0) {
+            return true;
+        }
+    }
+    const char* bad = edn_simd_validate_utf8(start, end);
+    if (bad != end) {
+        edn_parser_set_error(parser, code, message, bad, bad + 1);
+        return false;
+    }
+    return true;
+}
 
 /* String parsing functions */
 char* edn_decode_string(edn_arena_t* arena, const char* data, size_t length);
 edn_value_t* edn_read_string(edn_parser_t* parser);
 
 /* Number parsing functions */
+
+/* Clinger fast path shared by the tree and validation parsers; false when
+ * the exponent or mantissa is out of its exact range */
+bool edn_parse_double_fast(int64_t mantissa, int64_t exponent, bool negative, double* out);
+
 typedef enum {
     EDN_NUMBER_INT64,  /* Fits in int64_t */
     EDN_NUMBER_BIGINT, /* Overflow, needs BigInt */
@@ -533,6 +782,18 @@ typedef struct {
 } edn_identifier_scan_result_t;
 
 edn_identifier_scan_result_t edn_simd_scan_identifier(const char* ptr, const char* end);
+
+/* Identifier classified without allocating; namespace and name point into the input */
+typedef struct {
+    edn_type_t type; /* EDN_TYPE_NIL, _BOOL, _SYMBOL or _KEYWORD */
+    bool boolean;
+    const char* namespace; /* NULL if not namespaced */
+    size_t ns_length;
+    const char* name;
+    size_t name_length;
+} edn_identifier_token_t;
+
+bool edn_scan_identifier_token(edn_parser_t* parser, edn_identifier_token_t* token);
 edn_value_t* edn_read_identifier(edn_parser_t* parser);
 
 /* Symbolic value parsing function */
@@ -543,9 +804,28 @@ bool edn_value_equal(const edn_value_t* a, const edn_value_t* b);
 int edn_value_compare(const void* a, const void* b);
 uint64_t edn_value_hash(const edn_value_t* value);
 
+/* Drop one reference to a parse-cache entry (edn_free on a cached document) */
+void edn_parse_cache_release(struct edn_parse_cache_entry* entry);
+
+/* Source offsets of `value` in the text of the latest edn_reparse (reparse.c) */
+void edn_source_map(const edn_value_t* value, size_t* start, size_t* end);
+
 /* Uniqueness checking (for sets and maps) */
 bool edn_has_duplicates(edn_value_t** elements, size_t count);
 
+#ifdef EDN_ENABLE_INSTRUMENTATION
+/* Strategy edn_has_duplicates uses for `count` elements */
+edn_duplicate_tier_t edn_duplicates_tier(size_t count);
+
+/* Fill the tree-shape counters and arena_blocks of `stats` from a parsed value */
+void edn_stats_count_tree(const edn_value_t* value, edn_parse_stats_t* stats);
+
+/* Trace points around edn_read* calls: USDT probes and the trace hook */
+void edn_trace_parse_begin(const char* input, size_t length);
+void edn_trace_parse_end(const char* input, size_t length, const edn_result_t* result,
+                         const edn_parse_stats_t* stats, size_t bytes_scanned);
+#endif
+
 /* Collection parsers */
 edn_value_t* edn_read_list(edn_parser_t* parser);
 edn_value_t* edn_read_vector(edn_parser_t* parser);
@@ -558,14 +838,43 @@ edn_value_t* edn_read_tagged(edn_parser_t* parser);
 /* Discard reader macro parser */
 edn_value_t* edn_read_discarded_value(edn_parser_t* parser);
 
+/* Structural skipper (skip.c): finds the extent of the next form without
+ * building values. EDN_SKIP_CLOSE means a closing delimiter or EOF was hit
+ * before any form; parser->current is left on it. */
+typedef enum { EDN_SKIP_OK, EDN_SKIP_CLOSE, EDN_SKIP_ERROR } edn_skip_result_t;
+edn_skip_result_t edn_skip_value(edn_parser_t* parser, const char** out_start);
+
+/* Registry entry as seen by the parser: at most one of reader/raw_reader is set */
+typedef struct {
+    edn_reader_fn reader;
+    edn_raw_reader_fn raw_reader;
+    bool lazy; /* Defer reader until edn_tagged_resolve()/edn_tagged_get() */
+} edn_reader_binding_t;
+
 /* Internal reader lookup (for non-null-terminated tag strings) */
-edn_reader_fn edn_reader_lookup_internal(const edn_reader_registry_t* registry, const char* tag,
-                                         size_t tag_length);
+bool edn_reader_lookup_internal(const edn_reader_registry_t* registry, const char* tag,
+                                size_t tag_length, edn_reader_binding_t* out);
+
+/* Changes whenever a reader is registered or unregistered; unique across
+ * registries (0 for NULL) */
+uint64_t edn_reader_registry_generation(const edn_reader_registry_t* registry);
 
 /* External type equality/hash lookup (for use by equality.c) */
 edn_external_equal_fn edn_external_lookup_equal(uint32_t type_id);
 edn_external_hash_fn edn_external_lookup_hash(uint32_t type_id);
 
+/* Built-in #inst/#uuid parsing and formatting (builtin_readers.c) */
+#define EDN_INST_FORMAT_MAX 35 /* YYYY-MM-DDThh:mm:ss.fffffffff+hh:mm */
+#define EDN_UUID_FORMAT_LEN 36
+/* Buffer size for either format (neither writes a terminator) */
+#define EDN_BUILTIN_FORMAT_MAX \
+    (EDN_INST_FORMAT_MAX > EDN_UUID_FORMAT_LEN ? EDN_INST_FORMAT_MAX : EDN_UUID_FORMAT_LEN)
+const char* edn_inst_parse(const char* s, size_t len, int64_t* out_epoch_ns,
+                           int32_t* out_offset_minutes);
+size_t edn_inst_format(int64_t epoch_ns, int32_t offset_minutes, char* buf);
+const char* edn_uuid_parse(const char* s, size_t len, uint8_t out[16]);
+size_t edn_uuid_format(const uint8_t bytes[16], char* buf);
+
 /* Namespaced map parser (Clojure extension, requires EDN_ENABLE_CLOJURE_EXTENSION) */
 #ifdef EDN_ENABLE_CLOJURE_EXTENSION
 edn_value_t* edn_read_namespaced_map(edn_parser_t* parser);
@@ -574,6 +883,11 @@ edn_value_t* edn_read_namespaced_map(edn_parser_t* parser);
 /* Metadata parser (Clojure extension, requires EDN_ENABLE_CLOJURE_EXTENSION) */
 #ifdef EDN_ENABLE_CLOJURE_EXTENSION
 edn_value_t* edn_read_metadata(edn_parser_t* parser);
+
+/* Normalize a metadata form (map, keyword, string, symbol or vector) and
+ * merge it into form->metadata, new keys winning. Returns NULL on success
+ * or an out-of-memory message. */
+const char* edn_metadata_attach(edn_arena_t* arena, edn_value_t* meta_value, edn_value_t* form);
 #endif
 
 /* Text block parser (experimental, requires EDN_ENABLE_EXPERIMENTAL_EXTENSION) */
@@ -50,6 +50,20 @@ static inline uint64_t edn_value_get_hash(edn_value_t* value) {
     return value->cached_hash;
 }
 
+/**
+ * Hash of a child value for its parent's hash, without writing any cache.
+ *
+ * Reuses the child's cached hash when it is known to equal the uncached one
+ * (a cached 1 may stand for 0), so hashing a tree bottom-up, as the parse
+ * cache does when freezing, stays linear.
+ */
+static inline uint64_t edn_value_child_hash(const edn_value_t* value) {
+    if (value != NULL && value->cached_hash > 1) {
+        return value->cached_hash;
+    }
+    return edn_value_hash_internal(value);
+}
+
 static bool edn_value_equal_internal(const edn_value_t* a, const edn_value_t* b, int depth) {
     if (a == b) {
         return true;
@@ -272,14 +286,19 @@ static bool edn_value_equal_internal(const edn_value_t* a, const edn_value_t* b,
 
             size_t count = a->as.map.count;
 
+            const edn_map_entry_t* entries_b = b->as.map.entries;
+
             for (size_t i = 0; i < count; i++) {
-                edn_value_t* key_a = a->as.map.keys[i];
-                edn_value_t* val_a = a->as.map.values[i];
+                const edn_map_entry_t* ea = &a->as.map.entries[i];
 
                 bool found = false;
                 for (size_t j = 0; j < count; j++) {
-                    if (edn_value_equal_internal(key_a, b->as.map.keys[j], depth + 1)) {
-                        if (!edn_value_equal_internal(val_a, b->as.map.values[j], depth + 1)) {
+                    /* Differing summaries mean differing keys */
+                    if (entries_b[j].key_hash != ea->key_hash) {
+                        continue;
+                    }
+                    if (edn_value_equal_internal(ea->key, entries_b[j].key, depth + 1)) {
+                        if (!edn_value_equal_internal(ea->value, entries_b[j].value, depth + 1)) {
                             return false;
                         }
                         found = true;
@@ -309,6 +328,16 @@ static bool edn_value_equal_internal(const edn_value_t* a, const edn_value_t* b,
                 return false;
             }
 
+            /* Built-in #inst compares by instant (offset ignored), #uuid by bytes */
+            if (a->as.external.type_id == EDN_EXTERNAL_TYPE_INST) {
+                const edn_inst_data_t* ia = a->as.external.data;
+                const edn_inst_data_t* ib = b->as.external.data;
+                return ia->epoch_ns == ib->epoch_ns;
+            }
+            if (a->as.external.type_id == EDN_EXTERNAL_TYPE_UUID) {
+                return memcmp(a->as.external.data, b->as.external.data, EDN_UUID_SIZE) == 0;
+            }
+
             edn_external_equal_fn equal_fn = edn_external_lookup_equal(a->as.external.type_id);
             if (equal_fn) {
                 return equal_fn(a->as.external.data, b->as.external.data);
@@ -701,7 +730,7 @@ static uint64_t edn_value_hash_internal(const edn_value_t* value) {
             edn_value_t** elements = value->as.list.elements;
 
             for (size_t i = 0; i < count; i++) {
-                uint64_t elem_hash = edn_value_hash_internal(elements[i]);
+                uint64_t elem_hash = edn_value_child_hash(elements[i]);
                 hash ^= elem_hash;
                 hash *= FNV_PRIME;
             }
@@ -713,7 +742,7 @@ static uint64_t edn_value_hash_internal(const edn_value_t* value) {
             size_t count = value->as.set.count;
 
             for (size_t i = 0; i < count; i++) {
-                uint64_t elem_hash = edn_value_hash_internal(value->as.set.elements[i]);
+                uint64_t elem_hash = edn_value_child_hash(value->as.set.elements[i]);
                 set_hash ^= elem_hash;
             }
             hash ^= set_hash;
@@ -724,8 +753,8 @@ static uint64_t edn_value_hash_internal(const edn_value_t* value) {
         case EDN_TYPE_MAP: {
             uint64_t map_hash = 0;
             for (size_t i = 0; i < value->as.map.count; i++) {
-                uint64_t key_hash = edn_value_hash_internal(value->as.map.keys[i]);
-                uint64_t val_hash = edn_value_hash_internal(value->as.map.values[i]);
+                uint64_t key_hash = edn_value_child_hash(value->as.map.entries[i].key);
+                uint64_t val_hash = edn_value_child_hash(value->as.map.entries[i].value);
                 uint64_t pair_hash = key_hash ^ (val_hash * FNV_PRIME);
                 map_hash ^= pair_hash;
             }
@@ -739,7 +768,7 @@ static uint64_t edn_value_hash_internal(const edn_value_t* value) {
                 hash ^= (uint8_t) value->as.tagged.tag[i];
                 hash *= FNV_PRIME;
             }
-            hash ^= edn_value_hash_internal(value->as.tagged.value);
+            hash ^= edn_value_child_hash(value->as.tagged.value);
             hash *= FNV_PRIME;
             break;
 
@@ -748,7 +777,20 @@ static uint64_t edn_value_hash_internal(const edn_value_t* value) {
             hash *= FNV_PRIME;
 
             edn_external_hash_fn hash_fn = edn_external_lookup_hash(value->as.external.type_id);
-            if (hash_fn) {
+            if (value->as.external.type_id == EDN_EXTERNAL_TYPE_INST) {
+                const edn_inst_data_t* inst = value->as.external.data;
+                uint64_t ns = (uint64_t) inst->epoch_ns;
+                for (size_t i = 0; i < sizeof(ns); i++) {
+                    hash ^= (ns >> (i * 8)) & 0xFF;
+                    hash *= FNV_PRIME;
+                }
+            } else if (value->as.external.type_id == EDN_EXTERNAL_TYPE_UUID) {
+                const uint8_t* bytes = value->as.external.data;
+                for (size_t i = 0; i < EDN_UUID_SIZE; i++) {
+                    hash ^= bytes[i];
+                    hash *= FNV_PRIME;
+                }
+            } else if (hash_fn) {
                 hash ^= hash_fn(value->as.external.data);
                 hash *= FNV_PRIME;
             } else {
@@ -0,0 +1,602 @@
+/**
+ * EDN.C - Event (SAX-style) parser
+ *
+ * Walks the input with the same scanners and validation rules as the tree
+ * parser, but reports each form to caller-supplied callbacks instead of
+ * linking values into a tree. Scalars are read into a scratch arena that is
+ * reset after every event. Its first block lives on the stack, so a parse only
+ * touches the heap for a scalar too large for it.
+ */
+
+#include <string.h>
+
+#include "edn_internal.h"
+
+/* parse_form() results besides an edn_type_t */
+#define EVENT_CLOSE (-1) /* Closing delimiter reached; parser->current is on it */
+#define EVENT_ERROR (-2) /* parser->error is set */
+
+#define EVENTS_INLINE_SCRATCH 4096 /* Bytes of stack scratch before heap blocks */
+
+typedef struct {
+    edn_parser_t parser; /* parser.arena is the per-scalar scratch arena */
+    const edn_event_handlers_t* handlers;
+    void* ctx;
+    size_t muted;       /* Number of enclosing #_ forms (events suppressed while > 0) */
+    const char* key_ns; /* Namespace for the next map key (namespaced maps only) */
+    size_t key_ns_length;
+} event_state_t;
+
+typedef struct {
+    char close;
+    const char* unterminated;
+    const char* mismatched;
+} collection_syntax_t;
+
+static const collection_syntax_t LIST_SYNTAX = {')', "Unterminated list (missing ')')",
+                                                "Mismatched closing delimiter in list"};
+static const collection_syntax_t VECTOR_SYNTAX = {']', "Unterminated vector (missing ']')",
+                                                  "Mismatched closing delimiter in vector"};
+static const collection_syntax_t SET_SYNTAX = {'}', "Unterminated set (missing '}')",
+                                               "Mismatched closing delimiter in set"};
+static const collection_syntax_t MAP_SYNTAX = {'}', "Unterminated map (missing '}')",
+                                               "Mismatched closing delimiter in map"};
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+static const collection_syntax_t NS_MAP_SYNTAX = {
+    '}', "Unterminated namespaced map (missing '}')",
+    "Mismatched closing delimiter in namespaced map"};
+#endif
+
+static int event_abort(event_state_t* st, const char* start) {
+    edn_parser_set_error(&st->parser, EDN_ERROR_ABORTED, "Event handler aborted parsing", start,
+                         st->parser.current);
+    return EVENT_ERROR;
+}
+
+/* Deliver an event unless muted or unhandled; a nonzero callback result aborts */
+#define FIRE(st, start, fn, args)                                                               \
+    do {                                                                                        \
+        if ((st)->muted == 0 && (st)->handlers->fn != NULL && (st)->handlers->fn args != 0) {   \
+            return event_abort((st), (start));                                                  \
+        }                                                                                       \
+    } while (0)
+
+static int parse_form(event_state_t* st);
+
+static int fire_begin(event_state_t* st, edn_type_t kind, const char* start) {
+    switch (kind) {
+        case EDN_TYPE_LIST:
+            FIRE(st, start, on_begin_list, (st->ctx));
+            break;
+        case EDN_TYPE_VECTOR:
+            FIRE(st, start, on_begin_vector, (st->ctx));
+            break;
+        case EDN_TYPE_SET:
+            FIRE(st, start, on_begin_set, (st->ctx));
+            break;
+        default:
+            FIRE(st, start, on_begin_map, (st->ctx));
+            break;
+    }
+    return 0;
+}
+
+static int fire_end(event_state_t* st, edn_type_t kind, const char* start) {
+    switch (kind) {
+        case EDN_TYPE_LIST:
+            FIRE(st, start, on_end_list, (st->ctx));
+            break;
+        case EDN_TYPE_VECTOR:
+            FIRE(st, start, on_end_vector, (st->ctx));
+            break;
+        case EDN_TYPE_SET:
+            FIRE(st, start, on_end_set, (st->ctx));
+            break;
+        default:
+            FIRE(st, start, on_end_map, (st->ctx));
+            break;
+    }
+    return 0;
+}
+
+static int fire_string(event_state_t* st, const edn_value_t* value, const char* start) {
+    edn_parser_t* parser = &st->parser;
+    const char* s = value->as.string.decoded; /* Text blocks arrive pre-decoded */
+    size_t length;
+
+    if (s == NULL && (!edn_string_has_escapes(value) || !st->handlers->decode_strings)) {
+        s = value->as.string.data;
+        length = edn_string_get_length(value);
+    } else {
+        if (s == NULL) {
+            s = edn_decode_string(parser->arena, value->as.string.data,
+                                  edn_string_get_length(value));
+            if (s == NULL) {
+                edn_parser_set_error(parser, EDN_ERROR_INVALID_STRING,
+                                     "Invalid escape sequence in string", start, parser->current);
+                return EVENT_ERROR;
+            }
+        }
+        length = strlen(s);
+    }
+
+    FIRE(st, start, on_string, (st->ctx, s, length));
+    return 0;
+}
+
+/* Report a scalar read by one of the tree scanners, then recycle the scratch
+ * arena. `map_ns` is the enclosing namespaced map's namespace when the
+ * scalar is in key position. */
+static int event_scalar(event_state_t* st, const edn_value_t* value, const char* start,
+                        const char* map_ns, size_t map_ns_length) {
+    edn_parser_t* parser = &st->parser;
+    const edn_event_handlers_t* h = st->handlers;
+
+    if (value == NULL) {
+        return EVENT_ERROR; /* Error already set */
+    }
+
+    edn_type_t kind = value->type;
+    switch (kind) {
+        case EDN_TYPE_NIL:
+            FIRE(st, start, on_nil, (st->ctx));
+            break;
+
+        case EDN_TYPE_BOOL:
+            FIRE(st, start, on_bool, (st->ctx, value->as.boolean));
+            break;
+
+        case EDN_TYPE_INT:
+            FIRE(st, start, on_int, (st->ctx, value->as.integer));
+            break;
+
+        case EDN_TYPE_FLOAT:
+            FIRE(st, start, on_double, (st->ctx, value->as.floating));
+            break;
+
+        case EDN_TYPE_BIGINT:
+            if (st->muted == 0 && h->on_bigint != NULL) {
+                size_t length;
+                bool negative;
+                uint8_t radix;
+                const char* digits = edn_bigint_get(value, &length, &negative, &radix);
+                if (digits == NULL) {
+                    edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
+                                         "Out of memory reading big integer", start,
+                                         parser->current);
+                    return EVENT_ERROR;
+                }
+                FIRE(st, start, on_bigint, (st->ctx, digits, length, negative, radix));
+            }
+            break;
+
+        case EDN_TYPE_BIGDEC:
+            if (st->muted == 0 && h->on_bigdec != NULL) {
+                size_t length;
+                bool negative;
+                const char* digits = edn_bigdec_get(value, &length, &negative);
+                if (digits == NULL) {
+                    edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
+                                         "Out of memory reading big decimal", start,
+                                         parser->current);
+                    return EVENT_ERROR;
+                }
+                FIRE(st, start, on_bigdec, (st->ctx, digits, length, negative));
+            }
+            break;
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+        case EDN_TYPE_RATIO:
+            FIRE(st, start, on_ratio,
+                 (st->ctx, value->as.ratio.numerator, value->as.ratio.denominator));
+            break;
+
+        case EDN_TYPE_BIGRATIO:
+            FIRE(st, start, on_bigratio,
+                 (st->ctx, value->as.bigratio.numerator, value->as.bigratio.numer_length,
+                  value->as.bigratio.numer_negative, value->as.bigratio.denominator,
+                  value->as.bigratio.denom_length));
+            break;
+#endif
+
+        case EDN_TYPE_CHARACTER:
+            FIRE(st, start, on_character, (st->ctx, value->as.character));
+            break;
+
+        case EDN_TYPE_STRING:
+            if (st->muted == 0 && h->on_string != NULL && fire_string(st, value, start) != 0) {
+                return EVENT_ERROR;
+            }
+            break;
+
+        case EDN_TYPE_KEYWORD:
+        case EDN_TYPE_SYMBOL: {
+            bool is_keyword = kind == EDN_TYPE_KEYWORD;
+            const char* ns = is_keyword ? value->as.keyword.namespace : value->as.symbol.namespace;
+            size_t ns_length =
+                is_keyword ? value->as.keyword.ns_length : value->as.symbol.ns_length;
+            const char* name = is_keyword ? value->as.keyword.name : value->as.symbol.name;
+            size_t name_length =
+                is_keyword ? value->as.keyword.name_length : value->as.symbol.name_length;
+
+            /* Namespaced map keys: bare names take the map's namespace, :_/x opts out */
+            if (map_ns != NULL) {
+                if (ns == NULL) {
+                    ns = map_ns;
+                    ns_length = map_ns_length;
+                } else if (ns_length == 1 && ns[0] == '_') {
+                    ns = NULL;
+                    ns_length = 0;
+                }
+            }
+
+            if (is_keyword) {
+                FIRE(st, start, on_keyword, (st->ctx, ns, ns_length, name, name_length));
+            } else {
+                FIRE(st, start, on_symbol, (st->ctx, ns, ns_length, name, name_length));
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    edn_arena_reset(parser->arena);
+    return (int) kind;
+}
+
+/* List, vector, set or map; parser->current is on the opening delimiter */
+static int parse_collection(event_state_t* st, const char* start, edn_type_t kind,
+                            const collection_syntax_t* syntax, const char* ns, size_t ns_length) {
+    edn_parser_t* parser = &st->parser;
+
+    parser->current += (*parser->current == '#') ? 2 : 1;
+    if (!edn_enter_depth(parser)) {
+        return EVENT_ERROR;
+    }
+    if (fire_begin(st, kind, start) != 0) {
+        return EVENT_ERROR;
+    }
+
+    size_t count = 0;
+    for (;;) {
+        if (kind == EDN_TYPE_MAP && (count & 1) == 0) {
+            st->key_ns = ns;
+            st->key_ns_length = ns_length;
+        }
+
+        int r = parse_form(st);
+        if (r == EVENT_CLOSE) {
+            break;
+        }
+        if (r == EVENT_ERROR) {
+            if (parser->error == EDN_ERROR_UNEXPECTED_EOF) {
+                edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
+                                     syntax->unterminated, start, parser->current);
+            }
+            return EVENT_ERROR;
+        }
+        count++;
+    }
+
+    if (kind == EDN_TYPE_MAP && (count & 1) != 0) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Map has odd number of elements (key without value)", start,
+                             parser->current);
+        return EVENT_ERROR;
+    }
+
+    if (*parser->current != syntax->close) {
+        edn_parser_set_error(parser, EDN_ERROR_UNMATCHED_DELIMITER, syntax->mismatched, start,
+                             parser->current + 1);
+        return EVENT_ERROR;
+    }
+
+    parser->current++;
+    edn_leave_depth(parser);
+
+    if (fire_end(st, kind, start) != 0) {
+        return EVENT_ERROR;
+    }
+    return (int) kind;
+}
+
+/* #_ form: validate the discarded form silently, then parse the next one */
+static int parse_discard(event_state_t* st, const char* start, const char* key_ns,
+                         size_t key_ns_length) {
+    edn_parser_t* parser = &st->parser;
+
+    if (!edn_enter_depth(parser)) {
+        return EVENT_ERROR;
+    }
+    parser->current += 2;
+
+    st->muted++;
+    int r = parse_form(st);
+    st->muted--;
+
+    if (r == EVENT_CLOSE) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_DISCARD, "Discard macro missing value",
+                             start, start + 2);
+        return EVENT_ERROR;
+    }
+    if (r == EVENT_ERROR) {
+        return EVENT_ERROR;
+    }
+
+    /* The form after the discard takes its place, including map-key position */
+    st->key_ns = key_ns;
+    st->key_ns_length = key_ns_length;
+    r = parse_form(st);
+    edn_leave_depth(parser);
+    return r;
+}
+
+static int parse_tagged(event_state_t* st, const char* start) {
+    edn_parser_t* parser = &st->parser;
+
+    parser->current++;
+    if (!edn_enter_depth(parser)) {
+        return EVENT_ERROR;
+    }
+
+    if (parser->current >= parser->end) {
+        edn_parser_set_error(parser, EDN_ERROR_UNEXPECTED_EOF,
+                             "Unexpected end of input after '#' (expected tag)", start,
+                             parser->current);
+        return EVENT_ERROR;
+    }
+
+    char next = *parser->current;
+    if (next == ' ' || next == '\t' || next == '\n' || next == '\r' || next == ',') {
+        edn_parser_set_error(
+            parser, EDN_ERROR_INVALID_SYNTAX,
+            "Tagged literal tag must immediately follow '#' (no whitespace allowed)", start,
+            parser->current);
+        return EVENT_ERROR;
+    }
+
+    const char* tag_start = parser->current;
+    edn_value_t* tag_value = edn_read_identifier(parser);
+    if (tag_value == NULL) {
+        return EVENT_ERROR; /* Error already set */
+    }
+    if (tag_value->type != EDN_TYPE_SYMBOL) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX, "Tagged literal must be a symbol",
+                             start, parser->current);
+        return EVENT_ERROR;
+    }
+    edn_arena_reset(parser->arena);
+
+    FIRE(st, start, on_tag, (st->ctx, tag_start, (size_t) (parser->current - tag_start)));
+
+    int r = parse_form(st);
+    if (r == EVENT_CLOSE) {
+        edn_parser_set_error(parser, EDN_ERROR_UNEXPECTED_EOF, "Tagged literal missing value",
+                             start, parser->current);
+        return EVENT_ERROR;
+    }
+    if (r == EVENT_ERROR) {
+        return EVENT_ERROR;
+    }
+
+    edn_leave_depth(parser);
+    return EDN_TYPE_TAGGED;
+}
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+static int parse_metadata(event_state_t* st, const char* start) {
+    edn_parser_t* parser = &st->parser;
+
+    parser->current++;
+    if (!edn_enter_depth(parser)) {
+        return EVENT_ERROR;
+    }
+
+    FIRE(st, start, on_meta, (st->ctx));
+
+    int meta = parse_form(st);
+    if (meta == EVENT_ERROR) {
+        return EVENT_ERROR;
+    }
+    if (meta != EVENT_CLOSE && meta != EDN_TYPE_MAP && meta != EDN_TYPE_KEYWORD &&
+        meta != EDN_TYPE_STRING && meta != EDN_TYPE_SYMBOL && meta != EDN_TYPE_VECTOR) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Metadata must be a map, keyword, string, symbol, or vector", start,
+                             parser->current);
+        return EVENT_ERROR;
+    }
+
+    int form = meta == EVENT_CLOSE ? EVENT_CLOSE : parse_form(st);
+    if (form == EVENT_ERROR) {
+        return EVENT_ERROR;
+    }
+    if (form == EVENT_CLOSE) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Metadata must be followed by a form", start, parser->current);
+        return EVENT_ERROR;
+    }
+    if (form != EDN_TYPE_LIST && form != EDN_TYPE_VECTOR && form != EDN_TYPE_MAP &&
+        form != EDN_TYPE_SET && form != EDN_TYPE_TAGGED && form != EDN_TYPE_SYMBOL) {
+        edn_parser_set_error(
+            parser, EDN_ERROR_INVALID_SYNTAX,
+            "Metadata can only be attached to collections, tagged literals, and symbols", start,
+            parser->current);
+        return EVENT_ERROR;
+    }
+
+    edn_leave_depth(parser);
+    return form;
+}
+
+/* #:ns{...} */
+static int parse_namespaced_map(event_state_t* st, const char* start) {
+    edn_parser_t* parser = &st->parser;
+
+    parser->current++;
+
+    edn_value_t* ns_keyword = edn_read_identifier(parser);
+    if (ns_keyword == NULL) {
+        return EVENT_ERROR; /* Error already set */
+    }
+    if (ns_keyword->type != EDN_TYPE_KEYWORD) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Namespaced map must start with a keyword", start, parser->current);
+        return EVENT_ERROR;
+    }
+    if (ns_keyword->as.keyword.namespace != NULL) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Namespaced map keyword cannot have a namespace", start,
+                             parser->current);
+        return EVENT_ERROR;
+    }
+
+    /* The name points into the input, so it survives the arena reset */
+    const char* ns_name = ns_keyword->as.keyword.name;
+    size_t ns_length = ns_keyword->as.keyword.name_length;
+    edn_arena_reset(parser->arena);
+
+    edn_skip_whitespace(parser);
+    if (parser->current >= parser->end || *parser->current != '{') {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Namespaced map must be followed by '{'", start, parser->current);
+        return EVENT_ERROR;
+    }
+
+    return parse_collection(st, start, EDN_TYPE_MAP, &NS_MAP_SYNTAX, ns_name, ns_length);
+}
+#endif
+
+/* Parse one form, mirroring edn_read_value()'s dispatch. Returns the form's
+ * edn_type_t, EVENT_CLOSE or EVENT_ERROR. */
+static int parse_form(event_state_t* st) {
+    edn_parser_t* parser = &st->parser;
+
+    /* Map-key namespace applies to this form only */
+    const char* key_ns = st->key_ns;
+    size_t key_ns_length = st->key_ns_length;
+    st->key_ns = NULL;
+
+    if (!edn_skip_whitespace(parser)) {
+        edn_parser_set_error(parser, EDN_ERROR_UNEXPECTED_EOF, "Unexpected end of input",
+                             parser->current, parser->current);
+        return EVENT_ERROR;
+    }
+
+    const char* start = parser->current;
+    char c = *start;
+
+    switch (c) {
+        case '"':
+            return event_scalar(st, edn_read_string(parser), start, NULL, 0);
+
+        case '\\':
+            return event_scalar(st, edn_read_character(parser), start, NULL, 0);
+
+        case '(':
+            return parse_collection(st, start, EDN_TYPE_LIST, &LIST_SYNTAX, NULL, 0);
+
+        case '[':
+            return parse_collection(st, start, EDN_TYPE_VECTOR, &VECTOR_SYNTAX, NULL, 0);
+
+        case '{':
+            return parse_collection(st, start, EDN_TYPE_MAP, &MAP_SYNTAX, NULL, 0);
+
+        case ')':
+        case ']':
+        case '}':
+            if (parser->depth == 0) {
+                const char* msg;
+                if (c == ')') {
+                    msg = "Unmatched closing delimiter ')'";
+                } else if (c == ']') {
+                    msg = "Unmatched closing delimiter ']'";
+                } else {
+                    msg = "Unmatched closing delimiter '}'";
+                }
+                edn_parser_set_error(parser, EDN_ERROR_UNMATCHED_DELIMITER, msg, start, start + 1);
+                return EVENT_ERROR;
+            }
+            return EVENT_CLOSE;
+
+        case '#':
+            if (start + 1 < parser->end) {
+                char next = start[1];
+                if (next == '{') {
+                    return parse_collection(st, start, EDN_TYPE_SET, &SET_SYNTAX, NULL, 0);
+                } else if (next == '#') {
+                    return event_scalar(st, edn_read_symbolic_value(parser), start, NULL, 0);
+                } else if (next == '_') {
+                    return parse_discard(st, start, key_ns, key_ns_length);
+                }
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+                else if (next == ':') {
+                    return parse_namespaced_map(st, start);
+                }
+#endif
+            }
+            return parse_tagged(st, start);
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+        case '^':
+            return parse_metadata(st, start);
+#endif
+
+        case '+':
+        case '-':
+            if (start + 1 < parser->end && start[1] >= '0' && start[1] <= '9') {
+                return event_scalar(st, edn_read_number(parser), start, NULL, 0);
+            }
+            return event_scalar(st, edn_read_identifier(parser), start, key_ns, key_ns_length);
+
+        default:
+            if (c >= '0' && c <= '9') {
+                return event_scalar(st, edn_read_number(parser), start, NULL, 0);
+            }
+            return event_scalar(st, edn_read_identifier(parser), start, key_ns, key_ns_length);
+    }
+}
+
+edn_result_t edn_parse_events(const char* input, size_t length,
+                              const edn_event_handlers_t* handlers, void* ctx) {
+    edn_result_t result = {0};
+
+    if (!input) {
+        result.error = EDN_ERROR_INVALID_SYNTAX;
+        result.error_message = "Input is NULL";
+        return result;
+    }
+    if (!handlers) {
+        result.error = EDN_ERROR_INVALID_ARGUMENT;
+        result.error_message = "Event handlers are NULL";
+        return result;
+    }
+
+    if (length == 0) {
+        length = strlen(input);
+    }
+
+    uint64_t inline_scratch[EVENTS_INLINE_SCRATCH / sizeof(uint64_t)];
+    edn_arena_t scratch;
+    edn_arena_init_with_buffer(&scratch, inline_scratch, sizeof(inline_scratch));
+
+    event_state_t st;
+    edn_parser_init(&st.parser, input, length);
+    st.parser.arena = &scratch;
+    st.handlers = handlers;
+    st.ctx = ctx;
+    st.muted = 0;
+    st.key_ns = NULL;
+    st.key_ns_length = 0;
+
+    parse_form(&st);
+    edn_arena_release(&scratch);
+
+    result.error = st.parser.error;
+    result.error_message = st.parser.error_message;
+    if (result.error != EDN_OK) {
+        edn_result_set_error_positions(&result, &st.parser);
+    }
+    return result;
+}
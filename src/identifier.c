@@ -223,33 +223,34 @@ static edn_value_t* create_keyword_value(edn_parser_t* parser, const char* names
 }
 
 /**
- * Parse identifier (symbol or keyword) from current parser position.
- * 
- * Handles:
- * - Non-namespaced keywords: :foo, :name
- * - Namespaced keywords: :ns/name, :ns.foo/bar
- * - Reserved symbols: nil, true, false
- * - Non-namespaced symbols: foo, bar, +, /
- * - Namespaced symbols: ns/name, ns.foo/bar
- * 
- * Fast path optimized for non-namespaced identifiers (80% of cases).
- * Validates namespace/name syntax and colon placement.
+ * Scan and classify identifier at current parser position.
+ *
+ * Applies every syntax rule of edn_read_identifier() (reserved words,
+ * keyword colon placement, namespace validation) without allocating, and
+ * advances past the identifier. Returns false with the parser error set.
  */
-edn_value_t* edn_read_identifier(edn_parser_t* parser) {
+bool edn_scan_identifier_token(edn_parser_t* parser, edn_identifier_token_t* token) {
     const char* value_start = parser->current;
     edn_identifier_scan_t scan = scan_identifier(parser->current, parser->end);
 
     if (!scan.valid) {
         edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX, "Invalid identifier", value_start,
                              parser->current);
-        return NULL;
+        return false;
     }
 
     parser->current = scan.start + scan.length;
-    size_t source_start = value_start - parser->input;
-    size_t source_end = parser->current - parser->input;
+    if (parser->strict_utf8 &&
+        !edn_check_utf8(parser, value_start, parser->current, EDN_ERROR_INVALID_SYNTAX,
+                        "Invalid UTF-8 in identifier")) {
+        return false;
+    }
+    token->boolean = false;
 
     if (!scan.namespace) {
+        token->namespace = NULL;
+        token->ns_length = 0;
+
         if (*scan.name == ':') {
             const char* kw_name = scan.name + 1;
             size_t kw_len = scan.name_length - 1;
@@ -257,66 +258,111 @@ edn_value_t* edn_read_identifier(edn_parser_t* parser) {
             if (kw_len == 0) {
                 edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX, "Empty keyword name",
                                      value_start, parser->current);
-                return NULL;
+                return false;
             }
 
             if (*kw_name == ':') {
                 edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
                                      "Keyword name cannot start with ':'", value_start,
                                      parser->current);
-                return NULL;
+                return false;
             }
 
-            return create_keyword_value(parser, NULL, 0, kw_name, kw_len, source_start, source_end);
+            token->type = EDN_TYPE_KEYWORD;
+            token->name = kw_name;
+            token->name_length = kw_len;
+            return true;
         }
 
-        const char* sym_name = scan.name;
-        size_t sym_len = scan.name_length;
+        token->type = EDN_TYPE_SYMBOL;
+        token->name = scan.name;
+        token->name_length = scan.name_length;
 
-        switch (sym_len) {
+        switch (scan.name_length) {
             case 3:
-                if (memcmp(sym_name, "nil", 3) == 0) {
-                    return create_nil_value(parser, source_start, source_end);
+                if (memcmp(scan.name, "nil", 3) == 0) {
+                    token->type = EDN_TYPE_NIL;
                 }
                 break;
             case 4:
-                if (memcmp(sym_name, "true", 4) == 0) {
-                    return create_bool_value(parser, true, source_start, source_end);
+                if (memcmp(scan.name, "true", 4) == 0) {
+                    token->type = EDN_TYPE_BOOL;
+                    token->boolean = true;
                 }
                 break;
             case 5:
-                if (memcmp(sym_name, "false", 5) == 0) {
-                    return create_bool_value(parser, false, source_start, source_end);
+                if (memcmp(scan.name, "false", 5) == 0) {
+                    token->type = EDN_TYPE_BOOL;
                 }
                 break;
         }
-
-        return create_symbol_value(parser, NULL, 0, sym_name, sym_len, source_start, source_end);
+        return true;
     }
 
     if (*scan.namespace == ':') {
         const char* kw_ns = scan.namespace + 1;
         size_t kw_ns_len = scan.ns_length - 1;
-        const char* kw_name = scan.name;
-        size_t kw_name_len = scan.name_length;
 
         if (kw_ns_len == 0) {
             edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX, "Empty namespace in keyword",
                                  value_start, parser->current);
-            return NULL;
+            return false;
         }
 
         if (*kw_ns == ':') {
             edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
                                  "Keyword namespace cannot start with ':'", value_start,
                                  parser->current);
-            return NULL;
+            return false;
         }
 
-        return create_keyword_value(parser, kw_ns, kw_ns_len, kw_name, kw_name_len, source_start,
-                                    source_end);
+        token->type = EDN_TYPE_KEYWORD;
+        token->namespace = kw_ns;
+        token->ns_length = kw_ns_len;
+    } else {
+        token->type = EDN_TYPE_SYMBOL;
+        token->namespace = scan.namespace;
+        token->ns_length = scan.ns_length;
     }
+    token->name = scan.name;
+    token->name_length = scan.name_length;
+    return true;
+}
 
-    return create_symbol_value(parser, scan.namespace, scan.ns_length, scan.name, scan.name_length,
-                               source_start, source_end);
+/**
+ * Parse identifier (symbol or keyword) from current parser position.
+ * 
+ * Handles:
+ * - Non-namespaced keywords: :foo, :name
+ * - Namespaced keywords: :ns/name, :ns.foo/bar
+ * - Reserved symbols: nil, true, false
+ * - Non-namespaced symbols: foo, bar, +, /
+ * - Namespaced symbols: ns/name, ns.foo/bar
+ * 
+ * Fast path optimized for non-namespaced identifiers (80% of cases).
+ * Validates namespace/name syntax and colon placement.
+ */
+edn_value_t* edn_read_identifier(edn_parser_t* parser) {
+    const char* value_start = parser->current;
+    edn_identifier_token_t token;
+
+    if (!edn_scan_identifier_token(parser, &token)) {
+        return NULL;
+    }
+
+    size_t source_start = value_start - parser->input;
+    size_t source_end = parser->current - parser->input;
+
+    switch (token.type) {
+        case EDN_TYPE_NIL:
+            return create_nil_value(parser, source_start, source_end);
+        case EDN_TYPE_BOOL:
+            return create_bool_value(parser, token.boolean, source_start, source_end);
+        case EDN_TYPE_KEYWORD:
+            return create_keyword_value(parser, token.namespace, token.ns_length, token.name,
+                                        token.name_length, source_start, source_end);
+        default:
+            return create_symbol_value(parser, token.namespace, token.ns_length, token.name,
+                                       token.name_length, source_start, source_end);
+    }
 }
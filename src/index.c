@@ -0,0 +1,705 @@
+/**
+ * EDN.C - Sidecar offset index
+ *
+ * An index file is a fixed header, one entry per form and, for keyed
+ * indexes, an open-addressed table of entry numbers by key hash:
+ *
+ *   index_header_t | index_entry_t[count] | uint64_t[slots]
+ *
+ * Table slots hold entry number + 1 (0 = empty) and are filled by linear
+ * probing from hash & (slots - 1) in entry order, so a lookup meets the
+ * first form with a given key first. Entries are streamed to the file as
+ * the scan finds them; only the (hash, entry) pairs of keyed forms stay in
+ * memory until the table is written. The header goes in last, so an
+ * interrupted build leaves a file that edn_index_open rejects.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L /* open, fstat, mmap, posix_madvise under -std=c11 */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "edn_internal.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INDEX_MMAP 1
+#endif
+
+#define INDEX_SUFFIX ".ednidx"
+#define INDEX_MAGIC "EDNIDX\r\n"
+#define INDEX_VERSION 1u
+#define INDEX_BYTE_ORDER 0x0102030405060708ULL
+#define INDEX_FLAG_ELEMENTS 1u /* Entries are elements of a top-level vector */
+#define INDEX_FLAG_KEYED 2u    /* Built with a key */
+#define INDEX_KEYS_INITIAL 1024
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t byte_order; /* INDEX_BYTE_ORDER as written */
+    uint64_t data_size;  /* Size of the indexed file */
+    uint64_t count;      /* Entries */
+    uint64_t slots;      /* Key table slots: 0 or a power of two */
+    uint64_t reserved[2];
+} index_header_t;
+
+typedef struct {
+    uint64_t offset;     /* Form start in the data file */
+    uint64_t length;     /* Form bytes */
+    uint64_t key_hash;   /* edn_value_hash of the key value */
+    uint32_t key_offset; /* Key value's text, relative to the form */
+    uint32_t key_length; /* 0 when the form has no key */
+} index_entry_t;
+
+/* Read-only view of a whole file */
+typedef struct {
+    const char* data;
+    size_t size;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#elif !defined(INDEX_MMAP)
+    char* buffer;
+#endif
+} mapped_file_t;
+
+struct edn_index {
+    mapped_file_t data;
+    mapped_file_t file; /* The index itself */
+    const index_entry_t* entries;
+    const uint64_t* table;
+    size_t count;
+    uint64_t slots;
+};
+
+static edn_error_t map_file(const char* path, mapped_file_t* out) {
+    memset(out, 0, sizeof(*out));
+    out->data = "";
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return EDN_ERROR_IO_FAILURE;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (uint64_t) size.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return EDN_ERROR_IO_FAILURE;
+    }
+    out->file = file;
+    out->size = (size_t) size.QuadPart;
+    if (out->size > 0) {
+        out->mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        const char* view =
+            out->mapping ? (const char*) MapViewOfFile(out->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+        if (view == NULL) {
+            if (out->mapping) {
+                CloseHandle(out->mapping);
+            }
+            CloseHandle(file);
+            return EDN_ERROR_IO_FAILURE;
+        }
+        out->data = view;
+    }
+    return EDN_OK;
+#elif defined(INDEX_MMAP)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return EDN_ERROR_IO_FAILURE;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 0 || (uint64_t) st.st_size > SIZE_MAX) {
+        close(fd);
+        return EDN_ERROR_IO_FAILURE;
+    }
+    out->size = (size_t) st.st_size;
+    if (out->size > 0) {
+        void* view = mmap(NULL, out->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            close(fd);
+            return EDN_ERROR_IO_FAILURE;
+        }
+        out->data = view;
+    }
+    close(fd); /* The mapping keeps the file open */
+    return EDN_OK;
+#else
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        return EDN_ERROR_IO_FAILURE;
+    }
+    long size = (fseek(f, 0, SEEK_END) == 0) ? ftell(f) : -1;
+    if (size < 0 || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return EDN_ERROR_IO_FAILURE;
+    }
+    out->size = (size_t) size;
+    if (out->size > 0) {
+        out->buffer = malloc(out->size);
+        if (out->buffer == NULL) {
+            fclose(f);
+            return EDN_ERROR_OUT_OF_MEMORY;
+        }
+        if (fread(out->buffer, 1, out->size, f) != out->size) {
+            free(out->buffer);
+            fclose(f);
+            return EDN_ERROR_IO_FAILURE;
+        }
+        out->data = out->buffer;
+    }
+    fclose(f);
+    return EDN_OK;
+#endif
+}
+
+static void unmap_file(mapped_file_t* file) {
+#if defined(_WIN32)
+    if (file->size > 0) {
+        UnmapViewOfFile(file->data);
+        CloseHandle(file->mapping);
+    }
+    if (file->file) {
+        CloseHandle(file->file);
+    }
+#elif defined(INDEX_MMAP)
+    if (file->size > 0) {
+        munmap((void*) file->data, file->size);
+    }
+#else
+    free(file->buffer);
+#endif
+    memset(file, 0, sizeof(*file));
+}
+
+/* Access-pattern hint for the kernel's read-ahead (advisory) */
+#if defined(INDEX_MMAP) && defined(POSIX_MADV_SEQUENTIAL)
+#define INDEX_ADVISE(file, advice)                                                             \
+    ((file)->size > 0 ? (void) posix_madvise((void*) (file)->data, (file)->size, (advice)) \
+                      : (void) 0)
+#define INDEX_SEQUENTIAL POSIX_MADV_SEQUENTIAL
+#define INDEX_RANDOM POSIX_MADV_RANDOM
+#else
+#define INDEX_ADVISE(file, advice) ((void) (file))
+#endif
+
+static char* sidecar_path(const char* path) {
+    size_t length = strlen(path);
+    char* out = malloc(length + sizeof(INDEX_SUFFIX));
+    if (out != NULL) {
+        memcpy(out, path, length);
+        memcpy(out + length, INDEX_SUFFIX, sizeof(INDEX_SUFFIX));
+    }
+    return out;
+}
+
+/* Line and column of `offset`, counted the way edn_read reports them */
+static edn_error_position_t position_at(const char* data, size_t offset) {
+    edn_error_position_t pos = {offset, 1, 1};
+    const char* line_start = data;
+    const char* end = data + offset;
+    const char* p = data;
+    while (p < end && (p = memchr(p, '\n', (size_t) (end - p))) != NULL) {
+        pos.line++;
+        line_start = ++p;
+    }
+    pos.column = (size_t) (end - line_start) + 1;
+    return pos;
+}
+
+static void set_error(edn_result_t* result, const char* data, edn_error_t error,
+                      const char* message, size_t start, size_t end) {
+    result->error = error;
+    result->error_message = message;
+    result->error_start = position_at(data, start);
+    result->error_end = position_at(data, end);
+}
+
+typedef struct {
+    uint64_t hash;
+    uint64_t entry;
+} key_slot_t;
+
+typedef struct {
+    FILE* out;
+    const char* data;
+    size_t count;
+    edn_value_t* key; /* Keyword to look up in each form, or NULL */
+    char* key_text;
+    key_slot_t* keys;
+    size_t key_count;
+    size_t key_capacity;
+    edn_result_t* result;
+} builder_t;
+
+/* Record the form at [start, end); false with b->result set on failure */
+static bool add_form(builder_t* b, const char* start, const char* end) {
+    index_entry_t entry = {0};
+    entry.offset = (uint64_t) (start - b->data);
+    entry.length = (uint64_t) (end - start);
+
+    if (b->key != NULL) {
+        edn_result_t r = edn_read(start, (size_t) (end - start));
+        if (r.error != EDN_OK) {
+            size_t base = (size_t) entry.offset;
+            set_error(b->result, b->data, r.error, r.error_message, base + r.error_start.offset,
+                      base + r.error_end.offset);
+            return false;
+        }
+        const edn_value_t* value =
+            edn_type(r.value) == EDN_TYPE_MAP ? edn_map_lookup(r.value, b->key) : NULL;
+        size_t key_start, key_end;
+        if (value != NULL && edn_source_position(value, &key_start, &key_end) &&
+            key_end <= UINT32_MAX) {
+            entry.key_hash = edn_value_hash(value);
+            entry.key_offset = (uint32_t) key_start;
+            entry.key_length = (uint32_t) (key_end - key_start);
+        }
+        edn_free(r.value);
+
+        if (entry.key_length > 0) {
+            if (b->key_count == b->key_capacity) {
+                size_t capacity = b->key_capacity ? b->key_capacity * 2 : INDEX_KEYS_INITIAL;
+                key_slot_t* keys = realloc(b->keys, capacity * sizeof(*keys));
+                if (keys == NULL) {
+                    b->result->error = EDN_ERROR_OUT_OF_MEMORY;
+                    b->result->error_message = "Out of memory collecting index keys";
+                    return false;
+                }
+                b->keys = keys;
+                b->key_capacity = capacity;
+            }
+            b->keys[b->key_count].hash = entry.key_hash;
+            b->keys[b->key_count].entry = b->count;
+            b->key_count++;
+        }
+    }
+
+    if (fwrite(&entry, sizeof(entry), 1, b->out) != 1) {
+        b->result->error = EDN_ERROR_IO_FAILURE;
+        b->result->error_message = "Cannot write index file";
+        return false;
+    }
+    b->count++;
+    return true;
+}
+
+/* Skipper failure: copy the parser's error into the result */
+static bool skip_failed(builder_t* b, const edn_parser_t* parser) {
+    const char* start = parser->error_start ? parser->error_start : parser->current;
+    const char* end = parser->error_end ? parser->error_end : parser->current;
+    set_error(b->result, b->data, parser->error, parser->error_message,
+              (size_t) (start - b->data), (size_t) (end - b->data));
+    return false;
+}
+
+/* Every top-level form */
+static bool scan_forms(builder_t* b, edn_parser_t* parser) {
+    for (;;) {
+        const char* start = NULL;
+        edn_skip_result_t r = edn_skip_value(parser, &start);
+        if (r == EDN_SKIP_ERROR) {
+            return skip_failed(b, parser);
+        }
+        if (r == EDN_SKIP_CLOSE) {
+            if (parser->current >= parser->end) {
+                return true;
+            }
+            size_t at = (size_t) (parser->current - b->data);
+            set_error(b->result, b->data, EDN_ERROR_UNMATCHED_DELIMITER,
+                      "Unmatched closing delimiter", at, at + 1);
+            return false;
+        }
+        if (!add_form(b, start, parser->current)) {
+            return false;
+        }
+    }
+}
+
+/* Every element of the single top-level vector */
+static bool scan_elements(builder_t* b, edn_parser_t* parser) {
+    if (!edn_skip_whitespace(parser) || *parser->current != '[') {
+        size_t at = (size_t) (parser->current - b->data);
+        set_error(b->result, b->data, EDN_ERROR_INVALID_SYNTAX, "Expected a top-level vector", at,
+                  at);
+        return false;
+    }
+    const char* open = parser->current++;
+    if (!edn_enter_depth(parser)) {
+        return skip_failed(b, parser);
+    }
+
+    for (;;) {
+        const char* start = NULL;
+        edn_skip_result_t r = edn_skip_value(parser, &start);
+        if (r == EDN_SKIP_ERROR) {
+            return skip_failed(b, parser);
+        }
+        if (r == EDN_SKIP_CLOSE) {
+            size_t at = (size_t) (parser->current - b->data);
+            if (parser->current >= parser->end) {
+                set_error(b->result, b->data, EDN_ERROR_UNTERMINATED_COLLECTION,
+                          "Unterminated vector (missing ']')", (size_t) (open - b->data), at);
+                return false;
+            }
+            if (*parser->current != ']') {
+                set_error(b->result, b->data, EDN_ERROR_UNMATCHED_DELIMITER,
+                          "Mismatched closing delimiter", at, at + 1);
+                return false;
+            }
+            parser->current++;
+            break;
+        }
+        if (!add_form(b, start, parser->current)) {
+            return false;
+        }
+    }
+    edn_leave_depth(parser);
+
+    if (edn_skip_whitespace(parser)) {
+        size_t at = (size_t) (parser->current - b->data);
+        set_error(b->result, b->data, EDN_ERROR_INVALID_SYNTAX,
+                  "Unexpected content after the top-level vector", at, at);
+        return false;
+    }
+    return true;
+}
+
+/* Write the key table for b->keys; false with b->result set on failure */
+static bool write_table(builder_t* b, uint64_t* out_slots) {
+    uint64_t slots = 0;
+    if (b->key_count > 0) {
+        slots = 8;
+        while (slots < (uint64_t) b->key_count * 2) {
+            slots *= 2;
+        }
+    }
+    *out_slots = slots;
+    if (slots == 0) {
+        return true;
+    }
+    if (slots > SIZE_MAX / sizeof(uint64_t)) {
+        b->result->error = EDN_ERROR_OUT_OF_MEMORY;
+        b->result->error_message = "Out of memory building the index key table";
+        return false;
+    }
+    uint64_t* table = calloc((size_t) slots, sizeof(uint64_t));
+    if (table == NULL) {
+        b->result->error = EDN_ERROR_OUT_OF_MEMORY;
+        b->result->error_message = "Out of memory building the index key table";
+        return false;
+    }
+    uint64_t mask = slots - 1;
+    for (size_t i = 0; i < b->key_count; i++) {
+        uint64_t slot = b->keys[i].hash & mask;
+        while (table[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = b->keys[i].entry + 1;
+    }
+    bool ok = fwrite(table, sizeof(uint64_t), (size_t) slots, b->out) == (size_t) slots;
+    free(table);
+    if (!ok) {
+        b->result->error = EDN_ERROR_IO_FAILURE;
+        b->result->error_message = "Cannot write index file";
+    }
+    return ok;
+}
+
+/* Keyword value for options->key ("name" or "ns/name"), read from *text,
+ * which the caller frees after the value */
+static edn_value_t* key_keyword(const char* name, char** text) {
+    size_t length = strlen(name);
+    *text = malloc(length + 2);
+    if (*text == NULL) {
+        return NULL;
+    }
+    (*text)[0] = ':';
+    memcpy(*text + 1, name, length + 1);
+    edn_result_t r = edn_read(*text, length + 1);
+    size_t start, end;
+    if (r.error != EDN_OK || edn_type(r.value) != EDN_TYPE_KEYWORD ||
+        !edn_source_position(r.value, &start, &end) || end != length + 1) {
+        edn_free(r.value);
+        return NULL;
+    }
+    return r.value;
+}
+
+edn_result_t edn_index_build(const char* path, const edn_index_options_t* options) {
+    edn_result_t result = {0};
+    const char* index_path = NULL;
+    bool elements = false;
+    const char* key = NULL;
+
+    if (options != NULL) {
+        size_t sz = options->struct_size == 0 ? sizeof(edn_index_options_t) : options->struct_size;
+        if (sz >= offsetof(edn_index_options_t, index_path) + sizeof(options->index_path)) {
+            index_path = options->index_path;
+        }
+        if (sz >=
+            offsetof(edn_index_options_t, vector_elements) + sizeof(options->vector_elements)) {
+            elements = options->vector_elements;
+        }
+        if (sz >= offsetof(edn_index_options_t, key) + sizeof(options->key)) {
+            key = options->key;
+        }
+    }
+    if (path == NULL) {
+        result.error = EDN_ERROR_INVALID_ARGUMENT;
+        result.error_message = "Path is NULL";
+        return result;
+    }
+
+    builder_t b = {0};
+    b.result = &result;
+    if (key != NULL) {
+        b.key = key_keyword(key, &b.key_text);
+        if (b.key == NULL) {
+            free(b.key_text);
+            result.error = EDN_ERROR_INVALID_ARGUMENT;
+            result.error_message = "Index key is not a valid keyword name";
+            return result;
+        }
+    }
+
+    char* default_path = NULL;
+    if (index_path == NULL) {
+        default_path = sidecar_path(path);
+        if (default_path == NULL) {
+            edn_free(b.key);
+            free(b.key_text);
+            result.error = EDN_ERROR_OUT_OF_MEMORY;
+            result.error_message = "Out of memory";
+            return result;
+        }
+        index_path = default_path;
+    }
+
+    mapped_file_t data;
+    edn_error_t mapped = map_file(path, &data);
+    if (mapped != EDN_OK) {
+        edn_free(b.key);
+        free(b.key_text);
+        free(default_path);
+        result.error = mapped;
+        result.error_message = "Cannot read input file";
+        return result;
+    }
+    INDEX_ADVISE(&data, INDEX_SEQUENTIAL);
+    b.data = data.data;
+
+    index_header_t header = {0};
+    b.out = fopen(index_path, "wb");
+    bool ok = b.out != NULL && fwrite(&header, sizeof(header), 1, b.out) == 1;
+    if (!ok) {
+        result.error = EDN_ERROR_IO_FAILURE;
+        result.error_message = "Cannot write index file";
+    }
+
+    edn_parser_t parser;
+    edn_parser_init(&parser, data.data, data.size);
+
+    uint64_t slots = 0;
+    if (ok) {
+        ok = elements ? scan_elements(&b, &parser) : scan_forms(&b, &parser);
+    }
+    if (ok && b.key != NULL) {
+        ok = write_table(&b, &slots);
+    }
+    if (ok) {
+        memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+        header.version = INDEX_VERSION;
+        header.flags =
+            (elements ? INDEX_FLAG_ELEMENTS : 0u) | (b.key != NULL ? INDEX_FLAG_KEYED : 0u);
+        header.byte_order = INDEX_BYTE_ORDER;
+        header.data_size = data.size;
+        header.count = b.count;
+        header.slots = slots;
+        ok = fseek(b.out, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, b.out) == 1;
+        if (!ok) {
+            result.error = EDN_ERROR_IO_FAILURE;
+            result.error_message = "Cannot write index file";
+        }
+    }
+    if (b.out != NULL && fclose(b.out) != 0 && ok) {
+        ok = false;
+        result.error = EDN_ERROR_IO_FAILURE;
+        result.error_message = "Cannot write index file";
+    }
+    if (!ok && b.out != NULL) {
+        remove(index_path);
+    }
+
+    free(b.keys);
+    edn_free(b.key);
+    free(b.key_text);
+    free(default_path);
+    unmap_file(&data);
+    return result;
+}
+
+edn_index_t* edn_index_open(const char* path, const char* index_path, edn_error_t* error) {
+    edn_error_t ignored;
+    if (error == NULL) {
+        error = &ignored;
+    }
+    if (path == NULL) {
+        *error = EDN_ERROR_INVALID_ARGUMENT;
+        return NULL;
+    }
+
+    char* default_path = NULL;
+    if (index_path == NULL) {
+        default_path = sidecar_path(path);
+        if (default_path == NULL) {
+            *error = EDN_ERROR_OUT_OF_MEMORY;
+            return NULL;
+        }
+        index_path = default_path;
+    }
+    edn_index_t* index = calloc(1, sizeof(*index));
+    if (index == NULL) {
+        free(default_path);
+        *error = EDN_ERROR_OUT_OF_MEMORY;
+        return NULL;
+    }
+
+    *error = map_file(index_path, &index->file);
+    free(default_path);
+    if (*error != EDN_OK) {
+        free(index);
+        return NULL;
+    }
+    *error = map_file(path, &index->data);
+    if (*error != EDN_OK) {
+        unmap_file(&index->file);
+        free(index);
+        return NULL;
+    }
+
+    /* Validate the layout; entry offsets are checked when used */
+    const mapped_file_t* file = &index->file;
+    index_header_t header;
+    bool valid = file->size >= sizeof(header);
+    if (valid) {
+        memcpy(&header, file->data, sizeof(header));
+        size_t body = file->size - sizeof(header);
+        valid = memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) == 0 &&
+                header.version == INDEX_VERSION && header.byte_order == INDEX_BYTE_ORDER &&
+                (header.flags & ~(INDEX_FLAG_ELEMENTS | INDEX_FLAG_KEYED)) == 0 &&
+                header.data_size == index->data.size &&
+                header.count <= body / sizeof(index_entry_t) &&
+                (header.slots & (header.slots - 1)) == 0 &&
+                header.slots == (body - header.count * sizeof(index_entry_t)) / sizeof(uint64_t) &&
+                (body - header.count * sizeof(index_entry_t)) % sizeof(uint64_t) == 0;
+    }
+    if (!valid) {
+        edn_index_close(index);
+        *error = EDN_ERROR_INVALID_STATE;
+        return NULL;
+    }
+
+    index->count = (size_t) header.count;
+    index->slots = header.slots;
+    index->entries = (const index_entry_t*) (const void*) (file->data + sizeof(header));
+    index->table = (const uint64_t*) (const void*) (index->entries + index->count);
+    INDEX_ADVISE(&index->data, INDEX_RANDOM);
+    *error = EDN_OK;
+    return index;
+}
+
+void edn_index_close(edn_index_t* index) {
+    if (index == NULL) {
+        return;
+    }
+    unmap_file(&index->data);
+    unmap_file(&index->file);
+    free(index);
+}
+
+size_t edn_index_count(const edn_index_t* index) {
+    return index ? index->count : 0;
+}
+
+bool edn_index_form(const edn_index_t* index, size_t n, const char** text, size_t* length) {
+    if (index == NULL || n >= index->count) {
+        return false;
+    }
+    const index_entry_t* entry = &index->entries[n];
+    if (entry->length == 0 || entry->offset > index->data.size ||
+        entry->length > index->data.size - entry->offset) {
+        return false; /* Corrupt entry */
+    }
+    if (text) {
+        *text = index->data.data + entry->offset;
+    }
+    if (length) {
+        *length = (size_t) entry->length;
+    }
+    return true;
+}
+
+edn_result_t edn_index_get(const edn_index_t* index, size_t n,
+                           const edn_parse_options_t* options) {
+    const char* text;
+    size_t length;
+    if (!edn_index_form(index, n, &text, &length)) {
+        edn_result_t result = {0};
+        result.error = EDN_ERROR_INVALID_ARGUMENT;
+        result.error_message = "Form number out of range";
+        return result;
+    }
+
+    edn_result_t result = edn_read_with_options(text, length, options);
+    if (result.error != EDN_OK) {
+        size_t base = (size_t) (text - index->data.data);
+        result.error_start = position_at(index->data.data, base + result.error_start.offset);
+        result.error_end = position_at(index->data.data, base + result.error_end.offset);
+    }
+    return result;
+}
+
+bool edn_index_find(const edn_index_t* index, const edn_value_t* key, size_t* n) {
+    if (index == NULL || key == NULL || index->slots == 0) {
+        return false;
+    }
+    uint64_t hash = edn_value_hash(key);
+    uint64_t mask = index->slots - 1;
+    uint64_t slot = hash & mask;
+    for (uint64_t probes = 0; probes < index->slots; probes++, slot = (slot + 1) & mask) {
+        uint64_t number = index->table[slot];
+        if (number == 0 || number > index->count) {
+            return false;
+        }
+        const index_entry_t* entry = &index->entries[number - 1];
+        const char* text;
+        size_t length;
+        if (entry->key_hash != hash || entry->key_length == 0 ||
+            !edn_index_form(index, (size_t) (number - 1), &text, &length) ||
+            entry->key_offset > length || entry->key_length > length - entry->key_offset) {
+            continue;
+        }
+
+        /* Hashes can collide: compare the key's own text, read alone */
+        edn_result_t r = edn_read(text + entry->key_offset, entry->key_length);
+        bool match = r.error == EDN_OK && edn_value_equal(r.value, key);
+        edn_free(r.value);
+        if (match) {
+            if (n) {
+                *n = (size_t) (number - 1);
+            }
+            return true;
+        }
+    }
+    return false;
+}
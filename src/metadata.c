@@ -11,176 +11,118 @@
 
 #include "edn_internal.h"
 
-edn_value_t* edn_read_metadata(edn_parser_t* parser) {
-    const char* value_start = parser->current;
-
-    /* Skip the ^ character */
-    parser->current++;
-
-    /* Gate depth: chained ^^^...x would otherwise blow the C stack. */
-    if (!edn_enter_depth(parser)) {
+/* Keyword key synthesized for a shorthand metadata form */
+static edn_value_t* metadata_keyword(edn_arena_t* arena, const char* name, size_t name_length) {
+    edn_value_t* keyword = edn_arena_alloc_value(arena);
+    if (keyword == NULL) {
         return NULL;
     }
+    keyword->type = EDN_TYPE_KEYWORD;
+    keyword->as.keyword.namespace = NULL;
+    keyword->as.keyword.ns_length = 0;
+    keyword->as.keyword.name = name;
+    keyword->as.keyword.name_length = name_length;
+    keyword->arena = arena;
+    keyword->metadata = NULL;
+    return keyword;
+}
 
-    /* Step 1: Parse the metadata value */
-    edn_value_t* meta_value = edn_read_value(parser);
-    if (meta_value == NULL || parser->error != EDN_OK) {
-        edn_leave_depth(parser);
-        return NULL;
+/**
+ * Expand a metadata form into map entries:
+ *   ^{...}    -> the map's own entries
+ *   ^:kw      -> {:kw true}
+ *   ^[...]    -> {:param-tags [...]}
+ *   ^Sym/^"s" -> {:tag Sym}
+ * Returns NULL with *out_count == 0 for an empty map, and NULL with a
+ * non-zero *out_count (and *error_message set) when out of memory.
+ */
+static edn_map_entry_t* metadata_entries(edn_arena_t* arena, edn_value_t* meta_value,
+                                         size_t* out_count, const char** error_message) {
+    if (meta_value->type == EDN_TYPE_MAP) {
+        *out_count = meta_value->as.map.count;
+        return meta_value->as.map.entries;
     }
 
-    if (meta_value->type != EDN_TYPE_MAP && meta_value->type != EDN_TYPE_KEYWORD &&
-        meta_value->type != EDN_TYPE_STRING && meta_value->type != EDN_TYPE_SYMBOL &&
-        meta_value->type != EDN_TYPE_VECTOR) {
-        edn_leave_depth(parser);
-        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
-                             "Metadata must be a map, keyword, string, symbol, or vector",
-                             value_start, parser->current);
+    *out_count = 1;
+    edn_value_t* key;
+    edn_value_t* value;
+
+    if (meta_value->type == EDN_TYPE_KEYWORD) {
+        /* {:keyword true} */
+        value = edn_arena_alloc_value(arena);
+        if (value == NULL) {
+            *error_message = "Out of memory creating metadata value";
+            return NULL;
+        }
+        value->type = EDN_TYPE_BOOL;
+        value->as.boolean = true;
+        value->arena = arena;
+        value->metadata = NULL;
+        key = meta_value;
+    } else if (meta_value->type == EDN_TYPE_VECTOR) {
+        /* {:param-tags vector} */
+        key = metadata_keyword(arena, "param-tags", 10);
+        *error_message = "Out of memory creating :param-tags keyword";
+        value = meta_value;
+    } else /* EDN_TYPE_STRING or EDN_TYPE_SYMBOL */ {
+        /* {:tag value} */
+        key = metadata_keyword(arena, "tag", 3);
+        *error_message = "Out of memory creating :tag keyword";
+        value = meta_value;
+    }
+    if (key == NULL) {
         return NULL;
     }
 
-    /* Step 2: Parse the value to attach metadata to */
-    edn_value_t* form = edn_read_value(parser);
-    if (form == NULL || parser->error != EDN_OK) {
-        edn_leave_depth(parser);
+    edn_map_entry_t* entry = edn_arena_alloc(arena, sizeof(edn_map_entry_t));
+    if (entry == NULL) {
+        *error_message = "Out of memory creating metadata entry";
         return NULL;
     }
+    edn_map_entry_init(entry, key, value);
+    return entry;
+}
 
-    /* Validate that metadata can be attached to this type */
-    if (form->type != EDN_TYPE_LIST && form->type != EDN_TYPE_VECTOR &&
-        form->type != EDN_TYPE_MAP && form->type != EDN_TYPE_SET && form->type != EDN_TYPE_TAGGED &&
-        form->type != EDN_TYPE_SYMBOL) {
-        edn_leave_depth(parser);
-        edn_parser_set_error(
-            parser, EDN_ERROR_INVALID_SYNTAX,
-            "Metadata can only be attached to collections, tagged literals, and symbols",
-            value_start, parser->current);
-        return NULL;
+const char* edn_metadata_attach(edn_arena_t* arena, edn_value_t* meta_value, edn_value_t* form) {
+    const char* error_message = NULL;
+
+    /* Normalize the metadata to map entries */
+    size_t new_entries_count;
+    edn_map_entry_t* new_entries =
+        metadata_entries(arena, meta_value, &new_entries_count, &error_message);
+    if (new_entries == NULL && new_entries_count != 0) {
+        return error_message;
     }
 
-    /* Step 3: Add to existing metadata or create new */
+    /* Add to existing metadata or create new */
     if (form->metadata != NULL) {
         /* Form already has metadata - extend it */
         edn_value_t* existing_meta = form->metadata;
         size_t existing_count = existing_meta->as.map.count;
 
-        /* Prepare new entries to merge */
-        edn_value_t** new_keys = NULL;
-        edn_value_t** new_values = NULL;
-        size_t new_entries_count = 0;
-
-        if (meta_value->type == EDN_TYPE_MAP) {
-            new_keys = meta_value->as.map.keys;
-            new_values = meta_value->as.map.values;
-            new_entries_count = meta_value->as.map.count;
-        } else if (meta_value->type == EDN_TYPE_KEYWORD) {
-            /* Add {:keyword true} */
-            edn_value_t* true_value = edn_arena_alloc_value(parser->arena);
-            if (true_value == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating metadata value", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            true_value->type = EDN_TYPE_BOOL;
-            true_value->as.boolean = true;
-            true_value->arena = parser->arena;
-            true_value->metadata = NULL;
-
-            new_keys = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            new_values = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            if (new_keys == NULL || new_values == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating metadata entry", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            new_keys[0] = meta_value;
-            new_values[0] = true_value;
-            new_entries_count = 1;
-        } else if (meta_value->type == EDN_TYPE_VECTOR) {
-            /* Create {:param-tags vector} */
-            edn_value_t* param_tags_keyword = edn_arena_alloc_value(parser->arena);
-            if (param_tags_keyword == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating :param-tags keyword", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            param_tags_keyword->type = EDN_TYPE_KEYWORD;
-            param_tags_keyword->as.keyword.namespace = NULL;
-            param_tags_keyword->as.keyword.ns_length = 0;
-            param_tags_keyword->as.keyword.name = "param-tags";
-            param_tags_keyword->as.keyword.name_length = 10;
-            param_tags_keyword->arena = parser->arena;
-            param_tags_keyword->metadata = NULL;
-
-            new_keys = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            new_values = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            if (new_keys == NULL || new_values == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating metadata entry", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            new_keys[0] = param_tags_keyword;
-            new_values[0] = meta_value;
-            new_entries_count = 1;
-        } else /* EDN_TYPE_STRING or EDN_TYPE_SYMBOL */ {
-            /* Add {:tag value} */
-            edn_value_t* tag_keyword = edn_arena_alloc_value(parser->arena);
-            if (tag_keyword == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating :tag keyword", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            tag_keyword->type = EDN_TYPE_KEYWORD;
-            tag_keyword->as.keyword.namespace = NULL;
-            tag_keyword->as.keyword.ns_length = 0;
-            tag_keyword->as.keyword.name = "tag";
-            tag_keyword->as.keyword.name_length = 3;
-            tag_keyword->arena = parser->arena;
-            tag_keyword->metadata = NULL;
-
-            new_keys = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            new_values = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            if (new_keys == NULL || new_values == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating metadata entry", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            new_keys[0] = tag_keyword;
-            new_values[0] = meta_value;
-            new_entries_count = 1;
-        }
-
         /* Allocate worst-case space (all keys are unique) */
         size_t max_count = existing_count + new_entries_count;
-        edn_value_t** merged_keys =
-            edn_arena_alloc(parser->arena, max_count * sizeof(edn_value_t*));
-        edn_value_t** merged_values =
-            edn_arena_alloc(parser->arena, max_count * sizeof(edn_value_t*));
-        if (merged_keys == NULL || merged_values == NULL) {
-            edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY, "Out of memory merging metadata",
-                                 value_start, parser->current);
-            return NULL;
+        edn_map_entry_t* merged =
+            max_count ? edn_arena_alloc(arena, max_count * sizeof(edn_map_entry_t)) : NULL;
+        if (merged == NULL && max_count != 0) {
+            return "Out of memory merging metadata";
         }
 
         /* First, copy all new entries (highest precedence) */
-        memcpy(merged_keys, new_keys, new_entries_count * sizeof(edn_value_t*));
-        memcpy(merged_values, new_values, new_entries_count * sizeof(edn_value_t*));
+        if (new_entries_count > 0) {
+            memcpy(merged, new_entries, new_entries_count * sizeof(edn_map_entry_t));
+        }
         size_t merged_count = new_entries_count;
 
         /* Then, copy existing entries that don't have matching keys in new metadata */
         for (size_t i = 0; i < existing_count; i++) {
-            edn_value_t* existing_key = existing_meta->as.map.keys[i];
+            const edn_map_entry_t* existing = &existing_meta->as.map.entries[i];
 
             /* Check if this key exists in new metadata */
             bool found = false;
             for (size_t j = 0; j < new_entries_count; j++) {
-                if (edn_value_equal(existing_key, new_keys[j])) {
+                if (existing->key_hash == new_entries[j].key_hash &&
+                    edn_value_equal(existing->key, new_entries[j].key)) {
                     found = true;
                     break;
                 }
@@ -188,127 +130,86 @@ edn_value_t* edn_read_metadata(edn_parser_t* parser) {
 
             /* Only add if not found in new metadata (new overrides old) */
             if (!found) {
-                merged_keys[merged_count] = existing_key;
-                merged_values[merged_count] = existing_meta->as.map.values[i];
-                merged_count++;
+                merged[merged_count++] = *existing;
             }
         }
 
         /* Update the existing metadata map in place */
-        existing_meta->as.map.keys = merged_keys;
-        existing_meta->as.map.values = merged_values;
+        existing_meta->as.map.entries = merged;
         existing_meta->as.map.count = merged_count;
     } else {
         /* No existing metadata - create new metadata map */
-        edn_value_t* meta_map = edn_arena_alloc_value(parser->arena);
+        edn_value_t* meta_map = edn_arena_alloc_value(arena);
         if (meta_map == NULL) {
-            edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                 "Out of memory creating metadata map", value_start,
-                                 parser->current);
-            return NULL;
+            return "Out of memory creating metadata map";
         }
         meta_map->type = EDN_TYPE_MAP;
-        meta_map->arena = parser->arena;
+        meta_map->arena = arena;
         meta_map->metadata = NULL;
+        meta_map->as.map.entries = new_entries;
+        meta_map->as.map.count = new_entries_count;
 
-        if (meta_value->type == EDN_TYPE_MAP) {
-            /* Use the map directly */
-            meta_map->as.map.keys = meta_value->as.map.keys;
-            meta_map->as.map.values = meta_value->as.map.values;
-            meta_map->as.map.count = meta_value->as.map.count;
-        } else if (meta_value->type == EDN_TYPE_KEYWORD) {
-            /* Create {:keyword true} */
-            edn_value_t* true_value = edn_arena_alloc_value(parser->arena);
-            if (true_value == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating metadata value", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            true_value->type = EDN_TYPE_BOOL;
-            true_value->as.boolean = true;
-            true_value->arena = parser->arena;
-            true_value->metadata = NULL;
+        form->metadata = meta_map;
+    }
+    return NULL;
+}
 
-            edn_value_t** keys = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            edn_value_t** values = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            if (keys == NULL || values == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating metadata entry", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            keys[0] = meta_value;
-            values[0] = true_value;
+edn_value_t* edn_read_metadata(edn_parser_t* parser) {
+    const char* value_start = parser->current;
 
-            meta_map->as.map.keys = keys;
-            meta_map->as.map.values = values;
-            meta_map->as.map.count = 1;
-        } else if (meta_value->type == EDN_TYPE_VECTOR) {
-            /* Create {:param-tags vector} */
-            edn_value_t* param_tags_keyword = edn_arena_alloc_value(parser->arena);
-            if (param_tags_keyword == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating :param-tags keyword", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            param_tags_keyword->type = EDN_TYPE_KEYWORD;
-            param_tags_keyword->as.keyword.namespace = NULL;
-            param_tags_keyword->as.keyword.ns_length = 0;
-            param_tags_keyword->as.keyword.name = "param-tags";
-            param_tags_keyword->as.keyword.name_length = 10;
-            param_tags_keyword->arena = parser->arena;
-            param_tags_keyword->metadata = NULL;
+    /* Skip the ^ character */
+    parser->current++;
 
-            edn_value_t** keys = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            edn_value_t** values = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            if (keys == NULL || values == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating metadata entry", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            keys[0] = param_tags_keyword;
-            values[0] = meta_value;
+    /* Gate depth: chained ^^^...x would otherwise blow the C stack. */
+    if (!edn_enter_depth(parser)) {
+        return NULL;
+    }
 
-            meta_map->as.map.keys = keys;
-            meta_map->as.map.values = values;
-            meta_map->as.map.count = 1;
-        } else /* EDN_TYPE_STRING or EDN_TYPE_SYMBOL */ {
-            /* Create {:tag value} */
-            edn_value_t* tag_keyword = edn_arena_alloc_value(parser->arena);
-            if (tag_keyword == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating :tag keyword", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            tag_keyword->type = EDN_TYPE_KEYWORD;
-            tag_keyword->as.keyword.namespace = NULL;
-            tag_keyword->as.keyword.ns_length = 0;
-            tag_keyword->as.keyword.name = "tag";
-            tag_keyword->as.keyword.name_length = 3;
-            tag_keyword->arena = parser->arena;
-            tag_keyword->metadata = NULL;
+    /* Step 1: Parse the metadata value, which a schema ignores */
+    struct edn_schema_check* schema = parser->schema;
+    parser->schema = NULL;
+    edn_value_t* meta_value = edn_read_value(parser);
+    parser->schema = schema;
+    if (meta_value == NULL || parser->error != EDN_OK) {
+        edn_leave_depth(parser);
+        return NULL;
+    }
 
-            edn_value_t** keys = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            edn_value_t** values = edn_arena_alloc(parser->arena, sizeof(edn_value_t*));
-            if (keys == NULL || values == NULL) {
-                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
-                                     "Out of memory creating metadata entry", value_start,
-                                     parser->current);
-                return NULL;
-            }
-            keys[0] = tag_keyword;
-            values[0] = meta_value;
+    if (meta_value->type != EDN_TYPE_MAP && meta_value->type != EDN_TYPE_KEYWORD &&
+        meta_value->type != EDN_TYPE_STRING && meta_value->type != EDN_TYPE_SYMBOL &&
+        meta_value->type != EDN_TYPE_VECTOR) {
+        edn_leave_depth(parser);
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Metadata must be a map, keyword, string, symbol, or vector",
+                             value_start, parser->current);
+        return NULL;
+    }
 
-            meta_map->as.map.keys = keys;
-            meta_map->as.map.values = values;
-            meta_map->as.map.count = 1;
-        }
+    /* Step 2: Parse the value to attach metadata to */
+    edn_value_t* form = edn_read_value(parser);
+    if (form == NULL || parser->error != EDN_OK) {
+        edn_leave_depth(parser);
+        return NULL;
+    }
 
-        form->metadata = meta_map;
+    /* Validate that metadata can be attached to this type */
+    if (form->type != EDN_TYPE_LIST && form->type != EDN_TYPE_VECTOR &&
+        form->type != EDN_TYPE_MAP && form->type != EDN_TYPE_SET && form->type != EDN_TYPE_TAGGED &&
+        form->type != EDN_TYPE_SYMBOL) {
+        edn_leave_depth(parser);
+        edn_parser_set_error(
+            parser, EDN_ERROR_INVALID_SYNTAX,
+            "Metadata can only be attached to collections, tagged literals, and symbols",
+            value_start, parser->current);
+        return NULL;
+    }
+
+    /* Step 3: Normalize the metadata and merge it into the form's */
+    const char* error_message = edn_metadata_attach(parser->arena, meta_value, form);
+    if (error_message != NULL) {
+        edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY, error_message, value_start,
+                             parser->current);
+        return NULL;
     }
 
     /* Update form's source_start to include the ^ prefix and metadata */
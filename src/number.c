@@ -138,6 +138,11 @@ static inline void set_number_error(edn_parser_t* parser, const char* start, con
     edn_parser_set_error(parser, EDN_ERROR_INVALID_NUMBER, message, start, parser->current);
 }
 
+static inline void set_number_oom(edn_parser_t* parser, const char* start) {
+    edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY, "Out of memory allocating number", start,
+                         parser->current);
+}
+
 static inline bool validate_number_delimiter(edn_parser_t* parser, const char* start) {
     if (parser->current >= parser->end) {
         return true; /* EOF is valid */
@@ -448,8 +453,7 @@ static const double POWER_OF_TEN_NEGATIVE[23] = {
  * Constraints: exponent in [-22, 22], mantissa < 2^53.
  * Returns true if successful, false to fall back to strtod().
  */
-static inline bool parse_double_fast(int64_t mantissa, int64_t exponent, bool negative,
-                                     double* out) {
+bool edn_parse_double_fast(int64_t mantissa, int64_t exponent, bool negative, double* out) {
     if (exponent < -22 || exponent > 22) {
         return false;
     }
@@ -483,7 +487,8 @@ static inline bool parse_double_fast(int64_t mantissa, int64_t exponent, bool ne
  * 
  * Skips underscores if EDN_ENABLE_EXPERIMENTAL_EXTENSION is enabled.
  */
-static double parse_double_from_buffer(const char* start, const char* end) {
+static double parse_double_from_buffer(edn_parser_t* parser, const char* start,
+                                       const char* end) {
     const char* ptr = start;
     bool negative = false;
 
@@ -575,11 +580,13 @@ static double parse_double_from_buffer(const char* start, const char* end) {
     /* Try Clinger fast path (90% of cases). Pass mantissa as int64_t — safe
      * because digit_count <= 15 guarantees the value fits. */
     double result;
-    if (digit_count <= 15 && parse_double_fast((int64_t) mantissa_u, exponent, negative, &result)) {
+    if (digit_count <= 15 &&
+        edn_parse_double_fast((int64_t) mantissa_u, exponent, negative, &result)) {
         return result;
     }
 
     /* Fall back to strtod() for edge cases */
+    EDN_STATS_INC(parser, strtod_fallbacks);
 #ifdef EDN_ENABLE_EXPERIMENTAL_EXTENSION
     /* For strtod fallback with underscores, we need to create a cleaned buffer */
     char buffer[512];
@@ -933,7 +940,7 @@ edn_value_t* edn_read_number(edn_parser_t* parser) {
     /* Create value based on type */
     edn_value_t* value = edn_arena_alloc_value(parser->arena);
     if (!value) {
-        set_number_error(parser, start, "Out of memory");
+        set_number_oom(parser, start);
         return NULL;
     }
     value->arena = parser->arena;
@@ -1000,7 +1007,7 @@ edn_value_t* edn_read_number(edn_parser_t* parser) {
     } else if (has_decimal_point || has_exponent) {
         /* Double */
         value->type = EDN_TYPE_FLOAT;
-        value->as.floating = parse_double_from_buffer(start, digits_end);
+        value->as.floating = parse_double_from_buffer(parser, start, digits_end);
     } else {
         /* Try to fit in int64 */
         int64_t num;
@@ -1071,7 +1078,7 @@ parse_radix_digits:
 
     value = edn_arena_alloc_value(parser->arena);
     if (!value) {
-        set_number_error(parser, start, "Out of memory");
+        set_number_oom(parser, start);
         return NULL;
     }
     value->arena = parser->arena;
@@ -1145,7 +1152,7 @@ parse_hex_digits:
 
     value = edn_arena_alloc_value(parser->arena);
     if (!value) {
-        set_number_error(parser, start, "Out of memory");
+        set_number_oom(parser, start);
         return NULL;
     }
     value->arena = parser->arena;
@@ -1222,7 +1229,7 @@ parse_octal_digits:
 
     value = edn_arena_alloc_value(parser->arena);
     if (!value) {
-        set_number_error(parser, start, "Out of memory");
+        set_number_oom(parser, start);
         return NULL;
     }
     value->arena = parser->arena;
@@ -1254,7 +1261,7 @@ parse_octal_digits:
 create_integer_zero:
     value = edn_arena_alloc_value(parser->arena);
     if (!value) {
-        set_number_error(parser, start, "Out of memory");
+        set_number_oom(parser, start);
         return NULL;
     }
     value->arena = parser->arena;
@@ -1270,7 +1277,7 @@ create_integer_zero:
 create_bigint_zero:
     value = edn_arena_alloc_value(parser->arena);
     if (!value) {
-        set_number_error(parser, start, "Out of memory");
+        set_number_oom(parser, start);
         return NULL;
     }
     value->arena = parser->arena;
@@ -1285,7 +1292,7 @@ create_bigint_zero:
 create_bigdec_zero:
     value = edn_arena_alloc_value(parser->arena);
     if (!value) {
-        set_number_error(parser, start, "Out of memory");
+        set_number_oom(parser, start);
         return NULL;
     }
     value->arena = parser->arena;
@@ -1350,7 +1357,7 @@ create_ratio_zero:
     /* 0/N returns integer 0 (Clojure behavior) */
     value = edn_arena_alloc_value(parser->arena);
     if (!value) {
-        set_number_error(parser, start, "Out of memory");
+        set_number_oom(parser, start);
         return NULL;
     }
     value->arena = parser->arena;
@@ -7,6 +7,15 @@
 
 #include "edn_internal.h"
 
+#if defined(_WIN32)
+#include <windows.h>
+#define GENERATION_NEXT(p) ((uint64_t) InterlockedIncrement64((volatile LONG64*) (p)))
+#elif defined(__GNUC__) || defined(__clang__)
+#define GENERATION_NEXT(p) __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+#else
+#define GENERATION_NEXT(p) (++*(p))
+#endif
+
 /* Initial number of hash table buckets */
 #define INITIAL_BUCKET_COUNT 16
 
@@ -18,7 +27,9 @@
 typedef struct edn_reader_entry {
     char* tag;                     /* Owned copy of tag name */
     size_t tag_length;             /* Length of tag */
-    edn_reader_fn reader;          /* Reader function */
+    edn_reader_fn reader;          /* Reader function (NULL for raw readers) */
+    edn_raw_reader_fn raw_reader;  /* Raw-slice reader function (NULL for value readers) */
+    bool lazy;                     /* Defer reader invocation until first access */
     struct edn_reader_entry* next; /* For hash table chaining */
 } edn_reader_entry_t;
 
@@ -27,8 +38,13 @@ struct edn_reader_registry {
     edn_reader_entry_t** buckets; /* Hash table */
     size_t bucket_count;          /* Number of buckets */
     size_t entry_count;           /* Total entries */
+    uint64_t generation;          /* New value on every change (keys the parse cache) */
 };
 
+/* Generations are drawn from one process-wide counter, so a registry
+ * created at a destroyed one's address cannot repeat its generation */
+static uint64_t generation_counter = 0;
+
 /* FNV-1a hash function for tag strings */
 static uint64_t hash_tag(const char* tag, size_t length) {
     uint64_t hash = 14695981039346656037ULL; /* FNV offset basis */
@@ -53,6 +69,7 @@ edn_reader_registry_t* edn_reader_registry_create(void) {
 
     registry->bucket_count = INITIAL_BUCKET_COUNT;
     registry->entry_count = 0;
+    registry->generation = GENERATION_NEXT(&generation_counter);
 
     return registry;
 }
@@ -106,11 +123,9 @@ static void maybe_resize(edn_reader_registry_t* registry) {
     registry->bucket_count = new_count;
 }
 
-bool edn_reader_register(edn_reader_registry_t* registry, const char* tag, edn_reader_fn reader) {
-    if (registry == NULL || tag == NULL || reader == NULL) {
-        return false;
-    }
-
+/* Insert or replace the entry for tag; exactly one of reader/raw_reader is non-NULL. */
+static bool register_entry(edn_reader_registry_t* registry, const char* tag, edn_reader_fn reader,
+                           edn_raw_reader_fn raw_reader, bool lazy) {
     size_t tag_length = strlen(tag);
 
     /* Compute hash and bucket index */
@@ -123,6 +138,9 @@ bool edn_reader_register(edn_reader_registry_t* registry, const char* tag, edn_r
         if (entry->tag_length == tag_length && memcmp(entry->tag, tag, tag_length) == 0) {
             /* Update existing entry */
             entry->reader = reader;
+            entry->raw_reader = raw_reader;
+            entry->lazy = lazy;
+            registry->generation = GENERATION_NEXT(&generation_counter);
             return true;
         }
         entry = entry->next;
@@ -149,15 +167,41 @@ bool edn_reader_register(edn_reader_registry_t* registry, const char* tag, edn_r
     new_entry->tag[tag_length] = '\0';
     new_entry->tag_length = tag_length;
     new_entry->reader = reader;
+    new_entry->raw_reader = raw_reader;
+    new_entry->lazy = lazy;
 
     /* Insert at head of bucket chain */
     new_entry->next = registry->buckets[bucket_idx];
     registry->buckets[bucket_idx] = new_entry;
     registry->entry_count++;
+    registry->generation = GENERATION_NEXT(&generation_counter);
 
     return true;
 }
 
+bool edn_reader_register(edn_reader_registry_t* registry, const char* tag, edn_reader_fn reader) {
+    if (registry == NULL || tag == NULL || reader == NULL) {
+        return false;
+    }
+    return register_entry(registry, tag, reader, NULL, false);
+}
+
+bool edn_reader_register_lazy(edn_reader_registry_t* registry, const char* tag,
+                              edn_reader_fn reader) {
+    if (registry == NULL || tag == NULL || reader == NULL) {
+        return false;
+    }
+    return register_entry(registry, tag, reader, NULL, true);
+}
+
+bool edn_reader_register_raw(edn_reader_registry_t* registry, const char* tag,
+                             edn_raw_reader_fn reader) {
+    if (registry == NULL || tag == NULL || reader == NULL) {
+        return false;
+    }
+    return register_entry(registry, tag, NULL, reader, false);
+}
+
 void edn_reader_unregister(edn_reader_registry_t* registry, const char* tag) {
     if (registry == NULL || tag == NULL) {
         return;
@@ -179,6 +223,7 @@ void edn_reader_unregister(edn_reader_registry_t* registry, const char* tag) {
             free(entry->tag);
             free(entry);
             registry->entry_count--;
+            registry->generation = GENERATION_NEXT(&generation_counter);
             return;
         }
         entry_ptr = &entry->next;
@@ -209,10 +254,10 @@ edn_reader_fn edn_reader_lookup(const edn_reader_registry_t* registry, const cha
 }
 
 /* Internal lookup function that takes tag length (for non-null-terminated substrings) */
-edn_reader_fn edn_reader_lookup_internal(const edn_reader_registry_t* registry, const char* tag,
-                                         size_t tag_length) {
+bool edn_reader_lookup_internal(const edn_reader_registry_t* registry, const char* tag,
+                                size_t tag_length, edn_reader_binding_t* out) {
     if (registry == NULL || tag == NULL) {
-        return NULL;
+        return false;
     }
 
     /* Compute hash and bucket index */
@@ -223,10 +268,17 @@ edn_reader_fn edn_reader_lookup_internal(const edn_reader_registry_t* registry,
     edn_reader_entry_t* entry = registry->buckets[bucket_idx];
     while (entry != NULL) {
         if (entry->tag_length == tag_length && memcmp(entry->tag, tag, tag_length) == 0) {
-            return entry->reader;
+            out->reader = entry->reader;
+            out->raw_reader = entry->raw_reader;
+            out->lazy = entry->lazy;
+            return true;
         }
         entry = entry->next;
     }
 
-    return NULL;
+    return false;
+}
+
+uint64_t edn_reader_registry_generation(const edn_reader_registry_t* registry) {
+    return registry != NULL ? registry->generation : 0;
 }
@@ -0,0 +1,712 @@
+/**
+ * EDN.C - Incremental reparse
+ *
+ * edn_reparse brings a tree up to date with a text edit by parsing only
+ * the forms the edit touches. It walks down from the root to the innermost
+ * collection whose own delimiters enclose the edited bytes, reparses the
+ * run of children that overlap or touch them, and splices the new children
+ * in place. When that run does not parse back to exactly the same
+ * boundary (the edit opened a string or a comment, unbalanced a delimiter,
+ * produced a duplicate key, ...) the next enclosing collection is tried,
+ * and finally the whole input.
+ *
+ * Untouched values keep their source offsets in the text they were parsed
+ * from. Each splice appends the edit to a log on the arena and stamps the
+ * values it created with the log's new length (source_epoch), so
+ * edn_source_map can carry older offsets forward through the edits made
+ * since without visiting them.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "edn_internal.h"
+
+#define REPARSE_MAX_EDITS 1024   /* Full parse after this many splices into one arena */
+#define REPARSE_GARBAGE_RATIO 2  /* ... or once the arena grew this much since the first */
+#define REPARSE_PATH_INITIAL 32
+
+struct edn_source_edit {
+    size_t offset;
+    size_t removed;
+    size_t inserted;
+};
+
+typedef struct edn_source_edit edn_source_edit_t;
+
+/* ========================================================================
+ * Source offsets
+ * ======================================================================== */
+
+/* Starts at or after the removed bytes move; so do ends past them. A value
+ * ending right where bytes are inserted stays put. */
+static size_t map_offset(const edn_arena_t* arena, uint32_t epoch, size_t pos, bool is_end) {
+    for (uint32_t k = epoch; k < arena->source_epoch; k++) {
+        const edn_source_edit_t* edit = &arena->source_edits[k];
+        size_t edit_end = edit->offset + edit->removed;
+        if (is_end ? pos > edit_end : pos >= edit_end) {
+            pos = pos - edit->removed + edit->inserted;
+        }
+    }
+    return pos;
+}
+
+void edn_source_map(const edn_value_t* value, size_t* start, size_t* end) {
+    *start = value->source_start;
+    *end = value->source_end;
+    const edn_arena_t* arena = value->arena;
+    if (arena != NULL && value->source_epoch < arena->source_epoch) {
+        *start = map_offset(arena, value->source_epoch, *start, false);
+        *end = map_offset(arena, value->source_epoch, *end, true);
+    }
+}
+
+/* ========================================================================
+ * Tree walk
+ * ======================================================================== */
+
+static size_t child_count(const edn_value_t* value) {
+    switch (value->type) {
+        case EDN_TYPE_LIST:
+            return value->as.list.count;
+        case EDN_TYPE_VECTOR:
+            return value->as.vector.count;
+        case EDN_TYPE_SET:
+            return value->as.set.count;
+        case EDN_TYPE_MAP:
+            return value->as.map.count * 2;
+        default:
+            return 0;
+    }
+}
+
+/* Children in text order; map keys and values interleave */
+static edn_value_t* child_at(const edn_value_t* value, size_t i) {
+    switch (value->type) {
+        case EDN_TYPE_LIST:
+            return value->as.list.elements[i];
+        case EDN_TYPE_VECTOR:
+            return value->as.vector.elements[i];
+        case EDN_TYPE_SET:
+            return value->as.set.elements[i];
+        default:
+            return (i & 1) ? value->as.map.entries[i / 2].value : value->as.map.entries[i / 2].key;
+    }
+}
+
+/* Length of the opening delimiter when `value` is a collection written with
+ * its own delimiters at `start` in `text`; 0 for anything else (scalars,
+ * namespaced maps, forms carrying metadata). */
+static size_t open_length(const edn_value_t* value, const char* text, size_t start) {
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    if (value->metadata != NULL) {
+        return 0;
+    }
+#endif
+    switch (value->type) {
+        case EDN_TYPE_LIST:
+            return text[start] == '(' ? 1 : 0;
+        case EDN_TYPE_VECTOR:
+            return text[start] == '[' ? 1 : 0;
+        case EDN_TYPE_MAP:
+            return text[start] == '{' ? 1 : 0;
+        case EDN_TYPE_SET:
+            return text[start] == '#' && text[start + 1] == '{' ? 2 : 0;
+        default:
+            return 0;
+    }
+}
+
+typedef struct {
+    edn_value_t* value;
+    size_t start; /* Offsets in the old text */
+    size_t end;
+    size_t open; /* Opening delimiter length; 0 for tagged literals */
+} path_entry_t;
+
+typedef struct {
+    const char* old_input;
+    const char* new_input;
+    size_t new_length;
+    size_t offset; /* Edit, in old-text offsets */
+    size_t removed;
+    size_t inserted;
+    const edn_parse_options_t* options;
+    edn_arena_t* arena;
+    path_entry_t* path;
+    size_t path_count;
+    size_t path_capacity;
+    edn_value_t** forms; /* Reparsed children */
+    size_t form_count;
+    size_t form_capacity;
+} reparse_t;
+
+static bool path_push(reparse_t* r, edn_value_t* value, size_t start, size_t end, size_t open) {
+    if (r->path_count == r->path_capacity) {
+        size_t capacity = r->path_capacity ? r->path_capacity * 2 : REPARSE_PATH_INITIAL;
+        path_entry_t* grown = realloc(r->path, capacity * sizeof(path_entry_t));
+        if (grown == NULL) {
+            return false;
+        }
+        r->path = grown;
+        r->path_capacity = capacity;
+    }
+    r->path[r->path_count++] = (path_entry_t) {value, start, end, open};
+    return true;
+}
+
+static bool encloses_edit(const reparse_t* r, size_t start, size_t end, size_t open) {
+    return open > 0 && start + open <= r->offset && r->offset + r->removed < end;
+}
+
+/* Record the collections (and tagged literals around them) that enclose
+ * the edit, outermost first. The root itself must enclose it. */
+static bool find_path(reparse_t* r, edn_value_t* root) {
+    size_t start, end;
+    edn_source_map(root, &start, &end);
+    size_t open = open_length(root, r->old_input, start);
+    if (!encloses_edit(r, start, end, open) || !path_push(r, root, start, end, open)) {
+        return false;
+    }
+
+    edn_value_t* node = root;
+    while (true) {
+        /* Last child starting at or before the edit */
+        size_t lo = 0;
+        size_t hi = child_count(node);
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            size_t s, e;
+            edn_source_map(child_at(node, mid), &s, &e);
+            if (s <= r->offset) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo == 0) {
+            return true;
+        }
+
+        size_t depth = r->path_count;
+        edn_value_t* child = child_at(node, lo - 1);
+        while (child->type == EDN_TYPE_TAGGED && child->as.tagged.lazy == NULL) {
+            edn_source_map(child, &start, &end);
+            if (!path_push(r, child, start, end, 0)) {
+                return false;
+            }
+            child = child->as.tagged.value;
+        }
+        edn_source_map(child, &start, &end);
+        open = open_length(child, r->old_input, start);
+        if (!encloses_edit(r, start, end, open)) {
+            r->path_count = depth; /* Drop tagged literals that lead nowhere */
+            return true;
+        }
+        if (!path_push(r, child, start, end, open)) {
+            return false;
+        }
+        node = child;
+    }
+}
+
+/* ========================================================================
+ * Splicing
+ * ======================================================================== */
+
+typedef enum {
+    SPLICE_DONE,
+    SPLICE_RETRY, /* Try the enclosing collection */
+    SPLICE_FAILED /* Stop: error set on the parser (cancelled, out of memory) */
+} splice_status_t;
+
+static bool form_push(reparse_t* r, edn_value_t* value) {
+    if (r->form_count == r->form_capacity) {
+        size_t capacity = r->form_capacity ? r->form_capacity * 2 : 16;
+        edn_value_t** grown = realloc(r->forms, capacity * sizeof(edn_value_t*));
+        if (grown == NULL) {
+            return false;
+        }
+        r->forms = grown;
+        r->form_capacity = capacity;
+    }
+    r->forms[r->form_count++] = value;
+    return true;
+}
+
+static splice_status_t parse_failed(edn_parser_t* parser) {
+    switch (parser->error) {
+        case EDN_ERROR_CANCELLED:
+        case EDN_ERROR_DEADLINE_EXCEEDED:
+        case EDN_ERROR_OUT_OF_MEMORY:
+            return SPLICE_FAILED;
+        default:
+            return SPLICE_RETRY;
+    }
+}
+
+/* Parse the forms in new_input[from, stop) as children at `depth`. They
+ * must end exactly at `stop`: a token, string or comment running past it
+ * means the reused child there would no longer start a form. */
+static splice_status_t parse_run(reparse_t* r, edn_parser_t* parser, size_t from, size_t stop) {
+    const char* limit = r->new_input + stop;
+    parser->current = r->new_input + from;
+    r->form_count = 0;
+
+    while (true) {
+        edn_skip_whitespace(parser);
+        if (parser->current == limit) {
+            return SPLICE_DONE;
+        }
+        if (parser->current > limit || parser->current >= parser->end) {
+            return SPLICE_RETRY;
+        }
+        char c = *parser->current;
+        if (c == ')' || c == ']' || c == '}') {
+            return SPLICE_RETRY;
+        }
+        if (!edn_budget_ok(parser)) {
+            return SPLICE_FAILED;
+        }
+        if (c == '#' && parser->current + 1 < parser->end && parser->current[1] == '_') {
+            if (!edn_enter_depth(parser)) {
+                return SPLICE_RETRY;
+            }
+            edn_read_discarded_value(parser);
+            edn_leave_depth(parser);
+            if (parser->error != EDN_OK) {
+                return parse_failed(parser);
+            }
+            continue;
+        }
+        edn_value_t* value = edn_read_value(parser);
+        if (value == NULL) {
+            return parser->error != EDN_OK ? parse_failed(parser) : SPLICE_RETRY;
+        }
+        if (parser->current > limit) {
+            return SPLICE_RETRY;
+        }
+        if (!form_push(r, value)) {
+            edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
+                                 "Out of memory while reparsing", parser->current,
+                                 parser->current);
+            return SPLICE_FAILED;
+        }
+    }
+}
+
+static void stamp_epoch(edn_value_t* value, uint32_t epoch) {
+    if (value == NULL) {
+        return;
+    }
+    value->source_epoch = epoch;
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    stamp_epoch(value->metadata, epoch);
+#endif
+    if (value->type == EDN_TYPE_TAGGED) {
+        stamp_epoch(value->as.tagged.value, epoch);
+        return;
+    }
+    for (size_t i = 0, n = child_count(value); i < n; i++) {
+        stamp_epoch(child_at(value, i), epoch);
+    }
+}
+
+/* Whether path entry `i` compares the next entry on the path with its
+ * siblings: a set does, and so does a map when that entry is a key */
+static bool compares_path_child(const reparse_t* r, size_t i) {
+    const edn_value_t* coll = r->path[i].value;
+    if (coll->type == EDN_TYPE_SET) {
+        return true;
+    }
+    if (coll->type != EDN_TYPE_MAP) {
+        return false;
+    }
+    const edn_value_t* next = r->path[i + 1].value;
+    for (size_t k = 0; k < coll->as.map.count; k++) {
+        if (coll->as.map.entries[k].key == next) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* After a splice at `level`, the sets and keyed maps enclosing it must
+ * still hold distinct elements and keys, as a full parse checks */
+static bool ancestors_distinct(const reparse_t* r, size_t level) {
+    for (size_t i = 0; i <= level; i++) {
+        r->path[i].value->cached_hash = 0;
+    }
+    for (size_t i = level; i-- > 0;) {
+        if (!compares_path_child(r, i)) {
+            continue;
+        }
+        edn_value_t* coll = r->path[i].value;
+        if (coll->type == EDN_TYPE_SET) {
+            if (edn_has_duplicates(coll->as.set.elements, coll->as.set.count)) {
+                return false;
+            }
+            continue;
+        }
+        size_t entries = coll->as.map.count;
+        edn_value_t** keys = malloc(entries * sizeof(edn_value_t*));
+        if (keys == NULL) {
+            return false; /* The full parse reports it */
+        }
+        for (size_t k = 0; k < entries; k++) {
+            keys[k] = coll->as.map.entries[k].key;
+        }
+        bool duplicates = edn_has_duplicates(keys, entries);
+        free(keys);
+        if (duplicates) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Replace children [first, last) of the collection at path entry `level`
+ * with the reparsed forms */
+static splice_status_t replace_children(reparse_t* r, edn_parser_t* parser, size_t level,
+                                        size_t first, size_t last) {
+    edn_value_t* coll = r->path[level].value;
+    size_t count = child_count(coll);
+    size_t added = r->form_count;
+    size_t kept = count - (last - first);
+    size_t total = kept + added;
+
+    /* When an enclosing set or map compares this collection with its
+     * siblings, build new arrays so a duplicate can restore the old ones */
+    bool recheck = false;
+    for (size_t i = 0; i < level && !recheck; i++) {
+        recheck = compares_path_child(r, i);
+    }
+    const edn_value_t saved = *coll;
+
+    if (coll->type == EDN_TYPE_MAP) {
+        if (added % 2 != 0) {
+            return SPLICE_RETRY; /* The full parse reports the odd map */
+        }
+        size_t entries = total / 2;
+        edn_map_entry_t* old = coll->as.map.entries;
+        edn_map_entry_t* next = old;
+        if (added > last - first || recheck) {
+            next = edn_arena_alloc(r->arena, entries * sizeof(edn_map_entry_t));
+        }
+        edn_value_t** keys = malloc((entries > 0 ? entries : 1) * sizeof(edn_value_t*));
+        if (next == NULL || keys == NULL) {
+            free(keys);
+            edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY, "Out of memory while reparsing",
+                                 parser->current, parser->current);
+            return SPLICE_FAILED;
+        }
+
+        /* Check the would-be keys before touching the map */
+        size_t k = 0;
+        for (size_t i = 0; i < first / 2; i++) {
+            keys[k++] = old[i].key;
+        }
+        for (size_t i = 0; i < added / 2; i++) {
+            keys[k++] = r->forms[2 * i];
+        }
+        for (size_t i = last / 2; i < count / 2; i++) {
+            keys[k++] = old[i].key;
+        }
+        bool duplicates = entries > 1 && edn_has_duplicates(keys, entries);
+        free(keys);
+        if (duplicates) {
+            return SPLICE_RETRY;
+        }
+
+        if (next != old && first > 0) {
+            memcpy(next, old, (first / 2) * sizeof(edn_map_entry_t));
+        }
+        if (last < count) {
+            memmove(next + (first + added) / 2, old + last / 2,
+                    (count - last) / 2 * sizeof(edn_map_entry_t));
+        }
+        for (size_t i = 0; i < added / 2; i++) {
+            edn_map_entry_init(&next[first / 2 + i], r->forms[2 * i], r->forms[2 * i + 1]);
+        }
+        coll->as.map.entries = next;
+        coll->as.map.count = entries;
+        if (recheck && !ancestors_distinct(r, level)) {
+            coll->as = saved.as;
+            return SPLICE_RETRY;
+        }
+        return SPLICE_DONE;
+    }
+
+    edn_value_t** old;
+    switch (coll->type) {
+        case EDN_TYPE_LIST:
+            old = coll->as.list.elements;
+            break;
+        case EDN_TYPE_VECTOR:
+            old = coll->as.vector.elements;
+            break;
+        default:
+            old = coll->as.set.elements;
+            break;
+    }
+
+    /* Sets build the new array first so duplicates leave the set as it was */
+    edn_value_t** next = old;
+    if (added > last - first || coll->type == EDN_TYPE_SET || recheck) {
+        next = total > 0 ? edn_arena_alloc(r->arena, total * sizeof(edn_value_t*)) : NULL;
+        if (next == NULL && total > 0) {
+            edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY, "Out of memory while reparsing",
+                                 parser->current, parser->current);
+            return SPLICE_FAILED;
+        }
+        if (first > 0) {
+            memcpy(next, old, first * sizeof(edn_value_t*));
+        }
+    }
+    if (last < count) {
+        memmove(next + first + added, old + last, (count - last) * sizeof(edn_value_t*));
+    }
+    if (added > 0) {
+        memcpy(next + first, r->forms, added * sizeof(edn_value_t*));
+    }
+    if (coll->type == EDN_TYPE_SET && total > 1 && edn_has_duplicates(next, total)) {
+        return SPLICE_RETRY;
+    }
+
+    switch (coll->type) {
+        case EDN_TYPE_LIST:
+            coll->as.list.elements = total > 0 ? next : NULL;
+            coll->as.list.count = total;
+            break;
+        case EDN_TYPE_VECTOR:
+            coll->as.vector.elements = total > 0 ? next : NULL;
+            coll->as.vector.count = total;
+            break;
+        default:
+            coll->as.set.elements = total > 0 ? next : NULL;
+            coll->as.set.count = total;
+            break;
+    }
+    if (recheck && !ancestors_distinct(r, level)) {
+        coll->as = saved.as;
+        return SPLICE_RETRY;
+    }
+    return SPLICE_DONE;
+}
+
+/* Reparse the children of path entry `level` that the edit touches */
+static splice_status_t splice_at(reparse_t* r, edn_parser_t* parser, size_t level) {
+    const path_entry_t* entry = &r->path[level];
+    edn_value_t* coll = entry->value;
+    size_t count = child_count(coll);
+    size_t edit_end = r->offset + r->removed;
+
+    /* Children before `first` end before the edit, those from `last` on
+     * start after it; anything touching it is reparsed, as its token may
+     * now run on. Maps replace whole entries. */
+    size_t first = 0;
+    size_t hi = count;
+    while (first < hi) {
+        size_t mid = first + (hi - first) / 2;
+        size_t s, e;
+        edn_source_map(child_at(coll, mid), &s, &e);
+        if (e < r->offset) {
+            first = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    size_t last = first;
+    hi = count;
+    while (last < hi) {
+        size_t mid = last + (hi - last) / 2;
+        size_t s, e;
+        edn_source_map(child_at(coll, mid), &s, &e);
+        if (s <= edit_end) {
+            last = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (coll->type == EDN_TYPE_MAP) {
+        first &= ~(size_t) 1;
+        last += last & 1;
+    }
+
+    size_t s, e;
+    size_t from = entry->start + entry->open;
+    if (first > 0) {
+        edn_source_map(child_at(coll, first - 1), &s, &e);
+        from = e;
+    }
+    size_t stop = entry->end - 1;
+    if (last < count) {
+        edn_source_map(child_at(coll, last), &s, &e);
+        stop = s;
+    }
+    stop = stop - r->removed + r->inserted;
+
+    parser->depth = level + 1;
+    parser->child_count = 0;
+    parser->error = EDN_OK;
+    parser->error_message = NULL;
+    splice_status_t status = parse_run(r, parser, from, stop);
+    if (status != SPLICE_DONE) {
+        return status;
+    }
+    return replace_children(r, parser, level, first, last);
+}
+
+/* Make room for the edit in the arena's log before anything changes */
+static bool reserve_edit(reparse_t* r) {
+    edn_arena_t* arena = r->arena;
+    if (arena->source_epoch == arena->source_edit_capacity) {
+        uint32_t capacity = arena->source_edit_capacity ? arena->source_edit_capacity * 2 : 16;
+        edn_source_edit_t* grown =
+            realloc(arena->source_edits, capacity * sizeof(edn_source_edit_t));
+        if (grown == NULL) {
+            return false;
+        }
+        arena->source_edits = grown;
+        arena->source_edit_capacity = capacity;
+    }
+    return true;
+}
+
+/* ========================================================================
+ * Public API
+ * ======================================================================== */
+
+static edn_result_t reparse_fully(edn_value_t* old_root, const char* new_input, size_t length,
+                                  const edn_parse_options_t* options) {
+    edn_result_t result = edn_read_with_options(new_input, length, options);
+    if (result.error == EDN_OK && result.value != old_root) {
+        edn_free(old_root);
+    }
+    return result;
+}
+
+/* Options that make tagged literals more than a tag and a form; reparsing
+ * part of a reader's input would skip the reader */
+static bool options_allow_splicing(const edn_parse_options_t* options) {
+    if (options == NULL) {
+        return true;
+    }
+    size_t sz = options->struct_size == 0 ? sizeof(edn_parse_options_t) : options->struct_size;
+    if (sz >= offsetof(edn_parse_options_t, reader_registry) + sizeof(options->reader_registry) &&
+        options->reader_registry != NULL) {
+        return false;
+    }
+    if (sz >= offsetof(edn_parse_options_t, default_reader_mode) +
+                  sizeof(options->default_reader_mode) &&
+        options->default_reader_mode != EDN_DEFAULT_READER_PASSTHROUGH) {
+        return false;
+    }
+    return true;
+}
+
+static void init_parser(edn_parser_t* parser, const reparse_t* r) {
+    const edn_parse_options_t* options = r->options;
+    edn_parser_init(parser, r->new_input, r->new_length);
+    parser->arena = r->arena;
+    if (options != NULL) {
+        size_t sz = options->struct_size == 0 ? sizeof(edn_parse_options_t) : options->struct_size;
+        if (sz >= offsetof(edn_parse_options_t, max_depth) + sizeof(options->max_depth) &&
+            options->max_depth > 0) {
+            parser->max_depth = options->max_depth;
+        }
+        if (sz >= offsetof(edn_parse_options_t, strict_utf8) + sizeof(options->strict_utf8)) {
+            parser->strict_utf8 = options->strict_utf8;
+        }
+        if (sz >= offsetof(edn_parse_options_t, budget) + sizeof(options->budget)) {
+            parser->budget = options->budget;
+        }
+    }
+    parser->budget_checkpoint = parser->budget != NULL ? parser->input : parser->end;
+}
+
+edn_result_t edn_reparse(edn_value_t* old_root, const char* old_input, const char* new_input,
+                         size_t new_length, size_t edit_offset, size_t removed_len,
+                         size_t inserted_len, const edn_parse_options_t* options) {
+    if (new_input != NULL && new_length == 0) {
+        new_length = strlen(new_input);
+    }
+    edn_arena_t* arena = old_root != NULL ? old_root->arena : NULL;
+    if (arena == NULL || arena->cache_entry != NULL || old_input == NULL || new_input == NULL ||
+        edit_offset > new_length || inserted_len > new_length - edit_offset ||
+        !options_allow_splicing(options)) {
+        return reparse_fully(old_root, new_input, new_length, options);
+    }
+
+    size_t root_start, root_end;
+    edn_source_map(old_root, &root_start, &root_end);
+    bool delimited = open_length(old_root, old_input, root_start) > 0;
+    if ((removed_len == 0 && inserted_len == 0) || (delimited && edit_offset >= root_end)) {
+        /* Nothing changed, or only text after a collection root, which is not read */
+        edn_result_t result = {0};
+        result.value = old_root;
+        return result;
+    }
+    if (arena->source_epoch >= REPARSE_MAX_EDITS ||
+        (arena->source_baseline > 0 &&
+         arena->total_allocated > arena->source_baseline * REPARSE_GARBAGE_RATIO)) {
+        return reparse_fully(old_root, new_input, new_length, options);
+    }
+
+    reparse_t r = {0};
+    r.old_input = old_input;
+    r.new_input = new_input;
+    r.new_length = new_length;
+    r.offset = edit_offset;
+    r.removed = removed_len;
+    r.inserted = inserted_len;
+    r.options = options;
+    r.arena = arena;
+
+    edn_result_t result = {0};
+    size_t baseline = arena->total_allocated;
+    if (!find_path(&r, old_root) || !reserve_edit(&r)) {
+        free(r.path);
+        return reparse_fully(old_root, new_input, new_length, options);
+    }
+
+    edn_parser_t parser;
+    init_parser(&parser, &r);
+    splice_status_t status = SPLICE_RETRY;
+    size_t level = r.path_count;
+    while (level > 0 && status == SPLICE_RETRY) {
+        level--;
+        if (r.path[level].open > 0) {
+            status = splice_at(&r, &parser, level);
+        }
+    }
+
+    if (status == SPLICE_DONE) {
+        uint32_t epoch = arena->source_epoch + 1;
+        for (size_t i = 0; i < r.form_count; i++) {
+            stamp_epoch(r.forms[i], epoch);
+        }
+        for (size_t i = 0; i <= level; i++) {
+            r.path[i].value->cached_hash = 0;
+        }
+        arena->source_edits[arena->source_epoch] =
+            (edn_source_edit_t) {edit_offset, removed_len, inserted_len};
+        arena->source_epoch = epoch;
+        if (arena->source_baseline == 0) {
+            arena->source_baseline = baseline;
+        }
+        result.value = old_root;
+    } else if (status == SPLICE_FAILED) {
+        result.error = parser.error;
+        result.error_message = parser.error_message;
+        edn_result_set_error_positions(&result, &parser);
+    }
+
+    free(parser.child_stack);
+    free(r.forms);
+    free(r.path);
+    if (status == SPLICE_RETRY) {
+        return reparse_fully(old_root, new_input, new_length, options);
+    }
+    return result;
+}
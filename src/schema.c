@@ -0,0 +1,1402 @@
+/**
+ * EDN.C - Streaming schema validation
+ *
+ * Compiles schemas written in EDN into a tree of spec nodes held in one
+ * arena, then checks documents against them from edn_parse_events
+ * callbacks. A frame is pushed for every collection the schema describes;
+ * forms the schema leaves open (:any, values of unknown keys) are counted
+ * and skipped, so the scan stops at the first form that breaks the schema.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "edn_internal.h"
+
+#define SCHEMA_MAX_DEPTH 64   /* Nested collection schemas */
+#define SCHEMA_MAX_ENTRIES 64 /* Width of the seen/required bitmasks */
+#define SCHEMA_KEY_COPY 24    /* Bytes of a string map key kept for error paths */
+
+/* Value classes; a spec accepts a set of them */
+#define V_NIL (1u << 0)
+#define V_BOOL (1u << 1)
+#define V_INT (1u << 2)
+#define V_BIGINT (1u << 3)
+#define V_DOUBLE (1u << 4)
+#define V_BIGDEC (1u << 5)
+#define V_RATIO (1u << 6)
+#define V_STRING (1u << 7)
+#define V_KEYWORD (1u << 8)
+#define V_SYMBOL (1u << 9)
+#define V_CHAR (1u << 10)
+#define V_LIST (1u << 11)
+#define V_VECTOR (1u << 12)
+#define V_SET (1u << 13)
+#define V_MAP (1u << 14)
+#define V_NUMBER (V_INT | V_BIGINT | V_DOUBLE | V_BIGDEC | V_RATIO)
+#define V_ALL ((V_MAP << 1) - 1)
+
+typedef enum {
+    SPEC_ANY,
+    SPEC_SCALAR,     /* Type check only */
+    SPEC_NUMBER,     /* Bounds the value */
+    SPEC_STRING,     /* Bounds the decoded length */
+    SPEC_ENUM,       /* One of `values` */
+    SPEC_MAP,        /* Keyword entries */
+    SPEC_MAP_OF,     /* `key` and `element` for every entry */
+    SPEC_COLLECTION, /* `element` for every element */
+    SPEC_TUPLE       /* `items`, one per position */
+} spec_kind_t;
+
+typedef struct spec spec_t;
+
+typedef struct {
+    bool set;
+    bool is_int;
+    int64_t i; /* Integer bounds only */
+    double d;  /* Always set */
+} spec_bound_t;
+
+typedef struct {
+    const char* key; /* "ns/name" or "name" */
+    size_t key_length;
+    const spec_t* spec;
+    bool optional;
+} spec_entry_t;
+
+typedef struct {
+    uint32_t cls; /* V_KEYWORD, V_STRING or V_INT */
+    int64_t integer;
+    const char* text; /* Keyword "ns/name" or string bytes */
+    size_t length;
+} spec_value_t;
+
+struct spec {
+    spec_kind_t kind;
+    uint32_t accepts;
+    spec_bound_t min;
+    spec_bound_t max;
+    const spec_t* element;  /* Collection element or map-of value; NULL = any */
+    const spec_t* key;      /* Map-of key */
+    const spec_t** items;   /* Tuple */
+    spec_entry_t* entries;  /* Map */
+    spec_value_t* values;   /* Enum */
+    size_t count;           /* Items, entries or values */
+    uint8_t* slots;         /* Map: hash slot -> entry index + 1 (0 = empty) */
+    size_t mask;
+    uint64_t required; /* Map: bit i set when entries[i] is required */
+    bool closed;       /* Map: reject keys without an entry */
+};
+
+struct edn_schema {
+    edn_arena_t* arena; /* Owns every spec node and string */
+    const spec_t* root;
+};
+
+/* FNV-1a over "ns/name" (or "name") */
+static uint64_t key_hash(const char* ns, size_t ns_length, const char* name, size_t name_length) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    if (ns != NULL) {
+        for (size_t i = 0; i < ns_length; i++) {
+            h = (h ^ (uint8_t) ns[i]) * 0x100000001b3ULL;
+        }
+        h = (h ^ (uint8_t) '/') * 0x100000001b3ULL;
+    }
+    for (size_t i = 0; i < name_length; i++) {
+        h = (h ^ (uint8_t) name[i]) * 0x100000001b3ULL;
+    }
+    return h ^ (h >> 29);
+}
+
+/* Compare "ns/name" (or "name") against a stored "ns/name" */
+static bool keyword_equals(const char* text, size_t length, const char* ns, size_t ns_length,
+                           const char* name, size_t name_length) {
+    if (ns != NULL) {
+        if (length != ns_length + 1 + name_length || memcmp(text, ns, ns_length) != 0 ||
+            text[ns_length] != '/') {
+            return false;
+        }
+        text += ns_length + 1;
+    } else if (length != name_length) {
+        return false;
+    }
+    return memcmp(text, name, name_length) == 0;
+}
+
+static const spec_entry_t* lookup_entry(const spec_t* spec, const char* ns, size_t ns_length,
+                                        const char* name, size_t name_length, size_t* index) {
+    size_t slot = key_hash(ns, ns_length, name, name_length) & spec->mask;
+    while (spec->slots[slot] != 0) {
+        size_t i = spec->slots[slot] - 1;
+        const spec_entry_t* entry = &spec->entries[i];
+        if (keyword_equals(entry->key, entry->key_length, ns, ns_length, name, name_length)) {
+            *index = i;
+            return entry;
+        }
+        slot = (slot + 1) & spec->mask;
+    }
+    return NULL;
+}
+
+/* ========================================================================
+ * Compilation
+ * ======================================================================== */
+
+typedef enum { BOUNDS_NONE, BOUNDS_VALUE, BOUNDS_COUNT } bounds_kind_t;
+
+typedef struct {
+    const char* name;
+    spec_kind_t kind;
+    uint32_t accepts;
+    bounds_kind_t bounds;
+} spec_type_t;
+
+static const spec_type_t SPEC_TYPES[] = {
+    {"any", SPEC_ANY, V_ALL, BOUNDS_NONE},
+    {"nil", SPEC_SCALAR, V_NIL, BOUNDS_NONE},
+    {"boolean", SPEC_SCALAR, V_BOOL, BOUNDS_NONE},
+    {"keyword", SPEC_SCALAR, V_KEYWORD, BOUNDS_NONE},
+    {"symbol", SPEC_SCALAR, V_SYMBOL, BOUNDS_NONE},
+    {"char", SPEC_SCALAR, V_CHAR, BOUNDS_NONE},
+    {"int", SPEC_NUMBER, V_INT | V_BIGINT, BOUNDS_VALUE},
+    {"double", SPEC_NUMBER, V_DOUBLE, BOUNDS_VALUE},
+    {"number", SPEC_NUMBER, V_NUMBER, BOUNDS_VALUE},
+    {"string", SPEC_STRING, V_STRING, BOUNDS_COUNT},
+    {"enum", SPEC_ENUM, 0, BOUNDS_NONE},
+    {"map", SPEC_MAP, V_MAP, BOUNDS_NONE},
+    {"map-of", SPEC_MAP_OF, V_MAP, BOUNDS_COUNT},
+    {"vector", SPEC_COLLECTION, V_VECTOR, BOUNDS_COUNT},
+    {"list", SPEC_COLLECTION, V_LIST, BOUNDS_COUNT},
+    {"set", SPEC_COLLECTION, V_SET, BOUNDS_COUNT},
+    {"sequential", SPEC_COLLECTION, V_LIST | V_VECTOR, BOUNDS_COUNT},
+    {"tuple", SPEC_TUPLE, V_VECTOR, BOUNDS_NONE},
+};
+
+typedef struct {
+    edn_arena_t* arena;
+    const char* error;
+} compile_state_t;
+
+static void* compile_fail(compile_state_t* c, const char* message) {
+    if (c->error == NULL) {
+        c->error = message;
+    }
+    return NULL;
+}
+
+static void* compile_alloc(compile_state_t* c, size_t size) {
+    void* p = edn_arena_alloc(c->arena, size);
+    if (p == NULL) {
+        return compile_fail(c, "Out of memory");
+    }
+    memset(p, 0, size);
+    return p;
+}
+
+/* Copy "ns/name" (or "name") into the arena */
+static char* compile_text(compile_state_t* c, const char* ns, size_t ns_length, const char* name,
+                          size_t name_length, size_t* length) {
+    *length = (ns != NULL ? ns_length + 1 : 0) + name_length;
+    char* text = compile_alloc(c, *length + 1);
+    if (text == NULL) {
+        return NULL;
+    }
+    char* p = text;
+    if (ns != NULL) {
+        memcpy(p, ns, ns_length);
+        p += ns_length;
+        *p++ = '/';
+    }
+    memcpy(p, name, name_length);
+    return text;
+}
+
+/* A keyword without namespace, e.g. the `min` of `:min` */
+static bool simple_keyword(const edn_value_t* form, const char** name, size_t* name_length) {
+    const char* ns;
+    size_t ns_length;
+    return edn_keyword_get(form, &ns, &ns_length, name, name_length) && ns == NULL;
+}
+
+static bool name_is(const char* name, size_t length, const char* expected) {
+    return strlen(expected) == length && memcmp(name, expected, length) == 0;
+}
+
+static bool compile_bound(const edn_value_t* form, bounds_kind_t bounds, spec_bound_t* bound) {
+    int64_t i;
+    double d;
+    if (edn_int64_get(form, &i)) {
+        if (bounds == BOUNDS_COUNT && i < 0) {
+            return false;
+        }
+        bound->is_int = true;
+        bound->i = i;
+        bound->d = (double) i;
+    } else if (bounds == BOUNDS_VALUE && edn_double_get(form, &d) && d == d) {
+        bound->d = d;
+    } else {
+        return false;
+    }
+    bound->set = true;
+    return true;
+}
+
+static bool compile_props(compile_state_t* c, spec_t* spec, const edn_value_t* props,
+                          bounds_kind_t bounds) {
+    size_t count = edn_map_count(props);
+    for (size_t i = 0; i < count; i++) {
+        const edn_value_t* value = edn_map_get_value(props, i);
+        const char* name;
+        size_t length;
+        bool ok = false;
+        if (!simple_keyword(edn_map_get_key(props, i), &name, &length)) {
+            ok = false;
+        } else if (name_is(name, length, "min") && bounds != BOUNDS_NONE) {
+            ok = compile_bound(value, bounds, &spec->min);
+        } else if (name_is(name, length, "max") && bounds != BOUNDS_NONE) {
+            ok = compile_bound(value, bounds, &spec->max);
+        } else if (name_is(name, length, "closed") && spec->kind == SPEC_MAP) {
+            ok = edn_bool_get(value, &spec->closed);
+        }
+        if (!ok) {
+            compile_fail(c, "Invalid schema property");
+            return false;
+        }
+    }
+    if (spec->min.set && spec->max.set && spec->min.d > spec->max.d) {
+        compile_fail(c, "Invalid schema property");
+        return false;
+    }
+    return true;
+}
+
+static spec_t* compile_spec(compile_state_t* c, const edn_value_t* form, size_t level);
+
+static bool compile_entry(compile_state_t* c, spec_t* spec, size_t index,
+                          const edn_value_t* form, size_t level) {
+    size_t count = edn_vector_count(form);
+    const char* ns;
+    size_t ns_length;
+    const char* name;
+    size_t name_length;
+    if ((count != 2 && count != 3) ||
+        !edn_keyword_get(edn_vector_get(form, 0), &ns, &ns_length, &name, &name_length)) {
+        compile_fail(c, "Invalid map schema entry");
+        return false;
+    }
+
+    spec_entry_t* entry = &spec->entries[index];
+    if (count == 3) {
+        const edn_value_t* props = edn_vector_get(form, 1);
+        if (edn_type(props) != EDN_TYPE_MAP) {
+            compile_fail(c, "Invalid map schema entry");
+            return false;
+        }
+        for (size_t i = 0; i < edn_map_count(props); i++) {
+            const char* prop;
+            size_t prop_length;
+            if (!simple_keyword(edn_map_get_key(props, i), &prop, &prop_length) ||
+                !name_is(prop, prop_length, "optional") ||
+                !edn_bool_get(edn_map_get_value(props, i), &entry->optional)) {
+                compile_fail(c, "Invalid schema property");
+                return false;
+            }
+        }
+    }
+
+    for (size_t j = 0; j < index; j++) {
+        if (keyword_equals(spec->entries[j].key, spec->entries[j].key_length, ns, ns_length, name,
+                           name_length)) {
+            compile_fail(c, "Duplicate key in map schema");
+            return false;
+        }
+    }
+    entry->key = compile_text(c, ns, ns_length, name, name_length, &entry->key_length);
+    entry->spec = compile_spec(c, edn_vector_get(form, count - 1), level + 1);
+    if (entry->key == NULL || entry->spec == NULL) {
+        return false;
+    }
+    if (!entry->optional) {
+        spec->required |= (uint64_t) 1 << index;
+    }
+    return true;
+}
+
+/* Entries are the `n` forms from index `first`; a bare :map has none */
+static bool compile_map(compile_state_t* c, spec_t* spec, const edn_value_t* form, size_t first,
+                        size_t n, size_t level) {
+    if (n > SCHEMA_MAX_ENTRIES) {
+        compile_fail(c, "Too many keys in map schema");
+        return false;
+    }
+    size_t size = 1;
+    while (size < n * 2) {
+        size <<= 1;
+    }
+    spec->count = n;
+    spec->mask = size - 1;
+    spec->entries = compile_alloc(c, (n ? n : 1) * sizeof(spec_entry_t));
+    spec->slots = compile_alloc(c, size);
+    if (spec->entries == NULL || spec->slots == NULL) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const edn_value_t* entry = edn_vector_get(form, first + i);
+        if (edn_type(entry) != EDN_TYPE_VECTOR) {
+            compile_fail(c, "Invalid map schema entry");
+            return false;
+        }
+        if (!compile_entry(c, spec, i, entry, level)) {
+            return false;
+        }
+        size_t slot = key_hash(NULL, 0, spec->entries[i].key, spec->entries[i].key_length) &
+                      spec->mask;
+        while (spec->slots[slot] != 0) {
+            slot = (slot + 1) & spec->mask;
+        }
+        spec->slots[slot] = (uint8_t) (i + 1);
+    }
+    return true;
+}
+
+static bool compile_enum(compile_state_t* c, spec_t* spec, const edn_value_t* form,
+                         size_t first) {
+    size_t n = edn_vector_count(form) - first;
+    spec->count = n;
+    spec->values = compile_alloc(c, (n ? n : 1) * sizeof(spec_value_t));
+    if (n == 0 || spec->values == NULL) {
+        compile_fail(c, "Invalid enum value");
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const edn_value_t* item = edn_vector_get(form, first + i);
+        spec_value_t* value = &spec->values[i];
+        const char* ns;
+        size_t ns_length;
+        const char* name;
+        size_t name_length;
+        if (edn_keyword_get(item, &ns, &ns_length, &name, &name_length)) {
+            value->cls = V_KEYWORD;
+            value->text = compile_text(c, ns, ns_length, name, name_length, &value->length);
+        } else if ((name = edn_string_get(item, &name_length)) != NULL) {
+            value->cls = V_STRING;
+            value->text = compile_text(c, NULL, 0, name, name_length, &value->length);
+        } else if (edn_int64_get(item, &value->integer)) {
+            value->cls = V_INT;
+            value->text = "";
+        } else {
+            compile_fail(c, "Invalid enum value");
+            return false;
+        }
+        if (value->text == NULL) {
+            return false;
+        }
+        spec->accepts |= value->cls;
+    }
+    return true;
+}
+
+/* `level` counts enclosing collection schemas; each one needs a frame */
+static spec_t* compile_spec(compile_state_t* c, const edn_value_t* form, size_t level) {
+    const edn_value_t* head = form;
+    size_t argc = 1;
+    if (edn_type(form) == EDN_TYPE_VECTOR) {
+        argc = edn_vector_count(form);
+        head = edn_vector_get(form, 0);
+    }
+
+    const char* name;
+    size_t length;
+    if (head == NULL || !simple_keyword(head, &name, &length)) {
+        return compile_fail(c, "Invalid schema form");
+    }
+
+    size_t first = 1;
+    const edn_value_t* props = NULL;
+    if (argc > 1 && edn_type(edn_vector_get(form, 1)) == EDN_TYPE_MAP) {
+        props = edn_vector_get(form, 1);
+        first = 2;
+    }
+    size_t children = argc - first;
+
+    if (name_is(name, length, "maybe")) {
+        if (props != NULL || children != 1) {
+            return compile_fail(c, "Invalid schema form");
+        }
+        spec_t* inner = compile_spec(c, edn_vector_get(form, first), level);
+        if (inner != NULL) {
+            inner->accepts |= V_NIL;
+        }
+        return inner;
+    }
+
+    const spec_type_t* type = NULL;
+    for (size_t i = 0; i < sizeof(SPEC_TYPES) / sizeof(SPEC_TYPES[0]); i++) {
+        if (name_is(name, length, SPEC_TYPES[i].name)) {
+            type = &SPEC_TYPES[i];
+            break;
+        }
+    }
+    if (type == NULL) {
+        return compile_fail(c, "Unknown schema type");
+    }
+
+    bool is_collection = type->kind >= SPEC_MAP;
+    if (is_collection && level >= SCHEMA_MAX_DEPTH) {
+        return compile_fail(c, "Schema nested too deeply");
+    }
+
+    spec_t* spec = compile_alloc(c, sizeof(spec_t));
+    if (spec == NULL) {
+        return NULL;
+    }
+    spec->kind = type->kind;
+    spec->accepts = type->accepts;
+    if (props != NULL && !compile_props(c, spec, props, type->bounds)) {
+        return NULL;
+    }
+
+    bool ok = true;
+    switch (type->kind) {
+        case SPEC_ENUM:
+            ok = props == NULL && compile_enum(c, spec, form, first);
+            break;
+        case SPEC_MAP:
+            ok = compile_map(c, spec, form, first, children, level);
+            break;
+        case SPEC_MAP_OF:
+            ok = children == 2 &&
+                 (spec->key = compile_spec(c, edn_vector_get(form, first), level + 1)) != NULL &&
+                 (spec->element = compile_spec(c, edn_vector_get(form, first + 1), level + 1)) !=
+                     NULL;
+            break;
+        case SPEC_COLLECTION:
+            if (children == 1) {
+                ok = (spec->element = compile_spec(c, edn_vector_get(form, first), level + 1)) !=
+                     NULL;
+            } else {
+                ok = children == 0;
+            }
+            break;
+        case SPEC_TUPLE:
+            spec->count = children;
+            spec->items = compile_alloc(c, (children ? children : 1) * sizeof(spec_t*));
+            ok = spec->items != NULL;
+            for (size_t i = 0; ok && i < children; i++) {
+                ok = (spec->items[i] = compile_spec(c, edn_vector_get(form, first + i),
+                                                    level + 1)) != NULL;
+            }
+            break;
+        default:
+            ok = children == 0;
+            break;
+    }
+    return ok ? spec : compile_fail(c, "Invalid schema form");
+}
+
+edn_schema_t* edn_schema_compile(const char* source, size_t length, const char** error_message) {
+    const char* ignored;
+    if (error_message == NULL) {
+        error_message = &ignored;
+    }
+    *error_message = NULL;
+
+    if (source == NULL) {
+        *error_message = "Schema source is NULL";
+        return NULL;
+    }
+
+    edn_result_t r = edn_read(source, length);
+    if (r.error != EDN_OK) {
+        *error_message = r.error_message;
+        return NULL;
+    }
+
+    edn_schema_t* schema = calloc(1, sizeof(edn_schema_t));
+    edn_arena_t* arena = schema != NULL ? edn_arena_create() : NULL;
+    if (arena == NULL) {
+        free(schema);
+        edn_free(r.value);
+        *error_message = "Out of memory";
+        return NULL;
+    }
+    schema->arena = arena;
+
+    compile_state_t c = {arena, NULL};
+    schema->root = compile_spec(&c, r.value, 0);
+    edn_free(r.value);
+    if (schema->root == NULL) {
+        *error_message = c.error;
+        edn_schema_destroy(schema);
+        return NULL;
+    }
+    return schema;
+}
+
+void edn_schema_destroy(edn_schema_t* schema) {
+    if (schema == NULL) {
+        return;
+    }
+    edn_arena_destroy(schema->arena);
+    free(schema);
+}
+
+/* ========================================================================
+ * Validation
+ * ======================================================================== */
+
+typedef enum { KEY_NONE, KEY_OTHER, KEY_KEYWORD, KEY_INT, KEY_STRING } path_key_kind_t;
+
+/* The key most recently read in a map, for error paths */
+typedef struct {
+    path_key_kind_t kind;
+    const char* ns; /* Keyword namespace (points into the input) */
+    size_t ns_length;
+    const char* name; /* Keyword name or string bytes */
+    size_t name_length;
+    int64_t integer;
+} path_key_t;
+
+typedef struct {
+    const spec_t* spec;
+    const spec_t* value_spec; /* Map: spec for the current key's value; NULL = any */
+    size_t count;             /* Elements, or completed map entries */
+    uint64_t seen;            /* Map entries matched so far */
+    bool in_value;            /* Maps: the next form is a value */
+    path_key_t key;
+    char key_text[SCHEMA_KEY_COPY]; /* String keys are copied: events reuse their buffer */
+} schema_frame_t;
+
+typedef enum {
+    SLOT_VALUE, /* Check against `spec` (NULL = anything) */
+    SLOT_KEY,   /* Key of a map schema */
+    SLOT_META   /* Metadata payload; does not occupy the following slot */
+} slot_kind_t;
+
+typedef struct edn_schema_check {
+    const spec_t* root;
+    schema_frame_t frames[SCHEMA_MAX_DEPTH];
+    size_t depth;
+    size_t skip;         /* Open collections inside a skipped form */
+    bool skip_is_meta;   /* The skipped form is a metadata payload */
+    size_t pending_meta; /* Metadata payloads before the next form */
+    edn_error_t error;
+    const char* error_message;
+    bool error_at_end;           /* Violation found when a collection closed */
+    const spec_entry_t* missing; /* Required entry that was absent */
+    bool filled;                 /* Tree hooks: the current slot was already checked */
+} schema_state_t;
+
+static int schema_fail(schema_state_t* st, edn_error_t error, const char* message) {
+    st->error = error;
+    st->error_message = message;
+    return 1;
+}
+
+static int mismatch(schema_state_t* st) {
+    return schema_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Value does not match schema type");
+}
+
+static void set_key(schema_frame_t* frame, const path_key_t* key) {
+    if (key == NULL) {
+        frame->key.kind = KEY_OTHER;
+        return;
+    }
+    frame->key = *key;
+    if (key->kind == KEY_STRING) {
+        /* Keep a prefix; render_path marks the cut */
+        size_t length = key->name_length < SCHEMA_KEY_COPY ? key->name_length : SCHEMA_KEY_COPY;
+        memcpy(frame->key_text, key->name, length);
+        frame->key.name = frame->key_text;
+    }
+}
+
+static int too_many(schema_state_t* st) {
+    return schema_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Too many elements");
+}
+
+static int next_slot(schema_state_t* st, const path_key_t* key, slot_kind_t* kind,
+                     const spec_t** spec) {
+    *spec = NULL;
+    if (st->pending_meta > 0) {
+        st->pending_meta--;
+        *kind = SLOT_META;
+        return 0;
+    }
+
+    *kind = SLOT_VALUE;
+    if (st->depth == 0) {
+        *spec = st->root;
+        return 0;
+    }
+
+    schema_frame_t* frame = &st->frames[st->depth - 1];
+    const spec_t* s = frame->spec;
+    switch (s->kind) {
+        case SPEC_MAP:
+            if (frame->in_value) {
+                *spec = frame->value_spec;
+            } else {
+                set_key(frame, key);
+                *kind = SLOT_KEY;
+            }
+            break;
+        case SPEC_MAP_OF:
+            if (frame->in_value) {
+                *spec = s->element;
+            } else {
+                set_key(frame, key);
+                if (s->max.set && frame->count >= (uint64_t) s->max.i) {
+                    return too_many(st);
+                }
+                *spec = s->key;
+            }
+            break;
+        case SPEC_TUPLE:
+            if (frame->count >= s->count) {
+                return too_many(st);
+            }
+            *spec = s->items[frame->count];
+            break;
+        default:
+            if (s->max.set && frame->count >= (uint64_t) s->max.i) {
+                return too_many(st);
+            }
+            *spec = s->element;
+            break;
+    }
+    if (*spec != NULL && (*spec)->kind == SPEC_ANY) {
+        *spec = NULL;
+    }
+    return 0;
+}
+
+/* A form completed its slot */
+static void slot_done(schema_state_t* st) {
+    if (st->depth == 0) {
+        return;
+    }
+
+    schema_frame_t* frame = &st->frames[st->depth - 1];
+    if (frame->spec->kind != SPEC_MAP && frame->spec->kind != SPEC_MAP_OF) {
+        frame->count++;
+    } else if (!frame->in_value) {
+        frame->in_value = true;
+    } else {
+        frame->in_value = false;
+        frame->count++;
+        frame->value_spec = NULL;
+    }
+}
+
+/* A map schema key that is not a keyword, or is not in the schema */
+static int unknown_key(schema_state_t* st) {
+    schema_frame_t* frame = &st->frames[st->depth - 1];
+    if (frame->spec->closed) {
+        return schema_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Key not allowed in closed map");
+    }
+    frame->value_spec = NULL;
+    return 0;
+}
+
+/* Common entry for scalar events: 1 = abort, 0 = done, 2 = check against *spec */
+static int scalar_slot(schema_state_t* st, uint32_t cls, const path_key_t* key,
+                       const spec_t** spec) {
+    if (st->skip > 0) {
+        return 0;
+    }
+    slot_kind_t kind;
+    if (next_slot(st, key, &kind, spec) != 0) {
+        return 1;
+    }
+    if (kind == SLOT_META) {
+        return 0;
+    }
+    if (kind == SLOT_KEY) {
+        if (unknown_key(st) != 0) {
+            return 1;
+        }
+    } else if (*spec != NULL) {
+        if (((*spec)->accepts & cls) == 0) {
+            return mismatch(st);
+        }
+        if (cls != V_NIL) {
+            return 2;
+        }
+    }
+    slot_done(st);
+    return 0;
+}
+
+#define SCALAR_SLOT(st, cls, key, spec)                                                        \
+    do {                                                                                       \
+        int r_ = scalar_slot((st), (cls), (key), &(spec));                                     \
+        if (r_ != 2) {                                                                         \
+            return r_;                                                                         \
+        }                                                                                      \
+    } while (0)
+
+static bool below_min(const spec_bound_t* min, bool is_int, int64_t i, double d) {
+    if (!min->set) {
+        return false;
+    }
+    return is_int && min->is_int ? i < min->i : !(d >= min->d);
+}
+
+static bool above_max(const spec_bound_t* max, bool is_int, int64_t i, double d) {
+    if (!max->set) {
+        return false;
+    }
+    return is_int && max->is_int ? i > max->i : !(d <= max->d);
+}
+
+static int check_number(schema_state_t* st, const spec_t* spec, bool is_int, int64_t i,
+                        double d) {
+    if (below_min(&spec->min, is_int, i, d) || above_max(&spec->max, is_int, i, d)) {
+        return schema_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Value out of range");
+    }
+    slot_done(st);
+    return 0;
+}
+
+static int not_in_enum(schema_state_t* st) {
+    return schema_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Value not in enum");
+}
+
+/* Magnitude of a digit string in any radix; separators and suffixes are skipped */
+static double digits_to_double(const char* digits, size_t length, uint8_t radix) {
+    double value = 0.0;
+    for (size_t i = 0; i < length; i++) {
+        char ch = digits[i];
+        unsigned digit;
+        if (ch >= '0' && ch <= '9') {
+            digit = (unsigned) (ch - '0');
+        } else if (ch >= 'a' && ch <= 'z') {
+            digit = (unsigned) (ch - 'a') + 10;
+        } else if (ch >= 'A' && ch <= 'Z') {
+            digit = (unsigned) (ch - 'A') + 10;
+        } else {
+            continue;
+        }
+        if (digit < radix) {
+            value = value * radix + digit;
+        }
+    }
+    return value;
+}
+
+/* Approximate value of a big decimal ("123.456e-7"); enough for range checks */
+static double decimal_to_double(const char* digits, size_t length) {
+    double mantissa = 0.0;
+    int significant = 0;
+    long scale = 0;
+    bool fraction = false;
+    size_t i = 0;
+    for (; i < length; i++) {
+        char ch = digits[i];
+        if (ch >= '0' && ch <= '9') {
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (ch - '0');
+                if (mantissa != 0) {
+                    significant++;
+                }
+                scale -= fraction;
+            } else {
+                scale += !fraction;
+            }
+        } else if (ch == '.') {
+            fraction = true;
+        } else if (ch == 'e' || ch == 'E') {
+            break;
+        }
+    }
+
+    if (i < length) {
+        bool negative = false;
+        long exponent = 0;
+        for (i++; i < length; i++) {
+            if (digits[i] == '-') {
+                negative = true;
+            } else if (digits[i] >= '0' && digits[i] <= '9' && exponent < 100000) {
+                exponent = exponent * 10 + (digits[i] - '0');
+            }
+        }
+        scale += negative ? -exponent : exponent;
+    }
+
+    for (; scale > 0 && mantissa < 1e308; scale--) {
+        mantissa *= 10;
+    }
+    for (; scale < 0 && mantissa > 0; scale++) {
+        mantissa /= 10;
+    }
+    return mantissa;
+}
+
+static int schema_nil(void* ctx) {
+    const spec_t* spec;
+    return scalar_slot(ctx, V_NIL, NULL, &spec);
+}
+
+static int schema_bool(void* ctx, bool value) {
+    (void) value;
+    const spec_t* spec;
+    SCALAR_SLOT(ctx, V_BOOL, NULL, spec);
+    slot_done(ctx);
+    return 0;
+}
+
+static int schema_int(void* ctx, int64_t value) {
+    schema_state_t* st = ctx;
+    path_key_t key = {KEY_INT, NULL, 0, NULL, 0, value};
+    const spec_t* spec;
+    SCALAR_SLOT(st, V_INT, &key, spec);
+    if (spec->kind == SPEC_ENUM) {
+        for (size_t i = 0; i < spec->count; i++) {
+            if (spec->values[i].cls == V_INT && spec->values[i].integer == value) {
+                slot_done(st);
+                return 0;
+            }
+        }
+        return not_in_enum(st);
+    }
+    return check_number(st, spec, true, value, (double) value);
+}
+
+static int schema_double(void* ctx, double value) {
+    const spec_t* spec;
+    SCALAR_SLOT(ctx, V_DOUBLE, NULL, spec);
+    return check_number(ctx, spec, false, 0, value);
+}
+
+static int schema_bigint(void* ctx, const char* digits, size_t length, bool negative,
+                         uint8_t radix) {
+    const spec_t* spec;
+    SCALAR_SLOT(ctx, V_BIGINT, NULL, spec);
+    double d = digits_to_double(digits, length, radix);
+    return check_number(ctx, spec, false, 0, negative ? -d : d);
+}
+
+static int schema_bigdec(void* ctx, const char* digits, size_t length, bool negative) {
+    const spec_t* spec;
+    SCALAR_SLOT(ctx, V_BIGDEC, NULL, spec);
+    double d = decimal_to_double(digits, length);
+    return check_number(ctx, spec, false, 0, negative ? -d : d);
+}
+
+static int schema_ratio(void* ctx, int64_t numerator, int64_t denominator) {
+    const spec_t* spec;
+    SCALAR_SLOT(ctx, V_RATIO, NULL, spec);
+    return check_number(ctx, spec, false, 0, (double) numerator / (double) denominator);
+}
+
+static int schema_bigratio(void* ctx, const char* numerator, size_t numer_length, bool negative,
+                           const char* denominator, size_t denom_length) {
+    const spec_t* spec;
+    SCALAR_SLOT(ctx, V_RATIO, NULL, spec);
+    double d = digits_to_double(numerator, numer_length, 10) /
+               digits_to_double(denominator, denom_length, 10);
+    return check_number(ctx, spec, false, 0, negative ? -d : d);
+}
+
+static int schema_string(void* ctx, const char* s, size_t length) {
+    schema_state_t* st = ctx;
+    path_key_t key = {KEY_STRING, NULL, 0, s, length, 0};
+    const spec_t* spec;
+    SCALAR_SLOT(st, V_STRING, &key, spec);
+    if (spec->kind == SPEC_ENUM) {
+        for (size_t i = 0; i < spec->count; i++) {
+            const spec_value_t* v = &spec->values[i];
+            if (v->cls == V_STRING && v->length == length && memcmp(v->text, s, length) == 0) {
+                slot_done(st);
+                return 0;
+            }
+        }
+        return not_in_enum(st);
+    }
+    if (below_min(&spec->min, true, (int64_t) length, 0) ||
+        above_max(&spec->max, true, (int64_t) length, 0)) {
+        return schema_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "String length out of range");
+    }
+    slot_done(st);
+    return 0;
+}
+
+static int schema_keyword(void* ctx, const char* ns, size_t ns_length, const char* name,
+                          size_t name_length) {
+    schema_state_t* st = ctx;
+    if (st->skip > 0) {
+        return 0;
+    }
+
+    path_key_t key = {KEY_KEYWORD, ns, ns_length, name, name_length, 0};
+    slot_kind_t kind;
+    const spec_t* spec;
+    if (next_slot(st, &key, &kind, &spec) != 0) {
+        return 1;
+    }
+    if (kind == SLOT_META) {
+        return 0;
+    }
+
+    if (kind == SLOT_KEY) {
+        schema_frame_t* frame = &st->frames[st->depth - 1];
+        size_t index;
+        const spec_entry_t* entry =
+            lookup_entry(frame->spec, ns, ns_length, name, name_length, &index);
+        if (entry == NULL) {
+            if (unknown_key(st) != 0) {
+                return 1;
+            }
+        } else {
+            uint64_t bit = (uint64_t) 1 << index;
+            if (frame->seen & bit) {
+                return schema_fail(st, EDN_ERROR_DUPLICATE_KEY, "Duplicate key in map");
+            }
+            frame->seen |= bit;
+            frame->value_spec = entry->spec->kind == SPEC_ANY ? NULL : entry->spec;
+        }
+    } else if (spec != NULL) {
+        if ((spec->accepts & V_KEYWORD) == 0) {
+            return mismatch(st);
+        }
+        if (spec->kind == SPEC_ENUM) {
+            size_t i = 0;
+            while (i < spec->count &&
+                   (spec->values[i].cls != V_KEYWORD ||
+                    !keyword_equals(spec->values[i].text, spec->values[i].length, ns, ns_length,
+                                    name, name_length))) {
+                i++;
+            }
+            if (i == spec->count) {
+                return not_in_enum(st);
+            }
+        }
+    }
+    slot_done(st);
+    return 0;
+}
+
+static int schema_symbol(void* ctx, const char* ns, size_t ns_length, const char* name,
+                         size_t name_length) {
+    (void) ns;
+    (void) ns_length;
+    (void) name;
+    (void) name_length;
+    const spec_t* spec;
+    SCALAR_SLOT(ctx, V_SYMBOL, NULL, spec);
+    slot_done(ctx);
+    return 0;
+}
+
+static int schema_character(void* ctx, uint32_t codepoint) {
+    (void) codepoint;
+    const spec_t* spec;
+    SCALAR_SLOT(ctx, V_CHAR, NULL, spec);
+    slot_done(ctx);
+    return 0;
+}
+
+static int schema_begin(schema_state_t* st, uint32_t cls) {
+    if (st->skip > 0) {
+        st->skip++;
+        return 0;
+    }
+
+    slot_kind_t kind;
+    const spec_t* spec;
+    if (next_slot(st, NULL, &kind, &spec) != 0) {
+        return 1;
+    }
+    if (kind == SLOT_KEY && unknown_key(st) != 0) {
+        return 1;
+    }
+    if (kind != SLOT_VALUE || spec == NULL) {
+        st->skip = 1;
+        st->skip_is_meta = kind == SLOT_META;
+        return 0;
+    }
+    if ((spec->accepts & cls) == 0) {
+        return mismatch(st);
+    }
+
+    /* Compilation bounds collection schemas to SCHEMA_MAX_DEPTH levels */
+    schema_frame_t* frame = &st->frames[st->depth++];
+    frame->spec = spec;
+    frame->value_spec = NULL;
+    frame->count = 0;
+    frame->seen = 0;
+    frame->in_value = false;
+    frame->key.kind = KEY_NONE;
+    return 0;
+}
+
+static int schema_end(schema_state_t* st) {
+    if (st->skip > 0) {
+        if (--st->skip == 0 && !st->skip_is_meta) {
+            slot_done(st);
+        }
+        return 0;
+    }
+
+    schema_frame_t* frame = &st->frames[st->depth - 1];
+    const spec_t* spec = frame->spec;
+    uint64_t missing = spec->kind == SPEC_MAP ? spec->required & ~frame->seen : 0;
+    if (missing != 0) {
+        size_t i = 0;
+        while ((missing & ((uint64_t) 1 << i)) == 0) {
+            i++;
+        }
+        st->error_at_end = true;
+        st->missing = &spec->entries[i];
+        return schema_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Missing required key");
+    }
+    if ((spec->kind == SPEC_TUPLE && frame->count < spec->count) ||
+        below_min(&spec->min, true, (int64_t) frame->count, 0)) {
+        st->error_at_end = true;
+        return schema_fail(st, EDN_ERROR_SCHEMA_MISMATCH, "Too few elements");
+    }
+    st->depth--;
+    slot_done(st);
+    return 0;
+}
+
+static int schema_begin_list(void* ctx) {
+    return schema_begin(ctx, V_LIST);
+}
+
+static int schema_begin_vector(void* ctx) {
+    return schema_begin(ctx, V_VECTOR);
+}
+
+static int schema_begin_set(void* ctx) {
+    return schema_begin(ctx, V_SET);
+}
+
+static int schema_begin_map(void* ctx) {
+    return schema_begin(ctx, V_MAP);
+}
+
+static int schema_end_collection(void* ctx) {
+    return schema_end(ctx);
+}
+
+static int schema_meta(void* ctx) {
+    schema_state_t* st = ctx;
+    if (st->skip == 0) {
+        st->pending_meta++;
+    }
+    return 0;
+}
+
+static const edn_event_handlers_t schema_handlers = {
+    .on_nil = schema_nil,
+    .on_bool = schema_bool,
+    .on_int = schema_int,
+    .on_double = schema_double,
+    .on_string = schema_string,
+    .on_keyword = schema_keyword,
+    .on_symbol = schema_symbol,
+    .on_character = schema_character,
+    .on_bigint = schema_bigint,
+    .on_bigdec = schema_bigdec,
+    .on_ratio = schema_ratio,
+    .on_bigratio = schema_bigratio,
+    .on_begin_list = schema_begin_list,
+    .on_end_list = schema_end_collection,
+    .on_begin_vector = schema_begin_vector,
+    .on_end_vector = schema_end_collection,
+    .on_begin_set = schema_begin_set,
+    .on_end_set = schema_end_collection,
+    .on_begin_map = schema_begin_map,
+    .on_end_map = schema_end_collection,
+    .on_tag = NULL, /* Tags are transparent */
+    .on_meta = schema_meta,
+    .decode_strings = true,
+};
+
+/* ========================================================================
+ * Checks while the tree is built
+ * ======================================================================== */
+
+static uint32_t collection_class(edn_type_t type) {
+    switch (type) {
+        case EDN_TYPE_LIST:
+            return V_LIST;
+        case EDN_TYPE_VECTOR:
+            return V_VECTOR;
+        case EDN_TYPE_SET:
+            return V_SET;
+        default:
+            return V_MAP;
+    }
+}
+
+static int schema_value(schema_state_t* st, const edn_value_t* value);
+
+static int schema_elements(schema_state_t* st, uint32_t cls, edn_value_t* const* elements,
+                           size_t count) {
+    if (schema_begin(st, cls) != 0) {
+        return 1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (schema_value(st, elements[i]) != 0) {
+            return 1;
+        }
+    }
+    return schema_end(st);
+}
+
+/* Check a built form the parser did not report piece by piece: a scalar,
+ * or whatever a reader returned. Collections are walked in the order the
+ * event parser would report them. */
+static int schema_value(schema_state_t* st, const edn_value_t* value) {
+    switch (value->type) {
+        case EDN_TYPE_NIL:
+            return schema_nil(st);
+        case EDN_TYPE_BOOL:
+            return schema_bool(st, value->as.boolean);
+        case EDN_TYPE_INT:
+            return schema_int(st, value->as.integer);
+        case EDN_TYPE_FLOAT:
+            return schema_double(st, value->as.floating);
+        case EDN_TYPE_BIGINT:
+            /* Raw digits: digits_to_double skips the separators */
+            return schema_bigint(st, value->as.bigint.digits, value->as.bigint.length,
+                                 value->as.bigint.negative, value->as.bigint.radix);
+        case EDN_TYPE_BIGDEC:
+            return schema_bigdec(st, value->as.bigdec.decimal, value->as.bigdec.length,
+                                 value->as.bigdec.negative);
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+        case EDN_TYPE_RATIO:
+            return schema_ratio(st, value->as.ratio.numerator, value->as.ratio.denominator);
+        case EDN_TYPE_BIGRATIO:
+            return schema_bigratio(st, value->as.bigratio.numerator,
+                                   value->as.bigratio.numer_length,
+                                   value->as.bigratio.numer_negative,
+                                   value->as.bigratio.denominator,
+                                   value->as.bigratio.denom_length);
+#endif
+        case EDN_TYPE_CHARACTER:
+            return schema_character(st, value->as.character);
+        case EDN_TYPE_STRING: {
+            size_t length = edn_string_get_length(value);
+            const char* text = value->as.string.data;
+            if (edn_string_has_escapes(value)) {
+                text = edn_string_get(value, &length);
+                if (text == NULL) {
+                    return schema_fail(st, EDN_ERROR_INVALID_STRING,
+                                       "Invalid escape sequence in string");
+                }
+            }
+            return schema_string(st, text, length);
+        }
+        case EDN_TYPE_KEYWORD:
+            return schema_keyword(st, value->as.keyword.namespace, value->as.keyword.ns_length,
+                                  value->as.keyword.name, value->as.keyword.name_length);
+        case EDN_TYPE_SYMBOL:
+            return schema_symbol(st, value->as.symbol.namespace, value->as.symbol.ns_length,
+                                 value->as.symbol.name, value->as.symbol.name_length);
+        case EDN_TYPE_TAGGED:
+            return schema_value(st, value->as.tagged.value);
+        case EDN_TYPE_LIST:
+            return schema_elements(st, V_LIST, value->as.list.elements, value->as.list.count);
+        case EDN_TYPE_VECTOR:
+            return schema_elements(st, V_VECTOR, value->as.vector.elements,
+                                   value->as.vector.count);
+        case EDN_TYPE_SET:
+            return schema_elements(st, V_SET, value->as.set.elements, value->as.set.count);
+        case EDN_TYPE_MAP:
+            if (schema_begin(st, V_MAP) != 0) {
+                return 1;
+            }
+            for (size_t i = 0; i < value->as.map.count; i++) {
+                if (schema_value(st, value->as.map.entries[i].key) != 0 ||
+                    schema_value(st, value->as.map.entries[i].value) != 0) {
+                    return 1;
+                }
+            }
+            return schema_end(st);
+        default: {
+            /* External values match nothing but an open slot */
+            const spec_t* spec;
+            return scalar_slot(st, 0, NULL, &spec);
+        }
+    }
+}
+
+static bool schema_reject(edn_parser_t* parser, const char* start, const char* end) {
+    schema_state_t* st = parser->schema;
+    edn_parser_set_error(parser, st->error, st->error_message, start, end);
+    return false;
+}
+
+bool edn_schema_check_begin(edn_parser_t* parser, edn_type_t type, const char* start) {
+    if (schema_begin(parser->schema, collection_class(type)) != 0) {
+        return schema_reject(parser, start, parser->current);
+    }
+    return true;
+}
+
+bool edn_schema_check_end(edn_parser_t* parser, const char* start) {
+    schema_state_t* st = parser->schema;
+    if (schema_end(st) != 0) {
+        return schema_reject(parser, start, parser->current);
+    }
+    st->filled = true;
+    return true;
+}
+
+/* A collection's form was checked as it was read; anything else is checked
+ * now. An element also closes its slot, so the next one starts unchecked. */
+bool edn_schema_check_form(edn_parser_t* parser, const edn_value_t* value, bool element) {
+    schema_state_t* st = parser->schema;
+    if (!st->filled && schema_value(st, value) != 0) {
+        return schema_reject(parser, parser->input + value->source_start,
+                             parser->input + value->source_end);
+    }
+    st->filled = !element;
+    return true;
+}
+
+/* ========================================================================
+ * Error paths
+ * ======================================================================== */
+
+typedef struct {
+    char* buf;
+    size_t size;
+    size_t pos;
+} path_writer_t;
+
+static void path_append(path_writer_t* w, const char* fmt, ...) {
+    if (w->pos + 1 >= w->size) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(w->buf + w->pos, w->size - w->pos, fmt, args);
+    va_end(args);
+    if (n > 0) {
+        w->pos += (size_t) n < w->size - w->pos ? (size_t) n : w->size - w->pos - 1;
+    }
+}
+
+static void path_append_key(path_writer_t* w, const path_key_t* key) {
+    switch (key->kind) {
+        case KEY_KEYWORD:
+            if (key->ns != NULL) {
+                path_append(w, ":%.*s/", (int) key->ns_length, key->ns);
+            } else {
+                path_append(w, ":");
+            }
+            path_append(w, "%.*s", (int) key->name_length, key->name);
+            break;
+        case KEY_INT:
+            path_append(w, "%lld", (long long) key->integer);
+            break;
+        case KEY_STRING:
+            if (key->name_length > SCHEMA_KEY_COPY) {
+                path_append(w, "\"%.*s...\"", SCHEMA_KEY_COPY, key->name);
+            } else {
+                path_append(w, "\"%.*s\"", (int) key->name_length, key->name);
+            }
+            break;
+        default:
+            path_append(w, "_");
+            break;
+    }
+}
+
+static void render_path(const schema_state_t* st, char* buf, size_t size) {
+    path_writer_t w = {buf, size, 0};
+    const char* sep = "";
+    path_append(&w, "[");
+    for (size_t i = 0; i < st->depth; i++) {
+        const schema_frame_t* frame = &st->frames[i];
+        bool last = i + 1 == st->depth;
+        if (last && st->error_at_end) {
+            break;
+        }
+        if (frame->spec->kind == SPEC_MAP || frame->spec->kind == SPEC_MAP_OF) {
+            /* A rejected key is part of the path too */
+            if (frame->key.kind == KEY_NONE || (!frame->in_value && !last)) {
+                continue;
+            }
+            path_append(&w, "%s", sep);
+            path_append_key(&w, &frame->key);
+        } else {
+            path_append(&w, "%s%zu", sep, frame->count);
+        }
+        sep = " ";
+    }
+    if (st->missing != NULL) {
+        path_append(&w, "%s:%.*s", sep, (int) st->missing->key_length, st->missing->key);
+    }
+    path_append(&w, "]");
+}
+
+static void schema_state_init(schema_state_t* st, const edn_schema_t* schema) {
+    st->root = schema->root;
+    st->depth = 0;
+    st->skip = 0;
+    st->skip_is_meta = false;
+    st->pending_meta = 0;
+    st->error = EDN_OK;
+    st->error_message = NULL;
+    st->error_at_end = false;
+    st->missing = NULL;
+    st->filled = false;
+}
+
+edn_result_t edn_schema_validate(const edn_schema_t* schema, const char* input, size_t length,
+                                 char* path, size_t path_size) {
+    edn_result_t result = {0};
+    if (path != NULL && path_size > 0) {
+        path[0] = '\0';
+    }
+
+    if (schema == NULL) {
+        result.error = EDN_ERROR_INVALID_ARGUMENT;
+        result.error_message = "Schema is NULL";
+        return result;
+    }
+
+    schema_state_t st;
+    schema_state_init(&st, schema);
+    result = edn_parse_events(input, length, &schema_handlers, &st);
+    if (result.error == EDN_ERROR_ABORTED && st.error != EDN_OK) {
+        /* Positions already cover the form the schema rejected */
+        result.error = st.error;
+        result.error_message = st.error_message;
+        if (path != NULL && path_size > 0) {
+            render_path(&st, path, path_size);
+        }
+    }
+    return result;
+}
+
+edn_result_t edn_schema_read(const edn_schema_t* schema, const char* input, size_t length,
+                             const edn_parse_options_t* options, char* path, size_t path_size) {
+    edn_result_t result = {0};
+    if (path != NULL && path_size > 0) {
+        path[0] = '\0';
+    }
+
+    if (schema == NULL) {
+        result.error = EDN_ERROR_INVALID_ARGUMENT;
+        result.error_message = "Schema is NULL";
+        return result;
+    }
+
+    schema_state_t st;
+    schema_state_init(&st, schema);
+    result = edn_read_checked(input, length, options, &st);
+    if (st.error != EDN_OK && result.error == st.error && path != NULL && path_size > 0) {
+        render_path(&st, path, path_size);
+    }
+    return result;
+}
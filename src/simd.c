@@ -326,11 +326,17 @@ const char* edn_simd_skip_whitespace(const char* ptr, const char* end) {
 
 #if defined(__wasm__) && defined(__wasm_simd128__)
 
-const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_backslash) {
+static inline const char* find_quote(const char* ptr, const char* end, bool* out_has_backslash,
+                                     bool* out_non_ascii) {
     bool has_backslash = false;
+    v128_t seen = wasm_i8x16_splat(0);
+    unsigned char high = 0;
 
     while (ptr + 16 <= end) {
         v128_t chunk = wasm_v128_load((const v128_t*) ptr);
+        if (out_non_ascii) {
+            seen = wasm_v128_or(seen, chunk);
+        }
         v128_t quote_v = wasm_i8x16_eq(chunk, wasm_i8x16_splat('"'));
         v128_t bs_v = wasm_i8x16_eq(chunk, wasm_i8x16_splat('\\'));
         v128_t specials = wasm_v128_or(quote_v, bs_v);
@@ -359,21 +365,29 @@ const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_
         if (out_has_backslash) {
             *out_has_backslash = has_backslash || (bs_mask != 0);
         }
+        if (out_non_ascii) {
+            *out_non_ascii = wasm_i8x16_bitmask(seen) != 0;
+        }
         return ptr + idx;
     }
 
     while (ptr < end) {
         char c = *ptr;
+        high |= (unsigned char) c;
         if (c == '\\') {
             has_backslash = true;
             if (ptr + 1 >= end) {
                 return NULL;
             }
+            high |= (unsigned char) ptr[1];
             ptr += 2;
         } else if (c == '"') {
             if (out_has_backslash) {
                 *out_has_backslash = has_backslash;
             }
+            if (out_non_ascii) {
+                *out_non_ascii = (high & 0x80) != 0 || wasm_i8x16_bitmask(seen) != 0;
+            }
             return ptr;
         } else {
             ++ptr;
@@ -385,11 +399,17 @@ const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_
 
 #elif defined(__aarch64__) || defined(_M_ARM64)
 
-const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_backslash) {
+static inline const char* find_quote(const char* ptr, const char* end, bool* out_has_backslash,
+                                     bool* out_non_ascii) {
     bool has_backslash = false;
+    uint8x16_t seen = vdupq_n_u8(0);
+    unsigned char high = 0;
 
     while (ptr + 16 <= end) {
         uint8x16_t chunk = vld1q_u8((const uint8_t*) ptr);
+        if (out_non_ascii) {
+            seen = vorrq_u8(seen, chunk);
+        }
         uint8x16_t quote_v = vceqq_u8(chunk, vdupq_n_u8('"'));
         uint8x16_t bs_v = vceqq_u8(chunk, vdupq_n_u8('\\'));
         uint8x16_t specials = vorrq_u8(quote_v, bs_v);
@@ -421,22 +441,30 @@ const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_
         if (out_has_backslash) {
             *out_has_backslash = has_backslash || (bs_mask != 0);
         }
+        if (out_non_ascii) {
+            *out_non_ascii = vmaxvq_u8(seen) >= 0x80;
+        }
         return ptr + idx;
     }
 
     /* Scalar tail for remaining bytes (<16) */
     while (ptr < end) {
         char c = *ptr;
+        high |= (unsigned char) c;
         if (c == '\\') {
             has_backslash = true;
             if (ptr + 1 >= end) {
                 return NULL; /* trailing backslash */
             }
+            high |= (unsigned char) ptr[1];
             ptr += 2;
         } else if (c == '"') {
             if (out_has_backslash) {
                 *out_has_backslash = has_backslash;
             }
+            if (out_non_ascii) {
+                *out_non_ascii = ((high | vmaxvq_u8(seen)) & 0x80) != 0;
+            }
             return ptr;
         } else {
             ++ptr;
@@ -448,11 +476,17 @@ const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_
 
 #elif defined(__x86_64__) || defined(_M_X64)
 
-const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_backslash) {
+static inline const char* find_quote(const char* ptr, const char* end, bool* out_has_backslash,
+                                     bool* out_non_ascii) {
     bool has_backslash = false;
+    __m128i seen = _mm_setzero_si128();
+    unsigned char high = 0;
 
     while (ptr + 16 <= end) {
         __m128i chunk = _mm_loadu_si128((const __m128i*) ptr);
+        if (out_non_ascii) {
+            seen = _mm_or_si128(seen, chunk);
+        }
         __m128i quote_v = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
         __m128i bs_v = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
 
@@ -484,22 +518,30 @@ const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_
         if (out_has_backslash) {
             *out_has_backslash = has_backslash || (bs_mask != 0);
         }
+        if (out_non_ascii) {
+            *out_non_ascii = _mm_movemask_epi8(seen) != 0;
+        }
         return ptr + idx;
     }
 
     /* Scalar tail for remaining bytes (<16) */
     while (ptr < end) {
         char c = *ptr;
+        high |= (unsigned char) c;
         if (c == '\\') {
             has_backslash = true;
             if (ptr + 1 >= end) {
                 return NULL; /* trailing backslash */
             }
+            high |= (unsigned char) ptr[1];
             ptr += 2;
         } else if (c == '"') {
             if (out_has_backslash) {
                 *out_has_backslash = has_backslash;
             }
+            if (out_non_ascii) {
+                *out_non_ascii = (high & 0x80) != 0 || _mm_movemask_epi8(seen) != 0;
+            }
             return ptr;
         } else {
             ++ptr;
@@ -513,22 +555,29 @@ const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_
 /* Scalar fallback: scan for closing quote and track whether any '\' appeared.
    ptr points to first char after initial '"'. */
 
-const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_backslash) {
+static inline const char* find_quote(const char* ptr, const char* end, bool* out_has_backslash,
+                                     bool* out_non_ascii) {
     bool has_backslash = false;
+    unsigned char high = 0;
 
     while (ptr < end) {
         char c = *ptr;
+        high |= (unsigned char) c;
         if (c == '\\') {
             has_backslash = true;
             if (ptr + 1 >= end) {
                 /* trailing backslash with no following char -> invalid string */
                 return NULL;
             }
+            high |= (unsigned char) ptr[1];
             ptr += 2; /* skip escaped character */
         } else if (c == '"') {
             if (out_has_backslash) {
                 *out_has_backslash = has_backslash;
             }
+            if (out_non_ascii) {
+                *out_non_ascii = (high & 0x80) != 0;
+            }
             return ptr;
         } else {
             ptr++;
@@ -541,6 +590,15 @@ const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_
 
 #endif
 
+const char* edn_simd_find_quote(const char* ptr, const char* end, bool* out_has_backslash) {
+    return find_quote(ptr, end, out_has_backslash, NULL);
+}
+
+const char* edn_simd_find_quote_utf8(const char* ptr, const char* end, bool* out_has_backslash,
+                                     bool* out_non_ascii) {
+    return find_quote(ptr, end, out_has_backslash, out_non_ascii);
+}
+
 /* SIMD digit scanning for number parsing */
 #if defined(__wasm__) && defined(__wasm_simd128__)
 
@@ -1049,3 +1107,310 @@ edn_identifier_scan_result_t edn_simd_scan_identifier(const char* ptr, const cha
 }
 
 #endif
+
+/*
+ * UTF-8 validation
+ *
+ * Accepts exactly the well-formed sequences of Unicode Table 3-7: no
+ * overlong forms, no surrogates, nothing above U+10FFFF. The SIMD paths use
+ * the lookup-table algorithm of Keiser and Lemire ("Validating UTF-8 In Less
+ * Than One Instruction Per Byte", 2021): three 16-entry nibble tables
+ * classify each byte pair, and a saturating-subtract check covers the third
+ * and fourth bytes of long sequences. ASCII blocks skip all of that. The
+ * scalar path is range-based and also locates the first error, which the
+ * SIMD paths only detect.
+ */
+
+/* Returns the start of the first ill-formed sequence, or end */
+static const char* utf8_scan_scalar(const char* ptr, const char* end) {
+    const unsigned char* p = (const unsigned char*) ptr;
+    const unsigned char* e = (const unsigned char*) end;
+
+    while (p < e) {
+        /* Eight ASCII bytes at a time */
+        while (e - p >= 8) {
+            uint64_t word;
+            memcpy(&word, p, 8);
+            if ((word & 0x8080808080808080ULL) != 0) {
+                break;
+            }
+            p += 8;
+        }
+        if (p >= e) {
+            break;
+        }
+
+        unsigned char c = *p;
+        if (c < 0x80) {
+            p++;
+            continue;
+        }
+
+        size_t need;
+        unsigned char lo = 0x80;
+        unsigned char hi = 0xBF;
+        if (c < 0xC2) {
+            return (const char*) p; /* Continuation or overlong 2-byte lead */
+        } else if (c < 0xE0) {
+            need = 1;
+        } else if (c < 0xF0) {
+            need = 2;
+            lo = (c == 0xE0) ? 0xA0 : 0x80; /* Overlong */
+            hi = (c == 0xED) ? 0x9F : 0xBF; /* Surrogates */
+        } else if (c < 0xF5) {
+            need = 3;
+            lo = (c == 0xF0) ? 0x90 : 0x80; /* Overlong */
+            hi = (c == 0xF4) ? 0x8F : 0xBF; /* Above U+10FFFF */
+        } else {
+            return (const char*) p;
+        }
+
+        if ((size_t) (e - p) <= need || p[1] < lo || p[1] > hi) {
+            return (const char*) p;
+        }
+        for (size_t i = 2; i <= need; i++) {
+            if ((p[i] & 0xC0) != 0x80) {
+                return (const char*) p;
+            }
+        }
+        p += need + 1;
+    }
+
+    return end;
+}
+
+/* Error classes of the lookup algorithm, one bit per byte-pair pattern */
+#define UTF8_TOO_SHORT (1 << 0)  /* Lead byte followed by ASCII or another lead */
+#define UTF8_TOO_LONG (1 << 1)   /* ASCII followed by a continuation */
+#define UTF8_OVERLONG_3 (1 << 2) /* E0 80..9F */
+#define UTF8_TOO_LARGE (1 << 3)  /* F4 90..BF, F5..FF */
+#define UTF8_SURROGATE (1 << 4)  /* ED A0..BF */
+#define UTF8_OVERLONG_2 (1 << 5) /* C0, C1 */
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4 (1 << 6) /* F0 80..8F */
+#define UTF8_TWO_CONTS (1 << 7)  /* Continuation after continuation (valid if 3rd/4th byte) */
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+/* Indexed by the high nibble of the first byte of a pair */
+#define UTF8_BYTE_1_HIGH                                                                         \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,    \
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,            \
+        UTF8_TWO_CONTS, UTF8_TOO_SHORT | UTF8_OVERLONG_2, UTF8_TOO_SHORT,                        \
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,                                       \
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+
+/* Indexed by the low nibble of the first byte of a pair */
+#define UTF8_BYTE_1_LOW                                                                          \
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,                            \
+        UTF8_CARRY | UTF8_OVERLONG_2, UTF8_CARRY, UTF8_CARRY, UTF8_CARRY | UTF8_TOO_LARGE,       \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                       \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                       \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                       \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                       \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                       \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                       \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                       \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                       \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,                      \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                       \
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+
+/* Indexed by the high nibble of the second byte of a pair */
+#define UTF8_BYTE_2_HIGH                                                                         \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,              \
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,                                          \
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 |                     \
+            UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,                                               \
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,     \
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,      \
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,      \
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+
+/* Last-lane limits: a lead byte in one of the final three lanes needs the next block */
+#define UTF8_INCOMPLETE_MAX                                                                      \
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1,       \
+        0xE0 - 1, 0xC0 - 1
+
+#if defined(__wasm__) && defined(__wasm_simd128__)
+
+/* Block error bits given the block and the one before it */
+static inline v128_t utf8_block_errors(v128_t input, v128_t prev_input) {
+    const v128_t nibble = wasm_i8x16_splat(0x0F);
+    const v128_t byte_1_high = wasm_u8x16_make(UTF8_BYTE_1_HIGH);
+    const v128_t byte_1_low = wasm_u8x16_make(UTF8_BYTE_1_LOW);
+    const v128_t byte_2_high = wasm_u8x16_make(UTF8_BYTE_2_HIGH);
+
+    /* prevN: the block shifted so each lane sees the byte N positions earlier */
+    v128_t prev1 = wasm_i8x16_shuffle(prev_input, input, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+                                      25, 26, 27, 28, 29, 30);
+    v128_t prev2 = wasm_i8x16_shuffle(prev_input, input, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+                                      24, 25, 26, 27, 28, 29);
+    v128_t prev3 = wasm_i8x16_shuffle(prev_input, input, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22,
+                                      23, 24, 25, 26, 27, 28);
+
+    v128_t special = wasm_v128_and(
+        wasm_v128_and(wasm_i8x16_swizzle(byte_1_high, wasm_u8x16_shr(prev1, 4)),
+                      wasm_i8x16_swizzle(byte_1_low, wasm_v128_and(prev1, nibble))),
+        wasm_i8x16_swizzle(byte_2_high, wasm_u8x16_shr(input, 4)));
+
+    v128_t must_be_cont =
+        wasm_v128_or(wasm_u8x16_sub_sat(prev2, wasm_i8x16_splat((char) (0xE0 - 0x80))),
+                     wasm_u8x16_sub_sat(prev3, wasm_i8x16_splat((char) (0xF0 - 0x80))));
+    return wasm_v128_xor(wasm_v128_and(must_be_cont, wasm_i8x16_splat((char) 0x80)), special);
+}
+
+const char* edn_simd_validate_utf8(const char* ptr, const char* end) {
+    const char* start = ptr;
+    const v128_t incomplete_max = wasm_u8x16_make(UTF8_INCOMPLETE_MAX);
+    v128_t prev_input = wasm_i8x16_splat(0);
+    v128_t prev_incomplete = wasm_i8x16_splat(0);
+    v128_t error = wasm_i8x16_splat(0);
+
+    while (ptr + 16 <= end) {
+        v128_t input = wasm_v128_load((const v128_t*) ptr);
+        if (wasm_i8x16_bitmask(input) == 0) {
+            error = wasm_v128_or(error, prev_incomplete);
+            prev_incomplete = wasm_i8x16_splat(0);
+        } else {
+            error = wasm_v128_or(error, utf8_block_errors(input, prev_input));
+            prev_incomplete = wasm_u8x16_sub_sat(input, incomplete_max);
+        }
+        prev_input = input;
+        ptr += 16;
+    }
+
+    /* Zero padding is ASCII, so it also flushes a sequence cut off at the end */
+    char tail[16] = {0};
+    memcpy(tail, ptr, (size_t) (end - ptr));
+    v128_t input = wasm_v128_load((const v128_t*) tail);
+    error = wasm_v128_or(error, utf8_block_errors(input, prev_input));
+
+    if (wasm_v128_any_true(error)) {
+        return utf8_scan_scalar(start, end);
+    }
+    return end;
+}
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+
+static inline uint8x16_t utf8_block_errors(uint8x16_t input, uint8x16_t prev_input) {
+    static const uint8_t byte_1_high_table[16] = {UTF8_BYTE_1_HIGH};
+    static const uint8_t byte_1_low_table[16] = {UTF8_BYTE_1_LOW};
+    static const uint8_t byte_2_high_table[16] = {UTF8_BYTE_2_HIGH};
+
+    /* prevN: the block shifted so each lane sees the byte N positions earlier */
+    uint8x16_t prev1 = vextq_u8(prev_input, input, 15);
+    uint8x16_t prev2 = vextq_u8(prev_input, input, 14);
+    uint8x16_t prev3 = vextq_u8(prev_input, input, 13);
+
+    uint8x16_t special = vandq_u8(
+        vandq_u8(vqtbl1q_u8(vld1q_u8(byte_1_high_table), vshrq_n_u8(prev1, 4)),
+                 vqtbl1q_u8(vld1q_u8(byte_1_low_table), vandq_u8(prev1, vdupq_n_u8(0x0F)))),
+        vqtbl1q_u8(vld1q_u8(byte_2_high_table), vshrq_n_u8(input, 4)));
+
+    uint8x16_t must_be_cont = vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80)),
+                                       vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80)));
+    return veorq_u8(vandq_u8(must_be_cont, vdupq_n_u8(0x80)), special);
+}
+
+const char* edn_simd_validate_utf8(const char* ptr, const char* end) {
+    static const uint8_t incomplete_max_table[16] = {UTF8_INCOMPLETE_MAX};
+    const char* start = ptr;
+    const uint8x16_t incomplete_max = vld1q_u8(incomplete_max_table);
+    uint8x16_t prev_input = vdupq_n_u8(0);
+    uint8x16_t prev_incomplete = vdupq_n_u8(0);
+    uint8x16_t error = vdupq_n_u8(0);
+
+    while (ptr + 16 <= end) {
+        uint8x16_t input = vld1q_u8((const uint8_t*) ptr);
+        if (vmaxvq_u8(input) < 0x80) {
+            error = vorrq_u8(error, prev_incomplete);
+            prev_incomplete = vdupq_n_u8(0);
+        } else {
+            error = vorrq_u8(error, utf8_block_errors(input, prev_input));
+            prev_incomplete = vqsubq_u8(input, incomplete_max);
+        }
+        prev_input = input;
+        ptr += 16;
+    }
+
+    /* Zero padding is ASCII, so it also flushes a sequence cut off at the end */
+    uint8_t tail[16] = {0};
+    memcpy(tail, ptr, (size_t) (end - ptr));
+    error = vorrq_u8(error, utf8_block_errors(vld1q_u8(tail), prev_input));
+
+    if (vmaxvq_u8(error) != 0) {
+        return utf8_scan_scalar(start, end);
+    }
+    return end;
+}
+
+#elif defined(__x86_64__) || defined(_M_X64)
+
+/* _mm_shuffle_epi8 and _mm_alignr_epi8 are SSSE3, implied by the SSE4.2 baseline */
+static inline __m128i utf8_block_errors(__m128i input, __m128i prev_input) {
+    static const uint8_t byte_1_high_table[16] = {UTF8_BYTE_1_HIGH};
+    static const uint8_t byte_1_low_table[16] = {UTF8_BYTE_1_LOW};
+    static const uint8_t byte_2_high_table[16] = {UTF8_BYTE_2_HIGH};
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i byte_1_high = _mm_loadu_si128((const __m128i*) byte_1_high_table);
+    const __m128i byte_1_low = _mm_loadu_si128((const __m128i*) byte_1_low_table);
+    const __m128i byte_2_high = _mm_loadu_si128((const __m128i*) byte_2_high_table);
+
+    /* prevN: the block shifted so each lane sees the byte N positions earlier */
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+
+    /* There is no 8-bit shift; shifting 16-bit lanes and masking is equivalent */
+    __m128i special = _mm_and_si128(
+        _mm_and_si128(
+            _mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+            _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+        _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+    __m128i must_be_cont = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8((char) (0xE0 - 0x80))),
+                                        _mm_subs_epu8(prev3, _mm_set1_epi8((char) (0xF0 - 0x80))));
+    return _mm_xor_si128(_mm_and_si128(must_be_cont, _mm_set1_epi8((char) 0x80)), special);
+}
+
+const char* edn_simd_validate_utf8(const char* ptr, const char* end) {
+    static const uint8_t incomplete_max_table[16] = {UTF8_INCOMPLETE_MAX};
+    const char* start = ptr;
+    const __m128i incomplete_max = _mm_loadu_si128((const __m128i*) incomplete_max_table);
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    __m128i error = _mm_setzero_si128();
+
+    while (ptr + 16 <= end) {
+        __m128i input = _mm_loadu_si128((const __m128i*) ptr);
+        if (_mm_movemask_epi8(input) == 0) {
+            error = _mm_or_si128(error, prev_incomplete);
+            prev_incomplete = _mm_setzero_si128();
+        } else {
+            error = _mm_or_si128(error, utf8_block_errors(input, prev_input));
+            prev_incomplete = _mm_subs_epu8(input, incomplete_max);
+        }
+        prev_input = input;
+        ptr += 16;
+    }
+
+    /* Zero padding is ASCII, so it also flushes a sequence cut off at the end */
+    char tail[16] = {0};
+    memcpy(tail, ptr, (size_t) (end - ptr));
+    __m128i input = _mm_loadu_si128((const __m128i*) tail);
+    error = _mm_or_si128(error, utf8_block_errors(input, prev_input));
+
+    if (!_mm_testz_si128(error, error)) {
+        return utf8_scan_scalar(start, end);
+    }
+    return end;
+}
+
+#else
+
+const char* edn_simd_validate_utf8(const char* ptr, const char* end) {
+    return utf8_scan_scalar(ptr, end);
+}
+
+#endif
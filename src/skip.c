@@ -0,0 +1,215 @@
+/**
+ * EDN.C - Structural form skipper
+ *
+ * Finds the extent of the next form without building any values. Used by
+ * raw tagged readers, which receive the source slice instead of a parsed
+ * value.
+ *
+ * The skipper is structural: it balances brackets, honors strings,
+ * character literals, comments, discards and dispatch prefixes, and gates
+ * nesting with the parser's depth limit. It does not validate atoms
+ * (numbers, symbols, escapes); that is left to whoever consumes the slice.
+ */
+
+#include <string.h>
+
+#include "edn_internal.h"
+
+static const char* skip_token(const char* ptr, const char* end) {
+    while (ptr < end && !is_delimiter((unsigned char) *ptr)) {
+        ptr++;
+    }
+    return ptr;
+}
+
+static edn_skip_result_t skip_string(edn_parser_t* parser) {
+    const char* start = parser->current;
+
+#ifdef EDN_ENABLE_EXPERIMENTAL_EXTENSION
+    /* Text block: """\n ... """ (with \""" as the only escape) */
+    if (parser->current + 3 < parser->end && parser->current[1] == '"' &&
+        parser->current[2] == '"' && parser->current[3] == '\n') {
+        const char* ptr = parser->current + 4;
+        while (ptr + 3 <= parser->end) {
+            if (ptr[0] == '"' && ptr[1] == '"' && ptr[2] == '"' && ptr[-1] != '\\') {
+                parser->current = ptr + 3;
+                return EDN_SKIP_OK;
+            }
+            ptr++;
+        }
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_STRING, "Unterminated text block", start,
+                             parser->end);
+        return EDN_SKIP_ERROR;
+    }
+#endif
+
+    bool has_escapes;
+    const char* closing_quote = edn_simd_find_quote(start + 1, parser->end, &has_escapes);
+    if (!closing_quote) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_STRING, "Unterminated string", start,
+                             parser->end);
+        return EDN_SKIP_ERROR;
+    }
+    parser->current = closing_quote + 1;
+    return EDN_SKIP_OK;
+}
+
+static edn_skip_result_t skip_collection(edn_parser_t* parser, char close) {
+    const char* start = parser->current;
+    parser->current++;
+
+    if (!edn_enter_depth(parser)) {
+        return EDN_SKIP_ERROR;
+    }
+
+    for (;;) {
+        edn_skip_result_t r = edn_skip_value(parser, NULL);
+        if (r == EDN_SKIP_ERROR) {
+            edn_leave_depth(parser);
+            return EDN_SKIP_ERROR;
+        }
+        if (r == EDN_SKIP_CLOSE) {
+            if (parser->current >= parser->end) {
+                edn_leave_depth(parser);
+                edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
+                                     "Unterminated collection", start, parser->end);
+                return EDN_SKIP_ERROR;
+            }
+            if (*parser->current != close) {
+                edn_leave_depth(parser);
+                edn_parser_set_error(parser, EDN_ERROR_UNMATCHED_DELIMITER,
+                                     "Mismatched closing delimiter", start, parser->current + 1);
+                return EDN_SKIP_ERROR;
+            }
+            parser->current++;
+            edn_leave_depth(parser);
+            return EDN_SKIP_OK;
+        }
+    }
+}
+
+edn_skip_result_t edn_skip_value(edn_parser_t* parser, const char** out_start) {
+    for (;;) {
+        if (!edn_skip_whitespace(parser)) {
+            return EDN_SKIP_CLOSE; /* EOF: caller decides whether that is an error */
+        }
+
+        const char* start = parser->current;
+        const char* end = parser->end;
+        char c = *start;
+
+        if (out_start) {
+            *out_start = start;
+        }
+
+        switch (c) {
+            case ')':
+            case ']':
+            case '}':
+                return EDN_SKIP_CLOSE;
+
+            case '(':
+                return skip_collection(parser, ')');
+            case '[':
+                return skip_collection(parser, ']');
+            case '{':
+                return skip_collection(parser, '}');
+
+            case '"':
+                return skip_string(parser);
+
+            case '\\':
+                /* Character literal: first char is always part of it (e.g. \) or \"),
+                 * then any named/unicode suffix up to the next delimiter. */
+                if (start + 1 >= end) {
+                    edn_parser_set_error(parser, EDN_ERROR_INVALID_CHARACTER,
+                                         "Unexpected end of input in character literal", start,
+                                         end);
+                    return EDN_SKIP_ERROR;
+                }
+                parser->current = skip_token(start + 2, end);
+                return EDN_SKIP_OK;
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+            case '^': {
+                /* ^meta form: both halves belong to the slice */
+                parser->current++;
+                if (!edn_enter_depth(parser)) {
+                    return EDN_SKIP_ERROR;
+                }
+                edn_skip_result_t r = edn_skip_value(parser, NULL);
+                if (r == EDN_SKIP_OK) {
+                    r = edn_skip_value(parser, NULL);
+                }
+                edn_leave_depth(parser);
+                if (r == EDN_SKIP_CLOSE) {
+                    edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                                         "Metadata must be followed by a form", start,
+                                         parser->current);
+                    return EDN_SKIP_ERROR;
+                }
+                return r;
+            }
+#endif
+
+            case '#': {
+                if (start + 1 >= end) {
+                    edn_parser_set_error(parser, EDN_ERROR_UNEXPECTED_EOF,
+                                         "Unexpected end of input after '#' (expected tag)", start,
+                                         end);
+                    return EDN_SKIP_ERROR;
+                }
+                char next = start[1];
+                if (next == '{') {
+                    parser->current++;
+                    return skip_collection(parser, '}');
+                }
+                if (next == '#') {
+                    parser->current = skip_token(start + 2, end);
+                    return EDN_SKIP_OK;
+                }
+
+                /* #_ form is whitespace; #tag form and #:ns{} are one form */
+                bool discard = next == '_';
+                if (!discard) {
+                    const char* tag_end = skip_token(start + 1, end);
+                    if (tag_end == start + 1) {
+                        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                                             "Tagged literal tag must immediately follow '#' (no "
+                                             "whitespace allowed)",
+                                             start, start + 1);
+                        return EDN_SKIP_ERROR;
+                    }
+                    parser->current = tag_end;
+                } else {
+                    parser->current += 2;
+                }
+
+                if (!edn_enter_depth(parser)) {
+                    return EDN_SKIP_ERROR;
+                }
+                edn_skip_result_t r = edn_skip_value(parser, NULL);
+                edn_leave_depth(parser);
+                if (r == EDN_SKIP_CLOSE) {
+                    if (discard) {
+                        edn_parser_set_error(parser, EDN_ERROR_INVALID_DISCARD,
+                                             "Discard macro missing value", start, start + 2);
+                    } else {
+                        edn_parser_set_error(parser, EDN_ERROR_UNEXPECTED_EOF,
+                                             "Tagged literal missing value", start,
+                                             parser->current);
+                    }
+                    return EDN_SKIP_ERROR;
+                }
+                if (r == EDN_SKIP_ERROR || !discard) {
+                    return r;
+                }
+                continue; /* Discarded: the form we want comes next */
+            }
+
+            default:
+                parser->current = skip_token(start + 1, end);
+                return EDN_SKIP_OK;
+        }
+    }
+}
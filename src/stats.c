@@ -0,0 +1,107 @@
+/**
+ * EDN.C - Parse instrumentation
+ *
+ * Tree-shape counters and trace points behind EDN_ENABLE_INSTRUMENTATION.
+ * The hot-path counters themselves live next to the code they count
+ * (EDN_STATS_INC); this file only holds what runs once per parse. The clock
+ * is edn_monotonic_ns (budget.c).
+ */
+
+#include "edn_internal.h"
+
+#ifdef EDN_ENABLE_INSTRUMENTATION
+
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define EDN_HAVE_USDT 1
+#endif
+#endif
+
+static void count_value(const edn_value_t* value, size_t depth, edn_parse_stats_t* stats) {
+    if (value == NULL) {
+        return;
+    }
+    stats->nodes[value->type]++;
+
+    edn_value_t* const* elements = NULL;
+    size_t count = 0;
+    switch (value->type) {
+        case EDN_TYPE_STRING:
+            stats->strings_with_escapes += edn_string_has_escapes(value);
+            return;
+        case EDN_TYPE_LIST:
+            elements = value->as.list.elements;
+            count = value->as.list.count;
+            break;
+        case EDN_TYPE_VECTOR:
+            elements = value->as.vector.elements;
+            count = value->as.vector.count;
+            break;
+        case EDN_TYPE_SET:
+            elements = value->as.set.elements;
+            count = value->as.set.count;
+            break;
+        case EDN_TYPE_MAP:
+            if (depth + 1 > stats->max_depth) {
+                stats->max_depth = depth + 1;
+            }
+            for (size_t i = 0; i < value->as.map.count; i++) {
+                count_value(value->as.map.entries[i].key, depth + 1, stats);
+                count_value(value->as.map.entries[i].value, depth + 1, stats);
+            }
+            return;
+        case EDN_TYPE_TAGGED:
+            count_value(value->as.tagged.value, depth, stats);
+            return;
+        default:
+            return;
+    }
+
+    if (depth + 1 > stats->max_depth) {
+        stats->max_depth = depth + 1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        count_value(elements[i], depth + 1, stats);
+    }
+}
+
+void edn_stats_count_tree(const edn_value_t* value, edn_parse_stats_t* stats) {
+    count_value(value, 0, stats);
+    stats->arena_blocks = edn_value_memory_blocks(value, NULL, 0);
+}
+
+/* ========================================================================
+ * Trace points
+ * ======================================================================== */
+
+static edn_trace_fn trace_hook = NULL;
+static void* trace_ctx = NULL;
+
+void edn_set_trace_hook(edn_trace_fn hook, void* ctx) {
+    trace_hook = hook;
+    trace_ctx = ctx;
+}
+
+void edn_trace_parse_begin(const char* input, size_t length) {
+#ifdef EDN_HAVE_USDT
+    DTRACE_PROBE2(edn, parse_begin, input, length);
+#endif
+    if (trace_hook != NULL) {
+        trace_hook(EDN_TRACE_PARSE_BEGIN, input, length, NULL, NULL, trace_ctx);
+    }
+}
+
+void edn_trace_parse_end(const char* input, size_t length, const edn_result_t* result,
+                         const edn_parse_stats_t* stats, size_t bytes_scanned) {
+#ifdef EDN_HAVE_USDT
+    DTRACE_PROBE4(edn, parse_end, input, length, (int) result->error, bytes_scanned);
+#else
+    (void) bytes_scanned;
+#endif
+    if (trace_hook != NULL) {
+        trace_hook(EDN_TRACE_PARSE_END, input, length, result, stats, trace_ctx);
+    }
+}
+
+#endif /* EDN_ENABLE_INSTRUMENTATION */
@@ -250,7 +250,13 @@ edn_value_t* edn_read_string(edn_parser_t* parser) {
     /* Check for text block pattern: """\n */
     if (parser->current + 3 < parser->end && parser->current[0] == '"' &&
         parser->current[1] == '"' && parser->current[2] == '"' && parser->current[3] == '\n') {
-        return edn_parse_text_block(parser);
+        edn_value_t* block = edn_parse_text_block(parser);
+        if (block != NULL && parser->strict_utf8 &&
+            !edn_check_utf8(parser, value_start, parser->current, EDN_ERROR_INVALID_STRING,
+                            "Invalid UTF-8 in text block")) {
+            return NULL;
+        }
+        return block;
     }
 #endif
 
@@ -258,7 +264,10 @@ edn_value_t* edn_read_string(edn_parser_t* parser) {
     const char* start = ptr;
 
     bool has_escapes = false;
-    const char* closing_quote = edn_simd_find_quote(ptr, parser->end, &has_escapes);
+    bool non_ascii = false;
+    const char* closing_quote =
+        parser->strict_utf8 ? edn_simd_find_quote_utf8(ptr, parser->end, &has_escapes, &non_ascii)
+                            : edn_simd_find_quote(ptr, parser->end, &has_escapes);
 
     if (!closing_quote) {
         edn_parser_set_error(parser, EDN_ERROR_INVALID_STRING, "Unterminated string", value_start,
@@ -266,6 +275,12 @@ edn_value_t* edn_read_string(edn_parser_t* parser) {
         return NULL;
     }
 
+    /* Strict mode: only strings that contain non-ASCII bytes need a second look */
+    if (non_ascii && !edn_check_utf8(parser, start, closing_quote, EDN_ERROR_INVALID_STRING,
+                                     "Invalid UTF-8 in string")) {
+        return NULL;
+    }
+
     edn_value_t* value = edn_arena_alloc_value(parser->arena);
     if (!value) {
         edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY, "Out of memory allocating string",
@@ -6,6 +6,45 @@
 
 #include "edn_internal.h"
 
+/* Raw reader path: hand the reader the source slice of the next form
+ * instead of materializing it. Depth was entered by the caller. */
+static edn_value_t* read_tagged_raw(edn_parser_t* parser, edn_raw_reader_fn raw_reader,
+                                    const char* value_start) {
+    const char* form_start = parser->current;
+    edn_skip_result_t skipped = edn_skip_value(parser, &form_start);
+    edn_leave_depth(parser);
+
+    if (skipped == EDN_SKIP_ERROR) {
+        return NULL; /* Error already set */
+    }
+    if (skipped == EDN_SKIP_CLOSE) {
+        edn_parser_set_error(parser, EDN_ERROR_UNEXPECTED_EOF, "Tagged literal missing value",
+                             value_start, parser->current);
+        return NULL;
+    }
+    /* The skipper checks structure only; strict mode still vets what the reader sees */
+    if (parser->strict_utf8 &&
+        !edn_check_utf8(parser, form_start, parser->current, EDN_ERROR_INVALID_STRING,
+                        "Invalid UTF-8 in raw tagged form")) {
+        return NULL;
+    }
+
+    const char* error_msg = NULL;
+    EDN_STATS_INC(parser, reader_calls);
+    edn_value_t* result =
+        raw_reader(form_start, parser->current - form_start, parser->arena, &error_msg);
+    if (result == NULL) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             error_msg ? error_msg : "Reader function failed", value_start,
+                             parser->current);
+        return NULL;
+    }
+
+    result->source_start = value_start - parser->input;
+    result->source_end = parser->current - parser->input;
+    return result;
+}
+
 edn_value_t* edn_read_tagged(edn_parser_t* parser) {
     const char* value_start = parser->current;
 
@@ -53,6 +92,17 @@ edn_value_t* edn_read_tagged(edn_parser_t* parser) {
     size_t tag_length = tag_end - tag_start;
     const char* tag_string = tag_start;
 
+    /* Readers are skipped in discard mode; a raw reader never sees a parsed value */
+    edn_reader_binding_t binding = {NULL, NULL, false};
+    if (parser->reader_registry != NULL && !parser->discard_mode) {
+        edn_reader_lookup_internal(parser->reader_registry, tag_string, tag_length, &binding);
+        if (binding.raw_reader != NULL) {
+            return read_tagged_raw(parser, binding.raw_reader, value_start);
+        }
+    }
+
+    edn_lazy_tagged_t* lazy = NULL;
+
     edn_value_t* value = edn_read_value(parser);
     if (value == NULL) {
         edn_leave_depth(parser);
@@ -63,15 +113,32 @@ edn_value_t* edn_read_tagged(edn_parser_t* parser) {
         return NULL;
     }
 
+    /* Tags are transparent to a schema: it checks the form a reader receives */
+    if (!edn_schema_form(parser, value)) {
+        edn_leave_depth(parser);
+        return NULL;
+    }
+
     /* Check if reader registry is provided and not in discard mode */
     if (parser->reader_registry != NULL && !parser->discard_mode) {
-        edn_reader_fn reader =
-            edn_reader_lookup_internal(parser->reader_registry, tag_string, tag_length);
-
-        if (reader != NULL) {
+        if (binding.reader != NULL && binding.lazy) {
+            /* Defer: keep the tagged literal, resolve on first access */
+            lazy = edn_arena_alloc(parser->arena, sizeof(edn_lazy_tagged_t));
+            if (lazy == NULL) {
+                edn_leave_depth(parser);
+                edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
+                                     "Out of memory allocating tagged literal", value_start,
+                                     parser->current);
+                return NULL;
+            }
+            lazy->reader = binding.reader;
+            lazy->resolved = NULL;
+            lazy->error_message = NULL;
+        } else if (binding.reader != NULL) {
             /* Invoke custom reader */
             const char* error_msg = NULL;
-            edn_value_t* result = reader(value, parser->arena, &error_msg);
+            EDN_STATS_INC(parser, reader_calls);
+            edn_value_t* result = binding.reader(value, parser->arena, &error_msg);
 
             if (result == NULL) {
                 edn_leave_depth(parser);
@@ -87,23 +154,24 @@ edn_value_t* edn_read_tagged(edn_parser_t* parser) {
 
             edn_leave_depth(parser);
             return result;
-        }
-
-        /* No reader found - use default fallback */
-        switch (parser->default_reader_mode) {
-            case EDN_DEFAULT_READER_UNWRAP:
-                edn_leave_depth(parser);
-                return value;
-
-            case EDN_DEFAULT_READER_ERROR:
-                edn_leave_depth(parser);
-                edn_parser_set_error(parser, EDN_ERROR_UNKNOWN_TAG, "No reader registered for tag",
-                                     value_start, parser->current);
-                return NULL;
-
-            case EDN_DEFAULT_READER_PASSTHROUGH:
-                /* Fall through to existing behavior */
-                break;
+        } else {
+            /* No reader found - use default fallback */
+            switch (parser->default_reader_mode) {
+                case EDN_DEFAULT_READER_UNWRAP:
+                    edn_leave_depth(parser);
+                    return value;
+
+                case EDN_DEFAULT_READER_ERROR:
+                    edn_leave_depth(parser);
+                    edn_parser_set_error(parser, EDN_ERROR_UNKNOWN_TAG,
+                                         "No reader registered for tag", value_start,
+                                         parser->current);
+                    return NULL;
+
+                case EDN_DEFAULT_READER_PASSTHROUGH:
+                    /* Fall through to existing behavior */
+                    break;
+            }
         }
     }
 
@@ -122,9 +190,38 @@ edn_value_t* edn_read_tagged(edn_parser_t* parser) {
     tagged->as.tagged.tag = tag_string;
     tagged->as.tagged.tag_length = tag_length;
     tagged->as.tagged.value = value;
+    tagged->as.tagged.lazy = lazy;
     tagged->arena = parser->arena;
     tagged->source_start = value_start - parser->input;
     tagged->source_end = parser->current - parser->input;
 
     return tagged;
 }
+
+edn_value_t* edn_tagged_resolve(const edn_value_t* value, const char** error_message) {
+    if (error_message) {
+        *error_message = NULL;
+    }
+    if (!value || value->type != EDN_TYPE_TAGGED || value->as.tagged.lazy == NULL) {
+        return (edn_value_t*) value;
+    }
+
+    edn_lazy_tagged_t* lazy = value->as.tagged.lazy;
+    if (lazy->resolved == NULL && lazy->error_message == NULL) {
+        const char* error_msg = NULL;
+        edn_value_t* result = lazy->reader(value->as.tagged.value, value->arena, &error_msg);
+        if (result == NULL) {
+            lazy->error_message = error_msg ? error_msg : "Reader function failed";
+        } else {
+            /* Reader result spans the whole tagged literal, as with eager readers */
+            result->source_start = value->source_start;
+            result->source_end = value->source_end;
+            lazy->resolved = result;
+        }
+    }
+
+    if (lazy->resolved == NULL && error_message) {
+        *error_message = lazy->error_message;
+    }
+    return lazy->resolved;
+}
@@ -0,0 +1,1294 @@
+/**
+ * EDN.C - Tape document
+ *
+ * Records a document as a flat array of 64-bit words filled from the event
+ * parser, plus one side buffer for strings, identifiers and big numbers.
+ * Collections carry their skip distance and element count, so cursors move
+ * between siblings and count elements without visiting children. Trees are
+ * only built on request, one subtree at a time.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "edn_internal.h"
+
+/*
+ * Every entry is two words: a kind in the top byte with a 56-bit payload,
+ * then a value word. The payload is the side-buffer offset of the entry's
+ * text or record (TAPE_EMPTY_TEXT when it has neither), and the value
+ * holds the scalar, the text length, or a collection's extent. The fixed
+ * width means the next entry never depends on the current one.
+ */
+#define TAPE_KIND_SHIFT 56
+#define TAPE_PAYLOAD_MASK ((1ULL << TAPE_KIND_SHIFT) - 1)
+#define TAPE_ENTRY 2 /* Words per entry */
+
+#define TAPE_INITIAL_WORDS 256
+#define TAPE_INITIAL_BUFFER 1024
+#define TAPE_INITIAL_FRAMES 16
+
+typedef enum {
+    TAPE_NIL,
+    TAPE_FALSE,     /* Value: 0 */
+    TAPE_TRUE,      /* Value: 1 */
+    TAPE_INT,       /* Value: the integer */
+    TAPE_DOUBLE,    /* Value: the bit pattern */
+    TAPE_RATIO,     /* Payload: ratio record */
+    TAPE_CHARACTER, /* Value: codepoint */
+    TAPE_STRING,    /* Payload: text; value: its length */
+    TAPE_KEYWORD,   /* Payload: the name's text; value: its length */
+    TAPE_SYMBOL,    /* Same as keywords */
+    TAPE_TAG,       /* Same as strings; the tagged form follows */
+    TAPE_BIGINT,    /* Payload: number record */
+    TAPE_BIGDEC,    /* Payload: number record */
+    TAPE_BIGRATIO,  /* Payload: big ratio record */
+    TAPE_META,      /* The metadata payload and then the annotated form follow */
+    TAPE_LIST,      /* Value: index just past the matching end entry */
+    TAPE_VECTOR,
+    TAPE_SET,
+    TAPE_MAP,
+    TAPE_END_LIST, /* End entries follow the begin kinds in order; value: form count */
+    TAPE_END_VECTOR,
+    TAPE_END_SET,
+    TAPE_END_MAP
+} tape_kind_t;
+
+#define TAPE_END_OFFSET (TAPE_END_LIST - TAPE_LIST)
+
+/*
+ * Side buffer contents. Every byte string is followed by a NUL, and
+ * lengths are uint64_t copied with memcpy (nothing is aligned). Each text
+ * is preceded by the length of its namespace, which is 0 except for
+ * identifiers, whose namespace comes first. The buffer opens with an empty
+ * text at TAPE_EMPTY_TEXT.
+ *   text        [0][bytes]
+ *   identifier  [ns][ns_length][name]                (no ns when ns_length is 0)
+ *   number      [length][negative][radix][digits]    (one byte each for the flags)
+ *   ratio       [numerator][denominator]             (int64_t each)
+ *   big ratio   [numer_length][denom_length][negative][numerator][denominator]
+ */
+#define TAPE_EMPTY_TEXT 8
+
+struct edn_tape {
+    uint64_t* words;
+    size_t length;
+    size_t capacity;
+    char* buffer;
+    size_t buffer_length;
+    size_t buffer_capacity;
+};
+
+static inline tape_kind_t word_kind(uint64_t word) {
+    return (tape_kind_t) (word >> TAPE_KIND_SHIFT);
+}
+
+static inline size_t word_payload(uint64_t word) {
+    return (size_t) (word & TAPE_PAYLOAD_MASK);
+}
+
+static inline uint64_t make_word(tape_kind_t kind, uint64_t payload) {
+    return ((uint64_t) kind << TAPE_KIND_SHIFT) | payload;
+}
+
+static inline uint64_t read_u64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/* ========================================================================
+ * Building
+ * ======================================================================== */
+
+typedef struct {
+    size_t begin;   /* Index of the opening word (unused for the top level) */
+    size_t count;   /* Forms recorded so far */
+    size_t pending; /* Upcoming forms that belong to a tag or metadata word */
+} tape_frame_t;
+
+typedef struct {
+    uint64_t hash;
+    size_t index; /* Word index of the form */
+} tape_form_hash_t;
+
+typedef struct {
+    edn_tape_t* tape;
+    tape_frame_t* frames; /* frames[0] is the top level */
+    size_t depth;
+    size_t frame_capacity;
+    tape_form_hash_t* hashes; /* Scratch for the duplicate check of one set or map */
+    size_t hash_capacity;
+    edn_error_t error; /* Why a handler aborted, or EDN_OK for out of memory */
+    const char* error_message;
+} tape_builder_t;
+
+static bool has_duplicate_forms(tape_builder_t* b, size_t begin);
+
+static bool push_entry(edn_tape_t* tape, tape_kind_t kind, uint64_t payload, uint64_t value) {
+    if (tape->capacity - tape->length < TAPE_ENTRY) {
+        size_t capacity = tape->capacity * 2;
+        uint64_t* words = realloc(tape->words, capacity * sizeof(uint64_t));
+        if (words == NULL) {
+            return false;
+        }
+        tape->words = words;
+        tape->capacity = capacity;
+    }
+    tape->words[tape->length] = make_word(kind, payload);
+    tape->words[tape->length + 1] = value;
+    tape->length += TAPE_ENTRY;
+    return true;
+}
+
+/* Reserve `size` bytes at the end of the side buffer; returns the offset */
+static bool reserve_bytes(edn_tape_t* tape, size_t size, size_t* offset) {
+    size_t needed = tape->buffer_length + size;
+    if (needed < size) {
+        return false;
+    }
+    if (needed > tape->buffer_capacity) {
+        size_t capacity = tape->buffer_capacity;
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        char* buffer = realloc(tape->buffer, capacity);
+        if (buffer == NULL) {
+            return false;
+        }
+        tape->buffer = buffer;
+        tape->buffer_capacity = capacity;
+    }
+    *offset = tape->buffer_length;
+    tape->buffer_length = needed;
+    return true;
+}
+
+static inline char* put_u64(char* p, uint64_t v) {
+    memcpy(p, &v, sizeof(v));
+    return p + sizeof(v);
+}
+
+static inline char* put_bytes(char* p, const char* s, size_t length) {
+    if (length > 0) {
+        memcpy(p, s, length);
+    }
+    p[length] = '\0';
+    return p + length + 1;
+}
+
+/* The form about to be recorded: count it unless a tag or metadata word owns it */
+static inline void begin_form(tape_builder_t* b) {
+    tape_frame_t* frame = &b->frames[b->depth];
+    if (frame->pending > 0) {
+        frame->pending--;
+    } else {
+        frame->count++;
+    }
+}
+
+static int put_text(tape_builder_t* b, tape_kind_t kind, const char* s, size_t length) {
+    edn_tape_t* tape = b->tape;
+    size_t offset;
+    if (length > SIZE_MAX - 9 || !reserve_bytes(tape, 8 + length + 1, &offset)) {
+        return 1;
+    }
+    char* p = put_u64(tape->buffer + offset, 0);
+    put_bytes(p, s, length);
+    return push_entry(tape, kind, offset + 8, length) ? 0 : 1;
+}
+
+static int put_identifier(tape_builder_t* b, tape_kind_t kind, const char* ns, size_t ns_length,
+                          const char* name, size_t name_length) {
+    edn_tape_t* tape = b->tape;
+    size_t ns_size = ns_length > 0 ? ns_length + 1 : 0;
+    size_t offset;
+    begin_form(b);
+    if (!reserve_bytes(tape, ns_size + 8 + name_length + 1, &offset)) {
+        return 1;
+    }
+    char* p = tape->buffer + offset;
+    if (ns_length > 0) {
+        p = put_bytes(p, ns, ns_length);
+    }
+    p = put_u64(p, ns_length);
+    put_bytes(p, name, name_length);
+    return push_entry(tape, kind, offset + ns_size + 8, name_length) ? 0 : 1;
+}
+
+static int put_number(tape_builder_t* b, tape_kind_t kind, const char* digits, size_t length,
+                      bool negative, uint8_t radix) {
+    edn_tape_t* tape = b->tape;
+    size_t offset;
+    begin_form(b);
+    if (!reserve_bytes(tape, 8 + 2 + length + 1, &offset)) {
+        return 1;
+    }
+    char* p = put_u64(tape->buffer + offset, length);
+    *p++ = (char) negative;
+    *p++ = (char) radix;
+    put_bytes(p, digits, length);
+    return push_entry(tape, kind, offset, 0) ? 0 : 1;
+}
+
+static int tape_on_nil(void* ctx) {
+    tape_builder_t* b = ctx;
+    begin_form(b);
+    return push_entry(b->tape, TAPE_NIL, TAPE_EMPTY_TEXT, 0) ? 0 : 1;
+}
+
+static int tape_on_bool(void* ctx, bool value) {
+    tape_builder_t* b = ctx;
+    begin_form(b);
+    return push_entry(b->tape, value ? TAPE_TRUE : TAPE_FALSE, TAPE_EMPTY_TEXT, value) ? 0 : 1;
+}
+
+static int tape_on_int(void* ctx, int64_t value) {
+    tape_builder_t* b = ctx;
+    begin_form(b);
+    return push_entry(b->tape, TAPE_INT, TAPE_EMPTY_TEXT, (uint64_t) value) ? 0 : 1;
+}
+
+static int tape_on_double(void* ctx, double value) {
+    tape_builder_t* b = ctx;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    begin_form(b);
+    return push_entry(b->tape, TAPE_DOUBLE, TAPE_EMPTY_TEXT, bits) ? 0 : 1;
+}
+
+static int tape_on_string(void* ctx, const char* s, size_t length) {
+    tape_builder_t* b = ctx;
+    begin_form(b);
+    return put_text(b, TAPE_STRING, s, length);
+}
+
+static int tape_on_keyword(void* ctx, const char* ns, size_t ns_length, const char* name,
+                           size_t name_length) {
+    return put_identifier(ctx, TAPE_KEYWORD, ns, ns_length, name, name_length);
+}
+
+static int tape_on_symbol(void* ctx, const char* ns, size_t ns_length, const char* name,
+                          size_t name_length) {
+    return put_identifier(ctx, TAPE_SYMBOL, ns, ns_length, name, name_length);
+}
+
+static int tape_on_character(void* ctx, uint32_t codepoint) {
+    tape_builder_t* b = ctx;
+    begin_form(b);
+    return push_entry(b->tape, TAPE_CHARACTER, TAPE_EMPTY_TEXT, codepoint) ? 0 : 1;
+}
+
+static int tape_on_bigint(void* ctx, const char* digits, size_t length, bool negative,
+                          uint8_t radix) {
+    return put_number(ctx, TAPE_BIGINT, digits, length, negative, radix);
+}
+
+static int tape_on_bigdec(void* ctx, const char* digits, size_t length, bool negative) {
+    return put_number(ctx, TAPE_BIGDEC, digits, length, negative, 10);
+}
+
+static int tape_on_ratio(void* ctx, int64_t numerator, int64_t denominator) {
+    tape_builder_t* b = ctx;
+    edn_tape_t* tape = b->tape;
+    size_t offset;
+    begin_form(b);
+    if (!reserve_bytes(tape, 16, &offset)) {
+        return 1;
+    }
+    char* p = put_u64(tape->buffer + offset, (uint64_t) numerator);
+    put_u64(p, (uint64_t) denominator);
+    return push_entry(tape, TAPE_RATIO, offset, 0) ? 0 : 1;
+}
+
+static int tape_on_bigratio(void* ctx, const char* numerator, size_t numer_length, bool negative,
+                            const char* denominator, size_t denom_length) {
+    tape_builder_t* b = ctx;
+    edn_tape_t* tape = b->tape;
+    size_t offset;
+    begin_form(b);
+    if (!reserve_bytes(tape, 16 + 1 + numer_length + 1 + denom_length + 1, &offset)) {
+        return 1;
+    }
+    char* p = put_u64(tape->buffer + offset, numer_length);
+    p = put_u64(p, denom_length);
+    *p++ = (char) negative;
+    p = put_bytes(p, numerator, numer_length);
+    put_bytes(p, denominator, denom_length);
+    return push_entry(tape, TAPE_BIGRATIO, offset, 0) ? 0 : 1;
+}
+
+static int tape_begin(tape_builder_t* b, tape_kind_t kind) {
+    begin_form(b);
+    if (b->depth + 1 == b->frame_capacity) {
+        size_t capacity = b->frame_capacity * 2;
+        tape_frame_t* frames = realloc(b->frames, capacity * sizeof(tape_frame_t));
+        if (frames == NULL) {
+            return 1;
+        }
+        b->frames = frames;
+        b->frame_capacity = capacity;
+    }
+    tape_frame_t* frame = &b->frames[++b->depth];
+    frame->begin = b->tape->length;
+    frame->count = 0;
+    frame->pending = 0;
+    return push_entry(b->tape, kind, TAPE_EMPTY_TEXT, 0) ? 0 : 1;
+}
+
+static int tape_end(void* ctx) {
+    tape_builder_t* b = ctx;
+    edn_tape_t* tape = b->tape;
+    tape_frame_t* frame = &b->frames[b->depth--];
+    tape_kind_t kind = (tape_kind_t) (word_kind(tape->words[frame->begin]) + TAPE_END_OFFSET);
+    if (!push_entry(tape, kind, TAPE_EMPTY_TEXT, frame->count)) {
+        return 1;
+    }
+    tape->words[frame->begin + 1] = tape->length;
+    if ((kind == TAPE_END_SET || kind == TAPE_END_MAP) && has_duplicate_forms(b, frame->begin)) {
+        return 1;
+    }
+    return 0;
+}
+
+static int tape_on_begin_list(void* ctx) {
+    return tape_begin(ctx, TAPE_LIST);
+}
+
+static int tape_on_begin_vector(void* ctx) {
+    return tape_begin(ctx, TAPE_VECTOR);
+}
+
+static int tape_on_begin_set(void* ctx) {
+    return tape_begin(ctx, TAPE_SET);
+}
+
+static int tape_on_begin_map(void* ctx) {
+    return tape_begin(ctx, TAPE_MAP);
+}
+
+static int tape_on_tag(void* ctx, const char* tag, size_t length) {
+    tape_builder_t* b = ctx;
+    begin_form(b);
+    b->frames[b->depth].pending += 1; /* The tagged form */
+    return put_text(b, TAPE_TAG, tag, length);
+}
+
+static int tape_on_meta(void* ctx) {
+    tape_builder_t* b = ctx;
+    begin_form(b);
+    b->frames[b->depth].pending += 2; /* The payload and the annotated form */
+    return push_entry(b->tape, TAPE_META, TAPE_EMPTY_TEXT, 0) ? 0 : 1;
+}
+
+static const edn_event_handlers_t tape_handlers = {
+    .on_nil = tape_on_nil,
+    .on_bool = tape_on_bool,
+    .on_int = tape_on_int,
+    .on_double = tape_on_double,
+    .on_string = tape_on_string,
+    .on_keyword = tape_on_keyword,
+    .on_symbol = tape_on_symbol,
+    .on_character = tape_on_character,
+    .on_bigint = tape_on_bigint,
+    .on_bigdec = tape_on_bigdec,
+    .on_ratio = tape_on_ratio,
+    .on_bigratio = tape_on_bigratio,
+    .on_begin_list = tape_on_begin_list,
+    .on_end_list = tape_end,
+    .on_begin_vector = tape_on_begin_vector,
+    .on_end_vector = tape_end,
+    .on_begin_set = tape_on_begin_set,
+    .on_end_set = tape_end,
+    .on_begin_map = tape_on_begin_map,
+    .on_end_map = tape_end,
+    .on_tag = tape_on_tag,
+    .on_meta = tape_on_meta,
+    .decode_strings = true,
+};
+
+edn_result_t edn_tape_read(const char* input, size_t length, edn_tape_t** out) {
+    edn_result_t result = {0};
+
+    if (out == NULL) {
+        result.error = EDN_ERROR_INVALID_ARGUMENT;
+        result.error_message = "Tape output is NULL";
+        return result;
+    }
+    *out = NULL;
+
+    edn_tape_t* tape = calloc(1, sizeof(edn_tape_t));
+    tape_builder_t b = {0};
+    b.tape = tape;
+    b.frame_capacity = TAPE_INITIAL_FRAMES;
+    if (tape != NULL) {
+        tape->capacity = TAPE_INITIAL_WORDS;
+        tape->buffer_capacity = TAPE_INITIAL_BUFFER;
+        tape->words = malloc(tape->capacity * sizeof(uint64_t));
+        tape->buffer = malloc(tape->buffer_capacity);
+        b.frames = malloc(b.frame_capacity * sizeof(tape_frame_t));
+    }
+    if (tape == NULL || tape->words == NULL || tape->buffer == NULL || b.frames == NULL) {
+        free(b.frames);
+        edn_tape_free(tape);
+        result.error = EDN_ERROR_OUT_OF_MEMORY;
+        result.error_message = "Out of memory creating tape";
+        return result;
+    }
+    b.frames[0].begin = 0;
+    b.frames[0].count = 0;
+    b.frames[0].pending = 0;
+    memset(tape->buffer, 0, TAPE_EMPTY_TEXT + 1);
+    tape->buffer_length = TAPE_EMPTY_TEXT + 1;
+
+    result = edn_parse_events(input, length, &tape_handlers, &b);
+    free(b.frames);
+    free(b.hashes);
+    if (result.error == EDN_ERROR_ABORTED) {
+        /* Handlers abort on duplicates, at the collection's positions, or
+         * when an allocation fails */
+        result.error = b.error != EDN_OK ? b.error : EDN_ERROR_OUT_OF_MEMORY;
+        result.error_message = b.error != EDN_OK ? b.error_message : "Out of memory building tape";
+    }
+    if (result.error != EDN_OK) {
+        edn_tape_free(tape);
+        return result;
+    }
+    *out = tape;
+    return result;
+}
+
+void edn_tape_free(edn_tape_t* tape) {
+    if (tape == NULL) {
+        return;
+    }
+    free(tape->words);
+    free(tape->buffer);
+    free(tape);
+}
+
+size_t edn_tape_length(const edn_tape_t* tape) {
+    return tape ? tape->length : 0;
+}
+
+/* ========================================================================
+ * Cursors
+ * ======================================================================== */
+
+/* Index just past the form whose entry is at `i` */
+static inline size_t tape_skip(const uint64_t* words, size_t i) {
+    size_t forms = 1;
+    for (;;) {
+        uint64_t word = words[i];
+        tape_kind_t kind = word_kind(word);
+        if (kind >= TAPE_LIST) {
+            i = (size_t) words[i + 1];
+        } else {
+            i += TAPE_ENTRY;
+            if (kind == TAPE_TAG || kind == TAPE_META) {
+                /* A tag is completed by its form; metadata by its payload and form */
+                forms += kind == TAPE_META;
+                continue;
+            }
+        }
+        if (--forms == 0) {
+            return i;
+        }
+    }
+}
+
+static inline bool cursor_at_end(edn_tape_cursor_t cursor) {
+    return cursor.tape == NULL || cursor.index >= cursor.tape->length ||
+           word_kind(cursor.tape->words[cursor.index]) >= TAPE_END_LIST;
+}
+
+/* Index of the form under the cursor, looking through metadata; SIZE_MAX at the end */
+static inline size_t cursor_form(edn_tape_cursor_t cursor) {
+    if (cursor_at_end(cursor)) {
+        return SIZE_MAX;
+    }
+    const uint64_t* words = cursor.tape->words;
+    size_t i = cursor.index;
+    while (word_kind(words[i]) == TAPE_META) {
+        i = tape_skip(words, i + TAPE_ENTRY);
+    }
+    return i;
+}
+
+/* Word of the form under the cursor if it has `kind`, else NULL */
+static inline const uint64_t* cursor_word(edn_tape_cursor_t cursor, tape_kind_t kind) {
+    size_t i = cursor_form(cursor);
+    if (i == SIZE_MAX || word_kind(cursor.tape->words[i]) != kind) {
+        return NULL;
+    }
+    return &cursor.tape->words[i];
+}
+
+static inline const char* cursor_record(edn_tape_cursor_t cursor, tape_kind_t kind) {
+    const uint64_t* word = cursor_word(cursor, kind);
+    return word ? cursor.tape->buffer + word_payload(*word) : NULL;
+}
+
+/* Text of a string or tag entry; its length is the value word */
+static inline const char* cursor_text(edn_tape_cursor_t cursor, tape_kind_t kind,
+                                      size_t* length) {
+    const uint64_t* word = cursor_word(cursor, kind);
+    if (length) {
+        *length = word ? (size_t) word[1] : 0;
+    }
+    return word ? cursor.tape->buffer + word_payload(*word) : NULL;
+}
+
+edn_tape_cursor_t edn_tape_root(const edn_tape_t* tape) {
+    edn_tape_cursor_t cursor = {tape, 0};
+    return cursor;
+}
+
+bool edn_tape_at_end(edn_tape_cursor_t cursor) {
+    return cursor_at_end(cursor);
+}
+
+static const edn_type_t TAPE_TYPES[] = {
+    [TAPE_NIL] = EDN_TYPE_NIL,
+    [TAPE_FALSE] = EDN_TYPE_BOOL,
+    [TAPE_TRUE] = EDN_TYPE_BOOL,
+    [TAPE_INT] = EDN_TYPE_INT,
+    [TAPE_DOUBLE] = EDN_TYPE_FLOAT,
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    [TAPE_RATIO] = EDN_TYPE_RATIO,
+    [TAPE_BIGRATIO] = EDN_TYPE_BIGRATIO,
+#endif
+    [TAPE_CHARACTER] = EDN_TYPE_CHARACTER,
+    [TAPE_STRING] = EDN_TYPE_STRING,
+    [TAPE_KEYWORD] = EDN_TYPE_KEYWORD,
+    [TAPE_SYMBOL] = EDN_TYPE_SYMBOL,
+    [TAPE_BIGINT] = EDN_TYPE_BIGINT,
+    [TAPE_BIGDEC] = EDN_TYPE_BIGDEC,
+    [TAPE_TAG] = EDN_TYPE_TAGGED,
+    [TAPE_LIST] = EDN_TYPE_LIST,
+    [TAPE_VECTOR] = EDN_TYPE_VECTOR,
+    [TAPE_SET] = EDN_TYPE_SET,
+    [TAPE_MAP] = EDN_TYPE_MAP,
+    [TAPE_END_LIST] = EDN_TYPE_LIST,
+    [TAPE_END_VECTOR] = EDN_TYPE_VECTOR,
+    [TAPE_END_SET] = EDN_TYPE_SET,
+    [TAPE_END_MAP] = EDN_TYPE_MAP,
+};
+
+edn_type_t edn_tape_type(edn_tape_cursor_t cursor) {
+    size_t i = cursor_form(cursor);
+    if (i == SIZE_MAX) {
+        return EDN_TYPE_NIL;
+    }
+    return TAPE_TYPES[word_kind(cursor.tape->words[i])];
+}
+
+edn_tape_cursor_t edn_tape_next(edn_tape_cursor_t cursor) {
+    if (!cursor_at_end(cursor)) {
+        cursor.index = tape_skip(cursor.tape->words, cursor.index);
+    }
+    return cursor;
+}
+
+edn_tape_cursor_t edn_tape_child(edn_tape_cursor_t cursor) {
+    size_t i = cursor_form(cursor);
+    if (i == SIZE_MAX) {
+        return cursor;
+    }
+    switch (word_kind(cursor.tape->words[i])) {
+        case TAPE_LIST:
+        case TAPE_VECTOR:
+        case TAPE_SET:
+        case TAPE_MAP:
+        case TAPE_TAG:
+            cursor.index = i + TAPE_ENTRY;
+            break;
+        default:
+            cursor.index = cursor.tape->length;
+            break;
+    }
+    return cursor;
+}
+
+size_t edn_tape_count(edn_tape_cursor_t cursor) {
+    size_t i = cursor_form(cursor);
+    if (i == SIZE_MAX) {
+        return 0;
+    }
+    uint64_t word = cursor.tape->words[i];
+    tape_kind_t kind = word_kind(word);
+    if (kind != TAPE_LIST && kind != TAPE_VECTOR && kind != TAPE_SET && kind != TAPE_MAP) {
+        return 0;
+    }
+    size_t forms = (size_t) cursor.tape->words[cursor.tape->words[i + 1] - 1];
+    return kind == TAPE_MAP ? forms / 2 : forms;
+}
+
+bool edn_tape_bool_get(edn_tape_cursor_t cursor, bool* out) {
+    size_t i = cursor_form(cursor);
+    if (i == SIZE_MAX || out == NULL) {
+        return false;
+    }
+    tape_kind_t kind = word_kind(cursor.tape->words[i]);
+    if (kind != TAPE_TRUE && kind != TAPE_FALSE) {
+        return false;
+    }
+    *out = kind == TAPE_TRUE;
+    return true;
+}
+
+bool edn_tape_int64_get(edn_tape_cursor_t cursor, int64_t* out) {
+    const uint64_t* word = cursor_word(cursor, TAPE_INT);
+    if (word == NULL || out == NULL) {
+        return false;
+    }
+    *out = (int64_t) word[1];
+    return true;
+}
+
+bool edn_tape_double_get(edn_tape_cursor_t cursor, double* out) {
+    const uint64_t* word = cursor_word(cursor, TAPE_DOUBLE);
+    if (word == NULL || out == NULL) {
+        return false;
+    }
+    memcpy(out, &word[1], sizeof(double));
+    return true;
+}
+
+bool edn_tape_character_get(edn_tape_cursor_t cursor, uint32_t* out) {
+    const uint64_t* word = cursor_word(cursor, TAPE_CHARACTER);
+    if (word == NULL || out == NULL) {
+        return false;
+    }
+    *out = (uint32_t) word[1];
+    return true;
+}
+
+const char* edn_tape_string_get(edn_tape_cursor_t cursor, size_t* length) {
+    return cursor_text(cursor, TAPE_STRING, length);
+}
+
+/* Fields of the keyword or symbol whose entry is `word` */
+static void identifier_fields(const edn_tape_t* tape, const uint64_t* word, const char** ns,
+                              size_t* ns_length, const char** name, size_t* name_length) {
+    const char* text = tape->buffer + word_payload(*word);
+    size_t nsl = (size_t) read_u64(text - 8);
+    if (ns) {
+        *ns = nsl > 0 ? text - 8 - nsl - 1 : NULL;
+    }
+    if (ns_length) {
+        *ns_length = nsl;
+    }
+    if (name) {
+        *name = text;
+    }
+    if (name_length) {
+        *name_length = (size_t) word[1];
+    }
+}
+
+static bool identifier_get(edn_tape_cursor_t cursor, tape_kind_t kind, const char** ns,
+                           size_t* ns_length, const char** name, size_t* name_length) {
+    const uint64_t* word = cursor_word(cursor, kind);
+    if (word == NULL) {
+        return false;
+    }
+    identifier_fields(cursor.tape, word, ns, ns_length, name, name_length);
+    return true;
+}
+
+bool edn_tape_keyword_get(edn_tape_cursor_t cursor, const char** ns, size_t* ns_length,
+                          const char** name, size_t* name_length) {
+    return identifier_get(cursor, TAPE_KEYWORD, ns, ns_length, name, name_length);
+}
+
+bool edn_tape_symbol_get(edn_tape_cursor_t cursor, const char** ns, size_t* ns_length,
+                         const char** name, size_t* name_length) {
+    return identifier_get(cursor, TAPE_SYMBOL, ns, ns_length, name, name_length);
+}
+
+static const char* number_get(edn_tape_cursor_t cursor, tape_kind_t kind, size_t* length,
+                              bool* negative, uint8_t* radix) {
+    const char* record = cursor_record(cursor, kind);
+    if (length) {
+        *length = record ? (size_t) read_u64(record) : 0;
+    }
+    if (negative) {
+        *negative = record ? record[8] != 0 : false;
+    }
+    if (radix) {
+        *radix = record ? (uint8_t) record[9] : 10;
+    }
+    return record ? record + 10 : NULL;
+}
+
+const char* edn_tape_bigint_get(edn_tape_cursor_t cursor, size_t* length, bool* negative,
+                                uint8_t* radix) {
+    return number_get(cursor, TAPE_BIGINT, length, negative, radix);
+}
+
+const char* edn_tape_bigdec_get(edn_tape_cursor_t cursor, size_t* length, bool* negative) {
+    return number_get(cursor, TAPE_BIGDEC, length, negative, NULL);
+}
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+bool edn_tape_ratio_get(edn_tape_cursor_t cursor, int64_t* numerator, int64_t* denominator) {
+    const char* record = cursor_record(cursor, TAPE_RATIO);
+    if (record == NULL || numerator == NULL || denominator == NULL) {
+        return false;
+    }
+    *numerator = (int64_t) read_u64(record);
+    *denominator = (int64_t) read_u64(record + 8);
+    return true;
+}
+
+bool edn_tape_bigratio_get(edn_tape_cursor_t cursor, const char** numerator,
+                           size_t* numer_length, bool* numer_negative, const char** denominator,
+                           size_t* denom_length) {
+    const char* record = cursor_record(cursor, TAPE_BIGRATIO);
+    if (record == NULL) {
+        return false;
+    }
+    size_t nl = (size_t) read_u64(record);
+    if (numerator) {
+        *numerator = record + 17;
+    }
+    if (numer_length) {
+        *numer_length = nl;
+    }
+    if (numer_negative) {
+        *numer_negative = record[16] != 0;
+    }
+    if (denominator) {
+        *denominator = record + 17 + nl + 1;
+    }
+    if (denom_length) {
+        *denom_length = (size_t) read_u64(record + 8);
+    }
+    return true;
+}
+#endif
+
+const char* edn_tape_tag_get(edn_tape_cursor_t cursor, size_t* length) {
+    return cursor_text(cursor, TAPE_TAG, length);
+}
+
+bool edn_tape_iter_next(edn_tape_cursor_t* cursor, edn_tape_item_t* item) {
+    if (cursor == NULL || item == NULL || cursor->tape == NULL) {
+        return false;
+    }
+    const edn_tape_t* tape = cursor->tape;
+    const uint64_t* words = tape->words;
+    size_t length = tape->length;
+    size_t i = cursor->index;
+    uint64_t word;
+    for (;;) {
+        if (i >= length) {
+            cursor->index = i;
+            return false;
+        }
+        word = words[i];
+        if (word_kind(word) != TAPE_META) {
+            break;
+        }
+        i = tape_skip(words, i + TAPE_ENTRY); /* Metadata payloads are not reported */
+    }
+
+    /*
+     * Filled without branching on the kind, which mixed documents would
+     * mispredict: the value word and the text (empty for most kinds) are
+     * copied as they are, so the fields an item does not list get whatever
+     * its entry holds.
+     */
+    tape_kind_t kind = word_kind(word);
+    uint64_t value = words[i + 1];
+    const char* text = tape->buffer + word_payload(word);
+    size_t ns_length = (size_t) read_u64(text - 8);
+    uintptr_t has_ns = 0 - (uintptr_t) (ns_length > 0);
+
+    item->cursor.tape = tape;
+    item->cursor.index = i;
+    item->end = kind >= TAPE_END_LIST;
+    item->type = TAPE_TYPES[kind];
+    item->integer = (int64_t) value;
+    memcpy(&item->floating, &value, sizeof(double));
+    item->text = text;
+    item->length = (size_t) value;
+    item->ns = (const char*) (((uintptr_t) text - 9 - ns_length) & has_ns);
+    item->ns_length = ns_length;
+    cursor->index = i + TAPE_ENTRY;
+    return true;
+}
+
+/* ========================================================================
+ * Conversion to edn_value_t
+ * ======================================================================== */
+
+/* Arena copy of a side-buffer byte string (which is already NUL-terminated) */
+static const char* copy_bytes(edn_arena_t* arena, const char* s, size_t length) {
+    char* copy = edn_arena_alloc(arena, length + 1);
+    if (copy != NULL) {
+        memcpy(copy, s, length + 1);
+    }
+    return copy;
+}
+
+/* Escape letter for a byte the writer cannot emit verbatim, or 0 */
+static inline char escape_letter(char c) {
+    switch (c) {
+        case '"':
+            return '"';
+        case '\\':
+            return '\\';
+        case '\n':
+            return 'n';
+        case '\t':
+            return 't';
+        case '\r':
+            return 'r';
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Fill a string value from decoded text. Values keep their text in source
+ * form (the writer emits it verbatim), so the common escapes are put back
+ * and the decoded text is cached alongside.
+ */
+static bool set_string(edn_value_t* value, edn_arena_t* arena, const char* s, size_t length) {
+    const char* decoded = copy_bytes(arena, s, length);
+    if (decoded == NULL) {
+        return false;
+    }
+    size_t escapes = 0;
+    for (size_t k = 0; k < length; k++) {
+        escapes += escape_letter(s[k]) != 0;
+    }
+
+    const char* data = decoded;
+    if (escapes > 0) {
+        char* raw = edn_arena_alloc(arena, length + escapes);
+        if (raw == NULL) {
+            return false;
+        }
+        size_t n = 0;
+        for (size_t k = 0; k < length; k++) {
+            char letter = escape_letter(s[k]);
+            if (letter != 0) {
+                raw[n++] = '\\';
+                raw[n++] = letter;
+            } else {
+                raw[n++] = s[k];
+            }
+        }
+        data = raw;
+    }
+
+    value->as.string.data = data;
+    value->as.string.length_and_flags = 0;
+    edn_string_set_length(value, length + escapes);
+    edn_string_set_has_escapes(value, escapes > 0);
+    value->as.string.decoded = (char*) decoded;
+    return true;
+}
+
+/* Build the form starting at *pos and advance *pos past it; NULL when out of memory */
+static edn_value_t* build_value(const edn_tape_t* tape, size_t* pos, edn_arena_t* arena) {
+    size_t i = *pos;
+    uint64_t word = tape->words[i];
+    tape_kind_t kind = word_kind(word);
+    edn_tape_cursor_t cursor = {tape, i};
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    if (kind == TAPE_META) {
+        *pos = i + TAPE_ENTRY;
+        edn_value_t* meta = build_value(tape, pos, arena);
+        edn_value_t* form = meta ? build_value(tape, pos, arena) : NULL;
+        if (form == NULL || edn_metadata_attach(arena, meta, form) != NULL) {
+            return NULL;
+        }
+        return form;
+    }
+#endif
+
+    edn_value_t* value = edn_arena_alloc_value(arena);
+    if (value == NULL) {
+        return NULL;
+    }
+    value->arena = arena;
+    value->type = TAPE_TYPES[kind];
+    *pos = i + TAPE_ENTRY;
+
+    switch (kind) {
+        case TAPE_NIL:
+            break;
+
+        case TAPE_FALSE:
+        case TAPE_TRUE:
+            value->as.boolean = kind == TAPE_TRUE;
+            break;
+
+        case TAPE_INT:
+            value->as.integer = (int64_t) tape->words[i + 1];
+            break;
+
+        case TAPE_DOUBLE:
+            memcpy(&value->as.floating, &tape->words[i + 1], sizeof(double));
+            break;
+
+        case TAPE_CHARACTER:
+            value->as.character = (uint32_t) tape->words[i + 1];
+            break;
+
+        case TAPE_STRING: {
+            size_t length;
+            const char* s = edn_tape_string_get(cursor, &length);
+            if (!set_string(value, arena, s, length)) {
+                return NULL;
+            }
+            break;
+        }
+
+        case TAPE_KEYWORD:
+        case TAPE_SYMBOL: {
+            const char* ns = NULL;
+            const char* name = NULL;
+            size_t ns_length = 0, name_length = 0;
+            identifier_get(cursor, kind, &ns, &ns_length, &name, &name_length);
+            if (ns != NULL && (ns = copy_bytes(arena, ns, ns_length)) == NULL) {
+                return NULL;
+            }
+            if ((name = copy_bytes(arena, name, name_length)) == NULL) {
+                return NULL;
+            }
+            if (kind == TAPE_KEYWORD) {
+                value->as.keyword.namespace = ns;
+                value->as.keyword.ns_length = ns_length;
+                value->as.keyword.name = name;
+                value->as.keyword.name_length = name_length;
+            } else {
+                value->as.symbol.namespace = ns;
+                value->as.symbol.ns_length = ns_length;
+                value->as.symbol.name = name;
+                value->as.symbol.name_length = name_length;
+            }
+            break;
+        }
+
+        case TAPE_BIGINT:
+        case TAPE_BIGDEC: {
+            size_t length = 0;
+            bool negative = false;
+            uint8_t radix = 10;
+            const char* digits = number_get(cursor, kind, &length, &negative, &radix);
+            if ((digits = copy_bytes(arena, digits, length)) == NULL) {
+                return NULL;
+            }
+            if (kind == TAPE_BIGINT) {
+                value->as.bigint.digits = digits;
+                value->as.bigint.length = length;
+                value->as.bigint.negative = negative;
+                value->as.bigint.radix = radix;
+                value->as.bigint.cleaned = NULL;
+            } else {
+                value->as.bigdec.decimal = digits;
+                value->as.bigdec.length = length;
+                value->as.bigdec.negative = negative;
+                value->as.bigdec.cleaned = NULL;
+            }
+            break;
+        }
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+        case TAPE_RATIO:
+            edn_tape_ratio_get(cursor, &value->as.ratio.numerator, &value->as.ratio.denominator);
+            break;
+
+        case TAPE_BIGRATIO: {
+            const char* numerator = NULL;
+            const char* denominator = NULL;
+            size_t numer_length = 0, denom_length = 0;
+            bool negative = false;
+            edn_tape_bigratio_get(cursor, &numerator, &numer_length, &negative, &denominator,
+                                  &denom_length);
+            numerator = copy_bytes(arena, numerator, numer_length);
+            denominator = copy_bytes(arena, denominator, denom_length);
+            if (numerator == NULL || denominator == NULL) {
+                return NULL;
+            }
+            value->as.bigratio.numerator = numerator;
+            value->as.bigratio.numer_length = numer_length;
+            value->as.bigratio.numer_negative = negative;
+            value->as.bigratio.denominator = denominator;
+            value->as.bigratio.denom_length = denom_length;
+            break;
+        }
+#endif
+
+        case TAPE_TAG: {
+            size_t length;
+            const char* tag = edn_tape_tag_get(cursor, &length);
+            if ((tag = copy_bytes(arena, tag, length)) == NULL) {
+                return NULL;
+            }
+            value->as.tagged.tag = tag;
+            value->as.tagged.tag_length = length;
+            value->as.tagged.lazy = NULL;
+            value->as.tagged.value = build_value(tape, pos, arena);
+            if (value->as.tagged.value == NULL) {
+                return NULL;
+            }
+            break;
+        }
+
+        case TAPE_MAP: {
+            size_t count = edn_tape_count(cursor);
+            edn_map_entry_t* entries =
+                count ? edn_arena_alloc(arena, count * sizeof(edn_map_entry_t)) : NULL;
+            if (count > 0 && entries == NULL) {
+                return NULL;
+            }
+            for (size_t k = 0; k < count; k++) {
+                edn_value_t* key = build_value(tape, pos, arena);
+                edn_value_t* val = key ? build_value(tape, pos, arena) : NULL;
+                if (val == NULL) {
+                    return NULL;
+                }
+                edn_map_entry_init(&entries[k], key, val);
+            }
+            value->as.map.entries = entries;
+            value->as.map.count = count;
+            *pos = (size_t) tape->words[i + 1];
+            break;
+        }
+
+        case TAPE_LIST:
+        case TAPE_VECTOR:
+        case TAPE_SET: {
+            size_t count = edn_tape_count(cursor);
+            edn_value_t** elements =
+                count ? edn_arena_alloc(arena, count * sizeof(edn_value_t*)) : NULL;
+            if (count > 0 && elements == NULL) {
+                return NULL;
+            }
+            for (size_t k = 0; k < count; k++) {
+                if ((elements[k] = build_value(tape, pos, arena)) == NULL) {
+                    return NULL;
+                }
+            }
+            if (kind == TAPE_LIST) {
+                value->as.list.elements = elements;
+                value->as.list.count = count;
+            } else if (kind == TAPE_VECTOR) {
+                value->as.vector.elements = elements;
+                value->as.vector.count = count;
+            } else {
+                value->as.set.elements = elements;
+                value->as.set.count = count;
+            }
+            *pos = (size_t) tape->words[i + 1];
+            break;
+        }
+
+        default:
+            return NULL;
+    }
+    return value;
+}
+
+edn_value_t* edn_tape_to_value(edn_tape_cursor_t cursor) {
+    if (cursor_at_end(cursor)) {
+        return NULL;
+    }
+    edn_arena_t* arena = edn_arena_create();
+    if (arena == NULL) {
+        return NULL;
+    }
+    size_t pos = cursor.index;
+    edn_value_t* value = build_value(cursor.tape, &pos, arena);
+    if (value == NULL) {
+        edn_arena_destroy(arena);
+    }
+    return value;
+}
+
+/* ========================================================================
+ * Duplicate detection
+ * ======================================================================== */
+
+#define TAPE_HASH_PRIME 0x9E3779B97F4A7C15ULL
+#define TAPE_LINEAR_DUPS 16 /* Pairwise hash comparison up to this many forms */
+
+static inline uint64_t hash_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint64_t hash_bytes(uint64_t h, const char* s, size_t length) {
+    h = (h ^ length) * TAPE_HASH_PRIME;
+    size_t k = 0;
+    for (; k + 8 <= length; k += 8) {
+        h = (h ^ read_u64(s + k)) * TAPE_HASH_PRIME;
+        h ^= h >> 29;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, s + k, length - k);
+    h = (h ^ tail) * TAPE_HASH_PRIME;
+    return h ^ (h >> 32);
+}
+
+/**
+ * Hash of the form at *pos, advancing *pos past it. Forms that build equal
+ * values (edn_value_equal) hash alike: lists and vectors share a seed,
+ * sets and maps ignore order, metadata is skipped and NaNs and zeros are
+ * folded. Big numbers only hash their kind; a collision is settled by
+ * comparing the built values.
+ */
+static uint64_t form_hash(const edn_tape_t* tape, size_t* pos) {
+    const uint64_t* words = tape->words;
+    size_t i = *pos;
+    uint64_t word = words[i];
+    tape_kind_t kind = word_kind(word);
+    *pos = i + TAPE_ENTRY;
+
+    switch (kind) {
+        case TAPE_INT:
+            return hash_mix(word ^ (words[i + 1] * TAPE_HASH_PRIME));
+        case TAPE_DOUBLE: {
+            double d;
+            memcpy(&d, &words[i + 1], sizeof(d));
+            uint64_t bits = d != d ? 0x7FF8000000000000ULL : d == 0.0 ? 0 : words[i + 1];
+            return hash_mix(word ^ (bits * TAPE_HASH_PRIME));
+        }
+        case TAPE_RATIO: {
+            const char* record = tape->buffer + word_payload(word);
+            return hash_mix(kind ^ (read_u64(record) * TAPE_HASH_PRIME) ^
+                            hash_mix(read_u64(record + 8)));
+        }
+        case TAPE_STRING:
+            return hash_bytes(kind, tape->buffer + word_payload(word), (size_t) words[i + 1]);
+        case TAPE_KEYWORD:
+        case TAPE_SYMBOL: {
+            const char* ns;
+            const char* name;
+            size_t ns_length, name_length;
+            identifier_fields(tape, &words[i], &ns, &ns_length, &name, &name_length);
+            uint64_t h = ns_length > 0 ? hash_bytes(kind, ns, ns_length) : kind;
+            return hash_bytes(h, name, name_length);
+        }
+        case TAPE_BIGINT:
+        case TAPE_BIGDEC:
+        case TAPE_BIGRATIO:
+            return hash_mix(kind);
+        case TAPE_TAG: {
+            uint64_t h = hash_bytes(kind, tape->buffer + word_payload(word), (size_t) words[i + 1]);
+            return hash_mix(h ^ form_hash(tape, pos));
+        }
+        case TAPE_META:
+            form_hash(tape, pos);
+            return form_hash(tape, pos);
+        case TAPE_LIST:
+        case TAPE_VECTOR:
+        case TAPE_SET:
+        case TAPE_MAP: {
+            size_t end = (size_t) words[i + 1] - TAPE_ENTRY;
+            uint64_t h = 0;
+            while (*pos < end) {
+                uint64_t child = form_hash(tape, pos);
+                if (kind == TAPE_MAP) {
+                    child = hash_mix(child ^ (form_hash(tape, pos) * TAPE_HASH_PRIME));
+                }
+                h = kind == TAPE_SET || kind == TAPE_MAP ? h + hash_mix(child)
+                                                         : hash_mix(h ^ child) * TAPE_HASH_PRIME;
+            }
+            *pos = end + TAPE_ENTRY;
+            tape_kind_t seed = kind == TAPE_VECTOR ? TAPE_LIST : kind;
+            return hash_mix(((uint64_t) seed << TAPE_KIND_SHIFT) ^ h);
+        }
+        default:
+            return hash_mix(word ^ (words[i + 1] * TAPE_HASH_PRIME)); /* nil, booleans, characters */
+    }
+}
+
+static int compare_form_hashes(const void* a, const void* b) {
+    uint64_t x = ((const tape_form_hash_t*) a)->hash;
+    uint64_t y = ((const tape_form_hash_t*) b)->hash;
+    return (x > y) - (x < y);
+}
+
+/* Whether the forms at word indexes i and j build equal values */
+static bool forms_equal(const edn_tape_t* tape, size_t i, size_t j, bool* failed) {
+    edn_arena_t* arena = edn_arena_create();
+    edn_value_t* a = arena ? build_value(tape, &i, arena) : NULL;
+    edn_value_t* b = a ? build_value(tape, &j, arena) : NULL;
+    bool equal = b != NULL && edn_value_equal(a, b);
+    *failed = b == NULL;
+    edn_arena_destroy(arena);
+    return equal;
+}
+
+/**
+ * Check the set or map whose begin word is at `begin` (already closed) for
+ * equal elements or keys, as edn_read does. Sets b->error when one is
+ * found; returns true with b->error unset when memory runs out.
+ */
+static bool has_duplicate_forms(tape_builder_t* b, size_t begin) {
+    const edn_tape_t* tape = b->tape;
+    uint64_t word = tape->words[begin];
+    bool map = word_kind(word) == TAPE_MAP;
+    size_t count = (size_t) tape->words[tape->words[begin + 1] - 1] / (map ? 2 : 1);
+    if (count < 2) {
+        return false;
+    }
+
+    if (count > b->hash_capacity) {
+        size_t capacity = b->hash_capacity ? b->hash_capacity : TAPE_INITIAL_FRAMES;
+        while (capacity < count) {
+            capacity *= 2;
+        }
+        tape_form_hash_t* grown = realloc(b->hashes, capacity * sizeof(tape_form_hash_t));
+        if (grown == NULL) {
+            return true;
+        }
+        b->hashes = grown;
+        b->hash_capacity = capacity;
+    }
+    tape_form_hash_t* hashes = b->hashes;
+    size_t pos = begin + TAPE_ENTRY;
+    for (size_t k = 0; k < count; k++) {
+        hashes[k].index = pos;
+        hashes[k].hash = form_hash(tape, &pos);
+        if (map) {
+            pos = tape_skip(tape->words, pos);
+        }
+    }
+
+    /* Equal hashes are confirmed on built values, so collisions are harmless */
+    bool failed = false;
+    bool found = false;
+    if (count <= TAPE_LINEAR_DUPS) {
+        for (size_t x = 1; x < count && !found && !failed; x++) {
+            for (size_t y = 0; y < x && !found && !failed; y++) {
+                found = hashes[x].hash == hashes[y].hash &&
+                        forms_equal(tape, hashes[x].index, hashes[y].index, &failed);
+            }
+        }
+    } else {
+        qsort(hashes, count, sizeof(tape_form_hash_t), compare_form_hashes);
+        for (size_t x = 1; x < count && !found && !failed; x++) {
+            for (size_t y = x; y-- > 0 && hashes[y].hash == hashes[x].hash && !found && !failed;) {
+                found = forms_equal(tape, hashes[x].index, hashes[y].index, &failed);
+            }
+        }
+    }
+    if (found) {
+        b->error = map ? EDN_ERROR_DUPLICATE_KEY : EDN_ERROR_DUPLICATE_ELEMENT;
+        b->error_message = map ? "Map contains duplicate keys" : "Set contains duplicate elements";
+    }
+    return found || failed;
+}
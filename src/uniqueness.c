@@ -113,6 +113,15 @@ cleanup:
     return has_dups;
 }
 
+#ifdef EDN_ENABLE_INSTRUMENTATION
+edn_duplicate_tier_t edn_duplicates_tier(size_t count) {
+    if (count <= LINEAR_THRESHOLD) {
+        return EDN_DUPLICATE_TIER_LINEAR;
+    }
+    return count <= SORTED_THRESHOLD ? EDN_DUPLICATE_TIER_SORTED : EDN_DUPLICATE_TIER_HASH;
+}
+#endif
+
 bool edn_has_duplicates(edn_value_t** elements, size_t count) {
     if (count <= 1) {
         return false;
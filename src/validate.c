@@ -0,0 +1,927 @@
+/**
+ * EDN.C - Validation-only parser
+ *
+ * Walks the input with the grammar and error messages of the tree parser
+ * but creates no values. Strings, identifiers and plain decimal numbers -
+ * the bulk of typical documents - are checked in place; other scalars are
+ * read by the tree scanners into a scratch arena that is reset straight
+ * away. Optional duplicate detection keeps only a 64-bit hash per map key
+ * or set element, on a stack that lives in a small reusable buffer.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "edn_internal.h"
+
+/* parse_form() results besides an edn_type_t */
+#define VALIDATE_CLOSE (-1) /* Closing delimiter reached; parser->current is on it */
+#define VALIDATE_ERROR (-2) /* parser->error is set */
+
+#define VALIDATE_INLINE_HASHES 128 /* Hash stack slots before using caller scratch or heap */
+#define VALIDATE_LINEAR_DUPS 16    /* Pairwise duplicate check up to this many hashes */
+
+/* Per-kind hash seeds; lists and vectors share one because they compare equal */
+#define HASH_PRIME 0x9E3779B97F4A7C15ULL
+#define HASH_NIL 0x6E696CULL
+#define HASH_BOOL 0x626F6F6CULL
+#define HASH_INT 0x696E74ULL
+#define HASH_FLOAT 0x666C74ULL
+#define HASH_STRING 0x737472ULL
+#define HASH_KEYWORD 0x6B6579ULL
+#define HASH_SYMBOL 0x73796DULL
+#define HASH_SEQUENCE 0x736571ULL
+#define HASH_SET 0x736574ULL
+#define HASH_MAP 0x6D6170ULL
+#define HASH_TAGGED 0x746167ULL
+#define HASH_OTHER 0x6F7468ULL
+
+typedef struct {
+    edn_parser_t parser; /* parser.arena is created on the first scanner fallback */
+    bool check_duplicates;
+    bool hashing;      /* The form being parsed is, or is inside, a map key or set element */
+    uint64_t hash;     /* Hash of the form parse_form() last returned (hashing only) */
+    uint64_t* hashes;  /* Key/element hashes of the open maps and sets */
+    size_t hash_count;
+    size_t hash_capacity;
+    bool hashes_on_heap;
+    size_t muted;       /* Number of enclosing #_ forms (not counted while > 0) */
+    const char* key_ns; /* Namespace for the next map key (namespaced maps only) */
+    size_t key_ns_length;
+    size_t collection_depth;
+    edn_validate_stats_t stats;
+} validate_state_t;
+
+typedef struct {
+    char close;
+    const char* unterminated;
+    const char* mismatched;
+} collection_syntax_t;
+
+static const collection_syntax_t LIST_SYNTAX = {')', "Unterminated list (missing ')')",
+                                                "Mismatched closing delimiter in list"};
+static const collection_syntax_t VECTOR_SYNTAX = {']', "Unterminated vector (missing ']')",
+                                                  "Mismatched closing delimiter in vector"};
+static const collection_syntax_t SET_SYNTAX = {'}', "Unterminated set (missing '}')",
+                                               "Mismatched closing delimiter in set"};
+static const collection_syntax_t MAP_SYNTAX = {'}', "Unterminated map (missing '}')",
+                                               "Mismatched closing delimiter in map"};
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+static const collection_syntax_t NS_MAP_SYNTAX = {
+    '}', "Unterminated namespaced map (missing '}')",
+    "Mismatched closing delimiter in namespaced map"};
+#endif
+
+static inline uint64_t hash_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static uint64_t hash_bytes(uint64_t h, const char* data, size_t length) {
+    h = (h ^ length) * HASH_PRIME;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        h = (h ^ word) * HASH_PRIME;
+        h ^= h >> 29;
+        data += 8;
+        length -= 8;
+    }
+    if (length > 0) {
+        uint64_t word = 0;
+        memcpy(&word, data, length);
+        h = (h ^ word) * HASH_PRIME;
+    }
+    return hash_mix(h);
+}
+
+static inline uint64_t hash_int(int64_t value) {
+    return hash_mix(HASH_INT ^ ((uint64_t) value * HASH_PRIME));
+}
+
+/* Equal doubles hash alike: NaNs and both zeros are folded as in edn_value_equal */
+static inline uint64_t hash_float(double value) {
+    uint64_t bits;
+    if (isnan(value)) {
+        bits = 0x7FF8000000000000ULL;
+    } else if (value == 0.0) {
+        bits = 0;
+    } else {
+        memcpy(&bits, &value, sizeof(bits));
+    }
+    return hash_mix(HASH_FLOAT ^ (bits * HASH_PRIME));
+}
+
+static int compare_hashes(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+/* Sorts the range in place; the caller pops it afterwards */
+static bool has_duplicate_hash(uint64_t* hashes, size_t count) {
+    if (count <= VALIDATE_LINEAR_DUPS) {
+        for (size_t i = 1; i < count; i++) {
+            for (size_t j = 0; j < i; j++) {
+                if (hashes[i] == hashes[j]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    qsort(hashes, count, sizeof(uint64_t), compare_hashes);
+    for (size_t i = 1; i < count; i++) {
+        if (hashes[i] == hashes[i - 1]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool push_hash(validate_state_t* st, uint64_t hash, const char* start) {
+    if (st->hash_count == st->hash_capacity) {
+        size_t capacity = st->hash_capacity * 2;
+        uint64_t* grown;
+        if (st->hashes_on_heap) {
+            grown = realloc(st->hashes, capacity * sizeof(uint64_t));
+        } else {
+            grown = malloc(capacity * sizeof(uint64_t));
+            if (grown != NULL) {
+                memcpy(grown, st->hashes, st->hash_count * sizeof(uint64_t));
+            }
+        }
+        if (grown == NULL) {
+            edn_parser_set_error(&st->parser, EDN_ERROR_OUT_OF_MEMORY,
+                                 "Out of memory checking duplicates", start, st->parser.current);
+            return false;
+        }
+        st->hashes = grown;
+        st->hash_capacity = capacity;
+        st->hashes_on_heap = true;
+    }
+    st->hashes[st->hash_count++] = hash;
+    return true;
+}
+
+static inline int form_done(validate_state_t* st, int kind) {
+    if (st->muted == 0) {
+        st->stats.forms++;
+    }
+    return kind;
+}
+
+static int parse_form(validate_state_t* st);
+
+/* Single separators between tokens are skipped inline; comments and other
+ * whitespace go to the SIMD skipper */
+static inline bool skip_whitespace(edn_parser_t* parser) {
+    const char* ptr = parser->current;
+    while (ptr < parser->end && (*ptr == ' ' || *ptr == ',' || *ptr == '\n')) {
+        ptr++;
+    }
+    if (ptr < parser->end && ((unsigned char) *ptr < ' ' || *ptr == ';')) {
+        ptr = edn_simd_skip_whitespace(ptr, parser->end);
+    }
+    parser->current = ptr;
+    return ptr < parser->end;
+}
+
+/* Read a scalar with one of the tree scanners, then recycle the scratch arena */
+static int scanner_fallback(validate_state_t* st, edn_value_t* (*scan)(edn_parser_t*)) {
+    edn_parser_t* parser = &st->parser;
+
+    if (parser->arena == NULL) {
+        parser->arena = edn_arena_create();
+        if (parser->arena == NULL) {
+            edn_parser_set_error(parser, EDN_ERROR_OUT_OF_MEMORY,
+                                 "Out of memory allocating scratch arena", parser->current,
+                                 parser->current);
+            return VALIDATE_ERROR;
+        }
+    }
+
+    edn_value_t* value = scan(parser);
+    if (value == NULL) {
+        return VALIDATE_ERROR; /* Error already set */
+    }
+
+    int kind = (int) value->type;
+    if (st->hashing) {
+        if (kind == EDN_TYPE_INT) {
+            st->hash = hash_int(value->as.integer);
+        } else if (kind == EDN_TYPE_FLOAT) {
+            st->hash = hash_float(value->as.floating);
+        } else if (kind == EDN_TYPE_STRING) {
+            st->hash = hash_bytes(HASH_STRING, value->as.string.data, edn_string_get_length(value));
+        } else {
+            st->hash = hash_mix(HASH_OTHER ^ edn_value_hash(value));
+        }
+    }
+
+    edn_arena_reset(parser->arena);
+    return form_done(st, kind);
+}
+
+static int parse_string(validate_state_t* st, const char* start) {
+    edn_parser_t* parser = &st->parser;
+
+#ifdef EDN_ENABLE_EXPERIMENTAL_EXTENSION
+    if (start + 3 < parser->end && start[1] == '"' && start[2] == '"' && start[3] == '\n') {
+        return scanner_fallback(st, edn_read_string);
+    }
+#endif
+
+    /* Escapes are decoded lazily by the tree parser too, so only the end is checked */
+    bool has_escapes = false;
+    bool non_ascii = false;
+    const char* closing_quote =
+        parser->strict_utf8
+            ? edn_simd_find_quote_utf8(start + 1, parser->end, &has_escapes, &non_ascii)
+            : edn_simd_find_quote(start + 1, parser->end, &has_escapes);
+    if (closing_quote == NULL) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_STRING, "Unterminated string", start,
+                             parser->end);
+        return VALIDATE_ERROR;
+    }
+    if (non_ascii && !edn_check_utf8(parser, start + 1, closing_quote, EDN_ERROR_INVALID_STRING,
+                                     "Invalid UTF-8 in string")) {
+        return VALIDATE_ERROR;
+    }
+
+    if (st->hashing) {
+        st->hash = hash_bytes(HASH_STRING, start + 1, (size_t) (closing_quote - start - 1));
+    }
+    parser->current = closing_quote + 1;
+    return form_done(st, EDN_TYPE_STRING);
+}
+
+/* Characters that may end a number, as accepted by edn_read_number() */
+static inline bool ends_number(unsigned char c) {
+    switch (c) {
+        case ' ':
+        case ',':
+        case ';':
+        case ')':
+        case ']':
+        case '}':
+        case '"':
+        case '#':
+        case '(':
+        case '[':
+        case '{':
+            return true;
+        default:
+            return (c >= 0x09 && c <= 0x0D) || (c >= 0x1C && c <= 0x1F);
+    }
+}
+
+static inline bool is_digit(char c) {
+    return (unsigned) (c - '0') < 10;
+}
+
+/*
+ * Decimal integers that fit in int64 and plain decimal floats are
+ * recognized in place; anything else (radix, suffixes, leading zeros, long
+ * digit runs) goes to edn_read_number(). When the form is hashed, a
+ * float's value is computed here only where edn_read_number() would take
+ * its Clinger fast path, so both produce the same double.
+ */
+static int parse_number(validate_state_t* st, const char* start) {
+    edn_parser_t* parser = &st->parser;
+    const char* end = parser->end;
+    const char* ptr = start + (*start == '-');
+    const char* digits = ptr;
+    const char* limit = (end - ptr > 18) ? ptr + 18 : end;
+    uint64_t magnitude = 0;
+
+    while (ptr < limit && is_digit(*ptr)) {
+        magnitude = magnitude * 10 + (uint64_t) (*ptr - '0');
+        ptr++;
+    }
+    if (ptr == digits || (*digits == '0' && ptr != digits + 1)) {
+        return scanner_fallback(st, edn_read_number);
+    }
+
+    int kind = EDN_TYPE_INT;
+    size_t significant = (size_t) (ptr - digits);
+    int exponent = 0;
+    if (ptr < end && (*ptr == '.' || *ptr == 'e' || *ptr == 'E')) {
+        kind = EDN_TYPE_FLOAT;
+        if (*ptr == '.') {
+            const char* fraction = ++ptr;
+            while (ptr < end && is_digit(*ptr)) {
+                if (significant < 19) {
+                    magnitude = magnitude * 10 + (uint64_t) (*ptr - '0');
+                }
+                significant++;
+                ptr++;
+            }
+            if (ptr == fraction) {
+                return scanner_fallback(st, edn_read_number);
+            }
+            exponent = -(int) (ptr - fraction);
+        }
+        if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+            ptr++;
+            bool negative_exponent = false;
+            if (ptr < end && (*ptr == '+' || *ptr == '-')) {
+                negative_exponent = *ptr == '-';
+                ptr++;
+            }
+            const char* exponent_digits = ptr;
+            int written = 0;
+            while (ptr < end && is_digit(*ptr)) {
+                if (written < 10000) {
+                    written = written * 10 + (*ptr - '0');
+                }
+                ptr++;
+            }
+            if (ptr == exponent_digits) {
+                return scanner_fallback(st, edn_read_number);
+            }
+            exponent += negative_exponent ? -written : written;
+        }
+    }
+
+    if (ptr < end && !ends_number((unsigned char) *ptr)) {
+        return scanner_fallback(st, edn_read_number);
+    }
+
+    if (st->hashing) {
+        if (kind == EDN_TYPE_INT) {
+            st->hash = hash_int(digits == start ? (int64_t) magnitude : -(int64_t) magnitude);
+        } else {
+            double value;
+            if (significant > 15 ||
+                !edn_parse_double_fast((int64_t) magnitude, exponent, digits != start, &value)) {
+                return scanner_fallback(st, edn_read_number);
+            }
+            st->hash = hash_float(value);
+        }
+    }
+    parser->current = ptr;
+    return form_done(st, kind);
+}
+
+/* Bytes an identifier may contain without further rules: not a delimiter, ':' or '/' */
+static inline bool is_plain_identifier_byte(unsigned char c) {
+    return !is_delimiter(c) && c != ':' && c != '/';
+}
+
+/*
+ * Keywords and symbols made of plain bytes with at most one inner '/' are
+ * classified in place; everything else goes through the tree parser's
+ * identifier rules via edn_scan_identifier_token().
+ */
+static bool scan_identifier(edn_parser_t* parser, edn_identifier_token_t* token) {
+    const char* start = parser->current;
+    const char* end = parser->end;
+    const char* ptr = start + (*start == ':');
+    const char* name = ptr;
+
+    while (ptr < end && is_plain_identifier_byte((unsigned char) *ptr)) {
+        ptr++;
+    }
+    token->namespace = NULL;
+    token->ns_length = 0;
+    if (ptr < end && *ptr == '/' && ptr > name) {
+        token->namespace = name;
+        token->ns_length = (size_t) (ptr - name);
+        name = ++ptr;
+        while (ptr < end && is_plain_identifier_byte((unsigned char) *ptr)) {
+            ptr++;
+        }
+    }
+    if (ptr == name || (ptr < end && !is_delimiter((unsigned char) *ptr))) {
+        return edn_scan_identifier_token(parser, token);
+    }
+
+    if (parser->strict_utf8 &&
+        !edn_check_utf8(parser, start, ptr, EDN_ERROR_INVALID_SYNTAX,
+                        "Invalid UTF-8 in identifier")) {
+        return false;
+    }
+
+    token->name = name;
+    token->name_length = (size_t) (ptr - name);
+    token->boolean = false;
+    token->type = (*start == ':') ? EDN_TYPE_KEYWORD : EDN_TYPE_SYMBOL;
+    if (token->type == EDN_TYPE_SYMBOL && token->namespace == NULL) {
+        if (token->name_length == 3 && memcmp(name, "nil", 3) == 0) {
+            token->type = EDN_TYPE_NIL;
+        } else if (token->name_length == 4 && memcmp(name, "true", 4) == 0) {
+            token->type = EDN_TYPE_BOOL;
+            token->boolean = true;
+        } else if (token->name_length == 5 && memcmp(name, "false", 5) == 0) {
+            token->type = EDN_TYPE_BOOL;
+        }
+    }
+    parser->current = ptr;
+    return true;
+}
+
+static int parse_identifier(validate_state_t* st, const char* key_ns, size_t key_ns_length) {
+    edn_identifier_token_t token;
+    if (!scan_identifier(&st->parser, &token)) {
+        return VALIDATE_ERROR;
+    }
+
+    if (st->hashing) {
+        if (token.type == EDN_TYPE_NIL) {
+            st->hash = hash_mix(HASH_NIL);
+        } else if (token.type == EDN_TYPE_BOOL) {
+            st->hash = hash_mix(HASH_BOOL + token.boolean);
+        } else {
+            /* Namespaced map keys: bare names take the map's namespace, :_/x opts out */
+            const char* ns = token.namespace;
+            size_t ns_length = token.ns_length;
+            if (key_ns != NULL) {
+                if (ns == NULL) {
+                    ns = key_ns;
+                    ns_length = key_ns_length;
+                } else if (ns_length == 1 && ns[0] == '_') {
+                    ns = NULL;
+                    ns_length = 0;
+                }
+            }
+
+            uint64_t seed = token.type == EDN_TYPE_KEYWORD ? HASH_KEYWORD : HASH_SYMBOL;
+            if (ns != NULL) {
+                seed = hash_bytes(seed, ns, ns_length);
+            }
+            st->hash = hash_bytes(seed, token.name, token.name_length);
+        }
+    }
+
+    return form_done(st, (int) token.type);
+}
+
+/* List, vector, set or map; parser->current is on the opening delimiter */
+static int parse_collection(validate_state_t* st, const char* start, edn_type_t kind,
+                            const collection_syntax_t* syntax, const char* ns, size_t ns_length) {
+    edn_parser_t* parser = &st->parser;
+
+    parser->current += (*parser->current == '#') ? 2 : 1;
+    if (!edn_enter_depth(parser)) {
+        return VALIDATE_ERROR;
+    }
+    if (++st->collection_depth > st->stats.max_depth) {
+        st->stats.max_depth = st->collection_depth;
+    }
+
+    bool hashed = st->hashing;
+    size_t hash_base = st->hash_count;
+    uint64_t combined = 0;
+    uint64_t key_hash = 0;
+    size_t count = 0;
+
+    for (;;) {
+        if (kind == EDN_TYPE_MAP && (count & 1) == 0) {
+            st->key_ns = ns;
+            st->key_ns_length = ns_length;
+        }
+        if (st->check_duplicates) {
+            st->hashing =
+                hashed || kind == EDN_TYPE_SET || (kind == EDN_TYPE_MAP && (count & 1) == 0);
+        }
+
+        int r = parse_form(st);
+        if (r == VALIDATE_CLOSE) {
+            break;
+        }
+        if (r == VALIDATE_ERROR) {
+            if (parser->error == EDN_ERROR_UNEXPECTED_EOF) {
+                edn_parser_set_error(parser, EDN_ERROR_UNTERMINATED_COLLECTION,
+                                     syntax->unterminated, start, parser->current);
+            }
+            return VALIDATE_ERROR;
+        }
+
+        if (st->hashing) {
+            if (kind == EDN_TYPE_LIST || kind == EDN_TYPE_VECTOR) {
+                combined = hash_mix(combined ^ st->hash) * HASH_PRIME;
+            } else if (kind == EDN_TYPE_SET) {
+                if (!push_hash(st, st->hash, start)) {
+                    return VALIDATE_ERROR;
+                }
+                combined += hash_mix(st->hash);
+            } else if ((count & 1) == 0) {
+                if (!push_hash(st, st->hash, start)) {
+                    return VALIDATE_ERROR;
+                }
+                key_hash = st->hash;
+            } else {
+                combined += hash_mix(key_hash ^ (st->hash * HASH_PRIME));
+            }
+        }
+        count++;
+    }
+
+    if (kind == EDN_TYPE_MAP && (count & 1) != 0) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Map has odd number of elements (key without value)", start,
+                             parser->current);
+        return VALIDATE_ERROR;
+    }
+
+    if (*parser->current != syntax->close) {
+        edn_parser_set_error(parser, EDN_ERROR_UNMATCHED_DELIMITER, syntax->mismatched, start,
+                             parser->current + 1);
+        return VALIDATE_ERROR;
+    }
+
+    parser->current++;
+    edn_leave_depth(parser);
+    st->collection_depth--;
+
+    if (st->check_duplicates) {
+        size_t pushed = st->hash_count - hash_base;
+        if (pushed > 1 && has_duplicate_hash(st->hashes + hash_base, pushed)) {
+            if (kind == EDN_TYPE_SET) {
+                edn_parser_set_error(parser, EDN_ERROR_DUPLICATE_ELEMENT,
+                                     "Set contains duplicate elements", start, parser->current);
+            } else {
+                edn_parser_set_error(parser, EDN_ERROR_DUPLICATE_KEY,
+                                     ns != NULL ? "Namespaced map contains duplicate keys"
+                                                : "Map contains duplicate keys",
+                                     start, parser->current);
+            }
+            return VALIDATE_ERROR;
+        }
+        st->hash_count = hash_base;
+    }
+
+    st->hashing = hashed;
+    if (hashed) {
+        uint64_t seed = kind == EDN_TYPE_SET   ? HASH_SET
+                        : kind == EDN_TYPE_MAP ? HASH_MAP
+                                               : HASH_SEQUENCE;
+        st->hash = hash_mix(seed ^ (combined + count));
+    }
+
+    if (st->muted == 0) {
+        st->stats.collections++;
+    }
+    return form_done(st, (int) kind);
+}
+
+/* #_ form: validate the discarded form uncounted, then parse the next one */
+static int parse_discard(validate_state_t* st, const char* start, const char* key_ns,
+                         size_t key_ns_length) {
+    edn_parser_t* parser = &st->parser;
+
+    if (!edn_enter_depth(parser)) {
+        return VALIDATE_ERROR;
+    }
+    parser->current += 2;
+
+    bool hashing = st->hashing;
+    st->hashing = false;
+    st->muted++;
+    int r = parse_form(st);
+    st->muted--;
+    st->hashing = hashing;
+
+    if (r == VALIDATE_CLOSE) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_DISCARD, "Discard macro missing value",
+                             start, start + 2);
+        return VALIDATE_ERROR;
+    }
+    if (r == VALIDATE_ERROR) {
+        return VALIDATE_ERROR;
+    }
+
+    /* The form after the discard takes its place, including map-key position */
+    st->key_ns = key_ns;
+    st->key_ns_length = key_ns_length;
+    r = parse_form(st);
+    edn_leave_depth(parser);
+    return r;
+}
+
+static int parse_tagged(validate_state_t* st, const char* start) {
+    edn_parser_t* parser = &st->parser;
+
+    parser->current++;
+    if (!edn_enter_depth(parser)) {
+        return VALIDATE_ERROR;
+    }
+
+    if (parser->current >= parser->end) {
+        edn_parser_set_error(parser, EDN_ERROR_UNEXPECTED_EOF,
+                             "Unexpected end of input after '#' (expected tag)", start,
+                             parser->current);
+        return VALIDATE_ERROR;
+    }
+
+    char next = *parser->current;
+    if (next == ' ' || next == '\t' || next == '\n' || next == '\r' || next == ',') {
+        edn_parser_set_error(
+            parser, EDN_ERROR_INVALID_SYNTAX,
+            "Tagged literal tag must immediately follow '#' (no whitespace allowed)", start,
+            parser->current);
+        return VALIDATE_ERROR;
+    }
+
+    const char* tag_start = parser->current;
+    edn_identifier_token_t tag;
+    if (!edn_scan_identifier_token(parser, &tag)) {
+        return VALIDATE_ERROR;
+    }
+    if (tag.type != EDN_TYPE_SYMBOL) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX, "Tagged literal must be a symbol",
+                             start, parser->current);
+        return VALIDATE_ERROR;
+    }
+    bool hashed = st->hashing;
+    uint64_t tag_hash = 0;
+    if (hashed) {
+        tag_hash = hash_bytes(HASH_TAGGED, tag_start, (size_t) (parser->current - tag_start));
+    }
+
+    int r = parse_form(st);
+    if (r == VALIDATE_CLOSE) {
+        edn_parser_set_error(parser, EDN_ERROR_UNEXPECTED_EOF, "Tagged literal missing value",
+                             start, parser->current);
+        return VALIDATE_ERROR;
+    }
+    if (r == VALIDATE_ERROR) {
+        return VALIDATE_ERROR;
+    }
+
+    edn_leave_depth(parser);
+    if (hashed) {
+        st->hash = hash_mix(tag_hash ^ (st->hash * HASH_PRIME));
+    }
+    return form_done(st, EDN_TYPE_TAGGED);
+}
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+/* Metadata does not take part in equality, so the form keeps its own hash */
+static int parse_metadata(validate_state_t* st, const char* start, const char* key_ns,
+                          size_t key_ns_length) {
+    edn_parser_t* parser = &st->parser;
+
+    parser->current++;
+    if (!edn_enter_depth(parser)) {
+        return VALIDATE_ERROR;
+    }
+
+    bool hashing = st->hashing;
+    st->hashing = false;
+    int meta = parse_form(st);
+    st->hashing = hashing;
+    if (meta == VALIDATE_ERROR) {
+        return VALIDATE_ERROR;
+    }
+    if (meta != VALIDATE_CLOSE && meta != EDN_TYPE_MAP && meta != EDN_TYPE_KEYWORD &&
+        meta != EDN_TYPE_STRING && meta != EDN_TYPE_SYMBOL && meta != EDN_TYPE_VECTOR) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Metadata must be a map, keyword, string, symbol, or vector", start,
+                             parser->current);
+        return VALIDATE_ERROR;
+    }
+
+    st->key_ns = key_ns;
+    st->key_ns_length = key_ns_length;
+    int form = meta == VALIDATE_CLOSE ? VALIDATE_CLOSE : parse_form(st);
+    if (form == VALIDATE_ERROR) {
+        return VALIDATE_ERROR;
+    }
+    if (form == VALIDATE_CLOSE) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Metadata must be followed by a form", start, parser->current);
+        return VALIDATE_ERROR;
+    }
+    if (form != EDN_TYPE_LIST && form != EDN_TYPE_VECTOR && form != EDN_TYPE_MAP &&
+        form != EDN_TYPE_SET && form != EDN_TYPE_TAGGED && form != EDN_TYPE_SYMBOL) {
+        edn_parser_set_error(
+            parser, EDN_ERROR_INVALID_SYNTAX,
+            "Metadata can only be attached to collections, tagged literals, and symbols", start,
+            parser->current);
+        return VALIDATE_ERROR;
+    }
+
+    edn_leave_depth(parser);
+    return form;
+}
+
+/* #:ns{...} */
+static int parse_namespaced_map(validate_state_t* st, const char* start) {
+    edn_parser_t* parser = &st->parser;
+
+    parser->current++;
+
+    edn_identifier_token_t ns_keyword;
+    if (!edn_scan_identifier_token(parser, &ns_keyword)) {
+        return VALIDATE_ERROR;
+    }
+    if (ns_keyword.type != EDN_TYPE_KEYWORD) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Namespaced map must start with a keyword", start, parser->current);
+        return VALIDATE_ERROR;
+    }
+    if (ns_keyword.namespace != NULL) {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Namespaced map keyword cannot have a namespace", start,
+                             parser->current);
+        return VALIDATE_ERROR;
+    }
+
+    edn_skip_whitespace(parser);
+    if (parser->current >= parser->end || *parser->current != '{') {
+        edn_parser_set_error(parser, EDN_ERROR_INVALID_SYNTAX,
+                             "Namespaced map must be followed by '{'", start, parser->current);
+        return VALIDATE_ERROR;
+    }
+
+    return parse_collection(st, start, EDN_TYPE_MAP, &NS_MAP_SYNTAX, ns_keyword.name,
+                            ns_keyword.name_length);
+}
+#endif
+
+/* Parse one form, mirroring edn_read_value()'s dispatch. Returns the form's
+ * edn_type_t, VALIDATE_CLOSE or VALIDATE_ERROR. */
+static int parse_form(validate_state_t* st) {
+    edn_parser_t* parser = &st->parser;
+
+    /* Map-key namespace applies to this form only */
+    const char* key_ns = st->key_ns;
+    size_t key_ns_length = st->key_ns_length;
+    st->key_ns = NULL;
+
+    if (!skip_whitespace(parser)) {
+        edn_parser_set_error(parser, EDN_ERROR_UNEXPECTED_EOF, "Unexpected end of input",
+                             parser->current, parser->current);
+        return VALIDATE_ERROR;
+    }
+
+    const char* start = parser->current;
+    char c = *start;
+
+    switch (c) {
+        case '"':
+            return parse_string(st, start);
+
+        case ':':
+            return parse_identifier(st, key_ns, key_ns_length);
+
+        case '\\':
+            return scanner_fallback(st, edn_read_character);
+
+        case '(':
+            return parse_collection(st, start, EDN_TYPE_LIST, &LIST_SYNTAX, NULL, 0);
+
+        case '[':
+            return parse_collection(st, start, EDN_TYPE_VECTOR, &VECTOR_SYNTAX, NULL, 0);
+
+        case '{':
+            return parse_collection(st, start, EDN_TYPE_MAP, &MAP_SYNTAX, NULL, 0);
+
+        case ')':
+        case ']':
+        case '}':
+            if (parser->depth == 0) {
+                const char* msg;
+                if (c == ')') {
+                    msg = "Unmatched closing delimiter ')'";
+                } else if (c == ']') {
+                    msg = "Unmatched closing delimiter ']'";
+                } else {
+                    msg = "Unmatched closing delimiter '}'";
+                }
+                edn_parser_set_error(parser, EDN_ERROR_UNMATCHED_DELIMITER, msg, start, start + 1);
+                return VALIDATE_ERROR;
+            }
+            return VALIDATE_CLOSE;
+
+        case '#':
+            if (start + 1 < parser->end) {
+                char next = start[1];
+                if (next == '{') {
+                    return parse_collection(st, start, EDN_TYPE_SET, &SET_SYNTAX, NULL, 0);
+                } else if (next == '#') {
+                    return scanner_fallback(st, edn_read_symbolic_value);
+                } else if (next == '_') {
+                    return parse_discard(st, start, key_ns, key_ns_length);
+                }
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+                else if (next == ':') {
+                    return parse_namespaced_map(st, start);
+                }
+#endif
+            }
+            return parse_tagged(st, start);
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+        case '^':
+            return parse_metadata(st, start, key_ns, key_ns_length);
+#endif
+
+        case '+':
+            if (start + 1 < parser->end && start[1] >= '0' && start[1] <= '9') {
+                return scanner_fallback(st, edn_read_number);
+            }
+            return parse_identifier(st, key_ns, key_ns_length);
+
+        case '-':
+            if (start + 1 < parser->end && start[1] >= '0' && start[1] <= '9') {
+                return parse_number(st, start);
+            }
+            return parse_identifier(st, key_ns, key_ns_length);
+
+        default:
+            if (c >= '0' && c <= '9') {
+                return parse_number(st, start);
+            }
+            return parse_identifier(st, key_ns, key_ns_length);
+    }
+}
+
+edn_result_t edn_validate(const char* input, size_t length, const edn_validate_options_t* options,
+                          edn_validate_stats_t* stats) {
+    edn_result_t result = {0};
+    edn_validate_stats_t empty = {0};
+
+    if (stats != NULL) {
+        *stats = empty;
+    }
+    if (!input) {
+        result.error = EDN_ERROR_INVALID_SYNTAX;
+        result.error_message = "Input is NULL";
+        return result;
+    }
+
+    if (length == 0) {
+        length = strlen(input);
+    }
+
+    uint64_t inline_hashes[VALIDATE_INLINE_HASHES];
+    validate_state_t st;
+    edn_parser_init(&st.parser, input, length); /* Arena created on the first fallback */
+    st.check_duplicates = false;
+    st.hashing = false;
+    st.hash = 0;
+    st.hashes = inline_hashes;
+    st.hash_count = 0;
+    st.hash_capacity = VALIDATE_INLINE_HASHES;
+    st.hashes_on_heap = false;
+    st.muted = 0;
+    st.key_ns = NULL;
+    st.key_ns_length = 0;
+    st.collection_depth = 0;
+    st.stats = empty;
+
+    if (options != NULL) {
+        size_t sz =
+            options->struct_size == 0 ? sizeof(edn_validate_options_t) : options->struct_size;
+        if (sz >= offsetof(edn_validate_options_t, check_duplicates) +
+                      sizeof(options->check_duplicates)) {
+            st.check_duplicates = options->check_duplicates;
+        }
+        if (sz >= offsetof(edn_validate_options_t, max_depth) + sizeof(options->max_depth) &&
+            options->max_depth != 0) {
+            st.parser.max_depth = options->max_depth;
+        }
+        if (sz >= offsetof(edn_validate_options_t, scratch_size) + sizeof(options->scratch_size) &&
+            options->scratch != NULL) {
+            /* Use the caller's buffer from its first 8-byte boundary */
+            uintptr_t base = (uintptr_t) options->scratch;
+            size_t skip = (size_t) ((8 - (base & 7)) & 7);
+            size_t capacity = options->scratch_size > skip
+                                  ? (options->scratch_size - skip) / sizeof(uint64_t)
+                                  : 0;
+            if (capacity > VALIDATE_INLINE_HASHES) {
+                st.hashes = (uint64_t*) (base + skip);
+                st.hash_capacity = capacity;
+            }
+        }
+        if (sz >= offsetof(edn_validate_options_t, strict_utf8) + sizeof(options->strict_utf8)) {
+            st.parser.strict_utf8 = options->strict_utf8;
+        }
+    }
+
+    parse_form(&st);
+
+    edn_arena_destroy(st.parser.arena);
+    if (st.hashes_on_heap) {
+        free(st.hashes);
+    }
+
+    if (stats != NULL) {
+        *stats = st.stats;
+    }
+    result.error = st.parser.error;
+    result.error_message = st.parser.error_message;
+    if (result.error != EDN_OK) {
+        edn_result_set_error_positions(&result, &st.parser);
+    }
+    return result;
+}
@@ -0,0 +1,235 @@
+/**
+ * EDN.C - Non-recursive tree walker
+ *
+ * One frame per open collection or tagged literal holds the node, its
+ * child count (map entries count twice: key, then value), the next child
+ * and the node's own position in its parent, for its post-order visit.
+ * Children are read straight from the node's array, with no per-child type
+ * dispatch beyond the frame's own.
+ *
+ * Tree nodes are scattered over arena blocks, so the walk is bound by
+ * cache misses on them. Entering a collection prefetches its child array;
+ * returning child i prefetches child i + WALK_PREFETCH_DISTANCE, so its
+ * node is usually in cache by the time the walk gets there.
+ */
+
+#include <stdlib.h>
+
+#include "edn_internal.h"
+
+#define WALK_STACK_INITIAL 32
+#define WALK_PREFETCH_DISTANCE 8
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WALK_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define WALK_PREFETCH(addr) _mm_prefetch((const char*) (addr), _MM_HINT_T0)
+#else
+#define WALK_PREFETCH(addr) ((void) (addr))
+#endif
+
+typedef struct {
+    const edn_value_t* node;
+    edn_value_t* const* elements; /* List, vector or set children */
+    const edn_map_entry_t* entries;
+    size_t next;  /* Next child */
+    size_t count; /* Children */
+    /* The node's own visit, repeated for its post-order visit */
+    const edn_value_t* key;
+    size_t index;
+    bool is_key;
+} walk_frame_t;
+
+struct edn_walk {
+    walk_frame_t* stack;
+    size_t depth; /* Frames in use */
+    size_t capacity;
+    const edn_value_t* root; /* Not reported yet, or NULL */
+    unsigned order;
+    bool skippable; /* The last visit was pre-order and opened a frame */
+    edn_error_t error;
+};
+
+edn_walk_t* edn_walk_create(const edn_value_t* root, unsigned order) {
+    edn_walk_t* walk = calloc(1, sizeof(*walk));
+    if (walk == NULL) {
+        return NULL;
+    }
+    walk->stack = malloc(WALK_STACK_INITIAL * sizeof(walk_frame_t));
+    if (walk->stack == NULL) {
+        free(walk);
+        return NULL;
+    }
+    walk->capacity = WALK_STACK_INITIAL;
+    walk->order = order == 0 ? EDN_WALK_PRE : order;
+    walk->root = root;
+    return walk;
+}
+
+void edn_walk_reset(edn_walk_t* walk, const edn_value_t* root) {
+    if (walk == NULL) {
+        return;
+    }
+    walk->depth = 0;
+    walk->root = root;
+    walk->skippable = false;
+    walk->error = EDN_OK;
+}
+
+void edn_walk_destroy(edn_walk_t* walk) {
+    if (walk == NULL) {
+        return;
+    }
+    free(walk->stack);
+    free(walk);
+}
+
+edn_error_t edn_walk_error(const edn_walk_t* walk) {
+    return walk ? walk->error : EDN_ERROR_INVALID_ARGUMENT;
+}
+
+void edn_walk_skip(edn_walk_t* walk) {
+    if (walk != NULL && walk->skippable) {
+        walk_frame_t* frame = &walk->stack[walk->depth - 1];
+        frame->next = frame->count;
+        walk->skippable = false;
+    }
+}
+
+/* Open a frame for `node` if it has children to visit; false on OOM */
+static bool push_frame(edn_walk_t* walk, const edn_value_t* node, const edn_value_t* key,
+                       size_t index, bool is_key, bool* pushed) {
+    walk_frame_t frame;
+    frame.elements = NULL;
+    frame.entries = NULL;
+    switch (node->type) {
+        case EDN_TYPE_LIST:
+            frame.elements = node->as.list.elements;
+            frame.count = node->as.list.count;
+            break;
+        case EDN_TYPE_VECTOR:
+            frame.elements = node->as.vector.elements;
+            frame.count = node->as.vector.count;
+            break;
+        case EDN_TYPE_SET:
+            frame.elements = node->as.set.elements;
+            frame.count = node->as.set.count;
+            break;
+        case EDN_TYPE_MAP:
+            frame.entries = node->as.map.entries;
+            frame.count = node->as.map.count * 2;
+            break;
+        case EDN_TYPE_TAGGED:
+            frame.elements = &node->as.tagged.value;
+            frame.count = node->as.tagged.value != NULL ? 1 : 0;
+            break;
+        default:
+            *pushed = false;
+            return true;
+    }
+
+    if (walk->depth == walk->capacity) {
+        size_t capacity = walk->capacity * 2;
+        walk_frame_t* stack = realloc(walk->stack, capacity * sizeof(*stack));
+        if (stack == NULL) {
+            walk->error = EDN_ERROR_OUT_OF_MEMORY;
+            return false;
+        }
+        walk->stack = stack;
+        walk->capacity = capacity;
+    }
+    if (frame.elements != NULL) {
+        WALK_PREFETCH(frame.elements);
+    } else if (frame.entries != NULL) {
+        WALK_PREFETCH(frame.entries);
+    }
+    frame.node = node;
+    frame.next = 0;
+    frame.key = key;
+    frame.index = index;
+    frame.is_key = is_key;
+    walk->stack[walk->depth++] = frame;
+    *pushed = true;
+    return true;
+}
+
+/* Fill `item` for `node`; true if this visit is reported */
+static inline bool visit(edn_walk_t* walk, const edn_value_t* node, const edn_value_t* parent,
+                         const edn_value_t* key, size_t index, bool is_key,
+                         edn_walk_item_t* item) {
+    item->value = node;
+    item->parent = parent;
+    item->key = key;
+    item->depth = walk->depth;
+    item->index = index;
+    item->is_key = is_key;
+    item->post = false;
+    if (node->type < EDN_TYPE_LIST || node->type > EDN_TYPE_TAGGED) {
+        return true; /* Leaf: the common case, no frame */
+    }
+
+    bool pushed;
+    if (!push_frame(walk, node, key, index, is_key, &pushed)) {
+        return false;
+    }
+    walk->skippable = (walk->order & EDN_WALK_PRE) != 0;
+    return walk->skippable;
+}
+
+bool edn_walk_next(edn_walk_t* walk, edn_walk_item_t* item) {
+    if (walk == NULL || item == NULL || walk->error != EDN_OK) {
+        return false;
+    }
+    walk->skippable = false;
+
+    if (walk->root != NULL) {
+        const edn_value_t* root = walk->root;
+        walk->root = NULL;
+        if (visit(walk, root, NULL, NULL, 0, false, item)) {
+            return true;
+        }
+    }
+
+    while (walk->depth > 0 && walk->error == EDN_OK) {
+        walk_frame_t* frame = &walk->stack[walk->depth - 1];
+        if (frame->next < frame->count) {
+            size_t i = frame->next++;
+            if (frame->entries == NULL) {
+                if (i + WALK_PREFETCH_DISTANCE < frame->count) {
+                    WALK_PREFETCH(frame->elements[i + WALK_PREFETCH_DISTANCE]);
+                }
+                if (visit(walk, frame->elements[i], frame->node, NULL, i, false, item)) {
+                    return true;
+                }
+                continue;
+            }
+
+            const edn_map_entry_t* entry = &frame->entries[i / 2];
+            bool is_key = (i & 1) == 0;
+            if (is_key && i + WALK_PREFETCH_DISTANCE < frame->count) {
+                const edn_map_entry_t* ahead = entry + WALK_PREFETCH_DISTANCE / 2;
+                WALK_PREFETCH(ahead->key);
+                WALK_PREFETCH(ahead->value);
+            }
+            if (visit(walk, is_key ? entry->key : entry->value, frame->node,
+                      is_key ? NULL : entry->key, i / 2, is_key, item)) {
+                return true;
+            }
+            continue;
+        }
+
+        walk->depth--;
+        if (walk->order & EDN_WALK_POST) {
+            item->value = frame->node;
+            item->parent = walk->depth > 0 ? walk->stack[walk->depth - 1].node : NULL;
+            item->key = frame->key;
+            item->depth = walk->depth;
+            item->index = frame->index;
+            item->is_key = frame->is_key;
+            item->post = true;
+            return true;
+        }
+    }
+    return false;
+}
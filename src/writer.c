@@ -20,6 +20,9 @@ typedef struct {
     bool escape_unicode; /* escape non-ASCII bytes in strings as \uXXXX (BMP only) */
     bool indent;         /* pretty-print: hanging-indent collections, one item per line */
     size_t column;       /* current 0-based byte column since last '\n' in the output */
+    const edn_budget_t* budget; /* cancellation and deadline, or NULL */
+    size_t written;             /* bytes delivered to cb so far */
+    size_t budget_checkpoint;   /* `written` at which the budget is checked next */
 } emit_ctx_t;
 
 static int serialize_key_to_heap(const edn_value_t* v, bool sort_unordered, bool escape_unicode,
@@ -37,6 +40,7 @@ static int emit(emit_ctx_t* e, const char* buf, size_t len) {
         e->err = (r < 0) ? r : -r;
         return e->err;
     }
+    e->written += len;
     for (size_t i = 0; i < len; i++) {
         if (buf[i] == '\n') {
             e->column = 0;
@@ -47,6 +51,22 @@ static int emit(emit_ctx_t* e, const char* buf, size_t len) {
     return 0;
 }
 
+/* emit() for bytes known to hold no '\n' (pre-rendered tokens): one
+ * callback, and the column advances without a per-byte scan. */
+static int emit_line(emit_ctx_t* e, const char* buf, size_t len) {
+    if (e->err != 0) {
+        return e->err;
+    }
+    int r = e->cb(buf, len, e->ctx);
+    if (r != 0) {
+        e->err = (r < 0) ? r : -r;
+        return e->err;
+    }
+    e->written += len;
+    e->column += len;
+    return 0;
+}
+
 static int emit_cstr(emit_ctx_t* e, const char* s) {
     return emit(e, s, strlen(s));
 }
@@ -69,6 +89,26 @@ static int emit_newline_indent(emit_ctx_t* e, size_t col) {
 
 static int emit_value(emit_ctx_t* e, const edn_value_t* v);
 
+/* Between collection elements: stop once the budget says so. Without a
+ * budget the checkpoint moves to SIZE_MAX on the first call. */
+static int check_budget(emit_ctx_t* e) {
+    if (e->written < e->budget_checkpoint) {
+        return 0;
+    }
+    if (e->budget == NULL) {
+        e->budget_checkpoint = SIZE_MAX;
+        return 0;
+    }
+    edn_error_t error = edn_budget_poll(e->budget, e->written);
+    if (error != EDN_OK) {
+        e->err = -(int) error;
+        return e->err;
+    }
+    size_t slice = edn_budget_slice(e->budget);
+    e->budget_checkpoint = e->written > SIZE_MAX - slice ? SIZE_MAX : e->written + slice;
+    return 0;
+}
+
 /* --- scalar emitters --- */
 
 static int emit_int(emit_ctx_t* e, int64_t n) {
@@ -225,6 +265,16 @@ static int emit_bigint(emit_ctx_t* e, const edn_value_t* v) {
     return emit_bigint_parts(e, digits, len, neg, radix);
 }
 
+static int emit_bigdec_parts(emit_ctx_t* e, const char* dec, size_t len, bool negative) {
+    if (negative) {
+        if (emit(e, "-", 1) != 0)
+            return e->err;
+    }
+    if (emit(e, dec, len) != 0)
+        return e->err;
+    return emit(e, "M", 1);
+}
+
 static int emit_bigdec(emit_ctx_t* e, const edn_value_t* v) {
     size_t len;
     bool neg;
@@ -233,20 +283,13 @@ static int emit_bigdec(emit_ctx_t* e, const edn_value_t* v) {
         e->err = -EDN_ERROR_OUT_OF_MEMORY;
         return e->err;
     }
-    if (neg) {
-        if (emit(e, "-", 1) != 0)
-            return e->err;
-    }
-    if (emit(e, dec, len) != 0)
-        return e->err;
-    return emit(e, "M", 1);
+    return emit_bigdec_parts(e, dec, len, neg);
 }
 
 #ifdef EDN_ENABLE_CLOJURE_EXTENSION
-static int emit_ratio(emit_ctx_t* e, const edn_value_t* v) {
+static int emit_ratio_parts(emit_ctx_t* e, int64_t numerator, int64_t denominator) {
     char buf[64];
-    int len = snprintf(buf, sizeof(buf), "%" PRId64 "/%" PRId64, v->as.ratio.numerator,
-                       v->as.ratio.denominator);
+    int len = snprintf(buf, sizeof(buf), "%" PRId64 "/%" PRId64, numerator, denominator);
     if (len < 0) {
         e->err = -EDN_ERROR_OUT_OF_MEMORY;
         return e->err;
@@ -254,6 +297,23 @@ static int emit_ratio(emit_ctx_t* e, const edn_value_t* v) {
     return emit(e, buf, (size_t) len);
 }
 
+static int emit_ratio(emit_ctx_t* e, const edn_value_t* v) {
+    return emit_ratio_parts(e, v->as.ratio.numerator, v->as.ratio.denominator);
+}
+
+static int emit_bigratio_parts(emit_ctx_t* e, const char* num, size_t num_len, bool num_neg,
+                               const char* denom, size_t denom_len) {
+    if (num_neg) {
+        if (emit(e, "-", 1) != 0)
+            return e->err;
+    }
+    if (emit(e, num, num_len) != 0)
+        return e->err;
+    if (emit(e, "/", 1) != 0)
+        return e->err;
+    return emit(e, denom, denom_len);
+}
+
 /* The parser produces this shape only when one of the components
  * exceeds int64_t range; for the fits-in-int64 case it produces
  * EDN_TYPE_RATIO instead. */
@@ -266,15 +326,7 @@ static int emit_bigratio(emit_ctx_t* e, const edn_value_t* v) {
         e->err = -EDN_ERROR_OUT_OF_MEMORY;
         return e->err;
     }
-    if (num_neg) {
-        if (emit(e, "-", 1) != 0)
-            return e->err;
-    }
-    if (emit(e, num, num_len) != 0)
-        return e->err;
-    if (emit(e, "/", 1) != 0)
-        return e->err;
-    return emit(e, denom, denom_len);
+    return emit_bigratio_parts(e, num, num_len, num_neg, denom, denom_len);
 }
 
 /* True iff `v` is a bare (non-namespaced) keyword whose name equals
@@ -296,8 +348,8 @@ static int emit_metadata_prefix(emit_ctx_t* e, const edn_value_t* meta) {
     if (emit(e, "^", 1) != 0)
         return e->err;
     if (meta->as.map.count == 1) {
-        const edn_value_t* k = meta->as.map.keys[0];
-        const edn_value_t* val = meta->as.map.values[0];
+        const edn_value_t* k = meta->as.map.entries[0].key;
+        const edn_value_t* val = meta->as.map.entries[0].value;
         if (keyword_is_bare(k, "tag", 3) && val != NULL && val->type == EDN_TYPE_SYMBOL) {
             return emit_value(e, val);
         }
@@ -502,6 +554,8 @@ static int emit_sequence(emit_ctx_t* e, edn_value_t* const* elements, size_t cou
         return e->err;
     size_t indent_col = e->column;
     for (size_t i = 0; i < count; i++) {
+        if (check_budget(e) != 0)
+            return e->err;
         if (i > 0) {
             if (e->indent) {
                 if (emit_newline_indent(e, indent_col) != 0)
@@ -577,10 +631,18 @@ static int build_sorted_indices(edn_value_t* const* elements, size_t count, bool
     return 0;
 }
 
-static int emit_map_sorted(emit_ctx_t* e, edn_value_t* const* keys, edn_value_t* const* values,
-                           size_t count) {
+static int emit_map_sorted(emit_ctx_t* e, const edn_map_entry_t* entries, size_t count) {
+    edn_value_t** keys = malloc(count * sizeof(*keys));
+    if (keys == NULL) {
+        e->err = -EDN_ERROR_OUT_OF_MEMORY;
+        return e->err;
+    }
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = entries[i].key;
+    }
     key_sort_item_t* items = NULL;
     int r = build_sorted_indices(keys, count, e->sort_unordered, e->escape_unicode, &items);
+    free(keys);
     if (r != 0) {
         e->err = r;
         return e->err;
@@ -590,6 +652,8 @@ static int emit_map_sorted(emit_ctx_t* e, edn_value_t* const* keys, edn_value_t*
         goto done;
     size_t indent_col = e->column;
     for (size_t i = 0; i < count; i++) {
+        if (check_budget(e) != 0)
+            goto done;
         if (i > 0) {
             if (e->indent) {
                 if (emit_newline_indent(e, indent_col) != 0)
@@ -599,12 +663,12 @@ static int emit_map_sorted(emit_ctx_t* e, edn_value_t* const* keys, edn_value_t*
                     goto done;
             }
         }
-        size_t idx = items[i].idx;
-        if (emit_value(e, keys[idx]) != 0)
+        const edn_map_entry_t* entry = &entries[items[i].idx];
+        if (emit_value(e, entry->key) != 0)
             goto done;
         if (emit(e, " ", 1) != 0)
             goto done;
-        if (emit_value(e, values[idx]) != 0)
+        if (emit_value(e, entry->value) != 0)
             goto done;
     }
     emit(e, "}", 1);
@@ -626,6 +690,8 @@ static int emit_set_sorted(emit_ctx_t* e, edn_value_t* const* elements, size_t c
         goto done;
     size_t indent_col = e->column;
     for (size_t i = 0; i < count; i++) {
+        if (check_budget(e) != 0)
+            goto done;
         if (i > 0) {
             if (e->indent) {
                 if (emit_newline_indent(e, indent_col) != 0)
@@ -653,6 +719,8 @@ static int emit_set(emit_ctx_t* e, edn_value_t* const* elements, size_t count) {
         return e->err;
     size_t indent_col = e->column;
     for (size_t i = 0; i < count; i++) {
+        if (check_budget(e) != 0)
+            return e->err;
         if (i > 0) {
             if (e->indent) {
                 if (emit_newline_indent(e, indent_col) != 0)
@@ -668,15 +736,16 @@ static int emit_set(emit_ctx_t* e, edn_value_t* const* elements, size_t count) {
     return emit(e, "}", 1);
 }
 
-static int emit_map(emit_ctx_t* e, edn_value_t* const* keys, edn_value_t* const* values,
-                    size_t count) {
+static int emit_map(emit_ctx_t* e, const edn_map_entry_t* entries, size_t count) {
     if (e->sort_unordered && count > 1) {
-        return emit_map_sorted(e, keys, values, count);
+        return emit_map_sorted(e, entries, count);
     }
     if (emit(e, "{", 1) != 0)
         return e->err;
     size_t indent_col = e->column;
     for (size_t i = 0; i < count; i++) {
+        if (check_budget(e) != 0)
+            return e->err;
         if (i > 0) {
             if (e->indent) {
                 if (emit_newline_indent(e, indent_col) != 0)
@@ -686,11 +755,11 @@ static int emit_map(emit_ctx_t* e, edn_value_t* const* keys, edn_value_t* const*
                     return e->err;
             }
         }
-        if (emit_value(e, keys[i]) != 0)
+        if (emit_value(e, entries[i].key) != 0)
             return e->err;
         if (emit(e, " ", 1) != 0)
             return e->err;
-        if (emit_value(e, values[i]) != 0)
+        if (emit_value(e, entries[i].value) != 0)
             return e->err;
     }
     return emit(e, "}", 1);
@@ -706,6 +775,30 @@ static int emit_tagged(emit_ctx_t* e, const edn_value_t* v) {
     return emit_value(e, v->as.tagged.value);
 }
 
+/* Built-in #inst / #uuid externals round-trip; other externals are opaque. */
+static int emit_external(emit_ctx_t* e, const edn_value_t* v) {
+    char buf[EDN_BUILTIN_FORMAT_MAX];
+    size_t len;
+
+    if (v->as.external.type_id == EDN_EXTERNAL_TYPE_INST) {
+        const edn_inst_data_t* inst = v->as.external.data;
+        if (emit_cstr(e, "#inst \"") != 0)
+            return e->err;
+        len = edn_inst_format(inst->epoch_ns, inst->offset_minutes, buf);
+    } else if (v->as.external.type_id == EDN_EXTERNAL_TYPE_UUID) {
+        if (emit_cstr(e, "#uuid \"") != 0)
+            return e->err;
+        len = edn_uuid_format(v->as.external.data, buf);
+    } else {
+        e->err = -EDN_ERROR_UNSUPPORTED_TYPE;
+        return e->err;
+    }
+
+    if (emit(e, buf, len) != 0)
+        return e->err;
+    return emit(e, "\"", 1);
+}
+
 static int emit_value(emit_ctx_t* e, const edn_value_t* v) {
     if (e->err != 0)
         return e->err;
@@ -760,23 +853,26 @@ static int emit_value(emit_ctx_t* e, const edn_value_t* v) {
         case EDN_TYPE_SET:
             return emit_set(e, v->as.set.elements, v->as.set.count);
         case EDN_TYPE_MAP:
-            return emit_map(e, v->as.map.keys, v->as.map.values, v->as.map.count);
+            return emit_map(e, v->as.map.entries, v->as.map.count);
         case EDN_TYPE_TAGGED:
             return emit_tagged(e, v);
         case EDN_TYPE_EXTERNAL:
-            e->err = -EDN_ERROR_UNSUPPORTED_TYPE;
-            return e->err;
+            return emit_external(e, v);
         default:
             e->err = -EDN_ERROR_UNSUPPORTED_TYPE;
             return e->err;
     }
 }
 
+/* struct_size of edn_write_options_t before `budget` was appended */
+#define WRITE_OPTIONS_BASE_SIZE \
+    (offsetof(edn_write_options_t, writer_registry) + sizeof(edn_writer_registry_t*))
+
 static int validate_options(const edn_write_options_t* opts) {
     if (opts == NULL) {
         return 0;
     }
-    if (opts->struct_size < sizeof(edn_write_options_t)) {
+    if (opts->struct_size < WRITE_OPTIONS_BASE_SIZE) {
         if (opts->struct_size != 0) {
             return -EDN_ERROR_INVALID_ARGUMENT;
         }
@@ -795,6 +891,14 @@ static bool opt_newline_at_end(const edn_write_options_t* opts) {
     return opts->newline_at_end;
 }
 
+static const edn_budget_t* opt_budget(const edn_write_options_t* opts) {
+    if (opts == NULL || opts->struct_size == 0)
+        return NULL;
+    if (opts->struct_size < offsetof(edn_write_options_t, budget) + sizeof(opts->budget))
+        return NULL;
+    return opts->budget;
+}
+
 /* ========================================================================
  * Public streaming primitive
  * ======================================================================== */
@@ -819,7 +923,10 @@ int edn_write_stream(const edn_value_t* value, edn_writer_callback_fn cb, void*
                     .emit_metadata = emit_metadata,
                     .escape_unicode = escape_unicode,
                     .indent = indent,
-                    .column = 0};
+                    .column = 0,
+                    .budget = opt_budget(options),
+                    .written = 0,
+                    .budget_checkpoint = 0};
     emit_value(&e, value);
     if (e.err != 0)
         return e.err;
@@ -1278,21 +1385,8 @@ static bool valid_tag(const char* s, size_t len) {
     return valid_sym_chunk(s, ns_len) && valid_sym_chunk(name, name_len);
 }
 
-static bool valid_utf8(const char* s, size_t len) {
-    const unsigned char* p = (const unsigned char*) s;
-    size_t i = 0;
-    while (i < len) {
-        if (p[i] < 0x80) {
-            i++;
-            continue;
-        }
-        uint32_t cp;
-        size_t n = decode_utf8(p + i, len - i, &cp);
-        if (n == 0)
-            return false;
-        i += n;
-    }
-    return true;
+static inline bool valid_utf8(const char* s, size_t len) {
+    return edn_simd_validate_utf8(s, s + len) == s + len;
 }
 
 #ifdef EDN_ENABLE_CLOJURE_EXTENSION
@@ -1473,6 +1567,11 @@ static int emitter_pre_value(edn_emitter_t* em, payload_kind_t kind) {
             return -EDN_ERROR_INVALID_STATE;
         }
     } else {
+        /* Between elements, where edn_write_* checks it too */
+        if (check_budget(&em->e) != 0) {
+            em->poisoned = true;
+            return em->e.err;
+        }
         if (emitter_emit_separator(em, f) != 0) {
             em->poisoned = true;
             return em->e.err ? em->e.err : -EDN_ERROR_OUT_OF_MEMORY;
@@ -1521,7 +1620,7 @@ static int emitter_post_scalar(edn_emitter_t* em) {
 static int emitter_validate_options_for_create(const edn_write_options_t* opts) {
     if (opts == NULL)
         return 0;
-    if (opts->struct_size != 0 && opts->struct_size < sizeof(edn_write_options_t))
+    if (opts->struct_size != 0 && opts->struct_size < WRITE_OPTIONS_BASE_SIZE)
         return -1;
     if (opts->struct_size == 0)
         return 0;
@@ -1562,6 +1661,9 @@ edn_emitter_t* edn_emitter_create(edn_writer_callback_fn cb, void* ctx,
     em->e.escape_unicode = has_opts && options->escape_unicode;
     em->e.indent = em->indent_enabled;
     em->e.column = 0;
+    em->e.budget = opt_budget(options);
+    em->e.written = 0;
+    em->e.budget_checkpoint = 0;
 
     em->frames = em->inline_frames;
     em->frames_count = 0;
@@ -1687,79 +1789,108 @@ int edn_emit_string(edn_emitter_t* em, const char* s, size_t len) {
     return emitter_post_scalar(em);
 }
 
-static int emit_kw_or_sym_raw(edn_emitter_t* em, bool is_keyword, const char* ns,
-                              const char* name) {
+static int emit_kw_or_sym_raw(edn_emitter_t* em, bool is_keyword, const char* ns, size_t ns_len,
+                              const char* name, size_t name_len) {
     if (is_keyword) {
         if (emit(&em->e, ":", 1) != 0)
             return em->e.err;
     }
     if (ns != NULL) {
-        if (emit(&em->e, ns, strlen(ns)) != 0)
+        if (emit(&em->e, ns, ns_len) != 0)
             return em->e.err;
         if (emit(&em->e, "/", 1) != 0)
             return em->e.err;
     }
-    return emit(&em->e, name, strlen(name));
+    return emit(&em->e, name, name_len);
 }
 
-int edn_emit_keyword(edn_emitter_t* em, const char* name) {
-    if (em == NULL || name == NULL)
+/* Shared body of the keyword/symbol emitters; `ns` may be NULL. */
+static int emitter_kw_or_sym(edn_emitter_t* em, bool is_keyword, const char* ns, size_t ns_len,
+                             const char* name, size_t name_len) {
+    if (ns != NULL && !valid_sym_chunk(ns, ns_len))
         return -EDN_ERROR_INVALID_ARGUMENT;
-    if (!valid_kw_name(name, strlen(name)))
+    if (is_keyword ? !valid_kw_name(name, name_len) : !valid_sym_chunk(name, name_len))
         return -EDN_ERROR_INVALID_ARGUMENT;
-    int r = emitter_pre_value(em, PAYLOAD_KEYWORD);
+    int r = emitter_pre_value(em, is_keyword ? PAYLOAD_KEYWORD : PAYLOAD_SYMBOL);
     if (r != 0)
         return r;
-    if (emit_kw_or_sym_raw(em, true, NULL, name) != 0) {
+    if (emit_kw_or_sym_raw(em, is_keyword, ns, ns_len, name, name_len) != 0) {
         em->poisoned = true;
         return em->e.err;
     }
     return emitter_post_scalar(em);
 }
 
+int edn_emit_keyword(edn_emitter_t* em, const char* name) {
+    if (em == NULL || name == NULL)
+        return -EDN_ERROR_INVALID_ARGUMENT;
+    return emitter_kw_or_sym(em, true, NULL, 0, name, strlen(name));
+}
+
 int edn_emit_keyword_ns(edn_emitter_t* em, const char* ns, const char* name) {
     if (em == NULL || ns == NULL || name == NULL)
         return -EDN_ERROR_INVALID_ARGUMENT;
-    if (!valid_sym_chunk(ns, strlen(ns)))
-        return -EDN_ERROR_INVALID_ARGUMENT;
-    if (!valid_kw_name(name, strlen(name)))
-        return -EDN_ERROR_INVALID_ARGUMENT;
-    int r = emitter_pre_value(em, PAYLOAD_KEYWORD);
-    if (r != 0)
-        return r;
-    if (emit_kw_or_sym_raw(em, true, ns, name) != 0) {
-        em->poisoned = true;
-        return em->e.err;
-    }
-    return emitter_post_scalar(em);
+    return emitter_kw_or_sym(em, true, ns, strlen(ns), name, strlen(name));
 }
 
 int edn_emit_symbol(edn_emitter_t* em, const char* name) {
     if (em == NULL || name == NULL)
         return -EDN_ERROR_INVALID_ARGUMENT;
-    if (!valid_sym_chunk(name, strlen(name)))
-        return -EDN_ERROR_INVALID_ARGUMENT;
-    int r = emitter_pre_value(em, PAYLOAD_SYMBOL);
-    if (r != 0)
-        return r;
-    if (emit_kw_or_sym_raw(em, false, NULL, name) != 0) {
-        em->poisoned = true;
-        return em->e.err;
-    }
-    return emitter_post_scalar(em);
+    return emitter_kw_or_sym(em, false, NULL, 0, name, strlen(name));
 }
 
 int edn_emit_symbol_ns(edn_emitter_t* em, const char* ns, const char* name) {
     if (em == NULL || ns == NULL || name == NULL)
         return -EDN_ERROR_INVALID_ARGUMENT;
-    if (!valid_sym_chunk(ns, strlen(ns)))
-        return -EDN_ERROR_INVALID_ARGUMENT;
-    if (!valid_sym_chunk(name, strlen(name)))
+    return emitter_kw_or_sym(em, false, ns, strlen(ns), name, strlen(name));
+}
+
+/* --- pre-rendered tokens --- */
+
+struct edn_emitter_token {
+    payload_kind_t kind;
+    size_t len;
+    char bytes[]; /* rendered text, e.g. ":ns/name" */
+};
+
+edn_emitter_token_t* edn_emitter_make_keyword(const char* ns, const char* name) {
+    if (name == NULL)
+        return NULL;
+    size_t ns_len = ns ? strlen(ns) : 0;
+    size_t name_len = strlen(name);
+    if (ns != NULL && !valid_sym_chunk(ns, ns_len))
+        return NULL;
+    if (!valid_kw_name(name, name_len))
+        return NULL;
+
+    size_t len = 1 + (ns ? ns_len + 1 : 0) + name_len;
+    edn_emitter_token_t* tok = malloc(sizeof(*tok) + len);
+    if (tok == NULL)
+        return NULL;
+    tok->kind = PAYLOAD_KEYWORD;
+    tok->len = len;
+    char* out = tok->bytes;
+    *out++ = ':';
+    if (ns != NULL) {
+        memcpy(out, ns, ns_len);
+        out += ns_len;
+        *out++ = '/';
+    }
+    memcpy(out, name, name_len);
+    return tok;
+}
+
+void edn_emitter_token_free(edn_emitter_token_t* tok) {
+    free(tok);
+}
+
+int edn_emit_token(edn_emitter_t* em, const edn_emitter_token_t* tok) {
+    if (em == NULL || tok == NULL)
         return -EDN_ERROR_INVALID_ARGUMENT;
-    int r = emitter_pre_value(em, PAYLOAD_SYMBOL);
+    int r = emitter_pre_value(em, tok->kind);
     if (r != 0)
         return r;
-    if (emit_kw_or_sym_raw(em, false, ns, name) != 0) {
+    if (emit_line(&em->e, tok->bytes, tok->len) != 0) {
         em->poisoned = true;
         return em->e.err;
     }
@@ -1821,16 +1952,9 @@ int edn_emit_bigratio(edn_emitter_t* em, const char* numerator, const char* deno
     int r = emitter_pre_value(em, PAYLOAD_BIGNUM);
     if (r != 0)
         return r;
-    emit_ctx_t* e = &em->e;
-    if (nneg) {
-        if (emit(e, "-", 1) != 0) {
-            em->poisoned = true;
-            return e->err;
-        }
-    }
-    if (emit(e, n, nlen) != 0 || emit(e, "/", 1) != 0 || emit(e, d, dlen) != 0) {
+    if (emit_bigratio_parts(&em->e, n, nlen, nneg, d, dlen) != 0) {
         em->poisoned = true;
-        return e->err;
+        return em->e.err;
     }
     return emitter_post_scalar(em);
 }
@@ -1846,16 +1970,9 @@ int edn_emit_bigdecimal(edn_emitter_t* em, const char* digits) {
     int r = emitter_pre_value(em, PAYLOAD_BIGNUM);
     if (r != 0)
         return r;
-    emit_ctx_t* e = &em->e;
-    if (neg) {
-        if (emit(e, "-", 1) != 0) {
-            em->poisoned = true;
-            return e->err;
-        }
-    }
-    if (emit(e, d, dlen) != 0 || emit(e, "M", 1) != 0) {
+    if (emit_bigdec_parts(&em->e, d, dlen, neg) != 0) {
         em->poisoned = true;
-        return e->err;
+        return em->e.err;
     }
     return emitter_post_scalar(em);
 }
@@ -1957,12 +2074,11 @@ int edn_emit_end_map(edn_emitter_t* em) {
 
 /* --- tag --- */
 
-int edn_emit_tag(edn_emitter_t* em, const char* tag) {
-    if (em == NULL || tag == NULL)
+static int emitter_tag(edn_emitter_t* em, const char* tag, size_t tag_len) {
+    if (em == NULL)
         return -EDN_ERROR_INVALID_ARGUMENT;
     if (em->poisoned || em->finished)
         return -EDN_ERROR_INVALID_STATE;
-    size_t tag_len = strlen(tag);
     if (!valid_tag(tag, tag_len))
         return -EDN_ERROR_INVALID_ARGUMENT;
     if (em->tag_pending) {
@@ -1983,6 +2099,12 @@ int edn_emit_tag(edn_emitter_t* em, const char* tag) {
     return 0;
 }
 
+int edn_emit_tag(edn_emitter_t* em, const char* tag) {
+    if (em == NULL || tag == NULL)
+        return -EDN_ERROR_INVALID_ARGUMENT;
+    return emitter_tag(em, tag, strlen(tag));
+}
+
 /* --- meta --- */
 
 #ifdef EDN_ENABLE_CLOJURE_EXTENSION
@@ -2046,3 +2168,151 @@ int edn_emit_value(edn_emitter_t* em, const edn_value_t* v) {
     }
     return emitter_post_scalar(em);
 }
+
+/* --- event parser adapter --- */
+
+/* Callbacks for edn_emitter_event_handlers(); ctx is the edn_emitter_t.
+ * Numbers arrive already validated by the parser, so the big-number
+ * events go straight to the shared *_parts writers. */
+
+static int event_nil(void* ctx) {
+    return edn_emit_nil(ctx);
+}
+static int event_bool(void* ctx, bool value) {
+    return edn_emit_bool(ctx, value);
+}
+static int event_int(void* ctx, int64_t value) {
+    return edn_emit_int(ctx, value);
+}
+static int event_double(void* ctx, double value) {
+    return edn_emit_double(ctx, value);
+}
+static int event_string(void* ctx, const char* s, size_t len) {
+    return edn_emit_string(ctx, s, len);
+}
+static int event_keyword(void* ctx, const char* ns, size_t ns_len, const char* name,
+                         size_t name_len) {
+    return emitter_kw_or_sym(ctx, true, ns, ns_len, name, name_len);
+}
+static int event_symbol(void* ctx, const char* ns, size_t ns_len, const char* name,
+                        size_t name_len) {
+    return emitter_kw_or_sym(ctx, false, ns, ns_len, name, name_len);
+}
+static int event_character(void* ctx, uint32_t cp) {
+    return edn_emit_character(ctx, cp);
+}
+
+static int event_bigint(void* ctx, const char* digits, size_t len, bool negative, uint8_t radix) {
+    edn_emitter_t* em = ctx;
+    int r = emitter_pre_value(em, PAYLOAD_BIGNUM);
+    if (r != 0)
+        return r;
+    if (emit_bigint_parts(&em->e, digits, len, negative, radix) != 0) {
+        em->poisoned = true;
+        return em->e.err;
+    }
+    return emitter_post_scalar(em);
+}
+
+static int event_bigdec(void* ctx, const char* digits, size_t len, bool negative) {
+    edn_emitter_t* em = ctx;
+    int r = emitter_pre_value(em, PAYLOAD_BIGNUM);
+    if (r != 0)
+        return r;
+    if (emit_bigdec_parts(&em->e, digits, len, negative) != 0) {
+        em->poisoned = true;
+        return em->e.err;
+    }
+    return emitter_post_scalar(em);
+}
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+static int event_ratio(void* ctx, int64_t numerator, int64_t denominator) {
+    edn_emitter_t* em = ctx;
+    int r = emitter_pre_value(em, PAYLOAD_BIGNUM);
+    if (r != 0)
+        return r;
+    if (emit_ratio_parts(&em->e, numerator, denominator) != 0) {
+        em->poisoned = true;
+        return em->e.err;
+    }
+    return emitter_post_scalar(em);
+}
+
+static int event_bigratio(void* ctx, const char* num, size_t num_len, bool negative,
+                          const char* denom, size_t denom_len) {
+    edn_emitter_t* em = ctx;
+    int r = emitter_pre_value(em, PAYLOAD_BIGNUM);
+    if (r != 0)
+        return r;
+    if (emit_bigratio_parts(&em->e, num, num_len, negative, denom, denom_len) != 0) {
+        em->poisoned = true;
+        return em->e.err;
+    }
+    return emitter_post_scalar(em);
+}
+
+static int event_meta(void* ctx) {
+    return edn_emit_meta(ctx);
+}
+#endif
+
+static int event_begin_list(void* ctx) {
+    return edn_emit_begin_list(ctx);
+}
+static int event_end_list(void* ctx) {
+    return edn_emit_end_list(ctx);
+}
+static int event_begin_vector(void* ctx) {
+    return edn_emit_begin_vector(ctx);
+}
+static int event_end_vector(void* ctx) {
+    return edn_emit_end_vector(ctx);
+}
+static int event_begin_set(void* ctx) {
+    return edn_emit_begin_set(ctx);
+}
+static int event_end_set(void* ctx) {
+    return edn_emit_end_set(ctx);
+}
+static int event_begin_map(void* ctx) {
+    return edn_emit_begin_map(ctx);
+}
+static int event_end_map(void* ctx) {
+    return edn_emit_end_map(ctx);
+}
+
+static int event_tag(void* ctx, const char* tag, size_t len) {
+    return emitter_tag(ctx, tag, len);
+}
+
+static const edn_event_handlers_t emitter_event_handlers = {
+    .on_nil = event_nil,
+    .on_bool = event_bool,
+    .on_int = event_int,
+    .on_double = event_double,
+    .on_string = event_string,
+    .on_keyword = event_keyword,
+    .on_symbol = event_symbol,
+    .on_character = event_character,
+    .on_bigint = event_bigint,
+    .on_bigdec = event_bigdec,
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    .on_ratio = event_ratio,
+    .on_bigratio = event_bigratio,
+    .on_meta = event_meta,
+#endif
+    .on_begin_list = event_begin_list,
+    .on_end_list = event_end_list,
+    .on_begin_vector = event_begin_vector,
+    .on_end_vector = event_end_vector,
+    .on_begin_set = event_begin_set,
+    .on_end_set = event_end_set,
+    .on_begin_map = event_begin_map,
+    .on_end_map = event_end_map,
+    .on_tag = event_tag,
+};
+
+const edn_event_handlers_t* edn_emitter_event_handlers(void) {
+    return &emitter_event_handlers;
+}
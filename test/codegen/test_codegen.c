@@ -0,0 +1,85 @@
+/**
+ * Test edn_codegen output for schemas that use only some field types
+ *
+ * minimal.h/.c and subset.h/.c are generated from the schemas next to this
+ * file and compiled with -Wall -Wextra -Werror, so a helper or handler
+ * parameter the schema leaves unused fails the build.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../test_framework.h"
+#include "minimal.h"
+#include "subset.h"
+
+typedef struct {
+    char data[256];
+    size_t length;
+} buffer_t;
+
+static int append(const char* data, size_t length, void* ctx) {
+    buffer_t* buffer = ctx;
+    if (buffer->length + length >= sizeof(buffer->data)) {
+        return -1;
+    }
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+    buffer->data[buffer->length] = '\0';
+    return 0;
+}
+
+TEST(minimal_round_trip) {
+    min_note_t note;
+    edn_result_t r = min_note_decode("{:text \"say \\\"hi\\\"\" :other [1 2]}", 0, &note);
+    assert(r.error == EDN_OK);
+    assert_str_eq(note.text, "say \"hi\"");
+
+    buffer_t buffer = {{0}, 0};
+    edn_emitter_t* emitter = edn_emitter_create(append, &buffer, NULL);
+    assert(emitter != NULL);
+    assert_int_eq(min_note_encode(emitter, &note), 0);
+    assert_int_eq(edn_emitter_finish(emitter), 0);
+    edn_emitter_destroy(emitter);
+    assert_str_eq(buffer.data, "{:text \"say \\\"hi\\\"\"}");
+}
+
+TEST(minimal_rejects_other_types) {
+    min_note_t note;
+    assert(min_note_decode("{:text true}", 0, &note).error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert(min_note_decode("{:text 1.5}", 0, &note).error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert(min_note_decode("{:text :kw}", 0, &note).error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert(min_note_decode("{}", 0, &note).error == EDN_ERROR_SCHEMA_MISMATCH);
+}
+
+TEST(subset_round_trip) {
+    sub_box_t box;
+    edn_result_t r = sub_box_decode("{:on? true :n 3 :tags [{:k :a/b} {:k :c}]}", 0, &box);
+    assert(r.error == EDN_OK);
+    assert(box.on_);
+    assert_int_eq(box.n, 3);
+    assert_int_eq(box.tags_count, 2);
+    assert_str_eq(box.tags[0].k, "a/b");
+    assert_str_eq(box.tags[1].k, "c");
+
+    buffer_t buffer = {{0}, 0};
+    edn_emitter_t* emitter = edn_emitter_create(append, &buffer, NULL);
+    assert(emitter != NULL);
+    assert_int_eq(sub_box_encode(emitter, &box), 0);
+    assert_int_eq(edn_emitter_finish(emitter), 0);
+    edn_emitter_destroy(emitter);
+    assert_str_eq(buffer.data, "{:on? true, :n 3, :tags [{:k :a/b} {:k :c}]}");
+
+    assert(sub_box_decode("{:n \"3\"}", 0, &box).error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert(sub_box_decode("{:n 1.5}", 0, &box).error == EDN_ERROR_SCHEMA_MISMATCH);
+}
+
+int main(void) {
+    printf("Running generated codec tests...\n");
+
+    RUN_TEST(minimal_round_trip);
+    RUN_TEST(minimal_rejects_other_types);
+    RUN_TEST(subset_round_trip);
+
+    TEST_SUMMARY("generated codec");
+}
@@ -0,0 +1,315 @@
+/**
+ * Test arena sizing (input estimates, large-object blocks, huge pages),
+ * memory budgets and memory accounting
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "../src/edn_internal.h"
+#include "test_framework.h"
+
+static size_t chain_length(const arena_block_t* block) {
+    size_t n = 0;
+    for (; block != NULL; block = block->next) {
+        n++;
+    }
+    return n;
+}
+
+TEST(arena_default_sizes) {
+    edn_arena_t* arena = edn_arena_create();
+    assert(arena != NULL);
+    assert(arena->first->capacity == ARENA_INITIAL_SIZE);
+    assert(arena->next_block_size == ARENA_MEDIUM_SIZE);
+    assert(arena->max_block_size == ARENA_LARGE_SIZE);
+    edn_arena_destroy(arena);
+}
+
+TEST(arena_config_for_input) {
+    edn_arena_config_t config;
+
+    edn_arena_config_for_input(&config, 100);
+    assert(config.initial_size == ARENA_INITIAL_SIZE);
+    assert(config.max_block_size == ARENA_LARGE_SIZE);
+    assert(!config.huge_pages);
+
+    edn_arena_config_for_input(&config, 100000);
+    assert(config.initial_size == 100000 * ARENA_INPUT_RATIO);
+    assert(config.max_block_size == ARENA_LARGE_SIZE);
+
+    edn_arena_config_for_input(&config, (size_t) 1 << 30);
+    assert(config.initial_size == ARENA_MAX_INITIAL_SIZE);
+    assert(config.max_block_size == ARENA_MAX_BLOCK_SIZE);
+
+    edn_arena_config_for_input(&config, SIZE_MAX);
+    assert(config.initial_size == ARENA_MAX_INITIAL_SIZE);
+    assert(config.max_block_size == ARENA_MAX_BLOCK_SIZE);
+}
+
+TEST(arena_large_object_keeps_current_block) {
+    edn_arena_t* arena = edn_arena_create();
+    assert(arena != NULL);
+
+    char* a = edn_arena_alloc(arena, 64);
+    char* big = edn_arena_alloc(arena, ARENA_INITIAL_SIZE * 2);
+    char* b = edn_arena_alloc(arena, 64);
+    assert(a != NULL && big != NULL && b != NULL);
+    memset(big, 0xAB, ARENA_INITIAL_SIZE * 2);
+
+    /* The small allocations stay adjacent in the first block */
+    assert(b == a + 64);
+    assert(arena->current == arena->first);
+    assert(chain_length(arena->first) == 1);
+    assert(chain_length(arena->large) == 1);
+    assert(arena->total_allocated >= ARENA_INITIAL_SIZE * 3);
+
+    edn_arena_destroy(arena);
+}
+
+TEST(arena_growth_is_capped) {
+    edn_arena_config_t config = {ARENA_INITIAL_SIZE, 128 * 1024, false, 0};
+    edn_arena_t* arena = edn_arena_create_with(&config);
+    assert(arena != NULL);
+
+    for (int i = 0; i < 10000; i++) {
+        assert(edn_arena_alloc(arena, 1024) != NULL);
+    }
+    for (const arena_block_t* b = arena->first; b != NULL; b = b->next) {
+        assert(b->capacity <= 128 * 1024);
+    }
+    assert(arena->large == NULL);
+    edn_arena_destroy(arena);
+}
+
+TEST(arena_reset_releases_large_objects) {
+    edn_arena_t* arena = edn_arena_create();
+    assert(arena != NULL);
+
+    for (int i = 0; i < 100; i++) {
+        assert(edn_arena_alloc(arena, 4096) != NULL);
+    }
+    assert(edn_arena_alloc(arena, 1024 * 1024) != NULL);
+    assert(arena->large != NULL);
+
+    edn_arena_reset(arena);
+    assert(arena->large == NULL);
+    assert(arena->first->next == NULL);
+    assert(arena->next_block_size == ARENA_MEDIUM_SIZE);
+    assert(arena->total_allocated == arena->first->capacity);
+    assert(edn_arena_alloc(arena, 1024 * 1024) != NULL);
+
+    edn_arena_destroy(arena);
+}
+
+TEST(arena_huge_pages) {
+    /* Works whether or not the platform grants huge pages */
+    edn_arena_config_t config = {ARENA_HUGE_PAGE_SIZE, ARENA_HUGE_PAGE_SIZE * 2, true, 0};
+    edn_arena_t* arena = edn_arena_create_with(&config);
+    assert(arena != NULL);
+    assert(arena->first->capacity >= ARENA_HUGE_PAGE_SIZE);
+
+    char* big = edn_arena_alloc(arena, ARENA_HUGE_PAGE_SIZE * 3);
+    assert(big != NULL);
+    memset(big, 1, ARENA_HUGE_PAGE_SIZE * 3);
+    for (int i = 0; i < 4096; i++) {
+        char* p = edn_arena_alloc(arena, 1024);
+        assert(p != NULL);
+        memset(p, 2, 1024);
+    }
+
+    edn_arena_reset(arena);
+    assert(edn_arena_alloc(arena, 64) != NULL);
+    edn_arena_destroy(arena);
+}
+
+TEST(arena_parse_options) {
+    size_t cap = 256 * 1024;
+    char* input = malloc(cap);
+    assert(input != NULL);
+    size_t pos = (size_t) snprintf(input, cap, "[");
+    for (int i = 0; i < 10000; i++) {
+        pos += (size_t) snprintf(input + pos, cap - pos, "{:n %d} ", i);
+    }
+    pos += (size_t) snprintf(input + pos, cap - pos, "]");
+    size_t estimate = (pos * ARENA_INPUT_RATIO + 7) & ~(size_t) 7;
+
+    /* Estimated from the input length */
+    edn_result_t r = edn_read(input, 0);
+    assert(r.error == EDN_OK);
+    assert(r.value->arena->first->capacity == estimate);
+    size_t estimated_blocks = chain_length(r.value->arena->first);
+    edn_free(r.value);
+
+    edn_parse_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.arena_initial_block = 4096;
+    opts.arena_max_block = 8192;
+    r = edn_read_with_options(input, 0, &opts);
+    assert(r.error == EDN_OK);
+    assert(r.value->arena->first->capacity == 4096);
+    assert(r.value->arena->max_block_size == 8192);
+    assert(chain_length(r.value->arena->first) > estimated_blocks);
+    assert(edn_vector_count(r.value) == 10000);
+    edn_free(r.value);
+
+    opts.arena_huge_pages = true;
+    opts.arena_initial_block = ARENA_HUGE_PAGE_SIZE;
+    r = edn_read_with_options(input, 0, &opts);
+    assert(r.error == EDN_OK);
+    assert(edn_vector_count(r.value) == 10000);
+    edn_free(r.value);
+
+    /* Callers built against the older struct keep the estimate */
+    opts.struct_size = offsetof(edn_parse_options_t, strict_utf8) + sizeof(bool);
+    r = edn_read_with_options(input, 0, &opts);
+    assert(r.error == EDN_OK);
+    assert(r.value->arena->first->capacity == estimate);
+    edn_free(r.value);
+
+    free(input);
+}
+
+static char* numbers_document(int count, size_t* length) {
+    size_t cap = (size_t) count * 16 + 16;
+    char* input = malloc(cap);
+    if (input == NULL) {
+        return NULL;
+    }
+    size_t pos = (size_t) snprintf(input, cap, "[");
+    for (int i = 0; i < count; i++) {
+        pos += (size_t) snprintf(input + pos, cap - pos, "%d ", i);
+    }
+    pos += (size_t) snprintf(input + pos, cap - pos, "]");
+    *length = pos;
+    return input;
+}
+
+TEST(arena_limit) {
+    edn_arena_config_t config = {ARENA_INITIAL_SIZE, 0, false, 100 * 1024};
+    edn_arena_t* arena = edn_arena_create_with(&config);
+    assert(arena != NULL);
+
+    size_t total = 0;
+    while (edn_arena_alloc(arena, 1000) != NULL) {
+        total += 1000;
+        assert(arena->total_allocated <= 100 * 1024);
+    }
+    assert(arena->limit_hit);
+    assert(total > 90 * 1024); /* The last block is shrunk to fit */
+    assert(edn_arena_alloc(arena, 64 * 1024) == NULL);
+
+    edn_arena_reset(arena);
+    assert(!arena->limit_hit);
+    assert(edn_arena_alloc(arena, 1000) != NULL);
+    edn_arena_destroy(arena);
+}
+
+TEST(parse_max_memory) {
+    size_t length;
+    char* input = numbers_document(20000, &length);
+    assert(input != NULL);
+
+    edn_result_t r = edn_read(input, length);
+    assert(r.error == EDN_OK);
+    edn_memory_stats_t stats;
+    assert(edn_value_memory_usage(r.value, &stats));
+    size_t needed = stats.used;
+    edn_free(r.value);
+
+    edn_parse_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.max_memory = needed / 2;
+    r = edn_read_with_options(input, length, &opts);
+    assert(r.error == EDN_ERROR_OUT_OF_MEMORY);
+    assert(r.value == NULL);
+    assert(strcmp(r.error_message, "Memory limit exceeded") == 0);
+    assert(r.error_start.offset > 0 && r.error_start.offset < length);
+
+    /* Reported at the element that did not fit */
+    assert(input[r.error_start.offset - 1] == ' ');
+    assert(r.error_end.offset > r.error_start.offset);
+
+    opts.max_memory = needed * 2;
+    r = edn_read_with_options(input, length, &opts);
+    assert(r.error == EDN_OK);
+    assert(edn_vector_count(r.value) == 20000);
+    assert(edn_value_memory_usage(r.value, &stats));
+    assert(stats.allocated <= needed * 2);
+    edn_free(r.value);
+
+    /* The whole document in one tiny budget */
+    opts.max_memory = 16;
+    r = edn_read_with_options("[1 2 3]", 0, &opts);
+    assert(r.error == EDN_ERROR_OUT_OF_MEMORY);
+    assert(strcmp(r.error_message, "Memory limit exceeded") == 0);
+
+    free(input);
+}
+
+TEST(memory_usage) {
+    size_t length;
+    char* input = numbers_document(50000, &length);
+    assert(input != NULL);
+    edn_result_t r = edn_read(input, length);
+    assert(r.error == EDN_OK);
+
+    edn_memory_stats_t stats;
+    assert(edn_value_memory_usage(r.value, &stats));
+    assert(stats.allocated == stats.used + stats.wasted + stats.available);
+    assert(stats.allocated == r.value->arena->total_allocated);
+    assert(stats.blocks >= 1);
+    assert(stats.used >= 50000 * sizeof(edn_value_t));
+
+    /* Any value of the document reports the same totals */
+    edn_memory_stats_t child;
+    assert(edn_value_memory_usage(edn_vector_get(r.value, 123), &child));
+    assert(memcmp(&stats, &child, sizeof(stats)) == 0);
+
+    size_t count = edn_value_memory_blocks(r.value, NULL, 0);
+    assert(count == stats.blocks);
+    edn_memory_block_t* blocks = calloc(count, sizeof(*blocks));
+    assert(blocks != NULL);
+    assert(edn_value_memory_blocks(r.value, blocks, count) == count);
+    size_t allocated = 0, used = 0, large = 0, current = 0;
+    for (size_t i = 0; i < count; i++) {
+        allocated += blocks[i].allocated;
+        used += blocks[i].used;
+        large += blocks[i].large;
+        current += blocks[i].current;
+        assert(blocks[i].used <= blocks[i].allocated);
+    }
+    assert(allocated == stats.allocated && used == stats.used);
+    assert(large == stats.large_blocks);
+    assert(current == 1);
+    free(blocks);
+    edn_free(r.value);
+
+    /* The vector's element array is a large-object block */
+    assert(stats.large_blocks == 1);
+
+    assert(!edn_value_memory_usage(NULL, &stats));
+    assert(stats.allocated == 0 && stats.blocks == 0);
+    assert(edn_value_memory_blocks(NULL, NULL, 0) == 0);
+    assert(!edn_value_memory_usage(NULL, NULL));
+
+    free(input);
+}
+
+int main(void) {
+    printf("Running arena tests...\n");
+
+    RUN_TEST(arena_default_sizes);
+    RUN_TEST(arena_config_for_input);
+    RUN_TEST(arena_large_object_keeps_current_block);
+    RUN_TEST(arena_growth_is_capped);
+    RUN_TEST(arena_reset_releases_large_objects);
+    RUN_TEST(arena_huge_pages);
+    RUN_TEST(arena_parse_options);
+    RUN_TEST(arena_limit);
+    RUN_TEST(parse_max_memory);
+    RUN_TEST(memory_usage);
+
+    TEST_SUMMARY("arena");
+}
@@ -0,0 +1,334 @@
+/**
+ * Test cancellation flags, deadlines and yield hooks (edn_budget_t)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "test_framework.h"
+
+static char* numbers_document(int count, size_t* length) {
+    size_t cap = (size_t) count * 16 + 16;
+    char* input = malloc(cap);
+    if (input == NULL) {
+        return NULL;
+    }
+    size_t pos = (size_t) snprintf(input, cap, "[");
+    for (int i = 0; i < count; i++) {
+        pos += (size_t) snprintf(input + pos, cap - pos, "{:n %d} ", i);
+    }
+    pos += (size_t) snprintf(input + pos, cap - pos, "]");
+    *length = pos;
+    return input;
+}
+
+typedef struct {
+    size_t calls;
+    size_t last_progress;
+    bool monotonic;
+    size_t cancel_after; /* 0 = never */
+    volatile int* flag;  /* Set instead of returning non-zero, when non-NULL */
+} yield_log_t;
+
+static int record_yield(size_t progress, void* ctx) {
+    yield_log_t* log = ctx;
+    if (log->calls > 0 && progress <= log->last_progress) {
+        log->monotonic = false;
+    }
+    log->calls++;
+    log->last_progress = progress;
+    if (log->cancel_after != 0 && log->calls >= log->cancel_after) {
+        if (log->flag != NULL) {
+            *log->flag = 1;
+            return 0;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static edn_parse_options_t budget_options(const edn_budget_t* budget) {
+    edn_parse_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.budget = budget;
+    return opts;
+}
+
+TEST(parse_unbounded_budget) {
+    size_t length;
+    char* input = numbers_document(1000, &length);
+    assert(input != NULL);
+
+    edn_budget_t budget = {0};
+    edn_parse_options_t opts = budget_options(&budget);
+    edn_result_t r = edn_read_with_options(input, length, &opts);
+    assert(r.error == EDN_OK);
+    assert(edn_vector_count(r.value) == 1000);
+    edn_free(r.value);
+
+    budget.deadline_ns = edn_monotonic_ns() + 60ull * 1000000000ull;
+    r = edn_read_with_options(input, length, &opts);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+    free(input);
+}
+
+TEST(parse_cancel_flag) {
+    volatile int cancel = 1;
+    edn_budget_t budget = {0};
+    budget.cancel = &cancel;
+    edn_parse_options_t opts = budget_options(&budget);
+
+    edn_result_t r = edn_read_with_options("[1 2 {:a 3}]", 0, &opts);
+    assert(r.error == EDN_ERROR_CANCELLED);
+    assert(r.value == NULL);
+    assert(strcmp(r.error_message, "Parse cancelled") == 0);
+
+    /* Scalars are never interrupted */
+    r = edn_read_with_options("42", 0, &opts);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+
+    cancel = 0;
+    r = edn_read_with_options("[1 2 {:a 3}]", 0, &opts);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+}
+
+TEST(parse_deadline_exceeded) {
+    edn_budget_t budget = {0};
+    budget.deadline_ns = 1; /* Long past */
+    edn_parse_options_t opts = budget_options(&budget);
+
+    edn_result_t r = edn_read_with_options("{:a [1 2]}", 0, &opts);
+    assert(r.error == EDN_ERROR_DEADLINE_EXCEEDED);
+    assert(strcmp(r.error_message, "Parse deadline exceeded") == 0);
+    assert(r.value == NULL);
+}
+
+TEST(parse_yield_slices) {
+    size_t length;
+    char* input = numbers_document(20000, &length);
+    assert(input != NULL);
+
+    yield_log_t log = {0};
+    log.monotonic = true;
+    edn_budget_t budget = {0};
+    budget.slice_bytes = 4096;
+    budget.yield = record_yield;
+    budget.yield_ctx = &log;
+    edn_parse_options_t opts = budget_options(&budget);
+
+    edn_result_t r = edn_read_with_options(input, length, &opts);
+    assert(r.error == EDN_OK);
+    assert(edn_vector_count(r.value) == 20000);
+    assert(log.monotonic);
+    assert(log.calls >= length / 4096 && log.calls <= length / 4096 + 2);
+    edn_free(r.value);
+
+    /* Default slice */
+    memset(&log, 0, sizeof(log));
+    budget.slice_bytes = 0;
+    r = edn_read_with_options(input, length, &opts);
+    assert(r.error == EDN_OK);
+    assert(log.calls >= length / (64 * 1024) && log.calls <= length / (64 * 1024) + 2);
+    edn_free(r.value);
+    free(input);
+}
+
+TEST(parse_yield_cancels) {
+    size_t length;
+    char* input = numbers_document(20000, &length);
+    assert(input != NULL);
+
+    yield_log_t log = {0};
+    log.cancel_after = 3;
+    edn_budget_t budget = {0};
+    budget.slice_bytes = 1024;
+    budget.yield = record_yield;
+    budget.yield_ctx = &log;
+    edn_parse_options_t opts = budget_options(&budget);
+
+    edn_result_t r = edn_read_with_options(input, length, &opts);
+    assert(r.error == EDN_ERROR_CANCELLED);
+    assert(log.calls == 3);
+    assert(r.error_start.offset == log.last_progress);
+    assert(r.error_start.offset >= 2048 && r.error_start.offset < 4096);
+
+    /* A flag raised while parsing is seen at the next check */
+    volatile int cancel = 0;
+    memset(&log, 0, sizeof(log));
+    log.cancel_after = 5;
+    log.flag = &cancel;
+    budget.cancel = &cancel;
+    r = edn_read_with_options(input, length, &opts);
+    assert(r.error == EDN_ERROR_CANCELLED);
+    assert(log.calls == 5);
+    assert(r.error_start.offset > log.last_progress);
+    free(input);
+}
+
+TEST(parse_budget_older_struct) {
+    volatile int cancel = 1;
+    edn_budget_t budget = {0};
+    budget.cancel = &cancel;
+    edn_parse_options_t opts = budget_options(&budget);
+    opts.struct_size = offsetof(edn_parse_options_t, budget);
+
+    edn_result_t r = edn_read_with_options("[1 2 3]", 0, &opts);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+}
+
+TEST(write_cancel_and_deadline) {
+    edn_result_t r = edn_read("[1 [2 3] {:a #{4}}]", 0);
+    assert(r.error == EDN_OK);
+
+    volatile int cancel = 1;
+    edn_budget_t budget = {0};
+    budget.cancel = &cancel;
+    edn_write_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.budget = &budget;
+
+    size_t len = 0;
+    assert(edn_write_string(r.value, &opts, &len) == NULL);
+    FILE* devnull = tmpfile();
+    assert(devnull != NULL);
+    assert(edn_write_file(r.value, devnull, &opts) == -EDN_ERROR_CANCELLED);
+
+    cancel = 0;
+    budget.deadline_ns = 1;
+    assert(edn_write_file(r.value, devnull, &opts) == -EDN_ERROR_DEADLINE_EXCEEDED);
+    fclose(devnull);
+
+    budget.deadline_ns = 0;
+    char* out = edn_write_string(r.value, &opts, &len);
+    assert(out != NULL);
+    assert(strcmp(out, "[1 [2 3] {:a #{4}}]") == 0);
+    free(out);
+    edn_free(r.value);
+}
+
+TEST(write_yield_slices) {
+    size_t length;
+    char* input = numbers_document(5000, &length);
+    assert(input != NULL);
+    edn_result_t r = edn_read(input, length);
+    assert(r.error == EDN_OK);
+    char* expected = edn_write(r.value);
+    assert(expected != NULL);
+
+    yield_log_t log = {0};
+    log.monotonic = true;
+    edn_budget_t budget = {0};
+    budget.slice_bytes = 1000;
+    budget.yield = record_yield;
+    budget.yield_ctx = &log;
+    edn_write_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.budget = &budget;
+    opts.sort_unordered = true;
+
+    size_t len = 0;
+    char* out = edn_write_string(r.value, &opts, &len);
+    assert(out != NULL);
+    assert(strcmp(out, expected) == 0);
+    assert(log.monotonic);
+    assert(log.calls >= len / 1000 && log.calls <= len / 1000 + 2);
+    free(out);
+
+    memset(&log, 0, sizeof(log));
+    log.cancel_after = 2;
+    assert(edn_write_string(r.value, &opts, &len) == NULL);
+    assert(log.calls == 2);
+
+    /* Callers built against the struct without `budget` */
+    opts.struct_size = offsetof(edn_write_options_t, budget);
+    out = edn_write_string(r.value, &opts, &len);
+    assert(out != NULL);
+    assert(strcmp(out, expected) == 0);
+    free(out);
+
+    free(expected);
+    edn_free(r.value);
+    free(input);
+}
+
+static int discard_output(const char* data, size_t n, void* ctx) {
+    (void) data;
+    *(size_t*) ctx += n;
+    return 0;
+}
+
+TEST(emitter_budget) {
+    volatile int cancel = 0;
+    yield_log_t log = {0};
+    log.monotonic = true;
+    edn_budget_t budget = {0};
+    budget.cancel = &cancel;
+    budget.slice_bytes = 100;
+    budget.yield = record_yield;
+    budget.yield_ctx = &log;
+    edn_write_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.budget = &budget;
+
+    size_t written = 0;
+    edn_emitter_t* em = edn_emitter_create(discard_output, &written, &opts);
+    assert(em != NULL);
+    assert(edn_emit_begin_vector(em) == 0);
+    for (int i = 0; i < 1000; i++) {
+        assert(edn_emit_int(em, 1000000 + i) == 0);
+    }
+    assert(edn_emit_end_vector(em) == 0);
+    assert(edn_emitter_finish(em) == 0);
+    edn_emitter_destroy(em);
+    assert(log.monotonic);
+    /* Checks land on the first element boundary past each slice (8 bytes apart) */
+    assert(log.calls >= written / 108 && log.calls <= written / 100 + 1);
+
+    /* A stop poisons the emitter; elements before it were delivered */
+    budget.slice_bytes = 1;
+    em = edn_emitter_create(discard_output, &written, &opts);
+    assert(em != NULL);
+    assert(edn_emit_begin_vector(em) == 0);
+    assert(edn_emit_int(em, 1) == 0);
+    cancel = 1;
+    assert(edn_emit_int(em, 2) == -EDN_ERROR_CANCELLED);
+    assert(edn_emit_int(em, 3) == -EDN_ERROR_INVALID_STATE);
+    assert(edn_emitter_finish(em) == -EDN_ERROR_INVALID_STATE);
+    edn_emitter_destroy(em);
+
+    cancel = 0;
+    budget.deadline_ns = 1;
+    em = edn_emitter_create(discard_output, &written, &opts);
+    assert(em != NULL);
+    assert(edn_emit_begin_map(em) == 0);
+    assert(edn_emit_keyword(em, "a") == -EDN_ERROR_DEADLINE_EXCEEDED);
+    edn_emitter_destroy(em);
+
+    /* A top-level scalar has no element boundary to stop at */
+    em = edn_emitter_create(discard_output, &written, &opts);
+    assert(em != NULL);
+    assert(edn_emit_int(em, 1) == 0);
+    assert(edn_emitter_finish(em) == 0);
+    edn_emitter_destroy(em);
+}
+
+int main(void) {
+    printf("Running budget tests...\n");
+
+    RUN_TEST(parse_unbounded_budget);
+    RUN_TEST(parse_cancel_flag);
+    RUN_TEST(parse_deadline_exceeded);
+    RUN_TEST(parse_yield_slices);
+    RUN_TEST(parse_yield_cancels);
+    RUN_TEST(parse_budget_older_struct);
+    RUN_TEST(write_cancel_and_deadline);
+    RUN_TEST(write_yield_slices);
+    RUN_TEST(emitter_budget);
+
+    TEST_SUMMARY("budget");
+}
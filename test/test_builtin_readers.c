@@ -0,0 +1,276 @@
+/**
+ * Test built-in #inst and #uuid readers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "test_framework.h"
+
+static int64_t inst_ns(const char* input) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_builtins(registry);
+    edn_result_t r = read_with(input, registry, false);
+    int64_t ns = INT64_MIN;
+    if (r.error == EDN_OK) {
+        edn_inst_get(r.value, &ns, NULL);
+        edn_free(r.value);
+    }
+    edn_reader_registry_destroy(registry);
+    return ns;
+}
+
+static edn_error_t read_error(const char* input) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_builtins(registry);
+    edn_result_t r = read_with(input, registry, false);
+    edn_free(r.value);
+    edn_reader_registry_destroy(registry);
+    return r.error;
+}
+
+TEST(register_builtins) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    assert(edn_reader_register_builtins(registry));
+    assert(edn_reader_lookup(registry, "inst") == edn_inst_reader);
+    assert(edn_reader_lookup(registry, "uuid") == edn_uuid_reader);
+    edn_reader_registry_destroy(registry);
+
+    assert_false(edn_reader_register_builtins(NULL));
+}
+
+TEST(inst_full_timestamp) {
+    assert(inst_ns("#inst \"1970-01-01T00:00:00Z\"") == 0);
+    assert(inst_ns("#inst \"1970-01-01T00:00:01Z\"") == 1000000000LL);
+    assert(inst_ns("#inst \"2024-02-29T12:34:56Z\"") == 1709210096LL * 1000000000LL);
+}
+
+TEST(inst_fraction) {
+    assert(inst_ns("#inst \"1970-01-01T00:00:00.5Z\"") == 500000000LL);
+    assert(inst_ns("#inst \"1970-01-01T00:00:00.123Z\"") == 123000000LL);
+    assert(inst_ns("#inst \"1970-01-01T00:00:00.123456789Z\"") == 123456789LL);
+    assert(read_error("#inst \"1970-01-01T00:00:00.Z\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"1970-01-01T00:00:00.1234567890Z\"") == EDN_ERROR_INVALID_SYNTAX);
+}
+
+TEST(inst_offset) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_builtins(registry);
+
+    edn_result_t r = read_with("#inst \"1970-01-01T01:00:00+01:00\"", registry, false);
+    assert(r.error == EDN_OK);
+    int64_t ns;
+    int32_t offset;
+    assert(edn_inst_get(r.value, &ns, &offset));
+    assert(ns == 0);
+    assert_int_eq(offset, 60);
+    edn_free(r.value);
+
+    r = read_with("#inst \"1969-12-31T19:30:00-04:30\"", registry, false);
+    assert(r.error == EDN_OK);
+    assert(edn_inst_get(r.value, &ns, &offset));
+    assert(ns == 0);
+    assert_int_eq(offset, -270);
+    edn_free(r.value);
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(inst_truncated_forms) {
+    assert(inst_ns("#inst \"1970\"") == 0);
+    assert(inst_ns("#inst \"1970-02\"") == 31LL * 86400 * 1000000000LL);
+    assert(inst_ns("#inst \"1970-01-02\"") == 86400LL * 1000000000LL);
+    assert(inst_ns("#inst \"1970-01-01T01\"") == 3600LL * 1000000000LL);
+    assert(inst_ns("#inst \"1970-01-01T00:01\"") == 60LL * 1000000000LL);
+}
+
+TEST(inst_pre_epoch) {
+    assert(inst_ns("#inst \"1969-12-31T23:59:59Z\"") == -1000000000LL);
+    assert(inst_ns("#inst \"1900-01-01T00:00:00Z\"") == -2208988800LL * 1000000000LL);
+}
+
+TEST(inst_invalid) {
+    assert(read_error("#inst \"2023-02-29T00:00:00Z\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"2023-13-01T00:00:00Z\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"2023-00-01\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"2023-01-01T24:00:00Z\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"2023-01-01T00:60:00Z\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"2023-01-01T00:00:60Z\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"2023-01-01T00:00:00+25:00\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"2023-01-01T00:00:00Zjunk\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"2023/01/01\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"20x3-01-01T00:00:00Z\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst 42") == EDN_ERROR_INVALID_SYNTAX);
+    /* Beyond int64 nanoseconds */
+    assert(read_error("#inst \"2300-01-01T00:00:00Z\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#inst \"1600-01-01T00:00:00Z\"") == EDN_ERROR_INVALID_SYNTAX);
+}
+
+TEST(uuid_parse) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_builtins(registry);
+
+    edn_result_t r = read_with("#uuid \"f81d4fae-7dec-11d0-A765-00a0c91e6bf6\"", registry, false);
+    assert(r.error == EDN_OK);
+    assert(edn_type(r.value) == EDN_TYPE_EXTERNAL);
+    assert(edn_external_is_type(r.value, EDN_EXTERNAL_TYPE_UUID));
+
+    uint8_t bytes[16];
+    const uint8_t expected[16] = {0xf8, 0x1d, 0x4f, 0xae, 0x7d, 0xec, 0x11, 0xd0,
+                                  0xa7, 0x65, 0x00, 0xa0, 0xc9, 0x1e, 0x6b, 0xf6};
+    assert(edn_uuid_get(r.value, bytes));
+    assert(memcmp(bytes, expected, 16) == 0);
+    assert_false(edn_inst_get(r.value, NULL, NULL));
+    edn_free(r.value);
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(uuid_invalid) {
+    assert(read_error("#uuid \"f81d4fae-7dec-11d0-a765-00a0c91e6bf\"") == EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#uuid \"f81d4fae7dec-11d0-a765-00a0c91e6bf6a\"") ==
+           EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#uuid \"g81d4fae-7dec-11d0-a765-00a0c91e6bf6\"") ==
+           EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#uuid \"f81d4fae-7dec-11d0-a765-00a0c91e6bf:\"") ==
+           EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#uuid \"f81d4fae-7d@c-11d0-a765-00a0c91e6bf6\"") ==
+           EDN_ERROR_INVALID_SYNTAX);
+    assert(read_error("#uuid 1") == EDN_ERROR_INVALID_SYNTAX);
+}
+
+TEST(builtin_equality) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_builtins(registry);
+
+    /* Same instant written with different offsets is one element */
+    edn_result_t r = read_with("#{#inst \"2020-01-01T00:00:00Z\" "
+                               "#inst \"2020-01-01T02:00:00.000+02:00\"}",
+                               registry, false);
+    assert(r.error == EDN_ERROR_DUPLICATE_ELEMENT);
+
+    r = read_with("#{#uuid \"00000000-0000-0000-0000-000000000001\" "
+                  "#uuid \"00000000-0000-0000-0000-000000000001\"}",
+                  registry, false);
+    assert(r.error == EDN_ERROR_DUPLICATE_ELEMENT);
+
+    r = read_with("#{#uuid \"00000000-0000-0000-0000-000000000001\" "
+                  "#uuid \"00000000-0000-0000-0000-000000000002\" "
+                  "#inst \"2020-01-01\"}",
+                  registry, false);
+    assert(r.error == EDN_OK);
+    assert_int_eq(edn_set_count(r.value), 3);
+
+    edn_result_t probe =
+        read_with("#uuid \"00000000-0000-0000-0000-000000000002\"", registry, false);
+    assert(edn_set_contains(r.value, probe.value));
+    edn_free(probe.value);
+    edn_free(r.value);
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(builtin_round_trip) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_builtins(registry);
+
+    const char* cases[][2] = {
+        {"#inst \"2024-02-29T12:34:56Z\"", "#inst \"2024-02-29T12:34:56Z\""},
+        {"#inst \"2024-02-29T12:34:56.250Z\"", "#inst \"2024-02-29T12:34:56.250Z\""},
+        {"#inst \"2024-02-29T12:34:56.000000001-05:00\"",
+         "#inst \"2024-02-29T12:34:56.000000001-05:00\""},
+        {"#inst \"1969-07-20\"", "#inst \"1969-07-20T00:00:00Z\""},
+        {"#uuid \"F81D4FAE-7DEC-11D0-A765-00A0C91E6BF6\"",
+         "#uuid \"f81d4fae-7dec-11d0-a765-00a0c91e6bf6\""},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        edn_result_t r = read_with(cases[i][0], registry, false);
+        assert(r.error == EDN_OK);
+        char* out = edn_write_string(r.value, NULL, NULL);
+        assert(out != NULL);
+        assert_str_eq(out, cases[i][1]);
+        free(out);
+        edn_free(r.value);
+    }
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(uuid_write_round_trip) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_builtins(registry);
+
+    /* Written UUIDs read back to the same bytes, also inside collections */
+    edn_result_t r = read_with("[#uuid \"00000000-0000-0000-0000-000000000000\" "
+                               "#uuid \"FFFFFFFF-FFFF-FFFF-FFFF-FFFFFFFFFFFF\" "
+                               "{:id #uuid \"f81d4fae-7dec-11d0-a765-00a0c91e6bf6\"}]",
+                               registry, false);
+    assert(r.error == EDN_OK);
+    char* out = edn_write_string(r.value, NULL, NULL);
+    assert(out != NULL);
+    assert_str_eq(out, "[#uuid \"00000000-0000-0000-0000-000000000000\" "
+                       "#uuid \"ffffffff-ffff-ffff-ffff-ffffffffffff\" "
+                       "{:id #uuid \"f81d4fae-7dec-11d0-a765-00a0c91e6bf6\"}]");
+
+    edn_result_t again = read_with(out, registry, false);
+    assert(again.error == EDN_OK);
+    uint8_t before[16], after[16];
+    for (size_t i = 0; i < 2; i++) {
+        assert(edn_uuid_get(edn_vector_get(r.value, i), before));
+        assert(edn_uuid_get(edn_vector_get(again.value, i), after));
+        assert(memcmp(before, after, 16) == 0);
+    }
+    char* rewritten = edn_write_string(again.value, NULL, NULL);
+    assert(rewritten != NULL);
+    assert_str_eq(rewritten, out);
+
+    free(rewritten);
+    free(out);
+    edn_free(again.value);
+    edn_free(r.value);
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(builtin_escaped_string) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_builtins(registry);
+
+    /* The reader must see the decoded payload, not the raw escape */
+    edn_result_t r = read_with("#inst \"2020-01-01\\n\"", registry, false);
+    assert(r.error == EDN_ERROR_INVALID_SYNTAX);
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    /* \u0030 is '0' */
+    r = read_with("#inst \"197\\u0030-01-01T00:00:00Z\"", registry, false);
+    assert(r.error == EDN_OK);
+    int64_t ns = -1;
+    assert(edn_inst_get(r.value, &ns, NULL));
+    assert(ns == 0);
+    edn_free(r.value);
+#endif
+
+    edn_reader_registry_destroy(registry);
+}
+
+int main(void) {
+    printf("Running built-in reader tests...\n");
+
+    RUN_TEST(register_builtins);
+    RUN_TEST(inst_full_timestamp);
+    RUN_TEST(inst_fraction);
+    RUN_TEST(inst_offset);
+    RUN_TEST(inst_truncated_forms);
+    RUN_TEST(inst_pre_epoch);
+    RUN_TEST(inst_invalid);
+    RUN_TEST(uuid_parse);
+    RUN_TEST(uuid_invalid);
+    RUN_TEST(builtin_equality);
+    RUN_TEST(builtin_round_trip);
+    RUN_TEST(uuid_write_round_trip);
+    RUN_TEST(builtin_escaped_string);
+
+    TEST_SUMMARY("built-in reader");
+}
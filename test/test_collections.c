@@ -2,6 +2,7 @@
  * Test comprehensive collection examples
  */
 
+#include <stdio.h>
 #include <string.h>
 
 #include "../include/edn.h"
@@ -214,6 +215,51 @@ TEST(parse_mixed_nesting) {
     edn_free(result.value);
 }
 
+/* Large siblings interleaved with nested collections: every level shares the
+ * parser's child stack, so inner collections must not disturb outer ones. */
+TEST(parse_large_interleaved_collections) {
+    static char input[65536];
+    size_t pos = 0;
+    pos += (size_t) snprintf(input + pos, sizeof(input) - pos, "[");
+    for (int i = 0; i < 300; i++) {
+        pos += (size_t) snprintf(input + pos, sizeof(input) - pos, "%d {:k %d :v [%d %d %d]} ", i,
+                                 i, i, i + 1, i + 2);
+    }
+    pos += (size_t) snprintf(input + pos, sizeof(input) - pos, "#_ [1 2 3 4 5 6 7 8 9] 300]");
+
+    edn_result_t result = edn_read(input, pos);
+    assert(result.error == EDN_OK);
+    assert(edn_vector_count(result.value) == 601);
+
+    for (int i = 0; i < 300; i++) {
+        int64_t n;
+        assert(edn_int64_get(edn_vector_get(result.value, 2 * i), &n) && n == i);
+        edn_value_t* map = edn_vector_get(result.value, 2 * i + 1);
+        assert(edn_map_count(map) == 2);
+        assert(edn_int64_get(edn_map_get_keyword(map, "k"), &n) && n == i);
+        edn_value_t* vec = edn_map_get_keyword(map, "v");
+        assert(edn_vector_count(vec) == 3);
+        assert(edn_int64_get(edn_vector_get(vec, 2), &n) && n == i + 2);
+    }
+    int64_t last;
+    assert(edn_int64_get(edn_vector_get(result.value, 600), &last) && last == 300);
+
+    edn_free(result.value);
+}
+
+/* A failing inner collection leaves no state behind for the next parse */
+TEST(parse_error_inside_nested_collection) {
+    edn_result_t bad = edn_read("[1 2 {:a [3 4 5) :b 6}]", 0);
+    assert(bad.error == EDN_ERROR_UNMATCHED_DELIMITER);
+    assert(bad.value == NULL);
+
+    edn_result_t good = edn_read("[1 2 {:a [3 4 5] :b 6}]", 0);
+    assert(good.error == EDN_OK);
+    assert(edn_vector_count(good.value) == 3);
+    assert(edn_map_count(edn_vector_get(good.value, 2)) == 2);
+    edn_free(good.value);
+}
+
 int main(void) {
     printf("Running collection integration tests...\n");
 
@@ -226,6 +272,8 @@ int main(void) {
     RUN_TEST(parse_config_example);
     RUN_TEST(parse_deep_nesting);
     RUN_TEST(parse_mixed_nesting);
+    RUN_TEST(parse_large_interleaved_collections);
+    RUN_TEST(parse_error_inside_nested_collection);
 
     TEST_SUMMARY("collection integration");
 }
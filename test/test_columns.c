@@ -0,0 +1,238 @@
+/**
+ * Test columnar conversion (edn_to_columns)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "test_framework.h"
+
+/* Text of entry `n` of a string column or keyword dictionary */
+static bool text_is(const edn_column_t* column, size_t n, const char* expected) {
+    size_t length = (size_t) (column->offsets[n + 1] - column->offsets[n]);
+    return length == strlen(expected) &&
+           memcmp(column->data + column->offsets[n], expected, length) == 0;
+}
+
+TEST(columns_basic_types) {
+    edn_result_t r = edn_read("[{:id 1 :name \"a\" :score 1.5 :ok true :kind :x}"
+                              " {:id 2 :name \"bee\" :score 2 :ok false :kind :y}"
+                              " {:id 3 :name \"\" :score -0.5 :ok true :kind :x}]",
+                              0);
+    assert(r.error == EDN_OK);
+
+    edn_columns_t* columns = NULL;
+    edn_result_t c = edn_to_columns(r.value, NULL, &columns);
+    assert(c.error == EDN_OK && c.value == NULL && columns != NULL);
+    assert(edn_columns_row_count(columns) == 3);
+    assert(edn_columns_count(columns) == 5);
+
+    /* Columns in first-seen order */
+    const char* names[] = {"id", "name", "score", "ok", "kind"};
+    for (size_t i = 0; i < 5; i++) {
+        assert(strcmp(edn_columns_get(columns, i)->name, names[i]) == 0);
+    }
+    assert(edn_columns_get(columns, 5) == NULL);
+
+    const edn_column_t* id = edn_columns_find(columns, "id");
+    assert(id->type == EDN_COLUMN_INT64 && id->null_count == 0 && id->validity == NULL);
+    assert(id->int64_values[0] == 1 && id->int64_values[2] == 3);
+
+    const edn_column_t* name = edn_columns_find(columns, "name");
+    assert(name->type == EDN_COLUMN_STRING);
+    assert(name->offsets[0] == 0 && name->offsets[3] == 4);
+    assert(text_is(name, 0, "a") && text_is(name, 1, "bee") && text_is(name, 2, ""));
+
+    /* Integers mixed with floats make a double column */
+    const edn_column_t* score = edn_columns_find(columns, "score");
+    assert(score->type == EDN_COLUMN_DOUBLE);
+    assert(score->double_values[0] == 1.5 && score->double_values[1] == 2.0);
+    assert(score->double_values[2] == -0.5);
+
+    const edn_column_t* ok = edn_columns_find(columns, "ok");
+    assert(ok->type == EDN_COLUMN_BOOL && ok->bits[0] == 0x5);
+
+    const edn_column_t* kind = edn_columns_find(columns, "kind");
+    assert(kind->type == EDN_COLUMN_KEYWORD && kind->dictionary_size == 2);
+    assert(text_is(kind, 0, "x") && text_is(kind, 1, "y"));
+    assert(kind->indices[0] == 0 && kind->indices[1] == 1 && kind->indices[2] == 0);
+
+    assert(edn_columns_find(columns, "missing") == NULL);
+    edn_columns_free(columns);
+    edn_free(r.value);
+}
+
+TEST(columns_nulls) {
+    edn_result_t r = edn_read("({:a 1 :b \"x\" :c nil}"
+                              " {:b nil}"
+                              " {:a 3 :b \"yz\" :c nil :d :k}"
+                              " {}"
+                              " {:a nil :b \"w\"})",
+                              0);
+    assert(r.error == EDN_OK);
+
+    edn_columns_t* columns;
+    assert(edn_to_columns(r.value, NULL, &columns).error == EDN_OK);
+    assert(edn_columns_row_count(columns) == 5);
+
+    const edn_column_t* a = edn_columns_find(columns, "a");
+    assert(a->type == EDN_COLUMN_INT64 && a->null_count == 3);
+    assert(a->validity != NULL && a->validity[0] == 0x5);
+    assert(edn_column_is_valid(a, 0) && !edn_column_is_valid(a, 1));
+    assert(edn_column_is_valid(a, 2) && !edn_column_is_valid(a, 4));
+    assert(a->int64_values[1] == 0 && a->int64_values[2] == 3);
+
+    /* Null strings are empty slices between their neighbours */
+    const edn_column_t* b = edn_columns_find(columns, "b");
+    assert(b->type == EDN_COLUMN_STRING && b->null_count == 2);
+    assert(text_is(b, 0, "x") && text_is(b, 1, "") && text_is(b, 2, "yz"));
+    assert(text_is(b, 3, "") && text_is(b, 4, "w"));
+    assert(b->offsets[5] == 4);
+
+    const edn_column_t* c = edn_columns_find(columns, "c");
+    assert(c->type == EDN_COLUMN_NULL && c->null_count == 5 && !edn_column_is_valid(c, 0));
+
+    const edn_column_t* d = edn_columns_find(columns, "d");
+    assert(d->type == EDN_COLUMN_KEYWORD && d->null_count == 4 && d->indices[2] == 0);
+
+    edn_columns_free(columns);
+    edn_free(r.value);
+
+    /* No rows */
+    r = edn_read("[]", 0);
+    assert(edn_to_columns(r.value, NULL, &columns).error == EDN_OK);
+    assert(edn_columns_row_count(columns) == 0 && edn_columns_count(columns) == 0);
+    edn_columns_free(columns);
+    edn_free(r.value);
+}
+
+TEST(columns_selected_keys) {
+    edn_result_t r = edn_read("[{:user/id 1 :id \"one\" :tags [1 2] \"str\" 5}"
+                              " {:user/id 2 :id \"two\" :tags [] :extra 1}]",
+                              0);
+    assert(r.error == EDN_OK);
+
+    /* :tags holds vectors, which no column type can store */
+    edn_columns_t* columns;
+    edn_result_t c = edn_to_columns(r.value, NULL, &columns);
+    assert(c.error == EDN_ERROR_SCHEMA_MISMATCH && columns == NULL);
+    assert(c.error_start.offset == 29 && c.error_end.offset == 34);
+
+    const char* keys[] = {"user/id", "absent", "id"};
+    edn_columns_options_t options = {0};
+    options.struct_size = sizeof(options);
+    options.keys = keys;
+    options.key_count = 3;
+    c = edn_to_columns(r.value, &options, &columns);
+    assert(c.error == EDN_OK);
+    assert(edn_columns_count(columns) == 3);
+    assert(strcmp(edn_columns_get(columns, 0)->name, "user/id") == 0);
+    assert(edn_columns_get(columns, 0)->int64_values[1] == 2);
+    assert(edn_columns_get(columns, 1)->type == EDN_COLUMN_NULL);
+    assert(text_is(edn_columns_get(columns, 2), 1, "two"));
+    edn_columns_free(columns);
+
+    const char* twice[] = {"id", "id"};
+    options.keys = twice;
+    options.key_count = 2;
+    assert(edn_to_columns(r.value, &options, &columns).error == EDN_ERROR_INVALID_ARGUMENT);
+    edn_free(r.value);
+}
+
+TEST(columns_errors) {
+    edn_columns_t* columns = NULL;
+    edn_result_t r = edn_read("[{:a 1} {:a \"x\"}]", 0);
+    edn_result_t c = edn_to_columns(r.value, NULL, &columns);
+    assert(c.error == EDN_ERROR_SCHEMA_MISMATCH && columns == NULL);
+    assert(c.error_start.offset == 12);
+    edn_free(r.value);
+
+    r = edn_read("[{:a 1} [:not :a :map]]", 0);
+    c = edn_to_columns(r.value, NULL, &columns);
+    assert(c.error == EDN_ERROR_INVALID_ARGUMENT && c.error_start.offset == 8);
+    edn_free(r.value);
+
+    r = edn_read("{:a 1}", 0);
+    assert(edn_to_columns(r.value, NULL, &columns).error == EDN_ERROR_INVALID_ARGUMENT);
+    edn_free(r.value);
+    assert(edn_to_columns(NULL, NULL, &columns).error == EDN_ERROR_INVALID_ARGUMENT);
+
+    /* Tags are transparent */
+    r = edn_read("[{:at #inst \"2024-01-01T00:00:00Z\"} {:at #my/tag \"later\"}]", 0);
+    assert(r.error == EDN_OK);
+    c = edn_to_columns(r.value, NULL, &columns);
+    assert(c.error == EDN_OK);
+    const edn_column_t* at = edn_columns_find(columns, "at");
+    assert(at->type == EDN_COLUMN_STRING && text_is(at, 1, "later"));
+    edn_columns_free(columns);
+    edn_free(r.value);
+
+    assert(edn_columns_count(NULL) == 0 && edn_columns_get(NULL, 0) == NULL);
+    edn_columns_free(NULL);
+}
+
+TEST(columns_many_rows) {
+    const int rows = 20000;
+    size_t cap = (size_t) rows * 96 + 16;
+    char* text = malloc(cap);
+    assert(text != NULL);
+    size_t pos = (size_t) snprintf(text, cap, "[");
+    for (int i = 0; i < rows; i++) {
+        /* Key order varies between rows; :note is missing from every third */
+        if (i % 2 == 0) {
+            pos += (size_t) snprintf(text + pos, cap - pos, "{:id %d :kind :k%d :v %d.25", i,
+                                     i % 300, i);
+        } else {
+            pos += (size_t) snprintf(text + pos, cap - pos, "{:v %d.25 :kind :k%d :id %d", i,
+                                     i % 300, i);
+        }
+        if (i % 3 != 0) {
+            pos += (size_t) snprintf(text + pos, cap - pos, " :note \"n\\t%d\"", i);
+        }
+        pos += (size_t) snprintf(text + pos, cap - pos, "}\n");
+    }
+    pos += (size_t) snprintf(text + pos, cap - pos, "]");
+
+    edn_result_t r = edn_read(text, pos);
+    assert(r.error == EDN_OK);
+    edn_columns_t* columns;
+    assert(edn_to_columns(r.value, NULL, &columns).error == EDN_OK);
+    assert(edn_columns_count(columns) == 4);
+
+    const edn_column_t* id = edn_columns_find(columns, "id");
+    const edn_column_t* kind = edn_columns_find(columns, "kind");
+    const edn_column_t* v = edn_columns_find(columns, "v");
+    const edn_column_t* note = edn_columns_find(columns, "note");
+    assert(kind->dictionary_size == 300);
+    assert(note->null_count == (size_t) (rows + 2) / 3);
+    for (int i = 0; i < rows; i++) {
+        assert(id->int64_values[i] == i);
+        assert(v->double_values[i] == i + 0.25);
+        char expected[32];
+        snprintf(expected, sizeof(expected), "k%d", i % 300);
+        assert(text_is(kind, (size_t) kind->indices[i], expected));
+        assert(edn_column_is_valid(note, (size_t) i) == (i % 3 != 0));
+        if (i % 3 != 0) {
+            snprintf(expected, sizeof(expected), "n\t%d", i);
+            assert(text_is(note, (size_t) i, expected));
+        }
+    }
+
+    edn_columns_free(columns);
+    edn_free(r.value);
+    free(text);
+}
+
+int main(void) {
+    printf("Running columns tests...\n");
+
+    RUN_TEST(columns_basic_types);
+    RUN_TEST(columns_nulls);
+    RUN_TEST(columns_selected_keys);
+    RUN_TEST(columns_errors);
+    RUN_TEST(columns_many_rows);
+
+    TEST_SUMMARY("columns");
+}
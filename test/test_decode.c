@@ -0,0 +1,347 @@
+/**
+ * Test schema-directed decoding into C structs
+ */
+
+#include <string.h>
+
+#include "../include/edn.h"
+#include "test_framework.h"
+
+typedef struct {
+    double x;
+    double y;
+} point_t;
+
+static const edn_field_desc_t point_fields[] = {
+    EDN_FIELD(point_t, x, "x", EDN_FIELD_DOUBLE, true),
+    EDN_FIELD(point_t, y, "y", EDN_FIELD_DOUBLE, true),
+};
+static const edn_struct_desc_t point_desc = {point_fields, 2, sizeof(point_t)};
+
+typedef struct {
+    int64_t id;
+    int32_t age;
+    bool active;
+    char name[16];
+    char role[16];
+    point_t home;
+    int64_t scores[4];
+    size_t score_count;
+    point_t path[3];
+    size_t path_count;
+    char tags[2][8];
+    size_t tag_count;
+} user_t;
+
+static const edn_field_desc_t user_fields[] = {
+    EDN_FIELD(user_t, id, "user/id", EDN_FIELD_INT64, true),
+    EDN_FIELD(user_t, age, "age", EDN_FIELD_INT32, false),
+    EDN_FIELD(user_t, active, "active?", EDN_FIELD_BOOL, false),
+    EDN_FIELD(user_t, name, "name", EDN_FIELD_STRING, false),
+    EDN_FIELD(user_t, role, "role", EDN_FIELD_KEYWORD, false),
+    EDN_STRUCT_FIELD(user_t, home, "home", &point_desc, false),
+    EDN_ARRAY_FIELD(user_t, scores, score_count, "scores", EDN_FIELD_INT64, NULL, false),
+    EDN_ARRAY_FIELD(user_t, path, path_count, "path", EDN_FIELD_STRUCT, &point_desc, false),
+    EDN_ARRAY_FIELD(user_t, tags, tag_count, "tags", EDN_FIELD_STRING, NULL, false),
+};
+static const edn_struct_desc_t user_desc = {user_fields, 9, sizeof(user_t)};
+
+static edn_result_t decode_user(const char* input, user_t* user) {
+    edn_decoder_t* decoder = edn_decoder_create(&user_desc);
+    edn_result_t r = edn_decode(decoder, input, 0, user);
+    edn_decoder_destroy(decoder);
+    return r;
+}
+
+TEST(decode_flat_fields) {
+    user_t u;
+    edn_result_t r = decode_user(
+        "{:user/id 42 :age 31 :active? true :name \"Ada \\\"L\\\"\" :role :admin/owner}", &u);
+    assert(r.error == EDN_OK);
+    assert(r.value == NULL);
+    assert(u.id == 42);
+    assert_int_eq(u.age, 31);
+    assert(u.active);
+    assert_str_eq(u.name, "Ada \"L\"");
+    assert_str_eq(u.role, "admin/owner");
+    assert_int_eq(u.score_count, 0);
+}
+
+TEST(decode_nested_and_arrays) {
+    user_t u;
+    edn_result_t r = decode_user("{:user/id 1 :home {:x 1.5 :y 2} :scores [10 20 30]"
+                                 " :path ({:x 0 :y 0} {:x 3 :y 4}) :tags [\"a\" \"bc\"]}",
+                                 &u);
+    assert(r.error == EDN_OK);
+    assert_double_eq(u.home.x, 1.5);
+    assert_double_eq(u.home.y, 2.0);
+    assert_int_eq(u.score_count, 3);
+    assert(u.scores[0] == 10 && u.scores[2] == 30);
+    assert_int_eq(u.path_count, 2);
+    assert_double_eq(u.path[1].x, 3.0);
+    assert_double_eq(u.path[1].y, 4.0);
+    assert_int_eq(u.tag_count, 2);
+    assert_str_eq(u.tags[1], "bc");
+}
+
+TEST(decode_skips_unknown_keys) {
+    user_t u;
+    edn_result_t r = decode_user("{:extra {:deep [1 #{2} (3)]} \"str-key\" 5 [:vec :key] {:a 1}"
+                                 " :other/id 7 #_ :ignored :user/id 9 :age nil"
+                                 " :name #my/tag \"tagged\"}",
+                                 &u);
+    assert(r.error == EDN_OK);
+    assert(u.id == 9);
+    assert_int_eq(u.age, 0);
+    assert_str_eq(u.name, "tagged");
+}
+
+TEST(decode_missing_required) {
+    user_t u;
+    edn_result_t r = decode_user("{:age 3}", &u);
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Missing required field");
+
+    r = decode_user("{:user/id 1 :home {:x 1}}", &u);
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Missing required field");
+}
+
+TEST(decode_type_mismatch) {
+    user_t u;
+    edn_result_t r = decode_user("{:user/id 1\n :age \"old\"}", &u);
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Value does not match field type");
+    assert_int_eq(r.error_start.offset, 18);
+    assert_int_eq(r.error_start.line, 2);
+    assert_int_eq(r.error_end.offset, 23);
+
+    r = decode_user("{:user/id 1 :age 3000000000}", &u);
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Integer out of range");
+
+    r = decode_user("{:user/id 99999999999999999999}", &u);
+    assert_str_eq(r.error_message, "Integer out of range");
+
+    r = decode_user("{:user/id 1 :home [1 2]}", &u);
+    assert_str_eq(r.error_message, "Value does not match field type");
+
+    r = decode_user("{:user/id 1 :scores #{1}}", &u);
+    assert_str_eq(r.error_message, "Value does not match field type");
+
+    r = decode_user("{:user/id 1 :role admin}", &u);
+    assert_str_eq(r.error_message, "Value does not match field type");
+}
+
+TEST(decode_overflow) {
+    user_t u;
+    edn_result_t r = decode_user("{:user/id 1 :scores [1 2 3 4 5]}", &u);
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Array capacity exceeded");
+
+    /* name is char[16]: 15 bytes plus the terminator fit */
+    r = decode_user("{:user/id 1 :name \"sixteen chars!!!\"}", &u);
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "String too long for field");
+
+    r = decode_user("{:user/id 1 :name \"fifteen chars!!\"}", &u);
+    assert(r.error == EDN_OK);
+    assert_str_eq(u.name, "fifteen chars!!");
+}
+
+TEST(decode_duplicate_and_root_errors) {
+    user_t u;
+    edn_result_t r = decode_user("{:user/id 1 :user/id 2}", &u);
+    assert(r.error == EDN_ERROR_DUPLICATE_KEY);
+
+    r = decode_user("[1 2]", &u);
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Expected a map");
+
+    r = decode_user("42", &u);
+    assert_str_eq(r.error_message, "Expected a map");
+
+    r = decode_user("", &u);
+    assert(r.error == EDN_ERROR_UNEXPECTED_EOF);
+
+    /* Syntax errors come from the parser unchanged */
+    r = decode_user("{:user/id 1 :name \"x}", &u);
+    assert(r.error == EDN_ERROR_INVALID_STRING || r.error == EDN_ERROR_UNEXPECTED_EOF);
+
+    r = decode_user("{:user/id 1 :age}", &u);
+    assert(r.error == EDN_ERROR_INVALID_SYNTAX);
+}
+
+/* Keys no field asks for are skipped but still checked for repeats */
+TEST(decode_repeated_skipped_keys) {
+    static const struct {
+        const char* input;
+        bool duplicate;
+    } cases[] = {
+        {"{:user/id 1 :extra 1 :extra 2}", true},
+        {"{:user/id 1 :a/extra 1 :b/extra 2 :extra 3}", false},
+        {"{\"k\" 1 :user/id 1 \"k\" 2}", true},
+        {"{\"k\" 1 :user/id 1 :k 2 k 3}", false},
+        {"{:user/id 1 [1 [2]] 0 ([1 [2]]) 0}", false},
+        {"{:user/id 1 [1 [2]] 0 (1 (2)) 0}", true},
+        {"{:user/id 1 [1 2] 0 [2 1] 0}", false},
+        {"{:user/id 1 #{1 2} 0 #{2 1} 0}", true},
+        {"{:user/id 1 {:a 1 :b 2} 0 {:b 2 :a 1} 0}", true},
+        {"{:user/id 1 {:a 1 :b 2} 0 {:a 2 :b 1} 0}", false},
+        {"{:user/id 1 1 0 1.0 0 \\a 0 \"a\" 0 nil 0 false 0}", false},
+        {"{:user/id 1 #my/tag 1 0 1 0 #my/other 1 0}", false},
+        {"{:user/id 1 #my/tag [1] 0 #my/tag [1] 0}", true},
+        {"{:user/id 1 [[[[[[[[[[1]]]]]]]]]] 0 [[[[[[[[[[1]]]]]]]]]] 0}", true},
+        {"{:user/id 1 [[[[[[[[[[1]]]]]]]]]] 0 [[[[[[[[[[2]]]]]]]]]] 0}", false},
+        /* Each map checks its own keys */
+        {"{:user/id 1 :x 0 :home {:x 1 :y 2 :z 3}}", false},
+        {"{:user/id 1 :home {:x 1 :y 2 :z 3 :z 4}}", true},
+        /* Keys inside a skipped value are not the struct's keys */
+        {"{:user/id 1 :extra {:a 1} :a 2}", false},
+        /* Discarded keys do not count */
+        {"{:user/id 1 :extra 1 #_ :extra #_ 2}", false},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        user_t u;
+        edn_result_t r = decode_user(cases[i].input, &u);
+        edn_result_t read = edn_read(cases[i].input, 0);
+        edn_free(read.value);
+        if ((r.error == EDN_ERROR_DUPLICATE_KEY) != cases[i].duplicate ||
+            (read.error == EDN_ERROR_DUPLICATE_KEY) != cases[i].duplicate) {
+            printf("\n    %s: decode %d, edn_read %d", cases[i].input, r.error, read.error);
+            current_test_failed = true;
+        } else if (!cases[i].duplicate) {
+            assert(r.error == EDN_OK);
+        }
+    }
+
+    /* Past the inline hash stack and the pairwise check */
+    char input[1024] = "{:user/id 1";
+    for (int i = 0; i < 40; i++) {
+        char entry[24];
+        snprintf(entry, sizeof(entry), " :k%d %d", i, i);
+        strcat(input, entry);
+    }
+    strcat(input, "}");
+    user_t u;
+    edn_result_t r = decode_user(input, &u);
+    assert(r.error == EDN_OK);
+    input[strlen(input) - 1] = '\0';
+    strcat(input, " :k17 0}");
+    r = decode_user(input, &u);
+    assert(r.error == EDN_ERROR_DUPLICATE_KEY);
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    /* Metadata is not part of a key */
+    r = decode_user("{:user/id 1 [^:a x] 0 [^{:b 1} x] 0}", &u);
+    assert(r.error == EDN_ERROR_DUPLICATE_KEY);
+    r = decode_user("{:user/id 1 [^:a x y] 0 [x ^:a y] 0}", &u);
+    assert(r.error == EDN_ERROR_DUPLICATE_KEY);
+#endif
+}
+
+TEST(decode_zeroes_output) {
+    user_t u;
+    memset(&u, 0xAB, sizeof(u));
+    edn_result_t r = decode_user("{:user/id 5}", &u);
+    assert(r.error == EDN_OK);
+    assert_int_eq(u.age, 0);
+    assert_false(u.active);
+    assert_str_eq(u.name, "");
+    assert_int_eq(u.path_count, 0);
+}
+
+TEST(decode_many_keys_perfect_hash) {
+    typedef struct {
+        int64_t v[40];
+    } wide_t;
+    static char keys[40][8];
+    edn_field_desc_t fields[40];
+    char input[1024] = "{";
+    for (int i = 0; i < 40; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "k%d", i);
+        fields[i] = (edn_field_desc_t) {keys[i], EDN_FIELD_INT64, offsetof(wide_t, v) + i * 8,
+                                        8, true, NULL, EDN_FIELD_BOOL, 0, 0};
+        char entry[24];
+        snprintf(entry, sizeof(entry), ":k%d %d ", i, i * 3);
+        strcat(input, entry);
+    }
+    strcat(input, ":k40 1 :k4x 2}");
+    edn_struct_desc_t desc = {fields, 40, sizeof(wide_t)};
+
+    edn_decoder_t* decoder = edn_decoder_create(&desc);
+    assert(decoder != NULL);
+    wide_t w;
+    edn_result_t r = edn_decode(decoder, input, 0, &w);
+    assert(r.error == EDN_OK);
+    for (int i = 0; i < 40; i++) {
+        assert(w.v[i] == i * 3);
+    }
+    edn_decoder_destroy(decoder);
+}
+
+typedef struct node node_t;
+static const edn_struct_desc_t node_desc;
+static const edn_field_desc_t node_fields[] = {
+    {"child", EDN_FIELD_STRUCT, 0, 8, false, &node_desc, EDN_FIELD_BOOL, 0, 0},
+};
+static const edn_struct_desc_t node_desc = {node_fields, 1, 8};
+
+TEST(decoder_rejects_invalid_descriptors) {
+    assert(edn_decoder_create(NULL) == NULL);
+
+    /* Self-referencing descriptor */
+    assert(edn_decoder_create(&node_desc) == NULL);
+
+    edn_field_desc_t dup[] = {
+        EDN_FIELD(point_t, x, "x", EDN_FIELD_DOUBLE, false),
+        EDN_FIELD(point_t, y, "x", EDN_FIELD_DOUBLE, false),
+    };
+    edn_struct_desc_t dup_desc = {dup, 2, sizeof(point_t)};
+    assert(edn_decoder_create(&dup_desc) == NULL);
+
+    edn_field_desc_t no_nested[] = {
+        EDN_STRUCT_FIELD(user_t, home, "home", NULL, false),
+    };
+    edn_struct_desc_t no_nested_desc = {no_nested, 1, sizeof(user_t)};
+    assert(edn_decoder_create(&no_nested_desc) == NULL);
+
+    edn_field_desc_t nested_array[] = {
+        EDN_ARRAY_FIELD(user_t, scores, score_count, "s", EDN_FIELD_ARRAY, NULL, false),
+    };
+    edn_struct_desc_t nested_array_desc = {nested_array, 1, sizeof(user_t)};
+    assert(edn_decoder_create(&nested_array_desc) == NULL);
+
+    edn_decoder_destroy(NULL);
+}
+
+TEST(decode_ignores_metadata) {
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    user_t u;
+    edn_result_t r = decode_user("^{:doc \"x\"} {:user/id 4 :scores ^:big ^[1] [7]}", &u);
+    assert(r.error == EDN_OK);
+    assert(u.id == 4);
+    assert_int_eq(u.score_count, 1);
+    assert(u.scores[0] == 7);
+#endif
+}
+
+int main(void) {
+    printf("Running schema decode tests...\n");
+
+    RUN_TEST(decode_flat_fields);
+    RUN_TEST(decode_nested_and_arrays);
+    RUN_TEST(decode_skips_unknown_keys);
+    RUN_TEST(decode_missing_required);
+    RUN_TEST(decode_type_mismatch);
+    RUN_TEST(decode_overflow);
+    RUN_TEST(decode_duplicate_and_root_errors);
+    RUN_TEST(decode_repeated_skipped_keys);
+    RUN_TEST(decode_zeroes_output);
+    RUN_TEST(decode_many_keys_perfect_hash);
+    RUN_TEST(decoder_rejects_invalid_descriptors);
+    RUN_TEST(decode_ignores_metadata);
+
+    TEST_SUMMARY("schema decode");
+}
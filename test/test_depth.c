@@ -10,19 +10,10 @@
 #include "test_framework.h"
 
 /* Helper macro to initialize parser for testing */
-#define INIT_PARSER(parser, input_str)                                 \
-    do {                                                               \
-        (parser).input = (input_str);                                  \
-        (parser).current = (input_str);                                \
-        (parser).end = (input_str) + strlen(input_str);                \
-        (parser).depth = 0;                                            \
-        (parser).max_depth = EDN_DEFAULT_MAX_DEPTH;                    \
-        (parser).arena = edn_arena_create();                           \
-        (parser).error = EDN_OK;                                       \
-        (parser).error_message = NULL;                                 \
-        (parser).reader_registry = NULL;                               \
-        (parser).default_reader_mode = EDN_DEFAULT_READER_PASSTHROUGH; \
-        (parser).discard_mode = false;                                 \
+#define INIT_PARSER(parser, input_str)                              \
+    do {                                                            \
+        edn_parser_init(&(parser), (input_str), strlen(input_str)); \
+        (parser).arena = edn_arena_create();                        \
     } while (0)
 
 /* Test: depth is 0 at initialization */
@@ -33,6 +24,7 @@ TEST(depth_initial) {
 
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -46,6 +38,7 @@ TEST(depth_simple_values) {
     assert(value != NULL);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -60,6 +53,7 @@ TEST(depth_single_level) {
     assert(value->type == EDN_TYPE_VECTOR);
     assert(parser.depth == 0); /* Should return to 0 after complete parse */
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -74,6 +68,7 @@ TEST(depth_nested) {
     assert(value->type == EDN_TYPE_VECTOR);
     assert(parser.depth == 0); /* Should return to 0 after complete parse */
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -88,6 +83,7 @@ TEST(depth_list) {
     assert(value->type == EDN_TYPE_LIST);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -102,6 +98,7 @@ TEST(depth_map) {
     assert(value->type == EDN_TYPE_MAP);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -116,6 +113,7 @@ TEST(depth_set) {
     assert(value->type == EDN_TYPE_SET);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -130,6 +128,7 @@ TEST(depth_mixed_nested) {
     assert(value->type == EDN_TYPE_MAP);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -144,6 +143,7 @@ TEST(depth_error_restoration) {
     assert(parser.error == EDN_ERROR_UNTERMINATED_COLLECTION);
     assert(parser.depth == 0); /* Depth should be restored even on error */
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -158,6 +158,7 @@ TEST(depth_nested_error_restoration) {
     assert(parser.error == EDN_ERROR_UNTERMINATED_COLLECTION);
     assert(parser.depth == 0); /* Depth should be restored even on error */
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -172,6 +173,7 @@ TEST(depth_map_error_restoration) {
     assert(parser.error == EDN_ERROR_UNTERMINATED_COLLECTION);
     assert(parser.depth == 0); /* Depth should be restored even on error */
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -186,6 +188,7 @@ TEST(depth_tagged) {
     assert(value->type == EDN_TYPE_TAGGED);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -200,6 +203,7 @@ TEST(depth_nested_tagged) {
     assert(value->type == EDN_TYPE_TAGGED);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -214,6 +218,7 @@ TEST(depth_tagged_with_collection) {
     assert(value->type == EDN_TYPE_TAGGED);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -228,6 +233,7 @@ TEST(depth_tagged_error_missing_tag) {
     assert(parser.error == EDN_ERROR_UNEXPECTED_EOF);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -242,6 +248,7 @@ TEST(depth_tagged_error_missing_value) {
     assert(parser.error == EDN_ERROR_UNEXPECTED_EOF);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -256,6 +263,7 @@ TEST(depth_tagged_error_invalid_tag) {
     assert(parser.error == EDN_ERROR_INVALID_SYNTAX);
     assert(parser.depth == 0);
 
+    free(parser.child_stack);
     edn_arena_destroy(parser.arena);
 }
 
@@ -735,6 +735,24 @@ TEST(hash_map_order_independent) {
     edn_free(b);
 }
 
+TEST(equal_map_mixed_namespaced_keys) {
+    edn_value_t* a = parse_helper("{:x 1 :ns/y 2 \"z\" 3}");
+    edn_value_t* b = parse_helper("{\"z\" 3 :ns/y 2 :x 1}");
+    edn_value_t* c = parse_helper("{\"z\" 3 :ns/x 2 :x 1}");
+
+    assert(a != NULL);
+    assert(b != NULL);
+    assert(c != NULL);
+
+    assert(edn_value_equal(a, b));
+    assert(edn_value_hash(a) == edn_value_hash(b));
+    assert(!edn_value_equal(a, c));
+
+    edn_free(a);
+    edn_free(b);
+    edn_free(c);
+}
+
 /* Nested collection equality */
 TEST(equal_nested_collections) {
     edn_value_t* a = parse_helper("{:list (1 2) :vec [3 4] :set #{5 6}}");
@@ -1213,6 +1231,7 @@ int main(void) {
     RUN_TEST(not_equal_map_different_values);
     RUN_TEST(equal_empty_maps);
     RUN_TEST(hash_map_order_independent);
+    RUN_TEST(equal_map_mixed_namespaced_keys);
 
     /* Nested collections */
     RUN_TEST(equal_nested_collections);
@@ -0,0 +1,442 @@
+/**
+ * Test SAX-style event parsing (edn_parse_events)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "test_framework.h"
+
+/* Records events as a space-separated trace */
+typedef struct {
+    char buf[512];
+    size_t len;
+    int abort_after; /* Abort on this event number (1-based); 0 = never */
+    int events;
+} trace_t;
+
+static int trace_add(trace_t* t, const char* fmt, const char* s, size_t len) {
+    char item[128];
+    int n = snprintf(item, sizeof(item), fmt, (int) len, s);
+    if (n > 0 && t->len + (size_t) n + 2 < sizeof(t->buf)) {
+        if (t->len > 0) {
+            t->buf[t->len++] = ' ';
+        }
+        memcpy(t->buf + t->len, item, (size_t) n);
+        t->len += (size_t) n;
+        t->buf[t->len] = '\0';
+    }
+    t->events++;
+    return (t->abort_after != 0 && t->events >= t->abort_after) ? 1 : 0;
+}
+
+static int on_nil(void* ctx) {
+    return trace_add(ctx, "nil%.*s", "", 0);
+}
+static int on_bool(void* ctx, bool value) {
+    return trace_add(ctx, "%.*s", value ? "true" : "false", value ? 4 : 5);
+}
+static int on_int(void* ctx, int64_t value) {
+    char num[32];
+    snprintf(num, sizeof(num), "%lld", (long long) value);
+    return trace_add(ctx, "i:%.*s", num, strlen(num));
+}
+static int on_double(void* ctx, double value) {
+    char num[32];
+    snprintf(num, sizeof(num), "%g", value);
+    return trace_add(ctx, "d:%.*s", num, strlen(num));
+}
+static int on_string(void* ctx, const char* s, size_t len) {
+    return trace_add(ctx, "s:%.*s", s, len);
+}
+static int on_ident(void* ctx, const char* prefix, const char* ns, size_t ns_len,
+                    const char* name, size_t name_len) {
+    char id[96];
+    if (ns != NULL) {
+        snprintf(id, sizeof(id), "%s%.*s/%.*s", prefix, (int) ns_len, ns, (int) name_len, name);
+    } else {
+        snprintf(id, sizeof(id), "%s%.*s", prefix, (int) name_len, name);
+    }
+    return trace_add(ctx, "%.*s", id, strlen(id));
+}
+static int on_keyword(void* ctx, const char* ns, size_t ns_len, const char* name,
+                      size_t name_len) {
+    return on_ident(ctx, ":", ns, ns_len, name, name_len);
+}
+static int on_symbol(void* ctx, const char* ns, size_t ns_len, const char* name,
+                     size_t name_len) {
+    return on_ident(ctx, "", ns, ns_len, name, name_len);
+}
+static int on_character(void* ctx, uint32_t cp) {
+    char ch[16];
+    snprintf(ch, sizeof(ch), "%u", (unsigned) cp);
+    return trace_add(ctx, "c:%.*s", ch, strlen(ch));
+}
+static int on_bigint(void* ctx, const char* digits, size_t len, bool negative, uint8_t radix) {
+    (void) radix;
+    return trace_add(ctx, negative ? "N:-%.*s" : "N:%.*s", digits, len);
+}
+static int on_bigdec(void* ctx, const char* digits, size_t len, bool negative) {
+    return trace_add(ctx, negative ? "M:-%.*s" : "M:%.*s", digits, len);
+}
+static int on_ratio(void* ctx, int64_t num, int64_t den) {
+    char r[48];
+    snprintf(r, sizeof(r), "%lld/%lld", (long long) num, (long long) den);
+    return trace_add(ctx, "r:%.*s", r, strlen(r));
+}
+static int on_begin_list(void* ctx) {
+    return trace_add(ctx, "(%.*s", "", 0);
+}
+static int on_end_list(void* ctx) {
+    return trace_add(ctx, ")%.*s", "", 0);
+}
+static int on_begin_vector(void* ctx) {
+    return trace_add(ctx, "[%.*s", "", 0);
+}
+static int on_end_vector(void* ctx) {
+    return trace_add(ctx, "]%.*s", "", 0);
+}
+static int on_begin_set(void* ctx) {
+    return trace_add(ctx, "#{%.*s", "", 0);
+}
+static int on_end_set(void* ctx) {
+    return trace_add(ctx, "}%.*s", "", 0);
+}
+static int on_begin_map(void* ctx) {
+    return trace_add(ctx, "{%.*s", "", 0);
+}
+static int on_end_map(void* ctx) {
+    return trace_add(ctx, "}%.*s", "", 0);
+}
+static int on_tag(void* ctx, const char* tag, size_t len) {
+    return trace_add(ctx, "#%.*s", tag, len);
+}
+static int on_meta(void* ctx) {
+    return trace_add(ctx, "^%.*s", "", 0);
+}
+
+static const edn_event_handlers_t trace_handlers = {
+    .on_nil = on_nil,
+    .on_bool = on_bool,
+    .on_int = on_int,
+    .on_double = on_double,
+    .on_string = on_string,
+    .on_keyword = on_keyword,
+    .on_symbol = on_symbol,
+    .on_character = on_character,
+    .on_bigint = on_bigint,
+    .on_bigdec = on_bigdec,
+    .on_ratio = on_ratio,
+    .on_begin_list = on_begin_list,
+    .on_end_list = on_end_list,
+    .on_begin_vector = on_begin_vector,
+    .on_end_vector = on_end_vector,
+    .on_begin_set = on_begin_set,
+    .on_end_set = on_end_set,
+    .on_begin_map = on_begin_map,
+    .on_end_map = on_end_map,
+    .on_tag = on_tag,
+    .on_meta = on_meta,
+};
+
+static edn_error_t trace_events(const char* input, trace_t* t) {
+    memset(t, 0, sizeof(*t));
+    return edn_parse_events(input, 0, &trace_handlers, t).error;
+}
+
+#define assert_trace(input, expected)                  \
+    do {                                               \
+        trace_t _t;                                    \
+        assert(trace_events((input), &_t) == EDN_OK); \
+        assert_str_eq(_t.buf, (expected));             \
+    } while (0)
+
+/* Emitter sink */
+typedef struct {
+    char buf[512];
+    size_t len;
+} sink_t;
+
+static int sink_cb(const char* data, size_t n, void* ctx) {
+    sink_t* s = ctx;
+    if (s->len + n + 1 > sizeof(s->buf))
+        return -EDN_ERROR_OUT_OF_MEMORY;
+    memcpy(s->buf + s->len, data, n);
+    s->len += n;
+    s->buf[s->len] = '\0';
+    return 0;
+}
+
+/* Transcode through the emitter and compare with the tree writer */
+static bool transcodes_like_writer(const char* input, const edn_write_options_t* opts) {
+    sink_t sink = {{0}, 0};
+    edn_emitter_t* em = edn_emitter_create(sink_cb, &sink, opts);
+    if (em == NULL)
+        return false;
+    edn_result_t er = edn_parse_events(input, 0, edn_emitter_event_handlers(), em);
+    int finished = er.error == EDN_OK ? edn_emitter_finish(em) : -1;
+    edn_emitter_destroy(em);
+    if (finished != 0)
+        return false;
+
+    edn_result_t r = edn_read(input, 0);
+    if (r.error != EDN_OK)
+        return false;
+    char* expected = edn_write_string(r.value, opts, NULL);
+    edn_free(r.value);
+    bool same = expected != NULL && strcmp(expected, sink.buf) == 0;
+    if (!same) {
+        printf("\n      transcode: \"%s\" vs writer \"%s\"", sink.buf, expected);
+    }
+    free(expected);
+    return same;
+}
+
+TEST(scalar_events) {
+    assert_trace("nil", "nil");
+    assert_trace("true", "true");
+    assert_trace("-42", "i:-42");
+    assert_trace("1.5", "d:1.5");
+    assert_trace("##Inf", "d:inf");
+    assert_trace("\\a", "c:97");
+    assert_trace(":a/b", ":a/b");
+    assert_trace("foo", "foo");
+    assert_trace("123456789012345678901234567890", "N:123456789012345678901234567890");
+    assert_trace("-1.25M", "M:-1.25");
+}
+
+TEST(string_events) {
+    assert_trace("\"plain\"", "s:plain");
+    assert_trace("\"\"", "s:");
+    /* Raw body by default, as edn_emit_string takes it */
+    assert_trace("\"a\\tb\\\"c\"", "s:a\\tb\\\"c");
+
+    edn_event_handlers_t decoding = trace_handlers;
+    decoding.decode_strings = true;
+    trace_t t;
+    memset(&t, 0, sizeof(t));
+    assert(edn_parse_events("[\"a\\tb\\\"c\" \"x\"]", 0, &decoding, &t).error == EDN_OK);
+    assert_str_eq(t.buf, "[ s:a\tb\"c s:x ]");
+
+    memset(&t, 0, sizeof(t));
+    assert(edn_parse_events("\"bad \\q\"", 0, &decoding, &t).error == EDN_ERROR_INVALID_STRING);
+}
+
+/* Records the decoded strings' lengths and checks their contents */
+typedef struct {
+    size_t lengths[4];
+    int count;
+    bool intact;
+} string_lengths_t;
+
+static int record_string(void* ctx, const char* s, size_t len) {
+    string_lengths_t* r = ctx;
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] != (i % 2 == 0 ? 'a' : '\n')) {
+            r->intact = false;
+        }
+    }
+    if (r->count < 4) {
+        r->lengths[r->count] = len;
+    }
+    r->count++;
+    return 0;
+}
+
+TEST(strings_outgrow_stack_scratch) {
+    /* Decoded strings beyond the stack scratch block spill to heap blocks,
+     * and the scratch is usable again for the scalars that follow */
+    const size_t pairs[] = {3000, 40000, 2};
+    size_t total = 0;
+    for (int i = 0; i < 3; i++) {
+        total += pairs[i] * 3 + 3;
+    }
+    char* input = malloc(total + 3);
+    assert(input != NULL);
+    size_t pos = 0;
+    input[pos++] = '[';
+    for (int i = 0; i < 3; i++) {
+        input[pos++] = '"';
+        for (size_t j = 0; j < pairs[i]; j++) {
+            memcpy(input + pos, "a\\n", 3);
+            pos += 3;
+        }
+        input[pos++] = '"';
+        input[pos++] = ' ';
+    }
+    input[pos++] = ']';
+
+    edn_event_handlers_t handlers;
+    memset(&handlers, 0, sizeof(handlers));
+    handlers.on_string = record_string;
+    handlers.decode_strings = true;
+    string_lengths_t r = {{0}, 0, true};
+    assert(edn_parse_events(input, pos, &handlers, &r).error == EDN_OK);
+    free(input);
+
+    assert_int_eq(r.count, 3);
+    assert(r.intact);
+    assert(r.lengths[0] == 6000);
+    assert(r.lengths[1] == 80000);
+    assert(r.lengths[2] == 4);
+}
+
+TEST(collection_events) {
+    assert_trace("[1 (2) #{3} {:a nil}]", "[ i:1 ( i:2 ) #{ i:3 } { :a nil } ]");
+    assert_trace("[]", "[ ]");
+    assert_trace("{}", "{ }");
+}
+
+TEST(tagged_events) {
+    assert_trace("#inst \"2024-01-01T00:00:00Z\"", "#inst s:2024-01-01T00:00:00Z");
+    assert_trace("[#my/tag [1]]", "[ #my/tag [ i:1 ] ]");
+}
+
+TEST(discarded_forms_are_silent) {
+    assert_trace("[1 #_ [2 3] 4]", "[ i:1 i:4 ]");
+    assert_trace("#_ #_ a b c", "c");
+    assert_trace("{:a #_ :x 1}", "{ :a i:1 }");
+
+    /* ...but still validated */
+    trace_t t;
+    assert(trace_events("[#_ [1 2) 3]", &t) == EDN_ERROR_UNMATCHED_DELIMITER);
+    assert(trace_events("[#_]", &t) == EDN_ERROR_INVALID_DISCARD);
+}
+
+TEST(structural_errors) {
+    trace_t t;
+    assert(trace_events("", &t) == EDN_ERROR_UNEXPECTED_EOF);
+    assert(trace_events("[1 2", &t) == EDN_ERROR_UNTERMINATED_COLLECTION);
+    assert(trace_events("(1 2]", &t) == EDN_ERROR_UNMATCHED_DELIMITER);
+    assert(trace_events(")", &t) == EDN_ERROR_UNMATCHED_DELIMITER);
+    assert(trace_events("{:a}", &t) == EDN_ERROR_INVALID_SYNTAX);
+    assert(trace_events("# foo 1", &t) == EDN_ERROR_INVALID_SYNTAX);
+    assert(trace_events("[#tag]", &t) == EDN_ERROR_UNTERMINATED_COLLECTION);
+    assert(trace_events("\"abc", &t) == EDN_ERROR_INVALID_STRING);
+
+    /* Events before the error have already been delivered */
+    assert(trace_events("[1 2", &t) != EDN_OK);
+    assert_str_eq(t.buf, "[ i:1 i:2");
+}
+
+TEST(error_positions) {
+    trace_t t;
+    memset(&t, 0, sizeof(t));
+    edn_result_t r = edn_parse_events("[1\n 2 3)", 0, &trace_handlers, &t);
+    assert(r.error == EDN_ERROR_UNMATCHED_DELIMITER);
+    assert(r.value == NULL);
+    assert_str_eq(r.error_message, "Mismatched closing delimiter in vector");
+    assert_int_eq(r.error_end.line, 2);
+    assert_int_eq(r.error_end.column, 6);
+}
+
+TEST(handler_abort) {
+    trace_t t;
+    memset(&t, 0, sizeof(t));
+    t.abort_after = 3;
+    edn_result_t r = edn_parse_events("[1 2 3 4]", 0, &trace_handlers, &t);
+    assert(r.error == EDN_ERROR_ABORTED);
+    assert_int_eq(t.events, 3);
+    assert_str_eq(t.buf, "[ i:1 i:2");
+}
+
+TEST(optional_handlers) {
+    edn_event_handlers_t none = {0};
+    edn_result_t r = edn_parse_events("{:a [1 \"x\\n\" #t 2.5]}", 0, &none, NULL);
+    assert(r.error == EDN_OK);
+
+    r = edn_parse_events("[1", 0, &none, NULL);
+    assert(r.error == EDN_ERROR_UNTERMINATED_COLLECTION);
+
+    r = edn_parse_events("1", 0, NULL, NULL);
+    assert(r.error == EDN_ERROR_INVALID_ARGUMENT);
+    r = edn_parse_events(NULL, 0, &none, NULL);
+    assert(r.error != EDN_OK);
+}
+
+TEST(depth_limit) {
+    char deep[2 * 2000 + 1];
+    memset(deep, '[', 2000);
+    memset(deep + 2000, ']', 2000);
+    deep[4000] = '\0';
+
+    edn_event_handlers_t none = {0};
+    edn_result_t r = edn_parse_events(deep, 0, &none, NULL);
+    assert(r.error == EDN_ERROR_MAX_DEPTH_EXCEEDED);
+}
+
+TEST(transcode_matches_writer) {
+    assert(transcodes_like_writer("{:a [1 2.5 \"s\\\"q\" \\c nil true] :b #{x/y}}", NULL));
+    assert(transcodes_like_writer("(#inst \"2024-01-01T00:00:00Z\" #_ skip :k/w)", NULL));
+    assert(transcodes_like_writer("[123456789012345678901234567890 1.50M -7N]", NULL));
+    assert(transcodes_like_writer("[\\newline \\space \"tab\\there\"]", NULL));
+
+    edn_write_options_t pretty = {0};
+    pretty.struct_size = sizeof(pretty);
+    pretty.indent = 2;
+    assert(transcodes_like_writer("{:a [1 2] :b {:c (3 4)}}", &pretty));
+}
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+TEST(namespaced_map_keys) {
+    assert_trace("#:user{:name 1 :_/bare 2 :other/k 3 sym 4}",
+                 "{ :user/name i:1 :bare i:2 :other/k i:3 user/sym i:4 }");
+    /* Only keys are qualified, not values or nested keys */
+    assert_trace("#:a{:k {:x :y}}", "{ :a/k { :x :y } }");
+    assert_trace("#:a{#_ 0 :k 1}", "{ :a/k i:1 }");
+}
+
+TEST(metadata_events) {
+    assert_trace("^:private foo", "^ :private foo");
+    assert_trace("^{:a 1} [x]", "^ { :a i:1 } [ x ]");
+
+    trace_t t;
+    assert(trace_events("^:m 42", &t) == EDN_ERROR_INVALID_SYNTAX);
+    assert(trace_events("^42 foo", &t) == EDN_ERROR_INVALID_SYNTAX);
+
+    /* Payloads are forwarded as written; the tree writer would normalize
+     * ^{:tag String} to ^String and merge stacked metadata */
+    edn_write_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.emit_metadata = true;
+    sink_t sink = {{0}, 0};
+    edn_emitter_t* em = edn_emitter_create(sink_cb, &sink, &opts);
+    assert(em != NULL);
+    edn_result_t r = edn_parse_events("[^:dynamic x ^{:tag String} ^:a (1)]", 0,
+                                      edn_emitter_event_handlers(), em);
+    assert(r.error == EDN_OK);
+    assert_int_eq(edn_emitter_finish(em), 0);
+    edn_emitter_destroy(em);
+    assert_str_eq(sink.buf, "[^:dynamic x ^{:tag String} ^:a (1)]");
+}
+
+TEST(ratio_events) {
+    assert_trace("3/4", "r:3/4");
+    assert(transcodes_like_writer("[3/4 99999999999999999999/3]", NULL));
+}
+#endif
+
+int main(void) {
+    printf("Running event parser tests...\n");
+
+    RUN_TEST(scalar_events);
+    RUN_TEST(string_events);
+    RUN_TEST(strings_outgrow_stack_scratch);
+    RUN_TEST(collection_events);
+    RUN_TEST(tagged_events);
+    RUN_TEST(discarded_forms_are_silent);
+    RUN_TEST(structural_errors);
+    RUN_TEST(error_positions);
+    RUN_TEST(handler_abort);
+    RUN_TEST(optional_handlers);
+    RUN_TEST(depth_limit);
+    RUN_TEST(transcode_matches_writer);
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    RUN_TEST(namespaced_map_keys);
+    RUN_TEST(metadata_events);
+    RUN_TEST(ratio_events);
+#endif
+
+    TEST_SUMMARY("event parser");
+}
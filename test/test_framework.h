@@ -150,4 +150,26 @@ static bool current_test_failed = false;
         }                                                      \
     } while (0)
 
+/* Option-struct helpers for suites that include edn.h first */
+#ifdef EDN_H
+/* edn_read_with_options with only a reader registry and strict_utf8 set */
+static inline edn_result_t read_with(const char* input, edn_reader_registry_t* registry,
+                                     bool strict_utf8) {
+    edn_parse_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.reader_registry = registry;
+    opts.strict_utf8 = strict_utf8;
+    return edn_read_with_options(input, 0, &opts);
+}
+
+/* edn_validate with only check_duplicates set */
+static inline edn_result_t validate_with(const char* input, bool check_duplicates,
+                                         edn_validate_stats_t* stats) {
+    edn_validate_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.check_duplicates = check_duplicates;
+    return edn_validate(input, 0, &opts, stats);
+}
+#endif
+
 #endif /* TEST_FRAMEWORK_H */
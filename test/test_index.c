@@ -0,0 +1,271 @@
+/**
+ * Test the sidecar offset index (edn_index_build / edn_index_open)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "test_framework.h"
+
+#define DATA_PATH "test_index_data.edn"
+#define INDEX_PATH "test_index_data.edn.ednidx"
+#define OTHER_INDEX_PATH "test_index_other.idx"
+
+static bool write_text(const char* path, const char* text) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        return false;
+    }
+    size_t length = strlen(text);
+    bool ok = fwrite(text, 1, length, f) == length;
+    return fclose(f) == 0 && ok;
+}
+
+static bool form_is(const edn_index_t* index, size_t n, const char* expected) {
+    const char* text;
+    size_t length;
+    return edn_index_form(index, n, &text, &length) && length == strlen(expected) &&
+           memcmp(text, expected, length) == 0;
+}
+
+/* Position of the first form whose key reads as `key_text` */
+static bool find_text(const edn_index_t* index, const char* key_text, size_t* n) {
+    edn_result_t key = edn_read(key_text, 0);
+    bool found = key.error == EDN_OK && edn_index_find(index, key.value, n);
+    edn_free(key.value);
+    return found;
+}
+
+TEST(index_top_level_forms) {
+    assert(write_text(DATA_PATH, "{:id 1 :v \"a\"}\n{:id 2}\n; comment\n#_ {:id 99}\n[1 2] :kw"));
+    edn_result_t built = edn_index_build(DATA_PATH, NULL);
+    assert(built.error == EDN_OK && built.value == NULL);
+
+    edn_error_t error;
+    edn_index_t* index = edn_index_open(DATA_PATH, NULL, &error);
+    assert(index != NULL && error == EDN_OK);
+    assert(edn_index_count(index) == 4);
+    assert(form_is(index, 0, "{:id 1 :v \"a\"}"));
+    assert(form_is(index, 1, "{:id 2}"));
+    assert(form_is(index, 2, "[1 2]"));
+    assert(form_is(index, 3, ":kw"));
+    assert(!edn_index_form(index, 4, NULL, NULL));
+
+    edn_result_t r = edn_index_get(index, 2, NULL);
+    assert(r.error == EDN_OK);
+    assert(edn_type(r.value) == EDN_TYPE_VECTOR && edn_vector_count(r.value) == 2);
+    edn_free(r.value);
+
+    r = edn_index_get(index, 0, NULL);
+    assert(r.error == EDN_OK);
+    size_t length;
+    const char* v = edn_string_get(edn_map_get_keyword(r.value, "v"), &length);
+    assert(v != NULL && length == 1 && v[0] == 'a');
+    edn_free(r.value);
+
+    r = edn_index_get(index, 4, NULL);
+    assert(r.error == EDN_ERROR_INVALID_ARGUMENT && r.value == NULL);
+
+    /* Built without a key: nothing to find */
+    size_t n;
+    assert(!find_text(index, "1", &n));
+    edn_index_close(index);
+
+    /* Empty file, explicit index path */
+    assert(write_text(DATA_PATH, " ; nothing here\n"));
+    edn_index_options_t options = {0};
+    options.struct_size = sizeof(options);
+    options.index_path = OTHER_INDEX_PATH;
+    assert(edn_index_build(DATA_PATH, &options).error == EDN_OK);
+    index = edn_index_open(DATA_PATH, OTHER_INDEX_PATH, NULL);
+    assert(index != NULL && edn_index_count(index) == 0);
+    edn_index_close(index);
+
+    remove(DATA_PATH);
+    remove(INDEX_PATH);
+    remove(OTHER_INDEX_PATH);
+}
+
+TEST(index_vector_elements) {
+    edn_index_options_t options = {0};
+    options.struct_size = sizeof(options);
+    options.vector_elements = true;
+
+    assert(write_text(DATA_PATH, "; log\n[{:id 1}\n {:id 2} #_ {:id 3}\n \"three\"]\n"));
+    assert(edn_index_build(DATA_PATH, &options).error == EDN_OK);
+    edn_index_t* index = edn_index_open(DATA_PATH, NULL, NULL);
+    assert(index != NULL && edn_index_count(index) == 3);
+    assert(form_is(index, 0, "{:id 1}"));
+    assert(form_is(index, 1, "{:id 2}"));
+    assert(form_is(index, 2, "\"three\""));
+    edn_index_close(index);
+
+    assert(write_text(DATA_PATH, "[]"));
+    assert(edn_index_build(DATA_PATH, &options).error == EDN_OK);
+    index = edn_index_open(DATA_PATH, NULL, NULL);
+    assert(index != NULL && edn_index_count(index) == 0);
+    edn_index_close(index);
+
+    /* Not a single vector */
+    assert(write_text(DATA_PATH, "{:a 1}"));
+    assert(edn_index_build(DATA_PATH, &options).error == EDN_ERROR_INVALID_SYNTAX);
+    assert(write_text(DATA_PATH, "[1 2] [3]"));
+    edn_result_t r = edn_index_build(DATA_PATH, &options);
+    assert(r.error == EDN_ERROR_INVALID_SYNTAX && r.error_start.offset == 6);
+    assert(write_text(DATA_PATH, "[1 2"));
+    r = edn_index_build(DATA_PATH, &options);
+    assert(r.error == EDN_ERROR_UNTERMINATED_COLLECTION);
+    assert(write_text(DATA_PATH, "[1 2}"));
+    assert(edn_index_build(DATA_PATH, &options).error == EDN_ERROR_UNMATCHED_DELIMITER);
+
+    /* A failed build leaves no index behind */
+    FILE* f = fopen(INDEX_PATH, "rb");
+    assert(f == NULL);
+
+    remove(DATA_PATH);
+}
+
+TEST(index_keys) {
+    assert(write_text(DATA_PATH, "{:id 7 :name \"seven\"}\n"
+                                 "{:id \"x\" :name \"ex\"}\n"
+                                 "[:not :a :map]\n"
+                                 "{:name \"no id\"}\n"
+                                 "{:id [1 2] :name \"pair\"}\n"
+                                 "{:id 7 :name \"seven again\"}\n"
+                                 "{:user/id 7 :name \"namespaced\"}\n"));
+    edn_index_options_t options = {0};
+    options.struct_size = sizeof(options);
+    options.key = "id";
+    assert(edn_index_build(DATA_PATH, &options).error == EDN_OK);
+
+    edn_index_t* index = edn_index_open(DATA_PATH, NULL, NULL);
+    assert(index != NULL && edn_index_count(index) == 7);
+    size_t n = 99;
+    assert(find_text(index, "7", &n) && n == 0); /* First of the duplicates */
+    assert(find_text(index, "\"x\"", &n) && n == 1);
+    assert(find_text(index, "[1 2]", &n) && n == 4);
+    assert(find_text(index, "[ 1, 2 ]", &n) && n == 4); /* Compared as values, not text */
+    assert(!find_text(index, "8", &n));
+    assert(!find_text(index, "\"7\"", &n));
+    assert(!edn_index_find(index, NULL, &n));
+
+    assert(find_text(index, "\"x\"", &n));
+    edn_result_t r = edn_index_get(index, n, NULL);
+    assert(r.error == EDN_OK);
+    size_t length;
+    const char* name = edn_string_get(edn_map_get_keyword(r.value, "name"), &length);
+    assert(name != NULL && length == 2 && memcmp(name, "ex", 2) == 0);
+    edn_free(r.value);
+    edn_index_close(index);
+
+    options.key = "user/id";
+    assert(edn_index_build(DATA_PATH, &options).error == EDN_OK);
+    index = edn_index_open(DATA_PATH, NULL, NULL);
+    assert(index != NULL);
+    assert(find_text(index, "7", &n) && n == 6);
+    edn_index_close(index);
+
+    options.key = "not a keyword";
+    assert(edn_index_build(DATA_PATH, &options).error == EDN_ERROR_INVALID_ARGUMENT);
+
+    remove(DATA_PATH);
+    remove(INDEX_PATH);
+}
+
+TEST(index_many_keyed_forms) {
+    const int records = 5000;
+    FILE* f = fopen(DATA_PATH, "wb");
+    assert(f != NULL);
+    for (int i = 0; i < records; i++) {
+        fprintf(f, "{:id %d :tag :t%d :payload [\"%d\" %d.5]}\n", i * 3, i % 17, i, i);
+    }
+    assert(fclose(f) == 0);
+
+    edn_index_options_t options = {0};
+    options.struct_size = sizeof(options);
+    options.key = "id";
+    assert(edn_index_build(DATA_PATH, &options).error == EDN_OK);
+    edn_index_t* index = edn_index_open(DATA_PATH, NULL, NULL);
+    assert(index != NULL && edn_index_count(index) == (size_t) records);
+
+    for (int i = 0; i < records; i += 7) {
+        char key[32];
+        snprintf(key, sizeof(key), "%d", i * 3);
+        size_t n;
+        assert(find_text(index, key, &n) && n == (size_t) i);
+        snprintf(key, sizeof(key), "%d", i * 3 + 1);
+        assert(!find_text(index, key, &n));
+    }
+
+    edn_result_t r = edn_index_get(index, 4321, NULL);
+    assert(r.error == EDN_OK);
+    int64_t id;
+    assert(edn_int64_get(edn_map_get_keyword(r.value, "id"), &id) && id == 4321 * 3);
+    edn_free(r.value);
+
+    edn_index_close(index);
+    remove(DATA_PATH);
+    remove(INDEX_PATH);
+}
+
+TEST(index_errors) {
+    /* Structural errors are found while indexing, with file positions */
+    assert(write_text(DATA_PATH, "{:a 1}\n{:b 2}\n[\"open]\n"));
+    edn_result_t r = edn_index_build(DATA_PATH, NULL);
+    assert(r.error == EDN_ERROR_INVALID_STRING);
+    assert(r.error_start.offset == 15 && r.error_start.line == 3 && r.error_start.column == 2);
+
+    assert(write_text(DATA_PATH, "{:a 1} )"));
+    r = edn_index_build(DATA_PATH, NULL);
+    assert(r.error == EDN_ERROR_UNMATCHED_DELIMITER && r.error_start.offset == 7);
+
+    /* Atoms are only checked when the form is read */
+    assert(write_text(DATA_PATH, "{:a 1}\n  {:b 1.2.3}\n"));
+    assert(edn_index_build(DATA_PATH, NULL).error == EDN_OK);
+    edn_index_t* index = edn_index_open(DATA_PATH, NULL, NULL);
+    assert(index != NULL && edn_index_count(index) == 2);
+    r = edn_index_get(index, 1, NULL);
+    assert(r.error == EDN_ERROR_INVALID_NUMBER && r.value == NULL);
+    assert(r.error_start.line == 2 && r.error_start.column == 7);
+    edn_index_close(index);
+
+    /* ...unless a key is requested */
+    edn_index_options_t options = {0};
+    options.struct_size = sizeof(options);
+    options.key = "a";
+    r = edn_index_build(DATA_PATH, &options);
+    assert(r.error == EDN_ERROR_INVALID_NUMBER && r.error_start.line == 2);
+
+    /* Stale, truncated and missing files */
+    assert(write_text(DATA_PATH, "1 2 3"));
+    assert(edn_index_build(DATA_PATH, NULL).error == EDN_OK);
+    assert(write_text(DATA_PATH, "1 2 3 4"));
+    edn_error_t error = EDN_OK;
+    assert(edn_index_open(DATA_PATH, NULL, &error) == NULL && error == EDN_ERROR_INVALID_STATE);
+
+    assert(write_text(INDEX_PATH, "EDNIDX"));
+    assert(edn_index_open(DATA_PATH, NULL, &error) == NULL && error == EDN_ERROR_INVALID_STATE);
+
+    remove(INDEX_PATH);
+    assert(edn_index_open(DATA_PATH, NULL, &error) == NULL && error == EDN_ERROR_IO_FAILURE);
+    remove(DATA_PATH);
+    r = edn_index_build(DATA_PATH, NULL);
+    assert(r.error == EDN_ERROR_IO_FAILURE);
+    assert(edn_index_build(NULL, NULL).error == EDN_ERROR_INVALID_ARGUMENT);
+    assert(edn_index_count(NULL) == 0);
+    edn_index_close(NULL);
+}
+
+int main(void) {
+    printf("Running index tests...\n");
+
+    RUN_TEST(index_top_level_forms);
+    RUN_TEST(index_vector_elements);
+    RUN_TEST(index_keys);
+    RUN_TEST(index_many_keyed_forms);
+    RUN_TEST(index_errors);
+
+    TEST_SUMMARY("index");
+}
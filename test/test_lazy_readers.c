@@ -0,0 +1,199 @@
+/**
+ * Test lazy (deferred) tagged-literal readers
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "test_framework.h"
+
+static int reader_calls;
+
+/* #twice n → 2n, counting invocations */
+static edn_value_t* twice_reader(edn_value_t* value, edn_arena_t* arena,
+                                 const char** error_message) {
+    reader_calls++;
+    int64_t n;
+    if (!edn_int64_get(value, &n)) {
+        *error_message = "#twice requires an integer";
+        return NULL;
+    }
+    int64_t* slot = edn_arena_alloc(arena, sizeof(int64_t));
+    if (slot == NULL) {
+        *error_message = "Out of memory";
+        return NULL;
+    }
+    *slot = n * 2;
+    return edn_external_create(arena, slot, 0x54574943u);
+}
+
+static int64_t twice_value(const edn_value_t* v) {
+    void* data = NULL;
+    if (!edn_external_get(v, &data, NULL)) {
+        return -1;
+    }
+    return *(int64_t*) data;
+}
+
+TEST(lazy_not_invoked_during_parse) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    assert(edn_reader_register_lazy(registry, "twice", twice_reader));
+    assert(edn_reader_lookup(registry, "twice") == twice_reader);
+
+    reader_calls = 0;
+    edn_result_t r = read_with("[#twice 1 #twice 2 #twice 3]", registry, false);
+    assert(r.error == EDN_OK);
+    assert_int_eq(reader_calls, 0);
+
+    edn_value_t* first = edn_vector_get(r.value, 0);
+    assert(edn_type(first) == EDN_TYPE_TAGGED);
+
+    edn_free(r.value);
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(lazy_resolve_caches) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_lazy(registry, "twice", twice_reader);
+
+    reader_calls = 0;
+    edn_result_t r = read_with("[#twice 21 #twice 5]", registry, false);
+    assert(r.error == EDN_OK);
+
+    edn_value_t* tagged = edn_vector_get(r.value, 0);
+    edn_value_t* resolved = edn_tagged_resolve(tagged, NULL);
+    assert(resolved != NULL);
+    assert(twice_value(resolved) == 42);
+    assert_int_eq(reader_calls, 1);
+
+    /* Second access hits the cache */
+    assert(edn_tagged_resolve(tagged, NULL) == resolved);
+    assert_int_eq(reader_calls, 1);
+
+    /* Source position covers the whole literal */
+    size_t start, end;
+    assert(edn_source_position(resolved, &start, &end));
+    assert_int_eq(start, 1);
+    assert_int_eq(end, 10);
+
+    /* Untouched sibling still unresolved */
+    assert_int_eq(reader_calls, 1);
+
+    edn_free(r.value);
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(lazy_tagged_get_resolves) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_lazy(registry, "twice", twice_reader);
+
+    reader_calls = 0;
+    edn_result_t r = read_with("#twice 4", registry, false);
+    assert(r.error == EDN_OK);
+
+    const char* tag;
+    size_t tag_length;
+    edn_value_t* inner;
+    assert(edn_tagged_get(r.value, &tag, &tag_length, &inner));
+    assert_int_eq(tag_length, 5);
+    assert(strncmp(tag, "twice", 5) == 0);
+    assert(twice_value(inner) == 8);
+    assert(edn_tagged_get(r.value, &tag, &tag_length, &inner));
+    assert_int_eq(reader_calls, 1);
+
+    edn_free(r.value);
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(lazy_reader_error) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_lazy(registry, "twice", twice_reader);
+
+    reader_calls = 0;
+    /* Parse succeeds: the reader has not run yet */
+    edn_result_t r = read_with("#twice \"x\"", registry, false);
+    assert(r.error == EDN_OK);
+
+    const char* error = NULL;
+    assert(edn_tagged_resolve(r.value, &error) == NULL);
+    assert_str_eq(error, "#twice requires an integer");
+
+    /* Failure is cached too */
+    error = NULL;
+    assert(edn_tagged_resolve(r.value, &error) == NULL);
+    assert_str_eq(error, "#twice requires an integer");
+    assert_int_eq(reader_calls, 1);
+
+    const char* tag;
+    edn_value_t* inner;
+    assert_false(edn_tagged_get(r.value, &tag, NULL, &inner));
+
+    edn_free(r.value);
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(resolve_non_lazy_values) {
+    edn_result_t r = edn_read("[#foo 1 2]", 0);
+    assert(r.error == EDN_OK);
+
+    edn_value_t* tagged = edn_vector_get(r.value, 0);
+    const char* error = "unset";
+    assert(edn_tagged_resolve(tagged, &error) == tagged);
+    assert(error == NULL);
+    assert(edn_tagged_resolve(edn_vector_get(r.value, 1), NULL) == edn_vector_get(r.value, 1));
+    assert(edn_tagged_resolve(NULL, NULL) == NULL);
+
+    edn_free(r.value);
+}
+
+TEST(lazy_equality_and_writer_use_literal) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_lazy(registry, "twice", twice_reader);
+
+    reader_calls = 0;
+    edn_result_t r = read_with("#{#twice 1 #twice 2}", registry, false);
+    assert(r.error == EDN_OK);
+    assert_int_eq(edn_set_count(r.value), 2);
+
+    char* out = edn_write_string(edn_set_get(r.value, 0), NULL, NULL);
+    assert(out != NULL);
+    assert(strncmp(out, "#twice ", 7) == 0);
+    free(out);
+    assert_int_eq(reader_calls, 0);
+    edn_free(r.value);
+
+    r = read_with("#{#twice 1 #twice 1}", registry, false);
+    assert(r.error == EDN_ERROR_DUPLICATE_ELEMENT);
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(lazy_replaced_by_eager) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_lazy(registry, "twice", twice_reader);
+    edn_reader_register(registry, "twice", twice_reader);
+
+    reader_calls = 0;
+    edn_result_t r = read_with("#twice 3", registry, false);
+    assert(r.error == EDN_OK);
+    assert_int_eq(reader_calls, 1);
+    assert(edn_type(r.value) == EDN_TYPE_EXTERNAL);
+
+    edn_free(r.value);
+    edn_reader_registry_destroy(registry);
+}
+
+int main(void) {
+    printf("Running lazy reader tests...\n");
+
+    RUN_TEST(lazy_not_invoked_during_parse);
+    RUN_TEST(lazy_resolve_caches);
+    RUN_TEST(lazy_tagged_get_resolves);
+    RUN_TEST(lazy_reader_error);
+    RUN_TEST(resolve_non_lazy_values);
+    RUN_TEST(lazy_equality_and_writer_use_literal);
+    RUN_TEST(lazy_replaced_by_eager);
+
+    TEST_SUMMARY("lazy reader");
+}
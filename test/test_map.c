@@ -2,6 +2,7 @@
  * Test map parser
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "../include/edn.h"
@@ -298,6 +299,107 @@ TEST(map_api_wrong_type) {
     edn_free(result.value);
 }
 
+/* Keyword lookups distinguish namespace from name */
+TEST(map_keyword_lookup_namespaces) {
+    edn_result_t result = edn_read("{:a/bc 1 :ab/c 2 :abc 3 :bc 4}", 0);
+    assert(result.error == EDN_OK);
+
+    int64_t num;
+    assert(edn_int64_get(edn_map_get_namespaced_keyword(result.value, "a", "bc"), &num));
+    assert(num == 1);
+    assert(edn_int64_get(edn_map_get_namespaced_keyword(result.value, "ab", "c"), &num));
+    assert(num == 2);
+    assert(edn_int64_get(edn_map_get_keyword(result.value, "abc"), &num));
+    assert(num == 3);
+    assert(edn_int64_get(edn_map_get_keyword(result.value, "bc"), &num));
+    assert(num == 4);
+    assert(edn_map_get_namespaced_keyword(result.value, "a", "b") == NULL);
+    assert(edn_map_get_keyword(result.value, "c") == NULL);
+
+    edn_free(result.value);
+}
+
+/* Keyword keys too long to summarize are still found */
+TEST(map_keyword_lookup_long_key) {
+    size_t name_len = 70000;
+    char* input = malloc(name_len + 16);
+    assert(input != NULL);
+    input[0] = '{';
+    input[1] = ':';
+    memset(input + 2, 'k', name_len);
+    strcpy(input + 2 + name_len, " 7 :k 8}");
+
+    edn_result_t result = edn_read(input, 0);
+    assert(result.error == EDN_OK);
+
+    char* name = malloc(name_len + 1);
+    assert(name != NULL);
+    memset(name, 'k', name_len);
+    name[name_len] = '\0';
+
+    int64_t num;
+    assert(edn_int64_get(edn_map_get_keyword(result.value, name), &num));
+    assert(num == 7);
+    assert(edn_int64_get(edn_map_get_keyword(result.value, "k"), &num));
+    assert(num == 8);
+
+    edn_result_t key = edn_read(input + 1, name_len + 1);
+    assert(key.error == EDN_OK);
+    assert(edn_map_contains_key(result.value, key.value));
+
+    edn_free(key.value);
+    free(name);
+    edn_free(result.value);
+    free(input);
+}
+
+/* Non-keyword keys are found alongside keyword keys */
+TEST(map_lookup_mixed_keys) {
+    edn_result_t result = edn_read("{:a 1 \"a\" 2 a 3 1 4 [:a] 5}", 0);
+    assert(result.error == EDN_OK);
+
+    const char* probes[] = {":a", "\"a\"", "a", "1", "[:a]"};
+    for (int i = 0; i < 5; i++) {
+        edn_result_t key = edn_read(probes[i], 0);
+        assert(key.error == EDN_OK);
+        int64_t num;
+        assert(edn_int64_get(edn_map_lookup(result.value, key.value), &num));
+        assert(num == i + 1);
+        edn_free(key.value);
+    }
+
+    edn_result_t missing = edn_read("[:b]", 0);
+    assert(!edn_map_contains_key(result.value, missing.value));
+    edn_free(missing.value);
+
+    edn_free(result.value);
+}
+
+/* Every key of a wide map is reachable by keyword lookup */
+TEST(map_wide_keyword_lookup) {
+    char input[8192];
+    size_t pos = (size_t) snprintf(input, sizeof(input), "{");
+    for (int i = 0; i < 300; i++) {
+        pos += (size_t) snprintf(input + pos, sizeof(input) - pos, ":f/k%d %d ", i, i);
+    }
+    snprintf(input + pos, sizeof(input) - pos, "}");
+
+    edn_result_t result = edn_read(input, 0);
+    assert(result.error == EDN_OK);
+    assert(edn_map_count(result.value) == 300);
+
+    for (int i = 0; i < 300; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "k%d", i);
+        int64_t num;
+        assert(edn_int64_get(edn_map_get_namespaced_keyword(result.value, "f", name), &num));
+        assert(num == i);
+        assert(edn_map_get_keyword(result.value, name) == NULL);
+    }
+
+    edn_free(result.value);
+}
+
 /* API with NULL */
 TEST(map_api_null) {
     assert(edn_map_count(NULL) == 0);
@@ -332,6 +434,10 @@ int main(void) {
     RUN_TEST(parse_large_map_with_duplicate);
     RUN_TEST(map_get_out_of_bounds);
     RUN_TEST(map_api_wrong_type);
+    RUN_TEST(map_keyword_lookup_namespaces);
+    RUN_TEST(map_keyword_lookup_long_key);
+    RUN_TEST(map_lookup_mixed_keys);
+    RUN_TEST(map_wide_keyword_lookup);
     RUN_TEST(map_api_null);
 
     TEST_SUMMARY("map");
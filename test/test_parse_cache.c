@@ -0,0 +1,500 @@
+/**
+ * Test the parse-result cache (edn_parse_cache_t)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "../src/edn_internal.h"
+#include "test_framework.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define HAVE_PTHREAD 1
+#endif
+
+static edn_value_t* passthrough_reader(edn_value_t* value, edn_arena_t* arena,
+                                       const char** error_message) {
+    (void) arena;
+    (void) error_message;
+    return value;
+}
+
+TEST(cache_hit_shares_tree) {
+    edn_parse_cache_t* cache = edn_parse_cache_create(1024 * 1024, 4);
+    assert(cache != NULL);
+
+    const char* input = "{:name \"a\\tb\" :ids [1 2 3]}";
+    edn_result_t a = edn_parse_cache_read(cache, input, 0, NULL);
+    assert(a.error == EDN_OK);
+    edn_result_t b = edn_parse_cache_read(cache, input, 0, NULL);
+    assert(b.error == EDN_OK);
+    assert(a.value == b.value);
+
+    edn_parse_cache_stats_t stats;
+    edn_parse_cache_stats(cache, &stats);
+    assert(stats.hits == 1 && stats.misses == 1);
+    assert(stats.entries == 1 && stats.memory > strlen(input));
+    assert(stats.max_memory <= 1024 * 1024);
+
+    /* One reader letting go leaves the tree to the others */
+    edn_free(a.value);
+    edn_value_t* ids = edn_map_get_keyword(b.value, "ids");
+    assert(edn_vector_count(ids) == 3);
+    edn_free(b.value);
+
+    edn_parse_cache_destroy(cache);
+}
+
+TEST(cache_owns_input) {
+    edn_parse_cache_t* cache = edn_parse_cache_create(1024 * 1024, 0);
+    assert(cache != NULL);
+
+    char* buffer = malloc(64);
+    assert(buffer != NULL);
+    strcpy(buffer, "[\"hello\" :kw sym]");
+    edn_result_t a = edn_parse_cache_read(cache, buffer, 0, NULL);
+    assert(a.error == EDN_OK);
+    memset(buffer, 'x', 63);
+    buffer[63] = '\0';
+
+    size_t length;
+    assert(strcmp(edn_string_get(edn_vector_get(a.value, 0), &length), "hello") == 0);
+    const char* name;
+    assert(edn_keyword_get(edn_vector_get(a.value, 1), NULL, NULL, &name, &length));
+    assert(length == 2 && memcmp(name, "kw", 2) == 0);
+
+    /* Found again from a different buffer with the same bytes */
+    strcpy(buffer, "[\"hello\" :kw sym]");
+    edn_result_t b = edn_parse_cache_read(cache, buffer, strlen(buffer), NULL);
+    assert(b.value == a.value);
+    free(buffer);
+
+    edn_free(a.value);
+    edn_free(b.value);
+    edn_parse_cache_destroy(cache);
+}
+
+TEST(cache_key_includes_options) {
+    edn_parse_cache_t* cache = edn_parse_cache_create(1024 * 1024, 2);
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    assert(cache != NULL && registry != NULL);
+    assert(edn_reader_register(registry, "t", passthrough_reader));
+
+    const char* input = "[#t 1 2]";
+    edn_result_t plain = edn_parse_cache_read(cache, input, 0, NULL);
+
+    edn_parse_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.reader_registry = registry;
+    edn_result_t with_reader = edn_parse_cache_read(cache, input, 0, &opts);
+    assert(plain.error == EDN_OK && with_reader.error == EDN_OK);
+    assert(plain.value != with_reader.value);
+    assert(edn_type(edn_vector_get(plain.value, 0)) == EDN_TYPE_TAGGED);
+    assert(edn_type(edn_vector_get(with_reader.value, 0)) == EDN_TYPE_INT);
+
+    /* Arena sizing does not change the result, so it shares the entry */
+    opts.arena_initial_block = 4096;
+    edn_result_t sized = edn_parse_cache_read(cache, input, 0, &opts);
+    assert(sized.value == with_reader.value);
+
+    opts.strict_utf8 = true;
+    edn_result_t strict = edn_parse_cache_read(cache, input, 0, &opts);
+    assert(strict.value != with_reader.value);
+
+    edn_parse_cache_stats_t stats;
+    edn_parse_cache_stats(cache, &stats);
+    assert(stats.misses == 3 && stats.hits == 1 && stats.entries == 3);
+
+    edn_free(plain.value);
+    edn_free(with_reader.value);
+    edn_free(sized.value);
+    edn_free(strict.value);
+    edn_parse_cache_destroy(cache);
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(cache_key_follows_registry_changes) {
+    edn_parse_cache_t* cache = edn_parse_cache_create(1024 * 1024, 2);
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    assert(cache != NULL && registry != NULL);
+
+    edn_parse_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.reader_registry = registry;
+    const char* input = "[#t 1 2]";
+
+    edn_result_t before = edn_parse_cache_read(cache, input, 0, &opts);
+    assert(before.error == EDN_OK);
+    assert(edn_type(edn_vector_get(before.value, 0)) == EDN_TYPE_TAGGED);
+
+    assert(edn_reader_register(registry, "t", passthrough_reader));
+    edn_result_t registered = edn_parse_cache_read(cache, input, 0, &opts);
+    assert(registered.error == EDN_OK);
+    assert(edn_type(edn_vector_get(registered.value, 0)) == EDN_TYPE_INT);
+
+    /* Unchanged registry: a hit */
+    edn_result_t again = edn_parse_cache_read(cache, input, 0, &opts);
+    assert(again.value == registered.value);
+
+    edn_reader_unregister(registry, "t");
+    edn_result_t unregistered = edn_parse_cache_read(cache, input, 0, &opts);
+    assert(unregistered.value != before.value);
+    assert(edn_type(edn_vector_get(unregistered.value, 0)) == EDN_TYPE_TAGGED);
+
+    /* A new registry at a reused address is not the old one */
+    edn_reader_registry_destroy(registry);
+    registry = edn_reader_registry_create();
+    assert(registry != NULL);
+    opts.reader_registry = registry;
+    edn_result_t fresh = edn_parse_cache_read(cache, input, 0, &opts);
+    assert(fresh.value != unregistered.value);
+
+    edn_parse_cache_stats_t stats;
+    edn_parse_cache_stats(cache, &stats);
+    assert(stats.misses == 4 && stats.hits == 1);
+
+    edn_free(before.value);
+    edn_free(registered.value);
+    edn_free(again.value);
+    edn_free(unregistered.value);
+    edn_free(fresh.value);
+    edn_parse_cache_destroy(cache);
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(cache_trees_are_frozen) {
+    edn_parse_cache_t* cache = edn_parse_cache_create(1024 * 1024, 1);
+    assert(cache != NULL);
+
+    edn_result_t r = edn_parse_cache_read(cache, "[\"a\\nb\" \"plain\" #{1 2} {:k \"v\"}]", 0, NULL);
+    assert(r.error == EDN_OK);
+
+    edn_memory_stats_t before;
+    assert(edn_value_memory_usage(r.value, &before));
+    size_t length;
+    assert(strcmp(edn_string_get(edn_vector_get(r.value, 0), &length), "a\nb") == 0);
+    assert(strcmp(edn_string_get(edn_vector_get(r.value, 1), &length), "plain") == 0);
+    edn_value_hash(r.value);
+    edn_result_t copy = edn_read("[\"a\\nb\" \"plain\" #{1 2} {:k \"v\"}]", 0);
+    assert(edn_value_equal(copy.value, r.value));
+    edn_free(copy.value);
+
+    /* Nothing was allocated or decoded after publication */
+    edn_memory_stats_t after;
+    assert(edn_value_memory_usage(r.value, &after));
+    assert(memcmp(&before, &after, sizeof(before)) == 0);
+
+    edn_free(r.value);
+    edn_parse_cache_destroy(cache);
+}
+
+#define NESTED_DOCUMENT "[[1 2] {:a \"x\\ny\" :b [3 4.5]} #{:k \"v\" 7N} (1 (2 (3))) #tag {:z 1.0M}]"
+
+/* True if `value` and everything under it has its hash cached */
+static bool hashes_cached(const edn_value_t* value) {
+    if (value->cached_hash == 0) {
+        return false;
+    }
+    switch (value->type) {
+        case EDN_TYPE_LIST:
+        case EDN_TYPE_VECTOR:
+            for (size_t i = 0; i < value->as.list.count; i++) {
+                if (!hashes_cached(value->as.list.elements[i])) {
+                    return false;
+                }
+            }
+            return true;
+        case EDN_TYPE_SET:
+            for (size_t i = 0; i < value->as.set.count; i++) {
+                if (!hashes_cached(value->as.set.elements[i])) {
+                    return false;
+                }
+            }
+            return true;
+        case EDN_TYPE_MAP:
+            for (size_t i = 0; i < value->as.map.count; i++) {
+                if (!hashes_cached(value->as.map.entries[i].key) ||
+                    !hashes_cached(value->as.map.entries[i].value)) {
+                    return false;
+                }
+            }
+            return true;
+        case EDN_TYPE_TAGGED:
+            return hashes_cached(value->as.tagged.value);
+        default:
+            return true;
+    }
+}
+
+TEST(cache_child_hashes_precomputed) {
+    edn_parse_cache_t* cache = edn_parse_cache_create(1024 * 1024, 1);
+    assert(cache != NULL);
+
+    edn_result_t r = edn_parse_cache_read(cache, NESTED_DOCUMENT, 0, NULL);
+    assert(r.error == EDN_OK);
+    assert(hashes_cached(r.value));
+
+    /* Cached child hashes are the ones a fresh tree computes */
+    edn_result_t copy = edn_read(NESTED_DOCUMENT, 0);
+    assert(copy.error == EDN_OK);
+    for (size_t i = 0; i < edn_vector_count(r.value); i++) {
+        assert(edn_value_hash(edn_vector_get(r.value, i)) ==
+               edn_value_hash(edn_vector_get(copy.value, i)));
+    }
+    assert(edn_value_hash(r.value) == edn_value_hash(copy.value));
+    edn_free(copy.value);
+
+    edn_free(r.value);
+    edn_parse_cache_destroy(cache);
+}
+
+static char* numbers_document(int first, int count) {
+    size_t cap = (size_t) count * 12 + 16;
+    char* input = malloc(cap);
+    if (input == NULL) {
+        return NULL;
+    }
+    size_t pos = (size_t) snprintf(input, cap, "[");
+    for (int i = 0; i < count; i++) {
+        pos += (size_t) snprintf(input + pos, cap - pos, "%d ", first + i);
+    }
+    snprintf(input + pos, cap - pos, "]");
+    return input;
+}
+
+TEST(cache_evicts_least_recently_used) {
+    char* docs[4];
+    for (int i = 0; i < 4; i++) {
+        docs[i] = numbers_document(i * 1000, 1000);
+        assert(docs[i] != NULL);
+    }
+
+    /* Room for about two documents */
+    edn_result_t probe = edn_read(docs[0], 0);
+    edn_memory_stats_t usage;
+    assert(edn_value_memory_usage(probe.value, &usage));
+    edn_free(probe.value);
+    size_t cap = (usage.allocated + strlen(docs[0])) * 5 / 2;
+    edn_parse_cache_t* cache = edn_parse_cache_create(cap, 1);
+    assert(cache != NULL);
+
+    edn_result_t held = edn_parse_cache_read(cache, docs[0], 0, NULL);
+    assert(held.error == EDN_OK);
+    edn_result_t r = edn_parse_cache_read(cache, docs[1], 0, NULL);
+    edn_free(r.value);
+    r = edn_parse_cache_read(cache, docs[0], 0, NULL); /* docs[0] is now most recent */
+    assert(r.value == held.value);
+    edn_free(r.value);
+    r = edn_parse_cache_read(cache, docs[2], 0, NULL); /* Evicts docs[1] */
+    edn_free(r.value);
+
+    edn_parse_cache_stats_t stats;
+    edn_parse_cache_stats(cache, &stats);
+    assert(stats.evictions == 1 && stats.entries == 2);
+    assert(stats.memory <= cap);
+
+    r = edn_parse_cache_read(cache, docs[0], 0, NULL);
+    assert(r.value == held.value);
+    edn_free(r.value);
+    r = edn_parse_cache_read(cache, docs[1], 0, NULL);
+    edn_free(r.value);
+    edn_parse_cache_stats(cache, &stats);
+    assert(stats.hits == 2 && stats.misses == 4);
+
+    /* Evicted while held: still valid */
+    r = edn_parse_cache_read(cache, docs[3], 0, NULL);
+    edn_free(r.value);
+    edn_parse_cache_clear(cache);
+    edn_parse_cache_stats(cache, &stats);
+    assert(stats.entries == 0 && stats.memory == 0);
+    int64_t n;
+    assert(edn_int64_get(edn_vector_get(held.value, 999), &n) && n == 999);
+    edn_free(held.value);
+
+    edn_parse_cache_destroy(cache);
+    for (int i = 0; i < 4; i++) {
+        free(docs[i]);
+    }
+}
+
+TEST(cache_skips_errors_and_oversized) {
+    edn_parse_cache_t* cache = edn_parse_cache_create(4096, 1);
+    assert(cache != NULL);
+
+    edn_result_t r = edn_parse_cache_read(cache, "[1 2\n {:a}", 0, NULL);
+    assert(r.error == EDN_ERROR_INVALID_SYNTAX);
+    assert(r.value == NULL);
+    assert(r.error_start.line == 2);
+
+    char* big = numbers_document(0, 5000);
+    assert(big != NULL);
+    r = edn_parse_cache_read(cache, big, 0, NULL);
+    assert(r.error == EDN_OK);
+    assert(edn_vector_count(r.value) == 5000);
+    free(big);
+    edn_free(r.value);
+
+    edn_parse_cache_stats_t stats;
+    edn_parse_cache_stats(cache, &stats);
+    assert(stats.entries == 0 && stats.uncached == 1 && stats.misses == 2);
+
+    /* No cache: plain parse */
+    r = edn_parse_cache_read(NULL, "[1]", 0, NULL);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+
+    edn_parse_cache_destroy(cache);
+}
+
+TEST(cache_outlived_by_readers) {
+    edn_parse_cache_t* cache = edn_parse_cache_create(1024 * 1024, 0);
+    assert(cache != NULL);
+    edn_result_t r = edn_parse_cache_read(cache, "{:a [1 2]}", 0, NULL);
+    assert(r.error == EDN_OK);
+    edn_parse_cache_destroy(cache);
+    assert(edn_map_count(r.value) == 1);
+    edn_free(r.value);
+}
+
+#ifdef HAVE_PTHREAD
+#define THREADS 8
+#define READS 2000
+#define DOCS 16
+
+typedef struct {
+    edn_parse_cache_t* cache;
+    char** docs;
+    int seed;
+    int failures;
+} worker_t;
+
+static void* worker(void* arg) {
+    worker_t* w = arg;
+    for (int i = 0; i < READS; i++) {
+        int d = (i / 4 + w->seed) % DOCS; /* Each document a few times running */
+        edn_result_t r = edn_parse_cache_read(w->cache, w->docs[d], 0, NULL);
+        int64_t first;
+        if (r.error != EDN_OK || edn_vector_count(r.value) != 50 ||
+            !edn_int64_get(edn_vector_get(r.value, 0), &first) || first != d * 50) {
+            w->failures++;
+        }
+        edn_free(r.value);
+    }
+    return NULL;
+}
+
+typedef struct {
+    edn_parse_cache_t* cache;
+    int failures;
+} hash_worker_t;
+
+/* Hash and compare the children of a shared cached root. The tree is read
+ * once up front, so no cache lock orders the threads' accesses to it. */
+static void* hash_worker(void* arg) {
+    hash_worker_t* w = arg;
+    edn_result_t r = edn_parse_cache_read(w->cache, NESTED_DOCUMENT, 0, NULL);
+    edn_result_t copy = edn_read(NESTED_DOCUMENT, 0);
+    if (r.error != EDN_OK || copy.error != EDN_OK) {
+        w->failures++;
+    } else {
+        for (int i = 0; i < READS / 10; i++) {
+            for (size_t j = 0; j < edn_vector_count(r.value); j++) {
+                const edn_value_t* shared = edn_vector_get(r.value, j);
+                const edn_value_t* own = edn_vector_get(copy.value, j);
+                if (edn_value_hash(shared) != edn_value_hash(own) ||
+                    !edn_value_equal(shared, own)) {
+                    w->failures++;
+                }
+            }
+            const edn_value_t* shared_b = edn_map_get_keyword(edn_vector_get(r.value, 1), "b");
+            const edn_value_t* own_b = edn_map_get_keyword(edn_vector_get(copy.value, 1), "b");
+            if (!edn_value_equal(shared_b, own_b)) {
+                w->failures++;
+            }
+        }
+    }
+    edn_free(copy.value);
+    edn_free(r.value);
+    return NULL;
+}
+
+TEST(cache_concurrent_child_hashes) {
+    edn_parse_cache_t* cache = edn_parse_cache_create(1024 * 1024, 1);
+    assert(cache != NULL);
+    edn_result_t root = edn_parse_cache_read(cache, NESTED_DOCUMENT, 0, NULL);
+    assert(root.error == EDN_OK);
+
+    pthread_t threads[THREADS];
+    hash_worker_t workers[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        workers[i] = (hash_worker_t) {cache, 0};
+        assert(pthread_create(&threads[i], NULL, hash_worker, &workers[i]) == 0);
+    }
+    int failures = 0;
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        failures += workers[i].failures;
+    }
+    assert(failures == 0);
+
+    edn_free(root.value);
+    edn_parse_cache_destroy(cache);
+}
+
+TEST(cache_concurrent_readers) {
+    char* docs[DOCS];
+    for (int i = 0; i < DOCS; i++) {
+        docs[i] = numbers_document(i * 50, 50);
+        assert(docs[i] != NULL);
+    }
+    /* Small enough that threads also race on evictions */
+    edn_parse_cache_t* cache = edn_parse_cache_create(32 * 1024, 2);
+    assert(cache != NULL);
+
+    pthread_t threads[THREADS];
+    worker_t workers[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        workers[i] = (worker_t) {cache, docs, i, 0};
+        assert(pthread_create(&threads[i], NULL, worker, &workers[i]) == 0);
+    }
+    int failures = 0;
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        failures += workers[i].failures;
+    }
+    assert(failures == 0);
+
+    edn_parse_cache_stats_t stats;
+    edn_parse_cache_stats(cache, &stats);
+    assert(stats.hits + stats.misses == THREADS * READS);
+    assert(stats.hits > 0 && stats.evictions > 0);
+    assert(stats.memory <= stats.max_memory);
+
+    edn_parse_cache_destroy(cache);
+    for (int i = 0; i < DOCS; i++) {
+        free(docs[i]);
+    }
+}
+#endif
+
+int main(void) {
+    printf("Running parse cache tests...\n");
+
+    RUN_TEST(cache_hit_shares_tree);
+    RUN_TEST(cache_owns_input);
+    RUN_TEST(cache_key_includes_options);
+    RUN_TEST(cache_key_follows_registry_changes);
+    RUN_TEST(cache_trees_are_frozen);
+    RUN_TEST(cache_child_hashes_precomputed);
+    RUN_TEST(cache_evicts_least_recently_used);
+    RUN_TEST(cache_skips_errors_and_oversized);
+    RUN_TEST(cache_outlived_by_readers);
+#ifdef HAVE_PTHREAD
+    RUN_TEST(cache_concurrent_readers);
+    RUN_TEST(cache_concurrent_child_hashes);
+#endif
+
+    TEST_SUMMARY("parse cache");
+}
@@ -0,0 +1,181 @@
+/**
+ * Test parse statistics and trace hooks (EDN_ENABLE_INSTRUMENTATION)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "test_framework.h"
+
+#ifdef EDN_ENABLE_INSTRUMENTATION
+static edn_value_t* count_reader(edn_value_t* value, edn_arena_t* arena,
+                                 const char** error_message) {
+    (void) arena;
+    (void) error_message;
+    return value;
+}
+
+TEST(stats_tree_shape) {
+    const char* input = "[1 2.5 \"a\\nb\" \"plain\" :k {:a (x y) :b #{1 2}} #tag nil]";
+    edn_parse_stats_t stats;
+    edn_result_t r = edn_read_with_stats(input, 0, NULL, &stats);
+    assert(r.error == EDN_OK);
+
+    assert(stats.bytes_scanned == strlen(input));
+    assert(stats.nodes[EDN_TYPE_VECTOR] == 1);
+    assert(stats.nodes[EDN_TYPE_INT] == 3);
+    assert(stats.nodes[EDN_TYPE_FLOAT] == 1);
+    assert(stats.nodes[EDN_TYPE_STRING] == 2);
+    assert(stats.nodes[EDN_TYPE_KEYWORD] == 3);
+    assert(stats.nodes[EDN_TYPE_MAP] == 1);
+    assert(stats.nodes[EDN_TYPE_LIST] == 1);
+    assert(stats.nodes[EDN_TYPE_SYMBOL] == 2);
+    assert(stats.nodes[EDN_TYPE_SET] == 1);
+    assert(stats.nodes[EDN_TYPE_TAGGED] == 1);
+    assert(stats.nodes[EDN_TYPE_NIL] == 1);
+    assert(stats.max_depth == 3);
+    assert(stats.strings_with_escapes == 1);
+    assert(stats.strtod_fallbacks == 0);
+    assert(stats.reader_calls == 0);
+    assert(stats.arena_blocks >= 1);
+
+    /* One map and one set, both small enough for the linear tier */
+    assert(stats.duplicate_checks[EDN_DUPLICATE_TIER_LINEAR] == 2);
+    assert(stats.duplicate_checks[EDN_DUPLICATE_TIER_SORTED] == 0);
+    assert(stats.duplicate_checks[EDN_DUPLICATE_TIER_HASH] == 0);
+    edn_free(r.value);
+}
+
+TEST(stats_duplicate_tiers) {
+    size_t cap = 64 * 1024;
+    char* input = malloc(cap);
+    assert(input != NULL);
+    size_t pos = (size_t) snprintf(input, cap, "[#{");
+    for (int i = 0; i < 100; i++) {
+        pos += (size_t) snprintf(input + pos, cap - pos, "%d ", i);
+    }
+    pos += (size_t) snprintf(input + pos, cap - pos, "} #{");
+    for (int i = 0; i < 2000; i++) {
+        pos += (size_t) snprintf(input + pos, cap - pos, "%d ", i);
+    }
+    snprintf(input + pos, cap - pos, "}]");
+
+    edn_parse_stats_t stats;
+    edn_result_t r = edn_read_with_stats(input, 0, NULL, &stats);
+    assert(r.error == EDN_OK);
+    assert(stats.duplicate_checks[EDN_DUPLICATE_TIER_LINEAR] == 0);
+    assert(stats.duplicate_checks[EDN_DUPLICATE_TIER_SORTED] == 1);
+    assert(stats.duplicate_checks[EDN_DUPLICATE_TIER_HASH] == 1);
+    assert(stats.duplicate_check_ns[EDN_DUPLICATE_TIER_HASH] > 0);
+    assert(stats.nodes[EDN_TYPE_INT] == 2100);
+    edn_free(r.value);
+    free(input);
+}
+
+TEST(stats_hot_path_counters) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    assert(registry != NULL);
+    assert(edn_reader_register(registry, "count", count_reader));
+
+    edn_parse_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.reader_registry = registry;
+
+    /* 17 significant digits miss the Clinger fast path */
+    edn_parse_stats_t stats;
+    edn_result_t r =
+        edn_read_with_stats("[#count 1 #count 2 1.2345678901234567 #_ #count 3]", 0, &opts, &stats);
+    assert(r.error == EDN_OK);
+    assert(stats.reader_calls == 2); /* Discarded forms do not call readers */
+    assert(stats.strtod_fallbacks == 1);
+    edn_free(r.value);
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(stats_on_error) {
+    edn_parse_stats_t stats;
+    edn_result_t r = edn_read_with_stats("[1 2 #{3 3}]", 0, NULL, &stats);
+    assert(r.error == EDN_ERROR_DUPLICATE_ELEMENT);
+    assert(stats.bytes_scanned == 11);
+    assert(stats.duplicate_checks[EDN_DUPLICATE_TIER_LINEAR] == 1);
+    assert(stats.nodes[EDN_TYPE_INT] == 0); /* No tree to describe */
+    assert(stats.arena_blocks == 0);
+
+    r = edn_read_with_stats(NULL, 0, NULL, &stats);
+    assert(r.error == EDN_ERROR_INVALID_SYNTAX);
+    assert(stats.bytes_scanned == 0);
+
+    /* Stats are optional */
+    r = edn_read_with_stats("[1]", 0, NULL, NULL);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+}
+
+typedef struct {
+    int begins;
+    int ends;
+    edn_error_t last_error;
+    bool had_stats;
+    size_t last_length;
+} trace_log_t;
+
+static void trace(edn_trace_event_t event, const char* input, size_t length,
+                  const edn_result_t* result, const edn_parse_stats_t* stats, void* ctx) {
+    trace_log_t* log = ctx;
+    (void) input;
+    log->last_length = length;
+    if (event == EDN_TRACE_PARSE_BEGIN) {
+        log->begins++;
+        assert(result == NULL && stats == NULL);
+    } else {
+        log->ends++;
+        log->last_error = result->error;
+        log->had_stats = stats != NULL;
+    }
+}
+
+TEST(trace_hook) {
+    trace_log_t log = {0};
+    edn_set_trace_hook(trace, &log);
+
+    edn_result_t r = edn_read("[1 2]", 0);
+    edn_free(r.value);
+    assert(log.begins == 1 && log.ends == 1);
+    assert(log.last_error == EDN_OK && !log.had_stats && log.last_length == 5);
+
+    edn_parse_stats_t stats;
+    r = edn_read_with_stats("{:a", 0, NULL, &stats);
+    assert(log.begins == 2 && log.ends == 2);
+    assert(log.last_error == EDN_ERROR_UNTERMINATED_COLLECTION && log.had_stats);
+
+    edn_set_trace_hook(NULL, NULL);
+    r = edn_read("1", 0);
+    edn_free(r.value);
+    assert(log.begins == 2);
+}
+#else
+TEST(instrumentation_disabled) {
+    edn_result_t r = edn_read("[1 2 3]", 0);
+    assert(r.error == EDN_OK);
+    assert(edn_vector_count(r.value) == 3);
+    edn_free(r.value);
+}
+#endif
+
+int main(void) {
+    printf("Running parse statistics tests...\n");
+
+#ifdef EDN_ENABLE_INSTRUMENTATION
+    RUN_TEST(stats_tree_shape);
+    RUN_TEST(stats_duplicate_tiers);
+    RUN_TEST(stats_hot_path_counters);
+    RUN_TEST(stats_on_error);
+    RUN_TEST(trace_hook);
+#else
+    printf("Instrumentation is disabled (EDN_ENABLE_INSTRUMENTATION not defined)\n");
+    RUN_TEST(instrumentation_disabled);
+#endif
+
+    TEST_SUMMARY("parse statistics");
+}
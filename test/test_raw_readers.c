@@ -0,0 +1,215 @@
+/**
+ * Test raw-slice tagged readers
+ */
+
+#include <string.h>
+
+#include "../include/edn.h"
+#include "../src/edn_internal.h"
+#include "test_framework.h"
+
+/* Last slice seen by slice_reader */
+static const char* last_source;
+static size_t last_length;
+static int raw_calls;
+
+/* Reader that records its slice and returns it as a string value */
+static edn_value_t* slice_reader(const char* source, size_t length, edn_arena_t* arena,
+                                 const char** error_message) {
+    last_source = source;
+    last_length = length;
+    raw_calls++;
+
+    edn_value_t* result = edn_arena_alloc_value(arena);
+    if (result == NULL) {
+        *error_message = "Out of memory";
+        return NULL;
+    }
+    result->type = EDN_TYPE_STRING;
+    result->as.string.data = source;
+    edn_string_set_length(result, length);
+    edn_string_set_has_escapes(result, false);
+    result->as.string.decoded = NULL;
+    result->arena = arena;
+    return result;
+}
+
+/* Reader that only accepts a quoted payload */
+static edn_value_t* quoted_reader(const char* source, size_t length, edn_arena_t* arena,
+                                  const char** error_message) {
+    if (length < 2 || source[0] != '"') {
+        *error_message = "#bytes requires a string";
+        return NULL;
+    }
+    return slice_reader(source + 1, length - 2, arena, error_message);
+}
+
+static edn_value_t* value_reader(edn_value_t* value, edn_arena_t* arena,
+                                 const char** error_message) {
+    (void) arena;
+    (void) error_message;
+    return value;
+}
+
+static void assert_slice(const char* input, const char* expected) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_raw(registry, "raw", slice_reader);
+
+    edn_result_t r = read_with(input, registry, false);
+    assert(r.error == EDN_OK);
+    assert(last_length == strlen(expected));
+    assert(memcmp(last_source, expected, last_length) == 0);
+    edn_free(r.value);
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(register_raw) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    assert(edn_reader_register_raw(registry, "raw", slice_reader));
+    /* Raw readers are not visible through the value-reader lookup */
+    assert(edn_reader_lookup(registry, "raw") == NULL);
+
+    /* Registering a value reader replaces the raw one and vice versa */
+    assert(edn_reader_register(registry, "raw", value_reader));
+    assert(edn_reader_lookup(registry, "raw") == value_reader);
+    assert(edn_reader_register_raw(registry, "raw", slice_reader));
+    assert(edn_reader_lookup(registry, "raw") == NULL);
+
+    assert_false(edn_reader_register_raw(NULL, "raw", slice_reader));
+    assert_false(edn_reader_register_raw(registry, NULL, slice_reader));
+    assert_false(edn_reader_register_raw(registry, "raw", NULL));
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(raw_scalar_slices) {
+    assert_slice("#raw 42", "42");
+    assert_slice("#raw foo/bar", "foo/bar");
+    assert_slice("#raw :kw", ":kw");
+    assert_slice("#raw \"a \\\" ] b\"", "\"a \\\" ] b\"");
+    assert_slice("#raw \\)", "\\)");
+    assert_slice("#raw \\newline", "\\newline");
+    assert_slice("#raw ##Inf", "##Inf");
+}
+
+TEST(raw_collection_slices) {
+    assert_slice("#raw [1 2 3]", "[1 2 3]");
+    assert_slice("#raw {:a [1 (2)] :b #{3}}", "{:a [1 (2)] :b #{3}}");
+    assert_slice("#raw [\"]\" \\] ; ]\n]", "[\"]\" \\] ; ]\n]");
+    assert_slice("#raw #other [1]", "#other [1]");
+    assert_slice("#raw (#_ 0 1)", "(#_ 0 1)");
+}
+
+TEST(raw_skips_leading_trivia) {
+    assert_slice("#raw  ; comment\n , #_ skipped [1]", "[1]");
+    assert_slice("#raw #_ #_ a b c", "c");
+}
+
+TEST(raw_in_collection) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_raw(registry, "bytes", quoted_reader);
+
+    edn_result_t r = read_with("[#bytes \"AAE=\" #bytes \"\"]", registry, false);
+    assert(r.error == EDN_OK);
+    assert_int_eq(edn_vector_count(r.value), 2);
+
+    size_t len;
+    const char* s = edn_string_get(edn_vector_get(r.value, 0), &len);
+    assert_int_eq(len, 4);
+    assert(memcmp(s, "AAE=", 4) == 0);
+
+    size_t start, end;
+    assert(edn_source_position(edn_vector_get(r.value, 0), &start, &end));
+    assert_int_eq(start, 1);
+    assert_int_eq(end, 14);
+    edn_free(r.value);
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(raw_reader_error) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_raw(registry, "bytes", quoted_reader);
+
+    edn_result_t r = read_with("#bytes 42", registry, false);
+    assert(r.error == EDN_ERROR_INVALID_SYNTAX);
+    assert_str_eq(r.error_message, "#bytes requires a string");
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(raw_structural_errors) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_raw(registry, "raw", slice_reader);
+
+    edn_result_t r = read_with("#raw", registry, false);
+    assert(r.error == EDN_ERROR_UNEXPECTED_EOF);
+
+    /* Same error as the value-reader path reports for "[#tag]" */
+    r = read_with("[#raw]", registry, false);
+    assert(r.error == EDN_ERROR_UNTERMINATED_COLLECTION);
+
+    r = read_with("#raw [1 2", registry, false);
+    assert(r.error == EDN_ERROR_UNTERMINATED_COLLECTION);
+
+    r = read_with("#raw [1 2)", registry, false);
+    assert(r.error == EDN_ERROR_UNMATCHED_DELIMITER);
+
+    r = read_with("#raw \"abc", registry, false);
+    assert(r.error == EDN_ERROR_INVALID_STRING);
+
+    r = read_with("#raw #_", registry, false);
+    assert(r.error == EDN_ERROR_INVALID_DISCARD);
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(raw_depth_limit) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_raw(registry, "raw", slice_reader);
+
+    edn_parse_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.reader_registry = registry;
+    opts.max_depth = 4;
+
+    edn_result_t r = edn_read_with_options("#raw [[[]]]", 0, &opts);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+
+    r = edn_read_with_options("#raw [[[[[]]]]]", 0, &opts);
+    assert(r.error == EDN_ERROR_MAX_DEPTH_EXCEEDED);
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(raw_not_invoked_in_discard) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    edn_reader_register_raw(registry, "raw", slice_reader);
+
+    raw_calls = 0;
+    edn_result_t r = read_with("[#_ #raw [1] 2]", registry, false);
+    assert(r.error == EDN_OK);
+    assert_int_eq(raw_calls, 0);
+    assert_int_eq(edn_vector_count(r.value), 1);
+    edn_free(r.value);
+
+    edn_reader_registry_destroy(registry);
+}
+
+int main(void) {
+    printf("Running raw reader tests...\n");
+
+    RUN_TEST(register_raw);
+    RUN_TEST(raw_scalar_slices);
+    RUN_TEST(raw_collection_slices);
+    RUN_TEST(raw_skips_leading_trivia);
+    RUN_TEST(raw_in_collection);
+    RUN_TEST(raw_reader_error);
+    RUN_TEST(raw_structural_errors);
+    RUN_TEST(raw_depth_limit);
+    RUN_TEST(raw_not_invoked_in_discard);
+
+    TEST_SUMMARY("raw reader");
+}
@@ -0,0 +1,402 @@
+/**
+ * Test incremental reparse (edn_reparse)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "../src/edn_internal.h"
+#include "test_framework.h"
+
+/* Apply an edit to `text`, returning a new malloc'd string */
+static char* apply_edit(const char* text, size_t offset, size_t removed, const char* inserted) {
+    size_t length = strlen(text);
+    size_t added = strlen(inserted);
+    char* out = malloc(length - removed + added + 1);
+    if (out == NULL) {
+        return NULL;
+    }
+    memcpy(out, text, offset);
+    memcpy(out + offset, inserted, added);
+    memcpy(out + offset + added, text + offset + removed, length - offset - removed + 1);
+    return out;
+}
+
+static size_t children(const edn_value_t* v) {
+    switch (edn_type(v)) {
+        case EDN_TYPE_LIST:
+            return edn_list_count(v);
+        case EDN_TYPE_VECTOR:
+            return edn_vector_count(v);
+        case EDN_TYPE_SET:
+            return edn_set_count(v);
+        case EDN_TYPE_MAP:
+            return edn_map_count(v) * 2;
+        default:
+            return 0;
+    }
+}
+
+static edn_value_t* child(const edn_value_t* v, size_t i) {
+    switch (edn_type(v)) {
+        case EDN_TYPE_LIST:
+            return edn_list_get(v, i);
+        case EDN_TYPE_VECTOR:
+            return edn_vector_get(v, i);
+        case EDN_TYPE_SET:
+            return edn_set_get(v, i);
+        default:
+            return (i & 1) ? edn_map_get_value(v, i / 2) : edn_map_get_key(v, i / 2);
+    }
+}
+
+/* Same values in the same order, at the same source positions */
+static bool same_tree(const edn_value_t* a, const edn_value_t* b) {
+    size_t as, ae, bs, be;
+    if (edn_type(a) != edn_type(b) || !edn_source_position(a, &as, &ae) ||
+        !edn_source_position(b, &bs, &be) || as != bs || ae != be) {
+        return false;
+    }
+    if (edn_type(a) == EDN_TYPE_STRING) {
+        /* The scanner may flag escapes conservatively depending on the bytes
+         * after the closing quote, so compare decoded contents. */
+        size_t al, bl;
+        const char* sa = edn_string_get(a, &al);
+        const char* sb = edn_string_get(b, &bl);
+        if (sa == NULL || sb == NULL) {
+            return sa == sb && edn_value_equal(a, b); /* Both hold a bad escape */
+        }
+        return al == bl && memcmp(sa, sb, al) == 0;
+    }
+    if (edn_type(a) == EDN_TYPE_TAGGED) {
+        const char *ta, *tb;
+        size_t tal, tbl;
+        edn_value_t* ia = NULL;
+        edn_value_t* ib = NULL;
+        return edn_tagged_get(a, &ta, &tal, &ia) && edn_tagged_get(b, &tb, &tbl, &ib) &&
+               tal == tbl && memcmp(ta, tb, tal) == 0 && same_tree(ia, ib);
+    }
+    size_t n = children(a);
+    if (n == 0 && !edn_value_equal(a, b)) {
+        return false;
+    }
+    if (n != children(b)) {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!same_tree(child(a, i), child(b, i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(reparse_reuses_siblings) {
+    const char* v0 = "[{:id 1 :name \"a\"} {:id 2 :name \"b\"} {:id 3 :name \"c\"}]";
+    edn_result_t r = edn_read(v0, 0);
+    assert(r.error == EDN_OK);
+    edn_value_t* root = r.value;
+    edn_value_t* first = edn_vector_get(root, 0);
+    edn_value_t* third = edn_vector_get(root, 2);
+
+    /* "2" -> "42" inside the second map */
+    const char* at = strstr(v0, "2 ");
+    size_t offset = (size_t) (at - v0);
+    char* v1 = apply_edit(v0, offset, 0, "4");
+    r = edn_reparse(root, v0, v1, 0, offset, 0, 1, NULL);
+    assert(r.error == EDN_OK);
+    assert(r.value == root);
+    assert(edn_vector_get(root, 0) == first);
+    assert(edn_vector_get(root, 2) == third);
+
+    int64_t id;
+    assert(edn_int64_get(edn_map_get_keyword(edn_vector_get(root, 1), "id"), &id) && id == 42);
+
+    /* Later values moved by one byte, earlier ones did not */
+    size_t start, end;
+    assert(edn_source_position(third, &start, &end));
+    assert(strncmp(v1 + start, "{:id 3", 6) == 0 && end == strlen(v1) - 1);
+    assert(edn_source_position(first, &start, &end) && start == 1);
+    assert(edn_source_position(root, &start, &end) && end == strlen(v1));
+
+    edn_result_t fresh = edn_read(v1, 0);
+    assert(same_tree(root, fresh.value));
+    edn_free(fresh.value);
+    edn_free(root);
+    free(v1);
+}
+
+TEST(reparse_adds_and_removes_elements) {
+    const char* v0 = "[1 2 3]";
+    edn_result_t r = edn_read(v0, 0);
+    edn_value_t* root = r.value;
+
+    char* v1 = apply_edit(v0, 4, 0, " 9 8"); /* [1 2 9 8 3] */
+    r = edn_reparse(root, v0, v1, 0, 4, 0, 4, NULL);
+    assert(r.error == EDN_OK && r.value == root);
+    assert(edn_vector_count(root) == 5);
+
+    char* v2 = apply_edit(v1, 1, 4, ""); /* [9 8 3] */
+    r = edn_reparse(root, v1, v2, 0, 1, 4, 0, NULL);
+    assert(r.error == EDN_OK && r.value == root);
+    assert(edn_vector_count(root) == 3);
+
+    edn_result_t fresh = edn_read(v2, 0);
+    assert(same_tree(root, fresh.value));
+    edn_free(fresh.value);
+    edn_free(root);
+    free(v1);
+    free(v2);
+}
+
+TEST(reparse_structural_edits) {
+    /* Opening a string swallows the rest of the vector: an error, old tree kept */
+    const char* v0 = "[[1 2] [3 4]]";
+    edn_result_t r = edn_read(v0, 0);
+    edn_value_t* root = r.value;
+    char* v1 = apply_edit(v0, 2, 0, "\"");
+    r = edn_reparse(root, v0, v1, 0, 2, 0, 1, NULL);
+    assert(r.error != EDN_OK);
+    assert(edn_vector_count(root) == 2);
+
+    /* Closing the inner vector early moves "2" to the outer one */
+    char* v2 = apply_edit(v0, 3, 0, "]");
+    char* v3 = apply_edit(v2, 6, 1, ""); /* [[1] 2 [3 4]] */
+    r = edn_reparse(root, v0, v3, 0, 3, 1, 1, NULL);
+    assert(r.error == EDN_OK);
+    edn_result_t fresh = edn_read(v3, 0);
+    assert(same_tree(r.value, fresh.value));
+    edn_free(fresh.value);
+
+    /* A comment reaching past the next element */
+    root = r.value;
+    char* v4 = apply_edit(v3, 4, 0, ";");
+    r = edn_reparse(root, v3, v4, 0, 4, 0, 1, NULL);
+    assert(r.error != EDN_OK); /* Comment runs to the end: unterminated */
+
+    char* v5 = apply_edit(v3, 5, 0, "#_");
+    r = edn_reparse(root, v3, v5, 0, 5, 0, 2, NULL);
+    assert(r.error == EDN_OK);
+    assert(edn_vector_count(r.value) == 2);
+    fresh = edn_read(v5, 0);
+    assert(same_tree(r.value, fresh.value));
+    edn_free(fresh.value);
+
+    edn_free(r.value);
+    free(v1);
+    free(v2);
+    free(v3);
+    free(v4);
+    free(v5);
+}
+
+TEST(reparse_maps_and_sets) {
+    const char* v0 = "{:a 1 :b #{1 2} :c [3]}";
+    edn_result_t r = edn_read(v0, 0);
+    edn_value_t* root = r.value;
+
+    /* Duplicate set element: reported, nothing changes */
+    char* v1 = apply_edit(v0, 13, 1, "1");
+    r = edn_reparse(root, v0, v1, 0, 13, 1, 1, NULL);
+    assert(r.error == EDN_ERROR_DUPLICATE_ELEMENT);
+    assert(edn_set_count(edn_map_get_keyword(root, "b")) == 2);
+
+    /* Renaming a key to an existing one */
+    char* v2 = apply_edit(v0, 7, 1, "a");
+    r = edn_reparse(root, v0, v2, 0, 7, 1, 1, NULL);
+    assert(r.error == EDN_ERROR_DUPLICATE_KEY);
+
+    /* Renaming a key, and a key without its value */
+    char* v3 = apply_edit(v0, 7, 1, "z");
+    r = edn_reparse(root, v0, v3, 0, 7, 1, 1, NULL);
+    assert(r.error == EDN_OK && r.value == root);
+    assert(edn_map_get_keyword(root, "z") != NULL && edn_map_get_keyword(root, "b") == NULL);
+    char* v4 = apply_edit(v3, 1, 5, "");
+    r = edn_reparse(root, v3, v4, 0, 1, 5, 0, NULL);
+    assert(r.error == EDN_OK);
+    assert(edn_map_count(r.value) == 2);
+
+    edn_result_t fresh = edn_read(v4, 0);
+    assert(same_tree(r.value, fresh.value));
+    assert(edn_value_equal(r.value, fresh.value));
+    edn_free(fresh.value);
+    edn_free(r.value);
+    free(v1);
+    free(v2);
+    free(v3);
+    free(v4);
+}
+
+/* Edits inside a set element or a map key can make it equal a sibling */
+TEST(reparse_enclosing_duplicates) {
+    const char* v0 = "#{[1] [2]}";
+    edn_result_t r = edn_read(v0, 0);
+    edn_value_t* root = r.value;
+    edn_value_t* second = edn_set_get(root, 1);
+    char* v1 = apply_edit(v0, 7, 1, "1"); /* #{[1] [1]} */
+    r = edn_reparse(root, v0, v1, 0, 7, 1, 1, NULL);
+    assert(r.error == EDN_ERROR_DUPLICATE_ELEMENT);
+    assert(edn_read(v1, 0).error == EDN_ERROR_DUPLICATE_ELEMENT);
+    int64_t n;
+    assert(edn_set_count(root) == 2 && edn_set_get(root, 1) == second);
+    assert(edn_int64_get(edn_vector_get(second, 0), &n) && n == 2);
+
+    /* A distinct element still splices in place */
+    char* v2 = apply_edit(v0, 7, 1, "3");
+    r = edn_reparse(root, v0, v2, 0, 7, 1, 1, NULL);
+    assert(r.error == EDN_OK && r.value == root && edn_set_get(root, 1) == second);
+    assert(edn_int64_get(edn_vector_get(second, 0), &n) && n == 3);
+    edn_free(root);
+
+    const char* m0 = "{[1] :a [2] :b}";
+    r = edn_read(m0, 0);
+    root = r.value;
+    char* m1 = apply_edit(m0, 9, 1, "1"); /* {[1] :a [1] :b} */
+    r = edn_reparse(root, m0, m1, 0, 9, 1, 1, NULL);
+    assert(r.error == EDN_ERROR_DUPLICATE_KEY);
+    assert(edn_read(m1, 0).error == EDN_ERROR_DUPLICATE_KEY);
+    assert(edn_int64_get(edn_vector_get(edn_map_get_key(root, 1), 0), &n) && n == 2);
+
+    /* Map values may be equal */
+    const char* m2 = "{:a [1] :b [2]}";
+    edn_free(root);
+    r = edn_read(m2, 0);
+    root = r.value;
+    char* m3 = apply_edit(m2, 12, 1, "1");
+    r = edn_reparse(root, m2, m3, 0, 12, 1, 1, NULL);
+    assert(r.error == EDN_OK && r.value == root);
+    edn_result_t fresh = edn_read(m3, 0);
+    assert(same_tree(root, fresh.value));
+    edn_free(fresh.value);
+
+    edn_free(root);
+    free(v1);
+    free(v2);
+    free(m1);
+    free(m3);
+}
+
+TEST(reparse_outside_root) {
+    const char* v0 = "  [1 2]  ";
+    edn_result_t r = edn_read(v0, 0);
+    edn_value_t* root = r.value;
+
+    /* After a collection root: ignored, like edn_read ignores it */
+    char* v1 = apply_edit(v0, 8, 0, "junk");
+    r = edn_reparse(root, v0, v1, 0, 8, 0, 4, NULL);
+    assert(r.error == EDN_OK && r.value == root);
+
+    /* Before the root: full parse, the old tree is released */
+    char* v2 = apply_edit(v1, 0, 0, "5");
+    r = edn_reparse(root, v1, v2, 0, 0, 0, 1, NULL);
+    assert(r.error == EDN_OK);
+    int64_t n;
+    assert(edn_int64_get(r.value, &n) && n == 5);
+    edn_free(r.value);
+
+    /* A scalar root is always parsed again */
+    r = edn_read("12", 0);
+    r = edn_reparse(r.value, "12", "123", 0, 2, 0, 1, NULL);
+    assert(r.error == EDN_OK && edn_int64_get(r.value, &n) && n == 123);
+    edn_free(r.value);
+    free(v1);
+    free(v2);
+}
+
+TEST(reparse_tagged_and_options) {
+    const char* v0 = "[#point [1 2] #{:a}]";
+    edn_result_t r = edn_read(v0, 0);
+    edn_value_t* root = r.value;
+    edn_value_t* set = edn_vector_get(root, 1);
+
+    char* v1 = apply_edit(v0, 11, 1, "20");
+    r = edn_reparse(root, v0, v1, 0, 11, 1, 2, NULL);
+    assert(r.error == EDN_OK && r.value == root);
+    assert(edn_vector_get(root, 1) == set);
+    edn_result_t fresh = edn_read(v1, 0);
+    assert(same_tree(root, fresh.value));
+    edn_free(fresh.value);
+
+    /* max_depth still applies to spliced forms */
+    edn_parse_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.max_depth = 3;
+    char* v2 = apply_edit(v1, 12, 0, "[[0]]");
+    r = edn_reparse(root, v1, v2, 0, 12, 0, 5, &opts);
+    assert(r.error == EDN_ERROR_MAX_DEPTH_EXCEEDED);
+    edn_free(root);
+    free(v1);
+    free(v2);
+}
+
+/* Random edits against full parses of the same text */
+TEST(reparse_matches_full_parse) {
+    static const char* const snippets[] = {
+        " ", "1", "x", ":k", "\"", "[", "]", "{", "}", "(", ")", ";", "\n",
+        "#_", "#{", "2 3", "\\a", "\"s\"", "#t ", "-", "0.5", ",", "nil", "",
+    };
+    const size_t snippet_count = sizeof(snippets) / sizeof(snippets[0]);
+
+    const char* seed = "[{:id 1 :tags #{:a :b} :v [1 2 (3 4)] :s \"str\"}\n"
+                       " {:id 2 :tags #{} :v [] :s \"x\\ny\"} ; comment\n"
+                       " #inst \"2020-01-01\" #_ [ignored] (a b {:c d}) \\z 12.5]";
+    char* texts[4096];
+    size_t text_count = 0;
+    texts[text_count++] = apply_edit(seed, 0, 0, "");
+    edn_result_t r = edn_read(seed, 0);
+    assert(r.error == EDN_OK);
+    edn_value_t* root = r.value;
+
+    unsigned state = 12345;
+    size_t accepted = 0;
+    for (int i = 0; i < 3000 && text_count < 4096; i++) {
+        const char* text = texts[text_count - 1];
+        size_t length = strlen(text);
+        state = state * 1103515245u + 12345u;
+        size_t offset = (state >> 8) % (length + 1);
+        state = state * 1103515245u + 12345u;
+        size_t removed = (state >> 8) % 3;
+        if (removed > length - offset) {
+            removed = length - offset;
+        }
+        state = state * 1103515245u + 12345u;
+        const char* inserted = snippets[(state >> 8) % snippet_count];
+
+        char* next = apply_edit(text, offset, removed, inserted);
+        assert(next != NULL);
+        edn_result_t full = edn_read(next, 0);
+        r = edn_reparse(root, text, next, 0, offset, removed, strlen(inserted), NULL);
+        assert(r.error == full.error);
+        if (r.error != EDN_OK) {
+            free(next); /* Rejected: keep editing the old text */
+            continue;
+        }
+        assert(same_tree(r.value, full.value));
+        edn_free(full.value);
+        root = r.value;
+        texts[text_count++] = next;
+        accepted++;
+    }
+    assert(accepted > 500);
+
+    edn_free(root);
+    for (size_t i = 0; i < text_count; i++) {
+        free(texts[i]);
+    }
+}
+
+int main(void) {
+    printf("Running reparse tests...\n");
+
+    RUN_TEST(reparse_reuses_siblings);
+    RUN_TEST(reparse_adds_and_removes_elements);
+    RUN_TEST(reparse_structural_edits);
+    RUN_TEST(reparse_maps_and_sets);
+    RUN_TEST(reparse_enclosing_duplicates);
+    RUN_TEST(reparse_outside_root);
+    RUN_TEST(reparse_tagged_and_options);
+    RUN_TEST(reparse_matches_full_parse);
+
+    TEST_SUMMARY("reparse");
+}
@@ -0,0 +1,365 @@
+/**
+ * Test streaming schema validation
+ */
+
+#include <string.h>
+
+#include "../include/edn.h"
+#include "../src/edn_internal.h"
+#include "test_framework.h"
+
+static const char* USER_SCHEMA = "[:map {:closed true}"
+                                 " [:user/id [:int {:min 1}]]"
+                                 " [:name [:string {:min 1 :max 8}]]"
+                                 " [:email {:optional true} :string]"
+                                 " [:roles {:optional true} [:set [:enum :admin :ops]]]"
+                                 " [:scores {:optional true} [:vector {:max 3} [:maybe :double]]]"
+                                 " [:extra {:optional true} :any]]";
+
+static char path[128];
+
+/* edn_schema_read must stop where edn_schema_validate does, with the same
+ * path, and otherwise build what edn_read builds */
+static void check_read_agrees(const edn_schema_t* schema, const char* input,
+                              const edn_parse_options_t* options, edn_result_t expected) {
+    char read_path[sizeof(path)];
+    edn_result_t r = edn_schema_read(schema, input, 0, options, read_path, sizeof(read_path));
+    edn_result_t tree = {0};
+    if (expected.error == EDN_OK) {
+        tree = edn_read_with_options(input, 0, options);
+        expected = tree;
+    }
+    bool ok = r.error == expected.error && r.error_start.offset == expected.error_start.offset &&
+              r.error_end.offset == expected.error_end.offset && strcmp(read_path, path) == 0 &&
+              (r.error != EDN_OK || edn_value_equal(r.value, tree.value));
+    if (!ok) {
+        printf("\n    edn_schema_read disagrees on %s: error %d at %zu-%zu %s, expected %d at "
+               "%zu-%zu %s\n",
+               input, r.error, r.error_start.offset, r.error_end.offset, read_path,
+               expected.error, expected.error_start.offset, expected.error_end.offset, path);
+        current_test_failed = true;
+    }
+    edn_free(r.value);
+    edn_free(tree.value);
+}
+
+static edn_result_t validate(const char* schema_text, const char* input) {
+    const char* message = NULL;
+    edn_schema_t* schema = edn_schema_compile(schema_text, 0, &message);
+    if (schema == NULL) {
+        printf("schema error: %s\n", message);
+    }
+    edn_result_t r = edn_schema_validate(schema, input, 0, path, sizeof(path));
+    check_read_agrees(schema, input, NULL, r);
+    edn_schema_destroy(schema);
+    return r;
+}
+
+TEST(schema_accepts_valid_documents) {
+    edn_result_t r = validate(USER_SCHEMA, "{:user/id 7 :name \"Ada\"}");
+    assert(r.error == EDN_OK);
+    assert(r.value == NULL);
+    assert_str_eq(path, "");
+
+    r = validate(USER_SCHEMA, "{:name \"Ada\" :user/id 7 :email \"a@b\" :roles #{:ops :admin}"
+                              " :scores [1.5 nil 2.0] :extra {:any [\"thing\" #{1}]}}");
+    assert(r.error == EDN_OK);
+
+    r = validate("[:tuple :int :keyword [:maybe :string]]", "[1 :a nil]");
+    assert(r.error == EDN_OK);
+
+    r = validate("[:map-of :keyword [:sequential :int]]", "{:a [1 2] :b (3) :c []}");
+    assert(r.error == EDN_OK);
+
+    r = validate(":any", "#{[1] {2 3}}");
+    assert(r.error == EDN_OK);
+
+    r = validate("[:number {:min 0 :max 10}]", "9.5");
+    assert(r.error == EDN_OK);
+}
+
+TEST(schema_type_mismatch_has_path_and_position) {
+    edn_result_t r = validate(USER_SCHEMA, "{:user/id 7\n :name :ada}");
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Value does not match schema type");
+    assert_str_eq(path, "[:name]");
+    assert_int_eq(r.error_start.offset, 19);
+    assert_int_eq(r.error_start.line, 2);
+    assert_int_eq(r.error_end.offset, 23);
+
+    r = validate(USER_SCHEMA, "{:user/id 7 :name \"x\" :scores [1.0 2]}");
+    assert_str_eq(r.error_message, "Value does not match schema type");
+    assert_str_eq(path, "[:scores 1]");
+
+    r = validate("[:vector [:map [:a [:map [:b :int]]]]]", "[{:a {:b 1}} {:a {:b \"2\"}}]");
+    assert_str_eq(path, "[1 :a :b]");
+
+    r = validate(USER_SCHEMA, "[1]");
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(path, "[]");
+}
+
+TEST(schema_ranges) {
+    edn_result_t r = validate(USER_SCHEMA, "{:user/id 0 :name \"x\"}");
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Value out of range");
+    assert_str_eq(path, "[:user/id]");
+
+    r = validate(USER_SCHEMA, "{:user/id 1 :name \"too long!\"}");
+    assert_str_eq(r.error_message, "String length out of range");
+
+    r = validate(USER_SCHEMA, "{:user/id 1 :name \"\"}");
+    assert_str_eq(r.error_message, "String length out of range");
+
+    r = validate("[:int {:max 100}]", "100000000000000000000000N");
+    assert_str_eq(r.error_message, "Value out of range");
+
+    r = validate("[:int {:min 0}]", "100000000000000000000000N");
+    assert(r.error == EDN_OK);
+
+    r = validate("[:number {:max 1.5}]", "1.6M");
+    assert_str_eq(r.error_message, "Value out of range");
+
+    r = validate("[:number {:max 1.5}]", "0.000015e5M");
+    assert(r.error == EDN_OK);
+
+    r = validate("[:double {:min 0}]", "##NaN");
+    assert_str_eq(r.error_message, "Value out of range");
+
+    r = validate("[:int {:min 0.5 :max 2.5}]", "2");
+    assert(r.error == EDN_OK);
+}
+
+TEST(schema_counts_stop_early) {
+    /* The fourth element is rejected before its (broken) contents are scanned */
+    edn_result_t r = validate(USER_SCHEMA, "{:user/id 1 :name \"x\" :scores [1.0 2.0 3.0 [\"x");
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Too many elements");
+    assert_str_eq(path, "[:scores 3]");
+
+    r = validate("[:set {:min 2} :int]", "#{1}");
+    assert_str_eq(r.error_message, "Too few elements");
+    assert_str_eq(path, "[]");
+    assert_int_eq(r.error_start.offset, 0);
+    assert_int_eq(r.error_end.offset, 4);
+
+    r = validate("[:tuple :int :int]", "[1]");
+    assert_str_eq(r.error_message, "Too few elements");
+
+    r = validate("[:tuple :int :int]", "[1 2 3]");
+    assert_str_eq(r.error_message, "Too many elements");
+    assert_str_eq(path, "[2]");
+
+    r = validate("[:map-of {:max 1} :int :int]", "{1 2 3 4}");
+    assert_str_eq(r.error_message, "Too many elements");
+}
+
+TEST(schema_map_keys) {
+    edn_result_t r = validate(USER_SCHEMA, "{:name \"x\"}");
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Missing required key");
+    assert_str_eq(path, "[:user/id]");
+
+    r = validate(USER_SCHEMA, "{:user/id 1 :name \"x\" :bogus 1}");
+    assert_str_eq(r.error_message, "Key not allowed in closed map");
+    assert_str_eq(path, "[:bogus]");
+
+    r = validate(USER_SCHEMA, "{:user/id 1 :name \"x\" \"str\" 1}");
+    assert_str_eq(r.error_message, "Key not allowed in closed map");
+    assert_str_eq(path, "[\"str\"]");
+
+    r = validate(USER_SCHEMA, "{:user/id 1 :user/id 2 :name \"x\"}");
+    assert(r.error == EDN_ERROR_DUPLICATE_KEY);
+
+    /* Open maps skip unknown keys and their values unchecked */
+    r = validate("[:map [:a :int]]", "{:a 1 :b \"x\" [1 2] {:c 3} 4 5}");
+    assert(r.error == EDN_OK);
+
+    r = validate("[:map-of :string [:map [:id :int]]]", "{\"x\" {:id 1} \"y\" {}}");
+    assert_str_eq(r.error_message, "Missing required key");
+    assert_str_eq(path, "[\"y\" :id]");
+
+    r = validate("[:map-of :keyword :int]", "{:a 1 \"b\" 2}");
+    assert_str_eq(r.error_message, "Value does not match schema type");
+    assert_str_eq(path, "[\"b\"]");
+
+    r = validate("[:map-of :int :int]", "{1 2 3 :x}");
+    assert_str_eq(path, "[3]");
+}
+
+TEST(schema_enums) {
+    edn_result_t r = validate(USER_SCHEMA, "{:user/id 1 :name \"x\" :roles #{:admin :root}}");
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(r.error_message, "Value not in enum");
+    assert_str_eq(path, "[:roles 1]");
+
+    r = validate("[:enum \"a\" 2 :x/y]", "\"a\"");
+    assert(r.error == EDN_OK);
+    r = validate("[:enum \"a\" 2 :x/y]", "2");
+    assert(r.error == EDN_OK);
+    r = validate("[:enum \"a\" 2 :x/y]", ":x/y");
+    assert(r.error == EDN_OK);
+    r = validate("[:enum \"a\" 2 :x/y]", ":y");
+    assert_str_eq(r.error_message, "Value not in enum");
+    r = validate("[:enum \"a\" 2 :x/y]", "2.0");
+    assert_str_eq(r.error_message, "Value does not match schema type");
+}
+
+TEST(schema_syntax_errors_pass_through) {
+    edn_result_t r = validate(USER_SCHEMA, "{:user/id 1 :name}");
+    assert(r.error == EDN_ERROR_INVALID_SYNTAX);
+    assert_str_eq(path, "");
+
+    r = validate(USER_SCHEMA, "");
+    assert(r.error == EDN_ERROR_UNEXPECTED_EOF);
+
+    r = edn_schema_validate(NULL, "1", 0, path, sizeof(path));
+    assert(r.error == EDN_ERROR_INVALID_ARGUMENT);
+}
+
+TEST(schema_tags_and_path_truncation) {
+    edn_result_t r = validate("[:map [:at :string]]", "{:at #inst \"2024-01-01T00:00:00Z\"}");
+    assert(r.error == EDN_OK);
+
+    edn_schema_t* schema = edn_schema_compile("[:map [:long-key-name :int]]", 0, NULL);
+    char small[8];
+    r = edn_schema_validate(schema, "{:long-key-name nil}", 0, small, sizeof(small));
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(small, "[:long-");
+    edn_schema_destroy(schema);
+}
+
+TEST(schema_compile_errors) {
+    const char* message = NULL;
+    assert(edn_schema_compile("[:map", 0, &message) == NULL);
+    assert(message != NULL);
+
+    assert(edn_schema_compile(":integer", 0, &message) == NULL);
+    assert_str_eq(message, "Unknown schema type");
+
+    assert(edn_schema_compile("[:int {:size 3}]", 0, &message) == NULL);
+    assert_str_eq(message, "Invalid schema property");
+
+    assert(edn_schema_compile("[:string {:min -1}]", 0, &message) == NULL);
+    assert_str_eq(message, "Invalid schema property");
+
+    assert(edn_schema_compile("[:int {:min 5 :max 1}]", 0, &message) == NULL);
+    assert_str_eq(message, "Invalid schema property");
+
+    assert(edn_schema_compile("[:map [:a :int] [:a :string]]", 0, &message) == NULL);
+    assert_str_eq(message, "Duplicate key in map schema");
+
+    assert(edn_schema_compile("[:map [\"a\" :int]]", 0, &message) == NULL);
+    assert_str_eq(message, "Invalid map schema entry");
+
+    assert(edn_schema_compile("[:enum]", 0, &message) == NULL);
+    assert(edn_schema_compile("[:maybe :int :int]", 0, &message) == NULL);
+    assert(edn_schema_compile("[:vector :int :int]", 0, &message) == NULL);
+    assert(edn_schema_compile("[]", 0, &message) == NULL);
+    assert(edn_schema_compile(NULL, 0, &message) == NULL);
+
+    char deep[1024] = "";
+    for (int i = 0; i < 65; i++) {
+        strcat(deep, "[:vector ");
+    }
+    strcat(deep, ":int");
+    for (int i = 0; i < 65; i++) {
+        strcat(deep, "]");
+    }
+    assert(edn_schema_compile(deep, 0, &message) == NULL);
+    assert_str_eq(message, "Schema nested too deeply");
+
+    edn_schema_destroy(NULL);
+}
+
+TEST(schema_ignores_metadata) {
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    edn_result_t r = validate("[:map [:v [:vector :int]]]", "^{:doc \"x\"} {:v ^:tag ^[1] [7]}");
+    assert(r.error == EDN_OK);
+#endif
+}
+
+static edn_value_t* length_reader(edn_value_t* value, edn_arena_t* arena,
+                                  const char** error_message) {
+    (void) arena;
+    (void) error_message;
+    size_t length = 0;
+    edn_string_get(value, &length);
+    edn_value_t* result = value;
+    result->type = EDN_TYPE_INT;
+    result->as.integer = (int64_t) length;
+    return result;
+}
+
+TEST(schema_read_builds_tree) {
+    edn_schema_t* schema = edn_schema_compile(USER_SCHEMA, 0, NULL);
+    edn_result_t r = edn_schema_read(schema, "{:user/id 7 :name \"Ada\" :roles #{:ops}}", 0, NULL,
+                                     path, sizeof(path));
+    assert(r.error == EDN_OK);
+    assert_str_eq(path, "");
+    assert(edn_type(r.value) == EDN_TYPE_MAP);
+    assert(edn_map_count(r.value) == 3);
+    edn_free(r.value);
+
+    r = edn_schema_read(schema, "{:user/id 7 :name 1}", 0, NULL, path, sizeof(path));
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert(r.value == NULL);
+    assert_str_eq(path, "[:name]");
+
+    r = edn_schema_read(NULL, "1", 0, NULL, path, sizeof(path));
+    assert(r.error == EDN_ERROR_INVALID_ARGUMENT);
+    edn_schema_destroy(schema);
+
+    /* edn_read's own rules still apply where the schema leaves the form open */
+    assert(validate(":map", "{:a 1 :a 2}").error == EDN_OK);
+    assert(validate("[:vector :int]", "[1 #_ [:x] 2 #_ \"y\"]").error == EDN_OK);
+    assert(validate("[:map-of :keyword :int]", "{:a 1 #_ :b #_ \"2\"}").error == EDN_OK);
+    assert(validate("[:vector :string]", "[#x \"a\" #x #y \"b\"]").error == EDN_OK);
+    assert(validate("[:vector :string]", "[#x \"a\" #x #y 2]").error != EDN_OK);
+
+    /* The schema sees the form a reader receives, and the tree what it returns */
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    assert(edn_reader_register(registry, "len", length_reader));
+    edn_parse_options_t options = {0};
+    options.struct_size = sizeof(options);
+    options.reader_registry = registry;
+    schema = edn_schema_compile("[:vector [:string {:max 3}]]", 0, NULL);
+    r = edn_schema_read(schema, "[#len \"abc\" \"d\"]", 0, &options, path, sizeof(path));
+    assert(r.error == EDN_OK);
+    assert(edn_type(edn_vector_get(r.value, 0)) == EDN_TYPE_INT);
+    edn_free(r.value);
+    r = edn_schema_read(schema, "[\"d\" #len \"abcd\"]", 0, &options, path, sizeof(path));
+    assert(r.error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(path, "[1]");
+    assert_int_eq(r.error_start.offset, 10);
+    edn_schema_destroy(schema);
+    edn_reader_registry_destroy(registry);
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    const char* ns_schema = "[:map {:closed true} [:user/id :int] [:name :string]]";
+    assert(validate(ns_schema, "#:user{:id 1 :_/name \"x\"}").error == EDN_OK);
+    assert(validate(ns_schema, "#:user{:id 1 :name \"x\"}").error == EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(path, "[:user/name]");
+    assert(validate("[:vector [:map [:a :int]]]", "[^{:a \"x\"} {:a 1} ^:b {:a \"y\"}]").error ==
+           EDN_ERROR_SCHEMA_MISMATCH);
+    assert_str_eq(path, "[1 :a]");
+#endif
+}
+
+int main(void) {
+    printf("Running schema validation tests...\n");
+
+    RUN_TEST(schema_accepts_valid_documents);
+    RUN_TEST(schema_type_mismatch_has_path_and_position);
+    RUN_TEST(schema_ranges);
+    RUN_TEST(schema_counts_stop_early);
+    RUN_TEST(schema_map_keys);
+    RUN_TEST(schema_enums);
+    RUN_TEST(schema_syntax_errors_pass_through);
+    RUN_TEST(schema_tags_and_path_truncation);
+    RUN_TEST(schema_compile_errors);
+    RUN_TEST(schema_ignores_metadata);
+    RUN_TEST(schema_read_builds_tree);
+
+    TEST_SUMMARY("schema validation");
+}
@@ -0,0 +1,442 @@
+/**
+ * Test tape documents (edn_tape_read and cursors)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "../src/edn_internal.h"
+#include "test_framework.h"
+
+static edn_tape_t* read_tape(const char* input) {
+    edn_tape_t* tape = NULL;
+    edn_result_t result = edn_tape_read(input, 0, &tape);
+    if (result.error != EDN_OK) {
+        printf("\n    %s: %s\n", input, result.error_message);
+        return NULL;
+    }
+    return tape;
+}
+
+/* Converting the root must give the tree edn_read builds, written identically */
+static bool converts_like_read(const char* input) {
+    edn_tape_t* tape = read_tape(input);
+    if (tape == NULL) {
+        return false;
+    }
+    edn_result_t expected = edn_read(input, 0);
+    edn_value_t* actual = edn_tape_to_value(edn_tape_root(tape));
+    edn_tape_free(tape);
+
+    bool ok = expected.error == EDN_OK && actual != NULL && edn_value_equal(expected.value, actual);
+    char* expected_text = ok ? edn_write(expected.value) : NULL;
+    char* actual_text = ok ? edn_write(actual) : NULL;
+    if (ok && strcmp(expected_text, actual_text) != 0) {
+        printf("\n    %s: read writes %s, tape writes %s\n", input, expected_text, actual_text);
+        ok = false;
+    } else if (!ok) {
+        printf("\n    %s: tape conversion differs from edn_read\n", input);
+    }
+    free(expected_text);
+    free(actual_text);
+    edn_free(expected.value);
+    edn_free(actual);
+    return ok;
+}
+
+TEST(tape_scalars) {
+    edn_tape_t* tape = read_tape("[nil true false 42 -1.5 \\a \"hi\\n\\\"x\\\"\" :ns/kw sym "
+                                 "12345678901234567890N 1.5M]");
+    assert(tape != NULL);
+
+    edn_tape_cursor_t root = edn_tape_root(tape);
+    assert(edn_tape_type(root) == EDN_TYPE_VECTOR);
+    assert(edn_tape_count(root) == 11);
+
+    edn_tape_cursor_t c = edn_tape_child(root);
+    assert(edn_tape_type(c) == EDN_TYPE_NIL);
+
+    bool b;
+    c = edn_tape_next(c);
+    assert(edn_tape_bool_get(c, &b) && b);
+    c = edn_tape_next(c);
+    assert(edn_tape_bool_get(c, &b) && !b);
+
+    int64_t i;
+    c = edn_tape_next(c);
+    assert(edn_tape_int64_get(c, &i) && i == 42);
+    assert(!edn_tape_bool_get(c, &b));
+
+    double d;
+    c = edn_tape_next(c);
+    assert(edn_tape_double_get(c, &d) && d == -1.5);
+    assert(!edn_tape_int64_get(c, &i));
+
+    uint32_t cp;
+    c = edn_tape_next(c);
+    assert(edn_tape_character_get(c, &cp) && cp == 'a');
+
+    size_t length;
+    c = edn_tape_next(c);
+    const char* s = edn_tape_string_get(c, &length);
+    assert(s != NULL && length == 6 && memcmp(s, "hi\n\"x\"", 6) == 0 && s[6] == '\0');
+
+    const char* ns;
+    const char* name;
+    size_t ns_length, name_length;
+    c = edn_tape_next(c);
+    assert(edn_tape_keyword_get(c, &ns, &ns_length, &name, &name_length));
+    assert(ns_length == 2 && strcmp(ns, "ns") == 0);
+    assert(name_length == 2 && strcmp(name, "kw") == 0);
+    assert(!edn_tape_symbol_get(c, NULL, NULL, NULL, NULL));
+
+    c = edn_tape_next(c);
+    assert(edn_tape_symbol_get(c, &ns, &ns_length, &name, &name_length));
+    assert(ns == NULL && ns_length == 0 && strcmp(name, "sym") == 0);
+
+    bool negative;
+    uint8_t radix;
+    c = edn_tape_next(c);
+    const char* digits = edn_tape_bigint_get(c, &length, &negative, &radix);
+    assert(digits != NULL && strcmp(digits, "12345678901234567890") == 0);
+    assert(length == 20 && !negative && radix == 10);
+
+    c = edn_tape_next(c);
+    digits = edn_tape_bigdec_get(c, &length, &negative);
+    assert(digits != NULL && length == 3 && strncmp(digits, "1.5", 3) == 0 && !negative);
+
+    c = edn_tape_next(c);
+    assert(edn_tape_at_end(c));
+    assert(edn_tape_at_end(edn_tape_next(root)));
+
+    edn_tape_free(tape);
+}
+
+TEST(tape_collections) {
+    edn_tape_t* tape = read_tape("{:a [1 [2 3] 4] :b #{} :c (5) :d {}}");
+    assert(tape != NULL);
+
+    edn_tape_cursor_t root = edn_tape_root(tape);
+    assert(edn_tape_type(root) == EDN_TYPE_MAP);
+    assert(edn_tape_count(root) == 4);
+
+    /* Walk keys, skipping values whole */
+    const char* expected_keys[] = {"a", "b", "c", "d"};
+    const edn_type_t expected_types[] = {EDN_TYPE_VECTOR, EDN_TYPE_SET, EDN_TYPE_LIST,
+                                         EDN_TYPE_MAP};
+    const size_t expected_counts[] = {3, 0, 1, 0};
+    size_t n = 0;
+    for (edn_tape_cursor_t k = edn_tape_child(root); !edn_tape_at_end(k);
+         k = edn_tape_next(edn_tape_next(k))) {
+        const char* name;
+        assert(edn_tape_keyword_get(k, NULL, NULL, &name, NULL));
+        assert(strcmp(name, expected_keys[n]) == 0);
+        edn_tape_cursor_t v = edn_tape_next(k);
+        assert(edn_tape_type(v) == expected_types[n]);
+        assert(edn_tape_count(v) == expected_counts[n]);
+        n++;
+    }
+    assert(n == 4);
+
+    /* Empty collections have no children */
+    edn_tape_cursor_t b = edn_tape_next(edn_tape_next(edn_tape_child(root)));
+    b = edn_tape_next(b);
+    assert(edn_tape_type(b) == EDN_TYPE_SET);
+    assert(edn_tape_at_end(edn_tape_child(b)));
+
+    /* Nested vector: sum every integer depth-first */
+    edn_tape_cursor_t a = edn_tape_next(edn_tape_child(root));
+    int64_t sum = 0;
+    for (edn_tape_cursor_t c = edn_tape_child(a); !edn_tape_at_end(c); c = edn_tape_next(c)) {
+        int64_t i;
+        if (edn_tape_int64_get(c, &i)) {
+            sum += i;
+        } else {
+            assert(edn_tape_type(c) == EDN_TYPE_VECTOR);
+            for (edn_tape_cursor_t e = edn_tape_child(c); !edn_tape_at_end(e);
+                 e = edn_tape_next(e)) {
+                assert(edn_tape_int64_get(e, &i));
+                sum += i;
+            }
+        }
+    }
+    assert(sum == 10);
+
+    /* Scalars have no children or count */
+    edn_tape_cursor_t key = edn_tape_child(root);
+    assert(edn_tape_at_end(edn_tape_child(key)));
+    assert(edn_tape_count(key) == 0);
+
+    edn_tape_free(tape);
+}
+
+TEST(tape_tagged) {
+    edn_tape_t* tape = read_tape("[#inst \"2024-01-01T00:00:00Z\" #my/point [1 2] 3]");
+    assert(tape != NULL);
+
+    edn_tape_cursor_t root = edn_tape_root(tape);
+    assert(edn_tape_count(root) == 3);
+
+    edn_tape_cursor_t c = edn_tape_child(root);
+    assert(edn_tape_type(c) == EDN_TYPE_TAGGED);
+    size_t length;
+    const char* tag = edn_tape_tag_get(c, &length);
+    assert(tag != NULL && length == 4 && strcmp(tag, "inst") == 0);
+    assert(edn_tape_type(edn_tape_child(c)) == EDN_TYPE_STRING);
+
+    c = edn_tape_next(c);
+    tag = edn_tape_tag_get(c, &length);
+    assert(strcmp(tag, "my/point") == 0);
+    edn_tape_cursor_t point = edn_tape_child(c);
+    assert(edn_tape_type(point) == EDN_TYPE_VECTOR && edn_tape_count(point) == 2);
+
+    int64_t i;
+    c = edn_tape_next(c);
+    assert(edn_tape_int64_get(c, &i) && i == 3);
+    assert(edn_tape_at_end(edn_tape_next(c)));
+
+    edn_tape_free(tape);
+}
+
+TEST(tape_iterator) {
+    edn_tape_t* tape = read_tape("[1 {:a \"s\"} #t x]");
+    assert(tape != NULL);
+
+    static const edn_type_t types[] = {EDN_TYPE_VECTOR, EDN_TYPE_INT,    EDN_TYPE_MAP,
+                                       EDN_TYPE_KEYWORD, EDN_TYPE_STRING, EDN_TYPE_MAP,
+                                       EDN_TYPE_TAGGED, EDN_TYPE_SYMBOL, EDN_TYPE_VECTOR};
+    static const bool ends[] = {false, false, false, false, false, true, false, false, true};
+
+    edn_tape_cursor_t c = edn_tape_root(tape);
+    edn_tape_item_t item;
+    size_t n = 0;
+    while (edn_tape_iter_next(&c, &item)) {
+        assert(n < sizeof(types) / sizeof(types[0]));
+        assert(item.type == types[n] && item.end == ends[n]);
+        if (n == 1) {
+            assert(item.integer == 1);
+        } else if (n == 3) {
+            assert(item.length == 1 && memcmp(item.text, "a", 1) == 0 && item.ns == NULL);
+        } else if (n == 4 || n == 6) {
+            assert(item.length == 1 && item.text[0] == (n == 4 ? 's' : 't'));
+        } else if (n == 2) {
+            assert(edn_tape_count(item.cursor) == 1);
+        }
+        n++;
+    }
+    assert(n == sizeof(types) / sizeof(types[0]));
+    assert(!edn_tape_iter_next(&c, &item));
+    edn_tape_free(tape);
+}
+
+TEST(tape_to_value) {
+    assert(converts_like_read("nil"));
+    assert(converts_like_read("42"));
+    assert(converts_like_read("\"plain\""));
+    assert(converts_like_read("\"esc \\\"q\\\" \\\\ \\t \\n \\r\""));
+    assert(converts_like_read("[1 2.5 \\c :k :ns/k s ns/s 9999999999999999999999N 1.25M]"));
+    assert(converts_like_read("{:a {:b [1 #{2 3} (4 5)]} \"k\" nil [1] {}}"));
+    assert(converts_like_read("#my/tag {:x #other [1]}"));
+    assert(converts_like_read("[#_ignored 1 #_#_a b 2]"));
+    assert(converts_like_read("[[] () #{} {}]"));
+}
+
+TEST(tape_subtree_to_value) {
+    edn_tape_t* tape = read_tape("[{:id 1 :tags #{:a :b}} {:id 2 :tags #{}}]");
+    assert(tape != NULL);
+
+    edn_tape_cursor_t second = edn_tape_next(edn_tape_child(edn_tape_root(tape)));
+    edn_value_t* value = edn_tape_to_value(second);
+    edn_tape_free(tape); /* Converted values do not point into the tape */
+
+    edn_result_t expected = edn_read("{:id 2 :tags #{}}", 0);
+    assert(value != NULL && edn_value_equal(value, expected.value));
+    assert(edn_type(edn_map_get_keyword(value, "tags")) == EDN_TYPE_SET);
+
+    edn_free(expected.value);
+    edn_free(value);
+}
+
+TEST(tape_large_document) {
+    size_t cap = 64 * 1024;
+    char* input = malloc(cap);
+    assert(input != NULL);
+    size_t pos = (size_t) snprintf(input, cap, "[");
+    for (int i = 0; i < 2000; i++) {
+        pos += (size_t) snprintf(input + pos, cap - pos, "{:n %d :s \"v%d\"} ", i, i);
+    }
+    snprintf(input + pos, cap - pos, "]");
+
+    edn_tape_t* tape = read_tape(input);
+    assert(tape != NULL);
+    edn_tape_cursor_t root = edn_tape_root(tape);
+    assert(edn_tape_count(root) == 2000);
+
+    int64_t sum = 0;
+    size_t maps = 0;
+    for (edn_tape_cursor_t m = edn_tape_child(root); !edn_tape_at_end(m); m = edn_tape_next(m)) {
+        int64_t n;
+        assert(edn_tape_int64_get(edn_tape_next(edn_tape_child(m)), &n));
+        sum += n;
+        maps++;
+    }
+    assert(maps == 2000);
+    assert(sum == 1999 * 2000 / 2);
+    edn_tape_free(tape);
+
+    assert(converts_like_read(input));
+    free(input);
+}
+
+TEST(tape_errors) {
+    edn_tape_t* tape = (edn_tape_t*) 1;
+    edn_result_t result = edn_tape_read("[1 2", 0, &tape);
+    assert(result.error == EDN_ERROR_UNTERMINATED_COLLECTION);
+    assert(tape == NULL);
+
+    edn_result_t expected = edn_read("{:a 1 :b}", 0);
+    result = edn_tape_read("{:a 1 :b}", 0, &tape);
+    assert(result.error == expected.error);
+    assert(result.error_start.offset == expected.error_start.offset);
+    assert(tape == NULL);
+
+    result = edn_tape_read("1", 0, NULL);
+    assert(result.error == EDN_ERROR_INVALID_ARGUMENT);
+}
+
+/* Duplicates must fail with the error and range edn_read reports */
+static bool rejects_like_read(const char* input) {
+    edn_tape_t* tape = (edn_tape_t*) 1;
+    edn_result_t result = edn_tape_read(input, 0, &tape);
+    edn_result_t expected = edn_read(input, 0);
+    bool ok = expected.error != EDN_OK && result.error == expected.error && tape == NULL &&
+              result.error_start.offset == expected.error_start.offset &&
+              result.error_end.offset == expected.error_end.offset;
+    if (!ok) {
+        printf("\n    %s: tape error %d at %zu, read error %d at %zu\n", input, result.error,
+               result.error_start.offset, expected.error, expected.error_start.offset);
+    }
+    edn_free(expected.value);
+    return ok;
+}
+
+TEST(tape_duplicates) {
+    assert(rejects_like_read("{:a 1 :a 2}"));
+    assert(rejects_like_read("#{1 2 1}"));
+    assert(rejects_like_read("[0 #{[1] (1)}]"));
+    assert(rejects_like_read("#{{:a 1 :b 2} {:b 2 :a 1}}"));
+    assert(rejects_like_read("{#{1 2} :x #{2 1} :y}"));
+    assert(rejects_like_read("{:a {:b 1 :b 2}}"));
+    assert(rejects_like_read("#{#inst \"2020-01-01T00:00:00Z\" #inst \"2020-01-01T00:00:00Z\"}"));
+    assert(rejects_like_read("#{^:m [1] [1]}"));
+    assert(rejects_like_read("#{\"abcdefghijklmnopq\" \"abcdefghijklmnopq\"}"));
+
+    /* Strings compare decoded, where edn_read compares their source */
+    edn_tape_t* decoded = NULL;
+    assert(edn_tape_read("#{\"\\t\" \"\t\"}", 0, &decoded).error ==
+           EDN_ERROR_DUPLICATE_ELEMENT);
+    assert(decoded == NULL);
+
+    /* Equal values that are not duplicates, and values only a map key compares */
+    assert(converts_like_read("#{1 1.0 \"1\" :1 [1 2] [2 1]}"));
+    assert(converts_like_read("{:a 1 :b 1 [1] [1]}"));
+    assert(converts_like_read("#{{:a 1} {:a 2} #{1} #{2}}"));
+    assert(converts_like_read("#{\"abcdefghijklmnopq\" \"abcdefghijklmnopr\" :a/bc :ab/c}"));
+
+    /* Large sets sort their hashes; 1100 elements also reach edn_read's hash tier */
+    size_t size = 1100 * 8 + 16;
+    char* input = malloc(size);
+    assert(input != NULL);
+    size_t len = (size_t) snprintf(input, size, "#{");
+    size_t hundred = 0;
+    for (int i = 0; i < 1100; i++) {
+        hundred = i == 100 ? len : hundred;
+        len += (size_t) snprintf(input + len, size - len, "[%d] ", i);
+    }
+    snprintf(input + len, size - len, "}");
+    assert(converts_like_read(input));
+    snprintf(input + len, size - len, "[57]}");
+    assert(rejects_like_read(input));
+
+    edn_tape_t* tape = NULL;
+    snprintf(input + hundred, size - hundred, "[57]}");
+    assert(edn_tape_read(input, 0, &tape).error == EDN_ERROR_DUPLICATE_ELEMENT);
+    assert(tape == NULL);
+    free(input);
+}
+
+TEST(tape_api_null) {
+    edn_tape_cursor_t none = {NULL, 0};
+    assert(edn_tape_at_end(none));
+    assert(edn_tape_type(none) == EDN_TYPE_NIL);
+    assert(edn_tape_count(none) == 0);
+    assert(edn_tape_at_end(edn_tape_next(none)));
+    assert(edn_tape_at_end(edn_tape_child(none)));
+    assert(edn_tape_string_get(none, NULL) == NULL);
+    assert(edn_tape_to_value(none) == NULL);
+    assert(edn_tape_length(NULL) == 0);
+    edn_tape_free(NULL);
+}
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+TEST(tape_clojure_extensions) {
+    edn_tape_t* tape = read_tape("[^:private ^{:doc \"x\"} [1] 3/4 #:user{:id 7} ^String s]");
+    assert(tape != NULL);
+
+    edn_tape_cursor_t root = edn_tape_root(tape);
+    assert(edn_tape_count(root) == 4);
+
+    /* Accessors look through metadata */
+    edn_tape_cursor_t c = edn_tape_child(root);
+    assert(edn_tape_type(c) == EDN_TYPE_VECTOR);
+    assert(edn_tape_count(c) == 1);
+
+    int64_t num, den;
+    c = edn_tape_next(c);
+    assert(edn_tape_ratio_get(c, &num, &den) && num == 3 && den == 4);
+
+    const char* ns;
+    c = edn_tape_next(c);
+    assert(edn_tape_keyword_get(edn_tape_child(c), &ns, NULL, NULL, NULL));
+    assert(strcmp(ns, "user") == 0);
+
+    c = edn_tape_next(c);
+    assert(edn_tape_type(c) == EDN_TYPE_SYMBOL);
+    assert(edn_tape_at_end(edn_tape_next(c)));
+    edn_tape_free(tape);
+
+    assert(converts_like_read("^:private ^{:doc \"x\" :private false} [1]"));
+    assert(converts_like_read("[3/4 #:user{:id 7 :_/raw 8} ^String s ^[long] f]"));
+
+    edn_result_t expected = edn_read("^:a ^{:b 1} [x]", 0);
+    tape = read_tape("^:a ^{:b 1} [x]");
+    edn_value_t* value = edn_tape_to_value(edn_tape_root(tape));
+    edn_tape_free(tape);
+    const edn_value_t* meta = edn_value_meta(value);
+    assert(edn_value_equal(meta, edn_value_meta(expected.value)));
+    assert(edn_map_count(meta) == 2);
+    edn_free(value);
+    edn_free(expected.value);
+}
+#endif
+
+int main(void) {
+    printf("Running tape document tests...\n");
+
+    RUN_TEST(tape_scalars);
+    RUN_TEST(tape_collections);
+    RUN_TEST(tape_tagged);
+    RUN_TEST(tape_iterator);
+    RUN_TEST(tape_to_value);
+    RUN_TEST(tape_subtree_to_value);
+    RUN_TEST(tape_large_document);
+    RUN_TEST(tape_errors);
+    RUN_TEST(tape_duplicates);
+    RUN_TEST(tape_api_null);
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    RUN_TEST(tape_clojure_extensions);
+#endif
+
+    TEST_SUMMARY("tape document");
+}
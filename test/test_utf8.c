@@ -0,0 +1,206 @@
+/**
+ * Test UTF-8 validation: the shared validator and strict parse mode
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "../src/edn_internal.h"
+#include "test_framework.h"
+
+/* Offset of the first ill-formed sequence, or -1 if the bytes are valid */
+static long first_invalid(const char* s, size_t len) {
+    const char* bad = edn_simd_validate_utf8(s, s + len);
+    return bad == s + len ? -1 : (long) (bad - s);
+}
+
+TEST(validator_accepts_well_formed) {
+    assert_int_eq(first_invalid("", 0), -1);
+    assert_int_eq(first_invalid("plain ascii", 11), -1);
+    assert_int_eq(first_invalid("\xC2\x80", 2), -1);             /* U+0080 */
+    assert_int_eq(first_invalid("\xDF\xBF", 2), -1);             /* U+07FF */
+    assert_int_eq(first_invalid("\xE0\xA0\x80", 3), -1);         /* U+0800 */
+    assert_int_eq(first_invalid("\xED\x9F\xBF", 3), -1);         /* U+D7FF */
+    assert_int_eq(first_invalid("\xEE\x80\x80", 3), -1);         /* U+E000 */
+    assert_int_eq(first_invalid("\xEF\xBF\xBF", 3), -1);         /* U+FFFF */
+    assert_int_eq(first_invalid("\xF0\x90\x80\x80", 4), -1);     /* U+10000 */
+    assert_int_eq(first_invalid("\xF4\x8F\xBF\xBF", 4), -1);     /* U+10FFFF */
+    assert_int_eq(first_invalid("h\xC3\xA9llo w\xC3\xB6rld", 13), -1);
+}
+
+TEST(validator_rejects_ill_formed) {
+    assert_int_eq(first_invalid("\x80", 1), 0);                 /* Lone continuation */
+    assert_int_eq(first_invalid("ab\xC0\xAF", 4), 2);           /* Overlong '/' */
+    assert_int_eq(first_invalid("\xC1\xBF", 2), 0);             /* Overlong */
+    assert_int_eq(first_invalid("\xE0\x9F\xBF", 3), 0);         /* Overlong 3-byte */
+    assert_int_eq(first_invalid("\xF0\x8F\xBF\xBF", 4), 0);     /* Overlong 4-byte */
+    assert_int_eq(first_invalid("x\xED\xA0\x80", 4), 1);        /* Surrogate U+D800 */
+    assert_int_eq(first_invalid("\xF4\x90\x80\x80", 4), 0);     /* U+110000 */
+    assert_int_eq(first_invalid("\xF5\x80\x80\x80", 4), 0);     /* Invalid lead */
+    assert_int_eq(first_invalid("\xFF", 1), 0);
+    assert_int_eq(first_invalid("ok\xE2\x82", 4), 2);           /* Truncated at end */
+    assert_int_eq(first_invalid("\xE2\x82z", 3), 0);            /* Truncated by ASCII */
+    assert_int_eq(first_invalid("\xC3\xA9\xA9", 3), 2);         /* Extra continuation */
+}
+
+/* Sequences straddling 16-byte block boundaries, and errors in any block */
+TEST(validator_block_boundaries) {
+    char buf[80];
+    for (size_t offset = 0; offset < 40; offset++) {
+        memset(buf, 'a', sizeof(buf));
+        memcpy(buf + offset, "\xF0\x9F\x98\x80", 4); /* U+1F600 */
+        assert_int_eq(first_invalid(buf, sizeof(buf)), -1);
+
+        buf[offset + 3] = 'a'; /* Cut the sequence short */
+        assert_int_eq(first_invalid(buf, sizeof(buf)), (long) offset);
+
+        /* Lead byte as the very last byte, at every input length */
+        memset(buf, 'a', sizeof(buf));
+        buf[offset] = (char) 0xE2;
+        assert_int_eq(first_invalid(buf, offset + 1), (long) offset);
+    }
+
+    /* Error after a run of valid multi-byte text and ASCII blocks */
+    char text[200];
+    size_t n = 0;
+    for (int i = 0; i < 30; i++) {
+        memcpy(text + n, "\xC3\xA9\xE2\x82\xAC", 5);
+        n += 5;
+    }
+    memset(text + n, 'z', 40);
+    n += 40;
+    assert_int_eq(first_invalid(text, n), -1);
+    text[n - 3] = (char) 0xA0;
+    assert_int_eq(first_invalid(text, n), (long) (n - 3));
+}
+
+TEST(default_mode_accepts_any_bytes) {
+    edn_result_t r = edn_read("\"\xC0\xAF\"", 0);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+
+    r = edn_read(":k\xFF", 0);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+}
+
+TEST(strict_strings) {
+    edn_result_t r =
+        read_with("[\"caf\xC3\xA9\" \"\xE2\x82\xAC 5\" \"ascii\\\\\\\"\"]", NULL, true);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+
+    r = read_with("[\"ok\" \"bad \xC0\xAF here\"]", NULL, true);
+    assert(r.error == EDN_ERROR_INVALID_STRING);
+    assert_str_eq(r.error_message, "Invalid UTF-8 in string");
+    assert_uint_eq(r.error_start.offset, 11);
+
+    /* Long string: non-ASCII found by the SIMD quote scan */
+    char input[128];
+    memset(input, 'x', sizeof(input));
+    input[0] = '"';
+    input[70] = (char) 0xED; /* Surrogate */
+    input[71] = (char) 0xA0;
+    input[72] = (char) 0x80;
+    input[100] = '"';
+    input[101] = '\0';
+    r = read_with(input, NULL, true);
+    assert(r.error == EDN_ERROR_INVALID_STRING);
+    assert_uint_eq(r.error_start.offset, 70);
+
+    /* A non-ASCII byte right after the closing quote is not part of the string */
+    r = read_with("[\"abcdefghijklmnop\" \xC3\xA9]", NULL, true);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+}
+
+TEST(strict_identifiers) {
+    edn_result_t r = read_with("{:caf\xC3\xA9 ns\xC3\xA9/sym}", NULL, true);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+
+    r = read_with("[:ok :k\xFF]", NULL, true);
+    assert(r.error == EDN_ERROR_INVALID_SYNTAX);
+    assert_str_eq(r.error_message, "Invalid UTF-8 in identifier");
+    assert_uint_eq(r.error_start.offset, 7);
+
+    r = read_with("#t\xC3 1", NULL, true);
+    assert(r.error == EDN_ERROR_INVALID_SYNTAX);
+}
+
+/* Raw reader returning the slice length */
+static edn_value_t* raw_length(const char* source, size_t length, edn_arena_t* arena,
+                               const char** error_message) {
+    (void) source;
+    edn_value_t* result = edn_arena_alloc_value(arena);
+    if (result == NULL) {
+        *error_message = "Out of memory";
+        return NULL;
+    }
+    result->type = EDN_TYPE_INT;
+    result->as.integer = (int64_t) length;
+    result->arena = arena;
+    return result;
+}
+
+TEST(strict_raw_tagged_forms) {
+    edn_reader_registry_t* registry = edn_reader_registry_create();
+    assert(registry != NULL);
+    assert(edn_reader_register_raw(registry, "raw", raw_length));
+
+    edn_result_t r = read_with("#raw [\"\xC3\xA9\" x]", registry, true);
+    assert(r.error == EDN_OK);
+    edn_free(r.value);
+
+    r = read_with("#raw [\"\xC3\" x]", registry, true);
+    assert(r.error == EDN_ERROR_INVALID_STRING);
+
+    edn_reader_registry_destroy(registry);
+}
+
+TEST(strict_validate_only) {
+    edn_validate_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.strict_utf8 = true;
+
+    assert(edn_validate("{:n\xC3\xA9 \"\xE2\x82\xAC\"}", 0, &opts, NULL).error == EDN_OK);
+    assert(edn_validate("{:n \"\xE2\x82\"}", 0, &opts, NULL).error == EDN_ERROR_INVALID_STRING);
+    assert(edn_validate("[:n\xE2]", 0, &opts, NULL).error == EDN_ERROR_INVALID_SYNTAX);
+    assert(edn_validate("[\\a \"\xF8\"]", 0, &opts, NULL).error == EDN_ERROR_INVALID_STRING);
+
+    /* Off unless requested */
+    assert(edn_validate("\"\xF8\"", 0, NULL, NULL).error == EDN_OK);
+}
+
+static int discard_sink(const char* data, size_t n, void* ctx) {
+    (void) data;
+    (void) n;
+    (void) ctx;
+    return 0;
+}
+
+TEST(emitter_rejects_ill_formed_strings) {
+    edn_emitter_t* em = edn_emitter_create(discard_sink, NULL, NULL);
+    assert(em != NULL);
+    assert_int_eq(edn_emit_begin_vector(em), 0);
+    assert_int_eq(edn_emit_string(em, "caf\xC3\xA9 \xF0\x9F\x98\x80", (size_t) -1), 0);
+    assert_int_eq(edn_emit_string(em, "\xED\xA0\x80", 3), -EDN_ERROR_INVALID_ARGUMENT);
+    edn_emitter_destroy(em);
+}
+
+int main(void) {
+    printf("Running UTF-8 validation tests...\n");
+
+    RUN_TEST(validator_accepts_well_formed);
+    RUN_TEST(validator_rejects_ill_formed);
+    RUN_TEST(validator_block_boundaries);
+    RUN_TEST(default_mode_accepts_any_bytes);
+    RUN_TEST(strict_strings);
+    RUN_TEST(strict_identifiers);
+    RUN_TEST(strict_raw_tagged_forms);
+    RUN_TEST(strict_validate_only);
+    RUN_TEST(emitter_rejects_ill_formed_strings);
+
+    TEST_SUMMARY("UTF-8 validation");
+}
@@ -0,0 +1,210 @@
+/**
+ * Test validation-only parsing (edn_validate)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "test_framework.h"
+
+/* edn_validate with duplicate checks must agree with edn_read on error and position */
+static bool agrees_with_read(const char* input) {
+    edn_result_t expected = edn_read(input, 0);
+    edn_result_t actual = validate_with(input, true, NULL);
+    edn_free(expected.value);
+
+    if (actual.value != NULL || actual.error != expected.error) {
+        printf("\n    %s: read error %d, validate error %d\n", input, expected.error,
+               actual.error);
+        return false;
+    }
+    if (expected.error != EDN_OK &&
+        (actual.error_start.offset != expected.error_start.offset ||
+         actual.error_end.offset != expected.error_end.offset ||
+         strcmp(actual.error_message, expected.error_message) != 0)) {
+        printf("\n    %s: read \"%s\" at %zu-%zu, validate \"%s\" at %zu-%zu\n", input,
+               expected.error_message, expected.error_start.offset, expected.error_end.offset,
+               actual.error_message, actual.error_start.offset, actual.error_end.offset);
+        return false;
+    }
+    return true;
+}
+
+TEST(valid_forms) {
+    assert(agrees_with_read("42"));
+    assert(agrees_with_read("-17"));
+    assert(agrees_with_read("3.25e-2"));
+    assert(agrees_with_read("0x1F"));
+    assert(agrees_with_read("12345678901234567890123"));
+    assert(agrees_with_read("1.5M"));
+    assert(agrees_with_read("\"esc\\\"aped\\n\""));
+    assert(agrees_with_read("\\newline"));
+    assert(agrees_with_read("nil"));
+    assert(agrees_with_read(":ns.a/kw"));
+    assert(agrees_with_read("a.b/c"));
+    assert(agrees_with_read("##Inf"));
+    assert(agrees_with_read("{:a [1 2 (3 #{4 5})] \"k\" {:nested true}} ; trailing"));
+    assert(agrees_with_read("#inst \"2024-01-01T00:00:00Z\""));
+    assert(agrees_with_read("[#_ skipped 1 #_ #_ 2 3 4]"));
+    assert(agrees_with_read("{:a 1 #_ :b}"));
+}
+
+TEST(syntax_errors) {
+    assert(agrees_with_read(""));
+    assert(agrees_with_read("   ; only a comment"));
+    assert(agrees_with_read("[1 2"));
+    assert(agrees_with_read("{:a 1"));
+    assert(agrees_with_read("#{1 2"));
+    assert(agrees_with_read("(1 2]"));
+    assert(agrees_with_read(")"));
+    assert(agrees_with_read("{:a}"));
+    assert(agrees_with_read("\"open"));
+    assert(agrees_with_read(":"));
+    assert(agrees_with_read("::kw"));
+    assert(agrees_with_read(":ns/"));
+    assert(agrees_with_read("[1 #_]"));
+    assert(agrees_with_read("# tag"));
+    assert(agrees_with_read("#:kw 1"));
+    assert(agrees_with_read("#tag"));
+    assert(agrees_with_read("[\\ ]"));
+    assert(agrees_with_read("[1 0x]"));
+}
+
+TEST(duplicate_detection) {
+    assert(agrees_with_read("{:a 1 :a 2}"));
+    assert(agrees_with_read("{:a 1 :b 2 :ns/a 3}"));
+    assert(agrees_with_read("#{1 2 1}"));
+    assert(agrees_with_read("#{\"x\" \"x\"}"));
+    assert(agrees_with_read("#{[1 2] (1 2)}"));
+    assert(agrees_with_read("#{[1 2] [2 1]}"));
+    assert(agrees_with_read("#{#{1 2} #{2 1}}"));
+    assert(agrees_with_read("#{{:a 1 :b 2} {:b 2 :a 1}}"));
+    assert(agrees_with_read("#{{:a 1} {:a 2}}"));
+    assert(agrees_with_read("#{nil false}"));
+    assert(agrees_with_read("#{1 1.0}"));
+    assert(agrees_with_read("#{1.5 1.5}"));
+    assert(agrees_with_read("#{1.5 15e-1}"));
+    assert(agrees_with_read("#{0.1 1e-1 2.5E+3}"));
+    assert(agrees_with_read("#{-0.0 0.0}"));
+    assert(agrees_with_read("#{0.3 0.30000000000000004}"));
+    assert(agrees_with_read("#{1e300 1.0e300}"));
+    assert(agrees_with_read("#{12345678901234567.5 12345678901234567.6}"));
+    assert(agrees_with_read("#{\\a \\a}"));
+    assert(agrees_with_read("#{#t 1 #t 1}"));
+    assert(agrees_with_read("#{#t 1 #u 1}"));
+    assert(agrees_with_read("{[#{:x}] 1 [#{:x}] 2}"));
+    assert(agrees_with_read("{:outer {:a 1} :inner {:a 1}}"));
+
+    /* Enough elements to leave the inline hash stack and the pairwise check */
+    char big[4096];
+    size_t pos = (size_t) snprintf(big, sizeof(big), "#{");
+    for (int i = 0; i < 300; i++) {
+        pos += (size_t) snprintf(big + pos, sizeof(big) - pos, "%d ", i);
+    }
+    snprintf(big + pos, sizeof(big) - pos, "}");
+    assert(agrees_with_read(big));
+    snprintf(big + pos, sizeof(big) - pos, "17}");
+    assert(agrees_with_read(big));
+
+    /* Off by default */
+    assert(validate_with("{:a 1 :a 2}", false, NULL).error == EDN_OK);
+    assert(edn_validate("#{1 1}", 0, NULL, NULL).error == EDN_OK);
+}
+
+TEST(form_counts) {
+    edn_validate_stats_t stats;
+    edn_result_t r = validate_with("{:a [1 2 #{3}] #_ :skipped :b (nil)}", false, &stats);
+    assert(r.error == EDN_OK);
+    assert(r.value == NULL);
+    assert_uint_eq(stats.forms, 10);
+    assert_uint_eq(stats.collections, 4);
+    assert_uint_eq(stats.max_depth, 3);
+
+    r = validate_with("#tag [1]", false, &stats);
+    assert(r.error == EDN_OK);
+    assert_uint_eq(stats.forms, 3);
+    assert_uint_eq(stats.collections, 1);
+
+    /* Counts stop where validation did */
+    r = validate_with("[1 2 (3", false, &stats);
+    assert(r.error == EDN_ERROR_UNTERMINATED_COLLECTION);
+    assert_uint_eq(stats.forms, 3);
+    assert_uint_eq(stats.max_depth, 2);
+
+    assert(validate_with("42", false, NULL).error == EDN_OK);
+}
+
+TEST(caller_scratch) {
+    uint64_t scratch[600];
+    edn_validate_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.check_duplicates = true;
+    opts.scratch = (char*) scratch + 1; /* Deliberately misaligned */
+    opts.scratch_size = sizeof(scratch) - 1;
+
+    char doc[4096];
+    size_t pos = (size_t) snprintf(doc, sizeof(doc), "{");
+    for (int i = 0; i < 400; i++) {
+        pos += (size_t) snprintf(doc + pos, sizeof(doc) - pos, ":k%d %d ", i, i);
+    }
+    snprintf(doc + pos, sizeof(doc) - pos, "}");
+    assert(edn_validate(doc, 0, &opts, NULL).error == EDN_OK);
+
+    snprintf(doc + pos, sizeof(doc) - pos, ":k7 0}");
+    assert(edn_validate(doc, 0, &opts, NULL).error == EDN_ERROR_DUPLICATE_KEY);
+}
+
+TEST(depth_limit) {
+    char deep[2 * 2000 + 1];
+    memset(deep, '[', 2000);
+    memset(deep + 2000, ']', 2000);
+    deep[4000] = '\0';
+    assert(validate_with(deep, false, NULL).error == EDN_ERROR_MAX_DEPTH_EXCEEDED);
+
+    edn_validate_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.max_depth = 4;
+    assert(edn_validate("[[[[1]]]]", 0, &opts, NULL).error == EDN_OK);
+    assert(edn_validate("[[[[[1]]]]]", 0, &opts, NULL).error == EDN_ERROR_MAX_DEPTH_EXCEEDED);
+}
+
+TEST(null_input) {
+    edn_validate_stats_t stats = {1, 1, 1};
+    edn_result_t r = edn_validate(NULL, 0, NULL, &stats);
+    assert(r.error == EDN_ERROR_INVALID_SYNTAX);
+    assert_uint_eq(stats.forms, 0);
+}
+
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+TEST(clojure_extensions) {
+    assert(agrees_with_read("#:user{:name 1 :age 2}"));
+    assert(agrees_with_read("#:user{:name 1 :user/name 2}"));
+    assert(agrees_with_read("#:user{:name 1 :_/name 2}"));
+    assert(agrees_with_read("#:user{:name 1 :other/name 2}"));
+    assert(agrees_with_read("#:user/x{:a 1}"));
+    assert(agrees_with_read("^:private foo"));
+    assert(agrees_with_read("^{:a 1} [x]"));
+    assert(agrees_with_read("^:m 42"));
+    assert(agrees_with_read("^42 foo"));
+    assert(agrees_with_read("#{^:a [1] [1]}"));
+    assert(agrees_with_read("#{3/4 6/8}"));
+}
+#endif
+
+int main(void) {
+    printf("Running validation-only parser tests...\n");
+
+    RUN_TEST(valid_forms);
+    RUN_TEST(syntax_errors);
+    RUN_TEST(duplicate_detection);
+    RUN_TEST(form_counts);
+    RUN_TEST(caller_scratch);
+    RUN_TEST(depth_limit);
+    RUN_TEST(null_input);
+#ifdef EDN_ENABLE_CLOJURE_EXTENSION
+    RUN_TEST(clojure_extensions);
+#endif
+
+    TEST_SUMMARY("validation-only parser");
+}
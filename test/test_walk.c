@@ -0,0 +1,280 @@
+/**
+ * Test the non-recursive tree walker (edn_walk_t)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/edn.h"
+#include "test_framework.h"
+
+/* One character per type, upper case for post-order visits */
+static char type_code(const edn_walk_item_t* item) {
+    char c;
+    switch (edn_type(item->value)) {
+        case EDN_TYPE_INT:
+            c = 'i';
+            break;
+        case EDN_TYPE_KEYWORD:
+            c = 'k';
+            break;
+        case EDN_TYPE_STRING:
+            c = 's';
+            break;
+        case EDN_TYPE_LIST:
+            c = 'l';
+            break;
+        case EDN_TYPE_VECTOR:
+            c = 'v';
+            break;
+        case EDN_TYPE_MAP:
+            c = 'm';
+            break;
+        case EDN_TYPE_SET:
+            c = 'e';
+            break;
+        case EDN_TYPE_TAGGED:
+            c = 't';
+            break;
+        default:
+            c = '?';
+            break;
+    }
+    return item->post ? (char) (c - 'a' + 'A') : c;
+}
+
+/* Visits as "<code><depth>" separated by spaces */
+static char* trace(const edn_value_t* root, unsigned order) {
+    static char out[1024];
+    size_t used = 0;
+    edn_walk_t* walk = edn_walk_create(root, order);
+    if (walk == NULL) {
+        return NULL;
+    }
+    edn_walk_item_t item;
+    while (edn_walk_next(walk, &item) && used + 8 < sizeof(out)) {
+        used += (size_t) snprintf(out + used, sizeof(out) - used, "%s%c%zu", used ? " " : "",
+                                  type_code(&item), item.depth);
+    }
+    out[used] = '\0';
+    edn_walk_destroy(walk);
+    return out;
+}
+
+TEST(walk_orders) {
+    edn_result_t r = edn_read("{:a [1 (2)] :b #my/tag #{\"s\"}} ", 0);
+    assert(r.error == EDN_OK);
+
+    assert(strcmp(trace(r.value, EDN_WALK_PRE), "m0 k1 v1 i2 l2 i3 k1 t1 e2 s3") == 0);
+    assert(strcmp(trace(r.value, 0), "m0 k1 v1 i2 l2 i3 k1 t1 e2 s3") == 0);
+    assert(strcmp(trace(r.value, EDN_WALK_POST), "k1 i2 i3 L2 V1 k1 s3 E2 T1 M0") == 0);
+    assert(strcmp(trace(r.value, EDN_WALK_PRE | EDN_WALK_POST),
+                  "m0 k1 v1 i2 l2 i3 L2 V1 k1 t1 e2 s3 E2 T1 M0") == 0);
+    edn_free(r.value);
+
+    /* A scalar root is a single visit; empty collections still pair up */
+    r = edn_read("42", 0);
+    assert(strcmp(trace(r.value, EDN_WALK_PRE | EDN_WALK_POST), "i0") == 0);
+    edn_free(r.value);
+    r = edn_read("[[] {}]", 0);
+    assert(strcmp(trace(r.value, EDN_WALK_PRE | EDN_WALK_POST), "v0 v1 V1 m1 M1 V0") == 0);
+    edn_free(r.value);
+
+    assert(strcmp(trace(NULL, EDN_WALK_PRE), "") == 0);
+}
+
+TEST(walk_parent_key_index) {
+    edn_result_t r = edn_read("[:x {:k1 10 :k2 [20 21]}]", 0);
+    assert(r.error == EDN_OK);
+    edn_value_t* map = edn_vector_get(r.value, 1);
+
+    edn_walk_t* walk = edn_walk_create(r.value, EDN_WALK_PRE | EDN_WALK_POST);
+    assert(walk != NULL);
+    edn_walk_item_t item;
+
+    assert(edn_walk_next(walk, &item));
+    assert(item.value == r.value && item.parent == NULL && item.depth == 0 && !item.post);
+    assert(edn_walk_next(walk, &item)); /* :x */
+    assert(item.parent == r.value && item.index == 0 && item.key == NULL && !item.is_key);
+    assert(edn_walk_next(walk, &item)); /* the map */
+    assert(item.value == map && item.index == 1 && item.depth == 1);
+
+    assert(edn_walk_next(walk, &item)); /* :k1 */
+    assert(item.is_key && item.parent == map && item.index == 0 && item.key == NULL);
+    assert(item.value == edn_map_get_key(map, 0));
+    assert(edn_walk_next(walk, &item)); /* 10 */
+    assert(!item.is_key && item.index == 0 && item.key == edn_map_get_key(map, 0));
+    assert(item.value == edn_map_get_value(map, 0) && item.depth == 2);
+
+    assert(edn_walk_next(walk, &item)); /* :k2 */
+    assert(item.is_key && item.index == 1);
+    assert(edn_walk_next(walk, &item)); /* [20 21] */
+    const edn_value_t* inner = item.value;
+    assert(item.key == edn_map_get_key(map, 1) && item.index == 1 && !item.post);
+    assert(edn_walk_next(walk, &item)); /* 20 */
+    assert(item.parent == inner && item.index == 0 && item.key == NULL && item.depth == 3);
+    assert(edn_walk_next(walk, &item)); /* 21 */
+    assert(item.index == 1);
+
+    /* Post-order visits repeat the node's own position */
+    assert(edn_walk_next(walk, &item));
+    assert(item.post && item.value == inner && item.parent == map && item.index == 1);
+    assert(item.key == edn_map_get_key(map, 1) && item.depth == 2);
+    assert(edn_walk_next(walk, &item));
+    assert(item.post && item.value == map && item.parent == r.value && item.index == 1);
+    assert(edn_walk_next(walk, &item));
+    assert(item.post && item.value == r.value && item.parent == NULL);
+    assert(!edn_walk_next(walk, &item));
+    assert(!edn_walk_next(walk, &item));
+    assert(edn_walk_error(walk) == EDN_OK);
+
+    edn_walk_destroy(walk);
+    edn_free(r.value);
+}
+
+TEST(walk_skip) {
+    edn_result_t r = edn_read("[[1 2] {:a 1} 3]", 0);
+    assert(r.error == EDN_OK);
+
+    edn_walk_t* walk = edn_walk_create(r.value, EDN_WALK_PRE | EDN_WALK_POST);
+    edn_walk_item_t item;
+    char seen[64];
+    size_t n = 0;
+    while (edn_walk_next(walk, &item)) {
+        seen[n++] = type_code(&item);
+        if (!item.post && item.depth == 1) {
+            edn_walk_skip(walk); /* Collapse every top-level child */
+        }
+    }
+    seen[n] = '\0';
+    assert(strcmp(seen, "vvVmMiV") == 0);
+
+    /* Skip after a leaf or a post visit does nothing */
+    edn_walk_reset(walk, r.value);
+    n = 0;
+    while (edn_walk_next(walk, &item)) {
+        if (item.post || edn_type(item.value) == EDN_TYPE_INT) {
+            edn_walk_skip(walk);
+        }
+        n++;
+    }
+    assert(n == 11);
+
+    edn_walk_destroy(walk);
+    edn_free(r.value);
+}
+
+TEST(walk_deep_nesting) {
+    const size_t depth = 5000;
+    char* text = malloc(depth * 2 + 2);
+    assert(text != NULL);
+    memset(text, '[', depth);
+    text[depth] = '7';
+    memset(text + depth + 1, ']', depth);
+    text[depth * 2 + 1] = '\0';
+
+    edn_parse_options_t options = {0};
+    options.struct_size = sizeof(options);
+    options.max_depth = depth + 1;
+    edn_result_t r = edn_read_with_options(text, 0, &options);
+    assert(r.error == EDN_OK);
+
+    edn_walk_t* walk = edn_walk_create(r.value, EDN_WALK_PRE | EDN_WALK_POST);
+    edn_walk_item_t item;
+    size_t visits = 0;
+    size_t max_depth = 0;
+    while (edn_walk_next(walk, &item)) {
+        visits++;
+        if (item.depth > max_depth) {
+            max_depth = item.depth;
+        }
+    }
+    assert(edn_walk_error(walk) == EDN_OK);
+    assert(visits == depth * 2 + 1);
+    assert(max_depth == depth);
+
+    edn_walk_destroy(walk);
+    edn_free(r.value);
+    free(text);
+}
+
+/* Reference: count nodes with the indexed getters */
+static size_t count_recursive(const edn_value_t* value) {
+    size_t n = 1;
+    switch (edn_type(value)) {
+        case EDN_TYPE_VECTOR:
+            for (size_t i = 0; i < edn_vector_count(value); i++) {
+                n += count_recursive(edn_vector_get(value, i));
+            }
+            break;
+        case EDN_TYPE_LIST:
+            for (size_t i = 0; i < edn_list_count(value); i++) {
+                n += count_recursive(edn_list_get(value, i));
+            }
+            break;
+        case EDN_TYPE_SET:
+            for (size_t i = 0; i < edn_set_count(value); i++) {
+                n += count_recursive(edn_set_get(value, i));
+            }
+            break;
+        case EDN_TYPE_MAP:
+            for (size_t i = 0; i < edn_map_count(value); i++) {
+                n += count_recursive(edn_map_get_key(value, i));
+                n += count_recursive(edn_map_get_value(value, i));
+            }
+            break;
+        case EDN_TYPE_TAGGED: {
+            const char* tag;
+            edn_value_t* inner;
+            if (edn_tagged_get(value, &tag, NULL, &inner)) {
+                n += count_recursive(inner);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return n;
+}
+
+TEST(walk_matches_recursive_count) {
+    const char* input = "[{:id 1 :tags #{:a :b :c} :pos [1.5 2.5] :note \"x\"}"
+                        " {:id 2 :tags #{} :pos [] :note nil :more (1 2 3 4 5 6 7 8 9 10 11 12)}"
+                        " #my/point {:x 1 :y 2} [[[[[[]]]]]] {[1 2] {3 {4 5}}}]";
+    edn_result_t r = edn_read(input, 0);
+    assert(r.error == EDN_OK);
+
+    edn_walk_t* walk = edn_walk_create(r.value, EDN_WALK_PRE);
+    edn_walk_item_t item;
+    size_t visits = 0;
+    while (edn_walk_next(walk, &item)) {
+        visits++;
+    }
+    assert(visits == count_recursive(r.value));
+
+    /* Reuse on another tree */
+    edn_result_t other = edn_read("(1 2)", 0);
+    edn_walk_reset(walk, other.value);
+    visits = 0;
+    while (edn_walk_next(walk, &item)) {
+        visits++;
+    }
+    assert(visits == 3);
+
+    edn_walk_destroy(walk);
+    edn_free(other.value);
+    edn_free(r.value);
+}
+
+int main(void) {
+    printf("Running walk tests...\n");
+
+    RUN_TEST(walk_orders);
+    RUN_TEST(walk_parent_key_index);
+    RUN_TEST(walk_skip);
+    RUN_TEST(walk_deep_nesting);
+    RUN_TEST(walk_matches_recursive_count);
+
+    TEST_SUMMARY("walk");
+}
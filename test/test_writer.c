@@ -1733,6 +1733,83 @@ TEST(emit_symbol_invalid_fails) {
     edn_emitter_destroy(em);
 }
 
+/* --- pre-rendered tokens --- */
+
+TEST(emit_token_keyword) {
+    edn_emitter_token_t* plain = edn_emitter_make_keyword(NULL, "kw");
+    edn_emitter_token_t* qualified = edn_emitter_make_keyword("my.ns", "kw");
+    assert(plain != NULL && qualified != NULL);
+    EMITTER_OUTPUT_EQ({ assert_int_eq(edn_emit_token(em, plain), 0); }, ":kw");
+    EMITTER_OUTPUT_EQ({ assert_int_eq(edn_emit_token(em, qualified), 0); }, ":my.ns/kw");
+    edn_emitter_token_free(plain);
+    edn_emitter_token_free(qualified);
+}
+
+TEST(emit_token_make_rejects_invalid) {
+    /* Same grammar as edn_emit_keyword_ns. */
+    assert_ptr_eq(edn_emitter_make_keyword(NULL, NULL), NULL);
+    assert_ptr_eq(edn_emitter_make_keyword(NULL, ""), NULL);
+    assert_ptr_eq(edn_emitter_make_keyword(NULL, "a b"), NULL);
+    assert_ptr_eq(edn_emitter_make_keyword(NULL, ":kw"), NULL);
+    assert_ptr_eq(edn_emitter_make_keyword("1ns", "kw"), NULL);
+    assert_ptr_eq(edn_emitter_make_keyword("a/b", "kw"), NULL);
+    edn_emitter_token_free(NULL);
+}
+
+TEST(emit_token_matches_keyword_emit) {
+    /* Tokens reused across map entries, with indent column tracking. */
+    edn_write_options_t opts = {0};
+    opts.struct_size = sizeof(opts);
+    opts.indent = 1;
+    edn_emitter_token_t* id = edn_emitter_make_keyword("user", "id");
+    edn_emitter_token_t* tags = edn_emitter_make_keyword(NULL, "tags");
+    assert(id != NULL && tags != NULL);
+
+    emit_capture_t a = {{0}, 0};
+    emit_capture_t b = {{0}, 0};
+    edn_emitter_t* ea = edn_emitter_create(emit_capture_cb, &a, &opts);
+    edn_emitter_t* eb = edn_emitter_create(emit_capture_cb, &b, &opts);
+    assert(ea != NULL && eb != NULL);
+    for (int pass = 0; pass < 2; pass++) {
+        edn_emitter_t* em = pass ? eb : ea;
+        assert_int_eq(edn_emit_begin_vector(em), 0);
+        for (int i = 0; i < 2; i++) {
+            assert_int_eq(edn_emit_begin_map(em), 0);
+            assert_int_eq(pass ? edn_emit_token(em, id) : edn_emit_keyword_ns(em, "user", "id"),
+                          0);
+            assert_int_eq(edn_emit_int(em, i), 0);
+            assert_int_eq(pass ? edn_emit_token(em, tags) : edn_emit_keyword(em, "tags"), 0);
+            assert_int_eq(edn_emit_begin_set(em), 0);
+            assert_int_eq(pass ? edn_emit_token(em, tags) : edn_emit_keyword(em, "tags"), 0);
+            assert_int_eq(edn_emit_end_set(em), 0);
+            assert_int_eq(edn_emit_end_map(em), 0);
+        }
+        assert_int_eq(edn_emit_end_vector(em), 0);
+        assert_int_eq(edn_emitter_finish(em), 0);
+    }
+    assert_str_eq(b.buf, a.buf);
+    edn_emitter_destroy(ea);
+    edn_emitter_destroy(eb);
+    edn_emitter_token_free(id);
+    edn_emitter_token_free(tags);
+}
+
+TEST(emit_token_state_checks) {
+    edn_emitter_token_t* kw = edn_emitter_make_keyword(NULL, "kw");
+    assert(kw != NULL);
+    emit_capture_t c = {{0}, 0};
+    edn_emitter_t* em = edn_emitter_create(emit_capture_cb, &c, NULL);
+    assert(em != NULL);
+    assert_int_eq(edn_emit_token(em, NULL), -EDN_ERROR_INVALID_ARGUMENT);
+    assert_int_eq(edn_emit_token(NULL, kw), -EDN_ERROR_INVALID_ARGUMENT);
+    assert_int_eq(edn_emit_tag(em, "t"), 0);
+    assert_int_eq(edn_emit_token(em, kw), 0);
+    assert_int_eq(edn_emit_token(em, kw), -EDN_ERROR_INVALID_STATE);
+    assert_str_eq(c.buf, "#t :kw");
+    edn_emitter_destroy(em);
+    edn_emitter_token_free(kw);
+}
+
 TEST(emit_character_ascii) {
     EMITTER_OUTPUT_EQ({ assert_int_eq(edn_emit_character(em, 'a'), 0); }, "\\a");
 }
@@ -2221,6 +2298,21 @@ TEST(emit_meta_keyword_payload_then_value) {
     edn_emitter_destroy(em);
 }
 
+TEST(emit_meta_token_payload) {
+    edn_emitter_token_t* dynamic = edn_emitter_make_keyword(NULL, "dynamic");
+    assert(dynamic != NULL);
+    emit_capture_t c = {{0}, 0};
+    edn_emitter_t* em = meta_emitter(&c);
+    assert(em != NULL);
+    assert_int_eq(edn_emit_meta(em), 0);
+    assert_int_eq(edn_emit_token(em, dynamic), 0);
+    assert_int_eq(edn_emit_symbol(em, "value"), 0);
+    assert_int_eq(edn_emitter_finish(em), 0);
+    assert_str_eq(c.buf, "^:dynamic value");
+    edn_emitter_destroy(em);
+    edn_emitter_token_free(dynamic);
+}
+
 TEST(emit_meta_map_payload_streamed) {
     emit_capture_t c = {{0}, 0};
     edn_emitter_t* em = meta_emitter(&c);
@@ -2602,6 +2694,10 @@ int main(void) {
     RUN_TEST(emit_symbol_ns);
     RUN_TEST(emit_keyword_invalid_fails);
     RUN_TEST(emit_symbol_invalid_fails);
+    RUN_TEST(emit_token_keyword);
+    RUN_TEST(emit_token_make_rejects_invalid);
+    RUN_TEST(emit_token_matches_keyword_emit);
+    RUN_TEST(emit_token_state_checks);
     RUN_TEST(emit_character_ascii);
     RUN_TEST(emit_character_named);
     RUN_TEST(emit_character_unicode_bmp);
@@ -2653,6 +2749,7 @@ int main(void) {
 
     /* streaming emitter: metadata */
     RUN_TEST(emit_meta_keyword_payload_then_value);
+    RUN_TEST(emit_meta_token_payload);
     RUN_TEST(emit_meta_map_payload_streamed);
     RUN_TEST(emit_meta_map_payload_embedded);
     RUN_TEST(emit_meta_vector_payload_embedded);